@@ -0,0 +1,164 @@
+#ifndef BOOT_REPORT_H
+#define BOOT_REPORT_H
+
+/**
+ * @file boot_report.h
+ * @brief Durations of the boot phases from freertos_main() to the first frame on the wire.
+ *
+ * Every phase is closed with BootReport_mark() and the frame reference timer
+ * (40 MHz, Cycleprofiler_getTimeStamp()), its duration is the time since the
+ * previous mark. The phases up to BOOT_PHASE_START are marked by the main task,
+ * the last two by the dpcTask: the first frame is processed at least one frame
+ * period after the sensor was started, so the marks stay in order.
+ *
+ * The payload of the STREAM_RECORD_TYPE_BOOT_REPORT record (stream_record.h)
+ * is the BootReport_Payload in the memory order of the device (little endian).
+ * It is transmitted once, with the frame after the first one, since the first
+ * frame has to be on the wire before the report is complete. The sum of all
+ * phases is the restart latency seen by the host, startTicks the timer value
+ * at the entry of freertos_main() (the time spent before, if the timer runs
+ * from reset).
+ */
+
+#include <stdint.h>
+
+/*! @brief Version of the payload, increased whenever it changes */
+#define BOOT_REPORT_VERSION         1U
+
+/*! @brief BootReport_Payload::flags: the firmware booted warm, see warm_start.h */
+#define BOOT_REPORT_FLAG_WARM       0x1U
+
+/*! @brief Results of BootReport_decode() */
+#define BOOT_REPORT_OK              0
+#define BOOT_REPORT_ERR_VERSION     (-1)
+#define BOOT_REPORT_ERR_LENGTH      (-2)
+
+/**
+ * @brief Boot phases in the order they are run.
+ */
+typedef enum BootReport_Phase_e
+{
+    /*! @brief Drivers_open(), Board_driversOpen(), LED GPIO and semaphores */
+    BOOT_PHASE_DRIVERS = 0,
+
+    /*! @brief SOC_memoryInit() and the memory pools */
+    BOOT_PHASE_MEM_INIT,
+
+    /*! @brief Warm start check and boot profile (RAM, flash blob or defines.h) */
+    BOOT_PHASE_PROFILE,
+
+    /*! @brief mmwave_initSensor() */
+    BOOT_PHASE_SENSOR_INIT,
+
+    /*! @brief hwa_open_handler() and the DPU initialization */
+    BOOT_PHASE_HWA_OPEN,
+
+    /*! @brief FECSS RF power on and trim check */
+    BOOT_PHASE_RF_POWER,
+
+    /*! @brief mmwave_openSensor() */
+    BOOT_PHASE_OPEN,
+
+    /*! @brief mmwave_configSensor() */
+    BOOT_PHASE_CONFIG,
+
+    /*! @brief restoreFactoryCal() */
+    BOOT_PHASE_CALIBRATION,
+
+    /*! @brief dpcTask creation until the DPUs and stream products are configured */
+    BOOT_PHASE_PIPELINE,
+
+    /*! @brief spiTask creation and mmwave_startSensor() */
+    BOOT_PHASE_START,
+
+    /*! @brief Sensor started until the first radar cube and its products are computed */
+    BOOT_PHASE_FIRST_FRAME,
+
+    /*! @brief SPI transfer of the first frame */
+    BOOT_PHASE_FIRST_TX,
+
+    BOOT_PHASE_NUM
+} BootReport_Phase;
+
+/**
+ * @brief Payload of a STREAM_RECORD_TYPE_BOOT_REPORT record.
+ */
+typedef struct BootReport_Payload_t
+{
+    /*! @brief BOOT_REPORT_VERSION */
+    uint16_t version;
+
+    /*! @brief Number of entries in phaseTicks (BOOT_PHASE_NUM) */
+    uint16_t numPhases;
+
+    /*! @brief BOOT_REPORT_FLAG_* */
+    uint32_t flags;
+
+    /*! @brief Boots since the last cold boot, including this one */
+    uint32_t numBoots;
+
+    /*! @brief Frame reference timer at the entry of freertos_main() */
+    uint32_t startTicks;
+
+    /*! @brief Bit p is set once phase p was marked */
+    uint32_t phaseMask;
+
+    /*! @brief Duration of every phase (40 MHz ticks), indexed by BootReport_Phase */
+    uint32_t phaseTicks[BOOT_PHASE_NUM];
+} BootReport_Payload;
+
+/**
+ * @brief Boot report while it is collected.
+ */
+typedef struct BootReport_t
+{
+    /*! @brief Payload as transmitted */
+    BootReport_Payload payload;
+
+    /*! @brief Timer value of the last mark */
+    uint32_t lastTicks;
+} BootReport;
+
+/**
+ * @brief Starts the report at the entry of freertos_main().
+ */
+void BootReport_init(BootReport *report, uint32_t nowTicks);
+
+/**
+ * @brief Closes a phase: its duration is the time since the previous mark.
+ */
+void BootReport_mark(BootReport *report, BootReport_Phase phase, uint32_t nowTicks);
+
+/**
+ * @brief Sets the boot type (warm or cold) and the number of boots since the last cold boot.
+ */
+void BootReport_setBoot(BootReport *report, uint32_t warmStart, uint32_t numBoots);
+
+/**
+ * @brief Checks whether all phases were marked.
+ *
+ * @return 1 if complete, 0 otherwise
+ */
+int32_t BootReport_isComplete(const BootReport *report);
+
+/**
+ * @brief Sums the durations of the phases first..last (inclusive).
+ */
+uint32_t BootReport_sumTicks(const BootReport_Payload *payload, BootReport_Phase first, BootReport_Phase last);
+
+/**
+ * @brief Returns the name of a phase for logs and host tools.
+ */
+const char *BootReport_phaseName(BootReport_Phase phase);
+
+/**
+ * @brief Checks and copies a payload received from the stream.
+ *
+ * @param data      payload following the StreamRecord_Header
+ * @param numBytes  payloadBytes of the StreamRecord_Header
+ * @param payload   decoded payload
+ * @return BOOT_REPORT_OK, BOOT_REPORT_ERR_VERSION or BOOT_REPORT_ERR_LENGTH
+ */
+int32_t BootReport_decode(const void *data, uint32_t numBytes, BootReport_Payload *payload);
+
+#endif /* BOOT_REPORT_H */
@@ -0,0 +1,54 @@
+
+#ifndef BUDGET_H
+#define BUDGET_H
+
+/**
+ * @file budget.h
+ *
+ * @brief Build-time memory and throughput budget of the configuration in defines.h.
+ *
+ * Integer sizes and timings derived from the configuration, checked against
+ * the limits of budget_limits.h, so that a profile which does not fit the
+ * memory or can not be streamed within the frame period fails the build. Only
+ * the radar cube is accounted for the SPI time (default stream).
+ *
+ * This file was auto-generated by the script 'chirp_config_to_defines.py' from the config file 'default.cfg' on 2026-10-18 17:24:14
+ */
+
+#include <stdint.h>
+
+#include "budget_limits.h"
+
+/*! @brief Radar cube dimensions (see chirp_accum.h) */
+#define BUDGET_NUM_RANGE_BINS            64U
+#define BUDGET_NUM_VIRTUAL_ANTENNAS      6U
+#define BUDGET_NUM_DOPPLER_CHIRPS        64U
+
+/*! @brief Size of the radar cube in bytes */
+#define BUDGET_CUBE_BYTES                98304U
+
+/*! @brief Size of the symmetric range window in bytes */
+#define BUDGET_WINDOW_BYTES              256U
+
+/*! @brief Frame period and time spent chirping (bursts x burst period) in us */
+#define BUDGET_FRAME_PERIOD_US           100000U
+#define BUDGET_ACTIVE_FRAME_US           25792U
+
+/*! @brief Derived pool budgets */
+#define BUDGET_MAX_CUBE_SLOTS            (L3_MEM_SIZE / BUDGET_CUBE_BYTES)
+#define BUDGET_L3_HEADROOM_BYTES         (L3_MEM_SIZE - BUDGET_CUBE_BYTES)
+#define BUDGET_CORE_LOCAL_HEADROOM_BYTES (MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE - BUDGET_WINDOW_BYTES)
+
+/*! @brief Time to transfer the cube at SPI_SCLK_HZ in us (rounded up, without gaps between the chunks) */
+#define BUDGET_SPI_TIME_US               ((uint32_t)((((uint64_t)BUDGET_CUBE_BYTES * 8U * 1000000U) + SPI_SCLK_HZ - 1U) / SPI_SCLK_HZ))
+
+_Static_assert(BUDGET_CUBE_BYTES <= L3_MEM_SIZE,
+               "radar cube exceeds L3_MEM_SIZE");
+_Static_assert(BUDGET_WINDOW_BYTES <= MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE,
+               "range window exceeds MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE");
+_Static_assert((BUDGET_CUBE_BYTES % BYTES_PER_FRAME) == 0U,
+               "radar cube is not a multiple of the SPI frame size BYTES_PER_FRAME");
+_Static_assert((BUDGET_ACTIVE_FRAME_US + BUDGET_SPI_TIME_US) <= BUDGET_FRAME_PERIOD_US,
+               "chirping and the SPI transfer of the radar cube exceed the frame period");
+
+#endif /* BUDGET_H */
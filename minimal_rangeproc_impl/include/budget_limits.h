@@ -0,0 +1,33 @@
+#ifndef BUDGET_LIMITS_H
+#define BUDGET_LIMITS_H
+
+/**
+ * @file budget_limits.h
+ * @brief Memory and SPI limits of the firmware.
+ *
+ * The pool sizes and SPI parameters the chirp configuration is checked
+ * against at build time by the generated budget.h. They are kept here rather
+ * than in the translation units which use them, so that the checks see the
+ * same values as the firmware. Only plain integer macros, no SDK headers.
+ */
+
+/*! @brief L3 RAM buffer for object detection DPC (APPSS and HWA parts of HWASS_SHM_MEM) */
+#define L3_MEM_SIZE (0x40000 + 160*1024)
+
+/*! @brief Local RAM buffer for object detection DPC */
+#define MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE ((8U+6U+4U+2U+8U) * 1024U)
+
+/*! @brief FECSS part of the shared memory (see MMWAVE_FECSS_SHRAM_POOL_ENABLE) */
+#define FECSS_SHRAM_MEM_SIZE (96U * 1024U)
+
+/*! @brief Max. Bytes per transfer burst (FTDI: 65536 Byte) */
+#define MAX_SPI_TRANSFER_SIZE       (65280U)
+
+/*! @brief Bits per SPI frame */
+#define BITS_PER_FRAME              (32U)
+#define BYTES_PER_FRAME             (BITS_PER_FRAME/8U)
+
+/*! @brief SPI clock in Hz, must match mcspiChannel[0].bitRate in example.syscfg */
+#define SPI_SCLK_HZ                 (30000000U)
+
+#endif /* BUDGET_LIMITS_H */
@@ -0,0 +1,120 @@
+#ifndef CAL_STORE_H
+#define CAL_STORE_H
+
+/**
+ * @file cal_store.h
+ * @brief Factory calibration record in flash: restore, or generate and save.
+ *
+ * The record starts with a versioned header (CalStore_Header): magic word,
+ * format version, sizes and the CRC-32 of the calibration data behind it. At
+ * boot a valid record is restored. A record of the demo format (magic word
+ * directly followed by the data, no CRC) is converted in RAM and restored as
+ * well, the flash keeps it as it is. If the flash holds no usable record
+ * (fresh device, erased or corrupted sector), the boot calibration is run
+ * instead and its result is saved, so that later boots only restore it. If
+ * saving fails the device still runs calibrated and the calibration is
+ * repeated at the next boot.
+ *
+ * A record in flash is never replaced because the front end rejected it:
+ * the boot calibration then only runs into RAM, so a transient failure does
+ * not erase the factory calibration.
+ *
+ * Flash access and the front-end calibration are passed as callbacks.
+ */
+
+#include <stdint.h>
+
+/*! @brief Results of CalStore_run() */
+#define CAL_STORE_RESTORED          0       /* valid record restored */
+#define CAL_STORE_GENERATED         1       /* no valid record: calibrated and saved */
+#define CAL_STORE_RESTORED_LEGACY   2       /* record of the demo format restored, kept in flash */
+#define CAL_STORE_CALIBRATED_RAM    3       /* record rejected by the front end: calibrated, record kept in flash */
+#define CAL_STORE_ERR_NO_RECORD     (-1)    /* no valid record, generation disabled: uncalibrated */
+#define CAL_STORE_ERR_CALIB         (-2)    /* calibration failed: uncalibrated */
+#define CAL_STORE_ERR_SAVE          (-3)    /* calibrated, but the record could not be saved */
+#define CAL_STORE_ERR_RESTORE       (-4)    /* record rejected by the front end, generation disabled: uncalibrated */
+
+/*! @brief Flags of CalStore_run() */
+#define CAL_STORE_FLAG_RETAINED     0x1U    /* record already in RAM (warm boot), not read from flash */
+#define CAL_STORE_FLAG_GENERATE     0x2U    /* calibrate and save if no valid record exists */
+
+/*! @brief Version of the record header, increased whenever it changes */
+#define CAL_STORE_VERSION           1U
+
+/*! @brief Bytes before the data in a record of the demo format (the magic word) */
+#define CAL_STORE_LEGACY_HEADER_BYTES   4U
+
+/**
+ * @brief Header of a calibration record, followed by the calibration data.
+ */
+typedef struct CalStore_Header_t
+{
+    /*! @brief Magic word of the record format */
+    uint32_t magic;
+
+    /*! @brief CAL_STORE_VERSION */
+    uint16_t version;
+
+    /*! @brief Bytes of the header (sizeof(CalStore_Header)) */
+    uint16_t headerBytes;
+
+    /*! @brief Bytes of the calibration data behind the header */
+    uint32_t dataBytes;
+
+    /*! @brief CRC-32 of the calibration data behind the header */
+    uint32_t crc;
+} CalStore_Header;
+
+/**
+ * @brief Flash access and front-end calibration.
+ */
+typedef struct CalStore_Ops_t
+{
+    /*! @brief Reads the record from flash, returns 0 on success */
+    int32_t (*read)(void *arg, void *record, uint32_t recordBytes);
+
+    /*! @brief Erases the record's sector and writes the record, returns 0 on success */
+    int32_t (*write)(void *arg, const void *record, uint32_t recordBytes);
+
+    /*! @brief Applies the calibration data of the record, returns 0 on success */
+    int32_t (*restore)(void *arg);
+
+    /*! @brief Runs the boot calibration and stores its result as data of the record, returns 0 on success */
+    int32_t (*calibrate)(void *arg);
+
+    /*! @brief Passed to the operations */
+    void *arg;
+} CalStore_Ops;
+
+/**
+ * @brief Checks the header and CRC of a record.
+ *
+ * @param record       record (CalStore_Header and calibration data)
+ * @param recordBytes  size of the record
+ * @param magic        magic word of the record format
+ * @return 1 if valid, 0 otherwise
+ */
+int32_t CalStore_isValid(const void *record, uint32_t recordBytes, uint32_t magic);
+
+/**
+ * @brief Sets the header of a record after its calibration data was filled.
+ */
+void CalStore_seal(void *record, uint32_t recordBytes, uint32_t magic);
+
+/**
+ * @brief Restores the calibration, or generates and saves it if no valid record exists.
+ *
+ * The record in RAM is valid (CalStore_isValid()) afterwards only if the flash
+ * holds the same calibration: after CAL_STORE_RESTORED, _RESTORED_LEGACY and
+ * _GENERATED.
+ *
+ * @param record       record buffer (CalStore_Header and calibration data)
+ * @param recordBytes  size of the record
+ * @param magic        magic word of the record format
+ * @param flags        CAL_STORE_FLAG_*
+ * @param ops          flash access and front-end calibration
+ * @return CAL_STORE_RESTORED, _GENERATED, _RESTORED_LEGACY, _CALIBRATED_RAM or CAL_STORE_ERR_*
+ */
+int32_t CalStore_run(void *record, uint32_t recordBytes, uint32_t magic, uint32_t flags, const CalStore_Ops *ops);
+
+#endif /* CAL_STORE_H */
@@ -0,0 +1,183 @@
+#ifndef CFAR_H
+#define CFAR_H
+
+/**
+ * @file cfar.h
+ * @brief CFAR detection on the range profile or the range-Doppler heatmap.
+ *
+ * A cell is detected if its value exceeds the noise estimate of its
+ * neighbourhood, scaled by a threshold factor:
+ *
+ *   value * 256 > thresholdQ8 * noise
+ *
+ * The noise estimate is computed along the range dimension from noiseLen cells
+ * on each side, separated from the cell under test by guardLen cells:
+ *   - CA:   average of both sides
+ *   - CAGO: greater of the averages of the two sides
+ *   - CASO: smaller of the averages of the two sides
+ *   - OS:   osRank-th smallest (1 based) of the 2 * noiseLen cells
+ * Near the edges only the complete side is used. With peak grouping enabled a
+ * detection is only reported if the cell is a local maximum along range (and
+ * along Doppler for the heatmap, cyclically).
+ *
+ * The detection is done with integer arithmetic only (apart from the SNR
+ * reported per detection), so the device output and the output of this
+ * module on a host machine are identical for identical input.
+ *
+ * Layout of the detection list (following the StreamRecord_Header):
+ *   - Cfar_Header
+ *   - numDetections Cfar_Detection entries, in range bin major order
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Noise estimation methods.
+ */
+typedef enum Cfar_Mode_e
+{
+    /*! @brief Cell averaging */
+    CFAR_MODE_CA = 0,
+
+    /*! @brief Cell averaging, greater of both sides */
+    CFAR_MODE_CAGO = 1,
+
+    /*! @brief Cell averaging, smaller of both sides */
+    CFAR_MODE_CASO = 2,
+
+    /*! @brief Ordered statistic */
+    CFAR_MODE_OS = 3
+} Cfar_Mode;
+
+/**
+ * @brief Input of the detection.
+ */
+typedef enum Cfar_Input_e
+{
+    /*! @brief Non-coherent range profile (uint32 per range bin), Doppler index always 0 */
+    CFAR_INPUT_RANGE_PROFILE = 0,
+
+    /*! @brief Range-Doppler heatmap (uint16, range bin major), see rd_heatmap.h */
+    CFAR_INPUT_RD_HEATMAP = 1
+} Cfar_Input;
+
+/*! @brief Largest number of noise cells per side */
+#define CFAR_MAX_NOISE_LEN      (32U)
+
+/**
+ * @brief Configuration of the detection.
+ */
+typedef struct Cfar_Config_t
+{
+    /*! @brief Noise estimation method, see @ref Cfar_Mode */
+    uint8_t mode;
+
+    /*! @brief Number of guard cells per side */
+    uint8_t guardLen;
+
+    /*! @brief Number of noise cells per side (1 .. CFAR_MAX_NOISE_LEN) */
+    uint8_t noiseLen;
+
+    /*! @brief Rank of the noise cell used by CFAR_MODE_OS (1 .. 2 * noiseLen) */
+    uint8_t osRank;
+
+    /*! @brief Threshold factor in Q8 (e.g. 15 dB: 31.6 * 256 = 8092) */
+    uint32_t thresholdQ8;
+
+    /*! @brief First range bin searched, used to skip DC and TX leakage */
+    uint16_t minRangeBin;
+
+    /*! @brief Report local maxima only (1) or all cells above threshold (0) */
+    uint8_t peakGroupEn;
+
+    /*! @brief Reserved, always 0 */
+    uint8_t reserved;
+
+    /*! @brief Maximum number of detections of the list */
+    uint16_t maxDetections;
+} Cfar_Config;
+
+/**
+ * @brief Header of the detection list.
+ */
+typedef struct Cfar_Header_t
+{
+    /*! @brief Number of valid detections */
+    uint16_t numDetections;
+
+    /*! @brief Number of detections dropped because the list was full */
+    uint16_t numDropped;
+
+    /*! @brief Noise estimation method, see @ref Cfar_Mode */
+    uint8_t mode;
+
+    /*! @brief Input of the detection, see @ref Cfar_Input */
+    uint8_t input;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Duration of the detection in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} Cfar_Header;
+
+/**
+ * @brief Entry of the detection list.
+ */
+typedef struct Cfar_Detection_t
+{
+    /*! @brief Range bin index */
+    uint16_t rangeIdx;
+
+    /*! @brief Doppler bin index (FFT order), 0 for the range profile */
+    uint16_t dopplerIdx;
+
+    /*! @brief SNR (value / noise) in dB, Q8 */
+    int16_t snrDbQ8;
+
+    /*! @brief Value of the cell, saturated to 16 bits */
+    uint16_t level;
+} Cfar_Detection;
+
+/**
+ * @brief Returns the size of a detection list with maxDetections entries.
+ *
+ * @param cfg  detection configuration
+ * @return size in bytes (multiple of 4)
+ */
+uint32_t Cfar_getListSize(const Cfar_Config *cfg);
+
+/**
+ * @brief Returns the size of the valid part of a detection list.
+ *
+ * @param list  detection list
+ * @return size in bytes (multiple of 4)
+ */
+uint32_t Cfar_getUsedListSize(const void *list);
+
+/**
+ * @brief Detects targets in the non-coherent range profile.
+ *
+ * @param cfg           detection configuration
+ * @param profile       numRangeBins uint32 values
+ * @param numRangeBins  number of range bins
+ * @param list          output detection list of Cfar_getListSize() bytes
+ * @return number of detections, -1 on an invalid configuration
+ */
+int32_t Cfar_detectRangeProfile(const Cfar_Config *cfg, const uint32_t *profile, uint32_t numRangeBins,
+                                void *list);
+
+/**
+ * @brief Detects targets in the range-Doppler heatmap (CFAR along range per Doppler bin).
+ *
+ * @param cfg             detection configuration
+ * @param heatmap         numRangeBins x numDopplerBins uint16 values, range bin major
+ * @param numRangeBins    number of range bins
+ * @param numDopplerBins  number of Doppler bins
+ * @param list            output detection list of Cfar_getListSize() bytes
+ * @return number of detections, -1 on an invalid configuration
+ */
+int32_t Cfar_detectRdHeatmap(const Cfar_Config *cfg, const uint16_t *heatmap, uint32_t numRangeBins,
+                             uint32_t numDopplerBins, void *list);
+
+#endif /* CFAR_H */
@@ -0,0 +1,59 @@
+#ifndef CFAR_PROC_H
+#define CFAR_PROC_H
+
+/**
+ * @file cfar_proc.h
+ * @brief CFAR detection stage producing a compact detection list per frame.
+ *
+ * The stage runs after the range processing (and the Doppler stage, if the
+ * range-Doppler heatmap is used as input) and writes a detection list in the
+ * format of cfar.h to the shared memory. The detection itself is the portable
+ * cfar.c, so the device output can be compared one to one with a host run on
+ * the same input.
+ */
+
+#include <stdint.h>
+
+/*! @brief Run the CFAR stage every frame (1) or not (0) */
+#define CFARPROC_ENABLE             0
+
+/*! @brief Detect on the range-Doppler heatmap (1, requires DOPPLERPROC_ENABLE) or on the range profile (0) */
+#define CFARPROC_USE_RD_HEATMAP     0
+
+/*! @brief Noise estimation method (Cfar_Mode) */
+#define CFARPROC_MODE               CFAR_MODE_CASO
+
+/*! @brief Guard and noise cells per side, rank of CFAR_MODE_OS */
+#define CFARPROC_GUARD_LEN          2
+#define CFARPROC_NOISE_LEN          8
+#define CFARPROC_OS_RANK            12
+
+/*! @brief Threshold factor in Q8 (12 dB) */
+#define CFARPROC_THRESHOLD_Q8       4056U
+
+/*! @brief First range bin searched (skips DC and TX leakage) */
+#define CFARPROC_MIN_RANGE_BIN      2
+
+/*! @brief Report local maxima only (1) or all cells above threshold (0) */
+#define CFARPROC_PEAK_GROUP_EN      1
+
+/*! @brief Maximum number of detections per frame */
+#define CFARPROC_MAX_DETECTIONS     32
+
+/**
+ * @brief Allocates the detection list (and the range profile if used as input).
+ *
+ * Must be called after RangeProc_config() and DopplerProc_config().
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t CfarProc_config(void);
+
+/**
+ * @brief Runs the detection on the current frame.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t CfarProc_process(void);
+
+#endif /* CFAR_PROC_H */
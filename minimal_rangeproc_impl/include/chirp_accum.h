@@ -0,0 +1,93 @@
+#ifndef CHIRP_ACCUM_H
+#define CHIRP_ACCUM_H
+
+/**
+ * @file chirp_accum.h
+ * @brief Radar cube dimensions and range FFT scaling with front-end chirp accumulation.
+ *
+ * With frameCfg numOfChirpsAccum = N > 1 the front end sums N consecutive
+ * chirps before they are written to the ADC buffer. The range DPU therefore
+ * sees only numOfChirpsInBurst / N chirp events per burst, and the radar cube
+ * and the SPI stream shrink by the factor N without any processing on the
+ * core. 0 and 1 both mean no accumulation.
+ *
+ * The TX antennas are assumed to advance once per accumulated chirp, so the
+ * accumulated chirps of one burst must still be a multiple of the number of
+ * TX antennas.
+ *
+ * The coherent sum grows the signal by up to N (log2(N) bits) while the noise
+ * grows by sqrt(N), i.e. the SNR improves by 10*log10(N) dB. To keep the
+ * headroom of the 16-bit radar cube the range FFT output is shifted right by
+ * ceil(log2(N)) bits more. The range window is applied over the ADC samples
+ * of one chirp and stays the same.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Frame configuration relevant for the cube dimensions.
+ */
+typedef struct ChirpAccum_Config_t
+{
+    /*! @brief frameCfg numOfChirpsInBurst (chirps transmitted per burst) */
+    uint32_t numChirpsPerBurst;
+
+    /*! @brief frameCfg numOfBurstsInFrame */
+    uint32_t numBurstsPerFrame;
+
+    /*! @brief frameCfg numOfChirpsAccum, 0 or 1 for no accumulation */
+    uint32_t numChirpsAccum;
+
+    /*! @brief Number of TX antennas (chirps per doppler chirp) */
+    uint32_t numTxAntennas;
+
+    /*! @brief Number of virtual antennas */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+} ChirpAccum_Config;
+
+/**
+ * @brief Derived dimensions and scaling.
+ */
+typedef struct ChirpAccum_Dims_t
+{
+    /*! @brief Number of chirps summed per ADC buffer chirp (>= 1) */
+    uint32_t accumFactor;
+
+    /*! @brief Chirps per frame seen by the range DPU (numChirpsPerFrame) */
+    uint32_t numChirpsPerFrame;
+
+    /*! @brief Doppler chirps per frame (numDopplerChirpsPerFrame) */
+    uint32_t numDopplerChirpsPerFrame;
+
+    /*! @brief Size of the radar cube (and of the raw cube SPI transfer) in bytes */
+    uint32_t cubeBytes;
+
+    /*! @brief Additional right shift of the range FFT output, ceil(log2(accumFactor)) */
+    uint32_t extraShift;
+
+    /*! @brief Expected SNR gain of the accumulation in dB */
+    float snrGainDb;
+} ChirpAccum_Dims;
+
+/**
+ * @brief Returns the accumulation factor of a numOfChirpsAccum value.
+ *
+ * @param numChirpsAccum  frameCfg numOfChirpsAccum
+ * @return number of chirps summed per ADC buffer chirp (0 and 1 both give 1)
+ */
+uint32_t ChirpAccum_getFactor(uint32_t numChirpsAccum);
+
+/**
+ * @brief Computes the cube dimensions and scaling of a frame configuration.
+ *
+ * @param cfg   frame configuration
+ * @param dims  output
+ * @return 0 on success, -1 if the burst can not be divided into accumulated
+ *         chirps or these are not a multiple of the TX antennas
+ */
+int32_t ChirpAccum_compute(const ChirpAccum_Config *cfg, ChirpAccum_Dims *dims);
+
+#endif /* CHIRP_ACCUM_H */
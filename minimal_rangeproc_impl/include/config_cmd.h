@@ -0,0 +1,360 @@
+#ifndef CONFIG_CMD_H
+#define CONFIG_CMD_H
+
+/**
+ * @file config_cmd.h
+ * @brief Runtime reconfiguration of the chirp profile via SPI command records.
+ *
+ * A command record carries the channelCfg, chirpComnCfg, chirpTimingCfg and
+ * frameCfg commands of a .cfg file, with the parameter names and units of
+ * CONFIG_STRUCTURE in chirp_config_to_defines.py (which also encodes the
+ * records, see its --encode-cmd option). The record is a sequence of 32-bit
+ * words, as the SPI transfers them (BITS_PER_FRAME, most significant bit
+ * first):
+ *
+ * | word  | content                                                  |
+ * |-------|----------------------------------------------------------|
+ * | 0     | CONFIG_CMD_MAGIC                                         |
+ * | 1     | version << 16 | record type                              |
+ * | 2     | payload bytes << 16 | sequence number                    |
+ * | 3     | CRC-32 of the payload words (ConfigCmd_crc32())          |
+ * | 4..24 | payload: the fields of ConfigCmd_Profile in their order, |
+ * |       | integers as uint32, fractional values as IEEE float bits |
+ *
+ * A received record is validated against the active profile and the memory
+ * limits and then applied at the next frame boundary by ConfigCmd_service():
+ * the sensor is stopped, the front end and the processing pipeline are
+ * reconfigured and the sensor is restarted. If the new profile can not be
+ * applied, the previous one is restored. The result is reported to the host
+ * in a status record (ConfigCmd_encodeStatus()).
+ *
+ * The channelCfg of a record must match the active one: the RF power-up, the
+ * factory calibration and the antenna geometry depend on the enabled
+ * antennas and are only set up at boot.
+ *
+ * The sensor and pipeline operations are passed as callbacks.
+ */
+
+#include <stdint.h>
+
+/*! @brief First word of a command record ("RCFG") */
+#define CONFIG_CMD_MAGIC                0x52434647U
+
+/*! @brief First word of a status record ("RSTS") */
+#define CONFIG_CMD_STATUS_MAGIC         0x52535453U
+
+/*! @brief Version of the record format */
+#define CONFIG_CMD_VERSION              1U
+
+/*! @brief Record type: chirp profile (ConfigCmd_Profile) */
+#define CONFIG_CMD_TYPE_PROFILE         1U
+
+/*! @brief Number of header words */
+#define CONFIG_CMD_HEADER_WORDS         4U
+
+/*! @brief Number of payload words of a profile record */
+#define CONFIG_CMD_PROFILE_WORDS        21U
+
+/*! @brief Number of words of a profile record */
+#define CONFIG_CMD_RECORD_WORDS         (CONFIG_CMD_HEADER_WORDS + CONFIG_CMD_PROFILE_WORDS)
+
+/*! @brief Number of words of a status record */
+#define CONFIG_CMD_STATUS_WORDS         8U
+
+/*! @brief Results, reported in the status record */
+#define CONFIG_CMD_OK                   0
+#define CONFIG_CMD_ERR_NO_RECORD        (-1)    /* no magic, e.g. an idle slot */
+#define CONFIG_CMD_ERR_VERSION          (-2)
+#define CONFIG_CMD_ERR_LENGTH           (-3)
+#define CONFIG_CMD_ERR_CRC              (-4)
+#define CONFIG_CMD_ERR_CHANNEL          (-5)    /* channelCfg differs from the active one */
+#define CONFIG_CMD_ERR_INVALID          (-6)    /* parameter out of range or chirps not accumulable */
+#define CONFIG_CMD_ERR_BUDGET           (-7)    /* radar cube exceeds the L3 budget */
+#define CONFIG_CMD_ERR_BUSY             (-8)    /* previous record not applied yet */
+#define CONFIG_CMD_ERR_APPLY            (-9)    /* failed, the previous profile is running again */
+#define CONFIG_CMD_ERR_FAILED           (-10)   /* failed and the previous profile could not be restored */
+
+/*! @brief States of the reconfiguration */
+#define CONFIG_CMD_STATE_RUNNING        0U      /* sensor runs with the active profile */
+#define CONFIG_CMD_STATE_PENDING        1U      /* valid record received, waits for the frame boundary */
+#define CONFIG_CMD_STATE_STOPPING       2U
+#define CONFIG_CMD_STATE_RECONFIGURING  3U
+#define CONFIG_CMD_STATE_ROLLBACK       4U      /* restoring the previous profile */
+#define CONFIG_CMD_STATE_RESTARTING     5U
+#define CONFIG_CMD_STATE_FAILED         6U      /* sensor stopped, no profile applied */
+
+/**
+ * @brief channelCfg
+ */
+typedef struct ConfigCmd_ChannelCfg_t
+{
+    /*! @brief Enabled RX antennas */
+    uint32_t rxChCtrlBitMask;
+
+    /*! @brief Enabled TX antennas */
+    uint32_t txChCtrlBitMask;
+
+    /*! @brief Miscellaneous control */
+    uint32_t miscCtrl;
+} ConfigCmd_ChannelCfg;
+
+/**
+ * @brief chirpComnCfg
+ */
+typedef struct ConfigCmd_ChirpComnCfg_t
+{
+    /*! @brief ADC sampling rate divider (100 MHz / digOutputSampRate) */
+    uint32_t digOutputSampRate;
+
+    /*! @brief ADC output bits */
+    uint32_t digOutputBitsSel;
+
+    /*! @brief Decimation filter */
+    uint32_t dfeFirSel;
+
+    /*! @brief ADC samples per chirp */
+    uint32_t numOfAdcSamples;
+
+    /*! @brief MIMO pattern: 0/1 TDM, 4 BPM */
+    uint32_t chirpTxMimoPatSel;
+
+    /*! @brief Ramp end time in us */
+    float chirpRampEndTime;
+
+    /*! @brief RX high pass filter */
+    uint32_t chirpRxHpfSel;
+} ConfigCmd_ChirpComnCfg;
+
+/**
+ * @brief chirpTimingCfg
+ */
+typedef struct ConfigCmd_ChirpTimingCfg_t
+{
+    /*! @brief Idle time in us */
+    float chirpIdleTime;
+
+    /*! @brief ADC samples skipped at the chirp start */
+    uint32_t chirpAdcSkipSamples;
+
+    /*! @brief TX start time in us */
+    float chirpTxStartTime;
+
+    /*! @brief Slope in MHz/us */
+    float chirpRfFreqSlope;
+
+    /*! @brief Start frequency in GHz */
+    float chirpRfFreqStart;
+} ConfigCmd_ChirpTimingCfg;
+
+/**
+ * @brief frameCfg
+ */
+typedef struct ConfigCmd_FrameCfg_t
+{
+    /*! @brief Chirps per burst */
+    uint32_t numOfChirpsInBurst;
+
+    /*! @brief Chirps summed by the front end, 0 or 1 for none (see chirp_accum.h) */
+    uint32_t numOfChirpsAccum;
+
+    /*! @brief Burst period in us */
+    float burstPeriodicity;
+
+    /*! @brief Bursts per frame */
+    uint32_t numOfBurstsInFrame;
+
+    /*! @brief Frame period in ms */
+    float framePeriodicity;
+
+    /*! @brief Number of frames, 0 for endless */
+    uint32_t numOfFrames;
+} ConfigCmd_FrameCfg;
+
+/**
+ * @brief Chirp profile carried by a command record, in the units of the .cfg file.
+ */
+typedef struct ConfigCmd_Profile_t
+{
+    ConfigCmd_ChannelCfg     channelCfg;
+    ConfigCmd_ChirpComnCfg   chirpComnCfg;
+    ConfigCmd_ChirpTimingCfg chirpTimingCfg;
+    ConfigCmd_FrameCfg       frameCfg;
+} ConfigCmd_Profile;
+
+/**
+ * @brief Profile in the units of the front-end API, as defines.h derives them
+ *        (CLI_CHIRP_IDLE_TIME, CLI_CHIRP_FREQ_SLOPE, CLI_FRAME_PERIOD, ...).
+ */
+typedef struct ConfigCmd_SensorParams_t
+{
+    /*! @brief h_ChirpRampEndTime, 10 ns units */
+    uint16_t rampEndTime;
+
+    /*! @brief h_ChirpIdleTime, 10 ns units */
+    uint16_t idleTime;
+
+    /*! @brief h_ChirpAdcStartTime, skip samples << 10 */
+    uint16_t adcStartTime;
+
+    /*! @brief xh_ChirpTxStartTime, 20 ns units */
+    int16_t txStartTime;
+
+    /*! @brief xh_ChirpRfFreqSlope, 3 * 100 * 100 / 2^20 MHz/us units */
+    int16_t freqSlope;
+
+    /*! @brief w_ChirpRfFreqStart, 300 / 256 MHz units */
+    uint32_t freqStart;
+
+    /*! @brief w_BurstPeriodicity, 100 ns units */
+    uint32_t burstPeriod;
+
+    /*! @brief w_FramePeriodicity, 40 MHz ticks */
+    uint32_t framePeriod;
+
+    /*! @brief Number of range bins (half the power of 2 range FFT size) */
+    uint32_t numRangeBins;
+} ConfigCmd_SensorParams;
+
+/**
+ * @brief Limits a profile is validated against.
+ */
+typedef struct ConfigCmd_Limits_t
+{
+    /*! @brief Maximum ADC samples per chirp (ADC buffer and range FFT) */
+    uint32_t maxAdcSamples;
+
+    /*! @brief Minor motion chirps per frame, 0 without minor motion cube */
+    uint32_t numMinorChirps;
+
+    /*! @brief Bytes free for the radar cubes once the pipeline is released (largest DMA and HWA capable region) */
+    uint32_t freeBytes;
+
+    /*! @brief Bytes which must remain free after the cubes */
+    uint32_t reserveBytes;
+} ConfigCmd_Limits;
+
+/**
+ * @brief Sensor and pipeline operations of the reconfiguration, return 0 on success.
+ */
+typedef struct ConfigCmd_Ops_t
+{
+    /*! @brief Stops the sensor at a frame boundary */
+    int32_t (*stopSensor)(void *arg);
+
+    /*! @brief Configures the front end and the processing pipeline for a profile */
+    int32_t (*applyProfile)(void *arg, const ConfigCmd_Profile *profile);
+
+    /*! @brief Arms the pipeline and restarts the sensor */
+    int32_t (*startSensor)(void *arg);
+
+    /*! @brief Passed to the callbacks */
+    void *arg;
+} ConfigCmd_Ops;
+
+/**
+ * @brief Reconfiguration state.
+ */
+typedef struct ConfigCmd_Ctrl_t
+{
+    /*! @brief CONFIG_CMD_STATE_* */
+    uint32_t state;
+
+    /*! @brief Profile the sensor and pipeline run with */
+    ConfigCmd_Profile active;
+
+    /*! @brief Received profile, applied by the next ConfigCmd_service() */
+    ConfigCmd_Profile pending;
+
+    /*! @brief Limits received profiles are validated against */
+    ConfigCmd_Limits limits;
+
+    /*! @brief Sequence number of the last record */
+    uint32_t lastSequence;
+
+    /*! @brief Result of the last record (CONFIG_CMD_OK or CONFIG_CMD_ERR_*) */
+    int32_t lastResult;
+
+    /*! @brief Number of profiles applied */
+    uint32_t numApplied;
+
+    /*! @brief Number of records rejected or rolled back */
+    uint32_t numRejected;
+} ConfigCmd_Ctrl;
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected, as zlib.crc32()).
+ */
+uint32_t ConfigCmd_crc32(const void *data, uint32_t numBytes);
+
+/**
+ * @brief Encodes a profile record.
+ *
+ * @param profile   profile
+ * @param sequence  sequence number (16 bits)
+ * @param words     output, at least CONFIG_CMD_RECORD_WORDS
+ * @return CONFIG_CMD_RECORD_WORDS
+ */
+uint32_t ConfigCmd_encode(const ConfigCmd_Profile *profile, uint32_t sequence, uint32_t *words);
+
+/**
+ * @brief Decodes and checks a profile record.
+ *
+ * @param words     received words
+ * @param numWords  number of received words
+ * @param profile   output
+ * @param sequence  output: sequence number
+ * @return CONFIG_CMD_OK, CONFIG_CMD_ERR_NO_RECORD, _VERSION, _LENGTH or _CRC
+ */
+int32_t ConfigCmd_decode(const uint32_t *words, uint32_t numWords,
+                         ConfigCmd_Profile *profile, uint32_t *sequence);
+
+/**
+ * @brief Checks whether a profile can replace the active one.
+ *
+ * @return CONFIG_CMD_OK, CONFIG_CMD_ERR_CHANNEL, _INVALID or _BUDGET
+ */
+int32_t ConfigCmd_validate(const ConfigCmd_Profile *profile, const ConfigCmd_Profile *active,
+                           const ConfigCmd_Limits *limits);
+
+/**
+ * @brief Converts a profile into the units of the front-end API.
+ */
+void ConfigCmd_toSensorParams(const ConfigCmd_Profile *profile, ConfigCmd_SensorParams *params);
+
+/**
+ * @brief Initializes the state with the profile the sensor was started with.
+ */
+void ConfigCmd_init(ConfigCmd_Ctrl *ctrl, const ConfigCmd_Profile *active, const ConfigCmd_Limits *limits);
+
+/**
+ * @brief Handles a received slot: decodes and validates a record and queues its profile.
+ *
+ * A slot without magic is ignored (no state change), any other result is
+ * kept for the status record.
+ *
+ * @return CONFIG_CMD_OK if a profile was queued, otherwise CONFIG_CMD_ERR_*
+ */
+int32_t ConfigCmd_receive(ConfigCmd_Ctrl *ctrl, const uint32_t *words, uint32_t numWords);
+
+/**
+ * @brief Applies a queued profile, to be called at a frame boundary.
+ *
+ * Stops the sensor, applies the profile and restarts the sensor. If the
+ * profile fails, the previous one is applied again before the restart.
+ *
+ * @return 0 if nothing was queued or the sensor could not be stopped (still
+ *         running), 1 if the sensor was restarted (with the new or the previous
+ *         profile, see lastResult), -1 if the sensor is left stopped
+ */
+int32_t ConfigCmd_service(ConfigCmd_Ctrl *ctrl, const ConfigCmd_Ops *ops);
+
+/**
+ * @brief Encodes the status record: state, last sequence and result, CRC of the active profile.
+ *
+ * @param ctrl   state
+ * @param words  output, at least CONFIG_CMD_STATUS_WORDS
+ * @return CONFIG_CMD_STATUS_WORDS
+ */
+uint32_t ConfigCmd_encodeStatus(const ConfigCmd_Ctrl *ctrl, uint32_t *words);
+
+#endif /* CONFIG_CMD_H */
@@ -0,0 +1,81 @@
+#ifndef CUBE_BUDGET_H
+#define CUBE_BUDGET_H
+
+/**
+ * @file cube_budget.h
+ * @brief Memory accounting of the major and minor motion radar cubes.
+ *
+ * Both cubes are DPIF_RADARCUBE_FORMAT_6 (one cmplx16 sample per range bin,
+ * virtual antenna and doppler chirp) and are allocated one after the other
+ * from the shared memory regions, each aligned to 4 bytes. Checking them
+ * against the free bytes of the largest region (MemRegion_getLargestFree())
+ * guarantees that both are placed. The check is done before the
+ * allocation, so that a configuration which does not fit is reported with
+ * the sizes involved instead of a failed allocation.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Dimensions of the cubes and the memory available for them.
+ */
+typedef struct CubeBudget_Config_t
+{
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps of the major motion cube, 0 if disabled */
+    uint32_t numMajorChirps;
+
+    /*! @brief Number of doppler chirps of the minor motion cube (<= numMajorChirps), 0 if disabled */
+    uint32_t numMinorChirps;
+
+    /*! @brief Bytes still free before the cubes are allocated */
+    uint32_t freeBytes;
+
+    /*! @brief Bytes which must remain free after the cubes (products allocated later) */
+    uint32_t reserveBytes;
+} CubeBudget_Config;
+
+/**
+ * @brief Result of the memory accounting.
+ */
+typedef struct CubeBudget_Report_t
+{
+    /*! @brief Size of the major motion cube */
+    uint32_t majorBytes;
+
+    /*! @brief Size of the minor motion cube */
+    uint32_t minorBytes;
+
+    /*! @brief Bytes taken from the pool by both cubes, including alignment */
+    uint32_t totalBytes;
+
+    /*! @brief Bytes left after the cubes and the reserve, negative if the budget is exceeded */
+    int32_t headroomBytes;
+} CubeBudget_Report;
+
+/**
+ * @brief Returns the size of one cube.
+ *
+ * @param numRangeBins        number of range bins
+ * @param numVirtualAntennas  number of virtual antennas
+ * @param numChirps           number of doppler chirps
+ * @return size in bytes, 0 on overflow
+ */
+uint32_t CubeBudget_getCubeSize(uint32_t numRangeBins, uint32_t numVirtualAntennas, uint32_t numChirps);
+
+/**
+ * @brief Computes the memory needed by the cubes and checks it against the budget.
+ *
+ * @param cfg     dimensions and budget
+ * @param report  output, sizes are filled in unless the dimensions are invalid
+ * @return 0 if both cubes and the reserve fit, -1 otherwise or if the minor
+ *         cube has more chirps than the major cube
+ */
+int32_t CubeBudget_check(const CubeBudget_Config *cfg, CubeBudget_Report *report);
+
+#endif /* CUBE_BUDGET_H */
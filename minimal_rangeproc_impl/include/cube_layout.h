@@ -0,0 +1,89 @@
+#ifndef CUBE_LAYOUT_H
+#define CUBE_LAYOUT_H
+
+/**
+ * @file cube_layout.h
+ * @brief Conversion of the radar cube between DPIF_RADARCUBE_FORMAT_6 and host-friendly layouts.
+ *
+ * The range DPU writes the cube as x[chirp][antenna][rangeBin] of cmplx16
+ * samples with the imaginary part first (DPIF_RADARCUBE_FORMAT_6). Doppler or
+ * angle processing on the host then has to gather strided samples. Before the
+ * cube is streamed it can be reordered so that the dimension a consumer
+ * iterates over is contiguous:
+ *
+ *   | order                     | layout                       | contiguous |
+ *   |---------------------------|------------------------------|------------|
+ *   | CUBE_LAYOUT_CHIRP_MAJOR   | [chirp][antenna][rangeBin]   | range bins (native) |
+ *   | CUBE_LAYOUT_RANGE_MAJOR   | [rangeBin][antenna][chirp]   | chirps (Doppler FFT) |
+ *   | CUBE_LAYOUT_ANTENNA_MAJOR | [antenna][chirp][rangeBin]   | range-chirp map per antenna |
+ *
+ * The I/Q samples are either kept interleaved (imaginary, real as in the
+ * native cube) or split into a plane of all real parts followed by a plane
+ * of all imaginary parts, each in the selected order.
+ *
+ * The orders are plain defines so that they can be used in preprocessor
+ * conditions (see STREAM_CUBE_LAYOUT_ORDER). The host can convert the
+ * streamed cube back or into another layout with the same code.
+ */
+
+#include <stdint.h>
+
+/*! @brief [chirp][antenna][rangeBin], the native DPIF_RADARCUBE_FORMAT_6 order */
+#define CUBE_LAYOUT_CHIRP_MAJOR     0
+
+/*! @brief [rangeBin][antenna][chirp] */
+#define CUBE_LAYOUT_RANGE_MAJOR     1
+
+/*! @brief [antenna][chirp][rangeBin] */
+#define CUBE_LAYOUT_ANTENNA_MAJOR   2
+
+/**
+ * @brief Cube dimensions and target layout.
+ */
+typedef struct CubeLayout_Config_t
+{
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint32_t numChirps;
+
+    /*! @brief Order of the dimensions, CUBE_LAYOUT_* */
+    uint8_t order;
+
+    /*! @brief Split real and imaginary parts into two planes (1) or keep them interleaved (0) */
+    uint8_t iqSplit;
+} CubeLayout_Config;
+
+/**
+ * @brief Returns whether a layout differs from the native cube, i.e. needs a conversion.
+ *
+ * @param cfg  layout
+ * @return 1 if CubeLayout_fromNative() reorders the cube, 0 if it is a plain copy
+ */
+uint32_t CubeLayout_isConverted(const CubeLayout_Config *cfg);
+
+/**
+ * @brief Reorders a native cube into the configured layout.
+ *
+ * @param cfg  dimensions and layout
+ * @param src  native cube, 2 * numRangeBins * numVirtualAntennas * numChirps int16 values
+ * @param dst  output of the same size, must not overlap src
+ * @return 0 on success, -1 on an unknown order
+ */
+int32_t CubeLayout_fromNative(const CubeLayout_Config *cfg, const int16_t *src, int16_t *dst);
+
+/**
+ * @brief Reorders a cube in the configured layout back into the native layout.
+ *
+ * @param cfg  dimensions and layout of src
+ * @param src  cube in the configured layout
+ * @param dst  native cube of the same size, must not overlap src
+ * @return 0 on success, -1 on an unknown order
+ */
+int32_t CubeLayout_toNative(const CubeLayout_Config *cfg, const int16_t *src, int16_t *dst);
+
+#endif /* CUBE_LAYOUT_H */
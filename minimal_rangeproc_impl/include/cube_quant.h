@@ -0,0 +1,126 @@
+#ifndef CUBE_QUANT_H
+#define CUBE_QUANT_H
+
+/**
+ * @file cube_quant.h
+ * @brief Int8 quantisation of the radar cube.
+ *
+ * The radar cube holds 16-bit I/Q samples (cmplx16ImRe_t). This module
+ * quantises them to 8-bit I/Q, which halves the number of bytes that have to be
+ * streamed per frame. The quantisation step is chosen from the peak magnitude
+ * either over the full frame or separately for every range bin, and can
+ * optionally be dithered to decorrelate the quantisation error from the signal.
+ *
+ * Layout of the quantised payload (following the StreamRecord_Header):
+ *   - CubeQuant_Header
+ *   - float scales[numScales]          (1 per frame or 1 per range bin)
+ *   - int8_t samples[2 * numRangeBins * numRows], same order as the input cube
+ *   - padding to a multiple of 4 bytes
+ *
+ * A sample is reconstructed with x = q * scales[g], where g is 0 for the
+ * per-frame granularity or the range bin index for the per-bin granularity.
+ */
+
+#include <stdint.h>
+
+/*! @brief Largest magnitude of a quantised sample (symmetric range, -128 is unused) */
+#define CUBE_QUANT_MAX_CODE     (127)
+
+/**
+ * @brief Granularity of the quantisation scale factors.
+ */
+typedef enum CubeQuant_Granularity_e
+{
+    /*! @brief One scale factor for the whole frame */
+    CUBE_QUANT_GRANULARITY_PER_FRAME = 0,
+
+    /*! @brief One scale factor per range bin */
+    CUBE_QUANT_GRANULARITY_PER_RANGE_BIN = 1
+} CubeQuant_Granularity;
+
+/**
+ * @brief Configuration of the quantiser.
+ */
+typedef struct CubeQuant_Config_t
+{
+    /*! @brief Scale factor granularity */
+    CubeQuant_Granularity granularity;
+
+    /*! @brief Adds +-0.5 LSB uniform dither before rounding if non-zero */
+    uint8_t ditherEnable;
+
+    /*! @brief Number of range bins (innermost dimension of the cube) */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of range lines in the cube (doppler chirps x virtual antennas) */
+    uint32_t numRows;
+} CubeQuant_Config;
+
+/**
+ * @brief Header preceding the scale factors and samples in the stream.
+ */
+typedef struct CubeQuant_Header_t
+{
+    /*! @brief Scale factor granularity, see @ref CubeQuant_Granularity */
+    uint8_t granularity;
+
+    /*! @brief Non-zero if the samples were dithered */
+    uint8_t ditherEnable;
+
+    /*! @brief Number of float scale factors following the header */
+    uint16_t numScales;
+
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Number of range lines */
+    uint32_t numRows;
+
+    /*! @brief Signal to quantisation noise ratio of this frame in dB */
+    float sqnrDb;
+} CubeQuant_Header;
+
+/**
+ * @brief Returns the number of scale factors for a configuration.
+ *
+ * @param cfg  quantiser configuration
+ * @return number of scale factors
+ */
+uint32_t CubeQuant_getNumScales(const CubeQuant_Config *cfg);
+
+/**
+ * @brief Returns the size of the quantised payload for a configuration.
+ *
+ * @param cfg  quantiser configuration
+ * @return payload size in bytes (header, scales and samples, multiple of 4)
+ */
+uint32_t CubeQuant_getPayloadSize(const CubeQuant_Config *cfg);
+
+/**
+ * @brief Quantises a 16-bit I/Q radar cube to 8-bit I/Q.
+ *
+ * @param cfg          quantiser configuration
+ * @param cube         input cube, 2 * numRangeBins * numRows int16 values
+ * @param payload      output buffer of CubeQuant_getPayloadSize() bytes, 4 byte aligned
+ * @param ditherState  state of the dither noise generator, must be non-zero.
+ *                     Only used if dithering is enabled.
+ * @return 0 on success, -1 on invalid arguments
+ */
+int32_t CubeQuant_quantize(const CubeQuant_Config *cfg,
+                           const int16_t *cube,
+                           void *payload,
+                           uint32_t *ditherState);
+
+/**
+ * @brief Reconstructs a 16-bit I/Q radar cube from a quantised payload.
+ *
+ * @param payload  payload as written by CubeQuant_quantize()
+ * @param cube     output cube, 2 * numRangeBins * numRows int16 values
+ * @return 0 on success, -1 on an invalid payload header
+ */
+int32_t CubeQuant_dequantize(const void *payload, int16_t *cube);
+
+#endif /* CUBE_QUANT_H */
@@ -0,0 +1,240 @@
+#ifndef DOA_H
+#define DOA_H
+
+/**
+ * @file doa.h
+ * @brief Angle of arrival estimation across the virtual antennas of the radar cube.
+ *
+ * The virtual antennas are placed on a grid with half a wavelength spacing,
+ * given per virtual antenna (index tx * numRxAntennas + rx) by a row and a
+ * column. Row 0 is the azimuth row, row 1 (if present) is one half wavelength
+ * above it and is only used for the elevation estimate.
+ *
+ * Two products are provided:
+ *
+ * Range-azimuth heatmap: for every range bin and chirp the samples of the row
+ * 0 antennas are placed at their column (zero for empty columns and up to
+ * azimuthFftSize) and transformed with an azimuthFftSize point FFT. The
+ * magnitudes are summed non-coherently over the chirps:
+ *
+ *   H[bin][azimuthBin] = (sum over chirps of |X[azimuthBin]|) >> shift
+ *
+ * with shift = Doa_getShift(numChirps). No window is applied and every
+ * butterfly stage is scaled by 1/2, as done by the HWA on the device (see
+ * doa_proc.h). Azimuth bins are in FFT order, bin k corresponds to
+ * sin(azimuth) = 2 * k / azimuthFftSize (k above azimuthFftSize / 2 taken as
+ * k - azimuthFftSize). Doa_computeHeatmap() is the reference model of the
+ * device computation; it computes in double precision, so the device output
+ * is expected to match within a few LSB.
+ *
+ * Angle estimates: for a (range bin, Doppler bin) cell, the Doppler bin is
+ * extracted from every virtual antenna by a single bin DFT over the chirps.
+ * The azimuth is taken from the peak of the zero padded azimuth spectrum of
+ * row 0, refined by parabolic interpolation. The elevation is taken from the
+ * phase difference between row 1 and row 0, both steered to the azimuth peak,
+ * and the azimuth is corrected for the elevation. This is a few hundred
+ * multiplications per detection and is done by the CPU.
+ *
+ * Layout of the heatmap payload (following the StreamRecord_Header):
+ *   - Doa_HeatmapHeader
+ *   - numRangeBins x azimuthFftSize uint16 values, range bin major
+ *
+ * Layout of the estimate list (following the StreamRecord_Header):
+ *   - Doa_ListHeader
+ *   - numEstimates Doa_Estimate entries, in the order of the input cells
+ */
+
+#include <stdint.h>
+
+/*! @brief Largest supported number of virtual antennas */
+#define DOA_MAX_VIRTUAL_ANTENNAS    (16U)
+
+/*! @brief Largest supported azimuth FFT size */
+#define DOA_MAX_AZIMUTH_FFT_SIZE    (64U)
+
+/*! @brief Row of an antenna which is not used for the angle estimation */
+#define DOA_ANT_UNUSED              (0xFFU)
+
+/**
+ * @brief Configuration of the angle estimation.
+ */
+typedef struct Doa_Config_t
+{
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint16_t numChirps;
+
+    /*! @brief Azimuth FFT size (power of 2, larger than the largest row 0 column) */
+    uint16_t azimuthFftSize;
+
+    /*! @brief Doppler FFT size the Doppler bin indices of the estimates refer to */
+    uint16_t dopplerFftSize;
+
+    /*! @brief Number of columns covered by row 0 (largest column + 1), set by Doa_init() */
+    uint16_t numAzimuthCols;
+
+    /*! @brief Number of row 0 antennas, set by Doa_init() */
+    uint16_t numAzimuthAnt;
+
+    /*! @brief Row (0 or 1, or DOA_ANT_UNUSED) of every virtual antenna */
+    uint8_t antRow[DOA_MAX_VIRTUAL_ANTENNAS];
+
+    /*! @brief Column of every virtual antenna */
+    uint8_t antCol[DOA_MAX_VIRTUAL_ANTENNAS];
+
+    /*! @brief Virtual antenna of every row 0 column, DOA_ANT_UNUSED if empty, set by Doa_init() */
+    uint8_t azimuthAnt[DOA_MAX_AZIMUTH_FFT_SIZE];
+
+    /*! @brief 1 if row 1 contains antennas (elevation available), set by Doa_init() */
+    uint8_t elevationEn;
+} Doa_Config;
+
+/**
+ * @brief Header of the range-azimuth heatmap payload.
+ */
+typedef struct Doa_HeatmapHeader_t
+{
+    /*! @brief Number of range bins (rows) */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of azimuth bins (columns, azimuth FFT size) */
+    uint16_t numAzimuthBins;
+
+    /*! @brief Number of chirps summed per value */
+    uint16_t numChirps;
+
+    /*! @brief Right shift applied to the chirp sums, see Doa_getShift() */
+    uint8_t shift;
+
+    /*! @brief Number of columns of the azimuth row */
+    uint8_t numAzimuthCols;
+
+    /*! @brief Duration of the DoA stage in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+
+    /*! @brief Part of computeTicks during which the HWA was busy, 0 if unknown */
+    uint32_t hwaTicks;
+} Doa_HeatmapHeader;
+
+/**
+ * @brief Header of the estimate list.
+ */
+typedef struct Doa_ListHeader_t
+{
+    /*! @brief Number of valid estimates */
+    uint16_t numEstimates;
+
+    /*! @brief 1 if the elevation of the estimates is valid, 0 if it is always 0 */
+    uint8_t elevationEn;
+
+    /*! @brief Reserved, always 0 */
+    uint8_t reserved;
+
+    /*! @brief Duration of the estimation in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} Doa_ListHeader;
+
+/**
+ * @brief Entry of the estimate list.
+ */
+typedef struct Doa_Estimate_t
+{
+    /*! @brief Range bin index */
+    uint16_t rangeIdx;
+
+    /*! @brief Doppler bin index (FFT order) */
+    uint16_t dopplerIdx;
+
+    /*! @brief Azimuth in degrees, Q7, positive towards increasing column */
+    int16_t azimuthDegQ7;
+
+    /*! @brief Elevation in degrees, Q7, positive towards row 1 */
+    int16_t elevationDegQ7;
+
+    /*! @brief Magnitude of the steered row 0 sum per sample (chirps x row 0 antennas), saturated to 16 bits */
+    uint16_t level;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+} Doa_Estimate;
+
+/**
+ * @brief Validates the antenna geometry and derives the azimuth column map.
+ *
+ * @param cfg  configuration, antRow/antCol and the dimensions must be set
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t Doa_init(Doa_Config *cfg);
+
+/**
+ * @brief Returns the right shift applied to the sum over the chirps.
+ *
+ * @param numChirps  number of chirps
+ * @return ceil(log2(numChirps))
+ */
+uint32_t Doa_getShift(uint32_t numChirps);
+
+/**
+ * @brief Returns the size of the heatmap without header.
+ *
+ * @param cfg  configuration
+ * @return size in bytes
+ */
+uint32_t Doa_getHeatmapSize(const Doa_Config *cfg);
+
+/**
+ * @brief Returns the size of an estimate list with maxEstimates entries.
+ *
+ * @param maxEstimates  maximum number of estimates
+ * @return size in bytes (multiple of 4)
+ */
+uint32_t Doa_getListSize(uint32_t maxEstimates);
+
+/**
+ * @brief Returns the size of the valid part of an estimate list.
+ *
+ * @param list  estimate list
+ * @return size in bytes (multiple of 4)
+ */
+uint32_t Doa_getUsedListSize(const void *list);
+
+/**
+ * @brief Sums azimuth magnitudes over the chirps for a group of range bins.
+ *
+ * Used by the device after the HWA pass and by the reference model.
+ *
+ * @param mag      magnitudes, [numChirps][numBins][azimuthFftSize]
+ * @param numBins  number of range bins of the group
+ * @param cfg      configuration
+ * @param heatmap  output, first row of the group, [numBins][azimuthFftSize]
+ */
+void Doa_sumChirps(const uint16_t *mag, uint32_t numBins, const Doa_Config *cfg, uint16_t *heatmap);
+
+/**
+ * @brief Reference model of the range-azimuth heatmap computation.
+ *
+ * @param cfg      configuration (initialised by Doa_init())
+ * @param cube     radar cube in FORMAT_6 (cmplx16ImRe_t samples)
+ * @param heatmap  output, Doa_getHeatmapSize() bytes
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t Doa_computeHeatmap(const Doa_Config *cfg, const int16_t *cube, uint16_t *heatmap);
+
+/**
+ * @brief Estimates azimuth and elevation of one (range bin, Doppler bin) cell.
+ *
+ * @param cfg         configuration (initialised by Doa_init())
+ * @param cube        radar cube in FORMAT_6 (cmplx16ImRe_t samples)
+ * @param rangeIdx    range bin index
+ * @param dopplerIdx  Doppler bin index (FFT order, of dopplerFftSize)
+ * @param est         output estimate
+ */
+void Doa_estimate(const Doa_Config *cfg, const int16_t *cube, uint32_t rangeIdx, uint32_t dopplerIdx,
+                  Doa_Estimate *est);
+
+#endif /* DOA_H */
@@ -0,0 +1,74 @@
+#ifndef DOA_PROC_H
+#define DOA_PROC_H
+
+/**
+ * @file doa_proc.h
+ * @brief Angle of arrival stage computing a range-azimuth heatmap and per-detection angles.
+ *
+ * Range-azimuth heatmap (DOAPROC_HEATMAP_ENABLE): the radar cube is processed
+ * on the HWA in groups of range bins, like in the Doppler stage:
+ *   1. the EDMA gathers the samples of every azimuth column (row 0 antenna of
+ *      the geometry) of the group into HWA memory bank M0, one manually
+ *      triggered transfer per column (layout [column][chirp][bin]); empty
+ *      columns are zeroed by the CPU,
+ *   2. one HWA param set computes the azimuth FFT of every (chirp, bin)
+ *      sequence, zero padded to DOAPROC_AZIMUTH_FFT_SIZE, and writes the
+ *      16-bit magnitudes to bank M2 (layout [chirp][bin][azimuthBin]),
+ *   3. the CPU sums the magnitudes over the chirps into the heatmap
+ *      (Doa_sumChirps()).
+ * The time the HWA is busy is measured separately from the duration of the
+ * whole stage and reported in the heatmap header.
+ *
+ * Angle estimates (DOAPROC_ESTIMATES_ENABLE): azimuth and elevation of every
+ * CFAR detection of the frame, computed by the CPU with Doa_estimate().
+ *
+ * See doa.h for the output formats and the reference model. The stage uses
+ * the input pong EDMA channel of the DoA DPU (the ping channel is used by the
+ * Doppler stage) and the HWA param set after the one of the Doppler stage.
+ */
+
+#include <stdint.h>
+
+/*! @brief Run the DoA stage every frame (1) or not (0) */
+#define DOAPROC_ENABLE                  0
+
+/*! @brief Compute the range-azimuth heatmap on the HWA (1) or not (0) */
+#define DOAPROC_HEATMAP_ENABLE          1
+
+/*! @brief Estimate the angles of the CFAR detections (1, requires CFARPROC_ENABLE) or not (0) */
+#define DOAPROC_ESTIMATES_ENABLE        0
+
+/*! @brief Azimuth FFT size (power of 2) */
+#define DOAPROC_AZIMUTH_FFT_SIZE        32
+
+/**
+ * @brief Row and column of every virtual antenna (tx * numRxAntennas + rx), in
+ *        half wavelengths. Must match the antenna layout of the board, the
+ *        default is an L-shaped IWRL6432BOOST-like layout with 4 azimuth columns.
+ */
+#define DOAPROC_ANT_ROW                 {0, 0, 1, 0, 0, 1}
+#define DOAPROC_ANT_COL                 {0, 1, 1, 2, 3, 3}
+
+/*! @brief HWA param set used by the stage (the range DPU and the Doppler stage use the ones before) */
+#define DOAPROC_HWA_PARAMSET_IDX        (DPU_RANGEPROCHWA_NUM_HWA_PARAM_SETS + 1)
+
+/**
+ * @brief Allocates the outputs and configures EDMA and HWA param set.
+ *
+ * Must be called after RangeProc_config() and CfarProc_config().
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t DoaProc_config(void);
+
+/**
+ * @brief Computes the range-azimuth heatmap and the angle estimates of the current frame.
+ *
+ * Must be called after CfarProc_process() and before the next
+ * DPU_RangeProcHWA_Cmd_triggerProc.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t DoaProc_process(void);
+
+#endif /* DOA_PROC_H */
@@ -0,0 +1,62 @@
+#ifndef DOPPLER_PROC_H
+#define DOPPLER_PROC_H
+
+/**
+ * @file doppler_proc.h
+ * @brief Doppler processing stage computing a range-Doppler heatmap on the HWA.
+ *
+ * The stage runs after the range processing of every frame, while the HWA is
+ * idle until the next DPU_RangeProcHWA_Cmd_triggerProc. The radar cube is
+ * processed in groups of range bins:
+ *   1. an EDMA transfer gathers the samples of the group from the radar cube
+ *      into HWA memory bank M0 (one manually triggered AB-synchronised
+ *      transfer, layout [chirp][antenna][bin]),
+ *   2. one HWA param set computes the windowed Doppler FFT of every
+ *      (antenna, bin) sequence and writes the 16-bit magnitudes to bank M2
+ *      (layout [antenna][bin][dopplerBin]),
+ *   3. the CPU sums the magnitudes over the antennas into the heatmap
+ *      (RdHeatmap_sumAntennas()).
+ *
+ * All butterfly stages of the FFT are scaled, see rd_heatmap.h for the output
+ * format and the fixed-point reference model.
+ *
+ * The stage uses the input ping EDMA channel of the DoA DPU (in the motion and
+ * presence detection demo the Doppler FFT is part of the DoA DPU) and the
+ * first HWA param set after the ones of the range DPU.
+ */
+
+#include <stdint.h>
+
+/*! @brief Run the Doppler stage every frame (1) or not (0) */
+#define DOPPLERPROC_ENABLE                  0
+
+/*! @brief Window applied before the Doppler FFT */
+#define DOPPLERPROC_WINDOW_TYPE             MATHUTILS_WIN_HANNING
+
+/*! @brief Q format of the Doppler window, equal to RD_HEATMAP_WINDOW_QFORMAT */
+#define DPC_OBJDET_QFORMAT_DOPPLER_FFT      17
+
+/*! @brief HWA param set used by the stage (the range DPU uses the ones before) */
+#define DOPPLERPROC_HWA_PARAMSET_IDX        (DPU_RANGEPROCHWA_NUM_HWA_PARAM_SETS)
+
+/**
+ * @brief Allocates the heatmap and configures EDMA, HWA param set and window RAM.
+ *
+ * Must be called after RangeProc_config().
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t DopplerProc_config(void);
+
+/**
+ * @brief Computes the range-Doppler heatmap of the current radar cube.
+ *
+ * Must be called after DPU_RangeProcHWA_process() and before the next
+ * DPU_RangeProcHWA_Cmd_triggerProc.
+ *
+ * @param computeTicks  output, duration of the stage in ticks of the 40 MHz frame reference timer
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t DopplerProc_process(uint32_t *computeTicks);
+
+#endif /* DOPPLER_PROC_H */
@@ -142,6 +142,12 @@ extern "C" {
 #define DPC_OBJDET_DPU_DOAPROC_INTER_LOOP_EDMA_CHAIN_BACK_SHADOW         (DPC_OBJDET_EDMA_SHADOW_BASE + 20)
 #define DPC_OBJDET_DPU_DOAPROC_INTER_LOOP_EDMA_CHAIN_BACK_EVENT_QUE      0
 
+/* Doppler stage (doppler_proc.c): the Doppler FFT is part of the DoA DPU in the demo,
+   the stage gathers its input with the DoA input ping channel */
+#define DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_CH                             DPC_OBJDET_DPU_DOAPROC_EDMAIN_PING_CH
+#define DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_SHADOW                         DPC_OBJDET_DPU_DOAPROC_EDMAIN_PING_SHADOW
+#define DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_EVENT_QUE                      DPC_OBJDET_DPU_DOAPROC_EDMAIN_PING_EVENT_QUE
+
 /* CFAR DPU */
 #define DPC_OBJDET_DPU_CFAR_PROC_EDMAIN_CH                               EDMA_APPSS_TPCC_B_EVT_FREE_13
 #define DPC_OBJDET_DPU_CFAR_PROC_EDMAIN_SHADOW                           (DPC_OBJDET_EDMA_SHADOW_BASE + 21)
@@ -44,15 +44,27 @@
 
 
 
+#include "cal_store.h"
+
 /**
  * @brief Magic word for factory calibration data validation.
  *
  * This value is stored in flash alongside calibration data and checked upon 
- * restoration to verify data integrity. It acts as a simple checksum to ensure 
- * the calibration data is valid.
+ * restoration, together with the version and the CRC-32 of the calibration data
+ * (see cal_store.h). Records of the demo format (magic directly followed by the
+ * data) are restored as well and kept in flash.
  */
 #define MMWDEMO_CALIB_STORE_MAGIC (0x7CB28DF9U)
 
+/**
+ * @brief Run the boot calibration and save its result to flash if no valid record exists (1),
+ *        or boot uncalibrated in this case (0).
+ *
+ * The record is written to CLI_FACCALCFG_FLASH_OFFSET. A profile blob in the same
+ * erase block (PROFILE_BLOB_FLASH_OFFSET) is preserved.
+ */
+#define FACTORY_CAL_GENERATE_ENABLE 1
+
 
 
 /*!
@@ -64,8 +76,8 @@
  */
 typedef struct Mmw_calibData_t
 {
-    /*! @brief      Magic word for calibration data */
-    uint32_t 	    magic;
+    /*! @brief      Magic word, version and CRC-32 of calibData */
+    CalStore_Header header;
 
     /*! @brief      RX TX Calibration data */
     T_RL_API_FECSS_RXTX_CAL_DATA  calibData;
@@ -75,7 +87,9 @@ typedef struct Mmw_calibData_t
  * @brief Restores factory calibration data from flash.
  *
  * This function reads the calibration data stored in flash memory and restores it.
- * It requires that the system has been previously calibrated.
+ * Without a valid record the boot calibration is run and its result saved
+ * (FACTORY_CAL_GENERATE_ENABLE), so only the first boot of a device calibrates.
+ * On a warm boot the record retained in RAM is restored without flash access.
  *
  * Derived from `mmwDemo_factoryCal` and `MmwDemo_calibRestore` in `factory_cal.c` 
  * from the demo project.
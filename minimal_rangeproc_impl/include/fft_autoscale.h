@@ -0,0 +1,118 @@
+#ifndef FFT_AUTOSCALE_H
+#define FFT_AUTOSCALE_H
+
+/**
+ * @file fft_autoscale.h
+ * @brief Closed-loop scaling of the range FFT output.
+ *
+ * The range FFT output is scaled down by a total shift which is split into the
+ * HWA output shift (rangeFFTtuning.fftOutputDivShift) and the number of scaled
+ * butterfly stages (rangeFFTtuning.numLastButterflyStagesToScale).
+ *
+ * After every frame the peak magnitude and the number of saturated samples of
+ * the radar cube are measured. The controller increases the shift immediately
+ * if the cube saturates and decreases it after a number of consecutive frames
+ * in which the peak stays below the headroom threshold (hysteresis), so that
+ * the cube uses the available 16 bits without clipping.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Configuration of the auto-scaling controller.
+ */
+typedef struct FftAutoScale_Config_t
+{
+    /*! @brief Smallest total shift */
+    uint8_t minShift;
+
+    /*! @brief Largest total shift */
+    uint8_t maxShift;
+
+    /*! @brief Largest shift applied via fftOutputDivShift, the rest is applied
+     *         by scaling the last butterfly stages */
+    uint8_t maxDivShift;
+
+    /*! @brief Magnitude from which a sample counts as saturated */
+    uint16_t satThreshold;
+
+    /*! @brief Number of saturated samples per frame which trigger a shift increase */
+    uint32_t satCountUp;
+
+    /*! @brief Peak magnitude below which one bit of the output is unused */
+    uint16_t headroomLow;
+
+    /*! @brief Number of consecutive frames below headroomLow before the shift is decreased */
+    uint16_t framesDown;
+} FftAutoScale_Config;
+
+/**
+ * @brief Per-frame statistics of the radar cube.
+ */
+typedef struct FftAutoScale_Stats_t
+{
+    /*! @brief Largest magnitude of any I or Q value */
+    uint16_t peak;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Number of I or Q values with a magnitude >= satThreshold */
+    uint32_t numSaturated;
+} FftAutoScale_Stats;
+
+/**
+ * @brief State of the auto-scaling controller.
+ */
+typedef struct FftAutoScale_State_t
+{
+    /*! @brief Currently applied total shift */
+    uint8_t shift;
+
+    /*! @brief Number of consecutive frames with the peak below headroomLow */
+    uint16_t lowFrameCount;
+} FftAutoScale_State;
+
+/**
+ * @brief Initialises the controller state.
+ *
+ * @param cfg           controller configuration
+ * @param state         controller state
+ * @param initialShift  total shift applied to the first frame, clipped to [minShift, maxShift]
+ */
+void FftAutoScale_init(const FftAutoScale_Config *cfg, FftAutoScale_State *state, uint8_t initialShift);
+
+/**
+ * @brief Measures peak and saturation count of a radar cube.
+ *
+ * @param cube          I/Q values of the radar cube
+ * @param numValues     number of int16 values (2 x number of complex samples)
+ * @param satThreshold  magnitude from which a value counts as saturated
+ * @param stats         measured statistics
+ */
+void FftAutoScale_computeStats(const int16_t *cube, uint32_t numValues, uint16_t satThreshold,
+                               FftAutoScale_Stats *stats);
+
+/**
+ * @brief Updates the controller with the statistics of the last frame.
+ *
+ * @param cfg    controller configuration
+ * @param state  controller state, state->shift holds the shift for the next frame
+ * @param stats  statistics of the last frame
+ * @return 1 if the shift has changed and the HWA has to be reconfigured, 0 otherwise
+ */
+int32_t FftAutoScale_update(const FftAutoScale_Config *cfg, FftAutoScale_State *state,
+                            const FftAutoScale_Stats *stats);
+
+/**
+ * @brief Splits a total shift into HWA output shift and scaled butterfly stages.
+ *
+ * @param cfg                 controller configuration
+ * @param shift               total shift
+ * @param divShift            resulting rangeFFTtuning.fftOutputDivShift
+ * @param numButterflyStages  resulting rangeFFTtuning.numLastButterflyStagesToScale
+ */
+void FftAutoScale_splitShift(const FftAutoScale_Config *cfg, uint8_t shift,
+                             uint8_t *divShift, uint8_t *numButterflyStages);
+
+#endif /* FFT_AUTOSCALE_H */
@@ -6,6 +6,13 @@
 *
 * This header defines Memory Pool management functions and datatypes.
 *
+* Besides bump allocation and full reset, a pool keeps a stack of named
+* checkpoints (nested scopes) and a log of tagged allocations: rewinding to a
+* checkpoint releases everything allocated after it, e.g. to re-run the
+* configuration of the pipeline with another cube size, without resetting the
+* pool. Allocations are never freed individually, so the pool can not
+* fragment.
+*
 * @copyright Copyright (C) 2022-24 Texas Instruments Incorporated
 *
 * Redistribution and use in source and binary forms, with or without
@@ -37,10 +44,98 @@
 * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <stdint.h>
+#include <stddef.h>
+
+/*! @brief Maximum number of nested checkpoints per pool */
+#define MEM_POOL_MAX_CHECKPOINTS    8
+
+/*! @brief Maximum number of tagged allocations logged per pool */
+#define MEM_POOL_MAX_TAGS           24
+
+/*!
+ * @brief Memory Configuration used during init API
+ */
+typedef struct DPC_ObjectDetection_MemCfg_t
+{
+    /*! @brief   Start address of memory provided by the application
+     *           from which DPC will allocate.
+     */
+    void *addr;
+
+    /*! @brief   Size limit of memory allowed to be consumed by the DPC */
+    uint32_t size;
+} DPC_ObjectDetection_MemCfg;
+
+/*!
+ * @brief Named position of a pool, see DPC_ObjDet_MemPoolPushCheckpoint().
+ */
+typedef struct MemPoolCheckpoint_t
+{
+    /*! @brief Name (not copied, string literal expected) */
+    const char *name;
+
+    /*! @brief Pool running address when the checkpoint was set */
+    uintptr_t addr;
+
+    /*! @brief Number of logged tagged allocations when the checkpoint was set */
+    uint32_t numTags;
+} MemPoolCheckpoint;
+
+/*!
+ * @brief Logged tagged allocation, see DPC_ObjDet_MemPoolAllocTagged().
+ */
+typedef struct MemPoolTag_t
+{
+    /*! @brief Tag (not copied, string literal expected) */
+    const char *tag;
+
+    /*! @brief Start address of the allocation */
+    uintptr_t addr;
+
+    /*! @brief Size of the allocation in bytes */
+    uint32_t size;
+} MemPoolTag;
+
+/*!
+ * @brief Memory pool object to manage memory based on @ref DPC_ObjectDetection_MemCfg_t.
+ */
+typedef struct MemPoolObj_t
+{
+    /*! @brief Memory configuration */
+    DPC_ObjectDetection_MemCfg cfg;
+
+    /*! @brief   Pool running adress.*/
+    uintptr_t currAddr;
+
+    /*! @brief   Pool max address. This pool allows setting address to desired
+     *           (e.g for rewinding purposes), so having a running maximum
+     *           helps in finding max pool usage
+     */
+    uintptr_t maxCurrAddr;
+
+    /*! @brief   Checkpoint stack, innermost scope last */
+    MemPoolCheckpoint checkpoints[MEM_POOL_MAX_CHECKPOINTS];
+
+    /*! @brief   Number of valid checkpoints */
+    uint32_t numCheckpoints;
+
+    /*! @brief   Live tagged allocations in allocation order */
+    MemPoolTag tags[MEM_POOL_MAX_TAGS];
+
+    /*! @brief   Number of valid tag entries */
+    uint32_t numTags;
+
+    /*! @brief   Tagged allocations which did not fit into the log (still allocated) */
+    uint32_t numTagsDropped;
+} MemPoolObj;
+
+
 /**
  *  @b Description
  *  @n
- *      Utility function for reseting memory pool.
+ *      Utility function for reseting memory pool. Also drops all checkpoints
+ *      and tags.
  *
  *  @param[in]  pool Handle to pool object.
  *
@@ -55,7 +150,8 @@ void DPC_ObjDet_MemPoolReset(MemPoolObj *pool);
  *  @b Description
  *  @n
  *      Utility function for setting memory pool to desired address in the pool.
- *      Helps to rewind for example.
+ *      Helps to rewind for example. Checkpoints and tags are not updated,
+ *      see DPC_ObjDet_MemPoolRewind() for scoped rewinding.
  *
  *  @param[in]  pool Handle to pool object.
  *  @param[in]  addr Address to assign to the pool's current address.
@@ -65,7 +161,7 @@ void DPC_ObjDet_MemPoolReset(MemPoolObj *pool);
  *  @retval
  *      None
  */
-static void DPC_ObjDet_MemPoolSet(MemPoolObj *pool, void *addr);
+void DPC_ObjDet_MemPoolSet(MemPoolObj *pool, void *addr);
 
 /**
  *  @b Description
@@ -80,7 +176,7 @@ static void DPC_ObjDet_MemPoolSet(MemPoolObj *pool, void *addr);
  *      pointer to current address of the pool (from which next allocation will
  *      allocate to the desired alignment).
  */
-static void *DPC_ObjDet_MemPoolGet(MemPoolObj *pool);
+void *DPC_ObjDet_MemPoolGet(MemPoolObj *pool);
 
 /**
  *  @b Description
@@ -113,4 +209,120 @@ uint32_t DPC_ObjDet_MemPoolGetMaxUsage(MemPoolObj *pool);
  */
 void *DPC_ObjDet_MemPoolAlloc(MemPoolObj *pool, uint32_t size, uint8_t align);
 
+/**
+ *  @b Description
+ *  @n
+ *      Allocates like DPC_ObjDet_MemPoolAlloc() and logs the allocation under
+ *      a tag, so that the pool usage can be broken down by user. The entry is
+ *      removed again when the allocation is released by a rewind.
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  size Size in bytes to be allocated.
+ *  @param[in]  align Alignment in bytes
+ *  @param[in]  tag Tag (string literal), NULL for an untagged allocation
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      pointer to beginning of allocated block. NULL indicates could not
+ *      allocate. An allocation which does not fit into the log any more is
+ *      still made and counted in numTagsDropped.
+ */
+void *DPC_ObjDet_MemPoolAllocTagged(MemPoolObj *pool, uint32_t size, uint8_t align, const char *tag);
+
+/**
+ *  @b Description
+ *  @n
+ *      Utility function for getting the number of bytes which are still free
+ *      (without alignment padding).
+ *
+ *  @param[in]  pool Handle to pool object.
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      Free bytes of the pool.
+ */
+uint32_t DPC_ObjDet_MemPoolGetFree(const MemPoolObj *pool);
+
+/**
+ *  @b Description
+ *  @n
+ *      Opens a scope: remembers the current position of the pool under a
+ *      name. Scopes nest, the latest checkpoint is the innermost scope.
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  name Name of the checkpoint (string literal).
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      0 on success, -1 if MEM_POOL_MAX_CHECKPOINTS scopes are open.
+ */
+int32_t DPC_ObjDet_MemPoolPushCheckpoint(MemPoolObj *pool, const char *name);
+
+/**
+ *  @b Description
+ *  @n
+ *      Looks up an open checkpoint without changing the pool.
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  name Name of the checkpoint.
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      Index of the innermost open checkpoint with the name, -1 if none.
+ */
+int32_t DPC_ObjDet_MemPoolFindCheckpoint(const MemPoolObj *pool, const char *name);
+
+/**
+ *  @b Description
+ *  @n
+ *      Releases everything allocated since a checkpoint and closes all scopes
+ *      nested in it. The checkpoint itself stays open, so that the scope can
+ *      be allocated again (e.g. after a reconfiguration).
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  name Name of the checkpoint, the innermost one if several
+ *                   share the name.
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      0 on success, -1 if no such checkpoint is open.
+ */
+int32_t DPC_ObjDet_MemPoolRewind(MemPoolObj *pool, const char *name);
+
+/**
+ *  @b Description
+ *  @n
+ *      Closes a scope: rewinds to the checkpoint like DPC_ObjDet_MemPoolRewind()
+ *      and removes the checkpoint as well.
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  name Name of the checkpoint.
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      0 on success, -1 if no such checkpoint is open.
+ */
+int32_t DPC_ObjDet_MemPoolPopCheckpoint(MemPoolObj *pool, const char *name);
+
+/**
+ *  @b Description
+ *  @n
+ *      Sums up the live allocations of a tag.
+ *
+ *  @param[in]  pool Handle to pool object.
+ *  @param[in]  tag Tag to look for (compared by content).
+ *
+ *  \ingroup DPC_OBJDET__INTERNAL_FUNCTION
+ *
+ *  @retval
+ *      Bytes allocated under the tag.
+ */
+uint32_t DPC_ObjDet_MemPoolGetTagUsage(const MemPoolObj *pool, const char *tag);
+
 #endif /* MEM_POOL_H */
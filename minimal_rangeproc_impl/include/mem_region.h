@@ -0,0 +1,164 @@
+#ifndef MEM_REGION_H
+#define MEM_REGION_H
+
+/**
+ * @file mem_region.h
+ * @brief Placement of buffers across several on-chip memory regions.
+ *
+ * Each region wraps a memory pool (see mem_pool.h) with its attributes (which
+ * masters can reach it) and a speed rank (0 = fastest for the CPU). A buffer
+ * is placed by policy among the regions which have all the required
+ * attributes and enough free space:
+ *
+ * - MEM_REGION_POLICY_FASTEST:      lowest speed rank
+ * - MEM_REGION_POLICY_LARGEST_FREE: most free bytes, keeps the small fast
+ *   regions for the buffers which need them
+ * - MEM_REGION_POLICY_FIRST_FIT:    first region in map order
+ *
+ * Checkpoints and rewinds are applied to all regions at once, so a pipeline
+ * configuration spread across regions is released as a whole. The regions
+ * are described by the application (addresses, sizes, attributes).
+ */
+
+#include <stdint.h>
+
+#include "mem_pool.h"
+
+/*! @brief Maximum number of regions per map */
+#define MEM_REGION_MAX_NUM              4
+
+/*! @brief Region is reachable by the EDMA */
+#define MEM_REGION_ATTR_DMA             (1U << 0)
+
+/*! @brief Region is reachable by the HWA (radar cube, HWA input/output) */
+#define MEM_REGION_ATTR_HWA             (1U << 1)
+
+/*! @brief Placement policies */
+#define MEM_REGION_POLICY_FASTEST       0U
+#define MEM_REGION_POLICY_LARGEST_FREE  1U
+#define MEM_REGION_POLICY_FIRST_FIT     2U
+
+/**
+ * @brief One memory region.
+ */
+typedef struct MemRegion_Region_t
+{
+    /*! @brief Name used in reports (string literal) */
+    const char *name;
+
+    /*! @brief Pool managing the region, owned by the application */
+    MemPoolObj *pool;
+
+    /*! @brief MEM_REGION_ATTR_* flags */
+    uint32_t attrs;
+
+    /*! @brief CPU access speed rank, 0 = fastest */
+    uint32_t speedRank;
+} MemRegion_Region;
+
+/**
+ * @brief Set of regions buffers are placed in.
+ */
+typedef struct MemRegion_Map_t
+{
+    /*! @brief Regions in the order they were added */
+    MemRegion_Region region[MEM_REGION_MAX_NUM];
+
+    /*! @brief Number of valid regions */
+    uint32_t numRegions;
+} MemRegion_Map;
+
+/**
+ * @brief Usage of one region.
+ */
+typedef struct MemRegion_Usage_t
+{
+    /*! @brief Size of the region in bytes */
+    uint32_t size;
+
+    /*! @brief Bytes currently allocated */
+    uint32_t used;
+
+    /*! @brief Peak of used since the last reset */
+    uint32_t peak;
+
+    /*! @brief Bytes still free */
+    uint32_t free;
+} MemRegion_Usage;
+
+/**
+ * @brief Empties a region map.
+ */
+void MemRegion_init(MemRegion_Map *map);
+
+/**
+ * @brief Adds a region. The pool must already be configured (cfg.addr, cfg.size).
+ *
+ * @return index of the region, -1 if the map is full or the pool is empty
+ */
+int32_t MemRegion_add(MemRegion_Map *map, const char *name, MemPoolObj *pool,
+                      uint32_t attrs, uint32_t speedRank);
+
+/**
+ * @brief Resets the pools of all regions.
+ */
+void MemRegion_reset(MemRegion_Map *map);
+
+/**
+ * @brief Selects the region a buffer would be placed in, without allocating.
+ *
+ * @param map            region map
+ * @param size           size in bytes
+ * @param align          alignment in bytes (power of 2)
+ * @param requiredAttrs  MEM_REGION_ATTR_* flags the region must have
+ * @param policy         MEM_REGION_POLICY_*
+ * @return region index, -1 if no region qualifies
+ */
+int32_t MemRegion_select(const MemRegion_Map *map, uint32_t size, uint8_t align,
+                         uint32_t requiredAttrs, uint32_t policy);
+
+/**
+ * @brief Places and allocates a buffer.
+ *
+ * @param map            region map
+ * @param size           size in bytes
+ * @param align          alignment in bytes (power of 2)
+ * @param requiredAttrs  MEM_REGION_ATTR_* flags the region must have
+ * @param policy         MEM_REGION_POLICY_*
+ * @param tag            allocation tag (see DPC_ObjDet_MemPoolAllocTagged()), may be NULL
+ * @param regionIdx      output: index of the chosen region, may be NULL
+ * @return buffer, NULL if no region qualifies
+ */
+void *MemRegion_alloc(MemRegion_Map *map, uint32_t size, uint8_t align,
+                      uint32_t requiredAttrs, uint32_t policy, const char *tag, int32_t *regionIdx);
+
+/**
+ * @brief Opens a checkpoint with the same name in all regions.
+ *
+ * @return 0 on success, -1 if a region has no checkpoint left (no checkpoint is opened then)
+ */
+int32_t MemRegion_pushCheckpoint(MemRegion_Map *map, const char *name);
+
+/**
+ * @brief Rewinds all regions to a checkpoint (see DPC_ObjDet_MemPoolRewind()).
+ *
+ * @return 0 on success, -1 if a region does not have the checkpoint (no region is rewound then)
+ */
+int32_t MemRegion_rewind(MemRegion_Map *map, const char *name);
+
+/**
+ * @brief Returns the usage of a region.
+ */
+void MemRegion_getUsage(const MemRegion_Map *map, uint32_t regionIdx, MemRegion_Usage *usage);
+
+/**
+ * @brief Returns the free bytes of the region with the most free bytes among those with the required attributes.
+ *
+ * Buffers which fit into this many bytes together are placed by MEM_REGION_POLICY_LARGEST_FREE
+ * (up to their alignment), whatever region each of them ends up in.
+ *
+ * @return free bytes, 0 if no region has the attributes
+ */
+uint32_t MemRegion_getLargestFree(const MemRegion_Map *map, uint32_t requiredAttrs);
+
+#endif /* MEM_REGION_H */
@@ -0,0 +1,119 @@
+#ifndef MICRO_DOPPLER_H
+#define MICRO_DOPPLER_H
+
+/**
+ * @file micro_doppler.h
+ * @brief Micro-Doppler spectrogram column of a range window.
+ *
+ * Every frame yields one column of the spectrogram: the Doppler magnitudes of
+ * the range bins [rangeStart, rangeStart + rangeLen), computed like the rows
+ * of the range-Doppler heatmap (see rd_heatmap.h, windowed FFT, all butterfly
+ * stages scaled, summed over the virtual antennas) and summed over the range
+ * window:
+ *
+ *   C[dopplerBin] = (sum over window of H[bin][dopplerBin]) >> shift
+ *
+ * with shift = MicroDoppler_getShift(rangeLen). Doppler bins are in FFT
+ * order. The host builds the spectrogram by appending the columns of
+ * consecutive frames.
+ *
+ * On the device the FFT and the magnitude are computed by the HWA (see
+ * micro_doppler_proc.h), MicroDoppler_compute() is the reference model for
+ * validation on a host machine (based on RdHeatmap_computeRows()).
+ *
+ * Layout of the payload (following the StreamRecord_Header):
+ *   - MicroDoppler_Header
+ *   - numDopplerBins uint16 values
+ */
+
+#include <stdint.h>
+
+#include "rd_heatmap.h"
+
+/*! @brief Largest supported range window */
+#define MICRO_DOPPLER_MAX_RANGE_LEN     (8U)
+
+/**
+ * @brief Header of the spectrogram column.
+ */
+typedef struct MicroDoppler_Header_t
+{
+    /*! @brief First range bin of the window */
+    uint16_t rangeStart;
+
+    /*! @brief Number of range bins of the window */
+    uint8_t rangeLen;
+
+    /*! @brief Right shift applied to the sum over the window, see MicroDoppler_getShift() */
+    uint8_t shift;
+
+    /*! @brief Number of Doppler bins (Doppler FFT size) */
+    uint16_t numDopplerBins;
+
+    /*! @brief 1 if the window follows a detection, 0 if it is fixed or kept from the last frame */
+    uint8_t tracked;
+
+    /*! @brief Reserved, always 0 */
+    uint8_t reserved;
+
+    /*! @brief Duration of the stage in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} MicroDoppler_Header;
+
+/**
+ * @brief Returns the right shift applied to the sum over the range window.
+ *
+ * @param rangeLen  number of range bins of the window
+ * @return ceil(log2(rangeLen))
+ */
+uint32_t MicroDoppler_getShift(uint32_t rangeLen);
+
+/**
+ * @brief Returns the size of the column including its header.
+ *
+ * @param fftSize  Doppler FFT size
+ * @return size in bytes (multiple of 4)
+ */
+uint32_t MicroDoppler_getSize(uint32_t fftSize);
+
+/**
+ * @brief Returns the first bin of a window of rangeLen bins centred on centerBin.
+ *
+ * The window is kept within [minBin, numRangeBins).
+ *
+ * @param centerBin     range bin the window is centred on
+ * @param rangeLen      number of range bins of the window
+ * @param minBin        first usable range bin
+ * @param numRangeBins  number of range bins
+ * @return first range bin of the window
+ */
+uint32_t MicroDoppler_centerWindow(uint32_t centerBin, uint32_t rangeLen, uint32_t minBin, uint32_t numRangeBins);
+
+/**
+ * @brief Sums heatmap rows over the range window.
+ *
+ * Used by the device after the HWA pass and by the reference model.
+ *
+ * @param rows      rangeLen x fftSize heatmap rows
+ * @param rangeLen  number of range bins of the window
+ * @param fftSize   Doppler FFT size
+ * @param column    output, fftSize values
+ */
+void MicroDoppler_sumRows(const uint16_t *rows, uint32_t rangeLen, uint32_t fftSize, uint16_t *column);
+
+/**
+ * @brief Reference model of the spectrogram column computation.
+ *
+ * @param cfg         heatmap configuration of the whole cube
+ * @param cube        radar cube in FORMAT_6 (cmplx16ImRe_t samples)
+ * @param window      first half of the symmetric Doppler window, see RdHeatmap_compute()
+ * @param rangeStart  first range bin of the window
+ * @param rangeLen    number of range bins of the window (1 .. MICRO_DOPPLER_MAX_RANGE_LEN)
+ * @param scratch     working memory of rangeLen x fftSize uint16 values
+ * @param column      output, fftSize values
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t MicroDoppler_compute(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                             uint32_t rangeStart, uint32_t rangeLen, uint16_t *scratch, uint16_t *column);
+
+#endif /* MICRO_DOPPLER_H */
@@ -0,0 +1,66 @@
+#ifndef MICRO_DOPPLER_PROC_H
+#define MICRO_DOPPLER_PROC_H
+
+/**
+ * @file micro_doppler_proc.h
+ * @brief Micro-Doppler stage computing one spectrogram column per frame on the HWA.
+ *
+ * The stage processes a window of UDOPPROC_RANGE_LEN range bins in a single
+ * HWA pass, the same way the Doppler stage processes one group of range bins:
+ *   1. an EDMA transfer gathers the samples of the window into HWA memory
+ *      bank M0 (layout [chirp][antenna][bin]),
+ *   2. one HWA param set computes the windowed Doppler FFT magnitudes of every
+ *      (antenna, bin) sequence into bank M2,
+ *   3. the CPU sums the magnitudes over the antennas and the range window into
+ *      the column (RdHeatmap_sumAntennas(), MicroDoppler_sumRows()).
+ *
+ * The window either stays at UDOPPROC_RANGE_START or, with UDOPPROC_TRACK_CFAR,
+ * is centred on the strongest CFAR detection of the frame (and kept if there
+ * is none).
+ *
+ * See micro_doppler.h for the output format and the reference model. The
+ * stage uses the input EDMA channel of the micro-Doppler DPU and the HWA param
+ * set after the one of the DoA stage. Its window is stored in the window RAM
+ * after the Doppler window.
+ */
+
+#include <stdint.h>
+
+/*! @brief Run the micro-Doppler stage every frame (1) or not (0) */
+#define UDOPPROC_ENABLE                 0
+
+/*! @brief First range bin of the (initial) range window */
+#define UDOPPROC_RANGE_START            8
+
+/*! @brief Number of range bins of the window (1 .. MICRO_DOPPLER_MAX_RANGE_LEN) */
+#define UDOPPROC_RANGE_LEN              4
+
+/*! @brief Centre the window on the strongest CFAR detection (1, requires CFARPROC_ENABLE) or keep it fixed (0) */
+#define UDOPPROC_TRACK_CFAR             0
+
+/*! @brief Window applied before the Doppler FFT */
+#define UDOPPROC_WINDOW_TYPE            MATHUTILS_WIN_HANNING
+
+/*! @brief HWA param set used by the stage (the range DPU, Doppler and DoA stages use the ones before) */
+#define UDOPPROC_HWA_PARAMSET_IDX       (DPU_RANGEPROCHWA_NUM_HWA_PARAM_SETS + 2)
+
+/**
+ * @brief Allocates the column and configures EDMA, HWA param set and window RAM.
+ *
+ * Must be called after RangeProc_config() and CfarProc_config().
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t MicroDopplerProc_config(void);
+
+/**
+ * @brief Computes the spectrogram column of the current frame.
+ *
+ * Must be called after CfarProc_process() and before the next
+ * DPU_RangeProcHWA_Cmd_triggerProc.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t MicroDopplerProc_process(void);
+
+#endif /* MICRO_DOPPLER_PROC_H */
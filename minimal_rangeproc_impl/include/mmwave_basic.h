@@ -41,18 +41,60 @@
  *      functionality on the basis of which the DPUs can be used.
  */
 
+#include "config_cmd.h"
+#include "profile_blob.h"
+#include "warm_start.h"
+
+/*! @brief Load the chirp profile from the flash blob at PROFILE_BLOB_FLASH_OFFSET if it is valid (1) or always
+ *         boot with the profile of defines.h (0), see profile_blob.h */
+#define MMWAVE_PROFILE_BLOB_ENABLE          1
+
+/*! @brief Boot warm after a reset without power loss (MMWave_init() with iswarmstart, profile and factory
+ *         calibration retained in RAM instead of read from flash) if the retained state is valid (1) or always
+ *         boot cold (0), see warm_start.h */
+#define MMWAVE_WARM_START_ENABLE            0
+
+/*! @brief Flash offset of the profile blob (sector below the factory calibration at CLI_FACCALCFG_FLASH_OFFSET) */
+#define PROFILE_BLOB_FLASH_OFFSET           0x1fe000U
+
+/*! @brief Pool the otherwise unused FECSS part of the shared memory (96KB, initialised in main()) as an
+ *         additional memory region (1) or only the L3 and core local pools (0), see mem_region.h */
+#define MMWAVE_FECSS_SHRAM_POOL_ENABLE      1
+
 /**
- * @brief sets start address and size of shared mempool
+ * @brief sets start address and size of shared mempool and adds the pools to the memory region map
 */
 void mempool_init(void);
 
+/**
+ * @brief checks and invalidates the state retained from the previous boot and selects the warm or cold
+ *        boot path (gSysContext.warmStart), must be called before mmwave_loadBootProfile()
+*/
+void mmwave_checkWarmStart(void);
+
+/**
+ * @brief seals the boot profile and the factory calibration into the retained state once the sensor runs,
+ *        so that the next reset without power loss boots warm
+*/
+void mmwave_retainState(void);
+
+/**
+ * @brief selects the boot profile (gSysContext.bootProfile): the flash blob if it is valid and fits the
+ *        firmware (same channelCfg, see ConfigCmd_validate()), otherwise the profile of defines.h
+ *
+ * On a warm boot the retained profile is used without reading the flash.
+ * Never fails, must be called before mmwave_configSensor().
+*/
+void mmwave_loadBootProfile(void);
+
 /**
  * @brief calls HWA_open() and thereby retrieves the HWA's handle (HWA_Handle)
 */
 int32_t hwa_open_handler(void);
 
 /**
- * @brief calls the MMWave_init() function and thereby retrieves the mmwave control handle (MMWave_Handle)
+ * @brief calls the MMWave_init() function and thereby retrieves the mmwave control handle (MMWave_Handle),
+ *        with iswarmstart on a warm boot (retried cold if the warm init fails)
 */
 int32_t mmwave_initSensor(void);
 
@@ -71,6 +113,23 @@ int32_t mmwave_configSensor(void);
 */
 int32_t mmwave_startSensor(void);
 
+/**
+ * @brief calls the MMWave_stop() function, the sensor is restarted with mmwave_startSensor()
+*/
+int32_t mmwave_stopSensor(void);
+
+/**
+ * @brief calls the MMWave_stop() function and MMWave_config() with the profile and frame shape
+ *        of another sub-frame (see subframe_cfg.h), the sensor is restarted with mmwave_startSensor()
+*/
+int32_t mmwave_reconfigSensor(uint32_t subFrameIdx);
+
+/**
+ * @brief replaces the profile and frame shape (channel configuration kept, see config_cmd.h) and
+ *        calls MMWave_config(), the sensor must be stopped and is restarted with mmwave_startSensor()
+*/
+int32_t mmwave_applyProfile(const ConfigCmd_Profile *profile);
+
 /**
  * @brief calls the MMWave_stop(), MMWave_close() and MMWave_deinit() function
 */
@@ -1,6 +1,9 @@
 #ifndef MMWAVE_CONTROL_CONFIG_H
 #define MMWAVE_CONTROL_CONFIG_H
 
+#include "subframe.h"
+#include "config_cmd.h"
+
 
 
 /*!
@@ -47,12 +50,16 @@ typedef struct
     uint8_t ChirpBpmEn[4]; /* LUT address 68 */
 } T_SensPerChirpLut;
 
-static void Mmwave_populateDefaultProfileCfg (T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg);
+static void Mmwave_populateDefaultProfileCfg (const SubFrame_Config* ptrSubFrameCfg, T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg);
+static void Mmwave_copyProfileCfg (float chirpSlope, T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg);
 static void Mmwave_populateDefaultChirpCfg (T_RL_API_SENS_PER_CHIRP_CFG* ptrChirpCfg, T_RL_API_SENS_PER_CHIRP_CTRL* ptrChirpCtrl);
 void MMWave_populateChannelCfg();
 void Mmwave_populateDefaultCalibrationCfg (MMWave_CalibrationCfg* ptrCalibrationCfg);
 void Mmwave_populateDefaultStartCfg (MMWave_StrtCfg* ptrStartCfg);
 void Mmwave_populateDefaultOpenCfg (MMWave_OpenCfg* ptrOpenCfg);
 void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg);
+void Mmwave_selectSubFrameCfg (MMWave_CtrlCfg* ptrCtrlCfg, uint32_t subFrameIdx);
+void Mmwave_getDefaultProfile (ConfigCmd_Profile* ptrProfile);
+int32_t Mmwave_applyProfileCfg (MMWave_CtrlCfg* ptrCtrlCfg, const ConfigCmd_Profile* ptrProfile);
 
 #endif /* MMWAVE_CONTROL_CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef PROFILE_BLOB_H
+#define PROFILE_BLOB_H
+
+/**
+ * @file profile_blob.h
+ * @brief Chirp profile stored in flash, loaded at boot instead of defines.h.
+ *
+ * The blob is written by chirp_config_to_defines.py (--encode-blob) and
+ * programmed to PROFILE_BLOB_FLASH_OFFSET. It is a fixed-size struct in the
+ * memory order of the device (little endian), so loading it is one flash
+ * read and a check of the header:
+ *
+ * | bytes  | content                                                 |
+ * |--------|---------------------------------------------------------|
+ * | 0..3   | PROFILE_BLOB_MAGIC                                      |
+ * | 4..5   | format version                                          |
+ * | 6..7   | header bytes (16)                                       |
+ * | 8..11  | payload bytes (sizeof(ConfigCmd_Profile))               |
+ * | 12..15 | CRC-32 of the payload (ConfigCmd_crc32())               |
+ * | 16..99 | payload: ConfigCmd_Profile, the fields of the           |
+ * |        | channelCfg, chirpComnCfg, chirpTimingCfg and frameCfg   |
+ *
+ * The version is increased whenever the payload changes. A blob of another
+ * version, with a wrong CRC or erased flash is ignored and the firmware
+ * boots with the profile compiled from defines.h.
+ */
+
+#include <stdint.h>
+
+#include "config_cmd.h"
+
+/*! @brief First word of a profile blob ("RPRF") */
+#define PROFILE_BLOB_MAGIC          0x52505246U
+
+/*! @brief Version of the blob format */
+#define PROFILE_BLOB_VERSION        1U
+
+/*! @brief Results of ProfileBlob_check() */
+#define PROFILE_BLOB_OK             0
+#define PROFILE_BLOB_ERR_EMPTY      (-1)    /* no magic, e.g. erased flash */
+#define PROFILE_BLOB_ERR_VERSION    (-2)
+#define PROFILE_BLOB_ERR_LENGTH     (-3)
+#define PROFILE_BLOB_ERR_CRC        (-4)
+
+/*! @brief Origin of the profile the sensor was booted with */
+#define PROFILE_BLOB_SOURCE_DEFAULT 0U      /* defines.h */
+#define PROFILE_BLOB_SOURCE_FLASH   1U
+
+/**
+ * @brief Profile blob as stored in flash.
+ */
+typedef struct ProfileBlob_t
+{
+    /*! @brief PROFILE_BLOB_MAGIC */
+    uint32_t magic;
+
+    /*! @brief PROFILE_BLOB_VERSION */
+    uint16_t version;
+
+    /*! @brief Bytes before the payload */
+    uint16_t headerBytes;
+
+    /*! @brief Bytes of the payload */
+    uint32_t payloadBytes;
+
+    /*! @brief CRC-32 of the payload */
+    uint32_t crc;
+
+    /*! @brief Payload */
+    ConfigCmd_Profile profile;
+} ProfileBlob;
+
+/**
+ * @brief Encodes a profile blob.
+ */
+void ProfileBlob_encode(const ConfigCmd_Profile *profile, ProfileBlob *blob);
+
+/**
+ * @brief Checks the header and CRC of a blob read from flash.
+ *
+ * @return PROFILE_BLOB_OK, PROFILE_BLOB_ERR_EMPTY, _VERSION, _LENGTH or _CRC
+ */
+int32_t ProfileBlob_check(const ProfileBlob *blob);
+
+#endif /* PROFILE_BLOB_H */
@@ -0,0 +1,119 @@
+#ifndef RANGE_PEAKS_H
+#define RANGE_PEAKS_H
+
+/**
+ * @file range_peaks.h
+ * @brief List of the K strongest range bins of a frame.
+ *
+ * The peaks are the K largest local maxima of the non-coherent range profile
+ * (see range_profile.h). For every peak the list holds
+ *   - the range bin index and a parabolically interpolated fractional bin,
+ *   - the non-coherent power and magnitude of the bin,
+ *   - the complex sample of every virtual antenna at that bin for the first
+ *     doppler chirp of the frame, which can be used for angle estimation.
+ *
+ * Layout of the payload (following the StreamRecord_Header):
+ *   - RangePeaks_Header
+ *   - maxPeaks entries, each a RangePeaks_Peak followed by numVirtualAntennas
+ *     complex int16 samples in cmplx16ImRe_t order (imaginary part first).
+ *     Only the first numPeaks entries are valid, sorted by decreasing power.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Configuration of the peak search.
+ */
+typedef struct RangePeaks_Config_t
+{
+    /*! @brief Maximum number of peaks (K) */
+    uint16_t maxPeaks;
+
+    /*! @brief First range bin considered, used to skip DC and TX leakage */
+    uint16_t minBin;
+
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint32_t numDopplerChirps;
+} RangePeaks_Config;
+
+/**
+ * @brief Header of the peak list.
+ */
+typedef struct RangePeaks_Header_t
+{
+    /*! @brief Number of valid peaks */
+    uint16_t numPeaks;
+
+    /*! @brief Number of peak entries in the payload (K) */
+    uint16_t maxPeaks;
+
+    /*! @brief Number of complex antenna samples per peak */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Size of a range bin in meters, 0 if unknown */
+    float rangeBinSizeM;
+
+    /*! @brief Duration of the reduction in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} RangePeaks_Header;
+
+/**
+ * @brief Entry of the peak list.
+ */
+typedef struct RangePeaks_Peak_t
+{
+    /*! @brief Interpolated range in bins */
+    float rangeBin;
+
+    /*! @brief Non-coherent power of the bin (sum over antennas and chirps) */
+    float power;
+
+    /*! @brief Interpolated magnitude, sqrt of the average power per sample */
+    float magnitude;
+
+    /*! @brief Range bin index of the local maximum */
+    uint16_t bin;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+} RangePeaks_Peak;
+
+/**
+ * @brief Returns the size of a peak entry including the antenna samples.
+ *
+ * @param cfg  peak search configuration
+ * @return entry size in bytes
+ */
+uint32_t RangePeaks_getPeakSize(const RangePeaks_Config *cfg);
+
+/**
+ * @brief Returns the size of the peak list payload.
+ *
+ * @param cfg  peak search configuration
+ * @return payload size in bytes
+ */
+uint32_t RangePeaks_getPayloadSize(const RangePeaks_Config *cfg);
+
+/**
+ * @brief Searches the K strongest peaks of a range profile.
+ *
+ * @param cfg      peak search configuration
+ * @param cube     radar cube in FORMAT_6, used for the per-antenna samples
+ * @param acc      64-bit range profile as computed by RangeProfile_accumulate()
+ * @param payload  output buffer of RangePeaks_getPayloadSize() bytes, 4 byte aligned.
+ *                 rangeBinSizeM and computeTicks of the header are set to 0.
+ * @return number of peaks found, -1 on invalid arguments
+ */
+int32_t RangePeaks_find(const RangePeaks_Config *cfg, const int16_t *cube, const uint64_t *acc,
+                        void *payload);
+
+#endif /* RANGE_PEAKS_H */
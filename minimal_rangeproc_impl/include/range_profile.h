@@ -0,0 +1,92 @@
+#ifndef RANGE_PROFILE_H
+#define RANGE_PROFILE_H
+
+/**
+ * @file range_profile.h
+ * @brief Non-coherent range profile of the radar cube.
+ *
+ * The range profile holds, for every range bin, the power of all samples of
+ * that bin summed over virtual antennas and chirps:
+ *
+ *   P[bin] = sum over rows of (re^2 + im^2)
+ *
+ * The cube is expected in DPIF_RADARCUBE_FORMAT_6, i.e. range bins are the
+ * innermost dimension: x[numDopplerChirps][numVirtualAntennas][numRangeBins].
+ * Chirps and antennas are therefore treated as numRows range lines.
+ *
+ * The sums are accumulated with 64 bits and stored as uint32 values shifted
+ * right by RangeProfile_getShift(), which guarantees that no overflow can occur
+ * for the given number of range lines.
+ *
+ * On cores with the Arm DSP extension (e.g. the Cortex-M4F of the IWRL6432)
+ * each sample is accumulated with a single SMLALD instruction, elsewhere with
+ * plain C.
+ *
+ * Layout of the range profile payload (following the StreamRecord_Header):
+ *   - RangeProfile_Header
+ *   - numRangeBins uint32 power sums
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Header of the range profile payload.
+ */
+typedef struct RangeProfile_Header_t
+{
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Right shift applied to the power sums, see RangeProfile_getShift() */
+    uint8_t shift;
+
+    /*! @brief Reserved, always 0 */
+    uint8_t reserved;
+
+    /*! @brief Duration of the reduction in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} RangeProfile_Header;
+
+/**
+ * @brief Returns the right shift applied to the 64-bit power sums.
+ *
+ * @param numRows  number of range lines (doppler chirps x virtual antennas)
+ * @return smallest shift for which numRows full-scale samples fit into uint32
+ */
+uint32_t RangeProfile_getShift(uint32_t numRows);
+
+/**
+ * @brief Accumulates the 64-bit power sums of all range bins.
+ *
+ * @param cube          radar cube in FORMAT_6 (complex int16 samples, 4 byte aligned)
+ * @param numRangeBins  number of range bins
+ * @param numRows       number of range lines (doppler chirps x virtual antennas)
+ * @param acc           output, numRangeBins 64-bit power sums
+ */
+void RangeProfile_accumulate(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows,
+                             uint64_t *acc);
+
+/**
+ * @brief Converts the 64-bit power sums into the uint32 range profile.
+ *
+ * @param acc           numRangeBins 64-bit power sums from RangeProfile_accumulate()
+ * @param numRangeBins  number of range bins
+ * @param numRows       number of range lines the sums were accumulated over
+ * @param profile       output, numRangeBins power sums shifted by RangeProfile_getShift()
+ */
+void RangeProfile_pack(const uint64_t *acc, uint32_t numRangeBins, uint32_t numRows,
+                       uint32_t *profile);
+
+/**
+ * @brief Computes the range profile of a radar cube.
+ *
+ * @param cube          radar cube in FORMAT_6 (complex int16 samples, 4 byte aligned)
+ * @param numRangeBins  number of range bins
+ * @param numRows       number of range lines (doppler chirps x virtual antennas)
+ * @param acc           scratch memory for numRangeBins 64-bit sums
+ * @param profile       output, numRangeBins power sums shifted by RangeProfile_getShift()
+ */
+void RangeProfile_compute(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows,
+                          uint64_t *acc, uint32_t *profile);
+
+#endif /* RANGE_PROFILE_H */
@@ -0,0 +1,147 @@
+#ifndef RANGE_RECONFIG_H
+#define RANGE_RECONFIG_H
+
+/**
+ * @file range_reconfig.h
+ * @brief Change detection and window reuse for the reconfiguration of the range DPU.
+ *
+ * A full RangeProc_config() clears the DPU configuration and allocates the
+ * radar cubes, and the pipeline after it is rebuilt as well. When only a few
+ * parameters change at runtime (range FFT scaling, sub-frame switch, profile
+ * with the same cube shape) this is not necessary:
+ *
+ * - RangeReconfig_isChanged() compares the parameters of the current and the
+ *   new configuration which the DPU programming depends on. Without changes
+ *   the DPU is left untouched.
+ * - A window cache keyed by number of ADC samples, window type and Q format
+ *   hands out already generated windows, so that configurations with the same
+ *   window share one table and no window is generated twice. Its windows live
+ *   outside the pipeline memory, so they also survive a full rebuild.
+ *
+ * The SDK only offers DPU_RangeProcHWA_config() to program the HWA param sets
+ * and EDMA, so only the no-op case is short-circuited: any change re-applies
+ * the whole configuration with the cached memory.
+ */
+
+#include <stdint.h>
+
+/*! @brief Maximum number of cached windows */
+#define RANGE_RECONFIG_MAX_WINDOWS  4
+
+/**
+ * @brief Parameters of a range DPU configuration which are compared.
+ */
+typedef struct RangeReconfig_Params_t
+{
+    /*! @brief rangeFFTtuning.fftOutputDivShift */
+    uint32_t fftOutputDivShift;
+
+    /*! @brief rangeFFTtuning.numLastButterflyStagesToScale */
+    uint32_t numButterflyStagesScaled;
+
+    /*! @brief Window table */
+    const void *window;
+
+    /*! @brief Size of the window table in bytes */
+    uint32_t windowSize;
+
+    /*! @brief Number of ADC samples per chirp */
+    uint32_t numAdcSamples;
+
+    /*! @brief Range FFT size */
+    uint32_t rangeFftSize;
+
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+
+    /*! @brief Chirps per frame */
+    uint32_t numChirpsPerFrame;
+
+    /*! @brief Doppler chirps per frame */
+    uint32_t numDopplerChirpsPerFrame;
+
+    /*! @brief Number of TX antennas */
+    uint32_t numTxAntennas;
+
+    /*! @brief Number of virtual antennas */
+    uint32_t numVirtualAntennas;
+
+    /*! @brief BPM (1) or TDM (0) MIMO */
+    uint32_t isBpmEnabled;
+
+    /*! @brief ADC buffer bytes per chirp (ping and pong) */
+    uint32_t adcDataSize;
+
+    /*! @brief Offset between two RX channels in the ADC buffer */
+    uint32_t adcRxChanStride;
+
+    /*! @brief Radar cube */
+    const void *cube;
+
+    /*! @brief Size of the radar cube in bytes */
+    uint32_t cubeBytes;
+} RangeReconfig_Params;
+
+/**
+ * @brief Cached window table.
+ */
+typedef struct RangeReconfig_Window_t
+{
+    /*! @brief Number of ADC samples the window was generated for */
+    uint32_t numAdcSamples;
+
+    /*! @brief Window type (MATHUTILS_WIN_*) */
+    uint32_t winType;
+
+    /*! @brief Q format of the coefficients */
+    uint32_t qFormat;
+
+    /*! @brief Coefficients */
+    int32_t *window;
+
+    /*! @brief Size of the table in bytes */
+    uint32_t windowSize;
+} RangeReconfig_Window;
+
+/**
+ * @brief Window cache.
+ */
+typedef struct RangeReconfig_WindowCache_t
+{
+    /*! @brief Cached windows */
+    RangeReconfig_Window entry[RANGE_RECONFIG_MAX_WINDOWS];
+
+    /*! @brief Number of valid entries */
+    uint32_t numEntries;
+} RangeReconfig_WindowCache;
+
+/**
+ * @brief Checks whether the DPU programming differs between two configurations.
+ *
+ * @param cur   parameters of the applied configuration
+ * @param next  parameters of the new configuration
+ * @return 1 if any parameter differs, 0 if the DPU can keep its configuration
+ */
+int32_t RangeReconfig_isChanged(const RangeReconfig_Params *cur, const RangeReconfig_Params *next);
+
+/**
+ * @brief Empties a window cache.
+ */
+void RangeReconfig_initWindowCache(RangeReconfig_WindowCache *cache);
+
+/**
+ * @brief Looks up a window.
+ *
+ * @return cached window, NULL if none matches
+ */
+const RangeReconfig_Window *RangeReconfig_findWindow(const RangeReconfig_WindowCache *cache,
+                                                     uint32_t numAdcSamples, uint32_t winType, uint32_t qFormat);
+
+/**
+ * @brief Adds a generated window to the cache.
+ *
+ * @return 0 on success, -1 if the cache is full
+ */
+int32_t RangeReconfig_addWindow(RangeReconfig_WindowCache *cache, const RangeReconfig_Window *window);
+
+#endif /* RANGE_RECONFIG_H */
@@ -54,6 +54,50 @@
 
 #define DPC_OBJDET_QFORMAT_RANGE_FFT 17
 
+/*! @brief Range FFT scaling applied if auto-scaling is disabled (and initial value otherwise) */
+#define RANGEPROC_FFT_OUTPUT_DIV_SHIFT          2
+#define RANGEPROC_FFT_NUM_BUTTERFLY_STAGES      0
+
+/*! @brief Adapt the range FFT scaling to the per-frame cube statistics (1) or use the fixed values above (0) */
+#define RANGEPROC_FFT_AUTOSCALE_ENABLE          0
+
+/*! @brief Auto-scaling controller parameters, see fft_autoscale.h */
+#define RANGEPROC_FFT_AUTOSCALE_MAX_SHIFT       10
+#define RANGEPROC_FFT_AUTOSCALE_MAX_DIV_SHIFT   7
+#define RANGEPROC_FFT_AUTOSCALE_SAT_THRESHOLD   32767U
+#define RANGEPROC_FFT_AUTOSCALE_SAT_COUNT_UP    1U
+#define RANGEPROC_FFT_AUTOSCALE_HEADROOM_LOW    16384U
+#define RANGEPROC_FFT_AUTOSCALE_FRAMES_DOWN     8U
+
+/*! @brief Fill a minor motion cube from the first chirps of each frame in addition to the major motion cube (1) or not (0) */
+#define RANGEPROC_MINOR_MOTION_ENABLE           0
+
+/*! @brief Number of doppler chirps per frame written to the minor motion cube (<= doppler chirps per frame) */
+#define RANGEPROC_NUM_MINOR_MOTION_CHIRPS       8
+
+/*! @brief Bytes of the shared memory (DMA and HWA capable regions) which must remain free after the radar cubes
+ *         for the products allocated later */
+#define RANGEPROC_PRODUCT_RESERVE               0
+
+/*! @brief Largest number of ADC samples per chirp accepted from a runtime profile (see config_cmd.h) */
+#define RANGEPROC_MAX_ADC_SAMPLES               1024U
+
+/*! @brief Recover from DPU, HWA and SPI errors in the frame loop by re-arming, resetting or restarting
+ *         the pipeline (1, see recovery.h) or stop in DebugP_assert() (0) */
+#define RANGEPROC_RECOVERY_ENABLE               1
+
+/*! @brief Memory pool checkpoint opened before the DPUs and products are configured (see mem_pool.h) */
+#define RANGEPROC_MEM_CHECKPOINT_PIPELINE       "pipeline"
+
+/*! @brief Use the range window precomputed by chirp_config_to_defines.py (window_table.h) if it matches
+ *         the number of ADC samples (1) or always generate the window at startup (0) */
+#define RANGEPROC_WINDOW_TABLE_ENABLE           1
+
+/*! @brief Also generate the window at startup and compare it with the precomputed table, falling back to the
+ *         generated window on a mismatch (1), e.g. once after a compiler change (fused multiply-adds alter the
+ *         generator's rounding), or trust the table (0) */
+#define RANGEPROC_WINDOW_TABLE_CHECK            0
+
 extern SemaphoreP_Object dpcCfgDoneSemHandle;
 extern SemaphoreP_Object spi_tx_start_sem;
 extern SemaphoreP_Object spi_tx_done_sem;
@@ -81,10 +125,90 @@ void rangeProc_dpuInit(void);
  *
  * This function configures the range processing DPU (Data Path Unit) and the HWA
  * It is derived from the dpc.c of the mmwavedemo project.
+ * The frame shape is taken from gSysContext.profileComCfg and
+ * gSysContext.frameCfg, i.e. from defines.h or from a profile applied at runtime.
+ * The range windows come from a window cache which outlives the pipeline
+ * checkpoint, so a rebuild only generates windows for new numbers of ADC samples.
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+int32_t RangeProc_config();
+
+/**
+ * @brief Measures peak and saturation count of the current radar cube
+ *
+ * Updates gSysContext.cubeStats, which is used by the frame info record and
+ * the range FFT auto-scaling. Must be called after DPU_RangeProcHWA_process().
  *
  * @retval None
  */
-void RangeProc_config();
+void RangeProc_computeCubeStats(void);
+
+/**
+ * @brief Adapts the range FFT scaling to the statistics of the last frame
+ *
+ * Updates the auto-scaling controller with gSysContext.cubeStats. If the shift
+ * changes, a configuration which only differs in the range FFT scaling is
+ * applied by RangeProc_reconfig(), reusing the memory and window of the
+ * existing one. The SDK cannot reprogram the scaling of the range FFT param
+ * sets alone, so DPU_RangeProcHWA_config() programs all param sets and EDMA
+ * channels of the DPU again. Must be called while the HWA is idle, i.e. before
+ * the next frame is triggered.
+ *
+ * @retval SystemP_SUCCESS on success, DPU error code on a failed reconfiguration
+ */
+int32_t RangeProc_autoScale(void);
+
+/**
+ * @brief Applies another range DPU configuration without allocating memory
+ *
+ * Compares the configuration with gSysContext.rangeProcDpuCfg (see
+ * range_reconfig.h). Without changes the DPU is left untouched. Otherwise the
+ * whole configuration is re-applied by DPU_RangeProcHWA_config(), the only
+ * entry point of the SDK which programs the HWA param sets and EDMA channels
+ * of the DPU, with its existing memory and window, which are neither allocated
+ * nor regenerated. gSysContext.rangeProcDpuCfg
+ * only takes the new configuration once the DPU accepted it. Must be called
+ * while the HWA is idle.
+ *
+ * @param[in] newCfg New configuration (window and cube allocated by RangeProc_config())
+ *
+ * @retval SystemP_SUCCESS on success, DPU error code on a failed reconfiguration
+ */
+int32_t RangeProc_reconfig(const DPU_RangeProcHWA_Config *newCfg);
+
+/**
+ * @brief Applies the profile of the front end to the range DPU without rebuilding the pipeline
+ *
+ * Takes the profile from gSysContext.profileComCfg and gSysContext.frameCfg, as
+ * RangeProc_config() does. If the cube shape (range bins, doppler chirps, virtual
+ * antennas) stays the same, the ADC buffer, range FFT, scaling, window (see the
+ * window cache of range_reconfig.h) and chirps per frame are changed and the
+ * configuration is re-applied by RangeProc_reconfig(). The cubes and the stages
+ * after the range DPU keep their memory and configuration. Must be called while
+ * the HWA is idle. Without effect with SUBFRAME_ENABLE.
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE if the cube shape changes or
+ *         the window pool is exhausted (RangeProc_config() is needed then), DPU error code
+ *         on a failed reconfiguration
+ */
+int32_t RangeProc_reconfigProfile(void);
+
+/**
+ * @brief Switches the sensor and the range DPU to another sub-frame
+ *
+ * Stops the sensor, configures the profile and frame shape of the sub-frame
+ * (mmwave_reconfigSensor()) and re-applies the range DPU configuration of the
+ * sub-frame, whose window and radar cube were allocated by RangeProc_config().
+ * Must be called while the HWA is idle; the sensor has to be restarted with
+ * mmwave_startSensor() after the DPU is triggered. Without SUBFRAME_ENABLE this
+ * does nothing.
+ *
+ * @param[in] subFrameIdx Index of the sub-frame in gSubFrameCfg
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE or DPU error code otherwise
+ */
+int32_t RangeProc_switchSubFrame(uint32_t subFrameIdx);
 
 /**
  * @brief Main function for Range Processing DPU
@@ -0,0 +1,140 @@
+#ifndef RD_HEATMAP_H
+#define RD_HEATMAP_H
+
+/**
+ * @file rd_heatmap.h
+ * @brief Range-Doppler heatmap of the radar cube.
+ *
+ * For every range bin and virtual antenna the slow-time sequence of
+ * numDopplerChirps samples is windowed and transformed with a fftSize point
+ * Doppler FFT (zero padded if needed). The magnitudes of the Doppler bins are
+ * summed non-coherently over the virtual antennas:
+ *
+ *   H[bin][dopplerBin] = (sum over antennas of |X[dopplerBin]|) >> shift
+ *
+ * with shift = RdHeatmap_getShift(numVirtualAntennas), so that the sum of
+ * 16-bit magnitudes fits into uint16. Doppler bins are in FFT order, i.e. bin
+ * 0 is zero velocity and bins above fftSize/2 are negative velocities.
+ *
+ * On the device the FFT and the magnitude are computed by the HWA (see
+ * doppler_proc.h). RdHeatmap_compute() is a fixed-point model of the same
+ * computation for validation on a host machine:
+ *   - the window is applied in Q(RD_HEATMAP_WINDOW_QFORMAT) with rounding,
+ *   - every butterfly stage is scaled by 1/2 with rounding, so the FFT has a
+ *     gain of 1 and the output cannot overflow 16 bits,
+ *   - the magnitude is the rounded down square root of re^2 + im^2.
+ * The HWA uses its own internal rounding and magnitude approximation, so
+ * the device output is expected to match the model within a few LSB.
+ *
+ * Layout of the payload (following the StreamRecord_Header):
+ *   - RdHeatmap_Header
+ *   - numRangeBins x fftSize uint16 values, range bin major
+ */
+
+#include <stdint.h>
+
+/*! @brief Q format of the Doppler window coefficients (as generated by mathUtils_genWindow) */
+#define RD_HEATMAP_WINDOW_QFORMAT   (17U)
+
+/*! @brief Largest supported Doppler FFT size */
+#define RD_HEATMAP_MAX_FFT_SIZE     (256U)
+
+/**
+ * @brief Configuration of the heatmap computation.
+ */
+typedef struct RdHeatmap_Config_t
+{
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint16_t numDopplerChirps;
+
+    /*! @brief Doppler FFT size (power of 2, >= numDopplerChirps) */
+    uint16_t fftSize;
+} RdHeatmap_Config;
+
+/**
+ * @brief Header of the heatmap payload.
+ */
+typedef struct RdHeatmap_Header_t
+{
+    /*! @brief Number of range bins (rows) */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of Doppler bins (columns, Doppler FFT size) */
+    uint16_t numDopplerBins;
+
+    /*! @brief Number of virtual antennas summed per value */
+    uint8_t numVirtualAntennas;
+
+    /*! @brief Right shift applied to the antenna sums, see RdHeatmap_getShift() */
+    uint8_t shift;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Duration of the Doppler stage in ticks of the 40 MHz frame reference timer, 0 if unknown */
+    uint32_t computeTicks;
+} RdHeatmap_Header;
+
+/**
+ * @brief Returns the right shift applied to the sum over the virtual antennas.
+ *
+ * @param numVirtualAntennas  number of virtual antennas
+ * @return ceil(log2(numVirtualAntennas))
+ */
+uint32_t RdHeatmap_getShift(uint32_t numVirtualAntennas);
+
+/**
+ * @brief Returns the size of the heatmap without header.
+ *
+ * @param cfg  heatmap configuration
+ * @return size in bytes
+ */
+uint32_t RdHeatmap_getSize(const RdHeatmap_Config *cfg);
+
+/**
+ * @brief Sums Doppler magnitudes over the virtual antennas for a group of range bins.
+ *
+ * Used by the device after the HWA pass and by the reference model.
+ *
+ * @param mag           magnitudes, [numVirtualAntennas][numBins][fftSize]
+ * @param numBins       number of range bins of the group
+ * @param cfg           heatmap configuration
+ * @param heatmap       output, first row of the group, [numBins][fftSize]
+ */
+void RdHeatmap_sumAntennas(const uint16_t *mag, uint32_t numBins, const RdHeatmap_Config *cfg,
+                           uint16_t *heatmap);
+
+/**
+ * @brief Fixed-point reference model of the heatmap computation.
+ *
+ * @param cfg      heatmap configuration
+ * @param cube     radar cube in FORMAT_6 (cmplx16ImRe_t samples)
+ * @param window   first half of the symmetric Doppler window, (numDopplerChirps + 1) / 2
+ *                 coefficients in Q(RD_HEATMAP_WINDOW_QFORMAT)
+ * @param heatmap  output, RdHeatmap_getSize() bytes
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t RdHeatmap_compute(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                          uint16_t *heatmap);
+
+/**
+ * @brief Reference model of the heatmap computation for range bins [firstBin, firstBin + numBins).
+ *
+ * @param cfg       heatmap configuration
+ * @param cube      radar cube in FORMAT_6 (cmplx16ImRe_t samples)
+ * @param window    first half of the symmetric Doppler window, see RdHeatmap_compute()
+ * @param firstBin  first range bin
+ * @param numBins   number of range bins
+ * @param heatmap   output, numBins x fftSize uint16 values
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t RdHeatmap_computeRows(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                              uint32_t firstBin, uint32_t numBins, uint16_t *heatmap);
+
+#endif /* RD_HEATMAP_H */
@@ -0,0 +1,186 @@
+#ifndef RECOVERY_H
+#define RECOVERY_H
+
+/**
+ * @file recovery.h
+ * @brief Recovery of the processing pipeline from DPU, HWA and SPI errors.
+ *
+ * An error in the frame loop of the dpcTask is reported as fault, the frame
+ * is dropped and the pipeline is recovered with the cheapest action which
+ * can fix the fault, escalating while faults keep coming:
+ *
+ * | level   | action                                                        |
+ * |---------|---------------------------------------------------------------|
+ * | RESYNC  | none, the stream of the next frame starts with a marker       |
+ * | REARM   | trigger the range DPU again, it waits for the next frame      |
+ * | RESET   | reset the HWA, re-apply the DPU configuration (HWA param sets |
+ * |         | and EDMA channels) and trigger it                             |
+ * | RESTART | stop the sensor, rebuild the pipeline, trigger and restart    |
+ *
+ * Every fault type starts at its own minimum level (RECOVERY_FAULT_*). After
+ * a successful action the next fault is handled one level higher, unless
+ * RECOVERY_CLEAN_FRAMES frames were processed in between. An action which
+ * fails escalates at once. Once RECOVERY_MAX_RESTARTS restarts in a row
+ * failed, the recovery gives up (RECOVERY_STATE_FAILED).
+ *
+ * Every fault leaves the host behind: frames are missing or, after an SPI
+ * error, the transfer of a frame was cut short. The next frame therefore
+ * starts with a STREAM_RECORD_TYPE_RESYNC record (Recovery_Marker), which the
+ * host finds by scanning for the sync words and which tells it how many
+ * frames were lost.
+ *
+ * The pipeline operations are passed as callbacks.
+ */
+
+#include <stdint.h>
+
+/*! @brief Clean frames after which the next fault starts at its minimum level again */
+#define RECOVERY_CLEAN_FRAMES       8U
+
+/*! @brief Failed restarts in a row after which the recovery gives up */
+#define RECOVERY_MAX_RESTARTS       3U
+
+/*! @brief Sync words at the start of the Recovery_Marker ("RSYNCMRK") */
+#define RECOVERY_SYNC_WORD0         0x4E595352U
+#define RECOVERY_SYNC_WORD1         0x4B524D43U
+
+/*! @brief Recovery levels, result of Recovery_handleFault() */
+#define RECOVERY_LEVEL_RESYNC       0
+#define RECOVERY_LEVEL_REARM        1
+#define RECOVERY_LEVEL_RESET        2
+#define RECOVERY_LEVEL_RESTART      3
+#define RECOVERY_NUM_LEVELS         4
+
+/*! @brief Result of Recovery_handleFault() once the recovery gave up */
+#define RECOVERY_ERR_FAILED         (-1)
+
+/*! @brief Faults and their minimum recovery level */
+#define RECOVERY_FAULT_SPI          0U      /* SPI transfer failed: RESYNC */
+#define RECOVERY_FAULT_PROCESS      1U      /* DPU_RangeProcHWA_process() failed: REARM */
+#define RECOVERY_FAULT_TRIGGER      2U      /* DPU trigger failed: RESET */
+#define RECOVERY_FAULT_STAGE        3U      /* a processing stage or the autoscale reconfiguration failed: RESET */
+#define RECOVERY_FAULT_SENSOR       4U      /* sensor reconfiguration, sub-frame switch or restart failed: RESTART */
+#define RECOVERY_NUM_FAULTS         5U
+
+/*! @brief States */
+#define RECOVERY_STATE_RUNNING      0U      /* no fault within the last RECOVERY_CLEAN_FRAMES frames */
+#define RECOVERY_STATE_RECOVERING   1U      /* recovered, not yet RECOVERY_CLEAN_FRAMES clean frames */
+#define RECOVERY_STATE_FAILED       2U
+
+/**
+ * @brief Pipeline operations, each returns 0 on success.
+ */
+typedef struct Recovery_Ops_t
+{
+    /*! @brief Triggers the range DPU for the next frame */
+    int32_t (*rearm)(void *arg);
+
+    /*! @brief Resets the HWA, re-applies the DPU configuration and triggers the DPU */
+    int32_t (*reset)(void *arg);
+
+    /*! @brief Stops the sensor, rebuilds the pipeline, triggers the DPU and restarts the sensor */
+    int32_t (*restart)(void *arg);
+
+    /*! @brief Passed to the operations */
+    void *arg;
+} Recovery_Ops;
+
+/**
+ * @brief Payload of a STREAM_RECORD_TYPE_RESYNC record.
+ */
+typedef struct Recovery_Marker_t
+{
+    /*! @brief RECOVERY_SYNC_WORD0 and RECOVERY_SYNC_WORD1 */
+    uint32_t sync[2];
+
+    /*! @brief Faults since boot */
+    uint32_t numFaults;
+
+    /*! @brief Last frame which was streamed completely before the fault */
+    uint32_t lastGoodFrameIdx;
+
+    /*! @brief Frames dropped since the previous marker */
+    uint16_t numDroppedFrames;
+
+    /*! @brief Last fault, RECOVERY_FAULT_* */
+    uint8_t lastFault;
+
+    /*! @brief Level of the last recovery action, RECOVERY_LEVEL_* */
+    uint8_t lastLevel;
+
+    /*! @brief Sensor restarts since boot */
+    uint32_t numRestarts;
+} Recovery_Marker;
+
+/**
+ * @brief State of the recovery.
+ */
+typedef struct Recovery_Ctrl_t
+{
+    /*! @brief RECOVERY_STATE_* */
+    uint32_t state;
+
+    /*! @brief Level the next fault is handled with at least */
+    int32_t level;
+
+    /*! @brief Frames processed since the last fault */
+    uint32_t numCleanFrames;
+
+    /*! @brief Failed restarts in a row */
+    uint32_t numFailedRestarts;
+
+    /*! @brief Faults since boot */
+    uint32_t numFaults;
+
+    /*! @brief Successful actions per level since boot */
+    uint32_t numActions[RECOVERY_NUM_LEVELS];
+
+    /*! @brief Last fault and level */
+    uint32_t lastFault;
+    int32_t lastLevel;
+
+    /*! @brief Last frame which was streamed completely */
+    uint32_t lastGoodFrameIdx;
+
+    /*! @brief Frames dropped since the last marker */
+    uint32_t numDroppedFrames;
+
+    /*! @brief A marker has to be streamed with the next frame */
+    uint32_t resyncPending;
+} Recovery_Ctrl;
+
+/**
+ * @brief Initializes the recovery.
+ */
+void Recovery_init(Recovery_Ctrl *ctrl);
+
+/**
+ * @brief Handles a fault: recovers the pipeline and schedules a resync marker.
+ *
+ * @param ctrl     recovery state
+ * @param fault    RECOVERY_FAULT_*
+ * @param dropped  the frame was not streamed completely (1) or the fault came after its transfer (0)
+ * @param ops      pipeline operations
+ * @return level of the successful action (RECOVERY_LEVEL_*) or RECOVERY_ERR_FAILED
+ */
+int32_t Recovery_handleFault(Recovery_Ctrl *ctrl, uint32_t fault, uint32_t dropped, const Recovery_Ops *ops);
+
+/**
+ * @brief Reports a frame which was processed and streamed without fault.
+ */
+void Recovery_frameDone(Recovery_Ctrl *ctrl, uint32_t frameIdx);
+
+/**
+ * @brief Takes the marker to be streamed with the next frame.
+ *
+ * @return 1 if a marker is pending (filled in), 0 otherwise
+ */
+int32_t Recovery_takeMarker(Recovery_Ctrl *ctrl, Recovery_Marker *marker);
+
+/**
+ * @brief Names of faults and levels for logs and host tools.
+ */
+const char *Recovery_faultName(uint32_t fault);
+const char *Recovery_levelName(int32_t level);
+
+#endif /* RECOVERY_H */
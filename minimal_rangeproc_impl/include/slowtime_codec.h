@@ -0,0 +1,152 @@
+#ifndef SLOWTIME_CODEC_H
+#define SLOWTIME_CODEC_H
+
+/**
+ * @file slowtime_codec.h
+ * @brief Lossy transform coding of the radar cube along slow time.
+ *
+ * Every range bin / virtual antenna pair of the cube forms a slow-time sequence
+ * of numDopplerChirps complex samples. The encoder transforms each sequence
+ * with a doppler FFT, so that moving and static targets are compacted into few
+ * coefficients, and keeps only the coefficients above a threshold which is
+ * chosen per frame to reach a target SNR:
+ *
+ *   - half of the allowed noise energy (total energy / 10^(SNR/10)) is spent
+ *     on dropping the weakest coefficients (selected with a log-energy
+ *     histogram, i.e. in O(n)),
+ *   - the rest of the budget defines the uniform quantisation step of the
+ *     kept coefficients. The step is halved (a few times at most) while the
+ *     achieved SNR stays below the target.
+ *
+ * The number of kept coefficients, and therefore the compression ratio,
+ * follows the scene content. The achieved SNR is computed exactly in the
+ * transform domain (Parseval) and is part of the payload.
+ *
+ * Layout of the payload (following the StreamRecord_Header):
+ *   - SlowTimeCodec_Header
+ *   - for every range bin (outer) and virtual antenna (inner):
+ *       uint8_t count, followed by count entries of
+ *       { uint8_t doppler index, int16_t re, int16_t im } (little endian, packed),
+ *       the doppler index k being the bin of exp(-j*2*pi*k*c/n) as for the doppler FFT
+ *   - padding to a multiple of 4 bytes
+ *
+ * The cube is expected in DPIF_RADARCUBE_FORMAT_6 with cmplx16ImRe_t samples.
+ */
+
+#include <stdint.h>
+
+/*! @brief Largest supported number of doppler chirps (power of 2) */
+#define SLOWTIME_CODEC_MAX_CHIRPS       (128U)
+
+/*! @brief Number of bins of the log-energy histogram (4 per octave) */
+#define SLOWTIME_CODEC_HIST_BINS        (256U)
+
+/**
+ * @brief Configuration of the codec.
+ */
+typedef struct SlowTimeCodec_Config_t
+{
+    /*! @brief Target signal to noise ratio of the reconstructed cube in dB */
+    float targetSnrDb;
+
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps (power of 2, <= SLOWTIME_CODEC_MAX_CHIRPS) */
+    uint16_t numDopplerChirps;
+} SlowTimeCodec_Config;
+
+/**
+ * @brief Header of the encoded payload.
+ */
+typedef struct SlowTimeCodec_Header_t
+{
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint16_t numDopplerChirps;
+
+    /*! @brief Reserved, always 0 */
+    uint16_t reserved;
+
+    /*! @brief Target SNR in dB */
+    float targetSnrDb;
+
+    /*! @brief Achieved SNR in dB */
+    float achievedSnrDb;
+
+    /*! @brief Quantisation step of the kept coefficients */
+    float step;
+
+    /*! @brief Number of kept coefficients */
+    uint32_t numKept;
+
+    /*! @brief Number of payload bytes including this header (without padding) */
+    uint32_t encodedBytes;
+} SlowTimeCodec_Header;
+
+/**
+ * @brief Codec object holding the FFT twiddle factors and working memory.
+ */
+typedef struct SlowTimeCodec_Obj_t
+{
+    /*! @brief Codec configuration */
+    SlowTimeCodec_Config cfg;
+
+    /*! @brief Twiddle factors exp(-j*2*pi*k/n) of the forward transform, (cos, -sin) interleaved */
+    float twiddle[SLOWTIME_CODEC_MAX_CHIRPS];
+
+    /*! @brief Sequence being transformed, complex interleaved (re, im) */
+    float seq[2U * SLOWTIME_CODEC_MAX_CHIRPS];
+
+    /*! @brief Energy per log-energy histogram bin */
+    double histEnergy[SLOWTIME_CODEC_HIST_BINS];
+} SlowTimeCodec_Obj;
+
+/**
+ * @brief Initialises a codec object.
+ *
+ * @param obj  codec object
+ * @param cfg  codec configuration
+ * @return 0 on success, -1 on an unsupported configuration
+ */
+int32_t SlowTimeCodec_init(SlowTimeCodec_Obj *obj, const SlowTimeCodec_Config *cfg);
+
+/**
+ * @brief Returns the worst case payload size (all coefficients kept).
+ *
+ * @param cfg  codec configuration
+ * @return payload size in bytes (multiple of 4)
+ */
+uint32_t SlowTimeCodec_getMaxPayloadSize(const SlowTimeCodec_Config *cfg);
+
+/**
+ * @brief Encodes a radar cube.
+ *
+ * @param obj      codec object
+ * @param cube     radar cube (FORMAT_6, complex int16 samples)
+ * @param payload  output buffer of SlowTimeCodec_getMaxPayloadSize() bytes, 4 byte aligned
+ * @return payload size in bytes including padding, -1 on invalid arguments
+ */
+int32_t SlowTimeCodec_encode(SlowTimeCodec_Obj *obj, const int16_t *cube, void *payload);
+
+/**
+ * @brief Decodes a payload into a radar cube.
+ *
+ * The codec object has to be initialised with the dimensions of the header.
+ *
+ * @param obj      codec object
+ * @param payload  payload as written by SlowTimeCodec_encode()
+ * @param cube     output radar cube (FORMAT_6, complex int16 samples)
+ * @return 0 on success, -1 on a payload not matching the codec configuration
+ */
+int32_t SlowTimeCodec_decode(SlowTimeCodec_Obj *obj, const void *payload, int16_t *cube);
+
+#endif /* SLOWTIME_CODEC_H */
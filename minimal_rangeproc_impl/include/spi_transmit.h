@@ -18,6 +18,15 @@
  *       for synchronization.
 */
 
+/*! @brief Exchange a command slot with the host after the buffers of each frame (1) or only transmit (0).
+ *         The host clocks SPI_CMD_SLOT_WORDS words more per frame: it receives the status record
+ *         and sends a command record (see config_cmd.h) or zeros. Requires mcspi1.trMode = "TX_RX"
+ *         in example.syscfg. */
+#define SPI_CMD_CHANNEL_ENABLE      0
+
+/*! @brief Size of the command slot in 32-bit words, holds a command and a status record */
+#define SPI_CMD_SLOT_WORDS          32U
+
 /**
  * @brief Semaphore to signal the start of SPI transmission.
  *
@@ -46,6 +55,30 @@ extern uint32_t gpioBaseAddrLed, pinNumLed;
  */
 static int32_t spi_transfer_buffer(void *txBuf, uint32_t totalBytes);
 
+#if SPI_CMD_CHANNEL_ENABLE
+/**
+ * @brief Exchange the command slot: transmit the status record and receive a command record.
+ *
+ * A received profile is queued in gSysContext.configCmd and applied by the
+ * dpcTask at the frame boundary (see ConfigCmd_service()).
+ *
+ * @return SystemP_SUCCESS on success, otherwise error from SPI transfer
+ */
+static int32_t spi_exchange_cmd_slot(void);
+#endif
+
+/**
+ * @brief Allocate the command slot buffers (DMA reachable) and check the SPI mode.
+ *
+ * Must be called before the pipeline checkpoint is opened, so that the
+ * buffers survive a reconfiguration. Without SPI_CMD_CHANNEL_ENABLE this
+ * does nothing.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE if the SPI does not receive
+ *         or the buffers can not be allocated
+ */
+int32_t spi_cmdSlotConfig(void);
+
 /**
  * @brief SPI transmission loop function.
  *
@@ -0,0 +1,95 @@
+#ifndef STREAM_CFG_H
+#define STREAM_CFG_H
+
+/**
+ * @file stream_cfg.h
+ * @brief Static selection of the data products which are streamed via SPI.
+ *
+ * By default only the raw radar cube is streamed, which keeps the stream
+ * compatible with the mmwave-spi-ftdi-reader. All other products are framed by
+ * a StreamRecord_Header (see stream_record.h). The frame info record is
+ * transferred before the raw cube, all other products after it in the order of
+ * the defines below.
+ */
+
+/*! @brief Stream a StreamRecord_FrameInfo record per frame (required by
+ *         RANGEPROC_FFT_AUTOSCALE_ENABLE to tag frames with the applied shift) */
+#define STREAM_FRAME_INFO_ENABLE            0
+
+/*! @brief Stream the raw 16-bit radar cube (without record header) */
+#define STREAM_RAW_CUBE_ENABLE              1
+
+/*! @brief Stream the int8 quantised radar cube, see cube_quant.h */
+#define STREAM_CUBE_QUANT_ENABLE            0
+
+/*! @brief Scale factor granularity of the quantised cube (CubeQuant_Granularity) */
+#define STREAM_CUBE_QUANT_GRANULARITY       CUBE_QUANT_GRANULARITY_PER_RANGE_BIN
+
+/*! @brief Dither the quantised cube (1) or not (0) */
+#define STREAM_CUBE_QUANT_DITHER_ENABLE     0
+
+/*! @brief Stream the non-coherent range profile (uint32 per range bin), see range_profile.h */
+#define STREAM_RANGE_PROFILE_ENABLE         0
+
+/*! @brief Stream the range-Doppler heatmap (requires DOPPLERPROC_ENABLE), see rd_heatmap.h */
+#define STREAM_RD_HEATMAP_ENABLE            0
+
+/*! @brief Stream the CFAR detection list (requires CFARPROC_ENABLE), see cfar.h */
+#define STREAM_CFAR_DETECTIONS_ENABLE       0
+
+/*! @brief Stream the range-azimuth heatmap (requires DOAPROC_HEATMAP_ENABLE), see doa.h */
+#define STREAM_DOA_HEATMAP_ENABLE           0
+
+/*! @brief Stream the DoA estimate list (requires DOAPROC_ESTIMATES_ENABLE), see doa.h */
+#define STREAM_DOA_ESTIMATES_ENABLE         0
+
+/*! @brief Stream the micro-Doppler spectrogram column (requires UDOPPROC_ENABLE), see micro_doppler.h */
+#define STREAM_MICRO_DOPPLER_ENABLE         0
+
+/*! @brief Stream the major motion cube as a tagged record every STREAM_MAJOR_CUBE_DECIM frames,
+ *         see StreamRecord_CubeInfo (independent of the untagged raw cube) */
+#define STREAM_MAJOR_CUBE_ENABLE            0
+
+/*! @brief Stream the minor motion cube as a tagged record every STREAM_MINOR_CUBE_DECIM frames
+ *         (requires RANGEPROC_MINOR_MOTION_ENABLE) */
+#define STREAM_MINOR_CUBE_ENABLE            0
+
+/*! @brief Decimation factors of the tagged major and minor motion cubes (1 = every frame) */
+#define STREAM_MAJOR_CUBE_DECIM             1
+#define STREAM_MINOR_CUBE_DECIM             1
+
+/*! @brief Dimension order of all streamed radar cubes (raw and tagged), CUBE_LAYOUT_* from
+ *         cube_layout.h; any other layout than CUBE_LAYOUT_CHIRP_MAJOR with interleaved I/Q costs
+ *         a reordered copy in L3 and is not understood by the mmwave-spi-ftdi-reader */
+#define STREAM_CUBE_LAYOUT_ORDER            CUBE_LAYOUT_CHIRP_MAJOR
+
+/*! @brief Stream the cubes as a real and an imaginary plane (1) or with interleaved I/Q (0) */
+#define STREAM_CUBE_LAYOUT_IQ_SPLIT         0
+
+/*! @brief Stream the list of the K strongest range bins, see range_peaks.h */
+#define STREAM_RANGE_PEAKS_ENABLE           0
+
+/*! @brief Number of peaks (K) in the range peak list */
+#define STREAM_RANGE_PEAKS_MAX_PEAKS        8
+
+/*! @brief First range bin searched for peaks (skips DC and TX leakage) */
+#define STREAM_RANGE_PEAKS_MIN_BIN          2
+
+/*! @brief Stream the slow-time transform coded radar cube, see slowtime_codec.h */
+#define STREAM_SLOWTIME_CODEC_ENABLE        0
+
+/*! @brief Target SNR of the slow-time coded radar cube in dB */
+#define STREAM_SLOWTIME_CODEC_SNR_DB        (30.0f)
+
+/*! @brief Stream the boot report (durations of the boot phases up to the first frame on the wire)
+ *         once, with the second frame, see boot_report.h */
+#define STREAM_BOOT_REPORT_ENABLE           0
+
+/*! @brief Start the frame after a recovered DPU, HWA or SPI fault with a resync marker record, see
+ *         recovery.h (breaks the fixed frame size the mmwave-spi-ftdi-reader relies on) */
+#define STREAM_RESYNC_MARKER_ENABLE         0
+
+/*! @brief Maximum number of buffers transferred per frame */
+#define STREAM_MAX_TX_BUFFERS               16
+
+#endif /* STREAM_CFG_H */
@@ -0,0 +1,35 @@
+#ifndef STREAM_PRODUCTS_H
+#define STREAM_PRODUCTS_H
+
+/**
+ * @file stream_products.h
+ * @brief Data products computed from the radar cube and streamed via SPI.
+ *
+ * This module allocates the buffers of the products selected in stream_cfg.h,
+ * computes them after every processed frame and registers them in
+ * gSysContext.streamTxBuf, from where they are picked up by the SPI task.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Allocates the product buffers and registers the SPI transfer buffers.
+ *
+ * Must be called after RangeProc_config(), since the products are derived
+ * from the radar cube configuration.
+ *
+ * @return SystemP_SUCCESS on success, SystemP_FAILURE if the memory pools are exhausted
+ */
+int32_t streamProducts_config(void);
+
+/**
+ * @brief Computes all enabled products from the current radar cube.
+ *
+ * Called by the dpcTask after DPU_RangeProcHWA_process() has completed and
+ * before the SPI transfer is triggered.
+ *
+ * @param frameIdx  index of the processed frame, written to the record headers
+ */
+void streamProducts_process(uint32_t frameIdx);
+
+#endif /* STREAM_PRODUCTS_H */
@@ -0,0 +1,180 @@
+#ifndef STREAM_RECORD_H
+#define STREAM_RECORD_H
+
+/**
+ * @file stream_record.h
+ * @brief Framing of the data products streamed via SPI.
+ *
+ * Every product apart from the raw radar cube is prefixed with a
+ * StreamRecord_Header, so that the host can identify the product, the frame it
+ * belongs to and the number of bytes that follow.
+ *
+ * The header only depends on stdint.h, so it can be included by host tools
+ * which parse the stream.
+ *
+ * All records are padded to a multiple of 4 bytes, since the SPI transfers
+ * are made of 32-bit frames.
+ */
+
+#include <stdint.h>
+
+/*! @brief Magic word at the start of each record ("RREC" in little endian) */
+#define STREAM_RECORD_MAGIC         (0x43455252U)
+
+/*! @brief Version of the record layout, incremented on incompatible changes */
+#define STREAM_RECORD_VERSION       (1U)
+
+/*! @brief Rounds a record size up to the next multiple of the 32-bit SPI frame */
+#define STREAM_RECORD_ALIGN(x)      ((((uint32_t)(x)) + 3U) & ~3U)
+
+/**
+ * @brief Types of records which can be found in the stream.
+ */
+typedef enum StreamRecord_Type_e
+{
+    /*! @brief Int8 quantised radar cube, see cube_quant.h */
+    STREAM_RECORD_TYPE_CUBE_QUANT = 1,
+
+    /*! @brief Per-frame processing information, see @ref StreamRecord_FrameInfo */
+    STREAM_RECORD_TYPE_FRAME_INFO = 2,
+
+    /*! @brief List of the K strongest range bins, see range_peaks.h */
+    STREAM_RECORD_TYPE_RANGE_PEAKS = 3,
+
+    /*! @brief Slow-time transform coded radar cube (variable size), see slowtime_codec.h */
+    STREAM_RECORD_TYPE_SLOWTIME_CODEC = 4,
+
+    /*! @brief Non-coherent range profile, see range_profile.h */
+    STREAM_RECORD_TYPE_RANGE_PROFILE = 5,
+
+    /*! @brief Range-Doppler heatmap, see rd_heatmap.h */
+    STREAM_RECORD_TYPE_RD_HEATMAP = 6,
+
+    /*! @brief CFAR detection list (variable size), see cfar.h */
+    STREAM_RECORD_TYPE_CFAR_DETECTIONS = 7,
+
+    /*! @brief Range-azimuth heatmap, see doa.h */
+    STREAM_RECORD_TYPE_DOA_HEATMAP = 8,
+
+    /*! @brief Azimuth and elevation of the CFAR detections (variable size), see doa.h */
+    STREAM_RECORD_TYPE_DOA_ESTIMATES = 9,
+
+    /*! @brief Micro-Doppler spectrogram column, see micro_doppler.h */
+    STREAM_RECORD_TYPE_MICRO_DOPPLER = 10,
+
+    /*! @brief Major or minor motion radar cube, see @ref StreamRecord_CubeInfo */
+    STREAM_RECORD_TYPE_RADAR_CUBE = 11,
+
+    /*! @brief Durations of the boot phases, transmitted once after boot, see boot_report.h */
+    STREAM_RECORD_TYPE_BOOT_REPORT = 12,
+
+    /*! @brief Resync marker, first record of the frame after a recovered fault, see recovery.h */
+    STREAM_RECORD_TYPE_RESYNC = 13
+} StreamRecord_Type;
+
+/**
+ * @brief Header which precedes the payload of every record.
+ */
+typedef struct StreamRecord_Header_t
+{
+    /*! @brief Always STREAM_RECORD_MAGIC */
+    uint32_t magic;
+
+    /*! @brief Record type, see @ref StreamRecord_Type */
+    uint16_t recordType;
+
+    /*! @brief Record layout version, see STREAM_RECORD_VERSION */
+    uint16_t version;
+
+    /*! @brief Index of the frame the payload was computed from */
+    uint32_t frameIdx;
+
+    /*! @brief Number of payload bytes following the header (multiple of 4) */
+    uint32_t payloadBytes;
+} StreamRecord_Header;
+
+/**
+ * @brief Payload of a STREAM_RECORD_TYPE_FRAME_INFO record.
+ *
+ * Describes how the radar cube of the frame was computed, e.g. the range FFT
+ * scaling which has to be undone to compare cubes of different frames.
+ */
+typedef struct StreamRecord_FrameInfo_t
+{
+    /*! @brief rangeFFTtuning.fftOutputDivShift applied to this frame */
+    uint8_t fftOutputDivShift;
+
+    /*! @brief rangeFFTtuning.numLastButterflyStagesToScale applied to this frame */
+    uint8_t numButterflyStagesScaled;
+
+    /*! @brief Largest magnitude of any I or Q value of the radar cube */
+    uint16_t cubePeak;
+
+    /*! @brief Number of saturated I or Q values of the radar cube */
+    uint32_t cubeNumSaturated;
+} StreamRecord_FrameInfo;
+
+/*! @brief StreamRecord_CubeInfo::cubeType of the major motion cube */
+#define STREAM_RECORD_CUBE_MAJOR    (0U)
+
+/*! @brief StreamRecord_CubeInfo::cubeType of the minor motion cube */
+#define STREAM_RECORD_CUBE_MINOR    (1U)
+
+/**
+ * @brief Payload start of a STREAM_RECORD_TYPE_RADAR_CUBE record.
+ *
+ * The cube follows in the layout given by order and iqSplit (see
+ * cube_layout.h, CUBE_LAYOUT_CHIRP_MAJOR with interleaved I/Q is the native
+ * DPIF_RADARCUBE_FORMAT_6) and is part of the payload.
+ */
+typedef struct StreamRecord_CubeInfo_t
+{
+    /*! @brief STREAM_RECORD_CUBE_MAJOR or STREAM_RECORD_CUBE_MINOR */
+    uint8_t cubeType;
+
+    /*! @brief Decimation factor the cube is streamed with */
+    uint8_t decim;
+
+    /*! @brief Number of range bins */
+    uint16_t numRangeBins;
+
+    /*! @brief Number of virtual antennas */
+    uint16_t numVirtualAntennas;
+
+    /*! @brief Number of doppler chirps */
+    uint16_t numChirps;
+
+    /*! @brief Dimension order of the cube, CUBE_LAYOUT_* */
+    uint8_t order;
+
+    /*! @brief Real and imaginary planes (1) or interleaved I/Q (0) */
+    uint8_t iqSplit;
+
+    /*! @brief Sub-frame the cube belongs to (always 0 without SUBFRAME_ENABLE), see subframe_cfg.h */
+    uint8_t subFrameIdx;
+
+    /*! @brief Reserved, always 0 */
+    uint8_t reserved;
+} StreamRecord_CubeInfo;
+
+/**
+ * @brief Fills in a record header.
+ *
+ * @param hdr           pointer to the header to fill in
+ * @param recordType    record type, see @ref StreamRecord_Type
+ * @param frameIdx      index of the frame the payload belongs to
+ * @param payloadBytes  number of payload bytes following the header
+ */
+static inline void StreamRecord_initHeader(StreamRecord_Header *hdr,
+                                           uint16_t recordType,
+                                           uint32_t frameIdx,
+                                           uint32_t payloadBytes)
+{
+    hdr->magic        = STREAM_RECORD_MAGIC;
+    hdr->recordType   = recordType;
+    hdr->version      = STREAM_RECORD_VERSION;
+    hdr->frameIdx     = frameIdx;
+    hdr->payloadBytes = STREAM_RECORD_ALIGN(payloadBytes);
+}
+
+#endif /* STREAM_RECORD_H */
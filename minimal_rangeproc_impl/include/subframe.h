@@ -0,0 +1,127 @@
+#ifndef SUBFRAME_H
+#define SUBFRAME_H
+
+/**
+ * @file subframe.h
+ * @brief Parameters and memory bookkeeping of interleaved sub-frames.
+ *
+ * A sub-frame is one sensor frame with its own chirp profile and frame
+ * shape, e.g. a long-range low-resolution and a short-range high-resolution
+ * profile. The sub-frames are transmitted one after the other in a fixed
+ * rotation. Each sub-frame has its own range DPU configuration, range window
+ * (window pool, shared by sub-frames with the same number of ADC samples) and
+ * radar cube (shared memory), so that switching between them neither
+ * allocates memory nor regenerates windows.
+ *
+ * SubFrame_plan() derives the cube dimensions of every sub-frame (see
+ * chirp_accum.h) and places the cubes and windows one after the other, as
+ * the memory pools do (for the windows this is the worst case without
+ * sharing).
+ */
+
+#include <stdint.h>
+
+/*! @brief Maximum number of sub-frames */
+#define SUBFRAME_MAX_NUM            4
+
+/**
+ * @brief Parameters which may differ between sub-frames.
+ *
+ * All other front-end parameters (sampling rate, TX/RX antennas, MIMO
+ * pattern, timings) are shared and taken from defines.h.
+ */
+typedef struct SubFrame_Config_t
+{
+    /*! @brief chirpComnCfg numOfAdcSamples */
+    uint32_t numAdcSamples;
+
+    /*! @brief frameCfg numOfChirpsInBurst */
+    uint32_t numChirpsPerBurst;
+
+    /*! @brief frameCfg numOfBurstsInFrame */
+    uint32_t numBurstsPerFrame;
+
+    /*! @brief frameCfg numOfChirpsAccum */
+    uint32_t numChirpsAccum;
+
+    /*! @brief chirpTimingCfg chirpRfFreqSlope in MHz/us */
+    uint32_t chirpSlope;
+
+    /*! @brief Chirp ramp end time in units of 10 ns (h_ChirpRampEndTime) */
+    uint32_t rampEndTime;
+} SubFrame_Config;
+
+/**
+ * @brief Derived dimensions and memory placement of one sub-frame.
+ */
+typedef struct SubFrame_Layout_t
+{
+    /*! @brief Number of range bins (half the power of 2 FFT size) */
+    uint32_t numRangeBins;
+
+    /*! @brief Chirps per frame seen by the range DPU */
+    uint32_t numChirpsPerFrame;
+
+    /*! @brief Doppler chirps per frame */
+    uint32_t numDopplerChirpsPerFrame;
+
+    /*! @brief Additional range FFT shift of the chirp accumulation */
+    uint32_t extraShift;
+
+    /*! @brief Size of the radar cube in bytes */
+    uint32_t cubeBytes;
+
+    /*! @brief Offset of the radar cube from the first cube */
+    uint32_t cubeOffset;
+
+    /*! @brief Size of the symmetric range window in bytes */
+    uint32_t windowBytes;
+
+    /*! @brief Offset of the range window from the first window */
+    uint32_t windowOffset;
+} SubFrame_Layout;
+
+/**
+ * @brief Memory plan of all sub-frames.
+ */
+typedef struct SubFrame_Plan_t
+{
+    /*! @brief Number of sub-frames */
+    uint32_t numSubFrames;
+
+    /*! @brief Layout of each sub-frame */
+    SubFrame_Layout layout[SUBFRAME_MAX_NUM];
+
+    /*! @brief Shared memory bytes taken by all cubes */
+    uint32_t cubeBytes;
+
+    /*! @brief Window pool bytes taken by all windows */
+    uint32_t windowBytes;
+} SubFrame_Plan;
+
+/**
+ * @brief Computes the dimensions of all sub-frames and places their cubes and windows.
+ *
+ * Cubes and windows are 4 byte aligned and placed in the order of the
+ * sub-frames.
+ *
+ * @param cfg                 sub-frame table
+ * @param numSubFrames        number of entries of cfg (1 .. SUBFRAME_MAX_NUM)
+ * @param numTxAntennas       number of TX antennas
+ * @param numRxAntennas       number of RX antennas
+ * @param cubeBudget          bytes of the largest shared memory region available for the cubes
+ * @param windowBudget        window pool bytes available for the windows
+ * @param plan                output
+ * @return 0 on success, -1 if a sub-frame is invalid (see ChirpAccum_compute())
+ *         or the cubes or windows exceed their budget
+ */
+int32_t SubFrame_plan(const SubFrame_Config *cfg, uint32_t numSubFrames,
+                      uint32_t numTxAntennas, uint32_t numRxAntennas,
+                      uint32_t cubeBudget, uint32_t windowBudget, SubFrame_Plan *plan);
+
+/**
+ * @brief Returns the sub-frame following idx in the rotation.
+ */
+uint32_t SubFrame_next(uint32_t idx, uint32_t numSubFrames);
+
+#endif /* SUBFRAME_H */
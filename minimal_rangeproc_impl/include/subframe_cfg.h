@@ -0,0 +1,46 @@
+#ifndef SUBFRAME_CFG_H
+#define SUBFRAME_CFG_H
+
+/**
+ * @file subframe_cfg.h
+ * @brief Static selection of the interleaved sub-frames.
+ *
+ * The xWRL6432 front end takes a single profile per frame configuration
+ * (frameCfg[0]), so the sub-frames are time-multiplexed: after every frame the
+ * sensor is stopped, reconfigured with the profile and frame shape of the next
+ * sub-frame and restarted, and the range DPU is switched to the configuration
+ * and radar cube of that sub-frame (see RangeProc_switchSubFrame()).
+ *
+ * Sub-frame 0 is always the configuration of defines.h, further sub-frames
+ * only override the parameters of SubFrame_Config. Every sub-frame cube is
+ * streamed as a tagged STREAM_RECORD_TYPE_RADAR_CUBE record carrying the index
+ * of its sub-frame, so STREAM_MAJOR_CUBE_ENABLE is required.
+ *
+ * Unlike defines.h this file is not generated by chirp_config_to_defines.py.
+ */
+
+#include "subframe.h"
+
+/*! @brief Interleave the sub-frames below (1) or run the configuration of defines.h only (0) */
+#define SUBFRAME_ENABLE                     0
+
+/*! @brief Sub-frame 1: long range, low resolution (half the slope, i.e. half the bandwidth
+ *         and twice the maximum range of sub-frame 0) at half the chirp rate */
+#define SUBFRAME_1_NUM_ADC_SAMPLES          CLI_NUM_ADC_SAMPLES
+#define SUBFRAME_1_NUM_CHIRPS_PER_BURST     CLI_NUM_CHIRPS_PER_BURST
+#define SUBFRAME_1_NUM_BURSTS_PER_FRAME     32
+#define SUBFRAME_1_NUM_CHIRPS_ACCUM         CLI_NUM_CHIRPS_ACCUM
+#define SUBFRAME_1_CHIRP_SLOPE              (CLI_CHIRP_SLOPE / 2)
+#define SUBFRAME_1_CHIRP_RAMP_END_TIME      CLI_CHIRP_RAMP_END_TIME
+
+#if SUBFRAME_ENABLE
+/*! @brief Number of interleaved sub-frames (<= SUBFRAME_MAX_NUM) */
+#define SUBFRAME_NUM                        2
+#else
+#define SUBFRAME_NUM                        1
+#endif
+
+/*! @brief Sub-frame table in rotation order, defined in mmwave_control_config.c */
+extern const SubFrame_Config gSubFrameCfg[SUBFRAME_NUM];
+
+#endif /* SUBFRAME_CFG_H */
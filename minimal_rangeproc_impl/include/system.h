@@ -41,6 +41,18 @@
 #include <drivers/hwa.h>
 #include "kernel/dpl/SemaphoreP.h"
 
+#include "stream_cfg.h"
+#include "fft_autoscale.h"
+#include "rd_heatmap.h"
+#include "cfar.h"
+#include "doa.h"
+#include "subframe_cfg.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "config_cmd.h"
+#include "boot_report.h"
+#include "recovery.h"
+
 
 /*!
  * @brief DMA channel defines (as opposed to more dynamic DPC_ObjDet_HwaDmaTrigSrcChanPoolAlloc() in MPD demo project)
@@ -50,36 +62,16 @@
 
 
 /*!
- * @brief Memory Configuration used during init API
+ * @brief Buffer which is transferred via SPI once per frame.
  */
-typedef struct DPC_ObjectDetection_MemCfg_t
+typedef struct StreamTxBuffer_t
 {
-    /*! @brief   Start address of memory provided by the application
-     *           from which DPC will allocate.
-     */
-    void *addr;
-
-    /*! @brief   Size limit of memory allowed to be consumed by the DPC */
-    uint32_t size;
-} DPC_ObjectDetection_MemCfg;
+    /*! @brief Start address of the buffer */
+    void *data;
 
-/*!
- * @brief Memory pool object to manage memory based on @ref DPC_ObjectDetection_MemCfg_t.
- */
-typedef struct MemPoolObj_t
-{
-    /*! @brief Memory configuration */
-    DPC_ObjectDetection_MemCfg cfg;
-
-    /*! @brief   Pool running adress.*/
-    uintptr_t currAddr;
-
-    /*! @brief   Pool max address. This pool allows setting address to desired
-     *           (e.g for rewinding purposes), so having a running maximum
-     *           helps in finding max pool usage
-     */
-    uintptr_t maxCurrAddr;
-} MemPoolObj;
+    /*! @brief Number of bytes to transfer (multiple of 4) */
+    uint32_t dataSize;
+} StreamTxBuffer;
 
 
 /*! @brief Global struct which holds all handles and configs. */
@@ -111,12 +103,101 @@ typedef struct {
     /*! @brief Core Local ram memory pool object */
     MemPoolObj    CoreLocalRamObj;
 
+    /*! @brief FECSS shared ram memory pool object (empty unless MMWAVE_FECSS_SHRAM_POOL_ENABLE) */
+    MemPoolObj    FecssShramObj;
+
+    /*! @brief All pools as placement regions, see mem_region.h */
+    MemRegion_Map memRegions;
+
     /*! @brief Handle for Range Processing DPU */
     DPU_RangeProcHWA_Handle rangeProcHWADpuHandle;
 
     /*! @brief Config for Rangeproc DPU */
     DPU_RangeProcHWA_Config rangeProcDpuCfg;
 
+#if SUBFRAME_ENABLE
+    /*! @brief Range DPU configuration of each sub-frame, copied to rangeProcDpuCfg on a switch */
+    DPU_RangeProcHWA_Config subFrameDpuCfg[SUBFRAME_NUM];
+
+    /*! @brief Dimensions and memory placement of the sub-frames */
+    SubFrame_Plan subFramePlan;
+#endif
+
+    /*! @brief Sub-frame whose configuration is in rangeProcDpuCfg (always 0 without SUBFRAME_ENABLE) */
+    uint32_t subFrameIdx;
+
+    /*! @brief Range FFT auto-scaling controller configuration */
+    FftAutoScale_Config fftAutoScaleCfg;
+
+    /*! @brief Range FFT auto-scaling controller state */
+    FftAutoScale_State fftAutoScaleState;
+
+    /*! @brief Peak and saturation statistics of the last processed radar cube */
+    FftAutoScale_Stats cubeStats;
+
+    /*! @brief Dimensions of the range-Doppler heatmap (Doppler stage) */
+    RdHeatmap_Config rdHeatmapCfg;
+
+    /*! @brief Range-Doppler heatmap of the last frame in the shared memory, NULL if the Doppler stage is disabled */
+    uint16_t *rdHeatmap;
+
+    /*! @brief Duration of the Doppler stage of the last frame (40 MHz ticks) */
+    uint32_t dopplerProcTicks;
+
+    /*! @brief Configuration of the CFAR stage */
+    Cfar_Config cfarCfg;
+
+    /*! @brief CFAR detection list of the last frame in the shared memory (Cfar_Header and detections) */
+    void *cfarDetList;
+
+    /*! @brief Configuration and antenna geometry of the DoA stage */
+    Doa_Config doaCfg;
+
+    /*! @brief Range-azimuth heatmap of the last frame in the shared memory, NULL if not computed */
+    uint16_t *doaHeatmap;
+
+    /*! @brief DoA estimate list of the last frame in the shared memory (Doa_ListHeader and estimates), NULL if not computed */
+    void *doaList;
+
+    /*! @brief Duration of the range-azimuth heatmap computation of the last frame (40 MHz ticks) */
+    uint32_t doaProcTicks;
+
+    /*! @brief Part of doaProcTicks during which the HWA was busy (40 MHz ticks) */
+    uint32_t doaHwaTicks;
+
+    /*! @brief Micro-Doppler spectrogram column of the last frame in the shared memory (MicroDoppler_Header and column) */
+    void *microDoppler;
+
+    /*! @brief Buffers transferred via SPI each frame, in transfer order */
+    StreamTxBuffer streamTxBuf[STREAM_MAX_TX_BUFFERS];
+
+    /*! @brief Number of valid entries in streamTxBuf */
+    uint32_t numStreamTxBuf;
+
+    /*! @brief Set by the SPI task if a buffer of the current frame could not be transferred */
+    uint32_t spiTxFailed;
+
+    /*! @brief Recovery of the frame loop from DPU, HWA and SPI errors, see recovery.h */
+    Recovery_Ctrl recovery;
+
+    /*! @brief Active chirp profile and runtime reconfiguration state, see config_cmd.h */
+    ConfigCmd_Ctrl configCmd;
+
+    /*! @brief Profile the sensor was booted with, from flash or defines.h (see mmwave_loadBootProfile()) */
+    ConfigCmd_Profile bootProfile;
+
+    /*! @brief PROFILE_BLOB_SOURCE_FLASH or PROFILE_BLOB_SOURCE_DEFAULT */
+    uint32_t bootProfileSource;
+
+    /*! @brief Booted warm (1, profile and factory calibration retained in RAM) or cold (0), see warm_start.h */
+    uint32_t warmStart;
+
+    /*! @brief Boots since the last cold boot, including this one */
+    uint32_t numBoots;
+
+    /*! @brief Durations of the boot phases up to the first frame on the wire, see boot_report.h */
+    BootReport bootReport;
+
     T_RL_API_SENS_CHIRP_PROF_COMN_CFG profileComCfg;
     T_RL_API_SENS_CHIRP_PROF_TIME_CFG profileTimeCfg;
     T_RL_API_FECSS_RF_PWR_CFG_CMD channelCfg;
@@ -0,0 +1,86 @@
+#ifndef WARM_START_H
+#define WARM_START_H
+
+/**
+ * @file warm_start.h
+ * @brief State retained in RAM across resets for the warm-start boot path.
+ *
+ * After the sensor was started, the boot profile and a CRC of the restored
+ * factory calibration are sealed into a record placed in a RAM section which
+ * is not initialized at boot (.retained, see linker.cmd). After a reset
+ * without power loss, e.g. by the watchdog, the record is still valid and the
+ * firmware boots warm: MMWave_init() with iswarmstart, the profile and the
+ * factory calibration are taken from RAM instead of flash and only the
+ * profile is programmed again. After a power-on the RAM content is random and
+ * the CRC fails, so the firmware boots cold.
+ *
+ * The record is invalidated as soon as it was checked, so a reset during the
+ * boot always leads to a cold boot.
+ */
+
+#include <stdint.h>
+
+#include "config_cmd.h"
+
+/*! @brief First word of a valid record ("WRMS") */
+#define WARM_START_MAGIC        0x57524D53U
+
+/*! @brief Version of the record, increased whenever it changes */
+#define WARM_START_VERSION      1U
+
+/**
+ * @brief State retained across resets.
+ */
+typedef struct WarmStart_State_t
+{
+    /*! @brief WARM_START_MAGIC if valid */
+    uint32_t magic;
+
+    /*! @brief WARM_START_VERSION */
+    uint32_t version;
+
+    /*! @brief Boots since the last cold boot, including it */
+    uint32_t numBoots;
+
+    /*! @brief Profile the sensor was started with */
+    ConfigCmd_Profile profile;
+
+    /*! @brief Origin of the profile, PROFILE_BLOB_SOURCE_* */
+    uint32_t profileSource;
+
+    /*! @brief CRC-32 of the restored factory calibration data */
+    uint32_t calibCrc;
+
+    /*! @brief CRC-32 of the fields above */
+    uint32_t crc;
+} WarmStart_State;
+
+/**
+ * @brief Checks whether the retained state allows a warm boot.
+ *
+ * @param state       retained state
+ * @param calib       factory calibration data retained in RAM
+ * @param calibBytes  size of the calibration data
+ * @return 1 if the record and the calibration data are intact, 0 otherwise
+ */
+int32_t WarmStart_isValid(const WarmStart_State *state, const void *calib, uint32_t calibBytes);
+
+/**
+ * @brief Invalidates the retained state.
+ */
+void WarmStart_invalidate(WarmStart_State *state);
+
+/**
+ * @brief Seals the retained state once the sensor runs.
+ *
+ * @param state          retained state
+ * @param numBoots       boots since the last cold boot, including this one
+ * @param profile        profile the sensor was started with
+ * @param profileSource  PROFILE_BLOB_SOURCE_*
+ * @param calib          restored factory calibration data
+ * @param calibBytes     size of the calibration data
+ */
+void WarmStart_seal(WarmStart_State *state, uint32_t numBoots, const ConfigCmd_Profile *profile,
+                    uint32_t profileSource, const void *calib, uint32_t calibBytes);
+
+#endif /* WARM_START_H */
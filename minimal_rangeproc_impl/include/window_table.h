@@ -0,0 +1,41 @@
+
+#ifndef WINDOW_TABLE_H
+#define WINDOW_TABLE_H
+
+/**
+ * @file window_table.h
+ *
+ * @brief Precomputed range FFT window.
+ *
+ * First half of the symmetric Blackman window for 128 ADC samples in
+ * Q17, bit-identical to mathUtils_genWindow(). RangeProc_config()
+ * hands this table to the range DPU instead of generating the window at startup
+ * when CLI_NUM_ADC_SAMPLES matches (see RANGEPROC_WINDOW_TABLE_ENABLE). Only to
+ * be included by rangeproc_dpc.c.
+ *
+ * This file was auto-generated by the script 'chirp_config_to_defines.py' from the config file 'default.cfg' on 2026-10-18 17:16:43
+ */
+
+#include <stdint.h>
+
+/*! @brief Number of ADC samples the table was generated for */
+#define WINDOW_TABLE_NUM_ADC_SAMPLES 128
+
+/*! @brief Q format of the coefficients */
+#define WINDOW_TABLE_QFORMAT         17
+
+/*! @brief Number of coefficients */
+#define WINDOW_TABLE_LEN             64
+
+static const uint32_t gWindowTable[WINDOW_TABLE_LEN] = {
+    0x00000000U, 0x0000001DU, 0x00000074U, 0x00000106U, 0x000001D4U, 0x000002E2U, 0x00000430U, 0x000005C3U,
+    0x0000079DU, 0x000009C4U, 0x00000C3AU, 0x00000F06U, 0x0000122BU, 0x000015AFU, 0x00001996U, 0x00001DE6U,
+    0x000022A3U, 0x000027D2U, 0x00002D78U, 0x00003397U, 0x00003A35U, 0x00004153U, 0x000048F4U, 0x0000511BU,
+    0x000059C7U, 0x000062F8U, 0x00006CAFU, 0x000076EAU, 0x000081A5U, 0x00008CDDU, 0x0000988EU, 0x0000A4B2U,
+    0x0000B142U, 0x0000BE37U, 0x0000CB87U, 0x0000D92AU, 0x0000E715U, 0x0000F53BU, 0x00010392U, 0x0001120BU,
+    0x00012099U, 0x00012F2EU, 0x00013DBAU, 0x00014C2FU, 0x00015A7DU, 0x00016893U, 0x00017661U, 0x000183D8U,
+    0x000190E8U, 0x00019D80U, 0x0001A992U, 0x0001B50EU, 0x0001BFE5U, 0x0001CA0AU, 0x0001D370U, 0x0001DC0BU,
+    0x0001E3CFU, 0x0001EAB1U, 0x0001F0AAU, 0x0001F5B0U, 0x0001F9BDU, 0x0001FCCCU, 0x0001FED8U, 0x0001FFDFU
+};
+
+#endif /* WINDOW_TABLE_H */
@@ -29,6 +29,8 @@ SECTIONS
     .sysmem: {} palign(8) > M4F_RBL     /* This is where the malloc heap goes */
     .stack:  {} palign(8) > M4F_RBL     /* This is where the main() stack goes */
     .l3:     {} palign(8) > HWASS_SHM_MEM     /* This is where L3 data goes */
+    .fecss_shram: {} palign(8) > HWASS_SHM_MEM     /* Remaining 96KB of the shared memory, pooled as an additional region */
+    .retained: {} palign(8) > M4F_RAM3, type = NOINIT     /* Kept across resets without power loss (warm boot, see warm_start.h) */
 }
 
 MEMORY
@@ -0,0 +1,70 @@
+/**
+ * @file boot_report.c
+ * @brief Durations of the boot phases from freertos_main() to the first frame on the wire.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "boot_report.h"
+
+static const char *gBootReportPhaseNames[BOOT_PHASE_NUM] = {
+    "drivers", "mem init", "profile", "sensor init", "hwa open", "rf power", "open",
+    "config", "calibration", "pipeline", "start", "first frame", "first tx"
+};
+
+void BootReport_init(BootReport *report, uint32_t nowTicks) {
+    memset(report, 0, sizeof(BootReport));
+    report->payload.version    = BOOT_REPORT_VERSION;
+    report->payload.numPhases  = BOOT_PHASE_NUM;
+    report->payload.startTicks = nowTicks;
+    report->lastTicks          = nowTicks;
+}
+
+void BootReport_mark(BootReport *report, BootReport_Phase phase, uint32_t nowTicks) {
+    if ((uint32_t)phase >= BOOT_PHASE_NUM) {
+        return;
+    }
+    /* unsigned difference: correct across a wrap of the 32-bit timer */
+    report->payload.phaseTicks[phase] = nowTicks - report->lastTicks;
+    report->payload.phaseMask        |= (1U << phase);
+    report->lastTicks                 = nowTicks;
+}
+
+void BootReport_setBoot(BootReport *report, uint32_t warmStart, uint32_t numBoots) {
+    report->payload.flags    = (warmStart != 0U) ? BOOT_REPORT_FLAG_WARM : 0U;
+    report->payload.numBoots = numBoots;
+}
+
+int32_t BootReport_isComplete(const BootReport *report) {
+    return (report->payload.phaseMask == ((1U << BOOT_PHASE_NUM) - 1U)) ? 1 : 0;
+}
+
+uint32_t BootReport_sumTicks(const BootReport_Payload *payload, BootReport_Phase first, BootReport_Phase last) {
+    uint32_t ticks = 0;
+    uint32_t phase;
+
+    for (phase = (uint32_t)first; (phase <= (uint32_t)last) && (phase < payload->numPhases) &&
+                                  (phase < BOOT_PHASE_NUM); phase++) {
+        ticks += payload->phaseTicks[phase];
+    }
+    return ticks;
+}
+
+const char *BootReport_phaseName(BootReport_Phase phase) {
+    return ((uint32_t)phase < BOOT_PHASE_NUM) ? gBootReportPhaseNames[phase] : "?";
+}
+
+int32_t BootReport_decode(const void *data, uint32_t numBytes, BootReport_Payload *payload) {
+    if (numBytes < sizeof(BootReport_Payload)) {
+        return BOOT_REPORT_ERR_LENGTH;
+    }
+    memcpy(payload, data, sizeof(BootReport_Payload));
+    if (payload->version != BOOT_REPORT_VERSION) {
+        return BOOT_REPORT_ERR_VERSION;
+    }
+    if (payload->numPhases != BOOT_PHASE_NUM) {
+        return BOOT_REPORT_ERR_LENGTH;
+    }
+    return BOOT_REPORT_OK;
+}
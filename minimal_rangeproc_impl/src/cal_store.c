@@ -0,0 +1,106 @@
+/**
+ * @file cal_store.c
+ * @brief Factory calibration record in flash: restore, or generate and save.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config_cmd.h"
+#include "cal_store.h"
+
+
+/**
+ * @brief Checks whether the header has the fields of the versioned format, regardless of the CRC.
+ */
+static int32_t CalStore_isVersioned(const CalStore_Header *header, uint32_t dataBytes) {
+    return (((header->version == CAL_STORE_VERSION) && (header->headerBytes == sizeof(CalStore_Header))) ||
+            (header->dataBytes == dataBytes)) ? 1 : 0;
+}
+
+/**
+ * @brief Converts a record of the demo format (magic followed by the data) in place.
+ */
+static void CalStore_fromLegacy(void *record, uint32_t recordBytes, uint32_t magic) {
+    memmove((uint8_t *)record + sizeof(CalStore_Header), (const uint8_t *)record + CAL_STORE_LEGACY_HEADER_BYTES,
+            recordBytes - (uint32_t)sizeof(CalStore_Header));
+    CalStore_seal(record, recordBytes, magic);
+}
+
+int32_t CalStore_isValid(const void *record, uint32_t recordBytes, uint32_t magic) {
+    const CalStore_Header *header = (const CalStore_Header *)record;
+
+    if ((recordBytes < sizeof(CalStore_Header)) || (header->magic != magic) ||
+        (header->version != CAL_STORE_VERSION) || (header->headerBytes != sizeof(CalStore_Header)) ||
+        (header->dataBytes != recordBytes - (uint32_t)sizeof(CalStore_Header))) {
+        return 0;
+    }
+    return (ConfigCmd_crc32((const uint8_t *)record + sizeof(CalStore_Header),
+                            recordBytes - (uint32_t)sizeof(CalStore_Header)) == header->crc) ? 1 : 0;
+}
+
+void CalStore_seal(void *record, uint32_t recordBytes, uint32_t magic) {
+    CalStore_Header *header = (CalStore_Header *)record;
+
+    header->magic       = magic;
+    header->version     = CAL_STORE_VERSION;
+    header->headerBytes = (uint16_t)sizeof(CalStore_Header);
+    header->dataBytes   = recordBytes - (uint32_t)sizeof(CalStore_Header);
+    header->crc         = ConfigCmd_crc32((const uint8_t *)record + sizeof(CalStore_Header),
+                                          recordBytes - (uint32_t)sizeof(CalStore_Header));
+}
+
+int32_t CalStore_run(void *record, uint32_t recordBytes, uint32_t magic, uint32_t flags, const CalStore_Ops *ops) {
+    CalStore_Header *header = (CalStore_Header *)record;
+    int32_t legacy = 0;
+
+    if ((flags & CAL_STORE_FLAG_RETAINED) == 0U) {
+        if (ops->read(ops->arg, record, recordBytes) != 0) {
+            memset(record, 0, recordBytes);
+        }
+    }
+
+    /* the demo format has no CRC, the magic word is all it can be checked by */
+    if ((header->magic == magic) && (CalStore_isValid(record, recordBytes, magic) == 0) &&
+        (CalStore_isVersioned(header, recordBytes - (uint32_t)sizeof(CalStore_Header)) == 0)) {
+        CalStore_fromLegacy(record, recordBytes, magic);
+        legacy = 1;
+    }
+
+    if (CalStore_isValid(record, recordBytes, magic) != 0) {
+        if (ops->restore(ops->arg) == 0) {
+            return (legacy != 0) ? CAL_STORE_RESTORED_LEGACY : CAL_STORE_RESTORED;
+        }
+
+        /* the front end rejects a valid record: keep it in flash, calibrate into RAM only */
+        header->magic = 0U;
+        if ((flags & CAL_STORE_FLAG_GENERATE) == 0U) {
+            return CAL_STORE_ERR_RESTORE;
+        }
+        if (ops->calibrate(ops->arg) != 0) {
+            memset(record, 0, recordBytes);
+            return CAL_STORE_ERR_CALIB;
+        }
+        header->magic = 0U;
+        return CAL_STORE_CALIBRATED_RAM;
+    }
+    if ((flags & CAL_STORE_FLAG_GENERATE) == 0U) {
+        return CAL_STORE_ERR_NO_RECORD;
+    }
+
+    memset(record, 0, recordBytes);
+    if (ops->calibrate(ops->arg) != 0) {
+        memset(record, 0, recordBytes);
+        return CAL_STORE_ERR_CALIB;
+    }
+    CalStore_seal(record, recordBytes, magic);
+
+    /* read back: the record in RAM stays valid only if the flash holds it as well */
+    if ((ops->write(ops->arg, record, recordBytes) != 0) ||
+        (ops->read(ops->arg, record, recordBytes) != 0) ||
+        (CalStore_isValid(record, recordBytes, magic) == 0)) {
+        header->magic = 0U;
+        return CAL_STORE_ERR_SAVE;
+    }
+    return CAL_STORE_GENERATED;
+}
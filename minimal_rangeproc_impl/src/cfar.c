@@ -0,0 +1,233 @@
+/**
+ * @file cfar.c
+ * @brief CFAR detection on the range profile or the range-Doppler heatmap.
+ *
+ * The noise window is re-summed for every cell instead of being slid along
+ * range, which keeps CA, CAGO, CASO and OS in one code path. With the default
+ * 64 range bins and a few noise cells this is well below the cost of reading
+ * the heatmap once more.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "cfar.h"
+
+
+/**
+ * @brief Input of one detection run.
+ */
+typedef struct Cfar_Data_t
+{
+    /*! @brief Input values, range bin major */
+    const void *data;
+
+    /*! @brief Size of one value (2 or 4 bytes) */
+    uint32_t elemSize;
+
+    /*! @brief Number of range bins */
+    uint32_t numRangeBins;
+
+    /*! @brief Number of Doppler bins (1 for the range profile) */
+    uint32_t numDopplerBins;
+} Cfar_Data;
+
+static inline uint32_t Cfar_get(const Cfar_Data *in, uint32_t rangeIdx, uint32_t dopplerIdx) {
+    uint32_t idx = (rangeIdx * in->numDopplerBins) + dopplerIdx;
+
+    return (in->elemSize == sizeof(uint16_t)) ? ((const uint16_t *)in->data)[idx] :
+                                                ((const uint32_t *)in->data)[idx];
+}
+
+/**
+ * @brief Sums (or collects, for OS) the noise cells of one side.
+ *
+ * @return 1 if the side is complete, 0 otherwise
+ */
+static uint32_t Cfar_noiseSide(const Cfar_Config *cfg, const Cfar_Data *in, uint32_t rangeIdx,
+                               uint32_t dopplerIdx, int32_t dir, uint64_t *sum, uint32_t *cells) {
+    int32_t first = (int32_t)rangeIdx + (dir * ((int32_t)cfg->guardLen + 1));
+    int32_t last  = first + (dir * ((int32_t)cfg->noiseLen - 1));
+    uint32_t j;
+
+    if ((last < 0) || (last >= (int32_t)in->numRangeBins)) {
+        return 0;
+    }
+
+    *sum = 0;
+    for (j = 0; j < cfg->noiseLen; j++) {
+        uint32_t v = Cfar_get(in, (uint32_t)(first + (dir * (int32_t)j)), dopplerIdx);
+        *sum += v;
+        cells[j] = v;
+    }
+    return 1;
+}
+
+/**
+ * @brief Returns the k-th smallest (1 based) of n values, sorts the values.
+ */
+static uint32_t Cfar_select(uint32_t *v, uint32_t n, uint32_t k) {
+    uint32_t i, j;
+
+    for (i = 1; i < n; i++) {
+        uint32_t x = v[i];
+        for (j = i; (j > 0U) && (v[j - 1U] > x); j--) {
+            v[j] = v[j - 1U];
+        }
+        v[j] = x;
+    }
+    return v[k - 1U];
+}
+
+/**
+ * @brief Computes the noise estimate of a cell.
+ *
+ * @return 1 if a noise estimate is available, 0 otherwise
+ */
+static uint32_t Cfar_noise(const Cfar_Config *cfg, const Cfar_Data *in, uint32_t rangeIdx,
+                           uint32_t dopplerIdx, uint32_t *noise) {
+    uint32_t cells[2U * CFAR_MAX_NOISE_LEN];
+    uint64_t sumLeft = 0, sumRight = 0;
+    uint32_t leftOk, rightOk;
+    uint32_t n = cfg->noiseLen;
+
+    leftOk  = Cfar_noiseSide(cfg, in, rangeIdx, dopplerIdx, -1, &sumLeft, &cells[0]);
+    rightOk = Cfar_noiseSide(cfg, in, rangeIdx, dopplerIdx, 1, &sumRight, &cells[leftOk * n]);
+
+    if ((leftOk == 0U) && (rightOk == 0U)) {
+        return 0;
+    }
+
+    switch (cfg->mode) {
+        case CFAR_MODE_CAGO:
+        case CFAR_MODE_CASO:
+            if ((leftOk != 0U) && (rightOk != 0U)) {
+                uint64_t greater = (sumLeft > sumRight) ? sumLeft : sumRight;
+                uint64_t smaller = (sumLeft > sumRight) ? sumRight : sumLeft;
+                *noise = (uint32_t)(((cfg->mode == CFAR_MODE_CAGO) ? greater : smaller) / n);
+            } else {
+                *noise = (uint32_t)((sumLeft + sumRight) / n);
+            }
+            break;
+
+        case CFAR_MODE_OS:
+            if ((leftOk != 0U) && (rightOk != 0U)) {
+                *noise = Cfar_select(cells, 2U * n, cfg->osRank);
+            } else {
+                /* one side only: same relative rank */
+                *noise = Cfar_select(cells, n, (cfg->osRank + 1U) / 2U);
+            }
+            break;
+
+        case CFAR_MODE_CA:
+        default:
+            *noise = (uint32_t)((sumLeft + sumRight) / ((leftOk + rightOk) * n));
+            break;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Returns 1 if the cell is a local maximum along range and Doppler (cyclic).
+ */
+static uint32_t Cfar_isPeak(const Cfar_Data *in, uint32_t rangeIdx, uint32_t dopplerIdx, uint32_t value) {
+    uint32_t nD = in->numDopplerBins;
+
+    if ((rangeIdx > 0U) && (Cfar_get(in, rangeIdx - 1U, dopplerIdx) > value)) {
+        return 0;
+    }
+    if (((rangeIdx + 1U) < in->numRangeBins) && (Cfar_get(in, rangeIdx + 1U, dopplerIdx) >= value)) {
+        return 0;
+    }
+    if (nD > 1U) {
+        if (Cfar_get(in, rangeIdx, (dopplerIdx + nD - 1U) % nD) > value) {
+            return 0;
+        }
+        if (Cfar_get(in, rangeIdx, (dopplerIdx + 1U) % nD) >= value) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int32_t Cfar_detect(const Cfar_Config *cfg, const Cfar_Data *in, Cfar_Input input, void *list) {
+    Cfar_Header    *hdr = (Cfar_Header *)list;
+    Cfar_Detection *det = (Cfar_Detection *)(hdr + 1);
+    uint32_t rangeIdx, dopplerIdx;
+
+    if ((cfg->noiseLen == 0U) || (cfg->noiseLen > CFAR_MAX_NOISE_LEN) || (cfg->mode > CFAR_MODE_OS) ||
+        ((cfg->mode == CFAR_MODE_OS) && ((cfg->osRank == 0U) || (cfg->osRank > (2U * cfg->noiseLen))))) {
+        return -1;
+    }
+
+    memset(hdr, 0, sizeof(Cfar_Header));
+    hdr->mode  = cfg->mode;
+    hdr->input = (uint8_t)input;
+
+    for (rangeIdx = cfg->minRangeBin; rangeIdx < in->numRangeBins; rangeIdx++) {
+        for (dopplerIdx = 0; dopplerIdx < in->numDopplerBins; dopplerIdx++) {
+            uint32_t value = Cfar_get(in, rangeIdx, dopplerIdx);
+            uint32_t noise;
+            float    snrDb;
+
+            if ((Cfar_noise(cfg, in, rangeIdx, dopplerIdx, &noise) == 0U) ||
+                (((uint64_t)value << 8) <= ((uint64_t)cfg->thresholdQ8 * noise))) {
+                continue;
+            }
+            if ((cfg->peakGroupEn != 0U) && (Cfar_isPeak(in, rangeIdx, dopplerIdx, value) == 0U)) {
+                continue;
+            }
+            if (hdr->numDetections >= cfg->maxDetections) {
+                hdr->numDropped++;
+                continue;
+            }
+
+            snrDb = (noise > 0U) ? (10.0f * log10f((float)value / (float)noise)) : 127.0f;
+            snrDb = (snrDb > 127.0f) ? 127.0f : snrDb;
+
+            det->rangeIdx   = (uint16_t)rangeIdx;
+            det->dopplerIdx = (uint16_t)dopplerIdx;
+            det->snrDbQ8    = (int16_t)lrintf(snrDb * 256.0f);
+            det->level      = (uint16_t)((value > UINT16_MAX) ? UINT16_MAX : value);
+            det++;
+            hdr->numDetections++;
+        }
+    }
+
+    return (int32_t)hdr->numDetections;
+}
+
+uint32_t Cfar_getListSize(const Cfar_Config *cfg) {
+    return (uint32_t)sizeof(Cfar_Header) + ((uint32_t)cfg->maxDetections * sizeof(Cfar_Detection));
+}
+
+uint32_t Cfar_getUsedListSize(const void *list) {
+    return (uint32_t)sizeof(Cfar_Header) + ((uint32_t)((const Cfar_Header *)list)->numDetections * sizeof(Cfar_Detection));
+}
+
+int32_t Cfar_detectRangeProfile(const Cfar_Config *cfg, const uint32_t *profile, uint32_t numRangeBins,
+                                void *list) {
+    Cfar_Data in;
+
+    in.data           = profile;
+    in.elemSize       = sizeof(uint32_t);
+    in.numRangeBins   = numRangeBins;
+    in.numDopplerBins = 1;
+
+    return Cfar_detect(cfg, &in, CFAR_INPUT_RANGE_PROFILE, list);
+}
+
+int32_t Cfar_detectRdHeatmap(const Cfar_Config *cfg, const uint16_t *heatmap, uint32_t numRangeBins,
+                             uint32_t numDopplerBins, void *list) {
+    Cfar_Data in;
+
+    in.data           = heatmap;
+    in.elemSize       = sizeof(uint16_t);
+    in.numRangeBins   = numRangeBins;
+    in.numDopplerBins = numDopplerBins;
+
+    return Cfar_detect(cfg, &in, CFAR_INPUT_RD_HEATMAP, list);
+}
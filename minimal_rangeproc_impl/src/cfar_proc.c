@@ -0,0 +1,113 @@
+/**
+ * @file cfar_proc.c
+ * @brief CFAR detection stage producing a compact detection list per frame.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/SystemP.h>
+
+#include "system.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "range_profile.h"
+#include "rd_heatmap.h"
+#include "cfar.h"
+#include "doppler_proc.h"
+#include "cfar_proc.h"
+
+#if CFARPROC_ENABLE && CFARPROC_USE_RD_HEATMAP && !DOPPLERPROC_ENABLE
+#error "CFARPROC_USE_RD_HEATMAP requires DOPPLERPROC_ENABLE"
+#endif
+
+
+/**************************************************************************
+ ************************** Extern Definitions ****************************
+ **************************************************************************/
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
+
+#if !CFARPROC_USE_RD_HEATMAP
+/*! @brief 64-bit range profile sums in core local memory */
+static uint64_t *gCfarProfileAcc = NULL;
+
+/*! @brief Range profile used as detection input in core local memory */
+static uint32_t *gCfarProfile = NULL;
+#endif
+
+
+int32_t CfarProc_config(void) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    Cfar_Config *cfg = &gSysContext.cfarCfg;
+
+    memset(cfg, 0, sizeof(Cfar_Config));
+    cfg->mode          = CFARPROC_MODE;
+    cfg->guardLen      = CFARPROC_GUARD_LEN;
+    cfg->noiseLen      = CFARPROC_NOISE_LEN;
+    cfg->osRank        = CFARPROC_OS_RANK;
+    cfg->thresholdQ8   = CFARPROC_THRESHOLD_Q8;
+    cfg->minRangeBin   = CFARPROC_MIN_RANGE_BIN;
+    cfg->peakGroupEn   = CFARPROC_PEAK_GROUP_EN;
+    cfg->maxDetections = CFARPROC_MAX_DETECTIONS;
+
+    gSysContext.cfarDetList = MemRegion_alloc(&gSysContext.memRegions,
+                                              Cfar_getListSize(cfg),
+                                              sizeof(uint32_t),
+                                              MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                              MEM_REGION_POLICY_LARGEST_FREE,
+                                              "cfar",
+                                              NULL);
+    if (gSysContext.cfarDetList == NULL) {
+        DebugP_log("Error: not enough shared memory for the CFAR detection list\r\n");
+        return SystemP_FAILURE;
+    }
+
+#if !CFARPROC_USE_RD_HEATMAP
+    gCfarProfileAcc = (uint64_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                params->numRangeBins * sizeof(uint64_t),
+                                                                sizeof(uint64_t),
+                                                                "cfar");
+    gCfarProfile    = (uint32_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                params->numRangeBins * sizeof(uint32_t),
+                                                                sizeof(uint32_t),
+                                                                "cfar");
+    if ((gCfarProfileAcc == NULL) || (gCfarProfile == NULL)) {
+        DebugP_log("Error: not enough core local memory for the CFAR range profile\r\n");
+        return SystemP_FAILURE;
+    }
+#endif
+
+    (void)params;
+    return SystemP_SUCCESS;
+}
+
+int32_t CfarProc_process(void) {
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    int32_t numDetections;
+
+#if !CFARPROC_USE_RD_HEATMAP
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+
+    RangeProfile_compute((const int16_t *)gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                         params->numRangeBins,
+                         (uint32_t)params->numVirtualAntennas * params->numDopplerChirpsPerFrame,
+                         gCfarProfileAcc, gCfarProfile);
+    numDetections = Cfar_detectRangeProfile(&gSysContext.cfarCfg, gCfarProfile, params->numRangeBins,
+                                            gSysContext.cfarDetList);
+#else
+    numDetections = Cfar_detectRdHeatmap(&gSysContext.cfarCfg, gSysContext.rdHeatmap,
+                                         gSysContext.rdHeatmapCfg.numRangeBins,
+                                         gSysContext.rdHeatmapCfg.fftSize,
+                                         gSysContext.cfarDetList);
+#endif
+
+    if (numDetections < 0) {
+        DebugP_log("Error: invalid CFAR configuration\r\n");
+        return SystemP_FAILURE;
+    }
+
+    // benchmark: duration of the detection including its input reduction (40 MHz ticks)
+    ((Cfar_Header *)gSysContext.cfarDetList)->computeTicks = Cycleprofiler_getTimeStamp() - startTicks;
+
+    return SystemP_SUCCESS;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file chirp_accum.c
+ * @brief Radar cube dimensions and range FFT scaling with front-end chirp accumulation.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "cube_budget.h"
+#include "chirp_accum.h"
+
+
+uint32_t ChirpAccum_getFactor(uint32_t numChirpsAccum) {
+    return (numChirpsAccum > 1U) ? numChirpsAccum : 1U;
+}
+
+int32_t ChirpAccum_compute(const ChirpAccum_Config *cfg, ChirpAccum_Dims *dims) {
+    uint32_t factor = ChirpAccum_getFactor(cfg->numChirpsAccum);
+    uint32_t chirpsPerBurst;
+
+    memset(dims, 0, sizeof(ChirpAccum_Dims));
+
+    if ((cfg->numTxAntennas == 0U) || ((cfg->numChirpsPerBurst % factor) != 0U)) {
+        return -1;
+    }
+    chirpsPerBurst = cfg->numChirpsPerBurst / factor;
+    if ((chirpsPerBurst == 0U) || ((chirpsPerBurst % cfg->numTxAntennas) != 0U)) {
+        return -1;
+    }
+
+    dims->accumFactor              = factor;
+    dims->numChirpsPerFrame        = chirpsPerBurst * cfg->numBurstsPerFrame;
+    dims->numDopplerChirpsPerFrame = dims->numChirpsPerFrame / cfg->numTxAntennas;
+    dims->cubeBytes                = CubeBudget_getCubeSize(cfg->numRangeBins, cfg->numVirtualAntennas,
+                                                            dims->numDopplerChirpsPerFrame);
+    while ((1UL << dims->extraShift) < factor) {
+        dims->extraShift++;
+    }
+    dims->snrGainDb = 10.0f * log10f((float)factor);
+
+    return 0;
+}
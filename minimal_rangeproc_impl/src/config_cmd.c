@@ -0,0 +1,366 @@
+/**
+ * @file config_cmd.c
+ * @brief Runtime reconfiguration of the chirp profile via SPI command records.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "chirp_accum.h"
+#include "cube_budget.h"
+#include "config_cmd.h"
+
+/*! @brief Largest time (10 ns units) and ADC skip count of the 16-bit front-end fields */
+#define CONFIG_CMD_MAX_TIME_10NS        65535.0f
+#define CONFIG_CMD_MAX_ADC_SKIP         63U
+
+/*! @brief Largest slope magnitude in MHz/us that fits xh_ChirpRfFreqSlope */
+#define CONFIG_CMD_MAX_SLOPE            937.0f
+
+/*! @brief Largest frame period in ms that fits w_FramePeriodicity (40 MHz ticks) */
+#define CONFIG_CMD_MAX_FRAME_PERIOD_MS  107374.0f
+
+
+uint32_t ConfigCmd_crc32(const void *data, uint32_t numBytes) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t crc = 0xFFFFFFFFU;
+    uint32_t i;
+    uint32_t bit;
+
+    for (i = 0; i < numBytes; i++) {
+        crc ^= bytes[i];
+        for (bit = 0; bit < 8U; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+/**
+ * @brief CRC-32 of words serialized little endian (their memory order on the device).
+ */
+static uint32_t ConfigCmd_crcWords(const uint32_t *words, uint32_t numWords) {
+    uint8_t bytes[CONFIG_CMD_PROFILE_WORDS * sizeof(uint32_t)];
+    uint32_t i;
+
+    for (i = 0; i < numWords; i++) {
+        bytes[4U * i]      = (uint8_t)(words[i]);
+        bytes[4U * i + 1U] = (uint8_t)(words[i] >> 8);
+        bytes[4U * i + 2U] = (uint8_t)(words[i] >> 16);
+        bytes[4U * i + 3U] = (uint8_t)(words[i] >> 24);
+    }
+    return ConfigCmd_crc32(bytes, numWords * sizeof(uint32_t));
+}
+
+static uint32_t ConfigCmd_floatBits(float value) {
+    uint32_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float ConfigCmd_bitsFloat(uint32_t bits) {
+    float value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Serializes a profile into payload words, in the field order of ConfigCmd_Profile.
+ */
+static void ConfigCmd_packProfile(const ConfigCmd_Profile *profile, uint32_t *words) {
+    uint32_t n = 0;
+
+    words[n++] = profile->channelCfg.rxChCtrlBitMask;
+    words[n++] = profile->channelCfg.txChCtrlBitMask;
+    words[n++] = profile->channelCfg.miscCtrl;
+
+    words[n++] = profile->chirpComnCfg.digOutputSampRate;
+    words[n++] = profile->chirpComnCfg.digOutputBitsSel;
+    words[n++] = profile->chirpComnCfg.dfeFirSel;
+    words[n++] = profile->chirpComnCfg.numOfAdcSamples;
+    words[n++] = profile->chirpComnCfg.chirpTxMimoPatSel;
+    words[n++] = ConfigCmd_floatBits(profile->chirpComnCfg.chirpRampEndTime);
+    words[n++] = profile->chirpComnCfg.chirpRxHpfSel;
+
+    words[n++] = ConfigCmd_floatBits(profile->chirpTimingCfg.chirpIdleTime);
+    words[n++] = profile->chirpTimingCfg.chirpAdcSkipSamples;
+    words[n++] = ConfigCmd_floatBits(profile->chirpTimingCfg.chirpTxStartTime);
+    words[n++] = ConfigCmd_floatBits(profile->chirpTimingCfg.chirpRfFreqSlope);
+    words[n++] = ConfigCmd_floatBits(profile->chirpTimingCfg.chirpRfFreqStart);
+
+    words[n++] = profile->frameCfg.numOfChirpsInBurst;
+    words[n++] = profile->frameCfg.numOfChirpsAccum;
+    words[n++] = ConfigCmd_floatBits(profile->frameCfg.burstPeriodicity);
+    words[n++] = profile->frameCfg.numOfBurstsInFrame;
+    words[n++] = ConfigCmd_floatBits(profile->frameCfg.framePeriodicity);
+    words[n++] = profile->frameCfg.numOfFrames;
+}
+
+static void ConfigCmd_unpackProfile(const uint32_t *words, ConfigCmd_Profile *profile) {
+    uint32_t n = 0;
+
+    profile->channelCfg.rxChCtrlBitMask = words[n++];
+    profile->channelCfg.txChCtrlBitMask = words[n++];
+    profile->channelCfg.miscCtrl        = words[n++];
+
+    profile->chirpComnCfg.digOutputSampRate = words[n++];
+    profile->chirpComnCfg.digOutputBitsSel  = words[n++];
+    profile->chirpComnCfg.dfeFirSel         = words[n++];
+    profile->chirpComnCfg.numOfAdcSamples   = words[n++];
+    profile->chirpComnCfg.chirpTxMimoPatSel = words[n++];
+    profile->chirpComnCfg.chirpRampEndTime  = ConfigCmd_bitsFloat(words[n++]);
+    profile->chirpComnCfg.chirpRxHpfSel     = words[n++];
+
+    profile->chirpTimingCfg.chirpIdleTime       = ConfigCmd_bitsFloat(words[n++]);
+    profile->chirpTimingCfg.chirpAdcSkipSamples = words[n++];
+    profile->chirpTimingCfg.chirpTxStartTime    = ConfigCmd_bitsFloat(words[n++]);
+    profile->chirpTimingCfg.chirpRfFreqSlope    = ConfigCmd_bitsFloat(words[n++]);
+    profile->chirpTimingCfg.chirpRfFreqStart    = ConfigCmd_bitsFloat(words[n++]);
+
+    profile->frameCfg.numOfChirpsInBurst = words[n++];
+    profile->frameCfg.numOfChirpsAccum   = words[n++];
+    profile->frameCfg.burstPeriodicity   = ConfigCmd_bitsFloat(words[n++]);
+    profile->frameCfg.numOfBurstsInFrame = words[n++];
+    profile->frameCfg.framePeriodicity   = ConfigCmd_bitsFloat(words[n++]);
+    profile->frameCfg.numOfFrames        = words[n++];
+}
+
+/**
+ * @brief CRC of the payload words of a profile.
+ */
+static uint32_t ConfigCmd_profileCrc(const ConfigCmd_Profile *profile) {
+    uint32_t payload[CONFIG_CMD_PROFILE_WORDS];
+
+    memset(payload, 0, sizeof(payload));
+    ConfigCmd_packProfile(profile, payload);
+    return ConfigCmd_crcWords(payload, CONFIG_CMD_PROFILE_WORDS);
+}
+
+uint32_t ConfigCmd_encode(const ConfigCmd_Profile *profile, uint32_t sequence, uint32_t *words) {
+    uint32_t *payload = &words[CONFIG_CMD_HEADER_WORDS];
+
+    memset(payload, 0, CONFIG_CMD_PROFILE_WORDS * sizeof(uint32_t));
+    ConfigCmd_packProfile(profile, payload);
+
+    words[0] = CONFIG_CMD_MAGIC;
+    words[1] = (CONFIG_CMD_VERSION << 16) | CONFIG_CMD_TYPE_PROFILE;
+    words[2] = ((CONFIG_CMD_PROFILE_WORDS * (uint32_t)sizeof(uint32_t)) << 16) | (sequence & 0xFFFFU);
+    words[3] = ConfigCmd_crcWords(payload, CONFIG_CMD_PROFILE_WORDS);
+    return CONFIG_CMD_RECORD_WORDS;
+}
+
+int32_t ConfigCmd_decode(const uint32_t *words, uint32_t numWords,
+                         ConfigCmd_Profile *profile, uint32_t *sequence) {
+    const uint32_t *payload = &words[CONFIG_CMD_HEADER_WORDS];
+
+    if ((numWords < CONFIG_CMD_HEADER_WORDS) || (words[0] != CONFIG_CMD_MAGIC)) {
+        return CONFIG_CMD_ERR_NO_RECORD;
+    }
+    *sequence = words[2] & 0xFFFFU;
+    if ((words[1] >> 16) != CONFIG_CMD_VERSION) {
+        return CONFIG_CMD_ERR_VERSION;
+    }
+    if (((words[1] & 0xFFFFU) != CONFIG_CMD_TYPE_PROFILE) ||
+        ((words[2] >> 16) != CONFIG_CMD_PROFILE_WORDS * sizeof(uint32_t)) ||
+        (numWords < CONFIG_CMD_RECORD_WORDS)) {
+        return CONFIG_CMD_ERR_LENGTH;
+    }
+    if (ConfigCmd_crcWords(payload, CONFIG_CMD_PROFILE_WORDS) != words[3]) {
+        return CONFIG_CMD_ERR_CRC;
+    }
+    ConfigCmd_unpackProfile(payload, profile);
+    return CONFIG_CMD_OK;
+}
+
+/**
+ * @brief Returns whether value is a number in (0, max] (false for NaN).
+ */
+static int32_t ConfigCmd_inRange(float value, float max) {
+    return ((value > 0.0f) && (value <= max)) ? 1 : 0;
+}
+
+static uint32_t ConfigCmd_getNumRangeBins(uint32_t numAdcSamples) {
+    uint32_t fftSize = 1U;
+
+    while (fftSize < numAdcSamples) {
+        fftSize <<= 1;
+    }
+    return fftSize / 2U;
+}
+
+static uint32_t ConfigCmd_countBits(uint32_t mask) {
+    uint32_t count = 0;
+
+    while (mask != 0U) {
+        count += mask & 1U;
+        mask >>= 1;
+    }
+    return count;
+}
+
+int32_t ConfigCmd_validate(const ConfigCmd_Profile *profile, const ConfigCmd_Profile *active,
+                           const ConfigCmd_Limits *limits) {
+    const ConfigCmd_ChirpComnCfg *comn = &profile->chirpComnCfg;
+    const ConfigCmd_ChirpTimingCfg *timing = &profile->chirpTimingCfg;
+    const ConfigCmd_FrameCfg *frame = &profile->frameCfg;
+    ChirpAccum_Config accumCfg;
+    ChirpAccum_Dims accumDims;
+    CubeBudget_Config budgetCfg;
+    CubeBudget_Report budget;
+    uint32_t numTx = ConfigCmd_countBits(profile->channelCfg.txChCtrlBitMask);
+    uint32_t numRx = ConfigCmd_countBits(profile->channelCfg.rxChCtrlBitMask);
+
+    if (memcmp(&profile->channelCfg, &active->channelCfg, sizeof(ConfigCmd_ChannelCfg)) != 0) {
+        return CONFIG_CMD_ERR_CHANNEL;
+    }
+
+    /* front-end fields (see ConfigCmd_toSensorParams()) */
+    if ((comn->digOutputSampRate == 0U) ||
+        (comn->numOfAdcSamples == 0U) || (comn->numOfAdcSamples > limits->maxAdcSamples) ||
+        ((comn->chirpTxMimoPatSel != 0U) && (comn->chirpTxMimoPatSel != 1U) && (comn->chirpTxMimoPatSel != 4U)) ||
+        (ConfigCmd_inRange(comn->chirpRampEndTime, CONFIG_CMD_MAX_TIME_10NS / 10.0f) == 0) ||
+        (ConfigCmd_inRange(timing->chirpIdleTime, CONFIG_CMD_MAX_TIME_10NS / 10.0f) == 0) ||
+        (timing->chirpAdcSkipSamples > CONFIG_CMD_MAX_ADC_SKIP) ||
+        !(fabsf(timing->chirpTxStartTime) <= 32767.0f / 50.0f) ||
+        (ConfigCmd_inRange(fabsf(timing->chirpRfFreqSlope), CONFIG_CMD_MAX_SLOPE) == 0) ||
+        (ConfigCmd_inRange(timing->chirpRfFreqStart, 1000.0f) == 0)) {
+        return CONFIG_CMD_ERR_INVALID;
+    }
+
+    /* the bursts must fit into the frame period */
+    if ((frame->numOfChirpsInBurst == 0U) || (frame->numOfBurstsInFrame == 0U) ||
+        (ConfigCmd_inRange(frame->framePeriodicity, CONFIG_CMD_MAX_FRAME_PERIOD_MS) == 0) ||
+        (ConfigCmd_inRange(frame->burstPeriodicity, frame->framePeriodicity * 1000.0f) == 0) ||
+        ((float)frame->numOfBurstsInFrame * frame->burstPeriodicity > frame->framePeriodicity * 1000.0f)) {
+        return CONFIG_CMD_ERR_INVALID;
+    }
+
+    accumCfg.numChirpsPerBurst  = frame->numOfChirpsInBurst;
+    accumCfg.numBurstsPerFrame  = frame->numOfBurstsInFrame;
+    accumCfg.numChirpsAccum     = frame->numOfChirpsAccum;
+    accumCfg.numTxAntennas      = numTx;
+    accumCfg.numVirtualAntennas = numTx * numRx;
+    accumCfg.numRangeBins       = ConfigCmd_getNumRangeBins(comn->numOfAdcSamples);
+    if (ChirpAccum_compute(&accumCfg, &accumDims) != 0) {
+        return CONFIG_CMD_ERR_INVALID;
+    }
+
+    budgetCfg.numRangeBins       = accumCfg.numRangeBins;
+    budgetCfg.numVirtualAntennas = accumCfg.numVirtualAntennas;
+    budgetCfg.numMajorChirps     = accumDims.numDopplerChirpsPerFrame;
+    budgetCfg.numMinorChirps     = limits->numMinorChirps;
+    budgetCfg.freeBytes          = limits->freeBytes;
+    budgetCfg.reserveBytes       = limits->reserveBytes;
+    if (CubeBudget_check(&budgetCfg, &budget) != 0) {
+        return CONFIG_CMD_ERR_BUDGET;
+    }
+    return CONFIG_CMD_OK;
+}
+
+void ConfigCmd_toSensorParams(const ConfigCmd_Profile *profile, ConfigCmd_SensorParams *params) {
+    const ConfigCmd_ChirpTimingCfg *timing = &profile->chirpTimingCfg;
+
+    /* times are exact in their units and rounded, the derived values are
+       truncated as their CLI_* expressions in defines.h */
+    params->rampEndTime  = (uint16_t)lroundf(10.0f * profile->chirpComnCfg.chirpRampEndTime);
+    params->idleTime     = (uint16_t)lroundf(10.0f * timing->chirpIdleTime);
+    params->adcStartTime = (uint16_t)(timing->chirpAdcSkipSamples << 10);
+    params->txStartTime  = (int16_t)lroundf(50.0f * timing->chirpTxStartTime);
+    params->freqSlope    = (int16_t)(((double)timing->chirpRfFreqSlope * 1048576.0) / (3 * 100 * 100));
+    params->freqStart    = (uint32_t)(((double)timing->chirpRfFreqStart * 1000.0 * 256.0) / 300);
+    params->burstPeriod  = (uint32_t)lroundf(10.0f * profile->frameCfg.burstPeriodicity);
+    params->framePeriod  = (uint32_t)(((double)profile->frameCfg.framePeriodicity * 40000000.0) / 1000.0);
+    params->numRangeBins = ConfigCmd_getNumRangeBins(profile->chirpComnCfg.numOfAdcSamples);
+}
+
+void ConfigCmd_init(ConfigCmd_Ctrl *ctrl, const ConfigCmd_Profile *active, const ConfigCmd_Limits *limits) {
+    memset(ctrl, 0, sizeof(ConfigCmd_Ctrl));
+    ctrl->state      = CONFIG_CMD_STATE_RUNNING;
+    ctrl->active     = *active;
+    ctrl->limits     = *limits;
+    ctrl->lastResult = CONFIG_CMD_OK;
+}
+
+int32_t ConfigCmd_receive(ConfigCmd_Ctrl *ctrl, const uint32_t *words, uint32_t numWords) {
+    ConfigCmd_Profile profile;
+    uint32_t sequence = 0;
+    int32_t result;
+
+    result = ConfigCmd_decode(words, numWords, &profile, &sequence);
+    if (result == CONFIG_CMD_ERR_NO_RECORD) {
+        return result;
+    }
+    if (result == CONFIG_CMD_OK) {
+        if (ctrl->state != CONFIG_CMD_STATE_RUNNING) {
+            result = CONFIG_CMD_ERR_BUSY;
+        } else {
+            result = ConfigCmd_validate(&profile, &ctrl->active, &ctrl->limits);
+        }
+    }
+
+    ctrl->lastSequence = sequence;
+    ctrl->lastResult   = result;
+    if (result == CONFIG_CMD_OK) {
+        ctrl->pending = profile;
+        ctrl->state   = CONFIG_CMD_STATE_PENDING;
+    } else {
+        ctrl->numRejected++;
+    }
+    return result;
+}
+
+int32_t ConfigCmd_service(ConfigCmd_Ctrl *ctrl, const ConfigCmd_Ops *ops) {
+    if (ctrl->state != CONFIG_CMD_STATE_PENDING) {
+        return 0;
+    }
+
+    ctrl->state = CONFIG_CMD_STATE_STOPPING;
+    if (ops->stopSensor(ops->arg) != 0) {
+        /* nothing was changed, the sensor keeps running with the active profile */
+        ctrl->state      = CONFIG_CMD_STATE_RUNNING;
+        ctrl->lastResult = CONFIG_CMD_ERR_APPLY;
+        ctrl->numRejected++;
+        return 0;
+    }
+
+    ctrl->state = CONFIG_CMD_STATE_RECONFIGURING;
+    if (ops->applyProfile(ops->arg, &ctrl->pending) == 0) {
+        ctrl->active     = ctrl->pending;
+        ctrl->lastResult = CONFIG_CMD_OK;
+        ctrl->numApplied++;
+    } else {
+        /* the previous profile was applied before, so it is the known good fallback */
+        ctrl->state      = CONFIG_CMD_STATE_ROLLBACK;
+        ctrl->lastResult = CONFIG_CMD_ERR_APPLY;
+        ctrl->numRejected++;
+        if (ops->applyProfile(ops->arg, &ctrl->active) != 0) {
+            ctrl->state      = CONFIG_CMD_STATE_FAILED;
+            ctrl->lastResult = CONFIG_CMD_ERR_FAILED;
+            return -1;
+        }
+    }
+
+    ctrl->state = CONFIG_CMD_STATE_RESTARTING;
+    if (ops->startSensor(ops->arg) != 0) {
+        ctrl->state      = CONFIG_CMD_STATE_FAILED;
+        ctrl->lastResult = CONFIG_CMD_ERR_FAILED;
+        return -1;
+    }
+    ctrl->state = CONFIG_CMD_STATE_RUNNING;
+    return 1;
+}
+
+uint32_t ConfigCmd_encodeStatus(const ConfigCmd_Ctrl *ctrl, uint32_t *words) {
+    words[0] = CONFIG_CMD_STATUS_MAGIC;
+    words[1] = (CONFIG_CMD_VERSION << 16) | (ctrl->state & 0xFFFFU);
+    words[2] = ((ctrl->lastSequence & 0xFFFFU) << 16) | ((uint32_t)ctrl->lastResult & 0xFFFFU);
+    words[3] = ConfigCmd_profileCrc(&ctrl->active);
+    words[4] = ctrl->numApplied;
+    words[5] = ctrl->numRejected;
+    words[6] = 0U;
+    words[7] = ConfigCmd_crcWords(words, CONFIG_CMD_STATUS_WORDS - 1U);
+    return CONFIG_CMD_STATUS_WORDS;
+}
@@ -0,0 +1,48 @@
+/**
+ * @file cube_budget.c
+ * @brief Memory accounting of the major and minor motion radar cubes.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cube_budget.h"
+
+/*! @brief Size of one cube sample (cmplx16) */
+#define CUBE_BUDGET_SAMPLE_SIZE     (4U)
+
+
+uint32_t CubeBudget_getCubeSize(uint32_t numRangeBins, uint32_t numVirtualAntennas, uint32_t numChirps) {
+    uint64_t size = (uint64_t)numRangeBins * numVirtualAntennas * numChirps * CUBE_BUDGET_SAMPLE_SIZE;
+
+    return (size > UINT32_MAX) ? 0U : (uint32_t)size;
+}
+
+int32_t CubeBudget_check(const CubeBudget_Config *cfg, CubeBudget_Report *report) {
+    uint64_t total;
+    int64_t  headroom;
+
+    memset(report, 0, sizeof(CubeBudget_Report));
+
+    // the minor motion chirps are a subset of the chirps of the frame
+    if (cfg->numMinorChirps > cfg->numMajorChirps) {
+        return -1;
+    }
+
+    report->majorBytes = CubeBudget_getCubeSize(cfg->numRangeBins, cfg->numVirtualAntennas, cfg->numMajorChirps);
+    report->minorBytes = CubeBudget_getCubeSize(cfg->numRangeBins, cfg->numVirtualAntennas, cfg->numMinorChirps);
+    if (((report->majorBytes == 0U) && (cfg->numMajorChirps != 0U)) ||
+        ((report->minorBytes == 0U) && (cfg->numMinorChirps != 0U))) {
+        report->headroomBytes = INT32_MIN;
+        return -1;
+    }
+
+    /* the pool is 4 byte aligned and the cube sizes are multiples of 4, so there is no padding */
+    total = (uint64_t)report->majorBytes + report->minorBytes;
+    report->totalBytes = (total > UINT32_MAX) ? UINT32_MAX : (uint32_t)total;
+
+    headroom = (int64_t)cfg->freeBytes - (int64_t)total - (int64_t)cfg->reserveBytes;
+    report->headroomBytes = (headroom < INT32_MIN) ? INT32_MIN : (int32_t)headroom;
+
+    return (headroom >= 0) ? 0 : -1;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file cube_layout.c
+ * @brief Conversion of the radar cube between DPIF_RADARCUBE_FORMAT_6 and host-friendly layouts.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cube_layout.h"
+
+
+/**
+ * @brief Strides (in samples) of the chirp, antenna and range bin dimensions of a layout.
+ *
+ * @return 0 on success, -1 on an unknown order
+ */
+static int32_t CubeLayout_getStrides(const CubeLayout_Config *cfg,
+                                     uint32_t *chirpStride, uint32_t *antStride, uint32_t *binStride) {
+    switch (cfg->order) {
+        case CUBE_LAYOUT_CHIRP_MAJOR:
+            *chirpStride = cfg->numVirtualAntennas * cfg->numRangeBins;
+            *antStride   = cfg->numRangeBins;
+            *binStride   = 1U;
+            break;
+        case CUBE_LAYOUT_RANGE_MAJOR:
+            *chirpStride = 1U;
+            *antStride   = cfg->numChirps;
+            *binStride   = cfg->numVirtualAntennas * cfg->numChirps;
+            break;
+        case CUBE_LAYOUT_ANTENNA_MAJOR:
+            *chirpStride = cfg->numRangeBins;
+            *antStride   = cfg->numChirps * cfg->numRangeBins;
+            *binStride   = 1U;
+            break;
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Walks the native cube in memory order and copies every sample to or
+ *        from its position in the configured layout.
+ */
+static int32_t CubeLayout_convert(const CubeLayout_Config *cfg, const int16_t *src, int16_t *dst,
+                                  uint32_t toNative) {
+    uint32_t numSamples = cfg->numChirps * cfg->numVirtualAntennas * cfg->numRangeBins;
+    uint32_t chirpStride, antStride, binStride;
+    uint32_t chirp, ant, bin;
+    uint32_t native = 0;
+
+    if (CubeLayout_getStrides(cfg, &chirpStride, &antStride, &binStride) != 0) {
+        return -1;
+    }
+    if (CubeLayout_isConverted(cfg) == 0U) {
+        memcpy(dst, src, numSamples * 2U * sizeof(int16_t));
+        return 0;
+    }
+
+    for (chirp = 0; chirp < cfg->numChirps; chirp++) {
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            uint32_t idx = (chirp * chirpStride) + (ant * antStride);
+
+            for (bin = 0; bin < cfg->numRangeBins; bin++, native++, idx += binStride) {
+                if (cfg->iqSplit != 0U) {
+                    // real plane first, imaginary plane second
+                    if (toNative != 0U) {
+                        dst[(2U * native) + 1U] = src[idx];
+                        dst[2U * native]        = src[numSamples + idx];
+                    } else {
+                        dst[idx]              = src[(2U * native) + 1U];
+                        dst[numSamples + idx] = src[2U * native];
+                    }
+                } else {
+                    if (toNative != 0U) {
+                        dst[2U * native]        = src[2U * idx];
+                        dst[(2U * native) + 1U] = src[(2U * idx) + 1U];
+                    } else {
+                        dst[2U * idx]        = src[2U * native];
+                        dst[(2U * idx) + 1U] = src[(2U * native) + 1U];
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+uint32_t CubeLayout_isConverted(const CubeLayout_Config *cfg) {
+    return ((cfg->order != CUBE_LAYOUT_CHIRP_MAJOR) || (cfg->iqSplit != 0U)) ? 1U : 0U;
+}
+
+int32_t CubeLayout_fromNative(const CubeLayout_Config *cfg, const int16_t *src, int16_t *dst) {
+    return CubeLayout_convert(cfg, src, dst, 0U);
+}
+
+int32_t CubeLayout_toNative(const CubeLayout_Config *cfg, const int16_t *src, int16_t *dst) {
+    return CubeLayout_convert(cfg, src, dst, 1U);
+}
@@ -0,0 +1,245 @@
+/**
+ * @file cube_quant.c
+ * @brief Int8 quantisation and dequantisation of the radar cube.
+ *
+ * The quantiser works in two passes over the cube: the first one determines the
+ * peak magnitude per scale group (frame or range bin), the second one scales,
+ * optionally dithers, rounds and clips the samples while accumulating the
+ * signal and error energy for the SQNR.
+ *
+ * Divisions are avoided in the inner loops by multiplying with the reciprocal
+ * of the scale factor, computed once per scale for a block of range bins at a
+ * time. The energies are summed in double, a float sum over a large cube loses
+ * the small error terms.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "cube_quant.h"
+
+/*! @brief Range bins whose step reciprocals are held on the stack in the quantisation pass */
+#define CUBE_QUANT_BLOCK_BINS   (64U)
+
+/**
+ * @brief Returns the next value of a xorshift32 generator as a float in [-0.5, 0.5).
+ */
+static inline float CubeQuant_nextDither(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    // use the upper 24 bits, which are exactly representable as float
+    return ((float)(x >> 8) * (1.0f / 16777216.0f)) - 0.5f;
+}
+
+/**
+ * @brief Rounds to the nearest integer and clips to the symmetric int8 range.
+ */
+static inline int8_t CubeQuant_roundClip(float v) {
+    int32_t q = (int32_t)(v + ((v >= 0.0f) ? 0.5f : -0.5f));
+
+    if (q > CUBE_QUANT_MAX_CODE) {
+        q = CUBE_QUANT_MAX_CODE;
+    } else if (q < -CUBE_QUANT_MAX_CODE) {
+        q = -CUBE_QUANT_MAX_CODE;
+    }
+    return (int8_t)q;
+}
+
+/**
+ * @brief Returns the absolute value of a sample without overflowing on INT16_MIN.
+ */
+static inline uint32_t CubeQuant_abs(int16_t v) {
+    return (v < 0) ? (uint32_t)(-(int32_t)v) : (uint32_t)v;
+}
+
+uint32_t CubeQuant_getNumScales(const CubeQuant_Config *cfg) {
+    if (cfg->granularity == CUBE_QUANT_GRANULARITY_PER_RANGE_BIN) {
+        return cfg->numRangeBins;
+    }
+    return 1U;
+}
+
+uint32_t CubeQuant_getPayloadSize(const CubeQuant_Config *cfg) {
+    uint32_t numSamples = 2U * (uint32_t)cfg->numRangeBins * cfg->numRows;
+
+    return (uint32_t)sizeof(CubeQuant_Header)
+         + CubeQuant_getNumScales(cfg) * (uint32_t)sizeof(float)
+         + ((numSamples + 3U) & ~3U);
+}
+
+int32_t CubeQuant_quantize(const CubeQuant_Config *cfg,
+                           const int16_t *cube,
+                           void *payload,
+                           uint32_t *ditherState) {
+    CubeQuant_Header *hdr;
+    float            *scales;
+    int8_t           *out;
+    uint32_t          numScales;
+    uint32_t          numBins;
+    uint32_t          row, bin, i;
+    double            sigEnergy = 0.0;
+    double            errEnergy = 0.0;
+
+    if ((cfg == NULL) || (cube == NULL) || (payload == NULL) ||
+        (cfg->numRangeBins == 0U) || (cfg->numRows == 0U) ||
+        ((cfg->ditherEnable != 0U) && ((ditherState == NULL) || (*ditherState == 0U)))) {
+        return -1;
+    }
+
+    numBins   = cfg->numRangeBins;
+    numScales = CubeQuant_getNumScales(cfg);
+    hdr       = (CubeQuant_Header *)payload;
+    scales    = (float *)(hdr + 1);
+    out       = (int8_t *)(scales + numScales);
+
+    /* pass 1: peak magnitude per scale group, collected in the scales array */
+    for (i = 0; i < numScales; i++) {
+        scales[i] = 0.0f;
+    }
+
+    if (numScales == 1U) {
+        uint32_t peak = 0;
+        uint32_t numValues = 2U * numBins * cfg->numRows;
+        for (i = 0; i < numValues; i++) {
+            uint32_t a = CubeQuant_abs(cube[i]);
+            peak = (a > peak) ? a : peak;
+        }
+        scales[0] = (float)peak;
+    } else {
+        const int16_t *line = cube;
+        for (row = 0; row < cfg->numRows; row++) {
+            for (bin = 0; bin < numBins; bin++) {
+                float a = (float)CubeQuant_abs(line[2U * bin]);
+                float b = (float)CubeQuant_abs(line[2U * bin + 1U]);
+                a = (b > a) ? b : a;
+                scales[bin] = (a > scales[bin]) ? a : scales[bin];
+            }
+            line += 2U * numBins;
+        }
+    }
+
+    /* convert peaks to quantisation steps, an all-zero group gets a step of 1 */
+    for (i = 0; i < numScales; i++) {
+        scales[i] = (scales[i] > 0.0f) ? (scales[i] / (float)CUBE_QUANT_MAX_CODE) : 1.0f;
+    }
+
+    /*
+     * pass 2: scale, dither, round and clip, while accumulating the SQNR energies.
+     * The range bins are processed in blocks, the reciprocals of their steps are
+     * computed once per block rather than per sample.
+     */
+    {
+        uint32_t first;
+
+        for (first = 0; first < numBins; first += CUBE_QUANT_BLOCK_BINS) {
+            uint32_t       numBlockBins = ((numBins - first) < CUBE_QUANT_BLOCK_BINS) ?
+                                          (numBins - first) : CUBE_QUANT_BLOCK_BINS;
+            const int16_t *line  = cube + 2U * first;
+            int8_t        *qLine = out + 2U * first;
+            const float   *steps = (numScales == 1U) ? scales : (scales + first);
+            float          invSteps[CUBE_QUANT_BLOCK_BINS];
+
+            for (bin = 0; bin < numBlockBins; bin++) {
+                invSteps[bin] = 1.0f / steps[(numScales == 1U) ? 0U : bin];
+            }
+
+            for (row = 0; row < cfg->numRows; row++) {
+                for (bin = 0; bin < numBlockBins; bin++) {
+                    float    step    = steps[(numScales == 1U) ? 0U : bin];
+                    float    invStep = invSteps[bin];
+                    uint32_t k;
+
+                    for (k = 0; k < 2U; k++) {
+                        float x = (float)line[2U * bin + k];
+                        float v = x * invStep;
+                        float e;
+                        int8_t q;
+
+                        if (cfg->ditherEnable != 0U) {
+                            v += CubeQuant_nextDither(ditherState);
+                        }
+                        q = CubeQuant_roundClip(v);
+                        qLine[2U * bin + k] = q;
+
+                        e = x - ((float)q * step);
+                        sigEnergy += (double)(x * x);
+                        errEnergy += (double)(e * e);
+                    }
+                }
+                line  += 2U * numBins;
+                qLine += 2U * numBins;
+            }
+        }
+
+        /* zero the padding so that no stale memory is streamed */
+        for (i = 2U * numBins * cfg->numRows; (i & 3U) != 0U; i++) {
+            out[i] = 0;
+        }
+    }
+
+    hdr->granularity  = (uint8_t)cfg->granularity;
+    hdr->ditherEnable = cfg->ditherEnable;
+    hdr->numScales    = (uint16_t)numScales;
+    hdr->numRangeBins = cfg->numRangeBins;
+    hdr->reserved     = 0U;
+    hdr->numRows      = cfg->numRows;
+
+    if (errEnergy > 0.0) {
+        hdr->sqnrDb = (float)(10.0 * log10(sigEnergy / errEnergy));
+    } else {
+        /* lossless (e.g. all samples within the int8 range or an empty frame) */
+        hdr->sqnrDb = INFINITY;
+    }
+
+    return 0;
+}
+
+int32_t CubeQuant_dequantize(const void *payload, int16_t *cube) {
+    const CubeQuant_Header *hdr = (const CubeQuant_Header *)payload;
+    const float            *scales;
+    const int8_t           *in;
+    uint32_t                numBins;
+    uint32_t                row, bin;
+
+    if ((payload == NULL) || (cube == NULL)) {
+        return -1;
+    }
+
+    numBins = hdr->numRangeBins;
+    if ((numBins == 0U) ||
+        ((hdr->granularity == CUBE_QUANT_GRANULARITY_PER_FRAME) && (hdr->numScales != 1U)) ||
+        ((hdr->granularity == CUBE_QUANT_GRANULARITY_PER_RANGE_BIN) && (hdr->numScales != numBins)) ||
+        (hdr->granularity > CUBE_QUANT_GRANULARITY_PER_RANGE_BIN)) {
+        return -1;
+    }
+
+    scales = (const float *)(hdr + 1);
+    in     = (const int8_t *)(scales + hdr->numScales);
+
+    for (row = 0; row < hdr->numRows; row++) {
+        for (bin = 0; bin < numBins; bin++) {
+            float step = scales[(hdr->numScales == 1U) ? 0U : bin];
+            uint32_t k;
+
+            for (k = 0; k < 2U; k++) {
+                float x = (float)in[2U * bin + k] * step;
+                x += (x >= 0.0f) ? 0.5f : -0.5f;
+                if (x > 32767.0f) {
+                    x = 32767.0f;
+                } else if (x < -32768.0f) {
+                    x = -32768.0f;
+                }
+                cube[2U * bin + k] = (int16_t)x;
+            }
+        }
+        in   += 2U * numBins;
+        cube += 2U * numBins;
+    }
+
+    return 0;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file doa.c
+ * @brief Angle of arrival estimation across the virtual antennas of the radar cube.
+ *
+ * The estimates use single precision, the heatmap reference model double
+ * precision. Azimuth FFTs are short (at most DOA_MAX_AZIMUTH_FFT_SIZE points),
+ * so the twiddle factors are computed on the fly.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "doa.h"
+
+/*! @brief Pi */
+#define DOA_PI              (3.14159265358979323846)
+
+/*! @brief Degrees per radian in Q7 */
+#define DOA_RAD_TO_DEG_Q7   ((float)(180.0 * 128.0 / DOA_PI))
+
+
+int32_t Doa_init(Doa_Config *cfg) {
+    uint32_t n = cfg->azimuthFftSize;
+    uint32_t ant;
+
+    if ((n < 2U) || (n > DOA_MAX_AZIMUTH_FFT_SIZE) || ((n & (n - 1U)) != 0U) ||
+        (cfg->numVirtualAntennas == 0U) || (cfg->numVirtualAntennas > DOA_MAX_VIRTUAL_ANTENNAS) ||
+        (cfg->numChirps == 0U) || (cfg->dopplerFftSize < cfg->numChirps)) {
+        return -1;
+    }
+
+    memset(cfg->azimuthAnt, DOA_ANT_UNUSED, sizeof(cfg->azimuthAnt));
+    cfg->numAzimuthCols = 0;
+    cfg->numAzimuthAnt  = 0;
+    cfg->elevationEn    = 0;
+
+    for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+        uint32_t col = cfg->antCol[ant];
+
+        if (cfg->antRow[ant] == 0U) {
+            /* one antenna per azimuth column, all columns within the FFT */
+            if ((col >= n) || (cfg->azimuthAnt[col] != DOA_ANT_UNUSED)) {
+                return -1;
+            }
+            cfg->azimuthAnt[col] = (uint8_t)ant;
+            cfg->numAzimuthAnt++;
+            if (col >= cfg->numAzimuthCols) {
+                cfg->numAzimuthCols = (uint16_t)(col + 1U);
+            }
+        } else if (cfg->antRow[ant] == 1U) {
+            cfg->elevationEn = 1;
+        } else if (cfg->antRow[ant] != DOA_ANT_UNUSED) {
+            return -1;
+        }
+    }
+
+    return (cfg->numAzimuthCols > 0U) ? 0 : -1;
+}
+
+uint32_t Doa_getShift(uint32_t numChirps) {
+    uint32_t shift = 0;
+
+    while ((1UL << shift) < numChirps) {
+        shift++;
+    }
+    return shift;
+}
+
+uint32_t Doa_getHeatmapSize(const Doa_Config *cfg) {
+    return (uint32_t)cfg->numRangeBins * cfg->azimuthFftSize * sizeof(uint16_t);
+}
+
+uint32_t Doa_getListSize(uint32_t maxEstimates) {
+    return (uint32_t)sizeof(Doa_ListHeader) + (maxEstimates * sizeof(Doa_Estimate));
+}
+
+uint32_t Doa_getUsedListSize(const void *list) {
+    return (uint32_t)sizeof(Doa_ListHeader) + ((uint32_t)((const Doa_ListHeader *)list)->numEstimates * sizeof(Doa_Estimate));
+}
+
+void Doa_sumChirps(const uint16_t *mag, uint32_t numBins, const Doa_Config *cfg, uint16_t *heatmap) {
+    uint32_t shift = Doa_getShift(cfg->numChirps);
+    uint32_t rowSize = numBins * cfg->azimuthFftSize;
+    uint32_t i, c;
+
+    for (i = 0; i < rowSize; i++) {
+        uint32_t sum = 0;
+        for (c = 0; c < cfg->numChirps; c++) {
+            sum += mag[(c * rowSize) + i];
+        }
+        sum >>= shift;
+        heatmap[i] = (uint16_t)((sum > UINT16_MAX) ? UINT16_MAX : sum);
+    }
+}
+
+/**
+ * @brief Radix-2 decimation in time FFT without scaling, in place.
+ */
+static void Doa_fft(double *re, double *im, uint32_t n) {
+    uint32_t i, j, k, len;
+
+    for (i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; (j & bit) != 0U; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            double t;
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        uint32_t half = len >> 1;
+        for (k = 0; k < half; k++) {
+            double phi = (-2.0 * DOA_PI * (double)k) / (double)len;
+            double wr  = cos(phi);
+            double wi  = sin(phi);
+
+            for (i = k; i < n; i += len) {
+                double tr = (re[i + half] * wr) - (im[i + half] * wi);
+                double ti = (re[i + half] * wi) + (im[i + half] * wr);
+                re[i + half] = re[i] - tr;
+                im[i + half] = im[i] - ti;
+                re[i]       += tr;
+                im[i]       += ti;
+            }
+        }
+    }
+}
+
+int32_t Doa_computeHeatmap(const Doa_Config *cfg, const int16_t *cube, uint16_t *heatmap) {
+    double   re[DOA_MAX_AZIMUTH_FFT_SIZE];
+    double   im[DOA_MAX_AZIMUTH_FFT_SIZE];
+    uint32_t n = cfg->azimuthFftSize;
+    uint32_t rowStride = 2U * (uint32_t)cfg->numVirtualAntennas * cfg->numRangeBins;
+    uint32_t shift = Doa_getShift(cfg->numChirps);
+    uint32_t bin, c, k;
+
+    if (cfg->numAzimuthCols == 0U) {
+        return -1;
+    }
+
+    for (bin = 0; bin < cfg->numRangeBins; bin++) {
+        uint32_t sum[DOA_MAX_AZIMUTH_FFT_SIZE] = {0};
+
+        for (c = 0; c < cfg->numChirps; c++) {
+            const int16_t *s = cube + (c * rowStride) + (2U * bin);
+
+            for (k = 0; k < n; k++) {
+                uint32_t ant = (k < cfg->numAzimuthCols) ? cfg->azimuthAnt[k] : DOA_ANT_UNUSED;
+
+                /* cmplx16ImRe_t: imaginary part first */
+                re[k] = (ant != DOA_ANT_UNUSED) ? (double)s[(2U * ant * cfg->numRangeBins) + 1U] : 0.0;
+                im[k] = (ant != DOA_ANT_UNUSED) ? (double)s[2U * ant * cfg->numRangeBins] : 0.0;
+            }
+
+            Doa_fft(re, im, n);
+
+            /* all butterfly stages scaled: 1/n */
+            for (k = 0; k < n; k++) {
+                sum[k] += (uint32_t)(sqrt((re[k] * re[k]) + (im[k] * im[k])) / (double)n);
+            }
+        }
+
+        for (k = 0; k < n; k++) {
+            uint32_t v = sum[k] >> shift;
+            heatmap[(bin * n) + k] = (uint16_t)((v > UINT16_MAX) ? UINT16_MAX : v);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Extracts Doppler bin dopplerIdx of every virtual antenna (single bin DFT over the chirps).
+ */
+static void Doa_dopplerBin(const Doa_Config *cfg, const int16_t *cube, uint32_t rangeIdx, uint32_t dopplerIdx,
+                           float *re, float *im) {
+    uint32_t rowStride = 2U * (uint32_t)cfg->numVirtualAntennas * cfg->numRangeBins;
+    float    phi = (float)((-2.0 * DOA_PI * (double)dopplerIdx) / (double)cfg->dopplerFftSize);
+    float    stepRe = cosf(phi);
+    float    stepIm = sinf(phi);
+    float    wRe = 1.0f, wIm = 0.0f;
+    uint32_t ant, c;
+
+    memset(re, 0, cfg->numVirtualAntennas * sizeof(float));
+    memset(im, 0, cfg->numVirtualAntennas * sizeof(float));
+
+    for (c = 0; c < cfg->numChirps; c++) {
+        const int16_t *s = cube + (c * rowStride) + (2U * rangeIdx);
+        float t;
+
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            float xRe = (float)s[(2U * ant * cfg->numRangeBins) + 1U];
+            float xIm = (float)s[2U * ant * cfg->numRangeBins];
+
+            re[ant] += (xRe * wRe) - (xIm * wIm);
+            im[ant] += (xRe * wIm) + (xIm * wRe);
+        }
+
+        /* rotate the twiddle factor, the drift over a few hundred chirps is negligible */
+        t   = (wRe * stepRe) - (wIm * stepIm);
+        wIm = (wRe * stepIm) + (wIm * stepRe);
+        wRe = t;
+    }
+}
+
+/**
+ * @brief Sums the antennas of one row, steered to spatial frequency u (cycles per column).
+ */
+static void Doa_steer(const Doa_Config *cfg, const float *re, const float *im, uint32_t row, float u,
+                      float *sumRe, float *sumIm) {
+    uint32_t ant;
+
+    *sumRe = 0.0f;
+    *sumIm = 0.0f;
+    for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+        if (cfg->antRow[ant] == row) {
+            float phi = -2.0f * (float)DOA_PI * u * (float)cfg->antCol[ant];
+            float c = cosf(phi), s = sinf(phi);
+
+            *sumRe += (re[ant] * c) - (im[ant] * s);
+            *sumIm += (re[ant] * s) + (im[ant] * c);
+        }
+    }
+}
+
+void Doa_estimate(const Doa_Config *cfg, const int16_t *cube, uint32_t rangeIdx, uint32_t dopplerIdx,
+                  Doa_Estimate *est) {
+    float    antRe[DOA_MAX_VIRTUAL_ANTENNAS], antIm[DOA_MAX_VIRTUAL_ANTENNAS];
+    double   re[DOA_MAX_AZIMUTH_FFT_SIZE], im[DOA_MAX_AZIMUTH_FFT_SIZE];
+    float    mag[DOA_MAX_AZIMUTH_FFT_SIZE];
+    uint32_t n = cfg->azimuthFftSize;
+    uint32_t k, peak = 0;
+    float    u, sinAz, sinEl = 0.0f;
+    float    s0Re, s0Im, level;
+
+    Doa_dopplerBin(cfg, cube, rangeIdx, dopplerIdx, antRe, antIm);
+
+    /* azimuth spectrum of row 0 */
+    for (k = 0; k < n; k++) {
+        uint32_t ant = (k < cfg->numAzimuthCols) ? cfg->azimuthAnt[k] : DOA_ANT_UNUSED;
+
+        re[k] = (ant != DOA_ANT_UNUSED) ? (double)antRe[ant] : 0.0;
+        im[k] = (ant != DOA_ANT_UNUSED) ? (double)antIm[ant] : 0.0;
+    }
+    Doa_fft(re, im, n);
+    for (k = 0; k < n; k++) {
+        mag[k] = (float)sqrt((re[k] * re[k]) + (im[k] * im[k]));
+        if (mag[k] > mag[peak]) {
+            peak = k;
+        }
+    }
+
+    /* parabolic interpolation of the (cyclic) peak */
+    {
+        float l = mag[(peak + n - 1U) % n];
+        float c = mag[peak];
+        float r = mag[(peak + 1U) % n];
+        float d = (l - (2.0f * c)) + r;
+        float delta = (d < 0.0f) ? (0.5f * (l - r) / d) : 0.0f;
+
+        u = ((float)peak + delta) / (float)n;
+        u = (u >= 0.5f) ? (u - 1.0f) : u;
+    }
+
+    /* elevation from the phase difference of the steered rows */
+    Doa_steer(cfg, antRe, antIm, 0, u, &s0Re, &s0Im);
+    if (cfg->elevationEn != 0U) {
+        float s1Re, s1Im;
+
+        Doa_steer(cfg, antRe, antIm, 1, u, &s1Re, &s1Im);
+        sinEl = atan2f((s1Im * s0Re) - (s1Re * s0Im), (s1Re * s0Re) + (s1Im * s0Im)) / (float)DOA_PI;
+        sinEl = (sinEl > 1.0f) ? 1.0f : ((sinEl < -1.0f) ? -1.0f : sinEl);
+    }
+
+    /* the column phase is pi * sin(az) * cos(el) */
+    sinAz = (2.0f * u) / sqrtf(1.0f - (sinEl * sinEl) + 1.0e-6f);
+    sinAz = (sinAz > 1.0f) ? 1.0f : ((sinAz < -1.0f) ? -1.0f : sinAz);
+
+    /* normalised to the amplitude of one sample */
+    level = sqrtf((s0Re * s0Re) + (s0Im * s0Im)) / (float)(cfg->numChirps * cfg->numAzimuthAnt);
+
+    est->rangeIdx       = (uint16_t)rangeIdx;
+    est->dopplerIdx     = (uint16_t)dopplerIdx;
+    est->azimuthDegQ7   = (int16_t)lrintf(asinf(sinAz) * DOA_RAD_TO_DEG_Q7);
+    est->elevationDegQ7 = (int16_t)lrintf(asinf(sinEl) * DOA_RAD_TO_DEG_Q7);
+    est->level          = (uint16_t)((level > 65535.0f) ? 65535.0f : level);
+    est->reserved       = 0;
+}
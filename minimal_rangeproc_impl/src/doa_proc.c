@@ -0,0 +1,389 @@
+/**
+ * @file doa_proc.c
+ * @brief Angle of arrival stage computing a range-azimuth heatmap and per-detection angles.
+ *
+ * The heatmap is processed synchronously in the dpcTask in the same way as the
+ * Doppler stage (manually triggered and polled EDMA, software triggered HWA
+ * param set with done interrupt).
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/SystemP.h>
+#include <kernel/dpl/SemaphoreP.h>
+#include <utils/mathutils/mathutils.h>
+#include <drivers/edma.h>
+#include <drivers/hwa.h>
+#include "ti_drivers_config.h"
+#include "ti_drivers_open_close.h"
+
+#include "system.h"
+#include "defines.h"
+#include "dpu_res.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "doa.h"
+#include "cfar.h"
+#include "cfar_proc.h"
+#include "doa_proc.h"
+
+#if DOAPROC_ENABLE && DOAPROC_ESTIMATES_ENABLE && !CFARPROC_ENABLE
+#error "DOAPROC_ESTIMATES_ENABLE requires CFARPROC_ENABLE"
+#endif
+
+
+/**************************************************************************
+ ************************** Extern Definitions ****************************
+ **************************************************************************/
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
+
+#if DOAPROC_HEATMAP_ENABLE
+/*! @brief Translates a CPU address within the HWA memory banks to a HWA param set address */
+#define DOAPROC_HWA_ADDR(hwaMemBase, addr)  ((uint16_t)(((uintptr_t)(addr) - (hwaMemBase)) & 0xFFFFU))
+
+/**
+ * @brief State of the DoA stage.
+ */
+typedef struct DoaProc_Obj_t
+{
+    /*! @brief Number of range bins processed per HWA pass */
+    uint32_t binsPerGroup;
+
+    /*! @brief Size of one azimuth column of a group in HWA memory */
+    uint32_t colBytes;
+
+    /*! @brief CPU address of HWA memory bank M0 (gathered input) */
+    uint8_t *hwaIn;
+
+    /*! @brief CPU address of HWA memory bank M2 (magnitudes) */
+    uint16_t *hwaOut;
+
+    /*! @brief EDMA controller base address */
+    uint32_t edmaBaseAddr;
+
+    /*! @brief EDMA region of this core */
+    uint32_t edmaRegionId;
+
+    /*! @brief Signalled by the HWA done interrupt */
+    SemaphoreP_Object hwaDoneSem;
+} DoaProc_Obj;
+
+/*! @brief DoA stage state */
+static DoaProc_Obj gDoaProcObj;
+
+
+/**
+ * @brief HWA done interrupt callback.
+ */
+static void DoaProc_hwaDoneCallback(void *arg) {
+    SemaphoreP_post((SemaphoreP_Object *)arg);
+}
+
+/**
+ * @brief Configures the HWA param set computing the azimuth magnitudes of one group.
+ */
+static int32_t DoaProc_configParamSet(uint32_t hwaMemBase) {
+    Doa_Config *cfg = &gSysContext.doaCfg;
+    uint32_t numSeq = (uint32_t)cfg->numChirps * gDoaProcObj.binsPerGroup;
+    HWA_ParamConfig paramCfg;
+
+    memset(&paramCfg, 0, sizeof(HWA_ParamConfig));
+    paramCfg.triggerMode = HWA_TRIG_MODE_SOFTWARE;
+    paramCfg.accelMode   = HWA_ACCELMODE_FFT;
+
+    /* input: [column][chirp][bin], one sequence per (chirp, bin), zero padded by the HWA */
+    paramCfg.source.srcAddr        = DOAPROC_HWA_ADDR(hwaMemBase, gDoaProcObj.hwaIn);
+    paramCfg.source.srcAcnt        = cfg->numAzimuthCols - 1U;
+    paramCfg.source.srcAIdx        = gDoaProcObj.colBytes;
+    paramCfg.source.srcBcnt        = numSeq - 1U;
+    paramCfg.source.srcBIdx        = sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcRealComplex = HWA_SAMPLES_FORMAT_COMPLEX;
+    paramCfg.source.srcWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.source.srcSign        = HWA_SAMPLES_SIGNED;
+    paramCfg.source.srcConjugate   = 0;
+    paramCfg.source.srcScale       = 0;
+
+    /* output: [chirp][bin][azimuthBin] 16-bit magnitudes */
+    paramCfg.dest.dstAddr        = DOAPROC_HWA_ADDR(hwaMemBase, gDoaProcObj.hwaOut);
+    paramCfg.dest.dstAcnt        = cfg->azimuthFftSize - 1U;
+    paramCfg.dest.dstAIdx        = sizeof(uint16_t);
+    paramCfg.dest.dstBIdx        = cfg->azimuthFftSize * sizeof(uint16_t);
+    paramCfg.dest.dstRealComplex = HWA_SAMPLES_FORMAT_REAL;
+    paramCfg.dest.dstWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.dest.dstSign        = HWA_SAMPLES_UNSIGNED;
+    paramCfg.dest.dstConjugate   = 0;
+    paramCfg.dest.dstScale       = 0;
+
+    /* all butterfly stages scaled, no window (only a few antennas) */
+    paramCfg.accelModeArgs.fftMode.fftEn              = 1;
+    paramCfg.accelModeArgs.fftMode.fftSize            = mathUtils_ceilLog2(cfg->azimuthFftSize);
+    paramCfg.accelModeArgs.fftMode.butterflyScaling   = cfg->azimuthFftSize - 1U;
+    paramCfg.accelModeArgs.fftMode.windowEn           = 0;
+    paramCfg.accelModeArgs.fftMode.magLogEn           = HWA_FFT_MODE_MAGNITUDE_ONLY_ENABLED;
+    paramCfg.accelModeArgs.fftMode.fftOutMode         = HWA_FFT_MODE_OUTPUT_DEFAULT;
+    paramCfg.complexMultiply.mode                     = HWA_COMPLEX_MULTIPLY_MODE_DISABLE;
+
+    return HWA_configParamSet(gSysContext.hwaHandle, DOAPROC_HWA_PARAMSET_IDX, &paramCfg, NULL);
+}
+
+/**
+ * @brief Gathers the azimuth columns of range bins [bin, bin + binsPerGroup) into HWA memory.
+ */
+static void DoaProc_gather(uint32_t bin) {
+    Doa_Config *cfg = &gSysContext.doaCfg;
+    const cmplx16ImRe_t *cube = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+    uint32_t tcc = DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_CH;
+    EDMACCPaRAMEntry edmaParam;
+    uint32_t col;
+
+    for (col = 0; col < cfg->numAzimuthCols; col++) {
+        uint32_t ant = cfg->azimuthAnt[col];
+        uint8_t *dst = gDoaProcObj.hwaIn + (col * gDoaProcObj.colBytes);
+
+        if (ant == DOA_ANT_UNUSED) {
+            memset(dst, 0, gDoaProcObj.colBytes);
+            continue;
+        }
+
+        /* every chirp contributes binsPerGroup contiguous samples of the antenna */
+        EDMA_ccPaRAMEntry_init(&edmaParam);
+        edmaParam.srcAddr    = (uint32_t)SOC_virtToPhy((void *)&cube[(ant * cfg->numRangeBins) + bin]);
+        edmaParam.destAddr   = (uint32_t)SOC_virtToPhy(dst);
+        edmaParam.aCnt       = (uint16_t)(gDoaProcObj.binsPerGroup * sizeof(cmplx16ImRe_t));
+        edmaParam.bCnt       = cfg->numChirps;
+        edmaParam.cCnt       = 1;
+        edmaParam.bCntReload = 0;
+        edmaParam.srcBIdx    = (int16_t)((uint32_t)cfg->numVirtualAntennas * cfg->numRangeBins * sizeof(cmplx16ImRe_t));
+        edmaParam.destBIdx   = (int16_t)edmaParam.aCnt;
+        edmaParam.srcCIdx    = 0;
+        edmaParam.destCIdx   = 0;
+        edmaParam.linkAddr   = 0xFFFFU;
+        edmaParam.opt        = EDMA_OPT_TCINTEN_MASK | EDMA_OPT_SYNCDIM_MASK |
+                               ((tcc << EDMA_OPT_TCC_SHIFT) & EDMA_OPT_TCC_MASK);
+
+        EDMA_setPaRAM(gDoaProcObj.edmaBaseAddr, DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_SHADOW, &edmaParam);
+        EDMA_enableTransferRegion(gDoaProcObj.edmaBaseAddr, gDoaProcObj.edmaRegionId,
+                                  DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_CH, EDMA_TRIG_MODE_MANUAL);
+
+        while (EDMA_readIntrStatusRegion(gDoaProcObj.edmaBaseAddr, gDoaProcObj.edmaRegionId, tcc) != 1U) {
+        }
+        EDMA_clrIntrRegion(gDoaProcObj.edmaBaseAddr, gDoaProcObj.edmaRegionId, tcc);
+    }
+}
+
+/**
+ * @brief Allocates the heatmap and configures EDMA and HWA param set.
+ */
+static int32_t DoaProc_configHeatmap(void) {
+    Doa_Config *cfg = &gSysContext.doaCfg;
+    HWA_MemInfo hwaMemInfo;
+    uint32_t inBytes, outBytes;
+    int32_t retVal;
+
+    memset(&gDoaProcObj, 0, sizeof(DoaProc_Obj));
+
+    retVal = HWA_getHWAMemInfo(gSysContext.hwaHandle, &hwaMemInfo);
+    if (retVal != 0) {
+        DebugP_log("Error: HWA memory info not available (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    /* largest power of 2 group of range bins whose input and output fit into one bank each */
+    inBytes  = (uint32_t)cfg->numAzimuthCols * cfg->numChirps * sizeof(cmplx16ImRe_t);
+    outBytes = (uint32_t)cfg->numChirps * cfg->azimuthFftSize * sizeof(uint16_t);
+    gDoaProcObj.binsPerGroup = cfg->numRangeBins;
+    while ((gDoaProcObj.binsPerGroup * MAX(inBytes, outBytes)) > hwaMemInfo.bankSize) {
+        gDoaProcObj.binsPerGroup >>= 1;
+    }
+    if ((gDoaProcObj.binsPerGroup == 0U) || ((cfg->numRangeBins % gDoaProcObj.binsPerGroup) != 0U)) {
+        DebugP_log("Error: DoA stage does not fit into a HWA memory bank\r\n");
+        return SystemP_FAILURE;
+    }
+    gDoaProcObj.colBytes = (uint32_t)cfg->numChirps * gDoaProcObj.binsPerGroup * sizeof(cmplx16ImRe_t);
+    gDoaProcObj.hwaIn    = (uint8_t *)hwaMemInfo.baseAddress;
+    gDoaProcObj.hwaOut   = (uint16_t *)(hwaMemInfo.baseAddress + (2U * hwaMemInfo.bankSize));
+
+    gSysContext.doaHeatmap = (uint16_t *)MemRegion_alloc(&gSysContext.memRegions,
+                                                         Doa_getHeatmapSize(cfg),
+                                                         sizeof(uint32_t),
+                                                         MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                                         MEM_REGION_POLICY_LARGEST_FREE,
+                                                         "doa",
+                                                         NULL);
+    if (gSysContext.doaHeatmap == NULL) {
+        DebugP_log("Error: not enough shared memory for the range-azimuth heatmap\r\n");
+        return SystemP_FAILURE;
+    }
+
+    retVal = DoaProc_configParamSet(hwaMemInfo.baseAddress);
+    if (retVal != 0) {
+        DebugP_log("Error: DoA HWA param set configuration failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    /* manually triggered gather transfers */
+    gDoaProcObj.edmaBaseAddr = EDMA_getBaseAddr(gEdmaHandle[0]);
+    gDoaProcObj.edmaRegionId = EDMA_getRegionId(gEdmaHandle[0]);
+    EDMA_configureChannelRegion(gDoaProcObj.edmaBaseAddr, gDoaProcObj.edmaRegionId,
+                                EDMA_CHANNEL_TYPE_DMA,
+                                DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_CH,
+                                DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_CH,
+                                DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_SHADOW,
+                                DPC_OBJDET_DPU_DOAPROC_EDMAIN_PONG_EVENT_QUE);
+
+    if (SemaphoreP_constructBinary(&gDoaProcObj.hwaDoneSem, 0) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Computes the range-azimuth heatmap of the current radar cube.
+ */
+static int32_t DoaProc_processHeatmap(void) {
+    Doa_Config *cfg = &gSysContext.doaCfg;
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    uint32_t hwaTicks = 0;
+    HWA_CommonConfig hwaCommonCfg;
+    uint32_t bin;
+    int32_t retVal;
+
+    /* the HWA is shared with the range DPU, which reprograms the common config on its trigger */
+    memset(&hwaCommonCfg, 0, sizeof(HWA_CommonConfig));
+    hwaCommonCfg.configMask = HWA_COMMONCONFIG_MASK_NUMLOOPS |
+                              HWA_COMMONCONFIG_MASK_PARAMSTARTIDX |
+                              HWA_COMMONCONFIG_MASK_PARAMSTOPIDX |
+                              HWA_COMMONCONFIG_MASK_FFT1DENABLE |
+                              HWA_COMMONCONFIG_MASK_INTERFERENCETHRESHOLD;
+    hwaCommonCfg.numLoops      = 1;
+    hwaCommonCfg.paramStartIdx = DOAPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.paramStopIdx  = DOAPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.fftConfig.fft1DEnable           = HWA_FEATURE_BIT_DISABLE;
+    hwaCommonCfg.fftConfig.interferenceThreshold = 0xFFFFFF;
+
+    for (bin = 0; bin < cfg->numRangeBins; bin += gDoaProcObj.binsPerGroup) {
+        uint32_t hwaStartTicks;
+
+        DoaProc_gather(bin);
+
+        retVal = HWA_configCommon(gSysContext.hwaHandle, &hwaCommonCfg);
+        if (retVal == 0) {
+            retVal = HWA_enableDoneInterrupt(gSysContext.hwaHandle, DoaProc_hwaDoneCallback,
+                                             &gDoaProcObj.hwaDoneSem);
+        }
+        if (retVal == 0) {
+            retVal = HWA_enable(gSysContext.hwaHandle, 1);
+        }
+        hwaStartTicks = Cycleprofiler_getTimeStamp();
+        if (retVal == 0) {
+            retVal = HWA_setSoftwareTrigger(gSysContext.hwaHandle);
+        }
+        if (retVal != 0) {
+            DebugP_log("Error: DoA HWA pass failed (%d)\r\n", retVal);
+            return SystemP_FAILURE;
+        }
+
+        SemaphoreP_pend(&gDoaProcObj.hwaDoneSem, SystemP_WAIT_FOREVER);
+        hwaTicks += Cycleprofiler_getTimeStamp() - hwaStartTicks;
+        HWA_disableDoneInterrupt(gSysContext.hwaHandle);
+        HWA_enable(gSysContext.hwaHandle, 0);
+
+        Doa_sumChirps(gDoaProcObj.hwaOut, gDoaProcObj.binsPerGroup, cfg,
+                      &gSysContext.doaHeatmap[bin * cfg->azimuthFftSize]);
+    }
+
+    // benchmark: whole stage and HWA busy time incl. interrupt latency (40 MHz ticks)
+    gSysContext.doaProcTicks = Cycleprofiler_getTimeStamp() - startTicks;
+    gSysContext.doaHwaTicks  = hwaTicks;
+
+    return SystemP_SUCCESS;
+}
+#endif /* DOAPROC_HEATMAP_ENABLE */
+
+#if DOAPROC_ESTIMATES_ENABLE
+/**
+ * @brief Estimates the angles of the CFAR detections of the current frame.
+ */
+static void DoaProc_processEstimates(void) {
+    const Cfar_Header    *cfarHdr = (const Cfar_Header *)gSysContext.cfarDetList;
+    const Cfar_Detection *det     = (const Cfar_Detection *)(cfarHdr + 1);
+    Doa_ListHeader       *listHdr = (Doa_ListHeader *)gSysContext.doaList;
+    Doa_Estimate         *est     = (Doa_Estimate *)(listHdr + 1);
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    uint32_t i;
+
+    for (i = 0; i < cfarHdr->numDetections; i++) {
+        Doa_estimate(&gSysContext.doaCfg,
+                     (const int16_t *)gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                     det[i].rangeIdx, det[i].dopplerIdx, &est[i]);
+    }
+
+    listHdr->numEstimates = cfarHdr->numDetections;
+    listHdr->elevationEn  = gSysContext.doaCfg.elevationEn;
+    listHdr->reserved     = 0;
+    listHdr->computeTicks = Cycleprofiler_getTimeStamp() - startTicks;
+}
+#endif
+
+int32_t DoaProc_config(void) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    Doa_Config *cfg = &gSysContext.doaCfg;
+    const uint8_t antRow[] = DOAPROC_ANT_ROW;
+    const uint8_t antCol[] = DOAPROC_ANT_COL;
+    uint32_t ant;
+
+    memset(cfg, 0, sizeof(Doa_Config));
+    cfg->numRangeBins       = params->numRangeBins;
+    cfg->numVirtualAntennas = params->numVirtualAntennas;
+    cfg->numChirps          = params->numDopplerChirpsPerFrame;
+    cfg->azimuthFftSize     = DOAPROC_AZIMUTH_FFT_SIZE;
+    cfg->dopplerFftSize     = mathUtils_pow2roundup(params->numDopplerChirpsPerFrame);
+
+    for (ant = 0; ant < DOA_MAX_VIRTUAL_ANTENNAS; ant++) {
+        cfg->antRow[ant] = (ant < sizeof(antRow)) ? antRow[ant] : DOA_ANT_UNUSED;
+        cfg->antCol[ant] = (ant < sizeof(antCol)) ? antCol[ant] : 0U;
+    }
+
+    if (Doa_init(cfg) != 0) {
+        DebugP_log("Error: unsupported DoA antenna geometry or FFT size\r\n");
+        return SystemP_FAILURE;
+    }
+
+#if DOAPROC_HEATMAP_ENABLE
+    if (DoaProc_configHeatmap() != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if DOAPROC_ESTIMATES_ENABLE
+    gSysContext.doaList = MemRegion_alloc(&gSysContext.memRegions,
+                                          Doa_getListSize(CFARPROC_MAX_DETECTIONS),
+                                          sizeof(uint32_t),
+                                          MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                          MEM_REGION_POLICY_LARGEST_FREE,
+                                          "doa",
+                                          NULL);
+    if (gSysContext.doaList == NULL) {
+        DebugP_log("Error: not enough shared memory for the DoA estimate list\r\n");
+        return SystemP_FAILURE;
+    }
+#endif
+
+    return SystemP_SUCCESS;
+}
+
+int32_t DoaProc_process(void) {
+#if DOAPROC_HEATMAP_ENABLE
+    if (DoaProc_processHeatmap() != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if DOAPROC_ESTIMATES_ENABLE
+    DoaProc_processEstimates();
+#endif
+
+    return SystemP_SUCCESS;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file doppler_proc.c
+ * @brief Doppler processing stage computing a range-Doppler heatmap on the HWA.
+ *
+ * The stage is processed synchronously in the dpcTask: the EDMA transfer is
+ * triggered manually and polled, the HWA param set is triggered by software
+ * and signals completion through the HWA done interrupt. Input gather and FFT
+ * of a group are not overlapped, which keeps a single HWA param set and EDMA
+ * channel; both are short compared to the SPI transfer of the frame.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/SystemP.h>
+#include <kernel/dpl/SemaphoreP.h>
+#include <utils/mathutils/mathutils.h>
+#include <drivers/edma.h>
+#include <drivers/hwa.h>
+#include "ti_drivers_config.h"
+#include "ti_drivers_open_close.h"
+
+#include "system.h"
+#include "defines.h"
+#include "dpu_res.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "rd_heatmap.h"
+#include "doppler_proc.h"
+
+
+/**************************************************************************
+ ************************** Extern Definitions ****************************
+ **************************************************************************/
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
+
+/*! @brief Translates a CPU address within the HWA memory banks to a HWA param set address */
+#define DOPPLERPROC_HWA_ADDR(hwaMemBase, addr)  ((uint16_t)(((uintptr_t)(addr) - (hwaMemBase)) & 0xFFFFU))
+
+/**
+ * @brief State of the Doppler stage.
+ */
+typedef struct DopplerProc_Obj_t
+{
+    /*! @brief Doppler window (first half) in core local memory */
+    int32_t *window;
+
+    /*! @brief Number of range bins processed per HWA pass */
+    uint32_t binsPerGroup;
+
+    /*! @brief CPU address of HWA memory bank M0 (gathered input) */
+    uint8_t *hwaIn;
+
+    /*! @brief CPU address of HWA memory bank M2 (magnitudes) */
+    uint16_t *hwaOut;
+
+    /*! @brief EDMA controller base address */
+    uint32_t edmaBaseAddr;
+
+    /*! @brief EDMA region of this core */
+    uint32_t edmaRegionId;
+
+    /*! @brief Signalled by the HWA done interrupt */
+    SemaphoreP_Object hwaDoneSem;
+} DopplerProc_Obj;
+
+/*! @brief Doppler stage state */
+static DopplerProc_Obj gDopplerProcObj;
+
+
+/**
+ * @brief HWA done interrupt callback.
+ */
+static void DopplerProc_hwaDoneCallback(void *arg) {
+    SemaphoreP_post((SemaphoreP_Object *)arg);
+}
+
+/**
+ * @brief Configures the HWA param set computing the Doppler magnitudes of one group.
+ */
+static int32_t DopplerProc_configParamSet(uint32_t hwaMemBase, uint32_t windowOffset) {
+    RdHeatmap_Config *cfg = &gSysContext.rdHeatmapCfg;
+    uint32_t numSeq = (uint32_t)cfg->numVirtualAntennas * gDopplerProcObj.binsPerGroup;
+    HWA_ParamConfig paramCfg;
+
+    memset(&paramCfg, 0, sizeof(HWA_ParamConfig));
+    paramCfg.triggerMode = HWA_TRIG_MODE_SOFTWARE;
+    paramCfg.accelMode   = HWA_ACCELMODE_FFT;
+
+    /* input: [chirp][antenna][bin], one sequence per (antenna, bin) */
+    paramCfg.source.srcAddr        = DOPPLERPROC_HWA_ADDR(hwaMemBase, gDopplerProcObj.hwaIn);
+    paramCfg.source.srcAcnt        = cfg->numDopplerChirps - 1U;
+    paramCfg.source.srcAIdx        = numSeq * sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcBcnt        = numSeq - 1U;
+    paramCfg.source.srcBIdx        = sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcRealComplex = HWA_SAMPLES_FORMAT_COMPLEX;
+    paramCfg.source.srcWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.source.srcSign        = HWA_SAMPLES_SIGNED;
+    paramCfg.source.srcConjugate   = 0;
+    paramCfg.source.srcScale       = 0;
+
+    /* output: [antenna][bin][dopplerBin] 16-bit magnitudes */
+    paramCfg.dest.dstAddr        = DOPPLERPROC_HWA_ADDR(hwaMemBase, gDopplerProcObj.hwaOut);
+    paramCfg.dest.dstAcnt        = cfg->fftSize - 1U;
+    paramCfg.dest.dstAIdx        = sizeof(uint16_t);
+    paramCfg.dest.dstBIdx        = cfg->fftSize * sizeof(uint16_t);
+    paramCfg.dest.dstRealComplex = HWA_SAMPLES_FORMAT_REAL;
+    paramCfg.dest.dstWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.dest.dstSign        = HWA_SAMPLES_UNSIGNED;
+    paramCfg.dest.dstConjugate   = 0;
+    paramCfg.dest.dstScale       = 0;
+
+    /* all butterfly stages scaled: FFT gain of 1, the magnitude cannot overflow 16 bits */
+    paramCfg.accelModeArgs.fftMode.fftEn              = 1;
+    paramCfg.accelModeArgs.fftMode.fftSize            = mathUtils_ceilLog2(cfg->fftSize);
+    paramCfg.accelModeArgs.fftMode.butterflyScaling   = cfg->fftSize - 1U;
+    paramCfg.accelModeArgs.fftMode.windowEn           = 1;
+    paramCfg.accelModeArgs.fftMode.windowStart        = windowOffset;
+    paramCfg.accelModeArgs.fftMode.winSymm            = HWA_FFT_WINDOW_SYMMETRIC;
+    paramCfg.accelModeArgs.fftMode.winInterpolateMode = 0;
+    paramCfg.accelModeArgs.fftMode.magLogEn           = HWA_FFT_MODE_MAGNITUDE_ONLY_ENABLED;
+    paramCfg.accelModeArgs.fftMode.fftOutMode         = HWA_FFT_MODE_OUTPUT_DEFAULT;
+    paramCfg.complexMultiply.mode                     = HWA_COMPLEX_MULTIPLY_MODE_DISABLE;
+
+    return HWA_configParamSet(gSysContext.hwaHandle, DOPPLERPROC_HWA_PARAMSET_IDX, &paramCfg, NULL);
+}
+
+/**
+ * @brief Gathers the samples of range bins [bin, bin + binsPerGroup) into HWA memory.
+ */
+static void DopplerProc_gather(uint32_t bin) {
+    RdHeatmap_Config *cfg = &gSysContext.rdHeatmapCfg;
+    const cmplx16ImRe_t *cube = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+    uint32_t tcc = DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_CH;
+    EDMACCPaRAMEntry edmaParam;
+
+    /* every range line of the cube contributes binsPerGroup contiguous samples */
+    EDMA_ccPaRAMEntry_init(&edmaParam);
+    edmaParam.srcAddr    = (uint32_t)SOC_virtToPhy((void *)&cube[bin]);
+    edmaParam.destAddr   = (uint32_t)SOC_virtToPhy(gDopplerProcObj.hwaIn);
+    edmaParam.aCnt       = (uint16_t)(gDopplerProcObj.binsPerGroup * sizeof(cmplx16ImRe_t));
+    edmaParam.bCnt       = (uint16_t)((uint32_t)cfg->numVirtualAntennas * cfg->numDopplerChirps);
+    edmaParam.cCnt       = 1;
+    edmaParam.bCntReload = 0;
+    edmaParam.srcBIdx    = (int16_t)(cfg->numRangeBins * sizeof(cmplx16ImRe_t));
+    edmaParam.destBIdx   = (int16_t)edmaParam.aCnt;
+    edmaParam.srcCIdx    = 0;
+    edmaParam.destCIdx   = 0;
+    edmaParam.linkAddr   = 0xFFFFU;
+    edmaParam.opt        = EDMA_OPT_TCINTEN_MASK | EDMA_OPT_SYNCDIM_MASK |
+                           ((tcc << EDMA_OPT_TCC_SHIFT) & EDMA_OPT_TCC_MASK);
+
+    EDMA_setPaRAM(gDopplerProcObj.edmaBaseAddr, DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_SHADOW, &edmaParam);
+    EDMA_enableTransferRegion(gDopplerProcObj.edmaBaseAddr, gDopplerProcObj.edmaRegionId,
+                              DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_CH, EDMA_TRIG_MODE_MANUAL);
+
+    while (EDMA_readIntrStatusRegion(gDopplerProcObj.edmaBaseAddr, gDopplerProcObj.edmaRegionId, tcc) != 1U) {
+    }
+    EDMA_clrIntrRegion(gDopplerProcObj.edmaBaseAddr, gDopplerProcObj.edmaRegionId, tcc);
+}
+
+int32_t DopplerProc_config(void) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    RdHeatmap_Config *cfg = &gSysContext.rdHeatmapCfg;
+    HWA_MemInfo hwaMemInfo;
+    uint32_t windowSize;
+    uint32_t windowOffset;
+    uint32_t groupBytes;
+    int32_t retVal;
+
+    memset(&gDopplerProcObj, 0, sizeof(DopplerProc_Obj));
+
+    cfg->numRangeBins       = params->numRangeBins;
+    cfg->numVirtualAntennas = params->numVirtualAntennas;
+    cfg->numDopplerChirps   = params->numDopplerChirpsPerFrame;
+    cfg->fftSize            = mathUtils_pow2roundup(params->numDopplerChirpsPerFrame);
+
+    retVal = HWA_getHWAMemInfo(gSysContext.hwaHandle, &hwaMemInfo);
+    if (retVal != 0) {
+        DebugP_log("Error: HWA memory info not available (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    /* largest power of 2 group of range bins whose input and output fit into one bank each */
+    groupBytes = (uint32_t)cfg->numVirtualAntennas * MAX(cfg->numDopplerChirps * sizeof(cmplx16ImRe_t),
+                                                         cfg->fftSize * sizeof(uint16_t));
+    gDopplerProcObj.binsPerGroup = cfg->numRangeBins;
+    while ((gDopplerProcObj.binsPerGroup * groupBytes) > hwaMemInfo.bankSize) {
+        gDopplerProcObj.binsPerGroup >>= 1;
+    }
+    if ((gDopplerProcObj.binsPerGroup == 0U) || ((cfg->numRangeBins % gDopplerProcObj.binsPerGroup) != 0U)) {
+        DebugP_log("Error: Doppler stage does not fit into a HWA memory bank\r\n");
+        return SystemP_FAILURE;
+    }
+    gDopplerProcObj.hwaIn  = (uint8_t *)hwaMemInfo.baseAddress;
+    gDopplerProcObj.hwaOut = (uint16_t *)(hwaMemInfo.baseAddress + (2U * hwaMemInfo.bankSize));
+
+    /* heatmap in the shared memory, streamed via the SPI DMA */
+    gSysContext.rdHeatmap = (uint16_t *)MemRegion_alloc(&gSysContext.memRegions,
+                                                        RdHeatmap_getSize(cfg),
+                                                        sizeof(uint32_t),
+                                                        MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                                        MEM_REGION_POLICY_LARGEST_FREE,
+                                                        "doppler",
+                                                        NULL);
+    if (gSysContext.rdHeatmap == NULL) {
+        DebugP_log("Error: not enough shared memory for the range-Doppler heatmap\r\n");
+        return SystemP_FAILURE;
+    }
+
+    /* symmetric window, stored in the window RAM right after the range FFT window */
+    windowSize = sizeof(uint32_t) * ((cfg->numDopplerChirps + 1U) / 2U);
+    gDopplerProcObj.window = (int32_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                      windowSize,
+                                                                      sizeof(uint32_t),
+                                                                      "doppler");
+    if (gDopplerProcObj.window == NULL) {
+        DebugP_log("Error: not enough core local memory for the Doppler window\r\n");
+        return SystemP_FAILURE;
+    }
+    mathUtils_genWindow((uint32_t *)gDopplerProcObj.window,
+                        cfg->numDopplerChirps,
+                        windowSize / sizeof(uint32_t),
+                        DOPPLERPROC_WINDOW_TYPE,
+                        DPC_OBJDET_QFORMAT_DOPPLER_FFT);
+
+    windowOffset = gSysContext.rangeProcDpuCfg.hwRes.hwaCfg.hwaWinRamOffset +
+                   (params->windowSize / sizeof(uint32_t));
+    retVal = HWA_configRam(gSysContext.hwaHandle, HWA_RAM_TYPE_WINDOW_RAM,
+                           (uint8_t *)gDopplerProcObj.window, windowSize,
+                           windowOffset * sizeof(uint32_t));
+    if (retVal != 0) {
+        DebugP_log("Error: Doppler window RAM configuration failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    retVal = DopplerProc_configParamSet(hwaMemInfo.baseAddress, windowOffset);
+    if (retVal != 0) {
+        DebugP_log("Error: Doppler HWA param set configuration failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    /* manually triggered gather transfer */
+    gDopplerProcObj.edmaBaseAddr = EDMA_getBaseAddr(gEdmaHandle[0]);
+    gDopplerProcObj.edmaRegionId = EDMA_getRegionId(gEdmaHandle[0]);
+    EDMA_configureChannelRegion(gDopplerProcObj.edmaBaseAddr, gDopplerProcObj.edmaRegionId,
+                                EDMA_CHANNEL_TYPE_DMA,
+                                DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_CH,
+                                DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_CH,
+                                DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_SHADOW,
+                                DPC_OBJDET_DPU_DOPPLERPROC_EDMAIN_EVENT_QUE);
+
+    if (SemaphoreP_constructBinary(&gDopplerProcObj.hwaDoneSem, 0) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    return SystemP_SUCCESS;
+}
+
+int32_t DopplerProc_process(uint32_t *computeTicks) {
+    RdHeatmap_Config *cfg = &gSysContext.rdHeatmapCfg;
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    HWA_CommonConfig hwaCommonCfg;
+    uint32_t bin;
+    int32_t retVal;
+
+    /* the HWA is shared with the range DPU, which reprograms the common config on its trigger */
+    memset(&hwaCommonCfg, 0, sizeof(HWA_CommonConfig));
+    hwaCommonCfg.configMask = HWA_COMMONCONFIG_MASK_NUMLOOPS |
+                              HWA_COMMONCONFIG_MASK_PARAMSTARTIDX |
+                              HWA_COMMONCONFIG_MASK_PARAMSTOPIDX |
+                              HWA_COMMONCONFIG_MASK_FFT1DENABLE |
+                              HWA_COMMONCONFIG_MASK_INTERFERENCETHRESHOLD;
+    hwaCommonCfg.numLoops      = 1;
+    hwaCommonCfg.paramStartIdx = DOPPLERPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.paramStopIdx  = DOPPLERPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.fftConfig.fft1DEnable           = HWA_FEATURE_BIT_DISABLE;
+    hwaCommonCfg.fftConfig.interferenceThreshold = 0xFFFFFF;
+
+    for (bin = 0; bin < cfg->numRangeBins; bin += gDopplerProcObj.binsPerGroup) {
+        DopplerProc_gather(bin);
+
+        retVal = HWA_configCommon(gSysContext.hwaHandle, &hwaCommonCfg);
+        if (retVal == 0) {
+            retVal = HWA_enableDoneInterrupt(gSysContext.hwaHandle, DopplerProc_hwaDoneCallback,
+                                             &gDopplerProcObj.hwaDoneSem);
+        }
+        if (retVal == 0) {
+            retVal = HWA_enable(gSysContext.hwaHandle, 1);
+        }
+        if (retVal == 0) {
+            retVal = HWA_setSoftwareTrigger(gSysContext.hwaHandle);
+        }
+        if (retVal != 0) {
+            DebugP_log("Error: Doppler HWA pass failed (%d)\r\n", retVal);
+            return SystemP_FAILURE;
+        }
+
+        SemaphoreP_pend(&gDopplerProcObj.hwaDoneSem, SystemP_WAIT_FOREVER);
+        HWA_disableDoneInterrupt(gSysContext.hwaHandle);
+        HWA_enable(gSysContext.hwaHandle, 0);
+
+        RdHeatmap_sumAntennas(gDopplerProcObj.hwaOut, gDopplerProcObj.binsPerGroup, cfg,
+                              &gSysContext.rdHeatmap[bin * cfg->fftSize]);
+    }
+
+    *computeTicks = Cycleprofiler_getTimeStamp() - startTicks;
+
+    return SystemP_SUCCESS;
+}
@@ -64,21 +64,125 @@
 
 
 
-Mmw_calibData calibData __attribute__((aligned(8))) = {0};
+/* retained across resets for the warm boot (not initialized, see warm_start.h), read from flash on a cold boot */
+Mmw_calibData calibData __attribute__((aligned(8), section(".retained")));
 
 
-int32_t restoreFactoryCal(void)
+/**
+ * @brief Configures the calibration with MMWave_factoryCalibConfig(): runs the boot calibration
+ *        (isFactoryCalEnabled) and stores its result in calibData, or applies calibData.
+ */
+static int32_t factoryCal_config(MMWave_calibCfg *factoryCalCfg, bool runCalibration)
 {
-    uint16_t         calRfFreq = 0U;
-    MMWave_calibCfg  factoryCalCfg = {0U};
-    int32_t          retVal = SystemP_SUCCESS;
+    int32_t          retVal;
     int32_t          errCode;
     MMWave_ErrorLevel   errorLevel;
     int16_t          mmWaveErrorCode;
     int16_t          subsysErrorCode;
 
-    /* Enable sensor boot time calibration: */
-    factoryCalCfg.isFactoryCalEnabled = true;
+    /* Populate calibration data pointer: output of the boot calibration or data to restore */
+    factoryCalCfg->ptrFactoryCalibData = &calibData.calibData;
+    factoryCalCfg->isFactoryCalEnabled = runCalibration;
+
+    retVal = MMWave_factoryCalibConfig(gSysContext.gCtrlHandle, factoryCalCfg, &errCode);
+    if (retVal != SystemP_SUCCESS)
+    {
+
+        /* Error: Unable to perform boot calibration */
+        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
+
+        /* Error: Unable to initialize the mmWave control module */
+        DebugP_log("Error: mmWave Control Initialization failed [Error code %d] [errorLevel %d] [mmWaveErrorCode %d] [subsysErrorCode %d]\n", errCode, errorLevel, mmWaveErrorCode, subsysErrorCode);
+        if (mmWaveErrorCode == MMWAVE_ERFSBOOTCAL)
+        {
+            DebugP_log("Error: Factory Calibration failure\n");
+            return -1;
+        }
+        else
+        {
+            DebugP_log("Error: Invalid Factory calibration arguments\n");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int32_t factoryCal_restore(void *arg)
+{
+    return factoryCal_config((MMWave_calibCfg *)arg, false);
+}
+
+static int32_t factoryCal_calibrate(void *arg)
+{
+    DebugP_log("Running the boot calibration\r\n");
+    return factoryCal_config((MMWave_calibCfg *)arg, true);
+}
+
+static int32_t factoryCal_read(void *arg, void *record, uint32_t recordBytes)
+{
+    int32_t retVal;
+
+    (void)arg;
+    retVal = Flash_read(gFlashHandle[0], CLI_FACCALCFG_FLASH_OFFSET, (uint8_t *) record, recordBytes);
+    CacheP_wb((uint8_t *) record, recordBytes, CacheP_TYPE_ALL);
+
+    if(retVal == SystemP_FAILURE)
+    {
+        DebugP_log("Could not read from Flash to restore Calibration data!");
+        return -1;
+    }
+    return 0;
+}
+
+static int32_t factoryCal_write(void *arg, const void *record, uint32_t recordBytes)
+{
+    uint32_t    blk, page;
+    uint32_t    blkStart, blkSize;
+    int32_t     preserveBlob;
+    ProfileBlob blob;
+
+    (void)arg;
+    if (Flash_offsetToBlkPage(gFlashHandle[0], CLI_FACCALCFG_FLASH_OFFSET, &blk, &page) != SystemP_SUCCESS)
+    {
+        return -1;
+    }
+
+    /* the erase block may hold the profile blob as well (depends on the flash device) */
+    blkSize      = Flash_getAttrs(CONFIG_FLASH0)->blockSize;
+    blkStart     = blk * blkSize;
+    preserveBlob = (PROFILE_BLOB_FLASH_OFFSET >= blkStart) && (PROFILE_BLOB_FLASH_OFFSET < blkStart + blkSize);
+    if (preserveBlob &&
+        (Flash_read(gFlashHandle[0], PROFILE_BLOB_FLASH_OFFSET, (uint8_t *) &blob, sizeof(ProfileBlob)) != SystemP_SUCCESS))
+    {
+        return -1;
+    }
+
+    if (Flash_eraseBlk(gFlashHandle[0], blk) != SystemP_SUCCESS)
+    {
+        DebugP_log("Error: could not erase the factory calibration block\r\n");
+        return -1;
+    }
+    if (preserveBlob && (ProfileBlob_check(&blob) != PROFILE_BLOB_ERR_EMPTY) &&
+        (Flash_write(gFlashHandle[0], PROFILE_BLOB_FLASH_OFFSET, (uint8_t *) &blob, sizeof(ProfileBlob)) != SystemP_SUCCESS))
+    {
+        DebugP_log("Error: could not restore the profile blob\r\n");
+        return -1;
+    }
+    if (Flash_write(gFlashHandle[0], CLI_FACCALCFG_FLASH_OFFSET, (uint8_t *) record, recordBytes) != SystemP_SUCCESS)
+    {
+        DebugP_log("Error: could not write the factory calibration\r\n");
+        return -1;
+    }
+    return 0;
+}
+
+int32_t restoreFactoryCal(void)
+{
+    uint16_t         calRfFreq = 0U;
+    MMWave_calibCfg  factoryCalCfg = {0U};
+    CalStore_Ops     ops;
+    uint32_t         flags = 0U;
+    int32_t          result;
 
     /*
     * @brief  FECSS RFS Boot calibration control:
@@ -101,7 +205,7 @@ int32_t restoreFactoryCal(void)
 
     /* Calculate Calibration Rf Frequency. Use Center frequency of the bandwidth(being used in demo) for calibration */
     calRfFreq = (gSysContext.profileTimeCfg.w_ChirpRfFreqStart) + \
-                ((((CLI_CHIRP_SLOPE * 256.0)/300) * (gSysContext.profileComCfg.h_ChirpRampEndTime * 0.1)) / 2);
+                ((((gSysContext.bootProfile.chirpTimingCfg.chirpRfFreqSlope * 256.0)/300) * (gSysContext.profileComCfg.h_ChirpRampEndTime * 0.1)) / 2);
     factoryCalCfg.fecRFFactoryCalCmd.xh_CalRfSlope = 0x4Du; /* 2.2Mhz per uSec*/
 
 
@@ -125,49 +229,52 @@ int32_t restoreFactoryCal(void)
     factoryCalCfg.ptrAteCalibration = NULL;
     factoryCalCfg.isATECalibEfused  = true;
 
-    /* Read flash memory */
-    retVal = Flash_read(gFlashHandle[0], CLI_FACCALCFG_FLASH_OFFSET, (uint8_t *) &calibData, sizeof(Mmw_calibData));
-    CacheP_wb((uint8_t *) &calibData, sizeof(Mmw_calibData), CacheP_TYPE_ALL);
+    ops.read      = factoryCal_read;
+    ops.write     = factoryCal_write;
+    ops.restore   = factoryCal_restore;
+    ops.calibrate = factoryCal_calibrate;
+    ops.arg       = &factoryCalCfg;
 
-    if(retVal == SystemP_FAILURE)
+    /* the record was retained in RAM on a warm boot (checked by mmwave_checkWarmStart()) */
+    if (gSysContext.warmStart != 0U)
     {
-        DebugP_log("Could not read from Flash to restore Calibration data!");
-        return -1;
+        flags |= CAL_STORE_FLAG_RETAINED;
     }
+#if FACTORY_CAL_GENERATE_ENABLE
+    flags |= CAL_STORE_FLAG_GENERATE;
+#endif
 
-    /* Validate Calib data Magic number */
-    if(calibData.magic != MMWDEMO_CALIB_STORE_MAGIC)
+    result = CalStore_run(&calibData, sizeof(Mmw_calibData), MMWDEMO_CALIB_STORE_MAGIC, flags, &ops);
+    if (result == CAL_STORE_ERR_NO_RECORD)
     {
         /* Header validation failed */
         DebugP_log("Error: MmwDemo Factory calibration data header validation failed.\r\n");
         return -1;
     }
-
-    /* Populate calibration data pointer. */
-    factoryCalCfg.ptrFactoryCalibData = &calibData.calibData;
-
-    /* Disable factory calibration. */
-    factoryCalCfg.isFactoryCalEnabled = false;
-
-    retVal = MMWave_factoryCalibConfig(gSysContext.gCtrlHandle, &factoryCalCfg, &errCode);
-    if (retVal != SystemP_SUCCESS)
+    if (result == CAL_STORE_ERR_RESTORE)
     {
-
-        /* Error: Unable to perform boot calibration */
-        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
-
-        /* Error: Unable to initialize the mmWave control module */
-        DebugP_log("Error: mmWave Control Initialization failed [Error code %d] [errorLevel %d] [mmWaveErrorCode %d] [subsysErrorCode %d]\n", errCode, errorLevel, mmWaveErrorCode, subsysErrorCode);
-        if (mmWaveErrorCode == MMWAVE_ERFSBOOTCAL)
-        {
-            DebugP_log("Error: Factory Calibration failure\n");
-            return -1;
-        }
-        else
-        {
-            DebugP_log("Error: Invalid Factory calibration arguments\n");
-            return -1;
-        }
+        DebugP_log("Error: factory calibration in flash rejected, it is kept for the next boot\r\n");
+        return -1;
+    }
+    if (result == CAL_STORE_ERR_CALIB)
+    {
+        return -1;
+    }
+    if (result == CAL_STORE_CALIBRATED_RAM)
+    {
+        DebugP_log("Error: factory calibration in flash rejected, running calibrated from RAM, flash kept\r\n");
+    }
+    if (result == CAL_STORE_RESTORED_LEGACY)
+    {
+        DebugP_log("Factory calibration restored from a record of the demo format\r\n");
+    }
+    if (result == CAL_STORE_ERR_SAVE)
+    {
+        DebugP_log("Error: factory calibration could not be saved, it is repeated at the next boot\r\n");
+    }
+    if (result == CAL_STORE_GENERATED)
+    {
+        DebugP_log("Factory calibration saved to flash\r\n");
     }
 
     /* Configuring command for Run time CLPC calibration (Required if CLPC calib is enabled) */
@@ -179,5 +286,5 @@ int32_t restoreFactoryCal(void)
     gSysContext.fecTxclpcCalCmd.c_TxPwrCalTxEnaMask[0] = factoryCalCfg.fecRFFactoryCalCmd.c_TxPwrCalTxEnaMask[0];
     gSysContext.fecTxclpcCalCmd.c_TxPwrCalTxEnaMask[1] = factoryCalCfg.fecRFFactoryCalCmd.c_TxPwrCalTxEnaMask[1];
 
-    return retVal;
+    return SystemP_SUCCESS;
 }
\ No newline at end of file
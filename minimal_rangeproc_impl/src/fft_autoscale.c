@@ -0,0 +1,81 @@
+/**
+ * @file fft_autoscale.c
+ * @brief Closed-loop scaling of the range FFT output.
+ *
+ * Increasing the shift reacts within one frame to avoid clipping strong near
+ * range reflectors, decreasing it is delayed by framesDown frames so that the
+ * shift does not toggle on scenes whose peak is close to the threshold.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fft_autoscale.h"
+
+
+void FftAutoScale_init(const FftAutoScale_Config *cfg, FftAutoScale_State *state, uint8_t initialShift) {
+    if (initialShift < cfg->minShift) {
+        initialShift = cfg->minShift;
+    }
+    if (initialShift > cfg->maxShift) {
+        initialShift = cfg->maxShift;
+    }
+
+    state->shift         = initialShift;
+    state->lowFrameCount = 0;
+}
+
+void FftAutoScale_computeStats(const int16_t *cube, uint32_t numValues, uint16_t satThreshold,
+                               FftAutoScale_Stats *stats) {
+    uint32_t peak = 0;
+    uint32_t numSaturated = 0;
+    uint32_t i;
+
+    for (i = 0; i < numValues; i++) {
+        int32_t  v = cube[i];
+        uint32_t a = (v < 0) ? (uint32_t)(-v) : (uint32_t)v;
+
+        peak = (a > peak) ? a : peak;
+        numSaturated += (a >= satThreshold) ? 1U : 0U;
+    }
+
+    // -32768 has no positive int16 counterpart
+    stats->peak         = (peak > 0xFFFFU) ? 0xFFFFU : (uint16_t)peak;
+    stats->reserved     = 0;
+    stats->numSaturated = numSaturated;
+}
+
+int32_t FftAutoScale_update(const FftAutoScale_Config *cfg, FftAutoScale_State *state,
+                            const FftAutoScale_Stats *stats) {
+    uint8_t prevShift = state->shift;
+
+    if (stats->numSaturated >= cfg->satCountUp) {
+        // clipping: scale down more, starting with the next frame
+        state->lowFrameCount = 0;
+        if (state->shift < cfg->maxShift) {
+            state->shift++;
+        }
+    } else if (stats->peak < cfg->headroomLow) {
+        // at least one bit unused: scale down less after framesDown frames
+        state->lowFrameCount++;
+        if ((state->lowFrameCount >= cfg->framesDown) && (state->shift > cfg->minShift)) {
+            state->shift--;
+            state->lowFrameCount = 0;
+        }
+    } else {
+        state->lowFrameCount = 0;
+    }
+
+    return (state->shift != prevShift) ? 1 : 0;
+}
+
+void FftAutoScale_splitShift(const FftAutoScale_Config *cfg, uint8_t shift,
+                             uint8_t *divShift, uint8_t *numButterflyStages) {
+    if (shift > cfg->maxDivShift) {
+        *divShift           = cfg->maxDivShift;
+        *numButterflyStages = (uint8_t)(shift - cfg->maxDivShift);
+    } else {
+        *divShift           = shift;
+        *numButterflyStages = 0;
+    }
+}
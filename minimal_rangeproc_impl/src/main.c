@@ -73,6 +73,8 @@
 #include "mmwave_control_config.h"
 #include "factory_cal.h"
 
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
 
 // --- FRERTOS
 //#define MAIN_TASK_PRI  (configMAX_PRIORITIES-1)
@@ -113,7 +115,19 @@ uint32_t gpioBaseAddrLed, pinNumLed;
 
 void rangeproc_main(void *args);
 
+/**
+ * @brief Closes a boot phase of gSysContext.bootReport at the current frame reference timer value.
+ */
+static void bootPhaseDone(BootReport_Phase phase) {
+    BootReport_mark(&gSysContext.bootReport, phase, Cycleprofiler_getTimeStamp());
+}
+
 void freertos_main(void *args) {
+    uint32_t phase;
+
+    // benchmark: boot phases (40 MHz ticks) up to the first frame on the wire, see boot_report.h
+    BootReport_init(&gSysContext.bootReport, Cycleprofiler_getTimeStamp());
+
     /*** INIT ***/
     /* Peripheral Driver Initialization */
     Drivers_open();
@@ -130,6 +144,7 @@ void freertos_main(void *args) {
 
     SemaphoreP_constructBinary(&spi_tx_start_sem, 0);
     SemaphoreP_constructBinary(&spi_tx_done_sem, 0);
+    bootPhaseDone(BOOT_PHASE_DRIVERS);
     
     // Mmwave_HwaConfig_custom();
     /* The following function call and comment is copied from the motion and presence detection demo (motion_detect.c motion_detect()) */
@@ -147,12 +162,20 @@ void freertos_main(void *args) {
 
     // initialize memory segments from memory pools
     mempool_init();
+    bootPhaseDone(BOOT_PHASE_MEM_INIT);
+
+    // warm boot if the state of the previous boot was retained, then the chirp profile (RAM, flash blob or defines.h)
+    mmwave_checkWarmStart();
+    mmwave_loadBootProfile();
+    BootReport_setBoot(&gSysContext.bootReport, gSysContext.warmStart, gSysContext.numBoots);
+    bootPhaseDone(BOOT_PHASE_PROFILE);
 
     // TODO: initialize default antenna geometry
     
     if (mmwave_initSensor() == SystemP_FAILURE) {
         exit(1);
     }
+    bootPhaseDone(BOOT_PHASE_SENSOR_INIT);
 
     if (hwa_open_handler() == SystemP_FAILURE) {
         exit(1);
@@ -162,6 +185,7 @@ void freertos_main(void *args) {
     rangeProc_dpuInit();
     // TODO: init rest of DPUs as required
     DebugP_log("init passed");
+    bootPhaseDone(BOOT_PHASE_HWA_OPEN);
 
     MMWave_populateChannelCfg();
 
@@ -180,15 +204,18 @@ void freertos_main(void *args) {
         DebugP_log("Error: Device is not RF-Trimmed!\r\n");
         exit(1);
     }
+    bootPhaseDone(BOOT_PHASE_RF_POWER);
 
     /*** CONFIG ***/
     // TODO: factory calibration (mmwDemo_factoryCal()) 
     if(mmwave_openSensor() == SystemP_FAILURE){
         exit(1);
     }
+    bootPhaseDone(BOOT_PHASE_OPEN);
     if(mmwave_configSensor() == SystemP_FAILURE){
         exit(1);
     }
+    bootPhaseDone(BOOT_PHASE_CONFIG);
 
     // /* Perform factory Calibrations. */
     retVal = restoreFactoryCal();
@@ -197,6 +224,7 @@ void freertos_main(void *args) {
         DebugP_log("Error: mmWave factory calibration failed\r\n");
         retVal = SystemP_FAILURE;
     }
+    bootPhaseDone(BOOT_PHASE_CALIBRATION);
 
     gDpcTask = xTaskCreateStatic(dpcTask, /* Pointer to the function that implements the task. */
                                  "dpc_task",      /* Text name for the task.  This is to facilitate debugging only. */
@@ -208,6 +236,7 @@ void freertos_main(void *args) {
     configASSERT(gDpcTask != NULL);
 
     SemaphoreP_pend(&dpcCfgDoneSemHandle, SystemP_WAIT_FOREVER);
+    bootPhaseDone(BOOT_PHASE_PIPELINE);
 
     gSpiTask = xTaskCreateStatic(spiTask, /* Pointer to the function that implements the task. */
                                  "spi_task",      /* Text name for the task.  This is to facilitate debugging only. */
@@ -221,6 +250,19 @@ void freertos_main(void *args) {
     if (mmwave_startSensor() == SystemP_FAILURE){
         exit(1);
     }
+    bootPhaseDone(BOOT_PHASE_START);
+
+    // the next reset without power loss can boot warm
+    mmwave_retainState();
+
+    // the first frame is marked by the dpcTask, which logs the total
+    DebugP_log("Boot %s (%u since cold boot), timer at entry %u\r\n",
+               (gSysContext.warmStart != 0U) ? "warm" : "cold", gSysContext.numBoots,
+               gSysContext.bootReport.payload.startTicks);
+    for (phase = 0; phase <= BOOT_PHASE_START; phase++) {
+        DebugP_log("  %s: %u ticks\r\n", BootReport_phaseName((BootReport_Phase)phase),
+                   gSysContext.bootReport.payload.phaseTicks[phase]);
+    }
     
         /* Never return for this task. */
     SemaphoreP_pend(&pend_main_sem, SystemP_WAIT_FOREVER);
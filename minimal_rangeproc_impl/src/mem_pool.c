@@ -34,21 +34,29 @@
 */
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
-#include "system.h"
 #include "mem_pool.h"
 
+/*! @brief Rounds an address up to a power of 2 alignment (as MEM_ALIGN of the SDK) */
+#define MEM_POOL_ALIGN(addr, align)  (((addr) + (uintptr_t)(align) - 1U) & ~((uintptr_t)(align) - 1U))
+
 void DPC_ObjDet_MemPoolReset(MemPoolObj *pool) {
     pool->currAddr = (uintptr_t)pool->cfg.addr;
     pool->maxCurrAddr = pool->currAddr;
+    pool->numCheckpoints = 0;
+    pool->numTags = 0;
+    pool->numTagsDropped = 0;
 }
 
-static void DPC_ObjDet_MemPoolSet(MemPoolObj *pool, void *addr) {
+void DPC_ObjDet_MemPoolSet(MemPoolObj *pool, void *addr) {
     pool->currAddr = (uintptr_t)addr;
-    pool->maxCurrAddr = MAX(pool->currAddr, pool->maxCurrAddr);
+    if (pool->currAddr > pool->maxCurrAddr) {
+        pool->maxCurrAddr = pool->currAddr;
+    }
 }
 
-static void *DPC_ObjDet_MemPoolGet(MemPoolObj *pool) {
+void *DPC_ObjDet_MemPoolGet(MemPoolObj *pool) {
     return((void *)pool->currAddr);
 }
 
@@ -59,16 +67,97 @@ uint32_t DPC_ObjDet_MemPoolGetMaxUsage(MemPoolObj *pool) {
 void *DPC_ObjDet_MemPoolAlloc(MemPoolObj *pool,
                               uint32_t size,
                               uint8_t align) {
+    return DPC_ObjDet_MemPoolAllocTagged(pool, size, align, NULL);
+}
+
+void *DPC_ObjDet_MemPoolAllocTagged(MemPoolObj *pool,
+                                    uint32_t size,
+                                    uint8_t align,
+                                    const char *tag) {
     void *retAddr = NULL;
     uintptr_t addr;
 
-    addr = MEM_ALIGN(pool->currAddr, align);
+    addr = MEM_POOL_ALIGN(pool->currAddr, align);
     if ((addr + size) <= ((uintptr_t)pool->cfg.addr + pool->cfg.size))
     {
         retAddr = (void *)addr;
         pool->currAddr = addr + size;
-        pool->maxCurrAddr = MAX(pool->currAddr, pool->maxCurrAddr);
+        if (pool->currAddr > pool->maxCurrAddr) {
+            pool->maxCurrAddr = pool->currAddr;
+        }
+
+        if (tag != NULL) {
+            if (pool->numTags < MEM_POOL_MAX_TAGS) {
+                pool->tags[pool->numTags].tag  = tag;
+                pool->tags[pool->numTags].addr = addr;
+                pool->tags[pool->numTags].size = size;
+                pool->numTags++;
+            } else {
+                pool->numTagsDropped++;
+            }
+        }
     }
 
     return(retAddr);
-}
\ No newline at end of file
+}
+
+uint32_t DPC_ObjDet_MemPoolGetFree(const MemPoolObj *pool) {
+    return(pool->cfg.size - (uint32_t)(pool->currAddr - (uintptr_t)pool->cfg.addr));
+}
+
+int32_t DPC_ObjDet_MemPoolPushCheckpoint(MemPoolObj *pool, const char *name) {
+    MemPoolCheckpoint *checkpoint;
+
+    if (pool->numCheckpoints >= MEM_POOL_MAX_CHECKPOINTS) {
+        return -1;
+    }
+    checkpoint = &pool->checkpoints[pool->numCheckpoints];
+    checkpoint->name    = name;
+    checkpoint->addr    = pool->currAddr;
+    checkpoint->numTags = pool->numTags;
+    pool->numCheckpoints++;
+    return 0;
+}
+
+int32_t DPC_ObjDet_MemPoolFindCheckpoint(const MemPoolObj *pool, const char *name) {
+    uint32_t i;
+
+    for (i = pool->numCheckpoints; i > 0U; i--) {
+        if (strcmp(pool->checkpoints[i - 1U].name, name) == 0) {
+            return (int32_t)(i - 1U);
+        }
+    }
+    return -1;
+}
+
+int32_t DPC_ObjDet_MemPoolRewind(MemPoolObj *pool, const char *name) {
+    int32_t idx = DPC_ObjDet_MemPoolFindCheckpoint(pool, name);
+
+    if (idx < 0) {
+        return -1;
+    }
+    pool->currAddr       = pool->checkpoints[idx].addr;
+    pool->numTags        = pool->checkpoints[idx].numTags;
+    pool->numCheckpoints = (uint32_t)idx + 1U;
+    return 0;
+}
+
+int32_t DPC_ObjDet_MemPoolPopCheckpoint(MemPoolObj *pool, const char *name) {
+    if (DPC_ObjDet_MemPoolRewind(pool, name) != 0) {
+        return -1;
+    }
+    pool->numCheckpoints--;
+    return 0;
+}
+
+uint32_t DPC_ObjDet_MemPoolGetTagUsage(const MemPoolObj *pool, const char *tag) {
+    uint32_t i;
+    uint32_t bytes = 0;
+
+    for (i = 0; i < pool->numTags; i++) {
+        if (strcmp(pool->tags[i].tag, tag) == 0) {
+            bytes += pool->tags[i].size;
+        }
+    }
+    return bytes;
+}
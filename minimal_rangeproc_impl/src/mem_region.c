@@ -0,0 +1,149 @@
+/**
+ * @file mem_region.c
+ * @brief Placement of buffers across several on-chip memory regions.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mem_pool.h"
+#include "mem_region.h"
+
+
+void MemRegion_init(MemRegion_Map *map) {
+    memset(map, 0, sizeof(MemRegion_Map));
+}
+
+int32_t MemRegion_add(MemRegion_Map *map, const char *name, MemPoolObj *pool,
+                      uint32_t attrs, uint32_t speedRank) {
+    MemRegion_Region *region;
+
+    if ((map->numRegions >= MEM_REGION_MAX_NUM) || (pool->cfg.size == 0U)) {
+        return -1;
+    }
+    region = &map->region[map->numRegions];
+    region->name      = name;
+    region->pool      = pool;
+    region->attrs     = attrs;
+    region->speedRank = speedRank;
+    map->numRegions++;
+    return (int32_t)(map->numRegions - 1U);
+}
+
+void MemRegion_reset(MemRegion_Map *map) {
+    uint32_t i;
+
+    for (i = 0; i < map->numRegions; i++) {
+        DPC_ObjDet_MemPoolReset(map->region[i].pool);
+    }
+}
+
+/**
+ * @brief Returns whether a buffer fits into a pool at the given alignment.
+ */
+static int32_t MemRegion_fits(const MemPoolObj *pool, uint32_t size, uint8_t align) {
+    uintptr_t end  = (uintptr_t)pool->cfg.addr + pool->cfg.size;
+    uintptr_t addr = (pool->currAddr + (uintptr_t)align - 1U) & ~((uintptr_t)align - 1U);
+
+    return ((addr <= end) && (size <= (uint32_t)(end - addr))) ? 1 : 0;
+}
+
+int32_t MemRegion_select(const MemRegion_Map *map, uint32_t size, uint8_t align,
+                         uint32_t requiredAttrs, uint32_t policy) {
+    int32_t best = -1;
+    uint32_t i;
+
+    for (i = 0; i < map->numRegions; i++) {
+        const MemRegion_Region *region = &map->region[i];
+
+        if (((region->attrs & requiredAttrs) != requiredAttrs) ||
+            (MemRegion_fits(region->pool, size, align) == 0)) {
+            continue;
+        }
+        if (best < 0) {
+            best = (int32_t)i;
+            if (policy == MEM_REGION_POLICY_FIRST_FIT) {
+                break;
+            }
+        } else if (policy == MEM_REGION_POLICY_FASTEST) {
+            if (region->speedRank < map->region[best].speedRank) {
+                best = (int32_t)i;
+            }
+        } else if (policy == MEM_REGION_POLICY_LARGEST_FREE) {
+            if (DPC_ObjDet_MemPoolGetFree(region->pool) > DPC_ObjDet_MemPoolGetFree(map->region[best].pool)) {
+                best = (int32_t)i;
+            }
+        }
+    }
+    return best;
+}
+
+void *MemRegion_alloc(MemRegion_Map *map, uint32_t size, uint8_t align,
+                      uint32_t requiredAttrs, uint32_t policy, const char *tag, int32_t *regionIdx) {
+    int32_t idx = MemRegion_select(map, size, align, requiredAttrs, policy);
+    void *buf = NULL;
+
+    if (idx >= 0) {
+        buf = DPC_ObjDet_MemPoolAllocTagged(map->region[idx].pool, size, align, tag);
+    }
+    if (regionIdx != NULL) {
+        *regionIdx = idx;
+    }
+    return buf;
+}
+
+int32_t MemRegion_pushCheckpoint(MemRegion_Map *map, const char *name) {
+    uint32_t i;
+
+    for (i = 0; i < map->numRegions; i++) {
+        if (map->region[i].pool->numCheckpoints >= MEM_POOL_MAX_CHECKPOINTS) {
+            return -1;
+        }
+    }
+    for (i = 0; i < map->numRegions; i++) {
+        (void)DPC_ObjDet_MemPoolPushCheckpoint(map->region[i].pool, name);
+    }
+    return 0;
+}
+
+int32_t MemRegion_rewind(MemRegion_Map *map, const char *name) {
+    uint32_t i;
+
+    for (i = 0; i < map->numRegions; i++) {
+        if (DPC_ObjDet_MemPoolFindCheckpoint(map->region[i].pool, name) < 0) {
+            return -1;
+        }
+    }
+    for (i = 0; i < map->numRegions; i++) {
+        (void)DPC_ObjDet_MemPoolRewind(map->region[i].pool, name);
+    }
+    return 0;
+}
+
+void MemRegion_getUsage(const MemRegion_Map *map, uint32_t regionIdx, MemRegion_Usage *usage) {
+    MemPoolObj *pool = map->region[regionIdx].pool;
+
+    usage->size = pool->cfg.size;
+    usage->free = DPC_ObjDet_MemPoolGetFree(pool);
+    usage->used = usage->size - usage->free;
+    usage->peak = DPC_ObjDet_MemPoolGetMaxUsage(pool);
+}
+
+uint32_t MemRegion_getLargestFree(const MemRegion_Map *map, uint32_t requiredAttrs) {
+    uint32_t largest = 0;
+    uint32_t i;
+
+    for (i = 0; i < map->numRegions; i++) {
+        const MemRegion_Region *region = &map->region[i];
+        uint32_t freeBytes;
+
+        if ((region->attrs & requiredAttrs) != requiredAttrs) {
+            continue;
+        }
+        freeBytes = DPC_ObjDet_MemPoolGetFree(region->pool);
+        if (freeBytes > largest) {
+            largest = freeBytes;
+        }
+    }
+    return largest;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file micro_doppler.c
+ * @brief Micro-Doppler spectrogram column of a range window.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "rd_heatmap.h"
+#include "micro_doppler.h"
+
+
+uint32_t MicroDoppler_getShift(uint32_t rangeLen) {
+    uint32_t shift = 0;
+
+    while ((1UL << shift) < rangeLen) {
+        shift++;
+    }
+    return shift;
+}
+
+uint32_t MicroDoppler_getSize(uint32_t fftSize) {
+    return (uint32_t)sizeof(MicroDoppler_Header) + (((fftSize * sizeof(uint16_t)) + 3U) & ~3U);
+}
+
+uint32_t MicroDoppler_centerWindow(uint32_t centerBin, uint32_t rangeLen, uint32_t minBin, uint32_t numRangeBins) {
+    uint32_t start = (centerBin > (rangeLen / 2U)) ? (centerBin - (rangeLen / 2U)) : 0U;
+
+    if ((start + rangeLen) > numRangeBins) {
+        start = numRangeBins - rangeLen;
+    }
+    if (start < minBin) {
+        start = minBin;
+    }
+    return start;
+}
+
+void MicroDoppler_sumRows(const uint16_t *rows, uint32_t rangeLen, uint32_t fftSize, uint16_t *column) {
+    uint32_t shift = MicroDoppler_getShift(rangeLen);
+    uint32_t i, bin;
+
+    for (i = 0; i < fftSize; i++) {
+        uint32_t sum = 0;
+        for (bin = 0; bin < rangeLen; bin++) {
+            sum += rows[(bin * fftSize) + i];
+        }
+        column[i] = (uint16_t)(sum >> shift);
+    }
+}
+
+int32_t MicroDoppler_compute(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                             uint32_t rangeStart, uint32_t rangeLen, uint16_t *scratch, uint16_t *column) {
+    if ((rangeLen == 0U) || (rangeLen > MICRO_DOPPLER_MAX_RANGE_LEN)) {
+        return -1;
+    }
+    if (RdHeatmap_computeRows(cfg, cube, window, rangeStart, rangeLen, scratch) != 0) {
+        return -1;
+    }
+
+    MicroDoppler_sumRows(scratch, rangeLen, cfg->fftSize, column);
+    return 0;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file micro_doppler_proc.c
+ * @brief Micro-Doppler stage computing one spectrogram column per frame on the HWA.
+ *
+ * The stage is processed synchronously in the dpcTask, see doppler_proc.c.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/SystemP.h>
+#include <kernel/dpl/SemaphoreP.h>
+#include <utils/mathutils/mathutils.h>
+#include <drivers/edma.h>
+#include <drivers/hwa.h>
+#include "ti_drivers_config.h"
+#include "ti_drivers_open_close.h"
+
+#include "system.h"
+#include "defines.h"
+#include "dpu_res.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "rd_heatmap.h"
+#include "micro_doppler.h"
+#include "doppler_proc.h"
+#include "cfar.h"
+#include "cfar_proc.h"
+#include "micro_doppler_proc.h"
+
+#if UDOPPROC_ENABLE && UDOPPROC_TRACK_CFAR && !CFARPROC_ENABLE
+#error "UDOPPROC_TRACK_CFAR requires CFARPROC_ENABLE"
+#endif
+
+
+/**************************************************************************
+ ************************** Extern Definitions ****************************
+ **************************************************************************/
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
+
+/*! @brief Translates a CPU address within the HWA memory banks to a HWA param set address */
+#define UDOPPROC_HWA_ADDR(hwaMemBase, addr)  ((uint16_t)(((uintptr_t)(addr) - (hwaMemBase)) & 0xFFFFU))
+
+/**
+ * @brief State of the micro-Doppler stage.
+ */
+typedef struct MicroDopplerProc_Obj_t
+{
+    /*! @brief Dimensions of the Doppler FFT */
+    RdHeatmap_Config cfg;
+
+    /*! @brief First range bin of the current window */
+    uint32_t rangeStart;
+
+    /*! @brief Doppler window (first half) in core local memory */
+    int32_t *window;
+
+    /*! @brief Heatmap rows of the window in core local memory */
+    uint16_t *rows;
+
+    /*! @brief CPU address of HWA memory bank M0 (gathered input) */
+    uint8_t *hwaIn;
+
+    /*! @brief CPU address of HWA memory bank M2 (magnitudes) */
+    uint16_t *hwaOut;
+
+    /*! @brief EDMA controller base address */
+    uint32_t edmaBaseAddr;
+
+    /*! @brief EDMA region of this core */
+    uint32_t edmaRegionId;
+
+    /*! @brief Signalled by the HWA done interrupt */
+    SemaphoreP_Object hwaDoneSem;
+} MicroDopplerProc_Obj;
+
+/*! @brief Micro-Doppler stage state */
+static MicroDopplerProc_Obj gMicroDopplerProcObj;
+
+
+/**
+ * @brief HWA done interrupt callback.
+ */
+static void MicroDopplerProc_hwaDoneCallback(void *arg) {
+    SemaphoreP_post((SemaphoreP_Object *)arg);
+}
+
+/**
+ * @brief Configures the HWA param set computing the Doppler magnitudes of the window.
+ */
+static int32_t MicroDopplerProc_configParamSet(uint32_t hwaMemBase, uint32_t windowOffset) {
+    RdHeatmap_Config *cfg = &gMicroDopplerProcObj.cfg;
+    uint32_t numSeq = (uint32_t)cfg->numVirtualAntennas * UDOPPROC_RANGE_LEN;
+    HWA_ParamConfig paramCfg;
+
+    memset(&paramCfg, 0, sizeof(HWA_ParamConfig));
+    paramCfg.triggerMode = HWA_TRIG_MODE_SOFTWARE;
+    paramCfg.accelMode   = HWA_ACCELMODE_FFT;
+
+    /* input: [chirp][antenna][bin], one sequence per (antenna, bin) */
+    paramCfg.source.srcAddr        = UDOPPROC_HWA_ADDR(hwaMemBase, gMicroDopplerProcObj.hwaIn);
+    paramCfg.source.srcAcnt        = cfg->numDopplerChirps - 1U;
+    paramCfg.source.srcAIdx        = numSeq * sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcBcnt        = numSeq - 1U;
+    paramCfg.source.srcBIdx        = sizeof(cmplx16ImRe_t);
+    paramCfg.source.srcRealComplex = HWA_SAMPLES_FORMAT_COMPLEX;
+    paramCfg.source.srcWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.source.srcSign        = HWA_SAMPLES_SIGNED;
+    paramCfg.source.srcConjugate   = 0;
+    paramCfg.source.srcScale       = 0;
+
+    /* output: [antenna][bin][dopplerBin] 16-bit magnitudes */
+    paramCfg.dest.dstAddr        = UDOPPROC_HWA_ADDR(hwaMemBase, gMicroDopplerProcObj.hwaOut);
+    paramCfg.dest.dstAcnt        = cfg->fftSize - 1U;
+    paramCfg.dest.dstAIdx        = sizeof(uint16_t);
+    paramCfg.dest.dstBIdx        = cfg->fftSize * sizeof(uint16_t);
+    paramCfg.dest.dstRealComplex = HWA_SAMPLES_FORMAT_REAL;
+    paramCfg.dest.dstWidth       = HWA_SAMPLES_WIDTH_16BIT;
+    paramCfg.dest.dstSign        = HWA_SAMPLES_UNSIGNED;
+    paramCfg.dest.dstConjugate   = 0;
+    paramCfg.dest.dstScale       = 0;
+
+    /* all butterfly stages scaled, as in the Doppler stage */
+    paramCfg.accelModeArgs.fftMode.fftEn              = 1;
+    paramCfg.accelModeArgs.fftMode.fftSize            = mathUtils_ceilLog2(cfg->fftSize);
+    paramCfg.accelModeArgs.fftMode.butterflyScaling   = cfg->fftSize - 1U;
+    paramCfg.accelModeArgs.fftMode.windowEn           = 1;
+    paramCfg.accelModeArgs.fftMode.windowStart        = windowOffset;
+    paramCfg.accelModeArgs.fftMode.winSymm            = HWA_FFT_WINDOW_SYMMETRIC;
+    paramCfg.accelModeArgs.fftMode.winInterpolateMode = 0;
+    paramCfg.accelModeArgs.fftMode.magLogEn           = HWA_FFT_MODE_MAGNITUDE_ONLY_ENABLED;
+    paramCfg.accelModeArgs.fftMode.fftOutMode         = HWA_FFT_MODE_OUTPUT_DEFAULT;
+    paramCfg.complexMultiply.mode                     = HWA_COMPLEX_MULTIPLY_MODE_DISABLE;
+
+    return HWA_configParamSet(gSysContext.hwaHandle, UDOPPROC_HWA_PARAMSET_IDX, &paramCfg, NULL);
+}
+
+/**
+ * @brief Gathers the samples of the current range window into HWA memory.
+ */
+static void MicroDopplerProc_gather(void) {
+    RdHeatmap_Config *cfg = &gMicroDopplerProcObj.cfg;
+    const cmplx16ImRe_t *cube = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+    uint32_t tcc = DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_CH;
+    EDMACCPaRAMEntry edmaParam;
+
+    EDMA_ccPaRAMEntry_init(&edmaParam);
+    edmaParam.srcAddr    = (uint32_t)SOC_virtToPhy((void *)&cube[gMicroDopplerProcObj.rangeStart]);
+    edmaParam.destAddr   = (uint32_t)SOC_virtToPhy(gMicroDopplerProcObj.hwaIn);
+    edmaParam.aCnt       = (uint16_t)(UDOPPROC_RANGE_LEN * sizeof(cmplx16ImRe_t));
+    edmaParam.bCnt       = (uint16_t)((uint32_t)cfg->numVirtualAntennas * cfg->numDopplerChirps);
+    edmaParam.cCnt       = 1;
+    edmaParam.bCntReload = 0;
+    edmaParam.srcBIdx    = (int16_t)(cfg->numRangeBins * sizeof(cmplx16ImRe_t));
+    edmaParam.destBIdx   = (int16_t)edmaParam.aCnt;
+    edmaParam.srcCIdx    = 0;
+    edmaParam.destCIdx   = 0;
+    edmaParam.linkAddr   = 0xFFFFU;
+    edmaParam.opt        = EDMA_OPT_TCINTEN_MASK | EDMA_OPT_SYNCDIM_MASK |
+                           ((tcc << EDMA_OPT_TCC_SHIFT) & EDMA_OPT_TCC_MASK);
+
+    EDMA_setPaRAM(gMicroDopplerProcObj.edmaBaseAddr, DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_SHADOW, &edmaParam);
+    EDMA_enableTransferRegion(gMicroDopplerProcObj.edmaBaseAddr, gMicroDopplerProcObj.edmaRegionId,
+                              DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_CH, EDMA_TRIG_MODE_MANUAL);
+
+    while (EDMA_readIntrStatusRegion(gMicroDopplerProcObj.edmaBaseAddr, gMicroDopplerProcObj.edmaRegionId, tcc) != 1U) {
+    }
+    EDMA_clrIntrRegion(gMicroDopplerProcObj.edmaBaseAddr, gMicroDopplerProcObj.edmaRegionId, tcc);
+}
+
+#if UDOPPROC_TRACK_CFAR
+/**
+ * @brief Centres the range window on the strongest CFAR detection of the frame.
+ *
+ * @return 1 if the window follows a detection, 0 if it is kept
+ */
+static uint32_t MicroDopplerProc_track(void) {
+    const Cfar_Header    *cfarHdr = (const Cfar_Header *)gSysContext.cfarDetList;
+    const Cfar_Detection *det     = (const Cfar_Detection *)(cfarHdr + 1);
+    uint32_t best = 0;
+    uint32_t i;
+
+    if (cfarHdr->numDetections == 0U) {
+        return 0;
+    }
+    for (i = 1; i < cfarHdr->numDetections; i++) {
+        if (det[i].level > det[best].level) {
+            best = i;
+        }
+    }
+
+    gMicroDopplerProcObj.rangeStart = MicroDoppler_centerWindow(det[best].rangeIdx, UDOPPROC_RANGE_LEN,
+                                                                CFARPROC_MIN_RANGE_BIN,
+                                                                gMicroDopplerProcObj.cfg.numRangeBins);
+    return 1;
+}
+#endif
+
+int32_t MicroDopplerProc_config(void) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    RdHeatmap_Config *cfg = &gMicroDopplerProcObj.cfg;
+    HWA_MemInfo hwaMemInfo;
+    uint32_t windowSize;
+    uint32_t windowOffset;
+    int32_t retVal;
+
+    memset(&gMicroDopplerProcObj, 0, sizeof(MicroDopplerProc_Obj));
+
+    cfg->numRangeBins       = params->numRangeBins;
+    cfg->numVirtualAntennas = params->numVirtualAntennas;
+    cfg->numDopplerChirps   = params->numDopplerChirpsPerFrame;
+    cfg->fftSize            = mathUtils_pow2roundup(params->numDopplerChirpsPerFrame);
+    gMicroDopplerProcObj.rangeStart = UDOPPROC_RANGE_START;
+
+    if ((UDOPPROC_RANGE_LEN == 0U) || (UDOPPROC_RANGE_LEN > MICRO_DOPPLER_MAX_RANGE_LEN) ||
+        ((UDOPPROC_RANGE_START + UDOPPROC_RANGE_LEN) > cfg->numRangeBins)) {
+        DebugP_log("Error: invalid micro-Doppler range window\r\n");
+        return SystemP_FAILURE;
+    }
+
+    retVal = HWA_getHWAMemInfo(gSysContext.hwaHandle, &hwaMemInfo);
+    if (retVal != 0) {
+        DebugP_log("Error: HWA memory info not available (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+    if ((UDOPPROC_RANGE_LEN * (uint32_t)cfg->numVirtualAntennas *
+         MAX(cfg->numDopplerChirps * sizeof(cmplx16ImRe_t), cfg->fftSize * sizeof(uint16_t))) > hwaMemInfo.bankSize) {
+        DebugP_log("Error: micro-Doppler range window does not fit into a HWA memory bank\r\n");
+        return SystemP_FAILURE;
+    }
+    gMicroDopplerProcObj.hwaIn  = (uint8_t *)hwaMemInfo.baseAddress;
+    gMicroDopplerProcObj.hwaOut = (uint16_t *)(hwaMemInfo.baseAddress + (2U * hwaMemInfo.bankSize));
+
+    /* header and column in the shared memory, heatmap rows of the window in core local memory */
+    gSysContext.microDoppler = MemRegion_alloc(&gSysContext.memRegions,
+                                               MicroDoppler_getSize(cfg->fftSize),
+                                               sizeof(uint32_t),
+                                               MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                               MEM_REGION_POLICY_LARGEST_FREE,
+                                               "microDoppler",
+                                               NULL);
+    gMicroDopplerProcObj.rows = (uint16_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                          UDOPPROC_RANGE_LEN * cfg->fftSize * sizeof(uint16_t),
+                                                                          sizeof(uint32_t),
+                                                                          "microDoppler");
+    if ((gSysContext.microDoppler == NULL) || (gMicroDopplerProcObj.rows == NULL)) {
+        DebugP_log("Error: not enough memory for the micro-Doppler column\r\n");
+        return SystemP_FAILURE;
+    }
+    /* the dimensions in the header are valid from here on, they size the SPI buffer */
+    memset(gSysContext.microDoppler, 0, MicroDoppler_getSize(cfg->fftSize));
+    ((MicroDoppler_Header *)gSysContext.microDoppler)->numDopplerBins = cfg->fftSize;
+
+    /* symmetric window, stored in the window RAM after the range and Doppler windows */
+    windowSize = sizeof(uint32_t) * ((cfg->numDopplerChirps + 1U) / 2U);
+    gMicroDopplerProcObj.window = (int32_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                           windowSize,
+                                                                           sizeof(uint32_t),
+                                                                           "microDoppler");
+    if (gMicroDopplerProcObj.window == NULL) {
+        DebugP_log("Error: not enough core local memory for the micro-Doppler window\r\n");
+        return SystemP_FAILURE;
+    }
+    mathUtils_genWindow((uint32_t *)gMicroDopplerProcObj.window,
+                        cfg->numDopplerChirps,
+                        windowSize / sizeof(uint32_t),
+                        UDOPPROC_WINDOW_TYPE,
+                        DPC_OBJDET_QFORMAT_DOPPLER_FFT);
+
+    windowOffset = gSysContext.rangeProcDpuCfg.hwRes.hwaCfg.hwaWinRamOffset +
+                   (params->windowSize / sizeof(uint32_t)) + (windowSize / sizeof(uint32_t));
+    retVal = HWA_configRam(gSysContext.hwaHandle, HWA_RAM_TYPE_WINDOW_RAM,
+                           (uint8_t *)gMicroDopplerProcObj.window, windowSize,
+                           windowOffset * sizeof(uint32_t));
+    if (retVal != 0) {
+        DebugP_log("Error: micro-Doppler window RAM configuration failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    retVal = MicroDopplerProc_configParamSet(hwaMemInfo.baseAddress, windowOffset);
+    if (retVal != 0) {
+        DebugP_log("Error: micro-Doppler HWA param set configuration failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    /* manually triggered gather transfer */
+    gMicroDopplerProcObj.edmaBaseAddr = EDMA_getBaseAddr(gEdmaHandle[0]);
+    gMicroDopplerProcObj.edmaRegionId = EDMA_getRegionId(gEdmaHandle[0]);
+    EDMA_configureChannelRegion(gMicroDopplerProcObj.edmaBaseAddr, gMicroDopplerProcObj.edmaRegionId,
+                                EDMA_CHANNEL_TYPE_DMA,
+                                DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_CH,
+                                DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_CH,
+                                DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_SHADOW,
+                                DPC_OBJDET_DPU_UDOP_PROC_EDMAIN_EVENT_QUE);
+
+    if (SemaphoreP_constructBinary(&gMicroDopplerProcObj.hwaDoneSem, 0) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    return SystemP_SUCCESS;
+}
+
+int32_t MicroDopplerProc_process(void) {
+    RdHeatmap_Config *cfg = &gMicroDopplerProcObj.cfg;
+    MicroDoppler_Header *hdr = (MicroDoppler_Header *)gSysContext.microDoppler;
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    uint32_t tracked = 0;
+    HWA_CommonConfig hwaCommonCfg;
+    int32_t retVal;
+
+#if UDOPPROC_TRACK_CFAR
+    tracked = MicroDopplerProc_track();
+#endif
+
+    MicroDopplerProc_gather();
+
+    /* the HWA is shared with the range DPU, which reprograms the common config on its trigger */
+    memset(&hwaCommonCfg, 0, sizeof(HWA_CommonConfig));
+    hwaCommonCfg.configMask = HWA_COMMONCONFIG_MASK_NUMLOOPS |
+                              HWA_COMMONCONFIG_MASK_PARAMSTARTIDX |
+                              HWA_COMMONCONFIG_MASK_PARAMSTOPIDX |
+                              HWA_COMMONCONFIG_MASK_FFT1DENABLE |
+                              HWA_COMMONCONFIG_MASK_INTERFERENCETHRESHOLD;
+    hwaCommonCfg.numLoops      = 1;
+    hwaCommonCfg.paramStartIdx = UDOPPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.paramStopIdx  = UDOPPROC_HWA_PARAMSET_IDX;
+    hwaCommonCfg.fftConfig.fft1DEnable           = HWA_FEATURE_BIT_DISABLE;
+    hwaCommonCfg.fftConfig.interferenceThreshold = 0xFFFFFF;
+
+    retVal = HWA_configCommon(gSysContext.hwaHandle, &hwaCommonCfg);
+    if (retVal == 0) {
+        retVal = HWA_enableDoneInterrupt(gSysContext.hwaHandle, MicroDopplerProc_hwaDoneCallback,
+                                         &gMicroDopplerProcObj.hwaDoneSem);
+    }
+    if (retVal == 0) {
+        retVal = HWA_enable(gSysContext.hwaHandle, 1);
+    }
+    if (retVal == 0) {
+        retVal = HWA_setSoftwareTrigger(gSysContext.hwaHandle);
+    }
+    if (retVal != 0) {
+        DebugP_log("Error: micro-Doppler HWA pass failed (%d)\r\n", retVal);
+        return SystemP_FAILURE;
+    }
+
+    SemaphoreP_pend(&gMicroDopplerProcObj.hwaDoneSem, SystemP_WAIT_FOREVER);
+    HWA_disableDoneInterrupt(gSysContext.hwaHandle);
+    HWA_enable(gSysContext.hwaHandle, 0);
+
+    RdHeatmap_sumAntennas(gMicroDopplerProcObj.hwaOut, UDOPPROC_RANGE_LEN, cfg, gMicroDopplerProcObj.rows);
+    MicroDoppler_sumRows(gMicroDopplerProcObj.rows, UDOPPROC_RANGE_LEN, cfg->fftSize, (uint16_t *)(hdr + 1));
+
+    hdr->rangeStart     = (uint16_t)gMicroDopplerProcObj.rangeStart;
+    hdr->rangeLen       = UDOPPROC_RANGE_LEN;
+    hdr->shift          = (uint8_t)MicroDoppler_getShift(UDOPPROC_RANGE_LEN);
+    hdr->numDopplerBins = cfg->fftSize;
+    hdr->tracked        = (uint8_t)tracked;
+    hdr->reserved       = 0;
+    hdr->computeTicks   = Cycleprofiler_getTimeStamp() - startTicks;
+
+    return SystemP_SUCCESS;
+}
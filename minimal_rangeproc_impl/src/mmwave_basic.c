@@ -50,12 +50,20 @@
 #include "ti_drivers_open_close.h"
 #include "ti_board_open_close.h"
 #include <control/mmwave/mmwave.h>
+#include <board/flash.h>
 #include <string.h>
 
 #include "system.h"
 #include "defines.h"
 #include "mem_pool.h"
+#include "mem_region.h"
 #include "mmwave_basic.h"
+#include "budget_limits.h"
+#include "budget.h"
+#include "profile_blob.h"
+#include "warm_start.h"
+#include "factory_cal.h"
+#include "rangeproc_dpc.h"
 
 
 
@@ -66,22 +74,46 @@ extern void Mmwave_populateDefaultOpenCfg (MMWave_OpenCfg* ptrOpenCfg);
 extern void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg);
 extern void Mmwave_populateDefaultCalibrationCfg (MMWave_CalibrationCfg* ptrCalibrationCfg);
 extern void Mmwave_populateDefaultStartCfg (MMWave_StrtCfg* ptrStartCfg);
+extern void Mmwave_selectSubFrameCfg (MMWave_CtrlCfg* ptrCtrlCfg, uint32_t subFrameIdx);
+extern int32_t Mmwave_applyProfileCfg (MMWave_CtrlCfg* ptrCtrlCfg, const ConfigCmd_Profile* ptrProfile);
+extern void Mmwave_getDefaultProfile (ConfigCmd_Profile* ptrProfile);
+
+#if MMWAVE_PROFILE_BLOB_ENABLE && SUBFRAME_ENABLE
+#error "MMWAVE_PROFILE_BLOB_ENABLE replaces the profile of defines.h and does not support SUBFRAME_ENABLE"
+#endif
+
+#if MMWAVE_PROFILE_BLOB_ENABLE
+/*! @brief Profile blob read from flash */
+static ProfileBlob gProfileBlob __attribute__((aligned(8)));
+#endif
+
+/*! @brief State retained across resets (not initialized at boot, see linker.cmd) */
+WarmStart_State gWarmStartState __attribute__((aligned(8), section(".retained")));
+
+/*! @brief Factory calibration data, retained together with gWarmStartState (factory_cal.c) */
+extern Mmw_calibData calibData;
 
 
 /*! 
- * @brief L3 RAM buffer for object detection DPC.
+ * @brief L3 RAM buffer for object detection DPC (L3_MEM_SIZE, see budget_limits.h).
  * 
  */
-#define L3_MEM_SIZE (0x40000 + 160*1024)
 uint8_t gMmwL3[L3_MEM_SIZE]  __attribute((section(".l3")));
 
 /*! 
  * @brief Local RAM buffer for object detection DPC.
  * 
  */
-#define MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE ((8U+6U+4U+2U+8U) * 1024U)
 uint8_t gMmwCoreLocMem[MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE];
 
+#if MMWAVE_FECSS_SHRAM_POOL_ENABLE
+/*! 
+ * @brief FECSS part of the shared memory, behind the L3 buffer in HWASS_SHM_MEM (see linker.cmd).
+ * 
+ */
+uint8_t gMmwFecssShram[FECSS_SHRAM_MEM_SIZE]  __attribute((section(".fecss_shram")));
+#endif
+
 
 void mempool_init(void) {
     /* Shared memory pool for rangeproc DPU (window)*/
@@ -91,6 +123,18 @@ void mempool_init(void) {
         /* Local memory pool */
     gSysContext.CoreLocalRamObj.cfg.addr = (void *)&gMmwCoreLocMem[0];
     gSysContext.CoreLocalRamObj.cfg.size = sizeof(gMmwCoreLocMem);
+
+    /* region map: the core local RAM is the fastest for the CPU but only the shared memory is used by HWA and EDMA */
+    MemRegion_init(&gSysContext.memRegions);
+    (void)MemRegion_add(&gSysContext.memRegions, "Core local", &gSysContext.CoreLocalRamObj, 0U, 0U);
+    (void)MemRegion_add(&gSysContext.memRegions, "L3", &gSysContext.L3RamObj,
+                        MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA, 1U);
+#if MMWAVE_FECSS_SHRAM_POOL_ENABLE
+    gSysContext.FecssShramObj.cfg.addr = (void *)&gMmwFecssShram[0];
+    gSysContext.FecssShramObj.cfg.size = sizeof(gMmwFecssShram);
+    (void)MemRegion_add(&gSysContext.memRegions, "FECSS SHRAM", &gSysContext.FecssShramObj,
+                        MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA, 1U);
+#endif
 }
 
 int32_t hwa_open_handler() {
@@ -118,10 +162,16 @@ int32_t mmwave_initSensor() {
     /* Initialize the mmWave control init configuration */
     memset ((void*)&initCfg, 0, sizeof(MMWave_InitCfg));
 
-    initCfg.iswarmstart = false;
+    initCfg.iswarmstart = (gSysContext.warmStart != 0U);
 
     /* Initialize and setup the mmWave Control module */
     gSysContext.gCtrlHandle = MMWave_init(&initCfg, &errCode);
+    if ((gSysContext.gCtrlHandle == NULL) && initCfg.iswarmstart) {
+        /* the front end did not keep its state, the retained profile and calibration are still valid */
+        DebugP_log("Warm mmWave init failed [Error code %d], retrying cold\n", errCode);
+        initCfg.iswarmstart = false;
+        gSysContext.gCtrlHandle = MMWave_init(&initCfg, &errCode);
+    }
     if (gSysContext.gCtrlHandle == NULL) {
         /* Error: Unable to initialize the mmWave control module */
         MMWave_decodeError(errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
@@ -155,12 +205,101 @@ int32_t mmwave_openSensor(void) {
     return retVal;
 }
 
+void mmwave_checkWarmStart(void) {
+    gSysContext.warmStart = 0U;
+    gSysContext.numBoots  = 1U;
+
+#if MMWAVE_WARM_START_ENABLE
+    if (WarmStart_isValid(&gWarmStartState, &calibData, sizeof(Mmw_calibData)) != 0) {
+        gSysContext.warmStart = 1U;
+        gSysContext.numBoots  = gWarmStartState.numBoots + 1U;
+    }
+#endif
+
+    /* a reset before the sensor runs again leads to a cold boot */
+    WarmStart_invalidate(&gWarmStartState);
+}
+
+void mmwave_retainState(void) {
+#if MMWAVE_WARM_START_ENABLE
+    /* only a calibration which is also in flash (restored or saved) can be reused */
+    if (CalStore_isValid(&calibData, sizeof(Mmw_calibData), MMWDEMO_CALIB_STORE_MAGIC) == 0) {
+        return;
+    }
+    WarmStart_seal(&gWarmStartState, gSysContext.numBoots, &gSysContext.bootProfile,
+                   gSysContext.bootProfileSource, &calibData, sizeof(Mmw_calibData));
+#endif
+}
+
+void mmwave_loadBootProfile(void) {
+    if (gSysContext.warmStart != 0U) {
+        /* checked by mmwave_checkWarmStart(), no flash access */
+        gSysContext.bootProfile       = gWarmStartState.profile;
+        gSysContext.bootProfileSource = gWarmStartState.profileSource;
+        return;
+    }
+
+    Mmwave_getDefaultProfile (&gSysContext.bootProfile);
+    gSysContext.bootProfileSource = PROFILE_BLOB_SOURCE_DEFAULT;
+
+#if MMWAVE_PROFILE_BLOB_ENABLE
+    {
+        ConfigCmd_Limits    limits;
+        int32_t             result;
+
+        if (Flash_read(gFlashHandle[0], PROFILE_BLOB_FLASH_OFFSET, (uint8_t *)&gProfileBlob, sizeof(ProfileBlob)) != SystemP_SUCCESS) {
+            DebugP_log("Could not read the profile blob from flash, using defines.h\r\n");
+            return;
+        }
+
+        result = ProfileBlob_check(&gProfileBlob);
+        if (result == PROFILE_BLOB_ERR_EMPTY) {
+            DebugP_log("No profile blob in flash, using defines.h\r\n");
+            return;
+        }
+        if (result != PROFILE_BLOB_OK) {
+            DebugP_log("Error: profile blob rejected (%d), using defines.h\r\n", result);
+            return;
+        }
+
+        /* the shared memory used before the cubes is only known in dpcTask, RangeProc_config() checks the exact budget */
+        limits.maxAdcSamples  = RANGEPROC_MAX_ADC_SAMPLES;
+#if RANGEPROC_MINOR_MOTION_ENABLE
+        limits.numMinorChirps = RANGEPROC_NUM_MINOR_MOTION_CHIRPS;
+#else
+        limits.numMinorChirps = 0;
+#endif
+        limits.freeBytes      = MemRegion_getLargestFree(&gSysContext.memRegions,
+                                                         MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA);
+        limits.reserveBytes   = RANGEPROC_PRODUCT_RESERVE;
+        result = ConfigCmd_validate(&gProfileBlob.profile, &gSysContext.bootProfile, &limits);
+        if (result != CONFIG_CMD_OK) {
+            DebugP_log("Error: profile blob does not fit the firmware (%d), using defines.h\r\n", result);
+            return;
+        }
+
+        gSysContext.bootProfile       = gProfileBlob.profile;
+        gSysContext.bootProfileSource = PROFILE_BLOB_SOURCE_FLASH;
+        DebugP_log("Profile loaded from flash: %u ADC samples, %u chirps per burst, %u bursts\r\n",
+                   gSysContext.bootProfile.chirpComnCfg.numOfAdcSamples,
+                   gSysContext.bootProfile.frameCfg.numOfChirpsInBurst,
+                   gSysContext.bootProfile.frameCfg.numOfBurstsInFrame);
+    }
+#endif
+}
+
 int32_t mmwave_configSensor(void) {
     int32_t     errCode;
     int32_t     retVal = SystemP_SUCCESS;
 
     Mmwave_populateDefaultChirpControlCfg (&gSysContext.mmwCtrlCfg); /* regular frame config */
 
+    /* replace the profile of defines.h by the one loaded from flash */
+    if ((gSysContext.bootProfileSource == PROFILE_BLOB_SOURCE_FLASH) &&
+        (Mmwave_applyProfileCfg (&gSysContext.mmwCtrlCfg, &gSysContext.bootProfile) != SystemP_SUCCESS)) {
+        return SystemP_FAILURE;
+    }
+
     /* Configure the mmWave module: */
     if (MMWave_config (gSysContext.gCtrlHandle, &gSysContext.mmwCtrlCfg, &errCode) < 0) {
         MMWave_ErrorLevel   errorLevel;
@@ -214,6 +353,67 @@ int32_t mmwave_startSensor(void) {
     return retVal;
 }
 
+int32_t mmwave_stopSensor(void) {
+    int32_t     errCode;
+
+    if (MMWave_stop(gSysContext.gCtrlHandle, &errCode) < 0) {
+        MMWave_ErrorLevel   errorLevel;
+        int16_t             mmWaveErrorCode;
+        int16_t             subsysErrorCode;
+
+        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
+        DebugP_log("Error: mmWave Stop failed [Error code: %d Subsystem: %d]\n",
+                        mmWaveErrorCode, subsysErrorCode);
+        return SystemP_FAILURE;
+    }
+    return SystemP_SUCCESS;
+}
+
+int32_t mmwave_reconfigSensor(uint32_t subFrameIdx) {
+    int32_t     errCode;
+    int32_t     retVal = SystemP_SUCCESS;
+
+    if (mmwave_stopSensor() != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    /* the profiles of all sub-frames were added by mmwave_configSensor(), only select another one */
+    Mmwave_selectSubFrameCfg (&gSysContext.mmwCtrlCfg, subFrameIdx);
+
+    if (MMWave_config (gSysContext.gCtrlHandle, &gSysContext.mmwCtrlCfg, &errCode) < 0) {
+        MMWave_ErrorLevel   errorLevel;
+        int16_t             mmWaveErrorCode;
+        int16_t             subsysErrorCode;
+
+        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
+        DebugP_log("Error: mmWave Config of sub-frame %u failed [Error code: %d Subsystem: %d]\n",
+                        subFrameIdx, mmWaveErrorCode, subsysErrorCode);
+        retVal = SystemP_FAILURE;
+    }
+
+    return retVal;
+}
+
+int32_t mmwave_applyProfile(const ConfigCmd_Profile *profile) {
+    int32_t     errCode;
+
+    if (Mmwave_applyProfileCfg (&gSysContext.mmwCtrlCfg, profile) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    if (MMWave_config (gSysContext.gCtrlHandle, &gSysContext.mmwCtrlCfg, &errCode) < 0) {
+        MMWave_ErrorLevel   errorLevel;
+        int16_t             mmWaveErrorCode;
+        int16_t             subsysErrorCode;
+
+        MMWave_decodeError (errCode, &errorLevel, &mmWaveErrorCode, &subsysErrorCode);
+        DebugP_log("Error: mmWave Config of the new profile failed [Error code: %d Subsystem: %d]\n",
+                        mmWaveErrorCode, subsysErrorCode);
+        return SystemP_FAILURE;
+    }
+    return SystemP_SUCCESS;
+}
+
 int32_t mmwave_stop_close_deinit(void) {
     int32_t                 errCode;
     int32_t                 retVal = SystemP_SUCCESS;
@@ -68,54 +68,105 @@
 #include "defines.h"
 #include "common/sys_defs.h"
 #include "mmwave_control_config.h"
+#include "subframe_cfg.h"
 
 /*! @brief  Sensor Perchirp LUT */
 T_SensPerChirpLut* sensPerChirpLuTable = (T_SensPerChirpLut*)(0x21880000U);
 
+/*! @brief Profile of each sub-frame, created once by Mmwave_populateDefaultChirpControlCfg() */
+static MMWave_ProfileHandle gSubFrameProfileHandle[SUBFRAME_NUM];
+
+/*! @brief Sub-frame table, sub-frame 0 is the configuration of defines.h */
+const SubFrame_Config gSubFrameCfg[SUBFRAME_NUM] = {
+    {
+        .numAdcSamples     = CLI_NUM_ADC_SAMPLES,
+        .numChirpsPerBurst = CLI_NUM_CHIRPS_PER_BURST,
+        .numBurstsPerFrame = CLI_NUM_BURSTS_PER_FRAME,
+        .numChirpsAccum    = CLI_NUM_CHIRPS_ACCUM,
+        .chirpSlope        = CLI_CHIRP_SLOPE,
+        .rampEndTime       = CLI_CHIRP_RAMP_END_TIME
+    },
+#if SUBFRAME_ENABLE
+    {
+        .numAdcSamples     = SUBFRAME_1_NUM_ADC_SAMPLES,
+        .numChirpsPerBurst = SUBFRAME_1_NUM_CHIRPS_PER_BURST,
+        .numBurstsPerFrame = SUBFRAME_1_NUM_BURSTS_PER_FRAME,
+        .numChirpsAccum    = SUBFRAME_1_NUM_CHIRPS_ACCUM,
+        .chirpSlope        = SUBFRAME_1_CHIRP_SLOPE,
+        .rampEndTime       = SUBFRAME_1_CHIRP_RAMP_END_TIME
+    },
+#endif
+};
+
 /**
  *  @b Description
  *  @n
  *      Utility function which populates the profile configuration with
  *      well defined defaults.
  *
+ *  @param[in]   ptrSubFrameCfg
+ *      Sub-frame parameters (ADC samples, ramp end time, slope)
+ *
  *  @param[out]  ptrProfileCfg
  *      Pointer to the populated profile configuration
  *
  *  @retval
  *      Not applicable
  */
-static void Mmwave_populateDefaultProfileCfg (T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg) {
-    float rfBandwidth;
-    float rampDownTime;
-    float scale = 65536./(3*100*100);
-
+static void Mmwave_populateDefaultProfileCfg (const SubFrame_Config* ptrSubFrameCfg, T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg) {
     /* Populate the *default* profile configuration: */
     gSysContext.profileComCfg.c_DigOutputSampRate           = CLI_DIG_OUT_SAMPLING_RATE;
     gSysContext.profileComCfg.c_DigOutputBitsSel            = CLI_DIG_OUT_BITS_SEL;
     gSysContext.profileComCfg.c_DfeFirSel                   = CLI_DFE_FIR_SEL;
-    gSysContext.profileComCfg.h_NumOfAdcSamples             = CLI_NUM_ADC_SAMPLES;
+    gSysContext.profileComCfg.h_NumOfAdcSamples             = ptrSubFrameCfg->numAdcSamples;
     gSysContext.profileComCfg.c_ChirpTxMimoPatSel           = CLI_MIMO_SEL;
     gSysContext.profileComCfg.c_MiscSettings                = CLI_C_MISC_SETTINGS;
     gSysContext.profileComCfg.c_HpfFastInitDuration         = CLI_HPF_FAST_INIT_DURATION;
-    gSysContext.profileComCfg.h_ChirpRampEndTime            = CLI_CHIRP_RAMP_END_TIME;
+    gSysContext.profileComCfg.h_ChirpRampEndTime            = ptrSubFrameCfg->rampEndTime;
     gSysContext.profileComCfg.c_ChirpRxHpfSel               = CLI_CHIRP_RX_HPF_SEL;
 
     /* Populate the *default* timing configuration: */
     gSysContext.profileTimeCfg.h_ChirpIdleTime              = CLI_CHIRP_IDLE_TIME;
     gSysContext.profileTimeCfg.h_ChirpAdcStartTime          = CLI_CHIRP_ADC_START_TIME;
     gSysContext.profileTimeCfg.xh_ChirpTxStartTime          = CLI_CHIRP_TX_START_TIME;
-    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope          = CLI_CHIRP_SLOPE;
+    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope          = ptrSubFrameCfg->chirpSlope;
     /* Front End Firmware expects Start freq (MHz) as 1 LSB = (3 x APLL_FREQ / 2^16) * 2^6 resolution  */
     gSysContext.profileTimeCfg.w_ChirpRfFreqStart           = CLI_CHIRP_START_FREQ;
     gSysContext.profileTimeCfg.h_ChirpTxEnSel               = CLI_CHA_CFG_TX_BITMASK;
     gSysContext.profileTimeCfg.h_ChirpTxBpmEnSel            = 0x0U; // MIMO BPM enable (hardcoded to 0 in demo project);
 
-    rfBandwidth = (gSysContext.profileComCfg.h_ChirpRampEndTime*0.1) * CLI_CHIRP_SLOPE; //In MHz/usec
-    rampDownTime = MIN((gSysContext.profileTimeCfg.h_ChirpIdleTime*0.1-1.0), 6.0); //In usec
-    gSysContext.profileComCfg.h_CrdNSlopeMag = (uint16_t) fabs((scale * rfBandwidth / rampDownTime + 0.5));
+    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope  = (ptrSubFrameCfg->chirpSlope * 1048576.0) / (3 * 100 * 100); // as CLI_CHIRP_FREQ_SLOPE
+
+    Mmwave_copyProfileCfg (ptrSubFrameCfg->chirpSlope, ptrProfileCfg, ptrProfileTimeCfg);
+}
 
-    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope  = CLI_CHIRP_FREQ_SLOPE;
+/**
+ *  @b Description
+ *  @n
+ *      Utility function which derives h_CrdNSlopeMag and copies the profile
+ *      in gSysContext (profileComCfg, profileTimeCfg) into the configuration
+ *      passed to MMWave_addProfile().
+ *
+ *  @param[in]   chirpSlope
+ *      Chirp slope in MHz/us
+ *
+ *  @param[out]  ptrProfileCfg
+ *      Pointer to the populated profile configuration
+ *
+ *  @param[out]  ptrProfileTimeCfg
+ *      Pointer to the populated profile time configuration
+ *
+ *  @retval
+ *      Not applicable
+ */
+static void Mmwave_copyProfileCfg (float chirpSlope, T_RL_API_SENS_CHIRP_PROF_COMN_CFG* ptrProfileCfg, T_RL_API_SENS_CHIRP_PROF_TIME_CFG* ptrProfileTimeCfg) {
+    float rfBandwidth;
+    float rampDownTime;
+    float scale = 65536./(3*100*100);
 
+    rfBandwidth = (gSysContext.profileComCfg.h_ChirpRampEndTime*0.1) * chirpSlope; //In MHz/usec
+    rampDownTime = MIN((gSysContext.profileTimeCfg.h_ChirpIdleTime*0.1-1.0), 6.0); //In usec
+    gSysContext.profileComCfg.h_CrdNSlopeMag = (uint16_t) fabs((scale * rfBandwidth / rampDownTime + 0.5));
 
     /* Initialize the profile configuration: */
     memset ((void*)ptrProfileCfg, 0, sizeof(T_RL_API_SENS_CHIRP_PROF_COMN_CFG));
@@ -368,6 +419,7 @@ void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg) {
     T_RL_API_SENS_PER_CHIRP_CTRL            chirpCtrl;
     int32_t             errCode;
     MMWave_ChirpHandle  chirpHandle;
+    uint32_t            subFrameIdx;
 
     Mmwave_ADCBufConfig(gSysContext.channelCfg.h_RxChCtrlBitMask, (gSysContext.profileComCfg.h_NumOfAdcSamples *2));
 
@@ -382,29 +434,35 @@ void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg) {
     gSysContext.frameCfg.w_FramePeriodicity        = CLI_FRAME_PERIOD;
     gSysContext.frameCfg.h_NumOfFrames             = CLI_NUM_FRAMES;
 
-    /* Populate the profile configuration: */
-    Mmwave_populateDefaultProfileCfg (&profileCfg, &profileTimeCfg);
-
-    /* Create the profile: */
-    ptrCtrlCfg->frameCfg[0].profileHandle[0] = MMWave_addProfile(gSysContext.gCtrlHandle, &profileCfg, &profileTimeCfg, &errCode);
-    if (ptrCtrlCfg->frameCfg[0].profileHandle[0] == NULL) {
-        DebugP_logError ("Error: Unable to add the profile [Error code %d]\n", errCode);
-        DebugP_log ("MMWave Add Profile Error");
-        return;
-    }
-    DebugP_log ("MMWave Add Profile Success");
+    /* Create one profile (with its chirp) per sub-frame. The last one populated is
+       sub-frame 0, so that gSysContext.profileComCfg/profileTimeCfg hold the
+       configuration of defines.h (used by the factory calibration). */
+    for (subFrameIdx = SUBFRAME_NUM; subFrameIdx > 0U; subFrameIdx--) {
+        /* Populate the profile configuration: */
+        Mmwave_populateDefaultProfileCfg (&gSubFrameCfg[subFrameIdx - 1U], &profileCfg, &profileTimeCfg);
+
+        /* Create the profile: */
+        gSubFrameProfileHandle[subFrameIdx - 1U] = MMWave_addProfile(gSysContext.gCtrlHandle, &profileCfg, &profileTimeCfg, &errCode);
+        if (gSubFrameProfileHandle[subFrameIdx - 1U] == NULL) {
+            DebugP_logError ("Error: Unable to add the profile [Error code %d]\n", errCode);
+            DebugP_log ("MMWave Add Profile Error");
+            return;
+        }
+        DebugP_log ("MMWave Add Profile Success");
 
-    /* Populate the default chirp configuration */
-    Mmwave_populateDefaultChirpCfg (&chirpCfg, &chirpCtrl);
+        /* Populate the default chirp configuration */
+        Mmwave_populateDefaultChirpCfg (&chirpCfg, &chirpCtrl);
 
-    /* Add the chirp to the profile: */
-    chirpHandle = MMWave_addChirp (ptrCtrlCfg->frameCfg[0].profileHandle[0], &chirpCfg, &chirpCtrl, &errCode);
-    if (chirpHandle == NULL) {
-        DebugP_logError ("Error: Unable to add the chirp [Error code %d]\n", errCode);
-        DebugP_log ("MMWave Add Chirp Error");
-        return;
+        /* Add the chirp to the profile: */
+        chirpHandle = MMWave_addChirp (gSubFrameProfileHandle[subFrameIdx - 1U], &chirpCfg, &chirpCtrl, &errCode);
+        if (chirpHandle == NULL) {
+            DebugP_logError ("Error: Unable to add the chirp [Error code %d]\n", errCode);
+            DebugP_log ("MMWave Add Chirp Error");
+            return;
+        }
+        DebugP_log ("MMWave Add Chirp Success");
     }
-    DebugP_log ("MMWave Add Chirp Success");
+    ptrCtrlCfg->frameCfg[0].profileHandle[0] = gSubFrameProfileHandle[0];
 
     /* Populate the frame configuration: */
     ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfChirpsInBurst = gSysContext.frameCfg.h_NumOfChirpsInBurst; //2; //10; //2U;
@@ -428,6 +486,165 @@ void Mmwave_populateDefaultChirpControlCfg (MMWave_CtrlCfg* ptrCtrlCfg) {
     return;
 }
 
+/**
+ *  @b Description
+ *  @n
+ *      The function is used to switch the control configuration to another
+ *      sub-frame: selects its profile (created by
+ *      Mmwave_populateDefaultChirpControlCfg()) and frame shape and configures
+ *      the ADC buffer for its number of ADC samples. The sensor must be stopped.
+ *
+ *  @param[in,out]  ptrCtrlCfg
+ *      Pointer to the control configuration
+ *
+ *  @param[in]  subFrameIdx
+ *      Index of the sub-frame in gSubFrameCfg
+ *
+ *  @retval
+ *      Not applicable
+ */
+void Mmwave_selectSubFrameCfg (MMWave_CtrlCfg* ptrCtrlCfg, uint32_t subFrameIdx) {
+    const SubFrame_Config *subFrameCfg = &gSubFrameCfg[subFrameIdx];
+
+    Mmwave_ADCBufConfig(gSysContext.channelCfg.h_RxChCtrlBitMask, (subFrameCfg->numAdcSamples * 2));
+
+    ptrCtrlCfg->frameCfg[0].profileHandle[0] = gSubFrameProfileHandle[subFrameIdx];
+    ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfChirpsInBurst = subFrameCfg->numChirpsPerBurst;
+    ptrCtrlCfg->frameCfg[0].frameCfg.c_NumOfChirpsAccum   = subFrameCfg->numChirpsAccum;
+    ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfBurstsInFrame = subFrameCfg->numBurstsPerFrame;
+
+    return;
+}
+
+/**
+ *  @b Description
+ *  @n
+ *      The function is used to get the profile of defines.h in the units of
+ *      the .cfg file, as carried by the reconfiguration command records
+ *      (see config_cmd.h).
+ *
+ *  @param[out]  ptrProfile
+ *      Pointer to the profile
+ *
+ *  @retval
+ *      Not applicable
+ */
+void Mmwave_getDefaultProfile (ConfigCmd_Profile* ptrProfile) {
+    memset ((void*)ptrProfile, 0, sizeof(ConfigCmd_Profile));
+
+    ptrProfile->channelCfg.rxChCtrlBitMask = CLI_CHA_CFG_RX_BITMASK;
+    ptrProfile->channelCfg.txChCtrlBitMask = CLI_CHA_CFG_TX_BITMASK;
+    ptrProfile->channelCfg.miscCtrl        = CLI_CHA_CFG_MISC_CTRL;
+
+    ptrProfile->chirpComnCfg.digOutputSampRate = CLI_DIG_OUT_SAMPLING_RATE;
+    ptrProfile->chirpComnCfg.digOutputBitsSel  = CLI_DIG_OUT_BITS_SEL;
+    ptrProfile->chirpComnCfg.dfeFirSel         = CLI_DFE_FIR_SEL;
+    ptrProfile->chirpComnCfg.numOfAdcSamples   = CLI_NUM_ADC_SAMPLES;
+    ptrProfile->chirpComnCfg.chirpTxMimoPatSel = CLI_MIMO_SEL;
+    ptrProfile->chirpComnCfg.chirpRampEndTime  = (float)(CLI_CHIRP_RAMP_END_TIME / 10.0);
+    ptrProfile->chirpComnCfg.chirpRxHpfSel     = CLI_CHIRP_RX_HPF_SEL;
+
+    ptrProfile->chirpTimingCfg.chirpIdleTime       = (float)(CLI_CHIRP_IDLE_TIME / 10.0);
+    ptrProfile->chirpTimingCfg.chirpAdcSkipSamples = CLI_CHIRP_ADC_START_TIME >> 10;
+    ptrProfile->chirpTimingCfg.chirpTxStartTime    = (float)(CLI_CHIRP_TX_START_TIME / 50.0);
+    ptrProfile->chirpTimingCfg.chirpRfFreqSlope    = (float)CLI_CHIRP_SLOPE;
+    ptrProfile->chirpTimingCfg.chirpRfFreqStart    = (float)CLI_START_FREQ;
+
+    ptrProfile->frameCfg.numOfChirpsInBurst = CLI_NUM_CHIRPS_PER_BURST;
+    ptrProfile->frameCfg.numOfChirpsAccum   = CLI_NUM_CHIRPS_ACCUM;
+    ptrProfile->frameCfg.burstPeriodicity   = (float)CLI_BURST_PERIOD;
+    ptrProfile->frameCfg.numOfBurstsInFrame = CLI_NUM_BURSTS_PER_FRAME;
+    ptrProfile->frameCfg.framePeriodicity   = (float)(CLI_FRAME_PERIOD / 40000.0);
+    ptrProfile->frameCfg.numOfFrames        = CLI_NUM_FRAMES;
+}
+
+/**
+ *  @b Description
+ *  @n
+ *      The function is used to replace the profile and frame shape of the
+ *      control configuration at runtime: the fields in gSysContext are set
+ *      from the profile (in the units defines.h derives), the profile of
+ *      the front end is replaced and the ADC buffer is configured for the
+ *      number of ADC samples. The channel configuration is kept. The sensor
+ *      must be stopped; the configuration is applied by MMWave_config().
+ *
+ *  @param[in,out]  ptrCtrlCfg
+ *      Pointer to the control configuration
+ *
+ *  @param[in]  ptrProfile
+ *      Profile, validated by ConfigCmd_validate()
+ *
+ *  @retval
+ *      SystemP_SUCCESS on success, SystemP_FAILURE if the profile or chirp could not be created
+ */
+int32_t Mmwave_applyProfileCfg (MMWave_CtrlCfg* ptrCtrlCfg, const ConfigCmd_Profile* ptrProfile) {
+    ConfigCmd_SensorParams                  params;
+    T_RL_API_SENS_CHIRP_PROF_COMN_CFG       profileCfg;
+    T_RL_API_SENS_CHIRP_PROF_TIME_CFG       profileTimeCfg;
+    T_RL_API_SENS_PER_CHIRP_CFG             chirpCfg;
+    T_RL_API_SENS_PER_CHIRP_CTRL            chirpCtrl;
+    int32_t             errCode;
+    MMWave_ChirpHandle  chirpHandle;
+
+    ConfigCmd_toSensorParams (ptrProfile, &params);
+
+    gSysContext.profileComCfg.c_DigOutputSampRate   = (uint8_t)ptrProfile->chirpComnCfg.digOutputSampRate;
+    gSysContext.profileComCfg.c_DigOutputBitsSel    = (uint8_t)ptrProfile->chirpComnCfg.digOutputBitsSel;
+    gSysContext.profileComCfg.c_DfeFirSel           = (uint8_t)ptrProfile->chirpComnCfg.dfeFirSel;
+    gSysContext.profileComCfg.h_NumOfAdcSamples     = (uint16_t)ptrProfile->chirpComnCfg.numOfAdcSamples;
+    gSysContext.profileComCfg.c_ChirpTxMimoPatSel   = (uint8_t)ptrProfile->chirpComnCfg.chirpTxMimoPatSel;
+    gSysContext.profileComCfg.h_ChirpRampEndTime    = params.rampEndTime;
+    gSysContext.profileComCfg.c_ChirpRxHpfSel       = (uint8_t)ptrProfile->chirpComnCfg.chirpRxHpfSel;
+
+    gSysContext.profileTimeCfg.h_ChirpIdleTime      = params.idleTime;
+    gSysContext.profileTimeCfg.h_ChirpAdcStartTime  = params.adcStartTime;
+    gSysContext.profileTimeCfg.xh_ChirpTxStartTime  = params.txStartTime;
+    gSysContext.profileTimeCfg.xh_ChirpRfFreqSlope  = params.freqSlope;
+    gSysContext.profileTimeCfg.w_ChirpRfFreqStart   = params.freqStart;
+
+    gSysContext.frameCfg.h_NumOfChirpsInBurst       = (uint16_t)ptrProfile->frameCfg.numOfChirpsInBurst;
+    gSysContext.frameCfg.c_NumOfChirpsAccum         = (uint8_t)ptrProfile->frameCfg.numOfChirpsAccum;
+    gSysContext.frameCfg.w_BurstPeriodicity         = params.burstPeriod;
+    gSysContext.frameCfg.h_NumOfBurstsInFrame       = (uint16_t)ptrProfile->frameCfg.numOfBurstsInFrame;
+    gSysContext.frameCfg.w_FramePeriodicity         = params.framePeriod;
+    gSysContext.frameCfg.h_NumOfFrames              = (uint16_t)ptrProfile->frameCfg.numOfFrames;
+
+    /* a profile of the front end can only be replaced, not modified */
+    if (gSubFrameProfileHandle[0] != NULL) {
+        if (MMWave_delProfile (gSysContext.gCtrlHandle, gSubFrameProfileHandle[0], &errCode) < 0) {
+            DebugP_logError ("Error: Unable to delete the profile [Error code %d]\n", errCode);
+            return SystemP_FAILURE;
+        }
+        gSubFrameProfileHandle[0] = NULL;
+    }
+
+    Mmwave_copyProfileCfg (ptrProfile->chirpTimingCfg.chirpRfFreqSlope, &profileCfg, &profileTimeCfg);
+    gSubFrameProfileHandle[0] = MMWave_addProfile (gSysContext.gCtrlHandle, &profileCfg, &profileTimeCfg, &errCode);
+    if (gSubFrameProfileHandle[0] == NULL) {
+        DebugP_logError ("Error: Unable to add the profile [Error code %d]\n", errCode);
+        return SystemP_FAILURE;
+    }
+
+    Mmwave_populateDefaultChirpCfg (&chirpCfg, &chirpCtrl);
+    chirpHandle = MMWave_addChirp (gSubFrameProfileHandle[0], &chirpCfg, &chirpCtrl, &errCode);
+    if (chirpHandle == NULL) {
+        DebugP_logError ("Error: Unable to add the chirp [Error code %d]\n", errCode);
+        return SystemP_FAILURE;
+    }
+
+    Mmwave_ADCBufConfig(gSysContext.channelCfg.h_RxChCtrlBitMask, (gSysContext.profileComCfg.h_NumOfAdcSamples * 2));
+
+    ptrCtrlCfg->frameCfg[0].profileHandle[0] = gSubFrameProfileHandle[0];
+    ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfChirpsInBurst = gSysContext.frameCfg.h_NumOfChirpsInBurst;
+    ptrCtrlCfg->frameCfg[0].frameCfg.c_NumOfChirpsAccum   = gSysContext.frameCfg.c_NumOfChirpsAccum;
+    ptrCtrlCfg->frameCfg[0].frameCfg.w_BurstPeriodicity   = gSysContext.frameCfg.w_BurstPeriodicity;
+    ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfBurstsInFrame = gSysContext.frameCfg.h_NumOfBurstsInFrame;
+    ptrCtrlCfg->frameCfg[0].frameCfg.w_FramePeriodicity   = gSysContext.frameCfg.w_FramePeriodicity;
+    ptrCtrlCfg->frameCfg[0].frameCfg.h_NumOfFrames        = gSysContext.frameCfg.h_NumOfFrames;
+
+    return SystemP_SUCCESS;
+}
+
 /**
  *  @b Description
  *  @n
@@ -0,0 +1,44 @@
+/**
+ * @file profile_blob.c
+ * @brief Chirp profile stored in flash, loaded at boot instead of defines.h.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "config_cmd.h"
+#include "profile_blob.h"
+
+/* the payload is copied as is, so it must not contain padding */
+_Static_assert(sizeof(ConfigCmd_Profile) == CONFIG_CMD_PROFILE_WORDS * sizeof(uint32_t),
+               "ConfigCmd_Profile must consist of 32-bit fields only");
+_Static_assert(sizeof(ProfileBlob) == 16U + sizeof(ConfigCmd_Profile),
+               "ProfileBlob must not contain padding");
+
+
+void ProfileBlob_encode(const ConfigCmd_Profile *profile, ProfileBlob *blob) {
+    memset(blob, 0, sizeof(ProfileBlob));
+    blob->magic        = PROFILE_BLOB_MAGIC;
+    blob->version      = PROFILE_BLOB_VERSION;
+    blob->headerBytes  = (uint16_t)(sizeof(ProfileBlob) - sizeof(ConfigCmd_Profile));
+    blob->payloadBytes = sizeof(ConfigCmd_Profile);
+    blob->profile      = *profile;
+    blob->crc          = ConfigCmd_crc32(&blob->profile, sizeof(ConfigCmd_Profile));
+}
+
+int32_t ProfileBlob_check(const ProfileBlob *blob) {
+    if (blob->magic != PROFILE_BLOB_MAGIC) {
+        return PROFILE_BLOB_ERR_EMPTY;
+    }
+    if (blob->version != PROFILE_BLOB_VERSION) {
+        return PROFILE_BLOB_ERR_VERSION;
+    }
+    if ((blob->headerBytes != sizeof(ProfileBlob) - sizeof(ConfigCmd_Profile)) ||
+        (blob->payloadBytes != sizeof(ConfigCmd_Profile))) {
+        return PROFILE_BLOB_ERR_LENGTH;
+    }
+    if (ConfigCmd_crc32(&blob->profile, sizeof(ConfigCmd_Profile)) != blob->crc) {
+        return PROFILE_BLOB_ERR_CRC;
+    }
+    return PROFILE_BLOB_OK;
+}
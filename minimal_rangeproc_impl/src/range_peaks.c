@@ -0,0 +1,101 @@
+/**
+ * @file range_peaks.c
+ * @brief List of the K strongest range bins of a frame.
+ *
+ * The local maxima of the range profile are kept in a list sorted by
+ * decreasing power, so K is expected to be small (insertion costs O(K)).
+ * The fractional bin is obtained by fitting a parabola through the magnitudes
+ * of the maximum and its two neighbours.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "range_peaks.h"
+
+
+/**
+ * @brief Returns the address of the n-th peak entry.
+ */
+static inline RangePeaks_Peak *RangePeaks_getPeak(const RangePeaks_Config *cfg, void *payload, uint32_t n) {
+    return (RangePeaks_Peak *)((uint8_t *)payload + sizeof(RangePeaks_Header) + (n * RangePeaks_getPeakSize(cfg)));
+}
+
+uint32_t RangePeaks_getPeakSize(const RangePeaks_Config *cfg) {
+    return (uint32_t)sizeof(RangePeaks_Peak) + (uint32_t)cfg->numVirtualAntennas * 2U * sizeof(int16_t);
+}
+
+uint32_t RangePeaks_getPayloadSize(const RangePeaks_Config *cfg) {
+    return (uint32_t)sizeof(RangePeaks_Header) + ((uint32_t)cfg->maxPeaks * RangePeaks_getPeakSize(cfg));
+}
+
+int32_t RangePeaks_find(const RangePeaks_Config *cfg, const int16_t *cube, const uint64_t *acc,
+                        void *payload) {
+    RangePeaks_Header *hdr = (RangePeaks_Header *)payload;
+    uint16_t peakBins[UINT8_MAX];
+    uint32_t numPeaks = 0;
+    uint32_t numBins;
+    uint32_t bin, n, ant;
+    float    numSamples;
+
+    if ((cfg == NULL) || (cube == NULL) || (acc == NULL) || (payload == NULL) ||
+        (cfg->maxPeaks == 0U) || (cfg->maxPeaks > UINT8_MAX) || (cfg->numRangeBins < 3U)) {
+        return -1;
+    }
+
+    numBins    = cfg->numRangeBins;
+    numSamples = (float)cfg->numVirtualAntennas * (float)cfg->numDopplerChirps;
+
+    /* local maxima, kept sorted by decreasing power */
+    for (bin = (cfg->minBin > 0U) ? cfg->minBin : 1U; bin < (numBins - 1U); bin++) {
+        uint64_t p = acc[bin];
+
+        if ((p <= acc[bin - 1U]) || (p < acc[bin + 1U])) {
+            continue;
+        }
+        if ((numPeaks == cfg->maxPeaks) && (p <= acc[peakBins[numPeaks - 1U]])) {
+            continue;
+        }
+
+        n = (numPeaks < cfg->maxPeaks) ? numPeaks++ : (numPeaks - 1U);
+        while ((n > 0U) && (acc[peakBins[n - 1U]] < p)) {
+            peakBins[n] = peakBins[n - 1U];
+            n--;
+        }
+        peakBins[n] = (uint16_t)bin;
+    }
+
+    memset(payload, 0, RangePeaks_getPayloadSize(cfg));
+    hdr->numPeaks           = (uint16_t)numPeaks;
+    hdr->maxPeaks           = cfg->maxPeaks;
+    hdr->numVirtualAntennas = cfg->numVirtualAntennas;
+
+    for (n = 0; n < numPeaks; n++) {
+        RangePeaks_Peak *peak = RangePeaks_getPeak(cfg, payload, n);
+        uint32_t        *iq   = (uint32_t *)(peak + 1);
+        float a, b, c, denom, delta;
+
+        bin = peakBins[n];
+
+        /* parabolic interpolation on the magnitudes */
+        a = sqrtf((float)acc[bin - 1U]);
+        b = sqrtf((float)acc[bin]);
+        c = sqrtf((float)acc[bin + 1U]);
+        denom = a - (2.0f * b) + c;
+        delta = (denom < 0.0f) ? (0.5f * (a - c) / denom) : 0.0f;
+
+        peak->bin       = (uint16_t)bin;
+        peak->rangeBin  = (float)bin + delta;
+        peak->power     = (float)acc[bin];
+        peak->magnitude = (b - (0.25f * (a - c) * delta)) / sqrtf(numSamples);
+
+        /* first doppler chirp: range lines 0..numVirtualAntennas-1 */
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            iq[ant] = ((const uint32_t *)cube)[(ant * numBins) + bin];
+        }
+    }
+
+    return (int32_t)numPeaks;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file range_profile.c
+ * @brief Non-coherent range profile of the radar cube.
+ *
+ * The cube is read line by line in memory order, so that each range line is
+ * streamed once from L3 and the per-bin accumulators stay in local memory.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "range_profile.h"
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#include <arm_acle.h>
+#endif
+
+
+uint32_t RangeProfile_getShift(uint32_t numRows) {
+    uint32_t shift = 0;
+
+    /* a single sample contributes at most 2 * 32768^2 = 2^31 */
+    while ((((uint64_t)numRows << 31) >> shift) > 0xFFFFFFFFULL) {
+        shift++;
+    }
+    return shift;
+}
+
+void RangeProfile_accumulate(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows,
+                             uint64_t *acc) {
+    uint32_t row, bin;
+
+    memset(acc, 0, numRangeBins * sizeof(uint64_t));
+
+    for (row = 0; row < numRows; row++) {
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+        /* one complex sample per 32-bit word: re*re + im*im in a single SMLALD */
+        const uint32_t *line = (const uint32_t *)cube + (row * numRangeBins);
+        for (bin = 0; bin < numRangeBins; bin++) {
+            uint32_t x = line[bin];
+            acc[bin] = (uint64_t)__smlald((int16x2_t)x, (int16x2_t)x, (int64_t)acc[bin]);
+        }
+#else
+        const int16_t *line = cube + (2U * row * numRangeBins);
+        for (bin = 0; bin < numRangeBins; bin++) {
+            int32_t a = line[2U * bin];
+            int32_t b = line[2U * bin + 1U];
+            acc[bin] += (uint64_t)((uint32_t)(a * a) + (uint32_t)(b * b));
+        }
+#endif
+    }
+}
+
+void RangeProfile_pack(const uint64_t *acc, uint32_t numRangeBins, uint32_t numRows,
+                       uint32_t *profile) {
+    uint32_t shift = RangeProfile_getShift(numRows);
+    uint32_t bin;
+
+    for (bin = 0; bin < numRangeBins; bin++) {
+        profile[bin] = (uint32_t)(acc[bin] >> shift);
+    }
+}
+
+void RangeProfile_compute(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows,
+                          uint64_t *acc, uint32_t *profile) {
+    RangeProfile_accumulate(cube, numRangeBins, numRows, acc);
+    RangeProfile_pack(acc, numRangeBins, numRows, profile);
+}
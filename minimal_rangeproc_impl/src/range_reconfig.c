@@ -0,0 +1,53 @@
+/**
+ * @file range_reconfig.c
+ * @brief Change detection and window reuse for the reconfiguration of the range DPU.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "range_reconfig.h"
+
+
+int32_t RangeReconfig_isChanged(const RangeReconfig_Params *cur, const RangeReconfig_Params *next) {
+    return ((cur->fftOutputDivShift != next->fftOutputDivShift) ||
+            (cur->numButterflyStagesScaled != next->numButterflyStagesScaled) ||
+            (cur->window != next->window) || (cur->windowSize != next->windowSize) ||
+            (cur->numAdcSamples != next->numAdcSamples) || (cur->rangeFftSize != next->rangeFftSize) ||
+            (cur->numRangeBins != next->numRangeBins) ||
+            (cur->numChirpsPerFrame != next->numChirpsPerFrame) ||
+            (cur->numDopplerChirpsPerFrame != next->numDopplerChirpsPerFrame) ||
+            (cur->numTxAntennas != next->numTxAntennas) ||
+            (cur->numVirtualAntennas != next->numVirtualAntennas) ||
+            (cur->isBpmEnabled != next->isBpmEnabled) ||
+            (cur->adcDataSize != next->adcDataSize) || (cur->adcRxChanStride != next->adcRxChanStride) ||
+            (cur->cube != next->cube) || (cur->cubeBytes != next->cubeBytes)) ? 1 : 0;
+}
+
+void RangeReconfig_initWindowCache(RangeReconfig_WindowCache *cache) {
+    memset(cache, 0, sizeof(RangeReconfig_WindowCache));
+}
+
+const RangeReconfig_Window *RangeReconfig_findWindow(const RangeReconfig_WindowCache *cache,
+                                                     uint32_t numAdcSamples, uint32_t winType, uint32_t qFormat) {
+    uint32_t i;
+
+    for (i = 0; i < cache->numEntries; i++) {
+        const RangeReconfig_Window *entry = &cache->entry[i];
+
+        if ((entry->numAdcSamples == numAdcSamples) && (entry->winType == winType) &&
+            (entry->qFormat == qFormat)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int32_t RangeReconfig_addWindow(RangeReconfig_WindowCache *cache, const RangeReconfig_Window *window) {
+    if (cache->numEntries >= RANGE_RECONFIG_MAX_WINDOWS) {
+        return -1;
+    }
+    cache->entry[cache->numEntries] = *window;
+    cache->numEntries++;
+    return 0;
+}
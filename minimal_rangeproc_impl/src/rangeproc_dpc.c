@@ -41,6 +41,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <string.h>
 #include <kernel/dpl/DebugP.h>
 #include <utils/mathutils/mathutils.h>
 #include "drivers/edma/v0/edma.h"
@@ -56,8 +57,76 @@
 #include "dpu_res.h"
 #include "mmwave_basic.h"
 #include "mem_pool.h"
+#include "mem_region.h"
 #include "spi_transmit.h"
+#include "stream_products.h"
+#include "fft_autoscale.h"
+#include "cube_budget.h"
+#include "chirp_accum.h"
+#include "doppler_proc.h"
+#include "cfar_proc.h"
+#include "doa_proc.h"
+#include "micro_doppler_proc.h"
+#include "subframe_cfg.h"
+#include "range_reconfig.h"
+#include "config_cmd.h"
+#include "recovery.h"
 #include "rangeproc_dpc.h"
+#if RANGEPROC_WINDOW_TABLE_ENABLE
+#include "window_table.h"
+#endif
+
+#if RANGEPROC_FFT_AUTOSCALE_ENABLE && !STREAM_FRAME_INFO_ENABLE
+#error "RANGEPROC_FFT_AUTOSCALE_ENABLE requires STREAM_FRAME_INFO_ENABLE to tag the frames with the applied shift"
+#endif
+
+#if RANGEPROC_WINDOW_TABLE_ENABLE && (WINDOW_TABLE_QFORMAT != DPC_OBJDET_QFORMAT_RANGE_FFT)
+#error "window_table.h was generated for another Q format, regenerate it with chirp_config_to_defines.py"
+#endif
+
+#if STREAM_RD_HEATMAP_ENABLE && !DOPPLERPROC_ENABLE
+#error "STREAM_RD_HEATMAP_ENABLE requires DOPPLERPROC_ENABLE"
+#endif
+
+#if STREAM_CFAR_DETECTIONS_ENABLE && !CFARPROC_ENABLE
+#error "STREAM_CFAR_DETECTIONS_ENABLE requires CFARPROC_ENABLE"
+#endif
+
+#if STREAM_DOA_HEATMAP_ENABLE && !(DOAPROC_ENABLE && DOAPROC_HEATMAP_ENABLE)
+#error "STREAM_DOA_HEATMAP_ENABLE requires DOAPROC_ENABLE and DOAPROC_HEATMAP_ENABLE"
+#endif
+
+#if STREAM_DOA_ESTIMATES_ENABLE && !(DOAPROC_ENABLE && DOAPROC_ESTIMATES_ENABLE)
+#error "STREAM_DOA_ESTIMATES_ENABLE requires DOAPROC_ENABLE and DOAPROC_ESTIMATES_ENABLE"
+#endif
+
+#if STREAM_MICRO_DOPPLER_ENABLE && !UDOPPROC_ENABLE
+#error "STREAM_MICRO_DOPPLER_ENABLE requires UDOPPROC_ENABLE"
+#endif
+
+#if STREAM_MINOR_CUBE_ENABLE && !RANGEPROC_MINOR_MOTION_ENABLE
+#error "STREAM_MINOR_CUBE_ENABLE requires RANGEPROC_MINOR_MOTION_ENABLE"
+#endif
+
+#if SUBFRAME_ENABLE && (SUBFRAME_NUM > SUBFRAME_MAX_NUM)
+#error "SUBFRAME_NUM exceeds SUBFRAME_MAX_NUM"
+#endif
+
+#if SUBFRAME_ENABLE && (!STREAM_MAJOR_CUBE_ENABLE || STREAM_RAW_CUBE_ENABLE)
+#error "SUBFRAME_ENABLE streams the cubes tagged by sub-frame: requires STREAM_MAJOR_CUBE_ENABLE without STREAM_RAW_CUBE_ENABLE"
+#endif
+
+#if SUBFRAME_ENABLE && (RANGEPROC_FFT_AUTOSCALE_ENABLE || RANGEPROC_MINOR_MOTION_ENABLE)
+#error "SUBFRAME_ENABLE does not support RANGEPROC_FFT_AUTOSCALE_ENABLE or RANGEPROC_MINOR_MOTION_ENABLE"
+#endif
+
+#if SUBFRAME_ENABLE && (DOPPLERPROC_ENABLE || CFARPROC_ENABLE || DOAPROC_ENABLE || UDOPPROC_ENABLE)
+#error "SUBFRAME_ENABLE does not support the Doppler, CFAR, DoA and micro-Doppler stages, which are configured for one cube shape"
+#endif
+
+#if SUBFRAME_ENABLE && SPI_CMD_CHANNEL_ENABLE
+#error "SPI_CMD_CHANNEL_ENABLE replaces the profile of defines.h and does not support SUBFRAME_ENABLE"
+#endif
 
 
 /*! @brief for debugging: hardware interrupt objects for registering chirp available ISR */
@@ -82,6 +151,295 @@ void *gAdcDataDebugPtr = NULL;
 /*! @brief Rangeproc Callback EDMA Interrupt object (Ping and Poing, hence 2 objects) */
 Edma_IntrObject intrObj_Rangeproc[2];
 
+/*! @brief Windows the window pool holds: every cache entry, plus the one compared with the table in check mode */
+#define RANGEPROC_WINDOW_POOL_NUM       (RANGE_RECONFIG_MAX_WINDOWS + RANGEPROC_WINDOW_TABLE_CHECK)
+
+/*! @brief Windows a full configuration needs at once (one per sub-frame) */
+#if SUBFRAME_ENABLE
+#define RANGEPROC_NUM_CONFIG_WINDOWS    SUBFRAME_NUM
+#else
+#define RANGEPROC_NUM_CONFIG_WINDOWS    1U
+#endif
+
+/*! @brief Range windows generated so far, shared by all configurations with the same number of ADC samples */
+static RangeReconfig_WindowCache gWindowCache;
+
+/*! @brief Memory of the generated range windows, allocated before the pipeline checkpoint so that
+ *         rewinding the pipeline keeps the cached windows */
+static MemPoolObj gWindowPool;
+
+
+/**
+ * @brief Allocates the window pool and empties the window cache.
+ *
+ * Called once before the pipeline checkpoint is opened. The pool holds
+ * RANGEPROC_WINDOW_POOL_NUM windows of RANGEPROC_MAX_ADC_SAMPLES, so every
+ * window the cache can list fits.
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE if no region has room for the pool
+ */
+static int32_t RangeProc_initWindows(void) {
+    uint32_t poolBytes = RANGEPROC_WINDOW_POOL_NUM * sizeof(uint32_t) * ((RANGEPROC_MAX_ADC_SAMPLES + 1U) / 2U);
+
+    memset(&gWindowPool, 0, sizeof(MemPoolObj));
+    /* only read by DPU_RangeProcHWA_config(), which copies the window to the HWA window RAM */
+    gWindowPool.cfg.addr = MemRegion_alloc(&gSysContext.memRegions, poolBytes, sizeof(uint32_t), 0U,
+                                           MEM_REGION_POLICY_LARGEST_FREE, "rangeWindow", NULL);
+    if (gWindowPool.cfg.addr == NULL) {
+        return SystemP_FAILURE;
+    }
+    gWindowPool.cfg.size = poolBytes;
+    DPC_ObjDet_MemPoolReset(&gWindowPool);
+    RangeReconfig_initWindowCache(&gWindowCache);
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Logs the usage of a memory region and its live allocations by tag.
+ */
+static void RangeProc_logPoolUsage(uint32_t regionIdx) {
+    const MemRegion_Region *region = &gSysContext.memRegions.region[regionIdx];
+    const MemPoolObj *pool = region->pool;
+    MemRegion_Usage usage;
+    uint32_t i;
+
+    MemRegion_getUsage(&gSysContext.memRegions, regionIdx, &usage);
+    DebugP_log("%s pool usage: %u of %u bytes (peak %u)\n", region->name, usage.used, usage.size, usage.peak);
+    for (i = 0; i < pool->numTags; i++) {
+        DebugP_log("  %s: %u bytes at 0x%08x\n", pool->tags[i].tag, pool->tags[i].size, (uint32_t)pool->tags[i].addr);
+    }
+    if (pool->numTagsDropped > 0U) {
+        DebugP_log("  %u allocations beyond MEM_POOL_MAX_TAGS not listed\n", pool->numTagsDropped);
+    }
+}
+
+/**
+ * @brief Configures the range DPU, the stages after it and the streamed products.
+ *
+ * Everything is allocated from the memory regions, so the whole pipeline is
+ * released by rewinding to RANGEPROC_MEM_CHECKPOINT_PIPELINE.
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE otherwise
+ */
+static int32_t RangeProc_configPipeline(void) {
+    if (RangeProc_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: range DPU configuration failed\n");
+        return SystemP_FAILURE;
+    }
+#if DOPPLERPROC_ENABLE
+    if (DopplerProc_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: Doppler stage configuration failed\n");
+        return SystemP_FAILURE;
+    }
+#endif
+#if CFARPROC_ENABLE
+    if (CfarProc_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: CFAR stage configuration failed\n");
+        return SystemP_FAILURE;
+    }
+#endif
+#if DOAPROC_ENABLE
+    if (DoaProc_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: DoA stage configuration failed\n");
+        return SystemP_FAILURE;
+    }
+#endif
+#if UDOPPROC_ENABLE
+    if (MicroDopplerProc_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: micro-Doppler stage configuration failed\n");
+        return SystemP_FAILURE;
+    }
+#endif
+
+    /* allocate the streamed data products and register the SPI buffers */
+    if (streamProducts_config() != SystemP_SUCCESS) {
+        DebugP_log("Error: stream products configuration failed\n");
+        return SystemP_FAILURE;
+    }
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Initializes the runtime reconfiguration with the boot profile (flash or defines.h).
+ *
+ * Must be called right after the pipeline checkpoint is opened: the bytes of
+ * the largest shared memory region free at this point are the budget of the
+ * radar cubes of every profile.
+ */
+static void RangeProc_initConfigCmd(void) {
+    ConfigCmd_Limits limits;
+
+    limits.maxAdcSamples  = RANGEPROC_MAX_ADC_SAMPLES;
+#if RANGEPROC_MINOR_MOTION_ENABLE
+    limits.numMinorChirps = RANGEPROC_NUM_MINOR_MOTION_CHIRPS;
+#else
+    limits.numMinorChirps = 0;
+#endif
+    limits.freeBytes      = MemRegion_getLargestFree(&gSysContext.memRegions,
+                                                     MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA);
+    limits.reserveBytes   = RANGEPROC_PRODUCT_RESERVE;
+    ConfigCmd_init(&gSysContext.configCmd, &gSysContext.bootProfile, &limits);
+}
+
+#if SPI_CMD_CHANNEL_ENABLE
+/**
+ * @brief Stops the sensor for a reconfiguration (ConfigCmd_Ops).
+ */
+static int32_t RangeProc_cmdStopSensor(void *arg) {
+    (void)arg;
+    return (mmwave_stopSensor() == SystemP_SUCCESS) ? 0 : -1;
+}
+
+/**
+ * @brief Applies a profile to the front end and rebuilds the pipeline for it (ConfigCmd_Ops).
+ */
+static int32_t RangeProc_cmdApplyProfile(void *arg, const ConfigCmd_Profile *profile) {
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    uint32_t regionIdx;
+
+    (void)arg;
+    if (mmwave_applyProfile(profile) != SystemP_SUCCESS) {
+        return -1;
+    }
+
+    /* same cube shape: only the range DPU is reprogrammed, the cubes and products are kept */
+    if (RangeProc_reconfigProfile() == SystemP_SUCCESS) {
+        // benchmark: duration of the front-end and range DPU reconfiguration (40 MHz ticks)
+        DebugP_logInfo("Profile applied in %u ticks, pipeline kept\n", Cycleprofiler_getTimeStamp() - startTicks);
+        return 0;
+    }
+
+    /* release the cubes and products of the previous profile (the cached windows stay) */
+    if (MemRegion_rewind(&gSysContext.memRegions, RANGEPROC_MEM_CHECKPOINT_PIPELINE) != 0) {
+        return -1;
+    }
+    if (RangeProc_configPipeline() != SystemP_SUCCESS) {
+        return -1;
+    }
+    for (regionIdx = 0; regionIdx < gSysContext.memRegions.numRegions; regionIdx++) {
+        RangeProc_logPoolUsage(regionIdx);
+    }
+
+    // benchmark: duration of the front-end and pipeline reconfiguration (40 MHz ticks)
+    DebugP_logInfo("Profile applied in %u ticks\n", Cycleprofiler_getTimeStamp() - startTicks);
+    return 0;
+}
+
+/**
+ * @brief Arms the range DPU and restarts the sensor (ConfigCmd_Ops).
+ */
+static int32_t RangeProc_cmdStartSensor(void *arg) {
+    (void)arg;
+    if (DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle, DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0) < 0) {
+        return -1;
+    }
+    return (mmwave_startSensor() == SystemP_SUCCESS) ? 0 : -1;
+}
+
+/*! @brief Sensor and pipeline operations of the runtime reconfiguration */
+static const ConfigCmd_Ops gConfigCmdOps = {
+    .stopSensor   = RangeProc_cmdStopSensor,
+    .applyProfile = RangeProc_cmdApplyProfile,
+    .startSensor  = RangeProc_cmdStartSensor,
+    .arg          = NULL
+};
+#endif
+
+#if RANGEPROC_RECOVERY_ENABLE
+/**
+ * @brief Triggers the range DPU for the next frame (Recovery_Ops).
+ */
+static int32_t RangeProc_recoverRearm(void *arg) {
+    (void)arg;
+    return (DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle, DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0) < 0) ? -1 : 0;
+}
+
+/**
+ * @brief Resets the HWA, re-applies the range DPU configuration and triggers the DPU (Recovery_Ops).
+ */
+static int32_t RangeProc_recoverReset(void *arg) {
+    /* the stages program their HWA param sets every frame, so only the range DPU is configured
+       again, which re-programs its HWA param sets and EDMA channels as well */
+    HWA_enable(gSysContext.hwaHandle, 0);
+    if (HWA_reset(gSysContext.hwaHandle) != 0) {
+        return -1;
+    }
+    if (DPU_RangeProcHWA_config(gSysContext.rangeProcHWADpuHandle, &gSysContext.rangeProcDpuCfg) < 0) {
+        return -1;
+    }
+    return RangeProc_recoverRearm(arg);
+}
+
+/**
+ * @brief Stops the sensor, rebuilds the pipeline, triggers the DPU and restarts the sensor (Recovery_Ops).
+ */
+static int32_t RangeProc_recoverRestart(void *arg) {
+    /* the sensor may not run anymore, so a failing stop is not an error */
+    (void)mmwave_stopSensor();
+#if SPI_CMD_CHANNEL_ENABLE
+    /* after a failed reconfiguration the front end may hold a partly applied profile */
+    if ((gSysContext.configCmd.state == CONFIG_CMD_STATE_FAILED) &&
+        (mmwave_applyProfile(&gSysContext.configCmd.active) != SystemP_SUCCESS)) {
+        return -1;
+    }
+#endif
+#if SUBFRAME_ENABLE
+    /* RangeProc_config() starts with sub-frame 0 */
+    if (mmwave_reconfigSensor(0) != SystemP_SUCCESS) {
+        return -1;
+    }
+#endif
+    if (MemRegion_rewind(&gSysContext.memRegions, RANGEPROC_MEM_CHECKPOINT_PIPELINE) != 0) {
+        return -1;
+    }
+    if (RangeProc_configPipeline() != SystemP_SUCCESS) {
+        return -1;
+    }
+    if (RangeProc_recoverRearm(arg) != 0) {
+        return -1;
+    }
+    if (mmwave_startSensor() != SystemP_SUCCESS) {
+        return -1;
+    }
+#if SPI_CMD_CHANNEL_ENABLE
+    /* the active profile runs again, so commands are accepted (lastResult still reports the failure) */
+    if (gSysContext.configCmd.state == CONFIG_CMD_STATE_FAILED) {
+        gSysContext.configCmd.state = CONFIG_CMD_STATE_RUNNING;
+    }
+#endif
+    return 0;
+}
+
+/*! @brief Pipeline operations of the recovery */
+static const Recovery_Ops gRecoveryOps = {
+    .rearm   = RangeProc_recoverRearm,
+    .reset   = RangeProc_recoverReset,
+    .restart = RangeProc_recoverRestart,
+    .arg     = NULL
+};
+#endif
+
+/**
+ * @brief Handles an error of the frame loop: recovers the pipeline (see recovery.h), or stops in
+ *        DebugP_assert() without RANGEPROC_RECOVERY_ENABLE and once the recovery gave up.
+ */
+static void RangeProc_recover(uint32_t fault, uint32_t dropped, int32_t errCode) {
+#if RANGEPROC_RECOVERY_ENABLE
+    int32_t level = Recovery_handleFault(&gSysContext.recovery, fault, dropped, &gRecoveryOps);
+
+    if (level != RECOVERY_ERR_FAILED) {
+        DebugP_log("Recovered from %s fault (error %d) by %s, %u faults since boot\n", Recovery_faultName(fault),
+                   errCode, Recovery_levelName(level), gSysContext.recovery.numFaults);
+        return;
+    }
+    DebugP_log("Error: recovery from %s fault (error %d) failed\n", Recovery_faultName(fault), errCode);
+#else
+    (void)fault;
+    (void)dropped;
+    (void)errCode;
+#endif
+    DebugP_assert(0);
+}
 
 void spiTask() {
     spi_transmit_loop();
@@ -90,16 +448,38 @@ void spiTask() {
 void dpcTask() {
     int32_t retVal = -1;
     DPU_RangeProcHWA_OutParams outParams;
+    uint32_t frameIdx = 0;
+    uint32_t firstFrame = 1U;
+    uint32_t regionIdx;
 
     gChirpCount = 0;
     gFrameCount = 0;
     
-    DPC_ObjDet_MemPoolReset(&gSysContext.L3RamObj);
-    DPC_ObjDet_MemPoolReset(&gSysContext.CoreLocalRamObj);
+    MemRegion_reset(&gSysContext.memRegions);
 
-    /* configure DPUs: */
-    RangeProc_config();
-    // TODO: configure rest of DPUs if required
+    /* the command slot outlives every pipeline configuration */
+    if (spi_cmdSlotConfig() != SystemP_SUCCESS) {
+        DebugP_log("Error: SPI command slot configuration failed\n");
+        DebugP_assert(0);
+    }
+
+    /* the windows outlive every pipeline configuration as well, so that a rebuild reuses them */
+    if (RangeProc_initWindows() != SystemP_SUCCESS) {
+        DebugP_log("Error: range window pool allocation failed\n");
+        DebugP_assert(0);
+    }
+
+    /* everything allocated by the configuration below can be released by rewinding to this scope */
+    (void)MemRegion_pushCheckpoint(&gSysContext.memRegions, RANGEPROC_MEM_CHECKPOINT_PIPELINE);
+    RangeProc_initConfigCmd();
+
+    /* configure DPUs and products: */
+    if (RangeProc_configPipeline() != SystemP_SUCCESS) {
+        DebugP_assert(0);
+    }
+    for (regionIdx = 0; regionIdx < gSysContext.memRegions.numRegions; regionIdx++) {
+        RangeProc_logPoolUsage(regionIdx);
+    }
 
     SemaphoreP_post(&dpcCfgDoneSemHandle);
     
@@ -121,6 +501,8 @@ void dpcTask() {
         DebugP_assert(0);
     }
 
+    Recovery_init(&gSysContext.recovery);
+
     // give initial trigger for the first frame 
     retVal = DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle, DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0);
     if (retVal < 0) {
@@ -134,25 +516,140 @@ void dpcTask() {
         
         memset((void *)&outParams, 0, sizeof(DPU_RangeProcHWA_OutParams));
 
+        // on an error the frame is dropped and the recovery re-arms the DPU for the next one
         retVal = DPU_RangeProcHWA_process(gSysContext.rangeProcHWADpuHandle, &outParams);
         if (retVal < 0) {
             /* Not Expected */
             DebugP_log("RangeProc DPU process error %d\n", retVal);
-            DebugP_assert(0);
+            RangeProc_recover(RECOVERY_FAULT_PROCESS, 1U, retVal);
+            frameIdx++;
+            continue;
+        }
+
+#if DOPPLERPROC_ENABLE
+        // range-Doppler heatmap (HWA is idle until the next trigger)
+        if (DopplerProc_process(&gSysContext.dopplerProcTicks) != SystemP_SUCCESS) {
+            DebugP_log("Error: Doppler stage processing failed\n");
+            RangeProc_recover(RECOVERY_FAULT_STAGE, 1U, SystemP_FAILURE);
+            frameIdx++;
+            continue;
+        }
+#endif
+
+#if CFARPROC_ENABLE
+        // detection list on the range profile or the range-Doppler heatmap
+        if (CfarProc_process() != SystemP_SUCCESS) {
+            DebugP_log("Error: CFAR stage processing failed\n");
+            RangeProc_recover(RECOVERY_FAULT_STAGE, 1U, SystemP_FAILURE);
+            frameIdx++;
+            continue;
         }
+#endif
+
+#if DOAPROC_ENABLE
+        // range-azimuth heatmap and angles of the detections
+        if (DoaProc_process() != SystemP_SUCCESS) {
+            DebugP_log("Error: DoA stage processing failed\n");
+            RangeProc_recover(RECOVERY_FAULT_STAGE, 1U, SystemP_FAILURE);
+            frameIdx++;
+            continue;
+        }
+#endif
+
+#if UDOPPROC_ENABLE
+        // micro-Doppler spectrogram column of the range window
+        if (MicroDopplerProc_process() != SystemP_SUCCESS) {
+            DebugP_log("Error: micro-Doppler stage processing failed\n");
+            RangeProc_recover(RECOVERY_FAULT_STAGE, 1U, SystemP_FAILURE);
+            frameIdx++;
+            continue;
+        }
+#endif
+
+        // measure the radar cube and compute the data products derived from it
+        RangeProc_computeCubeStats();
+        streamProducts_process(frameIdx);
+        if (firstFrame != 0U) {
+            BootReport_mark(&gSysContext.bootReport, BOOT_PHASE_FIRST_FRAME, Cycleprofiler_getTimeStamp());
+        }
+
         // trigger SPI transmission
+        gSysContext.spiTxFailed = 0U;
         SemaphoreP_post(&spi_tx_start_sem);
 
         // wait for SPI transmission to complete
         SemaphoreP_pend(&spi_tx_done_sem, SystemP_WAIT_FOREVER);
 
+#if RANGEPROC_RECOVERY_ENABLE
+        // the host lost the rest of the frame, the next one starts with a resync marker
+        if (gSysContext.spiTxFailed != 0U) {
+            RangeProc_recover(RECOVERY_FAULT_SPI, 1U, SystemP_FAILURE);
+        } else {
+            Recovery_frameDone(&gSysContext.recovery, frameIdx);
+        }
+#endif
+
+        // benchmark: restart latency, the boot report is streamed with the next frame
+        if (firstFrame != 0U) {
+            firstFrame = 0U;
+            BootReport_mark(&gSysContext.bootReport, BOOT_PHASE_FIRST_TX, Cycleprofiler_getTimeStamp());
+            DebugP_log("First frame on the wire %u ticks after freertos_main (first frame %u, tx %u)\n",
+                       BootReport_sumTicks(&gSysContext.bootReport.payload, BOOT_PHASE_DRIVERS, BOOT_PHASE_FIRST_TX),
+                       gSysContext.bootReport.payload.phaseTicks[BOOT_PHASE_FIRST_FRAME],
+                       gSysContext.bootReport.payload.phaseTicks[BOOT_PHASE_FIRST_TX]);
+        }
+        frameIdx++;
+
+        // adapt the range FFT scaling for the next frame (HWA is idle until triggered)
+        retVal = RangeProc_autoScale();
+        if (retVal < 0) {
+            DebugP_log("Error: range FFT auto-scaling reconfiguration failed with error code %d", retVal);
+            RangeProc_recover(RECOVERY_FAULT_STAGE, 0U, retVal);
+            continue;
+        }
+
+#if SPI_CMD_CHANNEL_ENABLE
+        // apply a profile received in the command slot (stop, reconfigure, trigger and restart)
+        retVal = ConfigCmd_service(&gSysContext.configCmd, &gConfigCmdOps);
+        if (retVal < 0) {
+            DebugP_log("Error: reconfiguration failed, the previous profile could not be restored\n");
+            RangeProc_recover(RECOVERY_FAULT_SENSOR, 0U, retVal);
+            continue;
+        }
+        if (retVal > 0) {
+            DebugP_log("Profile %s (command %u)\n",
+                       (gSysContext.configCmd.lastResult == CONFIG_CMD_OK) ? "applied" : "rejected, previous profile restored",
+                       gSysContext.configCmd.lastSequence);
+            continue;
+        }
+#endif
+
+#if SUBFRAME_ENABLE
+        // stop the sensor and switch the front end and the range DPU to the next sub-frame
+        retVal = RangeProc_switchSubFrame(SubFrame_next(gSysContext.subFrameIdx, SUBFRAME_NUM));
+        if (retVal < 0) {
+            DebugP_log("Error: sub-frame switch failed with error code %d", retVal);
+            RangeProc_recover(RECOVERY_FAULT_SENSOR, 0U, retVal);
+            continue;
+        }
+#endif
+
         /* give initial trigger for the next frame */
         retVal = DPU_RangeProcHWA_control(gSysContext.rangeProcHWADpuHandle,
                     DPU_RangeProcHWA_Cmd_triggerProc, NULL, 0);
         if (retVal < 0) {
             DebugP_log("Error: DPU_RangeProcHWA_control failed with error code %d", retVal);
-            DebugP_assert(0);
+            RangeProc_recover(RECOVERY_FAULT_TRIGGER, 0U, retVal);
+            continue;
         }
+
+#if SUBFRAME_ENABLE
+        // restart the sensor once the DPU waits for the chirps of the new sub-frame
+        if (mmwave_startSensor() != SystemP_SUCCESS) {
+            DebugP_log("Error: sensor restart after the sub-frame switch failed\n");
+            RangeProc_recover(RECOVERY_FAULT_SENSOR, 0U, SystemP_FAILURE);
+        }
+#endif
     }
 }
 
@@ -169,12 +666,232 @@ void rangeProc_dpuInit() {
     }
 }
 
-void RangeProc_config() {
+/**
+ * @brief Returns the Blackman range window for a number of ADC samples.
+ *
+ * The window is taken from the cache, from the precomputed table of
+ * window_table.h if it was generated for this number of ADC samples, or
+ * allocated from the window pool, generated and added to the cache.
+ *
+ * @param[in]  numAdcSamples  number of ADC samples per chirp
+ * @param[out] windowSize     size of the symmetric window in bytes
+ *
+ * @retval window, NULL if the window pool is exhausted
+ */
+static int32_t *RangeProc_getWindow(uint32_t numAdcSamples, uint32_t *windowSize) {
+    const RangeReconfig_Window *cached;
+    RangeReconfig_Window entry;
+
+    cached = RangeReconfig_findWindow(&gWindowCache, numAdcSamples, MATHUTILS_WIN_BLACKMAN, DPC_OBJDET_QFORMAT_RANGE_FFT);
+    if (cached != NULL) {
+        *windowSize = cached->windowSize;
+        return cached->window;
+    }
+
+    entry.numAdcSamples = numAdcSamples;
+    entry.winType       = MATHUTILS_WIN_BLACKMAN;
+    entry.qFormat       = DPC_OBJDET_QFORMAT_RANGE_FFT;
+    entry.windowSize    = sizeof(uint32_t) * ((numAdcSamples + 1) / 2); // symmetric window (Blackman), for real samples (therefore /2)
+    entry.window        = NULL;
+
+#if RANGEPROC_WINDOW_TABLE_ENABLE
+    if (numAdcSamples == WINDOW_TABLE_NUM_ADC_SAMPLES) {
+        // only read by DPU_RangeProcHWA_config(), which copies it to the HWA window RAM
+        entry.window = (int32_t *)gWindowTable;
+    }
+#endif
+
+#if RANGEPROC_WINDOW_TABLE_ENABLE && !RANGEPROC_WINDOW_TABLE_CHECK
+    if (entry.window == NULL)
+#endif
+    {
+        int32_t *generated = (int32_t *)DPC_ObjDet_MemPoolAllocTagged(&gWindowPool,
+                                                                      entry.windowSize,
+                                                                      sizeof(uint32_t),
+                                                                      "rangeWindow");
+        if (generated == NULL) {
+            return NULL;
+        }
+        mathUtils_genWindow((uint32_t *)generated,
+                            numAdcSamples,
+                            entry.windowSize/sizeof(uint32_t),
+                            MATHUTILS_WIN_BLACKMAN,
+                            DPC_OBJDET_QFORMAT_RANGE_FFT);
+
+        if (entry.window == NULL) {
+            entry.window = generated;
+        } else if (memcmp(entry.window, generated, entry.windowSize) != 0) {
+            DebugP_log("Warning: precomputed range window differs from mathUtils_genWindow(), using the generated one\n");
+            entry.window = generated;
+        }
+    }
+
+    // a window which does not fit into a full cache is still used, RangeProc_config() empties the
+    // cache and the pool once they run full
+    (void)RangeReconfig_addWindow(&gWindowCache, &entry);
+
+    *windowSize = entry.windowSize;
+    return entry.window;
+}
+
+/**
+ * @brief Extracts the parameters compared by RangeReconfig_isChanged() from a DPU configuration.
+ */
+static void RangeProc_getReconfigParams(const DPU_RangeProcHWA_Config *cfg, RangeReconfig_Params *reconfigParams) {
+    const DPU_RangeProcHWA_StaticConfig *params = &cfg->staticCfg;
+
+    reconfigParams->fftOutputDivShift        = params->rangeFFTtuning.fftOutputDivShift;
+    reconfigParams->numButterflyStagesScaled = params->rangeFFTtuning.numLastButterflyStagesToScale;
+    reconfigParams->window                   = params->window;
+    reconfigParams->windowSize               = params->windowSize;
+    reconfigParams->numAdcSamples            = params->ADCBufData.dataProperty.numAdcSamples;
+    reconfigParams->rangeFftSize             = params->rangeFftSize;
+    reconfigParams->numRangeBins             = params->numRangeBins;
+    reconfigParams->numChirpsPerFrame        = params->numChirpsPerFrame;
+    reconfigParams->numDopplerChirpsPerFrame = params->numDopplerChirpsPerFrame;
+    reconfigParams->numTxAntennas            = params->numTxAntennas;
+    reconfigParams->numVirtualAntennas       = params->numVirtualAntennas;
+    reconfigParams->isBpmEnabled             = params->isBpmEnabled;
+    reconfigParams->adcDataSize              = params->ADCBufData.dataSize;
+    reconfigParams->adcRxChanStride          = params->ADCBufData.dataProperty.rxChanOffset[1];
+    reconfigParams->cube                     = cfg->hwRes.radarCube.data;
+    reconfigParams->cubeBytes                = cfg->hwRes.radarCube.dataSize;
+}
+
+/**
+ * @brief Sets the ADC buffer, range FFT size and scaling and the window of a range DPU configuration.
+ *
+ * @param[in,out] params         static configuration, all other parameters are kept
+ * @param[in]     numAdcSamples  number of ADC samples per chirp
+ * @param[in]     extraShift     additional range FFT shift of the chirp accumulation (see chirp_accum.h)
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE if the window pool is exhausted
+ */
+static int32_t RangeProc_setAdcParams(DPU_RangeProcHWA_StaticConfig *params, uint32_t numAdcSamples,
+                                      uint32_t extraShift) {
+    uint32_t bytesPerRxChan;
+    uint32_t index;
+
+    /* ADC buffer and range FFT, see RangeProc_config() */
+    params->ADCBufData.dataSize = numAdcSamples * gSysContext.numRxAntennas * sizeof(uint16_t) * 2;
+    params->ADCBufData.dataProperty.numAdcSamples = numAdcSamples;
+    params->rangeFftSize = numAdcSamples;
+    bytesPerRxChan = numAdcSamples * sizeof(uint16_t);
+    bytesPerRxChan = (bytesPerRxChan + 15) / 16 * 16;
+    for (index = 0; index < SYS_COMMON_NUM_RX_CHANNEL; index++) {
+        params->ADCBufData.dataProperty.rxChanOffset[index] = index * bytesPerRxChan;
+    }
+
+    if (extraShift > 0U) {
+        uint8_t divShift;
+        uint8_t numButterflyStages;
+
+        FftAutoScale_splitShift(&gSysContext.fftAutoScaleCfg,
+                                (uint8_t)(RANGEPROC_FFT_OUTPUT_DIV_SHIFT + RANGEPROC_FFT_NUM_BUTTERFLY_STAGES + extraShift),
+                                &divShift, &numButterflyStages);
+        params->rangeFFTtuning.fftOutputDivShift             = divShift;
+        params->rangeFFTtuning.numLastButterflyStagesToScale = numButterflyStages;
+    } else {
+        params->rangeFFTtuning.fftOutputDivShift             = RANGEPROC_FFT_OUTPUT_DIV_SHIFT;
+        params->rangeFFTtuning.numLastButterflyStagesToScale = RANGEPROC_FFT_NUM_BUTTERFLY_STAGES;
+    }
+
+    /* shared with the other configurations of the same number of ADC samples */
+    params->window = RangeProc_getWindow(numAdcSamples, &params->windowSize);
+    return (params->window != NULL) ? SystemP_SUCCESS : SystemP_FAILURE;
+}
+
+#if SUBFRAME_ENABLE
+/**
+ * @brief Derives the range DPU configurations of all sub-frames from the one of
+ *        sub-frame 0 in gSysContext.rangeProcDpuCfg.
+ *
+ * Only the parameters which depend on the sub-frame are changed, the EDMA and
+ * HWA resources are shared. The windows and cubes are allocated as planned by
+ * SubFrame_plan().
+ *
+ * @retval SystemP_SUCCESS on success, SystemP_FAILURE if an allocation failed
+ */
+static int32_t RangeProc_configSubFrames(void) {
+    uint32_t subFrameIdx;
+
+    gSysContext.subFrameDpuCfg[0] = gSysContext.rangeProcDpuCfg;
+
+    for (subFrameIdx = 1; subFrameIdx < SUBFRAME_NUM; subFrameIdx++) {
+        const SubFrame_Config *subFrameCfg = &gSubFrameCfg[subFrameIdx];
+        const SubFrame_Layout *layout = &gSysContext.subFramePlan.layout[subFrameIdx];
+        DPU_RangeProcHWA_Config *dpuCfg = &gSysContext.subFrameDpuCfg[subFrameIdx];
+        DPU_RangeProcHWA_StaticConfig *params = &dpuCfg->staticCfg;
+        int32_t retVal;
+
+        *dpuCfg = gSysContext.rangeProcDpuCfg;
+
+        params->numRangeBins             = layout->numRangeBins;
+        params->numChirpsPerFrame        = layout->numChirpsPerFrame;
+        params->numDopplerChirpsPerFrame = layout->numDopplerChirpsPerFrame;
+        params->numDopplerChirpsPerProc  = layout->numDopplerChirpsPerFrame;
+
+        /* own cube and (shared if the number of ADC samples matches) window, allocated
+           once so that a switch only re-applies the configuration */
+        retVal = RangeProc_setAdcParams(params, subFrameCfg->numAdcSamples, layout->extraShift);
+        dpuCfg->hwRes.radarCube.dataSize = layout->cubeBytes;
+        dpuCfg->hwRes.radarCube.data = (cmplx16ImRe_t *)MemRegion_alloc(&gSysContext.memRegions,
+                                                                        dpuCfg->hwRes.radarCube.dataSize,
+                                                                        sizeof(uint32_t),
+                                                                        MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                                                        MEM_REGION_POLICY_LARGEST_FREE,
+                                                                        "radarCube",
+                                                                        NULL);
+        if ((retVal != SystemP_SUCCESS) || (dpuCfg->hwRes.radarCube.data == NULL)) {
+            DebugP_log("Error allocating the window or radar cube of sub-frame %u\n", subFrameIdx);
+            return SystemP_FAILURE;
+        }
+        DebugP_log("Sub-frame %u: %u range bins, %u doppler chirps, cube %u bytes\n",
+                   subFrameIdx, layout->numRangeBins, layout->numDopplerChirpsPerFrame, layout->cubeBytes);
+    }
+    return SystemP_SUCCESS;
+}
+#endif
+
+int32_t RangeProc_config() {
     DPU_RangeProcHWA_HW_Resources *pHwConfig = &gSysContext.rangeProcDpuCfg.hwRes;
     DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    /* front-end configuration of defines.h (sub-frame 0) or of the profile applied at runtime */
+    uint32_t numAdcSamples = gSysContext.profileComCfg.h_NumOfAdcSamples;
+    uint32_t mimoSel = gSysContext.profileComCfg.c_ChirpTxMimoPatSel;
     uint32_t bytesPerRxChan;
+    CubeBudget_Config cubeBudgetCfg;
+    CubeBudget_Report cubeBudget;
+    ChirpAccum_Config accumCfg;
+    ChirpAccum_Dims accumDims;
 
     memset((void *)&gSysContext.rangeProcDpuCfg, 0, sizeof(DPU_RangeProcHWA_Config));
+    gSysContext.subFrameIdx = 0;
+
+    /* no window is in use anymore: the cached ones are only dropped if the windows of this
+       configuration might not fit next to them */
+    if (gWindowCache.numEntries + RANGEPROC_NUM_CONFIG_WINDOWS > RANGE_RECONFIG_MAX_WINDOWS) {
+        RangeReconfig_initWindowCache(&gWindowCache);
+        DPC_ObjDet_MemPoolReset(&gWindowPool);
+    }
+
+#if SUBFRAME_ENABLE
+    /* place the cubes and windows of all sub-frames up front, so that a switch allocates nothing */
+    {
+        uint32_t freeSharedBytes = MemRegion_getLargestFree(&gSysContext.memRegions,
+                                                            MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA);
+        uint32_t freeWindowBytes = DPC_ObjDet_MemPoolGetFree(&gWindowPool);
+
+        if (SubFrame_plan(gSubFrameCfg, SUBFRAME_NUM, gSysContext.numTxAntennas, gSysContext.numRxAntennas,
+                          (freeSharedBytes > RANGEPROC_PRODUCT_RESERVE) ? (freeSharedBytes - RANGEPROC_PRODUCT_RESERVE) : 0U,
+                          freeWindowBytes, &gSysContext.subFramePlan) != 0) {
+            DebugP_log("Error: invalid sub-frames or memory exceeded: cubes %u of %u bytes, windows %u of %u bytes\n",
+                       gSysContext.subFramePlan.cubeBytes, freeSharedBytes,
+                       gSysContext.subFramePlan.windowBytes, freeWindowBytes);
+            return SystemP_FAILURE;
+        }
+    }
+#endif
 
     // disable low power mode
     params->lowPowerMode = 0;
@@ -188,18 +905,30 @@ void RangeProc_config() {
     /* number of RX antennas, product of TX- and RX-antennas (on the IWRL6432BOOST 2*3=6) */
     params->numVirtualAntennas = gSysContext.numTxAntennas * gSysContext.numRxAntennas;
     /* size of real part of range FFT: half of the range FFT size, since the ADC samples are real valued*/
-    params->numRangeBins = CLI_NUM_RBINS; //CLI_NUM_ADC_SAMPLES/2;
-    /* number of chirps per frame (= number of chirps per burst, if Nburst = 1) */
-    params->numChirpsPerFrame = CLI_NUM_BURSTS_PER_FRAME * CLI_NUM_CHIRPS_PER_BURST;
+    params->numRangeBins = mathUtils_pow2roundup(numAdcSamples) / 2; // as CLI_NUM_RBINS
+    /* chirp accumulation: the front end sums numOfChirpsAccum chirps into one ADC buffer chirp */
+    accumCfg.numChirpsPerBurst  = gSysContext.frameCfg.h_NumOfChirpsInBurst;
+    accumCfg.numBurstsPerFrame  = gSysContext.frameCfg.h_NumOfBurstsInFrame;
+    accumCfg.numChirpsAccum     = gSysContext.frameCfg.c_NumOfChirpsAccum;
+    accumCfg.numTxAntennas      = gSysContext.numTxAntennas;
+    accumCfg.numVirtualAntennas = params->numVirtualAntennas;
+    accumCfg.numRangeBins       = params->numRangeBins;
+    if (ChirpAccum_compute(&accumCfg, &accumDims) != 0) {
+        DebugP_log("Error: %u chirps per burst can not be accumulated by %u for %u TX antennas\n",
+                   accumCfg.numChirpsPerBurst, ChirpAccum_getFactor(accumCfg.numChirpsAccum), accumCfg.numTxAntennas);
+        return SystemP_FAILURE;
+    }
+    /* number of chirps per frame seen by the DPU (= number of chirps per burst, if Nburst = 1 and no accumulation) */
+    params->numChirpsPerFrame = accumDims.numChirpsPerFrame;
     /* number of doppler chirps per frame (derived from rangeproc init example): one doppler chirp each set of TX antennas */
-    params->numDopplerChirpsPerFrame = params->numChirpsPerFrame / gSysContext.numTxAntennas;
+    params->numDopplerChirpsPerFrame = accumDims.numDopplerChirpsPerFrame;
     /* number of doppler chirps per processing evolution: only differs from numDopplerChirpsPerFrame with minor motion mode*/
     params->numDopplerChirpsPerProc = params->numDopplerChirpsPerFrame;
     /* BPM / TDM MIMO enable */
-    if ((CLI_MIMO_SEL == 1) || (CLI_MIMO_SEL == 0)) {
+    if ((mimoSel == 1) || (mimoSel == 0)) {
         /* TDM-MIMO*/
         params->isBpmEnabled = FALSE;
-    } else if (CLI_MIMO_SEL == 4) {
+    } else if (mimoSel == 4) {
         /* BPM-MIMO*/
         params->isBpmEnabled = TRUE;
     } else {
@@ -208,14 +937,11 @@ void RangeProc_config() {
     }
 
     /* windowing */
-    params->windowSize = sizeof(uint32_t) * ((CLI_NUM_ADC_SAMPLES +1 ) / 2); // symmetric window (Blackman), for real samples (therefore /2)
-    params->window =  (int32_t *)DPC_ObjDet_MemPoolAlloc(&gSysContext.CoreLocalRamObj,
-                                                        params->windowSize,
-                                                        sizeof(uint32_t));
+    params->window = RangeProc_getWindow(numAdcSamples, &params->windowSize);
 
     if (params->window == NULL) {
         DebugP_log("Error allocating window memory");
-        return;
+        return SystemP_FAILURE;
     }
 
     /* adc buffer buffer, format fixed, interleave, size will change */
@@ -227,24 +953,42 @@ void RangeProc_config() {
 
     /* dataSize defines the size of buffer that holds ADC data of every chirp */
     /* ADCBufData.dataSize omitted due to forum post: https://e2e.ti.com/support/sensors-group/sensors/f/sensors-forum/1324580/awrl6432boost-adc-buffer-data-size-in-motion-and-presence-detection-demo */
-    params->ADCBufData.dataSize = CLI_NUM_ADC_SAMPLES * gSysContext.numRxAntennas * sizeof(uint16_t) * 2; // times 2, because of ping and pong C:\ti\mmwave-sdk\docs\MotionPresenceDetectionDemo_documentation.pdf 
-    params->ADCBufData.dataProperty.numAdcSamples = CLI_NUM_ADC_SAMPLES;
-    
-    mathUtils_genWindow((uint32_t *)params->window,
-                                (uint32_t) params->ADCBufData.dataProperty.numAdcSamples,
-                                params->windowSize/sizeof(uint32_t),
-                                MATHUTILS_WIN_BLACKMAN,
-                                DPC_OBJDET_QFORMAT_RANGE_FFT);
+    params->ADCBufData.dataSize = numAdcSamples * gSysContext.numRxAntennas * sizeof(uint16_t) * 2; // times 2, because of ping and pong C:\ti\mmwave-sdk\docs\MotionPresenceDetectionDemo_documentation.pdf 
+    params->ADCBufData.dataProperty.numAdcSamples = numAdcSamples;
 
     /* FFT optimizing params (derived from rangeproc DPU example) */
-    params->rangeFFTtuning.fftOutputDivShift = 2;
-    params->rangeFFTtuning.numLastButterflyStagesToScale = 0; /* no scaling needed as ADC is 16-bit and we have 8 bits to grow */  
+    params->rangeFFTtuning.fftOutputDivShift = RANGEPROC_FFT_OUTPUT_DIV_SHIFT;
+    params->rangeFFTtuning.numLastButterflyStagesToScale = RANGEPROC_FFT_NUM_BUTTERFLY_STAGES; /* no scaling needed as ADC is 16-bit and we have 8 bits to grow */
+
+    /* closed-loop range FFT scaling, starts at the fixed values above */
+    gSysContext.fftAutoScaleCfg.minShift     = 0;
+    gSysContext.fftAutoScaleCfg.maxShift     = RANGEPROC_FFT_AUTOSCALE_MAX_SHIFT;
+    gSysContext.fftAutoScaleCfg.maxDivShift  = RANGEPROC_FFT_AUTOSCALE_MAX_DIV_SHIFT;
+    gSysContext.fftAutoScaleCfg.satThreshold = RANGEPROC_FFT_AUTOSCALE_SAT_THRESHOLD;
+    gSysContext.fftAutoScaleCfg.satCountUp   = RANGEPROC_FFT_AUTOSCALE_SAT_COUNT_UP;
+    gSysContext.fftAutoScaleCfg.headroomLow  = RANGEPROC_FFT_AUTOSCALE_HEADROOM_LOW;
+    gSysContext.fftAutoScaleCfg.framesDown   = RANGEPROC_FFT_AUTOSCALE_FRAMES_DOWN;
+    /* accumulated chirps grow by log2(accumFactor) bits, which is taken off the range FFT output */
+    if (accumDims.extraShift > 0U) {
+        uint8_t divShift;
+        uint8_t numButterflyStages;
+
+        FftAutoScale_splitShift(&gSysContext.fftAutoScaleCfg,
+                                (uint8_t)(RANGEPROC_FFT_OUTPUT_DIV_SHIFT + RANGEPROC_FFT_NUM_BUTTERFLY_STAGES + accumDims.extraShift),
+                                &divShift, &numButterflyStages);
+        params->rangeFFTtuning.fftOutputDivShift             = divShift;
+        params->rangeFFTtuning.numLastButterflyStagesToScale = numButterflyStages;
+        DebugP_log("Chirp accumulation x%u: cube %u bytes, range FFT shift +%u, SNR gain %d dB\n",
+                   accumDims.accumFactor, accumDims.cubeBytes, accumDims.extraShift, (int32_t)accumDims.snrGainDb);
+    }
+    FftAutoScale_init(&gSysContext.fftAutoScaleCfg, &gSysContext.fftAutoScaleState,
+                      RANGEPROC_FFT_OUTPUT_DIV_SHIFT + RANGEPROC_FFT_NUM_BUTTERFLY_STAGES + accumDims.extraShift);
 
     /* size of range FFT: equal to number of ADC samples*/
-    params->rangeFftSize = CLI_NUM_ADC_SAMPLES;
+    params->rangeFftSize = numAdcSamples;
 
     /* bytes per RX channel (each chirp is uint_16) */
-    bytesPerRxChan = CLI_NUM_ADC_SAMPLES * sizeof(uint16_t);
+    bytesPerRxChan = numAdcSamples * sizeof(uint16_t);
     bytesPerRxChan = (bytesPerRxChan + 15) / 16 * 16; // ensure that value is multiple of 16 (for EDMA?)
 
     /* initialize RX channel offsets */
@@ -258,8 +1002,18 @@ void RangeProc_config() {
 
     /* Set Motion Mode (Minor/Major) */
     params->enableMajorMotion = 1;
+#if RANGEPROC_MINOR_MOTION_ENABLE
+    /* the minor motion cube receives the first doppler chirps of every frame, it is
+       refilled each frame (one frame per minor motion processing), so the host
+       accumulates the minor motion cubes of consecutive frames itself */
+    params->enableMinorMotion = 1;
+    params->numMinorMotionChirpsPerFrame = RANGEPROC_NUM_MINOR_MOTION_CHIRPS;
+    params->numFramesPerMinorMotProc = 1;
+    params->frmCntrModNumFramesPerMinorMot = 0;
+#else
     params->enableMinorMotion = 0;
     params->numMinorMotionChirpsPerFrame = 0; // obsolete, not using minor motion
+#endif
 
     /* Data Input EDMA */
     pHwConfig->edmaInCfg.dataIn.channel         = DPC_OBJDET_DPU_RANGEPROC_EDMAIN_CH;
@@ -301,15 +1055,56 @@ void RangeProc_config() {
     pHwConfig->edmaOutCfg.path[1].dataOutMajor.channelShadow = DPC_OBJDET_DPU_RANGEPROC_EDMAOUT_MAJOR_PONG_SHADOW;
     pHwConfig->edmaOutCfg.path[1].dataOutMajor.eventQueue = DPC_OBJDET_DPU_RANGEPROC_EDMAOUT_MAJOR_PONG_EVENT_QUE;
    
+    /* check that the radar cube(s) fit into the shared memory before allocating them */
+    cubeBudgetCfg.numRangeBins       = params->numRangeBins;
+    cubeBudgetCfg.numVirtualAntennas = params->numVirtualAntennas;
+    cubeBudgetCfg.numMajorChirps     = params->numDopplerChirpsPerFrame;
+    cubeBudgetCfg.numMinorChirps     = params->numMinorMotionChirpsPerFrame;
+    cubeBudgetCfg.freeBytes          = MemRegion_getLargestFree(&gSysContext.memRegions,
+                                                                MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA);
+    cubeBudgetCfg.reserveBytes       = RANGEPROC_PRODUCT_RESERVE;
+    if (CubeBudget_check(&cubeBudgetCfg, &cubeBudget) != 0) {
+        DebugP_log("Error: radar cubes exceed the shared memory budget: major %u + minor %u bytes, reserve %u, free %u\n",
+                   cubeBudget.majorBytes, cubeBudget.minorBytes, cubeBudgetCfg.reserveBytes, cubeBudgetCfg.freeBytes);
+        return SystemP_FAILURE;
+    }
+    DebugP_log("Radar cubes: major %u + minor %u bytes, shared memory headroom %d bytes\n",
+               cubeBudget.majorBytes, cubeBudget.minorBytes, cubeBudget.headroomBytes);
+
     /* radar cube config*/
     /* total size of radar cube in bytes (num range bins x num virtual antennas x sizeof x num doppler chirps) */
-    pHwConfig->radarCube.dataSize = CLI_NUM_RBINS * params->numVirtualAntennas * sizeof(cmplx16ReIm_t) * params->numDopplerChirpsPerFrame;
+    pHwConfig->radarCube.dataSize = cubeBudget.majorBytes;
     pHwConfig->radarCube.datafmt = DPIF_RADARCUBE_FORMAT_6;
 
-        /* radar cube */
-    gSysContext.rangeProcDpuCfg.hwRes.radarCube.data  = (cmplx16ImRe_t *) DPC_ObjDet_MemPoolAlloc(&gSysContext.L3RamObj,
-                                                                                        pHwConfig->radarCube.dataSize,
-                                                                                        sizeof(uint32_t));
+        /* radar cube, written by the EDMA of the DPU */
+    gSysContext.rangeProcDpuCfg.hwRes.radarCube.data  = (cmplx16ImRe_t *) MemRegion_alloc(&gSysContext.memRegions,
+                                                                                          pHwConfig->radarCube.dataSize,
+                                                                                          sizeof(uint32_t),
+                                                                                          MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                                                                          MEM_REGION_POLICY_LARGEST_FREE,
+                                                                                          "radarCube",
+                                                                                          NULL);
+    if (pHwConfig->radarCube.data == NULL) {
+        DebugP_log("Error: not enough shared memory for the radar cube (%u bytes)\n", pHwConfig->radarCube.dataSize);
+        return SystemP_FAILURE;
+    }
+#if RANGEPROC_MINOR_MOTION_ENABLE
+    /* minor motion cube, same format, in the region with the most free bytes left */
+    pHwConfig->radarCubeMinMot.dataSize = cubeBudget.minorBytes;
+    pHwConfig->radarCubeMinMot.datafmt = DPIF_RADARCUBE_FORMAT_6;
+    pHwConfig->radarCubeMinMot.data = (cmplx16ImRe_t *) MemRegion_alloc(&gSysContext.memRegions,
+                                                                        pHwConfig->radarCubeMinMot.dataSize,
+                                                                        sizeof(uint32_t),
+                                                                        MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                                                        MEM_REGION_POLICY_LARGEST_FREE,
+                                                                        "radarCube",
+                                                                        NULL);
+    if (pHwConfig->radarCubeMinMot.data == NULL) {
+        DebugP_log("Error: not enough shared memory for the minor motion cube (%u bytes)\n",
+                   pHwConfig->radarCubeMinMot.dataSize);
+        return SystemP_FAILURE;
+    }
+#endif
     // bend global radar cube debug pointer to radar cube data 
     gRadarCubeDebugPtr = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
     /* Further non EDMA related HWA configurations */
@@ -335,14 +1130,158 @@ void RangeProc_config() {
     
     gAdcDataDebugPtr = params->ADCBufData.data;
 
+#if SUBFRAME_ENABLE
+    if (RangeProc_configSubFrames() != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+#endif
+
     /* configure HWA with set parameters */
     int32_t retVal;
     retVal = DPU_RangeProcHWA_config(gSysContext.rangeProcHWADpuHandle, &gSysContext.rangeProcDpuCfg);
  
     if (retVal < 0) {
         DebugP_log("DEBUG: RANGE DPU config return error:%d \n", retVal);
-        DebugP_assert(0);
+        return SystemP_FAILURE;
+    }
+    return SystemP_SUCCESS;
+}
+
+void RangeProc_computeCubeStats(void) {
+#if STREAM_FRAME_INFO_ENABLE || RANGEPROC_FFT_AUTOSCALE_ENABLE
+    DPU_RangeProcHWA_HW_Resources *pHwConfig = &gSysContext.rangeProcDpuCfg.hwRes;
+
+    FftAutoScale_computeStats((const int16_t *)pHwConfig->radarCube.data,
+                              pHwConfig->radarCube.dataSize / sizeof(int16_t),
+                              gSysContext.fftAutoScaleCfg.satThreshold,
+                              &gSysContext.cubeStats);
+#endif
+}
+
+int32_t RangeProc_autoScale(void) {
+    int32_t retVal = SystemP_SUCCESS;
+#if RANGEPROC_FFT_AUTOSCALE_ENABLE
+    DPU_RangeProcHWA_Config newCfg = gSysContext.rangeProcDpuCfg;
+    DPU_RangeProcHWA_StaticConfig *params = &newCfg.staticCfg;
+    FftAutoScale_State newState = gSysContext.fftAutoScaleState;
+    uint8_t divShift;
+    uint8_t numButterflyStages;
+
+    if (FftAutoScale_update(&gSysContext.fftAutoScaleCfg, &newState, &gSysContext.cubeStats) == 0) {
+        gSysContext.fftAutoScaleState = newState;
+        return retVal;
+    }
+
+    FftAutoScale_splitShift(&gSysContext.fftAutoScaleCfg, newState.shift, &divShift, &numButterflyStages);
+    params->rangeFFTtuning.fftOutputDivShift             = divShift;
+    params->rangeFFTtuning.numLastButterflyStagesToScale = numButterflyStages;
+
+    /* only the scaling differs, memory and window of the existing configuration are reused;
+       the controller keeps the applied shift if the DPU rejects the new one */
+    retVal = RangeProc_reconfig(&newCfg);
+    if (retVal == SystemP_SUCCESS) {
+        gSysContext.fftAutoScaleState = newState;
+    }
+#endif
+    return retVal;
+}
+
+int32_t RangeProc_reconfig(const DPU_RangeProcHWA_Config *newCfg) {
+    RangeReconfig_Params curParams;
+    RangeReconfig_Params newParams;
+    DPU_RangeProcHWA_Config cfg;
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    int32_t retVal;
+
+    RangeProc_getReconfigParams(&gSysContext.rangeProcDpuCfg, &curParams);
+    RangeProc_getReconfigParams(newCfg, &newParams);
+    if (RangeReconfig_isChanged(&curParams, &newParams) == 0) {
+        return SystemP_SUCCESS;
+    }
+
+    /* the SDK offers no public API to patch individual HWA param sets or EDMA
+       channels, so the configuration is re-applied as a whole: unlike
+       RangeProc_config() this neither clears the configuration nor allocates
+       memory or regenerates the window */
+    cfg = *newCfg;
+    retVal = DPU_RangeProcHWA_config(gSysContext.rangeProcHWADpuHandle, &cfg);
+    if (retVal < 0) {
+        /* gSysContext.rangeProcDpuCfg stays the last accepted configuration, which the recovery re-applies */
+        DebugP_log("Error: range DPU reconfiguration failed (%d)\n", retVal);
+        return retVal;
+    }
+    gSysContext.rangeProcDpuCfg = cfg;
+
+    // benchmark: duration of the reconfiguration (40 MHz ticks)
+    DebugP_logInfo("Range DPU reconfigured in %u ticks\n", Cycleprofiler_getTimeStamp() - startTicks);
+    return retVal;
+}
+
+int32_t RangeProc_reconfigProfile(void) {
+    int32_t retVal = SystemP_FAILURE;
+#if !SUBFRAME_ENABLE
+    DPU_RangeProcHWA_Config newCfg = gSysContext.rangeProcDpuCfg;
+    DPU_RangeProcHWA_StaticConfig *params = &newCfg.staticCfg;
+    uint32_t numAdcSamples = gSysContext.profileComCfg.h_NumOfAdcSamples;
+    uint32_t mimoSel = gSysContext.profileComCfg.c_ChirpTxMimoPatSel;
+    ChirpAccum_Config accumCfg;
+    ChirpAccum_Dims accumDims;
+
+    /* the cube shape sizes the cubes and everything after the range DPU, see RangeProc_config() */
+    accumCfg.numChirpsPerBurst  = gSysContext.frameCfg.h_NumOfChirpsInBurst;
+    accumCfg.numBurstsPerFrame  = gSysContext.frameCfg.h_NumOfBurstsInFrame;
+    accumCfg.numChirpsAccum     = gSysContext.frameCfg.c_NumOfChirpsAccum;
+    accumCfg.numTxAntennas      = params->numTxAntennas;
+    accumCfg.numVirtualAntennas = params->numVirtualAntennas;
+    accumCfg.numRangeBins       = mathUtils_pow2roundup(numAdcSamples) / 2;
+    if ((ChirpAccum_compute(&accumCfg, &accumDims) != 0) ||
+        (accumCfg.numRangeBins != params->numRangeBins) ||
+        (accumDims.numDopplerChirpsPerFrame != params->numDopplerChirpsPerFrame) ||
+        (accumDims.cubeBytes != newCfg.hwRes.radarCube.dataSize) ||
+        ((mimoSel != 0) && (mimoSel != 1) && (mimoSel != 4))) {
+        return SystemP_FAILURE;
     }
+
+    params->numChirpsPerFrame = accumDims.numChirpsPerFrame;
+    params->isBpmEnabled      = (mimoSel == 4) ? TRUE : FALSE;
+    if (RangeProc_setAdcParams(params, numAdcSamples, accumDims.extraShift) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+    retVal = RangeProc_reconfig(&newCfg);
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+    /* the auto-scaling restarts from the shift of the new profile, as after RangeProc_config() */
+    FftAutoScale_init(&gSysContext.fftAutoScaleCfg, &gSysContext.fftAutoScaleState,
+                      RANGEPROC_FFT_OUTPUT_DIV_SHIFT + RANGEPROC_FFT_NUM_BUTTERFLY_STAGES + accumDims.extraShift);
+#endif
+    return retVal;
+}
+
+int32_t RangeProc_switchSubFrame(uint32_t subFrameIdx) {
+    int32_t retVal = SystemP_SUCCESS;
+#if SUBFRAME_ENABLE
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+
+    if (mmwave_reconfigSensor(subFrameIdx) != SystemP_SUCCESS) {
+        return SystemP_FAILURE;
+    }
+
+    /* the window and cube of the sub-frame were allocated by RangeProc_config() */
+    retVal = RangeProc_reconfig(&gSysContext.subFrameDpuCfg[subFrameIdx]);
+    if (retVal < 0) {
+        return retVal;
+    }
+    gSysContext.subFrameIdx = subFrameIdx;
+    gRadarCubeDebugPtr = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+
+    // benchmark: duration of the sensor and DPU reconfiguration (40 MHz ticks)
+    DebugP_logInfo("Switched to sub-frame %u in %u ticks\n", subFrameIdx,
+                   Cycleprofiler_getTimeStamp() - startTicks);
+#else
+    (void)subFrameIdx;
+#endif
+    return retVal;
 }
 
 /**
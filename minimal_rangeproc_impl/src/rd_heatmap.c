@@ -0,0 +1,148 @@
+/**
+ * @file rd_heatmap.c
+ * @brief Range-Doppler heatmap of the radar cube.
+ *
+ * The reference model uses a radix-2 decimation in time FFT on int64 values
+ * with Q30 twiddle factors, which is far more precise than the HWA datapath,
+ * so that the differences to the device output are dominated by the HWA.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "rd_heatmap.h"
+
+/*! @brief Q format of the twiddle factors of the reference model */
+#define RD_HEATMAP_TWIDDLE_QFORMAT  (30)
+
+
+uint32_t RdHeatmap_getShift(uint32_t numVirtualAntennas) {
+    uint32_t shift = 0;
+
+    while ((1UL << shift) < numVirtualAntennas) {
+        shift++;
+    }
+    return shift;
+}
+
+uint32_t RdHeatmap_getSize(const RdHeatmap_Config *cfg) {
+    return (uint32_t)cfg->numRangeBins * cfg->fftSize * sizeof(uint16_t);
+}
+
+void RdHeatmap_sumAntennas(const uint16_t *mag, uint32_t numBins, const RdHeatmap_Config *cfg,
+                           uint16_t *heatmap) {
+    uint32_t shift = RdHeatmap_getShift(cfg->numVirtualAntennas);
+    uint32_t rowSize = numBins * cfg->fftSize;
+    uint32_t i, ant;
+
+    for (i = 0; i < rowSize; i++) {
+        uint32_t sum = 0;
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            sum += mag[(ant * rowSize) + i];
+        }
+        sum >>= shift;
+        heatmap[i] = (uint16_t)((sum > UINT16_MAX) ? UINT16_MAX : sum);
+    }
+}
+
+/**
+ * @brief Rounding arithmetic right shift.
+ */
+static inline int64_t RdHeatmap_roundShift(int64_t x, uint32_t shift) {
+    return (x + ((int64_t)1 << (shift - 1U))) >> shift;
+}
+
+/**
+ * @brief Fixed-point FFT with every stage scaled by 1/2, in place.
+ */
+static void RdHeatmap_fft(int64_t *re, int64_t *im, uint32_t n) {
+    uint32_t i, j, k, len;
+
+    for (i = 1, j = 0; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; (j & bit) != 0U; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int64_t t;
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (len = 2; len <= n; len <<= 1) {
+        uint32_t half = len >> 1;
+        for (k = 0; k < half; k++) {
+            double  phi = (-2.0 * 3.14159265358979323846 * (double)k) / (double)len;
+            int64_t wr  = (int64_t)llround(cos(phi) * (double)(1L << RD_HEATMAP_TWIDDLE_QFORMAT));
+            int64_t wi  = (int64_t)llround(sin(phi) * (double)(1L << RD_HEATMAP_TWIDDLE_QFORMAT));
+
+            for (i = k; i < n; i += len) {
+                int64_t tr = RdHeatmap_roundShift((re[i + half] * wr) - (im[i + half] * wi), RD_HEATMAP_TWIDDLE_QFORMAT);
+                int64_t ti = RdHeatmap_roundShift((re[i + half] * wi) + (im[i + half] * wr), RD_HEATMAP_TWIDDLE_QFORMAT);
+                re[i + half] = RdHeatmap_roundShift(re[i] - tr, 1U);
+                im[i + half] = RdHeatmap_roundShift(im[i] - ti, 1U);
+                re[i]        = RdHeatmap_roundShift(re[i] + tr, 1U);
+                im[i]        = RdHeatmap_roundShift(im[i] + ti, 1U);
+            }
+        }
+    }
+}
+
+int32_t RdHeatmap_computeRows(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                              uint32_t firstBin, uint32_t numBins, uint16_t *heatmap) {
+    static int64_t re[RD_HEATMAP_MAX_FFT_SIZE];
+    static int64_t im[RD_HEATMAP_MAX_FFT_SIZE];
+    uint32_t n = cfg->fftSize;
+    uint32_t rowStride = 2U * (uint32_t)cfg->numVirtualAntennas * cfg->numRangeBins;
+    uint32_t shift = RdHeatmap_getShift(cfg->numVirtualAntennas);
+    uint32_t bin, ant, c;
+
+    if ((n < 2U) || (n > RD_HEATMAP_MAX_FFT_SIZE) || ((n & (n - 1U)) != 0U) ||
+        (cfg->numDopplerChirps > n) || (cfg->numVirtualAntennas == 0U) ||
+        ((firstBin + numBins) > cfg->numRangeBins)) {
+        return -1;
+    }
+
+    for (bin = firstBin; bin < (firstBin + numBins); bin++) {
+        uint16_t *row = &heatmap[(bin - firstBin) * n];
+        uint32_t  sum[RD_HEATMAP_MAX_FFT_SIZE] = {0};
+
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            const int16_t *s = cube + 2U * ((ant * cfg->numRangeBins) + bin);
+
+            for (c = 0; c < n; c++) {
+                if (c < cfg->numDopplerChirps) {
+                    /* symmetric window, cmplx16ImRe_t: imaginary part first */
+                    uint32_t wIdx = (c < ((cfg->numDopplerChirps + 1U) / 2U)) ? c : (cfg->numDopplerChirps - 1U - c);
+                    re[c] = RdHeatmap_roundShift((int64_t)s[1] * window[wIdx], RD_HEATMAP_WINDOW_QFORMAT);
+                    im[c] = RdHeatmap_roundShift((int64_t)s[0] * window[wIdx], RD_HEATMAP_WINDOW_QFORMAT);
+                    s += rowStride;
+                } else {
+                    re[c] = 0;
+                    im[c] = 0;
+                }
+            }
+
+            RdHeatmap_fft(re, im, n);
+
+            for (c = 0; c < n; c++) {
+                sum[c] += (uint32_t)sqrt((double)((re[c] * re[c]) + (im[c] * im[c])));
+            }
+        }
+
+        for (c = 0; c < n; c++) {
+            uint32_t v = sum[c] >> shift;
+            row[c] = (uint16_t)((v > UINT16_MAX) ? UINT16_MAX : v);
+        }
+    }
+
+    return 0;
+}
+
+int32_t RdHeatmap_compute(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window,
+                          uint16_t *heatmap) {
+    return RdHeatmap_computeRows(cfg, cube, window, 0, cfg->numRangeBins, heatmap);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file recovery.c
+ * @brief Recovery of the processing pipeline from DPU, HWA and SPI errors.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "recovery.h"
+
+/*! @brief Minimum recovery level of every fault */
+static const int32_t gRecoveryMinLevel[RECOVERY_NUM_FAULTS] = {
+    RECOVERY_LEVEL_RESYNC,      /* RECOVERY_FAULT_SPI */
+    RECOVERY_LEVEL_REARM,       /* RECOVERY_FAULT_PROCESS */
+    RECOVERY_LEVEL_RESET,       /* RECOVERY_FAULT_TRIGGER */
+    RECOVERY_LEVEL_RESET,       /* RECOVERY_FAULT_STAGE */
+    RECOVERY_LEVEL_RESTART      /* RECOVERY_FAULT_SENSOR */
+};
+
+static const char *gRecoveryFaultNames[RECOVERY_NUM_FAULTS] = { "spi", "process", "trigger", "stage", "sensor" };
+
+static const char *gRecoveryLevelNames[RECOVERY_NUM_LEVELS] = { "resync", "rearm", "reset", "restart" };
+
+/**
+ * @brief Runs the action of a level, returns 0 on success.
+ */
+static int32_t Recovery_runAction(int32_t level, const Recovery_Ops *ops) {
+    switch (level) {
+    case RECOVERY_LEVEL_REARM:
+        return ops->rearm(ops->arg);
+    case RECOVERY_LEVEL_RESET:
+        return ops->reset(ops->arg);
+    case RECOVERY_LEVEL_RESTART:
+        return ops->restart(ops->arg);
+    default:
+        return 0;
+    }
+}
+
+void Recovery_init(Recovery_Ctrl *ctrl) {
+    memset(ctrl, 0, sizeof(Recovery_Ctrl));
+    ctrl->state     = RECOVERY_STATE_RUNNING;
+    ctrl->level     = RECOVERY_LEVEL_REARM;
+    ctrl->lastLevel = RECOVERY_LEVEL_RESYNC;
+}
+
+int32_t Recovery_handleFault(Recovery_Ctrl *ctrl, uint32_t fault, uint32_t dropped, const Recovery_Ops *ops) {
+    int32_t level;
+
+    if (ctrl->state == RECOVERY_STATE_FAILED) {
+        return RECOVERY_ERR_FAILED;
+    }
+    if (fault >= RECOVERY_NUM_FAULTS) {
+        fault = RECOVERY_FAULT_STAGE;
+    }
+
+    ctrl->numFaults++;
+    ctrl->lastFault      = fault;
+    ctrl->numCleanFrames = 0;
+    ctrl->numDroppedFrames += (dropped != 0U) ? 1U : 0U;
+    ctrl->resyncPending  = 1U;
+    ctrl->state          = RECOVERY_STATE_RECOVERING;
+
+    /* the pipeline is intact after an SPI error, only the stream is resynchronised */
+    if (fault == RECOVERY_FAULT_SPI) {
+        ctrl->numActions[RECOVERY_LEVEL_RESYNC]++;
+        ctrl->lastLevel = RECOVERY_LEVEL_RESYNC;
+        return RECOVERY_LEVEL_RESYNC;
+    }
+
+    level = (ctrl->level > gRecoveryMinLevel[fault]) ? ctrl->level : gRecoveryMinLevel[fault];
+    while (Recovery_runAction(level, ops) != 0) {
+        if (level < RECOVERY_LEVEL_RESTART) {
+            level++;
+            continue;
+        }
+        ctrl->numFailedRestarts++;
+        if (ctrl->numFailedRestarts >= RECOVERY_MAX_RESTARTS) {
+            ctrl->state     = RECOVERY_STATE_FAILED;
+            ctrl->lastLevel = level;
+            return RECOVERY_ERR_FAILED;
+        }
+    }
+    if (level == RECOVERY_LEVEL_RESTART) {
+        ctrl->numFailedRestarts = 0;
+    }
+
+    /* a fault before the pipeline ran clean for a while escalates */
+    ctrl->numActions[level]++;
+    ctrl->lastLevel = level;
+    ctrl->level     = (level < RECOVERY_LEVEL_RESTART) ? (level + 1) : RECOVERY_LEVEL_RESTART;
+    return level;
+}
+
+void Recovery_frameDone(Recovery_Ctrl *ctrl, uint32_t frameIdx) {
+    ctrl->lastGoodFrameIdx = frameIdx;
+    if (ctrl->numCleanFrames < RECOVERY_CLEAN_FRAMES) {
+        ctrl->numCleanFrames++;
+    }
+    if ((ctrl->numCleanFrames >= RECOVERY_CLEAN_FRAMES) && (ctrl->state == RECOVERY_STATE_RECOVERING)) {
+        ctrl->state = RECOVERY_STATE_RUNNING;
+        ctrl->level = RECOVERY_LEVEL_REARM;
+    }
+}
+
+int32_t Recovery_takeMarker(Recovery_Ctrl *ctrl, Recovery_Marker *marker) {
+    if (ctrl->resyncPending == 0U) {
+        return 0;
+    }
+    marker->sync[0]          = RECOVERY_SYNC_WORD0;
+    marker->sync[1]          = RECOVERY_SYNC_WORD1;
+    marker->numFaults        = ctrl->numFaults;
+    marker->lastGoodFrameIdx = ctrl->lastGoodFrameIdx;
+    marker->numDroppedFrames = (uint16_t)((ctrl->numDroppedFrames > 0xFFFFU) ? 0xFFFFU : ctrl->numDroppedFrames);
+    marker->lastFault        = (uint8_t)ctrl->lastFault;
+    marker->lastLevel        = (uint8_t)ctrl->lastLevel;
+    marker->numRestarts      = ctrl->numActions[RECOVERY_LEVEL_RESTART];
+
+    ctrl->resyncPending    = 0U;
+    ctrl->numDroppedFrames = 0U;
+    return 1;
+}
+
+const char *Recovery_faultName(uint32_t fault) {
+    return (fault < RECOVERY_NUM_FAULTS) ? gRecoveryFaultNames[fault] : "?";
+}
+
+const char *Recovery_levelName(int32_t level) {
+    return ((level >= 0) && (level < RECOVERY_NUM_LEVELS)) ? gRecoveryLevelNames[level] : "failed";
+}
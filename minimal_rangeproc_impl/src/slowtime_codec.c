@@ -0,0 +1,311 @@
+/**
+ * @file slowtime_codec.c
+ * @brief Lossy transform coding of the radar cube along slow time.
+ *
+ * The encoder makes three passes over the cube, transforming every sequence
+ * again in each of them instead of buffering the whole transformed cube:
+ *   1. energy histogram of all coefficients, total energy and peak value,
+ *   2. number of coefficients above the threshold, defining the step,
+ *   3. quantisation and packing of the kept coefficients.
+ *
+ * The forward FFT is not normalised and the inverse is scaled by 1/N, so the
+ * energies of the transform domain are N times the energies of the cube. This
+ * factor cancels in the SNR. The energies are summed in double, a float sum
+ * over a large cube loses the contribution of the weak coefficients.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#include "slowtime_codec.h"
+
+/*! @brief Maximum number of step refinements of the quantisation pass */
+#define SLOWTIME_CODEC_MAX_STEP_ITER    (4U)
+
+/**
+ * @brief In-place radix-2 FFT of obj->seq, inverse = conjugated twiddles (unscaled).
+ */
+static void SlowTimeCodec_fft(SlowTimeCodec_Obj *obj, uint32_t inverse) {
+    float   *x = obj->seq;
+    uint32_t n = obj->cfg.numDopplerChirps;
+    uint32_t i, j, k, len;
+    float    sign = (inverse != 0U) ? 1.0f : -1.0f;
+
+    /* bit reversal permutation */
+    for (i = 1U, j = 0U; i < n; i++) {
+        uint32_t bit = n >> 1;
+        for (; (j & bit) != 0U; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float tr = x[2U * i], ti = x[2U * i + 1U];
+            x[2U * i]      = x[2U * j];
+            x[2U * i + 1U] = x[2U * j + 1U];
+            x[2U * j]      = tr;
+            x[2U * j + 1U] = ti;
+        }
+    }
+
+    /* butterflies, twiddle k*step of the table holds exp(-j*2*pi*k*step/n), conjugated for the inverse */
+    for (len = 2U; len <= n; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = n / len;
+        for (i = 0U; i < n; i += len) {
+            for (k = 0U; k < half; k++) {
+                float wr = obj->twiddle[2U * k * step];
+                float wi = -sign * obj->twiddle[2U * k * step + 1U];
+                float *a = &x[2U * (i + k)];
+                float *b = &x[2U * (i + k + half)];
+                float tr = (b[0] * wr) - (b[1] * wi);
+                float ti = (b[0] * wi) + (b[1] * wr);
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Loads the slow-time sequence of (bin, ant) into obj->seq and transforms it.
+ */
+static void SlowTimeCodec_loadSequence(SlowTimeCodec_Obj *obj, const int16_t *cube, uint32_t bin, uint32_t ant) {
+    uint32_t rowStride = 2U * (uint32_t)obj->cfg.numVirtualAntennas * obj->cfg.numRangeBins;
+    const int16_t *s = cube + 2U * ((ant * obj->cfg.numRangeBins) + bin);
+    uint32_t c;
+
+    /* cmplx16ImRe_t: imaginary part first */
+    for (c = 0U; c < obj->cfg.numDopplerChirps; c++) {
+        obj->seq[2U * c]      = (float)s[1];
+        obj->seq[2U * c + 1U] = (float)s[0];
+        s += rowStride;
+    }
+    SlowTimeCodec_fft(obj, 0U);
+}
+
+/**
+ * @brief Maps an energy to its log-energy histogram bin (monotonic, 4 bins per octave).
+ */
+static inline uint32_t SlowTimeCodec_histIdx(float e) {
+    int32_t exp;
+    float   m;
+    int32_t idx;
+
+    if (e < 1.0f) {
+        return 0U;
+    }
+    m   = frexpf(e, &exp);           /* e = m * 2^exp, m in [0.5, 1) */
+    idx = (exp * 4) + (int32_t)((m - 0.5f) * 8.0f);
+    return (idx >= (int32_t)SLOWTIME_CODEC_HIST_BINS) ? (SLOWTIME_CODEC_HIST_BINS - 1U) : (uint32_t)idx;
+}
+
+static inline int16_t SlowTimeCodec_sat16(float v) {
+    v += (v >= 0.0f) ? 0.5f : -0.5f;
+    if (v > 32767.0f) {
+        return 32767;
+    }
+    if (v < -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)v;
+}
+
+int32_t SlowTimeCodec_init(SlowTimeCodec_Obj *obj, const SlowTimeCodec_Config *cfg) {
+    uint32_t n = cfg->numDopplerChirps;
+    uint32_t k;
+
+    if ((n < 2U) || (n > SLOWTIME_CODEC_MAX_CHIRPS) || ((n & (n - 1U)) != 0U) ||
+        (cfg->numRangeBins == 0U) || (cfg->numVirtualAntennas == 0U)) {
+        return -1;
+    }
+
+    memset(obj, 0, sizeof(SlowTimeCodec_Obj));
+    obj->cfg = *cfg;
+
+    for (k = 0U; k < (n / 2U); k++) {
+        float phi = (6.28318530718f * (float)k) / (float)n;
+        obj->twiddle[2U * k]      = cosf(phi);
+        obj->twiddle[2U * k + 1U] = -sinf(phi);
+    }
+
+    return 0;
+}
+
+uint32_t SlowTimeCodec_getMaxPayloadSize(const SlowTimeCodec_Config *cfg) {
+    uint32_t numSeq = (uint32_t)cfg->numRangeBins * cfg->numVirtualAntennas;
+
+    return ((uint32_t)sizeof(SlowTimeCodec_Header) +
+            numSeq * (1U + (5U * (uint32_t)cfg->numDopplerChirps)) + 3U) & ~3U;
+}
+
+int32_t SlowTimeCodec_encode(SlowTimeCodec_Obj *obj, const int16_t *cube, void *payload) {
+    SlowTimeCodec_Header *hdr = (SlowTimeCodec_Header *)payload;
+    uint8_t *out = (uint8_t *)(hdr + 1);
+    uint32_t n = obj->cfg.numDopplerChirps;
+    uint32_t bin, ant, c, i;
+    double   totalEnergy = 0.0;
+    float    peak = 0.0f;
+    double   noiseBudget, droppedEnergy, errEnergy;
+    float    step, invStep, minStep;
+    uint32_t thrBin, numKept, iter;
+    uint32_t numBytes;
+
+    if ((obj == NULL) || (cube == NULL) || (payload == NULL)) {
+        return -1;
+    }
+
+    /* pass 1: log-energy histogram of all coefficients */
+    memset(obj->histEnergy, 0, sizeof(obj->histEnergy));
+    for (bin = 0U; bin < obj->cfg.numRangeBins; bin++) {
+        for (ant = 0U; ant < obj->cfg.numVirtualAntennas; ant++) {
+            SlowTimeCodec_loadSequence(obj, cube, bin, ant);
+            for (c = 0U; c < n; c++) {
+                float re = obj->seq[2U * c], im = obj->seq[2U * c + 1U];
+                float e  = (re * re) + (im * im);
+                obj->histEnergy[SlowTimeCodec_histIdx(e)] += (double)e;
+                totalEnergy += (double)e;
+                peak = (fabsf(re) > peak) ? fabsf(re) : peak;
+                peak = (fabsf(im) > peak) ? fabsf(im) : peak;
+            }
+        }
+    }
+
+    /* drop the weakest histogram bins within half of the noise budget */
+    noiseBudget   = totalEnergy / pow(10.0, (double)obj->cfg.targetSnrDb / 10.0);
+    droppedEnergy = 0.0;
+    numKept       = 0U;
+    for (thrBin = 0U; thrBin < SLOWTIME_CODEC_HIST_BINS; thrBin++) {
+        if ((droppedEnergy + obj->histEnergy[thrBin]) > (0.5 * noiseBudget)) {
+            break;
+        }
+        droppedEnergy += obj->histEnergy[thrBin];
+    }
+
+    /* pass 2: count the kept coefficients to derive the quantisation step */
+    for (bin = 0U; bin < obj->cfg.numRangeBins; bin++) {
+        for (ant = 0U; ant < obj->cfg.numVirtualAntennas; ant++) {
+            SlowTimeCodec_loadSequence(obj, cube, bin, ant);
+            for (c = 0U; c < n; c++) {
+                float re = obj->seq[2U * c], im = obj->seq[2U * c + 1U];
+                numKept += (SlowTimeCodec_histIdx((re * re) + (im * im)) >= thrBin) ? 1U : 0U;
+            }
+        }
+    }
+
+    /* uniform quantisation noise of a complex coefficient: 2 * step^2 / 12 */
+    step = (numKept > 0U) ? (float)sqrt((6.0 * (noiseBudget - droppedEnergy)) / (double)numKept) : 1.0f;
+    minStep = (peak > 0.0f) ? (peak / 32767.0f) : 1.0f;
+    step = (step < minStep) ? minStep : step;
+
+    /*
+     * pass 3: quantise and pack. With few kept coefficients the uniform noise
+     * model is optimistic, so the step is halved until the target is reached.
+     */
+    for (iter = 0U; ; iter++) {
+        out       = (uint8_t *)(hdr + 1);
+        errEnergy = droppedEnergy;
+        invStep   = 1.0f / step;
+
+        for (bin = 0U; bin < obj->cfg.numRangeBins; bin++) {
+            for (ant = 0U; ant < obj->cfg.numVirtualAntennas; ant++) {
+                uint8_t *count = out++;
+                *count = 0U;
+
+                SlowTimeCodec_loadSequence(obj, cube, bin, ant);
+                for (c = 0U; c < n; c++) {
+                    float re = obj->seq[2U * c], im = obj->seq[2U * c + 1U];
+                    int16_t qr, qi;
+                    float dr, di;
+
+                    if (SlowTimeCodec_histIdx((re * re) + (im * im)) < thrBin) {
+                        continue;
+                    }
+                    qr = SlowTimeCodec_sat16(re * invStep);
+                    qi = SlowTimeCodec_sat16(im * invStep);
+                    dr = re - ((float)qr * step);
+                    di = im - ((float)qi * step);
+                    errEnergy += (double)((dr * dr) + (di * di));
+
+                    out[0] = (uint8_t)c;
+                    out[1] = (uint8_t)((uint16_t)qr & 0xFFU);
+                    out[2] = (uint8_t)((uint16_t)qr >> 8);
+                    out[3] = (uint8_t)((uint16_t)qi & 0xFFU);
+                    out[4] = (uint8_t)((uint16_t)qi >> 8);
+                    out += 5;
+                    (*count)++;
+                }
+            }
+        }
+
+        if ((errEnergy <= noiseBudget) || (iter >= SLOWTIME_CODEC_MAX_STEP_ITER) ||
+            ((0.5f * step) < minStep)) {
+            break;
+        }
+        step *= 0.5f;
+    }
+
+    numBytes = (uint32_t)(out - (uint8_t *)payload);
+    for (i = numBytes; (i & 3U) != 0U; i++) {
+        ((uint8_t *)payload)[i] = 0U;
+    }
+
+    hdr->numRangeBins       = obj->cfg.numRangeBins;
+    hdr->numVirtualAntennas = obj->cfg.numVirtualAntennas;
+    hdr->numDopplerChirps   = obj->cfg.numDopplerChirps;
+    hdr->reserved           = 0U;
+    hdr->targetSnrDb        = obj->cfg.targetSnrDb;
+    hdr->achievedSnrDb      = (errEnergy > 0.0) ? (float)(10.0 * log10(totalEnergy / errEnergy)) : INFINITY;
+    hdr->step               = step;
+    hdr->numKept            = numKept;
+    hdr->encodedBytes       = numBytes;
+
+    return (int32_t)((numBytes + 3U) & ~3U);
+}
+
+int32_t SlowTimeCodec_decode(SlowTimeCodec_Obj *obj, const void *payload, int16_t *cube) {
+    const SlowTimeCodec_Header *hdr = (const SlowTimeCodec_Header *)payload;
+    const uint8_t *in = (const uint8_t *)(hdr + 1);
+    uint32_t n = obj->cfg.numDopplerChirps;
+    uint32_t rowStride = 2U * (uint32_t)obj->cfg.numVirtualAntennas * obj->cfg.numRangeBins;
+    float    scale = 1.0f / (float)n;
+    uint32_t bin, ant, c, k;
+
+    if ((hdr->numRangeBins != obj->cfg.numRangeBins) ||
+        (hdr->numVirtualAntennas != obj->cfg.numVirtualAntennas) ||
+        (hdr->numDopplerChirps != obj->cfg.numDopplerChirps)) {
+        return -1;
+    }
+
+    for (bin = 0U; bin < obj->cfg.numRangeBins; bin++) {
+        for (ant = 0U; ant < obj->cfg.numVirtualAntennas; ant++) {
+            uint32_t count = *in++;
+            int16_t *d = cube + 2U * ((ant * obj->cfg.numRangeBins) + bin);
+
+            memset(obj->seq, 0, 2U * n * sizeof(float));
+            for (k = 0U; k < count; k++) {
+                uint32_t idx = in[0];
+                int16_t  qr  = (int16_t)((uint16_t)in[1] | ((uint16_t)in[2] << 8));
+                int16_t  qi  = (int16_t)((uint16_t)in[3] | ((uint16_t)in[4] << 8));
+                if (idx >= n) {
+                    return -1;
+                }
+                obj->seq[2U * idx]      = (float)qr * hdr->step;
+                obj->seq[2U * idx + 1U] = (float)qi * hdr->step;
+                in += 5;
+            }
+
+            SlowTimeCodec_fft(obj, 1U);
+            for (c = 0U; c < n; c++) {
+                d[0] = SlowTimeCodec_sat16(obj->seq[2U * c + 1U] * scale);
+                d[1] = SlowTimeCodec_sat16(obj->seq[2U * c] * scale);
+                d += rowStride;
+            }
+        }
+    }
+
+    return 0;
+}
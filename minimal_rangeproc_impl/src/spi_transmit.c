@@ -11,9 +11,14 @@
  * - `spi_tx_done_sem`: Signals the completion of transmission.
  *
  * The function `spi_transmit_loop()` runs continuously, waiting for
- * `spi_tx_start_sem` to be posted, transmitting radar cube data, and posting
+ * `spi_tx_start_sem` to be posted, transmitting the buffers registered in
+ * `gSysContext.streamTxBuf` (radar cube and derived products), and posting
  * `spi_tx_done_sem` upon completion.
  *
+ * With SPI_CMD_CHANNEL_ENABLE every frame ends with a command slot, in which
+ * the status record of the runtime reconfiguration is transmitted and a
+ * command record is received (see config_cmd.h).
+ *
  * @note This module relies on the SemaphoreP API from the kernel/dpl library
  *       for synchronization.
  */
@@ -30,11 +35,22 @@
 #include "system.h"
 #include "defines.h"
 #include "spi_transmit.h"
+#include "budget_limits.h"
+#include "config_cmd.h"
+#include "mem_region.h"
+
+#if SPI_CMD_CHANNEL_ENABLE && (SPI_CMD_SLOT_WORDS < CONFIG_CMD_RECORD_WORDS)
+#error "SPI_CMD_SLOT_WORDS is too small for a command record"
+#endif
+
+#if SPI_CMD_CHANNEL_ENABLE
+/*! @brief Status record transmitted in the command slot (shared memory, DMA) */
+static uint32_t *gCmdSlotTx = NULL;
 
+/*! @brief Command record received in the command slot (shared memory, DMA) */
+static uint32_t *gCmdSlotRx = NULL;
+#endif
 
-#define MAX_SPI_TRANSFER_SIZE       (65280U) // Max. Bytes per transfer burst (FTDI: 65536 Byte)
-#define BITS_PER_FRAME              (32U)    // Bits per SPI frame */
-#define BYTES_PER_FRAME             (BITS_PER_FRAME/8U)
 
 static int32_t spi_transfer_buffer(void *txBuf, uint32_t totalBytes) {
     MCSPI_Transaction spiTransaction;
@@ -74,13 +90,13 @@ static int32_t spi_transfer_buffer(void *txBuf, uint32_t totalBytes) {
 
         // write data
         transferOK = MCSPI_transfer(gMcspiHandle[CONFIG_MCSPI0], &spiTransaction);
+
+        // transfer complete or failed, set SPI_BUSY pin high again, so that the master does not keep reading
+        GPIO_pinWriteHigh(gpioBaseAddrLed, pinNumLed);
         if (transferOK != SystemP_SUCCESS) {
             return transferOK;
         }
 
-        // transfer complete, set SPI_BUSY pin high again
-        GPIO_pinWriteHigh(gpioBaseAddrLed, pinNumLed);
-
         // update for next chunk
         bytesRemaining -= chunkSize;
         chunkIndex++;
@@ -89,29 +105,94 @@ static int32_t spi_transfer_buffer(void *txBuf, uint32_t totalBytes) {
     return SystemP_SUCCESS;
 }
 
-void spi_transmit_loop() {
-    int32_t           transferOK;
+int32_t spi_cmdSlotConfig(void) {
+#if SPI_CMD_CHANNEL_ENABLE
+    if (gConfigMcspi0ChCfg[0].trMode != MCSPI_TR_MODE_TX_RX) {
+        DebugP_log("Error: the command slot requires mcspi1.trMode = \"TX_RX\" in example.syscfg\r\n");
+        return SystemP_FAILURE;
+    }
+    gCmdSlotTx = (uint32_t *)MemRegion_alloc(&gSysContext.memRegions, SPI_CMD_SLOT_WORDS * sizeof(uint32_t),
+                                             sizeof(uint32_t), MEM_REGION_ATTR_DMA,
+                                             MEM_REGION_POLICY_LARGEST_FREE, "cmdSlot", NULL);
+    gCmdSlotRx = (uint32_t *)MemRegion_alloc(&gSysContext.memRegions, SPI_CMD_SLOT_WORDS * sizeof(uint32_t),
+                                             sizeof(uint32_t), MEM_REGION_ATTR_DMA,
+                                             MEM_REGION_POLICY_LARGEST_FREE, "cmdSlot", NULL);
+    if ((gCmdSlotTx == NULL) || (gCmdSlotRx == NULL)) {
+        return SystemP_FAILURE;
+    }
+#endif
+    return SystemP_SUCCESS;
+}
 
-    // assign pointers which point to data which is transferred
-    cmplx16ImRe_t *radarCubePtr = gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
-    //uint8_t *adcData           = 
+#if SPI_CMD_CHANNEL_ENABLE
+static int32_t spi_exchange_cmd_slot(void) {
+    MCSPI_Transaction spiTransaction;
+    int32_t           transferOK;
+    int32_t           result;
+
+    memset(gCmdSlotTx, 0, SPI_CMD_SLOT_WORDS * sizeof(uint32_t));
+    (void)ConfigCmd_encodeStatus(&gSysContext.configCmd, gCmdSlotTx);
+    memset(gCmdSlotRx, 0, SPI_CMD_SLOT_WORDS * sizeof(uint32_t));
+
+    MCSPI_Transaction_init(&spiTransaction);
+    spiTransaction.channel   = gConfigMcspi0ChCfg[0].chNum;
+    spiTransaction.dataSize  = BITS_PER_FRAME;
+    spiTransaction.csDisable = TRUE;
+    spiTransaction.count     = SPI_CMD_SLOT_WORDS;
+    spiTransaction.txBuf     = (void *)gCmdSlotTx;
+    spiTransaction.rxBuf     = (void *)gCmdSlotRx;
+    spiTransaction.args      = NULL;
+
+    // the slot is announced like a data chunk, SPI_BUSY goes high again on success and on failure
+    GPIO_pinWriteLow(gpioBaseAddrLed, pinNumLed);
+    transferOK = MCSPI_transfer(gMcspiHandle[CONFIG_MCSPI0], &spiTransaction);
+    GPIO_pinWriteHigh(gpioBaseAddrLed, pinNumLed);
+    if (transferOK != SystemP_SUCCESS) {
+        return transferOK;
+    }
 
-    // Total bytes in one radar-cube frame
-    uint32_t radarCubeBytes = gSysContext.rangeProcDpuCfg.hwRes.radarCube.dataSize;
+    // the dpcTask waits for spi_tx_done_sem, so the state is not accessed concurrently
+    result = ConfigCmd_receive(&gSysContext.configCmd, gCmdSlotRx, SPI_CMD_SLOT_WORDS);
+    if (result != CONFIG_CMD_ERR_NO_RECORD) {
+        DebugP_log("Command record %u: result %d\r\n", gSysContext.configCmd.lastSequence, result);
+    }
+    return SystemP_SUCCESS;
+}
+#endif
 
+void spi_transmit_loop() {
+    int32_t           transferOK;
+    uint32_t          bufIdx;
 
     while(true) {
         // wait for new frame to be captured
         SemaphoreP_pend(&spi_tx_start_sem, SystemP_WAIT_FOREVER);
 
-        // transfer the radar cube via SPI
-        transferOK = spi_transfer_buffer(radarCubePtr, radarCubeBytes);
+        // transfer the radar cube and/or the data products derived from it via SPI
+        // (registered by streamProducts_config(), see stream_cfg.h)
+        for (bufIdx = 0; bufIdx < gSysContext.numStreamTxBuf; bufIdx++) {
+            transferOK = spi_transfer_buffer(gSysContext.streamTxBuf[bufIdx].data,
+                                             gSysContext.streamTxBuf[bufIdx].dataSize);
+            if (transferOK != SystemP_SUCCESS) {
+                // the rest of the frame would be misaligned on the host, which resyncs with the next frame
+                DebugP_log("SPI data transfer of buffer %u failed\r\n", bufIdx);
+                gSysContext.spiTxFailed = 1U;
+                break;
+            }
+        }
+
+#if SPI_CMD_CHANNEL_ENABLE
+        // status out, reconfiguration command in
+        transferOK = spi_exchange_cmd_slot();
         if (transferOK != SystemP_SUCCESS) {
-            DebugP_log("SPI radar cube data transfer failed\r\n");
+            // the host lost the slot as well, it resyncs with the next frame
+            DebugP_log("SPI command slot transfer failed\r\n");
+            gSysContext.spiTxFailed = 1U;
         }
+#endif
 
         // TODO: transfer raw ADC data via SPI
 
         SemaphoreP_post(&spi_tx_done_sem);
     }
-}
\ No newline at end of file
+}
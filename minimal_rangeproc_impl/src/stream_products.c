@@ -0,0 +1,824 @@
+/**
+ * @file stream_products.c
+ * @brief Computation of the data products streamed via SPI.
+ *
+ * The products are placed in the L3 memory pool right after the radar cube.
+ * Each product is stored as one contiguous record (StreamRecord_Header followed
+ * by the payload), so that it can be handed to the SPI task as a single buffer.
+ */
+
+#include <string.h>
+#include <kernel/dpl/DebugP.h>
+#include <kernel/dpl/SystemP.h>
+#include <datapath/dpu/rangeproc/v0/rangeprochwa.h>
+
+#include "system.h"
+#include "defines.h"
+#include "stream_cfg.h"
+#include "stream_record.h"
+#include "stream_products.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "cube_quant.h"
+#include "cube_layout.h"
+#include "range_profile.h"
+#include "range_peaks.h"
+#include "rd_heatmap.h"
+#include "cfar.h"
+#include "doa.h"
+#include "micro_doppler.h"
+#include "slowtime_codec.h"
+#include "boot_report.h"
+#include "recovery.h"
+
+/*! @brief The streamed cubes are reordered into a copy before the transfer */
+#if (STREAM_CUBE_LAYOUT_ORDER != CUBE_LAYOUT_CHIRP_MAJOR) || STREAM_CUBE_LAYOUT_IQ_SPLIT
+#define STREAM_CUBE_LAYOUT_CONVERT          1
+#else
+#define STREAM_CUBE_LAYOUT_CONVERT          0
+#endif
+
+#if SUBFRAME_ENABLE && (STREAM_CUBE_LAYOUT_CONVERT || STREAM_MINOR_CUBE_ENABLE || STREAM_CUBE_QUANT_ENABLE || \
+                        STREAM_RANGE_PROFILE_ENABLE || STREAM_RANGE_PEAKS_ENABLE || STREAM_SLOWTIME_CODEC_ENABLE)
+#error "SUBFRAME_ENABLE only supports the native tagged major cube and the frame info record"
+#endif
+
+#if (STREAM_MAJOR_CUBE_DECIM < 1) || (STREAM_MAJOR_CUBE_DECIM > 255) || \
+    (STREAM_MINOR_CUBE_DECIM < 1) || (STREAM_MINOR_CUBE_DECIM > 255)
+#error "STREAM_MAJOR_CUBE_DECIM and STREAM_MINOR_CUBE_DECIM must be in the range 1..255"
+#endif
+
+
+/**************************************************************************
+ ************************** Extern Definitions ****************************
+ **************************************************************************/
+extern uint32_t Cycleprofiler_getTimeStamp(void);
+
+
+#if STREAM_RESYNC_MARKER_ENABLE
+/*! @brief Resync marker record (header and payload), first SPI buffer, transferred after a fault */
+static StreamRecord_Header *gResyncRecord = NULL;
+#endif
+
+#if STREAM_FRAME_INFO_ENABLE
+/*! @brief Frame info record (header and payload) in L3 */
+static StreamRecord_Header *gFrameInfoRecord = NULL;
+#endif
+
+#if STREAM_CUBE_QUANT_ENABLE
+/*! @brief Configuration of the cube quantiser */
+static CubeQuant_Config gCubeQuantCfg;
+
+/*! @brief Quantised cube record (header and payload) in L3 */
+static StreamRecord_Header *gCubeQuantRecord = NULL;
+
+/*! @brief State of the dither noise generator */
+static uint32_t gCubeQuantDitherState = 0x12345678U;
+#endif
+
+
+#if STREAM_RANGE_PROFILE_ENABLE || STREAM_RANGE_PEAKS_ENABLE
+/*! @brief 64-bit non-coherent range profile of the current frame in core local memory */
+static uint64_t *gRangeProfileAcc = NULL;
+#endif
+
+#if STREAM_RANGE_PROFILE_ENABLE
+/*! @brief Range profile record (header and payload) in L3 */
+static StreamRecord_Header *gRangeProfileRecord = NULL;
+#endif
+
+#if STREAM_RD_HEATMAP_ENABLE
+/*! @brief Range-Doppler heatmap record header in L3, the heatmap itself is transferred from
+           gSysContext.rdHeatmap as the next SPI buffer */
+static StreamRecord_Header *gRdHeatmapRecord = NULL;
+#endif
+
+#if STREAM_CFAR_DETECTIONS_ENABLE
+/*! @brief CFAR detection list record header in L3, the list itself is transferred from
+           gSysContext.cfarDetList as the next SPI buffer (used part only) */
+static StreamRecord_Header *gCfarRecord = NULL;
+#endif
+
+#if STREAM_DOA_HEATMAP_ENABLE
+/*! @brief Range-azimuth heatmap record header in L3, the heatmap itself is transferred from
+           gSysContext.doaHeatmap as the next SPI buffer */
+static StreamRecord_Header *gDoaHeatmapRecord = NULL;
+#endif
+
+#if STREAM_DOA_ESTIMATES_ENABLE
+/*! @brief DoA estimate list record header in L3, the list itself is transferred from
+           gSysContext.doaList as the next SPI buffer (used part only) */
+static StreamRecord_Header *gDoaEstimatesRecord = NULL;
+#endif
+
+#if STREAM_MICRO_DOPPLER_ENABLE
+/*! @brief Micro-Doppler record header in L3, the column (with its MicroDoppler_Header) is transferred
+           from gSysContext.microDoppler as the next SPI buffer */
+static StreamRecord_Header *gMicroDopplerRecord = NULL;
+#endif
+
+#if STREAM_MAJOR_CUBE_ENABLE || STREAM_MINOR_CUBE_ENABLE
+/**
+ * @brief Tagged radar cube: a record holding the StreamRecord_CubeInfo, followed
+ *        by the cube itself as the next SPI buffer.
+ */
+typedef struct StreamProducts_Cube_t
+{
+    /*! @brief Record header in L3, followed by the cube info */
+    StreamRecord_Header *record;
+
+    /*! @brief Index of the record in gSysContext.streamTxBuf, the cube has the next one */
+    uint32_t bufIdx;
+
+    /*! @brief Size of the cube in bytes */
+    uint32_t cubeBytes;
+
+    /*! @brief Decimation factor, the cube is transferred if frameIdx % decim == 0 */
+    uint32_t decim;
+} StreamProducts_Cube;
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT
+/**
+ * @brief Reordered copy of a radar cube, which is streamed instead of the cube.
+ */
+typedef struct StreamProducts_CubeLayout_t
+{
+    /*! @brief Dimensions and layout */
+    CubeLayout_Config cfg;
+
+    /*! @brief Native cube written by the range DPU */
+    const int16_t *cube;
+
+    /*! @brief Reordered copy in L3 */
+    int16_t *copy;
+} StreamProducts_CubeLayout;
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && (STREAM_RAW_CUBE_ENABLE || STREAM_MAJOR_CUBE_ENABLE)
+/*! @brief Reordered major motion cube (shared by the raw and the tagged cube) */
+static StreamProducts_CubeLayout gMajorCubeLayout;
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && STREAM_MINOR_CUBE_ENABLE
+/*! @brief Reordered minor motion cube */
+static StreamProducts_CubeLayout gMinorCubeLayout;
+#endif
+
+#if STREAM_MAJOR_CUBE_ENABLE
+/*! @brief Tagged major motion cube */
+static StreamProducts_Cube gMajorCube;
+#endif
+
+#if STREAM_MINOR_CUBE_ENABLE
+/*! @brief Tagged minor motion cube */
+static StreamProducts_Cube gMinorCube;
+#endif
+
+#if STREAM_RANGE_PEAKS_ENABLE
+/*! @brief Configuration of the range peak search */
+static RangePeaks_Config gRangePeaksCfg;
+
+/*! @brief Range peak list record (header and payload) in L3 */
+static StreamRecord_Header *gRangePeaksRecord = NULL;
+#endif
+
+
+#if STREAM_BOOT_REPORT_ENABLE
+/*! @brief Boot report record (header and payload), transferred once */
+static StreamRecord_Header *gBootReportRecord = NULL;
+
+/*! @brief The boot report was transferred (kept across reconfigurations) */
+static uint32_t gBootReportSent = 0;
+#endif
+
+#if STREAM_SLOWTIME_CODEC_ENABLE
+/*! @brief Slow-time codec (twiddle factors and working memory) */
+static SlowTimeCodec_Obj gSlowTimeCodec;
+
+/*! @brief Slow-time coded cube record (header and payload) in L3, sized for the worst case */
+static StreamRecord_Header *gSlowTimeCodecRecord = NULL;
+#endif
+
+
+#if STREAM_RANGE_PEAKS_ENABLE
+/**
+ * @brief Returns the size of a range bin in meters.
+ *
+ * range bin size = c * Fs / (2 * slope * rangeFftSize)
+ */
+static float streamProducts_getRangeBinSize(void) {
+    /* active profile: defines.h or the last one applied via the SPI command slot */
+    const ConfigCmd_Profile *profile = &gSysContext.configCmd.active;
+    float adcSamplingRateHz = (100.0e6f / (float)profile->chirpComnCfg.digOutputSampRate);
+
+    return (3.0e8f * adcSamplingRateHz) /
+           (2.0f * (profile->chirpTimingCfg.chirpRfFreqSlope * 1.0e12f) * (float)gSysContext.rangeProcDpuCfg.staticCfg.rangeFftSize);
+}
+#endif
+
+/**
+ * @brief Appends a buffer to the list of buffers transferred via SPI.
+ */
+static int32_t streamProducts_addTxBuffer(void *data, uint32_t dataSize) {
+    if (gSysContext.numStreamTxBuf >= STREAM_MAX_TX_BUFFERS) {
+        DebugP_log("Error: too many SPI stream buffers\r\n");
+        return SystemP_FAILURE;
+    }
+
+    gSysContext.streamTxBuf[gSysContext.numStreamTxBuf].data     = data;
+    gSysContext.streamTxBuf[gSysContext.numStreamTxBuf].dataSize = dataSize;
+    gSysContext.numStreamTxBuf++;
+
+    return SystemP_SUCCESS;
+}
+
+/**
+ * @brief Allocates a record (header and payload) in the DMA capable memory region with the most free bytes
+ *        and appends it to the list of buffers transferred via SPI.
+ *
+ * @return pointer to the record header, NULL on failure
+ */
+static StreamRecord_Header *streamProducts_allocRecord(uint32_t payloadBytes) {
+    uint32_t recordBytes = sizeof(StreamRecord_Header) + STREAM_RECORD_ALIGN(payloadBytes);
+    StreamRecord_Header *record;
+
+    /* the MCSPI reads the record via DMA, so core local memory is out */
+    record = (StreamRecord_Header *)MemRegion_alloc(&gSysContext.memRegions,
+                                                    recordBytes,
+                                                    sizeof(uint32_t),
+                                                    MEM_REGION_ATTR_DMA,
+                                                    MEM_REGION_POLICY_LARGEST_FREE,
+                                                    "stream",
+                                                    NULL);
+    if (record == NULL) {
+        DebugP_log("Error: not enough memory for stream record (%u bytes)\r\n", recordBytes);
+        return NULL;
+    }
+
+    if (streamProducts_addTxBuffer(record, recordBytes) != SystemP_SUCCESS) {
+        return NULL;
+    }
+
+    return record;
+}
+
+#if STREAM_SLOWTIME_CODEC_ENABLE || STREAM_CFAR_DETECTIONS_ENABLE || STREAM_DOA_ESTIMATES_ENABLE || \
+    STREAM_BOOT_REPORT_ENABLE || STREAM_RESYNC_MARKER_ENABLE
+/**
+ * @brief Updates the transfer size of a registered SPI buffer, so that only the
+ *        used part of a variable size product is transferred.
+ */
+static void streamProducts_setTxBufferSize(const void *data, uint32_t dataSize) {
+    uint32_t i;
+
+    for (i = 0; i < gSysContext.numStreamTxBuf; i++) {
+        if (gSysContext.streamTxBuf[i].data == data) {
+            gSysContext.streamTxBuf[i].dataSize = STREAM_RECORD_ALIGN(dataSize);
+        }
+    }
+}
+#endif
+
+#if STREAM_MAJOR_CUBE_ENABLE || STREAM_MINOR_CUBE_ENABLE
+/**
+ * @brief Registers a tagged radar cube (record and cube buffer).
+ *
+ * The transfer sizes are kept in the stream buffer list by index, since the
+ * major motion cube may also be registered as the untagged raw cube.
+ */
+static int32_t streamProducts_addCube(StreamProducts_Cube *obj, uint8_t cubeType, uint32_t decim,
+                                      void *cube, uint32_t cubeBytes, uint32_t numChirps) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    StreamRecord_CubeInfo *info;
+
+    obj->bufIdx    = gSysContext.numStreamTxBuf;
+    obj->cubeBytes = cubeBytes;
+    obj->decim     = decim;
+    obj->record    = streamProducts_allocRecord(sizeof(StreamRecord_CubeInfo));
+    if (obj->record == NULL) {
+        return SystemP_FAILURE;
+    }
+
+    info = (StreamRecord_CubeInfo *)(obj->record + 1);
+    info->cubeType           = cubeType;
+    info->decim              = (uint8_t)decim;
+    info->numRangeBins       = params->numRangeBins;
+    info->numVirtualAntennas = params->numVirtualAntennas;
+    info->numChirps          = (uint16_t)numChirps;
+    info->order              = STREAM_CUBE_LAYOUT_ORDER;
+    info->iqSplit            = STREAM_CUBE_LAYOUT_IQ_SPLIT;
+    info->subFrameIdx        = (uint8_t)gSysContext.subFrameIdx;
+    info->reserved           = 0;
+
+    return streamProducts_addTxBuffer(cube, cubeBytes);
+}
+
+/**
+ * @brief Updates the record header of a tagged radar cube and enables its
+ *        transfer on the frames selected by the decimation factor.
+ */
+static void streamProducts_updateCube(StreamProducts_Cube *obj, uint32_t frameIdx) {
+    if ((frameIdx % obj->decim) == 0U) {
+        // the payload spans the cube info and the cube buffer which follows the record
+        StreamRecord_initHeader(obj->record, STREAM_RECORD_TYPE_RADAR_CUBE, frameIdx,
+                                sizeof(StreamRecord_CubeInfo) + obj->cubeBytes);
+        gSysContext.streamTxBuf[obj->bufIdx].dataSize     = sizeof(StreamRecord_Header) +
+                                                            STREAM_RECORD_ALIGN(sizeof(StreamRecord_CubeInfo));
+        gSysContext.streamTxBuf[obj->bufIdx + 1].dataSize = obj->cubeBytes;
+    } else {
+        // skipped frame: neither record nor cube are transferred
+        gSysContext.streamTxBuf[obj->bufIdx].dataSize     = 0;
+        gSysContext.streamTxBuf[obj->bufIdx + 1].dataSize = 0;
+    }
+}
+#endif
+
+#if SUBFRAME_ENABLE
+/**
+ * @brief Points a tagged radar cube to the cube of the current sub-frame and
+ *        updates its dimensions.
+ */
+static void streamProducts_selectSubFrameCube(StreamProducts_Cube *obj) {
+    DPU_RangeProcHWA_Config *rangeProcCfg = &gSysContext.rangeProcDpuCfg;
+    StreamRecord_CubeInfo *info = (StreamRecord_CubeInfo *)(obj->record + 1);
+
+    obj->cubeBytes = rangeProcCfg->hwRes.radarCube.dataSize;
+    gSysContext.streamTxBuf[obj->bufIdx + 1].data = rangeProcCfg->hwRes.radarCube.data;
+
+    info->numRangeBins = rangeProcCfg->staticCfg.numRangeBins;
+    info->numChirps    = (uint16_t)rangeProcCfg->staticCfg.numDopplerChirpsPerFrame;
+    info->subFrameIdx  = (uint8_t)gSysContext.subFrameIdx;
+}
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT
+/**
+ * @brief Allocates the reordered copy of a cube in the DMA capable memory region with the most free bytes.
+ *
+ * @return pointer to the copy, which is streamed instead of the cube, NULL on failure
+ */
+static void *streamProducts_configCubeLayout(StreamProducts_CubeLayout *obj, const void *cube,
+                                             uint32_t cubeBytes, uint32_t numChirps) {
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+
+    obj->cfg.numRangeBins       = params->numRangeBins;
+    obj->cfg.numVirtualAntennas = params->numVirtualAntennas;
+    obj->cfg.numChirps          = numChirps;
+    obj->cfg.order              = STREAM_CUBE_LAYOUT_ORDER;
+    obj->cfg.iqSplit            = STREAM_CUBE_LAYOUT_IQ_SPLIT;
+    obj->cube                   = (const int16_t *)cube;
+    obj->copy                   = (int16_t *)MemRegion_alloc(&gSysContext.memRegions,
+                                                             cubeBytes,
+                                                             sizeof(uint32_t),
+                                                             MEM_REGION_ATTR_DMA,
+                                                             MEM_REGION_POLICY_LARGEST_FREE,
+                                                             "stream",
+                                                             NULL);
+    if (obj->copy == NULL) {
+        DebugP_log("Error: not enough memory for the reordered cube (%u bytes)\r\n", cubeBytes);
+    }
+    return obj->copy;
+}
+
+/**
+ * @brief Reorders a cube into its copy.
+ */
+static void streamProducts_updateCubeLayout(StreamProducts_CubeLayout *obj, uint32_t frameIdx) {
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+
+    if (CubeLayout_fromNative(&obj->cfg, obj->cube, obj->copy) != 0) {
+        DebugP_log("Error: radar cube reordering failed\r\n");
+    }
+
+    // benchmark: duration of the post-pass (40 MHz ticks)
+    DebugP_logInfo("Frame %u: cube reordered in %u ticks\r\n", frameIdx,
+                   Cycleprofiler_getTimeStamp() - startTicks);
+}
+#endif
+
+#if STREAM_SLOWTIME_CODEC_ENABLE
+/**
+ * @brief Updates the payload size of a variable size record and the size of
+ *        its SPI buffer.
+ */
+static void streamProducts_setRecordSize(StreamRecord_Header *record, uint32_t payloadBytes) {
+    record->payloadBytes = STREAM_RECORD_ALIGN(payloadBytes);
+    streamProducts_setTxBufferSize(record, sizeof(StreamRecord_Header) + record->payloadBytes);
+}
+#endif
+
+int32_t streamProducts_config(void) {
+    DPU_RangeProcHWA_Config *rangeProcCfg = &gSysContext.rangeProcDpuCfg;
+    int32_t retVal = SystemP_SUCCESS;
+    void *majorCube = rangeProcCfg->hwRes.radarCube.data;
+#if STREAM_MINOR_CUBE_ENABLE
+    void *minorCube = rangeProcCfg->hwRes.radarCubeMinMot.data;
+#endif
+
+    gSysContext.numStreamTxBuf = 0;
+
+#if STREAM_RESYNC_MARKER_ENABLE
+    // first buffer of the frame, so that the host finds the frame start behind it
+    gResyncRecord = streamProducts_allocRecord(sizeof(Recovery_Marker));
+    if (gResyncRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    streamProducts_setTxBufferSize(gResyncRecord, 0);
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && (STREAM_RAW_CUBE_ENABLE || STREAM_MAJOR_CUBE_ENABLE)
+    majorCube = streamProducts_configCubeLayout(&gMajorCubeLayout, majorCube,
+                                                rangeProcCfg->hwRes.radarCube.dataSize,
+                                                rangeProcCfg->staticCfg.numDopplerChirpsPerFrame);
+    if (majorCube == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && STREAM_MINOR_CUBE_ENABLE
+    minorCube = streamProducts_configCubeLayout(&gMinorCubeLayout, minorCube,
+                                                rangeProcCfg->hwRes.radarCubeMinMot.dataSize,
+                                                rangeProcCfg->staticCfg.numMinorMotionChirpsPerFrame);
+    if (minorCube == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_FRAME_INFO_ENABLE
+    gFrameInfoRecord = streamProducts_allocRecord(sizeof(StreamRecord_FrameInfo));
+    if (gFrameInfoRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_RAW_CUBE_ENABLE
+    retVal = streamProducts_addTxBuffer(majorCube, rangeProcCfg->hwRes.radarCube.dataSize);
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_CUBE_QUANT_ENABLE
+    gCubeQuantCfg.granularity  = STREAM_CUBE_QUANT_GRANULARITY;
+    gCubeQuantCfg.ditherEnable = STREAM_CUBE_QUANT_DITHER_ENABLE;
+    gCubeQuantCfg.numRangeBins = rangeProcCfg->staticCfg.numRangeBins;
+    gCubeQuantCfg.numRows      = (uint32_t)rangeProcCfg->staticCfg.numVirtualAntennas *
+                                 rangeProcCfg->staticCfg.numDopplerChirpsPerFrame;
+
+    gCubeQuantRecord = streamProducts_allocRecord(CubeQuant_getPayloadSize(&gCubeQuantCfg));
+    if (gCubeQuantRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_RANGE_PROFILE_ENABLE || STREAM_RANGE_PEAKS_ENABLE
+    gRangeProfileAcc = (uint64_t *)DPC_ObjDet_MemPoolAllocTagged(&gSysContext.CoreLocalRamObj,
+                                                                  rangeProcCfg->staticCfg.numRangeBins * sizeof(uint64_t),
+                                                                  sizeof(uint64_t),
+                                                                  "stream");
+    if (gRangeProfileAcc == NULL) {
+        DebugP_log("Error: not enough core local memory for the range profile\r\n");
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_RANGE_PROFILE_ENABLE
+    gRangeProfileRecord = streamProducts_allocRecord(sizeof(RangeProfile_Header) +
+                                                     rangeProcCfg->staticCfg.numRangeBins * sizeof(uint32_t));
+    if (gRangeProfileRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_RD_HEATMAP_ENABLE
+    gRdHeatmapRecord = streamProducts_allocRecord(sizeof(RdHeatmap_Header));
+    if (gRdHeatmapRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    retVal = streamProducts_addTxBuffer(gSysContext.rdHeatmap, RdHeatmap_getSize(&gSysContext.rdHeatmapCfg));
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_CFAR_DETECTIONS_ENABLE
+    gCfarRecord = streamProducts_allocRecord(0);
+    if (gCfarRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    retVal = streamProducts_addTxBuffer(gSysContext.cfarDetList, Cfar_getListSize(&gSysContext.cfarCfg));
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_DOA_HEATMAP_ENABLE
+    gDoaHeatmapRecord = streamProducts_allocRecord(sizeof(Doa_HeatmapHeader));
+    if (gDoaHeatmapRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    retVal = streamProducts_addTxBuffer(gSysContext.doaHeatmap, Doa_getHeatmapSize(&gSysContext.doaCfg));
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_DOA_ESTIMATES_ENABLE
+    gDoaEstimatesRecord = streamProducts_allocRecord(0);
+    if (gDoaEstimatesRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    retVal = streamProducts_addTxBuffer(gSysContext.doaList, Doa_getListSize(gSysContext.cfarCfg.maxDetections));
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_MICRO_DOPPLER_ENABLE
+    gMicroDopplerRecord = streamProducts_allocRecord(0);
+    if (gMicroDopplerRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    retVal = streamProducts_addTxBuffer(gSysContext.microDoppler,
+                                        MicroDoppler_getSize(((MicroDoppler_Header *)gSysContext.microDoppler)->numDopplerBins));
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_MAJOR_CUBE_ENABLE
+    retVal = streamProducts_addCube(&gMajorCube, STREAM_RECORD_CUBE_MAJOR, STREAM_MAJOR_CUBE_DECIM,
+                                    majorCube,
+                                    rangeProcCfg->hwRes.radarCube.dataSize,
+                                    rangeProcCfg->staticCfg.numDopplerChirpsPerFrame);
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_MINOR_CUBE_ENABLE
+    retVal = streamProducts_addCube(&gMinorCube, STREAM_RECORD_CUBE_MINOR, STREAM_MINOR_CUBE_DECIM,
+                                    minorCube,
+                                    rangeProcCfg->hwRes.radarCubeMinMot.dataSize,
+                                    rangeProcCfg->staticCfg.numMinorMotionChirpsPerFrame);
+    if (retVal != SystemP_SUCCESS) {
+        return retVal;
+    }
+#endif
+
+#if STREAM_RANGE_PEAKS_ENABLE
+    gRangePeaksCfg.maxPeaks           = STREAM_RANGE_PEAKS_MAX_PEAKS;
+    gRangePeaksCfg.minBin             = STREAM_RANGE_PEAKS_MIN_BIN;
+    gRangePeaksCfg.numRangeBins       = rangeProcCfg->staticCfg.numRangeBins;
+    gRangePeaksCfg.numVirtualAntennas = rangeProcCfg->staticCfg.numVirtualAntennas;
+    gRangePeaksCfg.numDopplerChirps   = rangeProcCfg->staticCfg.numDopplerChirpsPerFrame;
+
+    gRangePeaksRecord = streamProducts_allocRecord(RangePeaks_getPayloadSize(&gRangePeaksCfg));
+    if (gRangePeaksRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+#endif
+
+#if STREAM_SLOWTIME_CODEC_ENABLE
+    {
+        SlowTimeCodec_Config codecCfg;
+
+        codecCfg.targetSnrDb        = STREAM_SLOWTIME_CODEC_SNR_DB;
+        codecCfg.numRangeBins       = rangeProcCfg->staticCfg.numRangeBins;
+        codecCfg.numVirtualAntennas = rangeProcCfg->staticCfg.numVirtualAntennas;
+        codecCfg.numDopplerChirps   = rangeProcCfg->staticCfg.numDopplerChirpsPerFrame;
+
+        if (SlowTimeCodec_init(&gSlowTimeCodec, &codecCfg) != 0) {
+            DebugP_log("Error: unsupported slow-time codec configuration\r\n");
+            return SystemP_FAILURE;
+        }
+
+        gSlowTimeCodecRecord = streamProducts_allocRecord(SlowTimeCodec_getMaxPayloadSize(&codecCfg));
+        if (gSlowTimeCodecRecord == NULL) {
+            return SystemP_FAILURE;
+        }
+    }
+#endif
+
+#if STREAM_BOOT_REPORT_ENABLE
+    gBootReportRecord = streamProducts_allocRecord(sizeof(BootReport_Payload));
+    if (gBootReportRecord == NULL) {
+        return SystemP_FAILURE;
+    }
+    streamProducts_setTxBufferSize(gBootReportRecord, 0);
+#endif
+
+    (void)rangeProcCfg;
+    (void)majorCube;
+    return retVal;
+}
+
+void streamProducts_process(uint32_t frameIdx) {
+#if STREAM_RESYNC_MARKER_ENABLE
+    streamProducts_setTxBufferSize(gResyncRecord, 0);
+    if (Recovery_takeMarker(&gSysContext.recovery, (Recovery_Marker *)(gResyncRecord + 1)) != 0) {
+        StreamRecord_initHeader(gResyncRecord, STREAM_RECORD_TYPE_RESYNC, frameIdx, sizeof(Recovery_Marker));
+        streamProducts_setTxBufferSize(gResyncRecord, sizeof(StreamRecord_Header) + sizeof(Recovery_Marker));
+    }
+#endif
+
+#if STREAM_FRAME_INFO_ENABLE
+    {
+        StreamRecord_FrameInfo *info = (StreamRecord_FrameInfo *)(gFrameInfoRecord + 1);
+        DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+
+        StreamRecord_initHeader(gFrameInfoRecord, STREAM_RECORD_TYPE_FRAME_INFO, frameIdx,
+                                sizeof(StreamRecord_FrameInfo));
+        info->fftOutputDivShift        = params->rangeFFTtuning.fftOutputDivShift;
+        info->numButterflyStagesScaled = params->rangeFFTtuning.numLastButterflyStagesToScale;
+        info->cubePeak                 = gSysContext.cubeStats.peak;
+        info->cubeNumSaturated         = gSysContext.cubeStats.numSaturated;
+    }
+#endif
+
+#if STREAM_CUBE_QUANT_ENABLE
+    {
+        CubeQuant_Header *quantHdr = (CubeQuant_Header *)(gCubeQuantRecord + 1);
+
+        StreamRecord_initHeader(gCubeQuantRecord, STREAM_RECORD_TYPE_CUBE_QUANT, frameIdx,
+                                CubeQuant_getPayloadSize(&gCubeQuantCfg));
+
+        if (CubeQuant_quantize(&gCubeQuantCfg,
+                               (const int16_t *)gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                               quantHdr,
+                               &gCubeQuantDitherState) != 0) {
+            DebugP_log("Error: radar cube quantisation failed\r\n");
+        }
+
+        // telemetry: the SQNR is contained in the record, log it for debugging as well
+        DebugP_logInfo("Frame %u: quantised cube SQNR %d dB\r\n", frameIdx,
+                       (int32_t)MIN(quantHdr->sqnrDb, 999.0f));
+    }
+#endif
+
+#if STREAM_RANGE_PROFILE_ENABLE || STREAM_RANGE_PEAKS_ENABLE
+    // the 64-bit profile is shared by the range profile and the peak list
+    DPU_RangeProcHWA_StaticConfig *params = &gSysContext.rangeProcDpuCfg.staticCfg;
+    const int16_t *cube = (const int16_t *)gSysContext.rangeProcDpuCfg.hwRes.radarCube.data;
+    uint32_t numRows = (uint32_t)params->numVirtualAntennas * params->numDopplerChirpsPerFrame;
+    uint32_t startTicks = Cycleprofiler_getTimeStamp();
+    uint32_t accTicks;
+
+    RangeProfile_accumulate(cube, params->numRangeBins, numRows, gRangeProfileAcc);
+    accTicks = Cycleprofiler_getTimeStamp() - startTicks;
+#endif
+
+#if STREAM_RANGE_PROFILE_ENABLE
+    {
+        RangeProfile_Header *profileHdr = (RangeProfile_Header *)(gRangeProfileRecord + 1);
+
+        startTicks = Cycleprofiler_getTimeStamp();
+        StreamRecord_initHeader(gRangeProfileRecord, STREAM_RECORD_TYPE_RANGE_PROFILE, frameIdx,
+                                sizeof(RangeProfile_Header) + params->numRangeBins * sizeof(uint32_t));
+
+        RangeProfile_pack(gRangeProfileAcc, params->numRangeBins, numRows, (uint32_t *)(profileHdr + 1));
+
+        // benchmark: duration of the reduction over the cube (40 MHz ticks)
+        profileHdr->numRangeBins = params->numRangeBins;
+        profileHdr->shift        = (uint8_t)RangeProfile_getShift(numRows);
+        profileHdr->reserved     = 0;
+        profileHdr->computeTicks = accTicks + (Cycleprofiler_getTimeStamp() - startTicks);
+    }
+#endif
+
+#if STREAM_RD_HEATMAP_ENABLE
+    {
+        RdHeatmap_Header *heatmapHdr = (RdHeatmap_Header *)(gRdHeatmapRecord + 1);
+        RdHeatmap_Config *heatmapCfg = &gSysContext.rdHeatmapCfg;
+
+        // the payload spans the header record and the heatmap buffer which follows it
+        StreamRecord_initHeader(gRdHeatmapRecord, STREAM_RECORD_TYPE_RD_HEATMAP, frameIdx,
+                                sizeof(RdHeatmap_Header) + RdHeatmap_getSize(heatmapCfg));
+        heatmapHdr->numRangeBins       = heatmapCfg->numRangeBins;
+        heatmapHdr->numDopplerBins     = heatmapCfg->fftSize;
+        heatmapHdr->numVirtualAntennas = (uint8_t)heatmapCfg->numVirtualAntennas;
+        heatmapHdr->shift              = (uint8_t)RdHeatmap_getShift(heatmapCfg->numVirtualAntennas);
+        heatmapHdr->reserved           = 0;
+        heatmapHdr->computeTicks       = gSysContext.dopplerProcTicks;
+    }
+#endif
+
+#if STREAM_CFAR_DETECTIONS_ENABLE
+    {
+        uint32_t listBytes = Cfar_getUsedListSize(gSysContext.cfarDetList);
+
+        // the payload spans the header record and the used part of the detection list
+        StreamRecord_initHeader(gCfarRecord, STREAM_RECORD_TYPE_CFAR_DETECTIONS, frameIdx, listBytes);
+        streamProducts_setTxBufferSize(gSysContext.cfarDetList, listBytes);
+    }
+#endif
+
+#if STREAM_DOA_HEATMAP_ENABLE
+    {
+        Doa_HeatmapHeader *doaHdr = (Doa_HeatmapHeader *)(gDoaHeatmapRecord + 1);
+        Doa_Config *doaCfg = &gSysContext.doaCfg;
+
+        // the payload spans the header record and the heatmap buffer which follows it
+        StreamRecord_initHeader(gDoaHeatmapRecord, STREAM_RECORD_TYPE_DOA_HEATMAP, frameIdx,
+                                sizeof(Doa_HeatmapHeader) + Doa_getHeatmapSize(doaCfg));
+        doaHdr->numRangeBins   = doaCfg->numRangeBins;
+        doaHdr->numAzimuthBins = doaCfg->azimuthFftSize;
+        doaHdr->numChirps      = doaCfg->numChirps;
+        doaHdr->shift          = (uint8_t)Doa_getShift(doaCfg->numChirps);
+        doaHdr->numAzimuthCols = (uint8_t)doaCfg->numAzimuthCols;
+        doaHdr->computeTicks   = gSysContext.doaProcTicks;
+        doaHdr->hwaTicks       = gSysContext.doaHwaTicks;
+    }
+#endif
+
+#if STREAM_DOA_ESTIMATES_ENABLE
+    {
+        uint32_t listBytes = Doa_getUsedListSize(gSysContext.doaList);
+
+        // the payload spans the header record and the used part of the estimate list
+        StreamRecord_initHeader(gDoaEstimatesRecord, STREAM_RECORD_TYPE_DOA_ESTIMATES, frameIdx, listBytes);
+        streamProducts_setTxBufferSize(gSysContext.doaList, listBytes);
+    }
+#endif
+
+#if STREAM_MICRO_DOPPLER_ENABLE
+    // the payload is the column buffer (header included) which follows the record header
+    StreamRecord_initHeader(gMicroDopplerRecord, STREAM_RECORD_TYPE_MICRO_DOPPLER, frameIdx,
+                            MicroDoppler_getSize(((MicroDoppler_Header *)gSysContext.microDoppler)->numDopplerBins));
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && (STREAM_RAW_CUBE_ENABLE || STREAM_MAJOR_CUBE_ENABLE)
+    streamProducts_updateCubeLayout(&gMajorCubeLayout, frameIdx);
+#endif
+
+#if STREAM_CUBE_LAYOUT_CONVERT && STREAM_MINOR_CUBE_ENABLE
+    streamProducts_updateCubeLayout(&gMinorCubeLayout, frameIdx);
+#endif
+
+#if SUBFRAME_ENABLE
+    streamProducts_selectSubFrameCube(&gMajorCube);
+#endif
+
+#if STREAM_MAJOR_CUBE_ENABLE
+    streamProducts_updateCube(&gMajorCube, frameIdx);
+#endif
+
+#if STREAM_MINOR_CUBE_ENABLE
+    streamProducts_updateCube(&gMinorCube, frameIdx);
+#endif
+
+#if STREAM_RANGE_PEAKS_ENABLE
+    {
+        RangePeaks_Header *peaksHdr = (RangePeaks_Header *)(gRangePeaksRecord + 1);
+
+        startTicks = Cycleprofiler_getTimeStamp();
+        StreamRecord_initHeader(gRangePeaksRecord, STREAM_RECORD_TYPE_RANGE_PEAKS, frameIdx,
+                                RangePeaks_getPayloadSize(&gRangePeaksCfg));
+
+        if (RangePeaks_find(&gRangePeaksCfg, cube, gRangeProfileAcc, peaksHdr) < 0) {
+            DebugP_log("Error: range peak search failed\r\n");
+        }
+
+        // benchmark: duration of the reduction over the cube (40 MHz ticks)
+        peaksHdr->computeTicks  = accTicks + (Cycleprofiler_getTimeStamp() - startTicks);
+        peaksHdr->rangeBinSizeM = streamProducts_getRangeBinSize();
+    }
+#endif
+
+#if STREAM_SLOWTIME_CODEC_ENABLE
+    {
+        SlowTimeCodec_Header *codecHdr = (SlowTimeCodec_Header *)(gSlowTimeCodecRecord + 1);
+        int32_t payloadBytes;
+
+        StreamRecord_initHeader(gSlowTimeCodecRecord, STREAM_RECORD_TYPE_SLOWTIME_CODEC, frameIdx, 0);
+
+        payloadBytes = SlowTimeCodec_encode(&gSlowTimeCodec,
+                                            (const int16_t *)gSysContext.rangeProcDpuCfg.hwRes.radarCube.data,
+                                            codecHdr);
+        if (payloadBytes < 0) {
+            DebugP_log("Error: slow-time coding of the radar cube failed\r\n");
+            payloadBytes = 0;
+        }
+        streamProducts_setRecordSize(gSlowTimeCodecRecord, (uint32_t)payloadBytes);
+
+        // telemetry: compressed size and SNR are contained in the record, log them for debugging as well
+        DebugP_logInfo("Frame %u: slow-time coded cube %u bytes, SNR %d dB\r\n", frameIdx,
+                       (uint32_t)payloadBytes, (int32_t)MIN(codecHdr->achievedSnrDb, 999.0f));
+    }
+#endif
+
+#if STREAM_BOOT_REPORT_ENABLE
+    // once, with the first frame after the first one reached the wire
+    streamProducts_setTxBufferSize(gBootReportRecord, 0);
+    if ((gBootReportSent == 0U) && (BootReport_isComplete(&gSysContext.bootReport) != 0)) {
+        StreamRecord_initHeader(gBootReportRecord, STREAM_RECORD_TYPE_BOOT_REPORT, frameIdx,
+                                sizeof(BootReport_Payload));
+        memcpy(gBootReportRecord + 1, &gSysContext.bootReport.payload, sizeof(BootReport_Payload));
+        streamProducts_setTxBufferSize(gBootReportRecord, sizeof(StreamRecord_Header) + sizeof(BootReport_Payload));
+        gBootReportSent = 1U;
+    }
+#endif
+
+    (void)frameIdx;
+}
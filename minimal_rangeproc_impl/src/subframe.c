@@ -0,0 +1,78 @@
+/**
+ * @file subframe.c
+ * @brief Parameters and memory bookkeeping of interleaved sub-frames.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "chirp_accum.h"
+#include "subframe.h"
+
+
+/**
+ * @brief Returns the smallest power of 2 >= n.
+ */
+static uint32_t SubFrame_pow2roundup(uint32_t n) {
+    uint32_t p = 1U;
+
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+int32_t SubFrame_plan(const SubFrame_Config *cfg, uint32_t numSubFrames,
+                      uint32_t numTxAntennas, uint32_t numRxAntennas,
+                      uint32_t cubeBudget, uint32_t windowBudget, SubFrame_Plan *plan) {
+    uint32_t i;
+
+    memset(plan, 0, sizeof(SubFrame_Plan));
+
+    if ((numSubFrames == 0U) || (numSubFrames > SUBFRAME_MAX_NUM)) {
+        return -1;
+    }
+    plan->numSubFrames = numSubFrames;
+
+    for (i = 0; i < numSubFrames; i++) {
+        SubFrame_Layout *layout = &plan->layout[i];
+        ChirpAccum_Config accumCfg;
+        ChirpAccum_Dims accumDims;
+
+        if (cfg[i].numAdcSamples == 0U) {
+            return -1;
+        }
+
+        accumCfg.numChirpsPerBurst  = cfg[i].numChirpsPerBurst;
+        accumCfg.numBurstsPerFrame  = cfg[i].numBurstsPerFrame;
+        accumCfg.numChirpsAccum     = cfg[i].numChirpsAccum;
+        accumCfg.numTxAntennas      = numTxAntennas;
+        accumCfg.numVirtualAntennas = numTxAntennas * numRxAntennas;
+        accumCfg.numRangeBins       = SubFrame_pow2roundup(cfg[i].numAdcSamples) / 2U;
+        if ((ChirpAccum_compute(&accumCfg, &accumDims) != 0) || (accumDims.cubeBytes == 0U)) {
+            return -1;
+        }
+
+        layout->numRangeBins             = accumCfg.numRangeBins;
+        layout->numChirpsPerFrame        = accumDims.numChirpsPerFrame;
+        layout->numDopplerChirpsPerFrame = accumDims.numDopplerChirpsPerFrame;
+        layout->extraShift               = accumDims.extraShift;
+        layout->cubeBytes                = accumDims.cubeBytes;
+        layout->cubeOffset               = plan->cubeBytes;
+        layout->windowBytes              = (uint32_t)sizeof(uint32_t) * ((cfg[i].numAdcSamples + 1U) / 2U);
+        layout->windowOffset             = plan->windowBytes;
+
+        // cube sizes are multiples of 4, windows are made of 32-bit words, so no padding is needed
+        plan->cubeBytes   += layout->cubeBytes;
+        plan->windowBytes += layout->windowBytes;
+    }
+
+    if ((plan->cubeBytes > cubeBudget) || (plan->windowBytes > windowBudget)) {
+        return -1;
+    }
+    return 0;
+}
+
+uint32_t SubFrame_next(uint32_t idx, uint32_t numSubFrames) {
+    return ((idx + 1U) < numSubFrames) ? (idx + 1U) : 0U;
+}
@@ -0,0 +1,45 @@
+/**
+ * @file warm_start.c
+ * @brief State retained in RAM across resets for the warm-start boot path.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "config_cmd.h"
+#include "warm_start.h"
+
+/**
+ * @brief CRC-32 of the record without its CRC field.
+ */
+static uint32_t WarmStart_crc(const WarmStart_State *state) {
+    return ConfigCmd_crc32(state, (uint32_t)offsetof(WarmStart_State, crc));
+}
+
+int32_t WarmStart_isValid(const WarmStart_State *state, const void *calib, uint32_t calibBytes) {
+    if ((state->magic != WARM_START_MAGIC) || (state->version != WARM_START_VERSION)) {
+        return 0;
+    }
+    if (WarmStart_crc(state) != state->crc) {
+        return 0;
+    }
+    return (ConfigCmd_crc32(calib, calibBytes) == state->calibCrc) ? 1 : 0;
+}
+
+void WarmStart_invalidate(WarmStart_State *state) {
+    state->magic = 0U;
+    state->crc   = 0U;
+}
+
+void WarmStart_seal(WarmStart_State *state, uint32_t numBoots, const ConfigCmd_Profile *profile,
+                    uint32_t profileSource, const void *calib, uint32_t calibBytes) {
+    memset(state, 0, sizeof(WarmStart_State));
+    state->magic         = WARM_START_MAGIC;
+    state->version       = WARM_START_VERSION;
+    state->numBoots      = numBoots;
+    state->profile       = *profile;
+    state->profileSource = profileSource;
+    state->calibCrc      = ConfigCmd_crc32(calib, calibBytes);
+    state->crc           = WarmStart_crc(state);
+}
@@ -0,0 +1,164 @@
+/**
+ * @file boot_report_sim.c
+ * @brief Host test of the boot report (boot_report.h) and its stream record.
+ *
+ * Marks the boot phases in the order of main.c and rangeproc_dpc.c with
+ * known durations, starting shortly before the 32-bit timer wraps, and checks
+ * the duration of every phase, the sums and that the report is complete only
+ * after the first frame was transmitted. Then frames the payload as
+ * STREAM_RECORD_TYPE_BOOT_REPORT record like stream_products.c, checks its
+ * byte layout against the little endian layout documented for host tools, and
+ * that BootReport_decode() accepts it and rejects a truncated payload,
+ * another version and another number of phases. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o boot_report_sim scripts/boot_report_sim.c \
+ *         minimal_rangeproc_impl/src/boot_report.c
+ *     ./boot_report_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "boot_report.h"
+#include "sim_check.h"
+#include "stream_record.h"
+
+/*! @brief Frame reference timer at the entry of freertos_main(), 40000 ticks before the wrap */
+#define SIM_START_TICKS         0xFFFF63C0U
+
+/*! @brief Frame index of the record (the frame after the first one) */
+#define SIM_FRAME_IDX           1U
+
+/*! @brief Boots since the last cold boot of the warm boot */
+#define SIM_NUM_BOOTS           3U
+
+/**
+ * @brief Duration of a phase in the simulated boot (40 MHz ticks).
+ */
+static uint32_t Sim_phaseTicks(uint32_t phase) {
+    return 1000U * (phase + 1U) + phase;
+}
+
+static uint32_t Sim_readU32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static void Sim_boot(BootReport *report) {
+    uint32_t now = SIM_START_TICKS;
+    uint32_t phase;
+    int ok = 1;
+
+    BootReport_init(report, now);
+    for (phase = 0; phase < BOOT_PHASE_NUM; phase++) {
+        ok = ok && (BootReport_isComplete(report) == 0);
+        if (phase == BOOT_PHASE_PROFILE) {
+            /* main.c: after mmwave_checkWarmStart(), at the end of the profile phase */
+            BootReport_setBoot(report, 1U, SIM_NUM_BOOTS);
+        }
+        now += Sim_phaseTicks(phase);
+        BootReport_mark(report, (BootReport_Phase)phase, now);
+    }
+    Sim_check(ok && (BootReport_isComplete(report) == 1),
+              "report is complete only once the first frame was transmitted");
+}
+
+static void Sim_testPhases(const BootReport *report) {
+    BootReport copy = *report;
+    uint32_t phase, total = 0, numDiff = 0;
+    int ok;
+    char msg[160];
+
+    for (phase = 0; phase < BOOT_PHASE_NUM; phase++) {
+        numDiff += (report->payload.phaseTicks[phase] != Sim_phaseTicks(phase)) ? 1U : 0U;
+        total += Sim_phaseTicks(phase);
+    }
+    snprintf(msg, sizeof(msg), "durations of all %u phases across the timer wrap (%u differ)",
+             (unsigned)BOOT_PHASE_NUM, numDiff);
+    Sim_check((numDiff == 0U) && (report->payload.startTicks == SIM_START_TICKS), msg);
+
+    ok = (BootReport_sumTicks(&report->payload, BOOT_PHASE_DRIVERS, BOOT_PHASE_FIRST_TX) == total) &&
+         (BootReport_sumTicks(&report->payload, BOOT_PHASE_FIRST_FRAME, BOOT_PHASE_FIRST_TX) ==
+          Sim_phaseTicks(BOOT_PHASE_FIRST_FRAME) + Sim_phaseTicks(BOOT_PHASE_FIRST_TX)) &&
+         (BootReport_sumTicks(&report->payload, BOOT_PHASE_START, BOOT_PHASE_START) ==
+          Sim_phaseTicks(BOOT_PHASE_START)) &&
+         (BootReport_sumTicks(&report->payload, BOOT_PHASE_FIRST_TX, BOOT_PHASE_DRIVERS) == 0U);
+    snprintf(msg, sizeof(msg), "restart latency is the sum of all phases (%u ticks), partial sums", total);
+    Sim_check(ok, msg);
+
+    ok = (report->payload.flags == BOOT_REPORT_FLAG_WARM) && (report->payload.numBoots == SIM_NUM_BOOTS);
+    BootReport_setBoot(&copy, 0U, 1U);
+    ok = ok && (copy.payload.flags == 0U) && (copy.payload.numBoots == 1U);
+    Sim_check(ok, "warm and cold boot flags and boot count");
+
+    copy = *report;
+    BootReport_mark(&copy, BOOT_PHASE_NUM, SIM_START_TICKS);
+    Sim_check(memcmp(&copy, report, sizeof(copy)) == 0, "mark of an invalid phase is ignored");
+
+    ok = (strcmp(BootReport_phaseName(BOOT_PHASE_NUM), "?") == 0);
+    for (phase = 0; phase < BOOT_PHASE_NUM; phase++) {
+        uint32_t other;
+
+        ok = ok && (strcmp(BootReport_phaseName((BootReport_Phase)phase), "?") != 0);
+        for (other = 0; other < phase; other++) {
+            ok = ok && (strcmp(BootReport_phaseName((BootReport_Phase)phase),
+                               BootReport_phaseName((BootReport_Phase)other)) != 0);
+        }
+    }
+    Sim_check(ok, "every phase has its own name");
+}
+
+static void Sim_testRecord(const BootReport *report) {
+    static uint8_t record[sizeof(StreamRecord_Header) + sizeof(BootReport_Payload) + 4U];
+    const StreamRecord_Header *header = (const StreamRecord_Header *)record;
+    const uint8_t *bytes = record + sizeof(StreamRecord_Header);
+    BootReport_Payload payload;
+    uint32_t phase, numDiff = 0;
+    int ok;
+    char msg[160];
+
+    /* as stream_products.c frames it */
+    StreamRecord_initHeader((StreamRecord_Header *)record, STREAM_RECORD_TYPE_BOOT_REPORT, SIM_FRAME_IDX,
+                            sizeof(BootReport_Payload));
+    memcpy(record + sizeof(StreamRecord_Header), &report->payload, sizeof(BootReport_Payload));
+    ok = (header->magic == STREAM_RECORD_MAGIC) && (header->recordType == STREAM_RECORD_TYPE_BOOT_REPORT) &&
+         (header->frameIdx == SIM_FRAME_IDX) && (header->payloadBytes == sizeof(BootReport_Payload));
+    snprintf(msg, sizeof(msg), "record header of the %u byte payload", (unsigned)sizeof(BootReport_Payload));
+    Sim_check(ok && (sizeof(BootReport_Payload) == 20U + 4U * BOOT_PHASE_NUM), msg);
+
+    /* layout a host tool decodes: version, numPhases, flags, numBoots, startTicks, phaseMask, phaseTicks[] */
+    ok = ((bytes[0] | (bytes[1] << 8)) == BOOT_REPORT_VERSION) &&
+         ((bytes[2] | (bytes[3] << 8)) == BOOT_PHASE_NUM) &&
+         (Sim_readU32(bytes + 4) == BOOT_REPORT_FLAG_WARM) && (Sim_readU32(bytes + 8) == SIM_NUM_BOOTS) &&
+         (Sim_readU32(bytes + 12) == SIM_START_TICKS) && (Sim_readU32(bytes + 16) == (1U << BOOT_PHASE_NUM) - 1U);
+    for (phase = 0; phase < BOOT_PHASE_NUM; phase++) {
+        numDiff += (Sim_readU32(bytes + 20U + 4U * phase) != Sim_phaseTicks(phase)) ? 1U : 0U;
+    }
+    Sim_check(ok && (numDiff == 0U), "payload bytes follow the documented little endian layout");
+
+    ok = (BootReport_decode(bytes, header->payloadBytes, &payload) == BOOT_REPORT_OK) &&
+         (memcmp(&payload, &report->payload, sizeof(payload)) == 0);
+    Sim_check(ok, "decoded payload equals the report");
+
+    Sim_check(BootReport_decode(bytes, header->payloadBytes - 4U, &payload) == BOOT_REPORT_ERR_LENGTH,
+              "truncated payload is rejected");
+
+    record[sizeof(StreamRecord_Header)] = (uint8_t)(BOOT_REPORT_VERSION + 1U);
+    ok = (BootReport_decode(bytes, header->payloadBytes, &payload) == BOOT_REPORT_ERR_VERSION);
+    record[sizeof(StreamRecord_Header)] = (uint8_t)BOOT_REPORT_VERSION;
+    record[sizeof(StreamRecord_Header) + 2U] = (uint8_t)(BOOT_PHASE_NUM - 1U);
+    ok = ok && (BootReport_decode(bytes, header->payloadBytes, &payload) == BOOT_REPORT_ERR_LENGTH);
+    Sim_check(ok, "payload of another version or number of phases is rejected");
+}
+
+int main(void) {
+    BootReport report;
+
+    Sim_boot(&report);
+    Sim_testPhases(&report);
+    Sim_testRecord(&report);
+
+    return Sim_result();
+}
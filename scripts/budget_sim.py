@@ -0,0 +1,175 @@
+"""
+Host test of the build-time budget checks (budget.h generated by chirp_config_to_defines.py).
+
+Generates budget.h for a matrix of profiles derived from profiles/default.cfg
+(ADC samples, bursts, chirps per burst, accumulation, TX antennas, burst and
+frame period) and compiles it with the C compiler. Every profile must compile
+exactly when an independent model of the cube size and timing fits the limits
+of budget_limits.h, and a profile which does not fit must fail with the
+#error or static assertion of each limit it exceeds, and only those. The
+matrix is run once against budget_limits.h and once against a copy with a
+small core local pool and large SPI frames, so that every assertion fires.
+Also checks that the committed budget.h compiles. Exits with 1 if a check
+fails.
+
+Run (from the repo root, CC selects the compiler, default gcc):
+
+    python3 scripts/budget_sim.py
+"""
+import concurrent.futures
+import itertools
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import chirp_config_to_defines as gen
+
+REPO_ROOT   = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+INCLUDE_DIR = os.path.join(REPO_ROOT, 'minimal_rangeproc_impl', 'include')
+BASE_CFG    = os.path.join(REPO_ROOT, 'profiles', 'default.cfg')
+CC          = os.environ.get('CC', 'gcc')
+
+# profile matrix: numOfAdcSamples, numOfBurstsInFrame, numOfChirpsInBurst, numOfChirpsAccum,
+# txChCtrlBitMask, burstPeriodicity (us), framePeriodicity (ms)
+MATRIX = list(itertools.product((64, 100, 128, 256, 512, 1024), (16, 64, 128, 256), (2, 4, 6), (0, 2),
+                                (3, 1), (100, 403), (50, 100, 200)))
+
+# limits of the second run: every assertion of budget.h fires for some profiles
+TIGHT_LIMITS = {'MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE': '(1024U)', 'BITS_PER_FRAME': '(8U * 9U * 1024U)'}
+
+# message of each check in the compiler output
+REASONS = {
+    'accum':  'infeasible configuration',
+    'L3':     'radar cube exceeds L3_MEM_SIZE',
+    'window': 'range window exceeds MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE',
+    'frame':  'radar cube is not a multiple of the SPI frame size',
+    'spi':    'chirping and the SPI transfer of the radar cube exceed the frame period',
+}
+
+num_failed = 0
+
+
+def check(ok, what):
+    global num_failed
+    print(f"{'pass' if ok else 'FAIL'}: {what}")
+    if not ok:
+        num_failed += 1
+
+
+def profile(base, n_adc, bursts, cpb, accum, tx, burst_us, frame_ms):
+    """
+    Copy of the base configuration with the parameters of a matrix entry
+    """
+    data = {cmd: dict(params) for cmd, params in base.items()}
+    data['chirpComnCfg']['numOfAdcSamples'] = str(n_adc)
+    data['frameCfg']['numOfBurstsInFrame']  = str(bursts)
+    data['frameCfg']['numOfChirpsInBurst']  = str(cpb)
+    data['frameCfg']['numOfChirpsAccum']    = str(accum)
+    data['channelCfg']['txChCtrlBitMask']   = str(tx)
+    data['frameCfg']['burstPeriodicity']    = str(burst_us)
+    data['frameCfg']['framePeriodicity']    = str(frame_ms)
+    return data
+
+
+def expected_reasons(limits, n_rx, n_adc, bursts, cpb, accum, tx, burst_us, frame_ms):
+    """
+    Independent model: the checks a profile must fail
+    """
+    n_tx = bin(tx).count('1')
+    accum = max(accum, 1)
+    if cpb % accum or (cpb // accum) % n_tx:
+        return {'accum'}
+    reasons = set()
+    n_bins = 1
+    while n_bins < n_adc:
+        n_bins *= 2
+    cube = (n_bins // 2) * n_tx * n_rx * ((cpb // accum) * bursts // n_tx) * 4
+    spi_us = -(-cube * 8 * 1000000 // limits['SPI_SCLK_HZ'])
+    if cube > limits['L3_MEM_SIZE']:
+        reasons.add('L3')
+    if 4 * ((n_adc + 1) // 2) > limits['MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE']:
+        reasons.add('window')
+    if cube % limits['BYTES_PER_FRAME']:
+        reasons.add('frame')
+    if burst_us * bursts + spi_us > frame_ms * 1000:
+        reasons.add('spi')
+    return reasons
+
+
+def compile_header(include_dirs, header):
+    """
+    Compiles a header, returns the compiler exit code and messages
+    """
+    cmd = [CC, '-std=c11', '-fsyntax-only'] + [f'-I{d}' for d in include_dirs] + ['-x', 'c', header]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    return result.returncode, result.stderr
+
+
+def run_matrix(base, tmp_dir, limits_dir, name):
+    """
+    Generates and compiles budget.h for every profile of the matrix
+    """
+    limits = gen.read_budget_limits(os.path.join(limits_dir, gen.BUDGET_LIMITS_HEADER_NAME))
+    n_rx = bin(int(base['channelCfg']['rxChCtrlBitMask'])).count('1')
+
+    def run(idx_entry):
+        idx, entry = idx_entry
+        header = os.path.join(tmp_dir, f'{name}_{idx}', gen.BUDGET_HEADER_NAME)
+        os.makedirs(os.path.dirname(header))
+        gen.generate_budget_file(profile(base, *entry), 'budget_sim.py', 'matrix', header)
+        code, messages = compile_header([limits_dir, INCLUDE_DIR], header)
+        got = {reason for reason, text in REASONS.items() if text in messages}
+        return entry, code, got, expected_reasons(limits, n_rx, *entry)
+
+    mismatches = []
+    counts = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=os.cpu_count()) as pool:
+        for entry, code, got, expected in pool.map(run, enumerate(MATRIX)):
+            if ((code == 0) != (not expected)) or (got != expected):
+                mismatches.append((entry, sorted(got), sorted(expected)))
+            key = '+'.join(sorted(expected)) or 'ok'
+            counts[key] = counts.get(key, 0) + 1
+    for entry, got, expected in mismatches[:5]:
+        print(f"      {entry}: failed {got}, expected {expected}")
+    summary = ', '.join(f'{k} {v}' for k, v in sorted(counts.items()))
+    check(not mismatches, f"{name}: {len(MATRIX)} profiles compile or fail with the expected checks ({summary})")
+    return counts
+
+
+def main():
+    base = gen.parse_config_file(BASE_CFG)
+
+    code, messages = compile_header([INCLUDE_DIR], os.path.join(INCLUDE_DIR, gen.BUDGET_HEADER_NAME))
+    check(code == 0, f"committed {gen.BUDGET_HEADER_NAME} compiles")
+
+    tmp_dir = tempfile.mkdtemp(prefix='budget_sim_')
+    try:
+        counts = run_matrix(base, tmp_dir, INCLUDE_DIR, gen.BUDGET_LIMITS_HEADER_NAME)
+        check(all(counts.get(k, 0) > 0 for k in ('ok', 'accum', 'L3', 'spi')),
+              "the matrix has feasible profiles and profiles failing each limit of budget_limits.h")
+
+        # copy of budget_limits.h with the tight limits
+        tight_dir = os.path.join(tmp_dir, 'tight')
+        os.makedirs(tight_dir)
+        with open(os.path.join(INCLUDE_DIR, gen.BUDGET_LIMITS_HEADER_NAME), 'r') as f:
+            text = f.read()
+        for macro, value in TIGHT_LIMITS.items():
+            text = re.sub(rf'(#define\s+{macro}\s+).*', rf'\g<1>{value}', text)
+        with open(os.path.join(tight_dir, gen.BUDGET_LIMITS_HEADER_NAME), 'w') as f:
+            f.write(text)
+        counts = run_matrix(base, tmp_dir, tight_dir, 'tight limits')
+        check(all(any(k in key.split('+') for key in counts) for k in REASONS),
+              "with the tight limits every check of budget.h fires")
+    finally:
+        shutil.rmtree(tmp_dir)
+
+    print(f"\n{'ok' if num_failed == 0 else 'FAILED'}: {num_failed} check(s) failed")
+    sys.exit(0 if num_failed == 0 else 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,238 @@
+/**
+ * @file cal_store_sim.c
+ * @brief Host simulation of the factory calibration record in flash (cal_store.h).
+ *
+ * Runs a sequence of boots through CalStore_run() against a simulated NOR
+ * flash sector (erase sets all bits, programming can only clear bits) and a
+ * simulated front end whose calibration result depends on the device. Faults
+ * are injected into single boots: a record of the demo format, a corrupted
+ * sector, a power loss while the record is programmed, a failing calibration,
+ * a front end which rejects the stored data and a build without generation.
+ * Prints the result of every boot and the state of the sector afterwards, and
+ * checks that a record the front end rejected or a record of the demo format
+ * is never erased. Exits with 1 if a boot has an unexpected result.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -Wall -Iminimal_rangeproc_impl/include -o cal_store_sim scripts/cal_store_sim.c \
+ *         minimal_rangeproc_impl/src/cal_store.c minimal_rangeproc_impl/src/config_cmd.c \
+ *         minimal_rangeproc_impl/src/chirp_accum.c minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     ./cal_store_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cal_store.h"
+
+/*! @brief MMWDEMO_CALIB_STORE_MAGIC of factory_cal.h (SDK header, not included here) */
+#define SIM_CALIB_MAGIC         0x7CB28DF9U
+
+/*! @brief Erase block of the simulated flash */
+#define SIM_SECTOR_BYTES        4096U
+
+/*! @brief Calibration data of the simulated front end */
+#define SIM_CALIB_BYTES         120U
+
+/**
+ * @brief Record as in factory_cal.h: header and calibration data.
+ */
+typedef struct Sim_Record_t
+{
+    CalStore_Header header;
+    uint8_t         calibData[SIM_CALIB_BYTES];
+} Sim_Record;
+
+/**
+ * @brief Simulated flash sector, front end and injected faults.
+ */
+typedef struct Sim_Device_t
+{
+    uint8_t     sector[SIM_SECTOR_BYTES];
+    Sim_Record  *record;        /* record buffer in RAM */
+    uint8_t     seed;           /* device specific calibration result */
+    int         powerFail;      /* power lost after half of the record was programmed */
+    int         failCalib;
+    int         rejectRestore;  /* front end rejects the stored data */
+    int         calibrated;     /* front end holds a calibration after the boot */
+    int         numCalibrations;
+    int         numErases;
+} Sim_Device;
+
+static int32_t Sim_read(void *arg, void *record, uint32_t recordBytes) {
+    Sim_Device *dev = (Sim_Device *)arg;
+
+    memcpy(record, dev->sector, recordBytes);
+    return 0;
+}
+
+static int32_t Sim_write(void *arg, const void *record, uint32_t recordBytes) {
+    Sim_Device *dev = (Sim_Device *)arg;
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t numBytes = dev->powerFail ? (recordBytes / 2U) : recordBytes;
+    uint32_t i;
+
+    memset(dev->sector, 0xFF, sizeof(dev->sector));
+    dev->numErases++;
+    for (i = 0; i < numBytes; i++) {
+        dev->sector[i] &= bytes[i];
+    }
+    return dev->powerFail ? -1 : 0;
+}
+
+static int32_t Sim_restore(void *arg) {
+    Sim_Device *dev = (Sim_Device *)arg;
+
+    if (dev->rejectRestore) {
+        return -1;
+    }
+    dev->calibrated = 1;
+    return 0;
+}
+
+static int32_t Sim_calibrate(void *arg) {
+    Sim_Device *dev = (Sim_Device *)arg;
+    uint32_t i;
+
+    dev->numCalibrations++;
+    if (dev->failCalib) {
+        return -1;
+    }
+    for (i = 0; i < SIM_CALIB_BYTES; i++) {
+        dev->record->calibData[i] = (uint8_t)(dev->seed + i);
+    }
+    dev->calibrated = 1;
+    return 0;
+}
+
+static const char *Sim_resultName(int32_t result) {
+    switch (result) {
+    case CAL_STORE_RESTORED:        return "RESTORED";
+    case CAL_STORE_GENERATED:       return "GENERATED";
+    case CAL_STORE_RESTORED_LEGACY: return "RESTORED_LEGACY";
+    case CAL_STORE_CALIBRATED_RAM:  return "CALIBRATED_RAM";
+    case CAL_STORE_ERR_NO_RECORD:   return "ERR_NO_RECORD";
+    case CAL_STORE_ERR_CALIB:       return "ERR_CALIB";
+    case CAL_STORE_ERR_SAVE:        return "ERR_SAVE";
+    case CAL_STORE_ERR_RESTORE:     return "ERR_RESTORE";
+    default:                        return "?";
+    }
+}
+
+/**
+ * @brief One boot: RAM is random, the sector keeps its content.
+ */
+static int32_t Sim_boot(Sim_Device *dev, const CalStore_Ops *ops, uint32_t flags, const char *step) {
+    int32_t result;
+
+    memset(dev->record, 0xA5, sizeof(Sim_Record));
+    dev->calibrated = 0;
+    result = CalStore_run(dev->record, sizeof(Sim_Record), SIM_CALIB_MAGIC, flags, ops);
+    printf("%-22s %-15s calibrated %d, record in RAM %s, sector %s, calibrations %d, erases %d\n",
+           step, Sim_resultName(result), dev->calibrated,
+           CalStore_isValid(dev->record, sizeof(Sim_Record), SIM_CALIB_MAGIC) ? "valid" : "invalid",
+           CalStore_isValid(dev->sector, sizeof(Sim_Record), SIM_CALIB_MAGIC) ? "valid" : "invalid",
+           dev->numCalibrations, dev->numErases);
+    return result;
+}
+
+int main(void) {
+    static Sim_Device dev;
+    static uint8_t saved[SIM_SECTOR_BYTES];
+    Sim_Record record;
+    CalStore_Ops ops;
+    uint32_t flags = CAL_STORE_FLAG_GENERATE;
+    uint32_t magic = SIM_CALIB_MAGIC;
+    uint32_t i;
+    int numErases;
+    int numFailed = 0;
+
+    memset(&dev, 0, sizeof(dev));
+    memset(dev.sector, 0xFF, sizeof(dev.sector));
+    dev.record = &record;
+    dev.seed   = 0x42U;
+    ops.read      = Sim_read;
+    ops.write     = Sim_write;
+    ops.restore   = Sim_restore;
+    ops.calibrate = Sim_calibrate;
+    ops.arg       = &dev;
+
+    /* erased flash without generation: the firmware runs uncalibrated */
+    numFailed += (Sim_boot(&dev, &ops, 0U, "erased, no generation") != CAL_STORE_ERR_NO_RECORD);
+
+    /* fresh device: calibrate and save, then only restore */
+    numFailed += (Sim_boot(&dev, &ops, flags, "fresh device") != CAL_STORE_GENERATED);
+    numFailed += (Sim_boot(&dev, &ops, flags, "second boot") != CAL_STORE_RESTORED);
+    numFailed += (record.calibData[0] != dev.seed);
+
+    /* warm boot: the record retained in RAM is used without reading the sector */
+    numFailed += (CalStore_run(&record, sizeof(record), SIM_CALIB_MAGIC,
+                               flags | CAL_STORE_FLAG_RETAINED, &ops) != CAL_STORE_RESTORED);
+    memset(&record, 0xA5, sizeof(record));
+    numFailed += (CalStore_run(&record, sizeof(record), SIM_CALIB_MAGIC,
+                               flags | CAL_STORE_FLAG_RETAINED, &ops) != CAL_STORE_GENERATED);
+    printf("%-22s retained record restored, random RAM regenerated\n", "warm boot");
+
+    /* a flipped bit: replaced */
+    dev.sector[sizeof(CalStore_Header) + 7U] ^= 0x10U;
+    numFailed += (Sim_boot(&dev, &ops, flags, "corrupted sector") != CAL_STORE_GENERATED);
+
+    /* a corrupted version is not mistaken for the demo format */
+    dev.sector[4] ^= 0x01U;
+    numFailed += (Sim_boot(&dev, &ops, flags, "corrupted version") != CAL_STORE_GENERATED);
+
+    /* power lost while programming: calibrated now, repeated at the next boot */
+    memset(dev.sector, 0xFF, sizeof(dev.sector));
+    dev.powerFail = 1;
+    numFailed += (Sim_boot(&dev, &ops, flags, "power loss on save") != CAL_STORE_ERR_SAVE);
+    numFailed += (dev.calibrated != 1);
+    dev.powerFail = 0;
+    numFailed += (Sim_boot(&dev, &ops, flags, "after power loss") != CAL_STORE_GENERATED);
+
+    /* calibration fails: nothing is written */
+    memset(dev.sector, 0xFF, sizeof(dev.sector));
+    dev.failCalib = 1;
+    numFailed += (Sim_boot(&dev, &ops, flags, "calibration fails") != CAL_STORE_ERR_CALIB);
+    dev.failCalib = 0;
+    numFailed += (Sim_boot(&dev, &ops, flags, "calibration ok") != CAL_STORE_GENERATED);
+
+    /* front end rejects the stored data: calibrated into RAM only, the record is kept */
+    memcpy(saved, dev.sector, sizeof(saved));
+    numErases = dev.numErases;
+    dev.rejectRestore = 1;
+    dev.seed = 0x17U;
+    numFailed += (Sim_boot(&dev, &ops, flags, "restore rejected") != CAL_STORE_CALIBRATED_RAM);
+    numFailed += (dev.calibrated != 1);
+    numFailed += (Sim_boot(&dev, &ops, 0U, "rejected, no generate") != CAL_STORE_ERR_RESTORE);
+    numFailed += (dev.calibrated != 0);
+    numFailed += (CalStore_isValid(&record, sizeof(record), SIM_CALIB_MAGIC) != 0);
+    dev.rejectRestore = 0;
+    numFailed += (Sim_boot(&dev, &ops, flags, "after rejection") != CAL_STORE_RESTORED);
+    numFailed += (record.calibData[0] != 0x42U);
+    numFailed += (memcmp(saved, dev.sector, sizeof(saved)) != 0) || (dev.numErases != numErases);
+
+    /* record of the demo format: magic directly followed by the data, restored and kept */
+    memset(dev.sector, 0xFF, sizeof(dev.sector));
+    memcpy(dev.sector, &magic, sizeof(magic));
+    for (i = 0; i < SIM_CALIB_BYTES; i++) {
+        dev.sector[CAL_STORE_LEGACY_HEADER_BYTES + i] = (uint8_t)(0x33U + i);
+    }
+    memcpy(saved, dev.sector, sizeof(saved));
+    numErases = dev.numErases;
+    numFailed += (Sim_boot(&dev, &ops, flags, "demo format") != CAL_STORE_RESTORED_LEGACY);
+    numFailed += (record.calibData[0] != 0x33U) ||
+                 (record.calibData[SIM_CALIB_BYTES - 1U] != (uint8_t)(0x33U + SIM_CALIB_BYTES - 1U));
+    numFailed += (CalStore_isValid(&record, sizeof(record), SIM_CALIB_MAGIC) != 1);
+    numFailed += (CalStore_run(&record, sizeof(record), SIM_CALIB_MAGIC,
+                               flags | CAL_STORE_FLAG_RETAINED, &ops) != CAL_STORE_RESTORED);
+    printf("%-22s converted record retained in RAM restored\n", "warm boot, demo format");
+    dev.rejectRestore = 1;
+    numFailed += (Sim_boot(&dev, &ops, flags, "demo format rejected") != CAL_STORE_CALIBRATED_RAM);
+    dev.rejectRestore = 0;
+    numFailed += (Sim_boot(&dev, &ops, flags, "demo format again") != CAL_STORE_RESTORED_LEGACY);
+    numFailed += (memcmp(saved, dev.sector, sizeof(saved)) != 0) || (dev.numErases != numErases);
+
+    printf("%s\n", (numFailed == 0) ? "all boots as expected" : "unexpected results");
+    return (numFailed == 0) ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file cfar_sim.c
+ * @brief Host detection-equivalence test and benchmark of the CFAR detection (cfar.h).
+ *
+ * Compares the detection lists of Cfar_detectRangeProfile() and
+ * Cfar_detectRdHeatmap() with a straightforward reference CFAR (noise cells
+ * collected per cell, sorted with qsort for OS, local maxima checked on the
+ * full neighbourhood) on random range profiles and heatmaps with targets, for
+ * all modes, several guard and noise lengths, with and without peak grouping
+ * and with an overflowing list. Checks the false alarm rate of CA and OS on
+ * exponentially distributed noise against theory, the argument checks, and
+ * times the detection with the stage configuration of cfar_proc.h on a
+ * heatmap of the default profile. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o cfar_sim scripts/cfar_sim.c \
+ *         minimal_rangeproc_impl/src/cfar.c -lm
+ *     ./cfar_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cfar.h"
+#include "cfar_proc.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 64 Doppler bins */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_DOPPLER_BINS    64U
+
+/*! @brief Range bins of the profiles of the false alarm test */
+#define SIM_PFA_RANGE_BINS      4096U
+#define SIM_PFA_TRIALS          200U
+
+/*! @brief Largest detection list of the tests */
+#define SIM_MAX_DETECTIONS      512U
+
+static int Sim_compareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Reference CFAR, same detection rule and list order as cfar.h, written for clarity.
+ *
+ * @return number of detections, numDropped in *numDropped
+ */
+static uint32_t Sim_reference(const Cfar_Config *cfg, const uint32_t *in, uint32_t numRangeBins,
+                              uint32_t numDopplerBins, Cfar_Detection *det, uint32_t *numDropped) {
+    uint32_t n = cfg->noiseLen, g = cfg->guardLen;
+    uint32_t r, d, j, numDet = 0;
+
+    *numDropped = 0;
+    for (r = cfg->minRangeBin; r < numRangeBins; r++) {
+        for (d = 0; d < numDopplerBins; d++) {
+            uint32_t value = in[r * numDopplerBins + d];
+            uint32_t cells[2U * CFAR_MAX_NOISE_LEN], numCells = 0;
+            uint64_t sumLeft = 0, sumRight = 0, noise;
+            int hasLeft = (r >= g + n), hasRight = (r + g + n < numRangeBins);
+
+            if (!hasLeft && !hasRight) {
+                continue;
+            }
+            for (j = 1; j <= n; j++) {
+                if (hasLeft) {
+                    sumLeft += in[(r - g - j) * numDopplerBins + d];
+                    cells[numCells++] = in[(r - g - j) * numDopplerBins + d];
+                }
+                if (hasRight) {
+                    sumRight += in[(r + g + j) * numDopplerBins + d];
+                    cells[numCells++] = in[(r + g + j) * numDopplerBins + d];
+                }
+            }
+            if (cfg->mode == CFAR_MODE_OS) {
+                qsort(cells, numCells, sizeof(uint32_t), Sim_compareU32);
+                noise = cells[((numCells == 2U * n) ? cfg->osRank : (cfg->osRank + 1U) / 2U) - 1U];
+            } else if ((cfg->mode != CFAR_MODE_CA) && hasLeft && hasRight) {
+                noise = (((cfg->mode == CFAR_MODE_CAGO) == (sumLeft > sumRight)) ? sumLeft : sumRight) / n;
+            } else {
+                noise = (sumLeft + sumRight) / numCells;
+            }
+            if ((uint64_t)value * 256U <= (uint64_t)cfg->thresholdQ8 * noise) {
+                continue;
+            }
+            if (cfg->peakGroupEn) {
+                /* ties: the first cell along range and Doppler wins */
+                if (((r > 0U) && (in[(r - 1U) * numDopplerBins + d] > value)) ||
+                    ((r + 1U < numRangeBins) && (in[(r + 1U) * numDopplerBins + d] >= value)) ||
+                    ((numDopplerBins > 1U) &&
+                     ((in[r * numDopplerBins + (d + numDopplerBins - 1U) % numDopplerBins] > value) ||
+                      (in[r * numDopplerBins + (d + 1U) % numDopplerBins] >= value)))) {
+                    continue;
+                }
+            }
+            if (numDet >= cfg->maxDetections) {
+                (*numDropped)++;
+                continue;
+            }
+            det[numDet].rangeIdx   = (uint16_t)r;
+            det[numDet].dopplerIdx = (uint16_t)d;
+            det[numDet].snrDbQ8    = (noise > 0U) ? (int16_t)lrint(fmin(10.0 * log10((double)value / (double)noise),
+                                                                        127.0) * 256.0) : (int16_t)(127 * 256);
+            det[numDet].level      = (uint16_t)((value > UINT16_MAX) ? UINT16_MAX : value);
+            numDet++;
+        }
+    }
+    return numDet;
+}
+
+/**
+ * @brief Compares a detection list with the reference, the SNR within 1 LSB of Q8 (float vs double log10).
+ */
+static int Sim_equal(const void *list, const Cfar_Detection *ref, uint32_t numRef, uint32_t numDropped,
+                     int32_t ret) {
+    const Cfar_Header *hdr = (const Cfar_Header *)list;
+    const Cfar_Detection *det = (const Cfar_Detection *)(hdr + 1);
+    uint32_t i;
+
+    if ((ret != (int32_t)numRef) || (hdr->numDetections != numRef) || (hdr->numDropped != numDropped) ||
+        (Cfar_getUsedListSize(list) != sizeof(Cfar_Header) + numRef * sizeof(Cfar_Detection))) {
+        return 0;
+    }
+    for (i = 0; i < numRef; i++) {
+        if ((det[i].rangeIdx != ref[i].rangeIdx) || (det[i].dopplerIdx != ref[i].dopplerIdx) ||
+            (det[i].level != ref[i].level) || (abs(det[i].snrDbQ8 - ref[i].snrDbQ8) > 1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Heatmap with noise, plateaus (ties) and point targets, and the range profile of its sums.
+ */
+static void Sim_fillScene(uint16_t *heatmap, uint32_t *profile, uint32_t seed) {
+    uint32_t r, d, t;
+
+    srand(seed);
+    for (r = 0; r < SIM_NUM_RANGE_BINS; r++) {
+        for (d = 0; d < SIM_NUM_DOPPLER_BINS; d++) {
+            heatmap[r * SIM_NUM_DOPPLER_BINS + d] = (uint16_t)(100 + rand() % 50);
+        }
+    }
+    for (t = 0; t < 12U; t++) {
+        r = (uint32_t)rand() % SIM_NUM_RANGE_BINS;
+        d = (uint32_t)rand() % SIM_NUM_DOPPLER_BINS;
+        heatmap[r * SIM_NUM_DOPPLER_BINS + d] = (uint16_t)(400 + rand() % 60000);
+        if ((t % 4U) == 0U) {
+            /* equal neighbour along Doppler, only one of both may be reported */
+            heatmap[r * SIM_NUM_DOPPLER_BINS + (d + 1U) % SIM_NUM_DOPPLER_BINS] = heatmap[r * SIM_NUM_DOPPLER_BINS + d];
+        }
+    }
+    for (r = 0; r < SIM_NUM_RANGE_BINS; r++) {
+        profile[r] = 0;
+        for (d = 0; d < SIM_NUM_DOPPLER_BINS; d++) {
+            profile[r] += heatmap[r * SIM_NUM_DOPPLER_BINS + d];
+        }
+        /* large values test the 64-bit threshold products */
+        profile[r] *= 1000U;
+    }
+}
+
+static void Sim_testEquivalence(void *list) {
+    static const uint8_t guards[] = { 0U, 1U, 2U, 4U };
+    static const uint8_t noises[] = { 1U, 4U, 8U, 16U };
+    static const uint32_t thresholds[] = { 300U, 1366U, 4056U };
+    static uint16_t heatmap[SIM_NUM_RANGE_BINS * SIM_NUM_DOPPLER_BINS];
+    static uint32_t heatmap32[SIM_NUM_RANGE_BINS * SIM_NUM_DOPPLER_BINS];
+    static Cfar_Detection ref[SIM_MAX_DETECTIONS];
+    uint32_t profile[SIM_NUM_RANGE_BINS];
+    uint32_t seed, mode, g, n, t, pg, i, numRef, numDropped, numRuns = 0, numDet = 0, numOverflow = 0;
+    int okProfile = 1, okHeatmap = 1;
+    char msg[200];
+
+    for (seed = 1; seed <= 4U; seed++) {
+        Sim_fillScene(heatmap, profile, seed);
+        for (i = 0; i < SIM_NUM_RANGE_BINS * SIM_NUM_DOPPLER_BINS; i++) {
+            heatmap32[i] = heatmap[i];
+        }
+        for (mode = CFAR_MODE_CA; mode <= CFAR_MODE_OS; mode++) {
+            for (g = 0; g < sizeof(guards); g++) {
+                for (n = 0; n < sizeof(noises); n++) {
+                    for (t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); t++) {
+                        for (pg = 0; pg < 2U; pg++) {
+                            Cfar_Config cfg = { (uint8_t)mode, guards[g], noises[n],
+                                                (uint8_t)((3U * noises[n] + 1U) / 2U), thresholds[t],
+                                                (uint16_t)(seed - 1U), (uint8_t)pg, 0U,
+                                                (uint16_t)((t == 0U) ? 20U : SIM_MAX_DETECTIONS) };
+                            int32_t ret;
+
+                            ret = Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list);
+                            numRef = Sim_reference(&cfg, profile, SIM_NUM_RANGE_BINS, 1U, ref, &numDropped);
+                            okProfile = okProfile && Sim_equal(list, ref, numRef, numDropped, ret);
+
+                            ret = Cfar_detectRdHeatmap(&cfg, heatmap, SIM_NUM_RANGE_BINS, SIM_NUM_DOPPLER_BINS, list);
+                            numRef = Sim_reference(&cfg, heatmap32, SIM_NUM_RANGE_BINS, SIM_NUM_DOPPLER_BINS, ref,
+                                                   &numDropped);
+                            okHeatmap = okHeatmap && Sim_equal(list, ref, numRef, numDropped, ret);
+
+                            numRuns++;
+                            numDet += numRef;
+                            numOverflow += (numDropped > 0U) ? 1U : 0U;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "range profile: %u configurations match the reference CFAR", numRuns);
+    Sim_check(okProfile, msg);
+    snprintf(msg, sizeof(msg), "heatmap: %u configurations match the reference CFAR (%u detections, %u full lists)",
+             numRuns, numDet, numOverflow);
+    Sim_check(okHeatmap && (numOverflow > 0U), msg);
+}
+
+/**
+ * @brief False alarm rate of a range profile of exponential noise (square law detector) against theory.
+ */
+static void Sim_testFalseAlarms(void *list, uint8_t mode, uint32_t thresholdQ8) {
+    static uint32_t profile[SIM_PFA_RANGE_BINS];
+    Cfar_Config cfg = { mode, 2U, 8U, 12U, thresholdQ8, 0U, 0U, 0U, SIM_MAX_DETECTIONS };
+    const Cfar_Detection *det = (const Cfar_Detection *)((const Cfar_Header *)list + 1);
+    uint32_t numCells = 0, numAlarms = 0, trial, i, k;
+    double alpha = thresholdQ8 / 256.0, expected = 1.0, measured;
+    char msg[160];
+
+    if (mode == CFAR_MODE_CA) {
+        expected = pow(1.0 + alpha / 16.0, -16.0);
+    } else {
+        /* k-th of N ordered statistic: prod (N - i) / (N - i + alpha) */
+        for (k = 0; k < cfg.osRank; k++) {
+            expected *= (16.0 - k) / (16.0 - k + alpha);
+        }
+    }
+
+    srand(7);
+    for (trial = 0; trial < SIM_PFA_TRIALS; trial++) {
+        int32_t numDet;
+
+        for (i = 0; i < SIM_PFA_RANGE_BINS; i++) {
+            profile[i] = (uint32_t)lrint(-1e6 * log(((double)rand() + 1.0) / ((double)RAND_MAX + 2.0)));
+        }
+        numDet = Cfar_detectRangeProfile(&cfg, profile, SIM_PFA_RANGE_BINS, list);
+        /* only cells with both noise windows complete */
+        for (i = 0; i < (uint32_t)numDet; i++) {
+            numAlarms += ((det[i].rangeIdx >= 10U) && (det[i].rangeIdx < SIM_PFA_RANGE_BINS - 10U)) ? 1U : 0U;
+        }
+        numCells += SIM_PFA_RANGE_BINS - 20U;
+    }
+    measured = (double)numAlarms / (double)numCells;
+    snprintf(msg, sizeof(msg), "%s false alarm rate %.2e at threshold %.2f, theory %.2e (within 10%%)",
+             (mode == CFAR_MODE_CA) ? "CA" : "OS", measured, alpha, expected);
+    Sim_check(fabs(measured / expected - 1.0) < 0.1, msg);
+}
+
+static void Sim_testArguments(void *list) {
+    uint32_t profile[SIM_NUM_RANGE_BINS] = { 0 };
+    Cfar_Config cfg = { CFAR_MODE_OS, 2U, 8U, 17U, 4056U, 0U, 1U, 0U, 16U };
+    int ok;
+
+    ok = (Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list) == -1);
+    cfg.osRank = 0U;
+    ok = ok && (Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list) == -1);
+    cfg.osRank = 12U;
+    cfg.noiseLen = 0U;
+    ok = ok && (Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list) == -1);
+    cfg.noiseLen = CFAR_MAX_NOISE_LEN + 1U;
+    ok = ok && (Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list) == -1);
+    cfg.noiseLen = 8U;
+    cfg.mode = CFAR_MODE_OS + 1U;
+    ok = ok && (Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list) == -1);
+    Sim_check(ok, "OS rank out of range, 0 or too many noise cells and unknown modes are rejected");
+    Sim_check((Cfar_getListSize(&cfg) % 4U == 0U) && (Cfar_getListSize(&cfg) == 12U + 16U * 8U),
+              "list size is a multiple of 4 bytes");
+}
+
+static void Sim_benchmark(void *list) {
+    static uint16_t heatmap[SIM_NUM_RANGE_BINS * SIM_NUM_DOPPLER_BINS];
+    uint32_t profile[SIM_NUM_RANGE_BINS];
+    Cfar_Config cfg = { CFARPROC_MODE, CFARPROC_GUARD_LEN, CFARPROC_NOISE_LEN, CFARPROC_OS_RANK,
+                        CFARPROC_THRESHOLD_Q8, CFARPROC_MIN_RANGE_BIN, CFARPROC_PEAK_GROUP_EN, 0U,
+                        CFARPROC_MAX_DETECTIONS };
+    struct timespec t0, t1, t2;
+    uint32_t i, iterations = 200U;
+    int32_t numDet = 0;
+
+    Sim_fillScene(heatmap, profile, 1U);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        numDet = Cfar_detectRdHeatmap(&cfg, heatmap, SIM_NUM_RANGE_BINS, SIM_NUM_DOPPLER_BINS, list);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (i = 0; i < iterations; i++) {
+        (void)Cfar_detectRangeProfile(&cfg, profile, SIM_NUM_RANGE_BINS, list);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    printf("\nbenchmark, stage configuration of cfar_proc.h: %u x %u heatmap in %.1f us (%d detections), "
+           "range profile in %.2f us\n", SIM_NUM_RANGE_BINS, SIM_NUM_DOPPLER_BINS,
+           ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations, numDet,
+           ((double)(t2.tv_sec - t1.tv_sec) * 1e6 + (double)(t2.tv_nsec - t1.tv_nsec) * 1e-3) / iterations);
+}
+
+int main(void) {
+    void *list = aligned_alloc(4, sizeof(Cfar_Header) + SIM_MAX_DETECTIONS * sizeof(Cfar_Detection));
+
+    Sim_testEquivalence(list);
+    Sim_testFalseAlarms(list, CFAR_MODE_CA, 1366U);
+    Sim_testFalseAlarms(list, CFAR_MODE_OS, 1366U);
+    Sim_testArguments(list);
+    Sim_benchmark(list);
+
+    free(list);
+    return Sim_result();
+}
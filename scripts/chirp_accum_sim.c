@@ -0,0 +1,204 @@
+/**
+ * @file chirp_accum_sim.c
+ * @brief Host test of the cube dimensions and range FFT scaling with chirp accumulation (chirp_accum.h).
+ *
+ * Checks the cube dimensions of the default frame with and without
+ * accumulation, compares ChirpAccum_compute() with a chirp-by-chirp count of
+ * the chirp events of a frame over a grid of burst sizes, accumulation factors
+ * and TX antennas, and simulates the accumulation of N chirps (a tone in
+ * Gaussian noise) followed by a range DFT: the measured SNR gain must match
+ * snrGainDb and the extra shift must keep the cube amplitude at or below the
+ * amplitude without accumulation. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o chirp_accum_sim scripts/chirp_accum_sim.c \
+ *         minimal_rangeproc_impl/src/chirp_accum.c minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     ./chirp_accum_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chirp_accum.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 2 chirps per burst, 64 bursts, 2 TX, 6 virtual antennas, 64 range bins */
+#define SIM_CHIRPS_PER_BURST    2U
+#define SIM_BURSTS_PER_FRAME    64U
+#define SIM_NUM_TX              2U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_RANGE_BINS      64U
+
+/*! @brief ADC samples per chirp, tone bin and amplitudes of the accumulation simulation */
+#define SIM_NUM_ADC_SAMPLES     128U
+#define SIM_TONE_BIN            20U
+#define SIM_TONE_AMP            200.0
+#define SIM_NOISE_SIGMA         100.0
+#define SIM_NUM_TRIALS          200U
+
+static double Sim_noise(void) {
+    double u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    double u2 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+
+    return SIM_NOISE_SIGMA * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void Sim_testDefaultFrame(void) {
+    ChirpAccum_Config cfg = { SIM_CHIRPS_PER_BURST, SIM_BURSTS_PER_FRAME, 0U, SIM_NUM_TX, SIM_NUM_ANTENNAS,
+                              SIM_NUM_RANGE_BINS };
+    ChirpAccum_Dims dims;
+    int ok;
+
+    ok = (ChirpAccum_compute(&cfg, &dims) == 0) && (dims.accumFactor == 1U) && (dims.numChirpsPerFrame == 128U) &&
+         (dims.numDopplerChirpsPerFrame == 64U) && (dims.cubeBytes == 98304U) && (dims.extraShift == 0U) &&
+         (dims.snrGainDb == 0.0f);
+    cfg.numChirpsAccum = 1U;
+    ok = ok && (ChirpAccum_compute(&cfg, &dims) == 0) && (dims.cubeBytes == 98304U);
+    Sim_check(ok, "default frame: 64 doppler chirps, 98304 byte cube, numOfChirpsAccum 0 and 1 are the same");
+
+    cfg.numChirpsPerBurst = 8U;
+    cfg.numChirpsAccum = 4U;
+    ok = (ChirpAccum_compute(&cfg, &dims) == 0) && (dims.numChirpsPerFrame == 128U) &&
+         (dims.numDopplerChirpsPerFrame == 64U) && (dims.cubeBytes == 98304U) && (dims.extraShift == 2U);
+    Sim_check(ok, "8 chirps per burst accumulated by 4: same cube as the default frame, 2 bits more shift");
+
+    cfg.numChirpsPerBurst = SIM_CHIRPS_PER_BURST;
+    cfg.numChirpsAccum = 2U;
+    Sim_check(ChirpAccum_compute(&cfg, &dims) == -1, "2 chirps per burst accumulated by 2 (1 chirp for 2 TX) is rejected");
+}
+
+/**
+ * @brief Reference: walks the chirps of a frame, the TX antenna advances once per accumulated chirp.
+ *
+ * @return 0 and the doppler chirps per frame, -1 if the configuration is not valid
+ */
+static int32_t Sim_countChirps(const ChirpAccum_Config *cfg, uint32_t *numDoppler) {
+    uint32_t factor = (cfg->numChirpsAccum > 1U) ? cfg->numChirpsAccum : 1U;
+    uint32_t burst, chirp, numEvents = 0, tx = 0, inEvent = 0;
+
+    for (burst = 0; burst < cfg->numBurstsPerFrame; burst++) {
+        tx = 0;
+        for (chirp = 0; chirp < cfg->numChirpsPerBurst; chirp++) {
+            if (++inEvent == factor) {
+                inEvent = 0;
+                numEvents++;
+                tx = (tx + 1U) % cfg->numTxAntennas;
+            }
+        }
+        /* a burst ends with a complete accumulated chirp and a complete TX cycle */
+        if ((inEvent != 0U) || (tx != 0U)) {
+            return -1;
+        }
+    }
+    *numDoppler = numEvents / cfg->numTxAntennas;
+    return (numEvents == 0U) ? -1 : 0;
+}
+
+static void Sim_testGrid(void) {
+    uint32_t perBurst, accum, tx, numRuns = 0, numValid = 0;
+    int ok = 1;
+    char msg[160];
+
+    for (perBurst = 1; perBurst <= 64U; perBurst++) {
+        for (accum = 0; accum <= 16U; accum++) {
+            for (tx = 1; tx <= 3U; tx++) {
+                ChirpAccum_Config cfg = { perBurst, 4U, accum, tx, 3U * tx, SIM_NUM_RANGE_BINS };
+                ChirpAccum_Dims dims;
+                uint32_t numDoppler = 0;
+                int32_t ret = ChirpAccum_compute(&cfg, &dims);
+                int32_t ref = Sim_countChirps(&cfg, &numDoppler);
+
+                ok = ok && (ret == ref) &&
+                     ((ret != 0) || ((dims.numDopplerChirpsPerFrame == numDoppler) &&
+                                     (dims.cubeBytes == SIM_NUM_RANGE_BINS * 3U * tx * numDoppler * 4U) &&
+                                     ((1UL << dims.extraShift) >= dims.accumFactor) &&
+                                     ((dims.extraShift == 0U) || ((1UL << (dims.extraShift - 1U)) < dims.accumFactor))));
+                numRuns++;
+                numValid += (ret == 0) ? 1U : 0U;
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "%u frames (%u valid) match a chirp-by-chirp count, shift is ceil(log2(N))",
+             numRuns, numValid);
+    Sim_check(ok, msg);
+}
+
+/**
+ * @brief Range DFT of one accumulated chirp, returns tone bin power and mean power of the other bins.
+ */
+static void Sim_rangeDft(const double *x, double *tonePower, double *noisePower, double *peak) {
+    uint32_t k, n;
+
+    *noisePower = 0.0;
+    *peak = 0.0;
+    for (k = 1; k < SIM_NUM_ADC_SAMPLES / 2U; k++) {
+        double re = 0.0, im = 0.0, p;
+        for (n = 0; n < SIM_NUM_ADC_SAMPLES; n++) {
+            re += x[n] * cos(2.0 * M_PI * k * n / SIM_NUM_ADC_SAMPLES);
+            im -= x[n] * sin(2.0 * M_PI * k * n / SIM_NUM_ADC_SAMPLES);
+        }
+        p = re * re + im * im;
+        *peak = fmax(*peak, sqrt(p));
+        if (k == SIM_TONE_BIN) {
+            *tonePower = p;
+        } else {
+            *noisePower += p / (SIM_NUM_ADC_SAMPLES / 2U - 2U);
+        }
+    }
+}
+
+static void Sim_testScaling(void) {
+    static const uint32_t factors[] = { 1U, 2U, 3U, 4U, 8U };
+    double snrDb[5], peak[5];
+    uint32_t f, trial, c, n;
+    int gainOk = 1, peakOk = 1;
+    char msg[240];
+    int len = 0;
+
+    srand(3);
+    for (f = 0; f < 5U; f++) {
+        ChirpAccum_Config cfg = { 8U * factors[f] * SIM_NUM_TX, 1U, factors[f], SIM_NUM_TX, SIM_NUM_ANTENNAS,
+                                  SIM_NUM_RANGE_BINS };
+        ChirpAccum_Dims dims;
+        double tone = 0.0, noise = 0.0, maxPeak = 0.0;
+
+        (void)ChirpAccum_compute(&cfg, &dims);
+        for (trial = 0; trial < SIM_NUM_TRIALS; trial++) {
+            double x[SIM_NUM_ADC_SAMPLES] = { 0.0 };
+            double t = 0.0, nz, p;
+
+            /* the front end sums N chirps: the tone adds coherently, the noise does not */
+            for (c = 0; c < dims.accumFactor; c++) {
+                for (n = 0; n < SIM_NUM_ADC_SAMPLES; n++) {
+                    x[n] += SIM_TONE_AMP * cos(2.0 * M_PI * SIM_TONE_BIN * n / SIM_NUM_ADC_SAMPLES) + Sim_noise();
+                }
+            }
+            Sim_rangeDft(x, &t, &nz, &p);
+            tone += t;
+            noise += nz;
+            /* the range FFT output is shifted by extraShift more */
+            maxPeak = fmax(maxPeak, p / (double)(1U << dims.extraShift));
+        }
+        snrDb[f] = 10.0 * log10(tone / noise);
+        peak[f] = maxPeak;
+        gainOk = gainOk && (fabs((snrDb[f] - snrDb[0]) - dims.snrGainDb) < 0.5);
+        peakOk = peakOk && (peak[f] <= peak[0] * 1.05);
+        len += snprintf(msg + len, sizeof(msg) - (size_t)len, "%sx%u %+.2f dB (%.2f)", (f == 0U) ? "" : ", ",
+                        factors[f], snrDb[f] - snrDb[0], dims.snrGainDb);
+    }
+    Sim_check(gainOk, "measured SNR gain matches snrGainDb within 0.5 dB:");
+    printf("      %s\n", msg);
+    Sim_check(peakOk, "with the extra shift the range FFT peak stays at or below the peak without accumulation");
+}
+
+int main(void) {
+    Sim_testDefaultFrame();
+    Sim_testGrid();
+    Sim_testScaling();
+
+    return Sim_result();
+}
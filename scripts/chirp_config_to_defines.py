@@ -1,7 +1,11 @@
 import argparse
 import json
+import zlib
+import math
+import struct
 import time
 import os
+import re
 import sys
 
 # structure defining the expected configuration parameter order for each command
@@ -20,9 +24,392 @@ CONFIG_STRUCTURE = {
 # name of the output file
 DEFINES_HEADER_NAME= "defines.h"
 
-def print_basic_config_info(data):
+# name of the precomputed window table, written next to the defines header
+WINDOW_TABLE_HEADER_NAME = "window_table.h"
+
+# name of the build-time budget checks, written next to the defines header
+BUDGET_HEADER_NAME = "budget.h"
+
+# limits of the firmware the feasibility model reads (memory pools, SPI), next to the defines header
+BUDGET_LIMITS_HEADER_NAME = "budget_limits.h"
+BUDGET_LIMITS_REQUIRED    = ['L3_MEM_SIZE', 'MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE', 'MAX_SPI_TRANSFER_SIZE',
+                             'BYTES_PER_FRAME', 'SPI_SCLK_HZ']
+
+# search range of the integer parameters changed for the nearest feasible profile
+FEASIBLE_SEARCH_RANGES = {
+    ('frameCfg', 'numOfChirpsInBurst'):    (1, 256),
+    ('frameCfg', 'numOfBurstsInFrame'):    (1, 1024),
+    ('chirpComnCfg', 'numOfAdcSamples'):   (2, 1024),
+}
+
+# window parameters of the range DPU (MATHUTILS_WIN_BLACKMAN, DPC_OBJDET_QFORMAT_RANGE_FFT in rangeproc_dpc.h)
+RANGE_WINDOW_TYPE    = 'blackman'
+RANGE_WINDOW_QFORMAT = 17
+
+# runtime reconfiguration command record (see config_cmd.h)
+CONFIG_CMD_MAGIC        = 0x52434647    # "RCFG"
+CONFIG_CMD_STATUS_MAGIC = 0x52535453    # "RSTS"
+CONFIG_CMD_VERSION      = 1
+CONFIG_CMD_TYPE_PROFILE = 1
+
+# commands and fractional parameters of the command record payload (order of ConfigCmd_Profile)
+CONFIG_CMD_COMMANDS     = ['channelCfg', 'chirpComnCfg', 'chirpTimingCfg', 'frameCfg']
+CONFIG_CMD_FLOAT_PARAMS = {'chirpRampEndTime', 'chirpIdleTime', 'chirpTxStartTime', 'chirpRfFreqSlope',
+                           'chirpRfFreqStart', 'burstPeriodicity', 'framePeriodicity'}
+
+# profile blob in flash (see profile_blob.h)
+PROFILE_BLOB_MAGIC        = 0x52505246  # "RPRF"
+PROFILE_BLOB_VERSION      = 1
+PROFILE_BLOB_HEADER_BYTES = 16
+
+# results and states reported in the status record
+CONFIG_CMD_RESULTS = {0: 'ok', -1: 'no record', -2: 'version', -3: 'length', -4: 'crc', -5: 'channel changed',
+                      -6: 'invalid parameter', -7: 'L3 budget exceeded', -8: 'busy',
+                      -9: 'apply failed, previous profile restored', -10: 'failed, sensor stopped'}
+CONFIG_CMD_STATES  = ['running', 'pending', 'stopping', 'reconfiguring', 'rollback', 'restarting', 'failed']
+
+def derive_cube(data):
+    """
+    Derive the radar cube dimensions (with front-end chirp accumulation, see chirp_accum.h)
+    Raises ValueError if the chirps per burst can not be accumulated
+    """
+    n_adc            = int(data['chirpComnCfg']['numOfAdcSamples'])
+    n_bins           = (1 << (n_adc - 1).bit_length()) // 2    # as mathUtils_pow2roundup(n_adc) / 2
+    n_tx             = bin(int(data['channelCfg']['txChCtrlBitMask'])).count('1')
+    n_rx             = bin(int(data['channelCfg']['rxChCtrlBitMask'])).count('1')
+    accum            = max(int(data['frameCfg']['numOfChirpsAccum']), 1)
+    chirps_per_burst = int(data['frameCfg']['numOfChirpsInBurst'])
+    if n_tx == 0 or chirps_per_burst % accum != 0 or (chirps_per_burst // accum) % n_tx != 0:
+        raise ValueError(f"{chirps_per_burst} chirps per burst can not be accumulated by "
+                         f"{accum} for {n_tx} TX antennas")
+    n_doppler = (chirps_per_burst // accum) * int(data['frameCfg']['numOfBurstsInFrame']) // n_tx
+    return {
+        'n_adc':      n_adc,
+        'n_bins':     n_bins,
+        'n_tx':       n_tx,
+        'n_rx':       n_rx,
+        'n_virt':     n_tx * n_rx,
+        'accum':      accum,
+        'n_doppler':  n_doppler,
+        'cube_bytes': n_bins * n_tx * n_rx * n_doppler * 4,
+    }
+
+
+# tokens of the limit expressions: decimal, octal or hex constant with optional unsigned suffix, name, operator
+LIMIT_TOKEN = re.compile(r'\s*(?:(0[xX][0-9A-Fa-f]+|\d+)[uU]?(?!\w)|([A-Za-z_]\w*)|([-+*/()]))')
+
+
+def eval_limit_expr(expr, names):
+    """
+    Evaluate a C integer constant expression of budget_limits.h without eval(): integer
+    constants (decimal, octal, hex, U suffix), names defined before (names), unary and
+    binary + - * / with C precedence and truncating division, parentheses
+    Raises ValueError for anything else
+    """
+    tokens = []
+    pos = 0
+    expr = expr.strip()
+    while pos < len(expr):
+        m = LIMIT_TOKEN.match(expr, pos)
+        if not m:
+            raise ValueError(f"unsupported expression '{expr}'")
+        tokens.append(m.groups())
+        pos = m.end()
+
+    def peek(i):
+        return tokens[i][2] if i < len(tokens) else None
+
+    def primary(i):
+        if i >= len(tokens):
+            raise ValueError(f"incomplete expression '{expr}'")
+        number, name, op = tokens[i]
+        if number:
+            base = 16 if number[:2] in ('0x', '0X') else 8 if len(number) > 1 and number[0] == '0' else 10
+            return int(number, base), i + 1
+        if name:
+            if name not in names:
+                raise ValueError(f"'{name}' in '{expr}' is not an integer limit defined before")
+            return names[name], i + 1
+        if op in ('+', '-'):
+            value, i = primary(i + 1)
+            return (-value if op == '-' else value), i
+        if op == '(':
+            value, i = additive(i + 1)
+            if peek(i) != ')':
+                raise ValueError(f"unbalanced parentheses in '{expr}'")
+            return value, i + 1
+        raise ValueError(f"unexpected '{op}' in '{expr}'")
+
+    def multiplicative(i):
+        value, i = primary(i)
+        while peek(i) in ('*', '/'):
+            op = peek(i)
+            rhs, i = primary(i + 1)
+            if op == '*':
+                value *= rhs
+            elif rhs == 0:
+                raise ValueError(f"division by zero in '{expr}'")
+            else:
+                quotient = abs(value) // abs(rhs)
+                value = quotient if (value < 0) == (rhs < 0) else -quotient
+        return value, i
+
+    def additive(i):
+        value, i = multiplicative(i)
+        while peek(i) in ('+', '-'):
+            op = peek(i)
+            rhs, i = multiplicative(i + 1)
+            value = value + rhs if op == '+' else value - rhs
+        return value, i
+
+    value, i = additive(0)
+    if i != len(tokens):
+        raise ValueError(f"unexpected '{''.join(t for t in tokens[i] if t)}' in '{expr}'")
+    return value
+
+
+def read_budget_limits(file_path):
+    """
+    Read the integer limits of budget_limits.h, so that the feasibility model uses the
+    same values as the firmware and the generated budget.h. Macros which are not plain
+    integer expressions (see eval_limit_expr) are skipped
+    Raises ValueError if a required limit is missing or not a plain integer expression
+    """
+    limits = {}
+    unsupported = {}
+    with open(file_path, 'r') as f:
+        for line in f:
+            line = re.sub(r'/\*.*?\*/|//.*', '', line)
+            m = re.match(r'\s*#define\s+(\w+)\s+(\S.*?)\s*$', line)
+            if not m:
+                continue
+            try:
+                limits[m.group(1)] = eval_limit_expr(m.group(2), limits)
+            except ValueError as e:
+                unsupported[m.group(1)] = str(e)
+    for name in BUDGET_LIMITS_REQUIRED:
+        if name in unsupported:
+            raise ValueError(f"'{file_path}': {name}: {unsupported[name]}")
+    missing = [name for name in BUDGET_LIMITS_REQUIRED if name not in limits]
+    if missing:
+        raise ValueError(f"'{file_path}' does not define {', '.join(missing)}")
+    return limits
+
+
+def evaluate_feasibility(data, limits, spi_sclk_hz=None, chunk_bytes=None, chunk_gap_us=0.0):
+    """
+    Timing, memory and throughput model of a configuration
+
+    The frame is chirped first (numOfBurstsInFrame x burstPeriodicity), the radar
+    cube is then streamed in SPI transactions of chunk_bytes (MAX_SPI_TRANSFER_SIZE)
+    at spi_sclk_hz, each followed by chunk_gap_us until the host has read it (FTDI
+    turnaround). Both have to fit the frame period, the cube the L3 pool. The range
+    FFT runs on the HWA while chirping and is not accounted. With the default
+    arguments the checks are the ones of the generated budget.h, extended by the
+    chirp timing within a burst.
+
+    Returns a dict with the derived values and 'violations', the reasons why the
+    configuration is infeasible (empty if it is feasible)
+    """
+    sclk_hz  = spi_sclk_hz or limits['SPI_SCLK_HZ']
+    chunk    = chunk_bytes or limits['MAX_SPI_TRANSFER_SIZE']
+    if sclk_hz <= 0 or chunk <= 0:
+        raise ValueError(f"SPI clock {sclk_hz} Hz and chunk size {chunk} bytes must be positive")
+    frame    = data['frameCfg']
+    chirp_us = float(data['chirpTimingCfg']['chirpIdleTime']) + float(data['chirpComnCfg']['chirpRampEndTime'])
+    n_chirps = int(frame['numOfChirpsInBurst'])
+    n_bursts = int(frame['numOfBurstsInFrame'])
+    burst_us = float(frame['burstPeriodicity'])
+    model = {
+        'chirp_us':        chirp_us,
+        'burst_us':        burst_us,
+        'burst_active_us': n_chirps * chirp_us,
+        'frame_us':        int(round(float(frame['framePeriodicity']) * 1000)),
+        'active_us':       int(round(burst_us * n_bursts)),
+        'spi_sclk_hz':     sclk_hz,
+        'chunk_bytes':     chunk,
+        'violations':      [],
+    }
+    violations = model['violations']
+
+    for cmd, param in (('frameCfg', 'numOfChirpsInBurst'), ('frameCfg', 'numOfBurstsInFrame'),
+                       ('chirpComnCfg', 'numOfAdcSamples')):
+        if int(data[cmd][param]) <= 0:
+            violations.append(f"{param} {data[cmd][param]} is not positive")
+    if model['frame_us'] <= 0:
+        violations.append(f"framePeriodicity {frame['framePeriodicity']} ms is below 1 us")
+    if violations:
+        return model
+
+    if model['burst_active_us'] > burst_us:
+        violations.append(f"{n_chirps} chirps x {chirp_us:g} us (chirpIdleTime + chirpRampEndTime) = "
+                          f"{model['burst_active_us']:g} us exceed burstPeriodicity {burst_us:g} us")
+    if model['active_us'] > model['frame_us']:
+        violations.append(f"{n_bursts} bursts x {burst_us:g} us = {model['active_us']} us exceed "
+                          f"framePeriodicity {model['frame_us']} us")
+    try:
+        cube = derive_cube(data)
+    except ValueError as e:
+        violations.append(str(e))
+        return model
+
+    cube_bytes   = cube['cube_bytes']
+    window_bytes = 4 * ((cube['n_adc'] + 1) // 2)
+    num_chunks   = -(-cube_bytes // chunk)
+    spi_us       = -(-cube_bytes * 8 * 1000000 // sclk_hz) + int(math.ceil(num_chunks * chunk_gap_us))
+    min_frame_us = model['active_us'] + spi_us
+    model.update({
+        'cube':            cube,
+        'cube_bytes':      cube_bytes,
+        'window_bytes':    window_bytes,
+        'num_chunks':      num_chunks,
+        'spi_us':          spi_us,
+        'min_frame_us':    min_frame_us,
+        'max_frame_rate':  1e6 / min_frame_us if min_frame_us > 0 else float('inf'),
+        'active_duty':     model['active_us'] / model['frame_us'],
+        'rf_duty':         n_bursts * model['burst_active_us'] / model['frame_us'],
+        'l3_headroom':     limits['L3_MEM_SIZE'] - cube_bytes,
+    })
+
+    if cube_bytes > limits['L3_MEM_SIZE']:
+        violations.append(f"radar cube of {cube_bytes} bytes exceeds L3_MEM_SIZE {limits['L3_MEM_SIZE']} bytes "
+                          f"by {cube_bytes - limits['L3_MEM_SIZE']} bytes")
+    if window_bytes > limits['MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE']:
+        violations.append(f"range window of {window_bytes} bytes exceeds MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE "
+                          f"{limits['MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE']} bytes")
+    if cube_bytes % limits['BYTES_PER_FRAME'] != 0:
+        violations.append(f"radar cube of {cube_bytes} bytes is not a multiple of the SPI frame size "
+                          f"BYTES_PER_FRAME {limits['BYTES_PER_FRAME']}")
+    if model['active_us'] <= model['frame_us'] < min_frame_us:
+        violations.append(f"chirping {model['active_us']} us + SPI transfer {spi_us} us of {cube_bytes} bytes "
+                          f"at {sclk_hz / 1e6:g} MHz = {min_frame_us} us exceed framePeriodicity "
+                          f"{model['frame_us']} us by {min_frame_us - model['frame_us']} us")
+    return model
+
+
+def _with_param(data, cmd, param, value):
+    """
+    Copy of a configuration with one parameter changed
+    """
+    changed = {c: dict(p) for c, p in data.items()}
+    changed[cmd][param] = str(int(value)) if float(value).is_integer() else str(value)
+    return changed
+
+
+def _fit_periods(data, limits, **kwargs):
     """
-    Print basic info calculated from parameters
+    Copy of a configuration with the burst and frame period raised to the minimum its
+    chirps, bursts and SPI transfer need, None if the cube can not be derived
+    """
+    model = evaluate_feasibility(data, limits, **kwargs)
+    if 'spi_us' not in model:
+        return None
+    burst   = max(float(data['frameCfg']['burstPeriodicity']), math.ceil(model['burst_active_us']))
+    changed = _with_param(data, 'frameCfg', 'burstPeriodicity', burst)
+    model   = evaluate_feasibility(changed, limits, **kwargs)
+    frame   = max(float(data['frameCfg']['framePeriodicity']), math.ceil(model['min_frame_us'] / 1000))
+    return _with_param(changed, 'frameCfg', 'framePeriodicity', frame)
+
+
+def _relative_change(old, new):
+    """
+    Relative change of a parameter (from 0 counted as from 1)
+    """
+    return abs(new - old) / max(abs(old), 1)
+
+
+def suggest_feasible(data, limits, **kwargs):
+    """
+    Search the nearest feasible profiles, in stages until one is found:
+      1. one parameter changed (chirps per burst, bursts per frame, ADC samples or a period)
+      2. one of the integer parameters changed with the minimum burst and frame period
+      3. as 2., after the nearest value of another integer parameter the cube can be
+         derived with (chirps per burst matching the accumulation and TX antennas)
+    The ramp is kept, the ADC window within it is not checked.
+    Returns a list of profiles, each a list of (command, parameter, old value, new value),
+    smallest sum of the relative changes first
+    """
+    def feasible(changed):
+        return (changed is not None) and not evaluate_feasibility(changed, limits, **kwargs)['violations']
+
+    def derivable(changed):
+        return 'spi_us' in evaluate_feasibility(changed, limits, **kwargs)
+
+    def fitted(changed):
+        return _fit_periods(changed, limits, **kwargs)
+
+    def changes(changed):
+        params = list(FEASIBLE_SEARCH_RANGES) + [('frameCfg', 'burstPeriodicity'), ('frameCfg', 'framePeriodicity')]
+        return [(cmd, param, float(data[cmd][param]), float(changed[cmd][param]))
+                for cmd, param in params if float(changed[cmd][param]) != float(data[cmd][param])]
+
+    def scan(base, fit, accept, skip=()):
+        """nearest value of every integer parameter for which accept() holds, as changed configurations"""
+        found = []
+        for (cmd, param), (lo, hi) in FEASIBLE_SEARCH_RANGES.items():
+            if (cmd, param) in skip:
+                continue
+            old = int(base[cmd][param])
+            for delta in range(1, max(old - lo, hi - old) + 1):
+                changed = next((c for c in (fit(_with_param(base, cmd, param, v)) for v in (old - delta, old + delta)
+                                            if lo <= v <= hi) if accept(c)), None)
+                if changed is not None:
+                    found.append(((cmd, param), changed))
+                    break
+        return found
+
+    suggestions = [changed for _, changed in scan(data, lambda changed: changed, feasible)]
+
+    # longer periods, or a burst period short enough for the bursts and the transfer to fit the frame
+    if feasible(fitted(data)):
+        suggestions.append(fitted(data))
+    model = evaluate_feasibility(data, limits, **kwargs)
+    if 'spi_us' in model:
+        lo = math.ceil(model['burst_active_us'])
+        hi = (model['frame_us'] - model['spi_us']) // int(data['frameCfg']['numOfBurstsInFrame'])
+        changed = _with_param(data, 'frameCfg', 'burstPeriodicity', hi)
+        if lo <= hi < float(data['frameCfg']['burstPeriodicity']) and feasible(changed):
+            suggestions.append(changed)
+
+    if not suggestions:
+        suggestions = [changed for _, changed in scan(data, fitted, feasible)]
+    if not suggestions:
+        for first, base in scan(data, lambda changed: changed, derivable):
+            suggestions += [changed for _, changed in scan(base, fitted, feasible, skip=(first,))]
+
+    profiles = []
+    for profile in (changes(changed) for changed in suggestions):
+        if profile not in profiles:
+            profiles.append(profile)
+    return sorted(profiles, key=lambda profile: sum(_relative_change(old, new) for _, _, old, new in profile))
+
+
+def check_feasibility(data, limits, **kwargs):
+    """
+    Print why a configuration is infeasible and the nearest feasible profiles
+    Returns True if the configuration is feasible
+    """
+    model = evaluate_feasibility(data, limits, **kwargs)
+    if not model['violations']:
+        return True
+
+    print("error: infeasible configuration:")
+    for reason in model['violations']:
+        print(f"  - {reason}")
+    suggestions = suggest_feasible(data, limits, **kwargs)
+    if suggestions:
+        print("nearest feasible profiles (nearest first):")
+        for profile in suggestions:
+            print("  - " + ", ".join(f"{cmd} {param} {old:g} -> {new:g} ({'+' if new > old else '-'}"
+                                     f"{_relative_change(old, new) * 100:.0f} %)" for cmd, param, old, new in profile))
+    else:
+        print("no feasible profile found")
+    return False
+
+
+def print_basic_config_info(data, model=None):
+    """
+    Print basic info calculated from parameters and, if given, the feasibility model
     """
 
     c = 3e8  # speed of light in m/s
@@ -39,11 +426,31 @@ def print_basic_config_info(data):
     # calculate range resolution in meters
     range_res        = c / (2 * bandwidth_hz)
 
+    # radar cube dimensions with front-end chirp accumulation (see chirp_accum.h)
+    accum            = max(int(data['frameCfg']['numOfChirpsAccum']), 1)
+    n_bins           = int(data['chirpComnCfg']['numOfAdcSamples']) // 2
+    try:
+        cube      = derive_cube(data)
+        n_bins    = cube['n_bins']
+        cube_info = f"{n_bins} x {cube['n_virt']} x {cube['n_doppler']} = {cube['cube_bytes']} bytes"
+    except ValueError as e:
+        cube_info = f"invalid: {e}"
+
     msg = f"""
 Some basic information on the configuration:
-  - n range bins (N_bins): {int(data['chirpComnCfg']['numOfAdcSamples']) // 2}
+  - n range bins (N_bins): {n_bins}
   - bandwidth (B):         {bandwidth_hz * 1e-9} GHz
   - range resolution (ΔR): {(range_res * 100):.2f} cm
+  - chirp accumulation:    x{accum}
+  - radar cube:            {cube_info}
+"""
+    if model and 'spi_us' in model:
+        msg += f"""\
+  - chirp / burst / frame: {model['chirp_us']:g} us / {model['burst_us']:g} us ({model['burst_active_us']:g} us chirping) / {model['frame_us']} us ({model['active_us']} us bursts)
+  - duty cycle:            {model['active_duty'] * 100:.1f} % bursts, {model['rf_duty'] * 100:.1f} % chirping
+  - SPI transfer:          {model['spi_us']} us at {model['spi_sclk_hz'] / 1e6:g} MHz, {model['num_chunks']} chunk(s) of max. {model['chunk_bytes']} bytes
+  - L3 headroom:           {model['l3_headroom']} bytes
+  - max. frame rate:       {model['max_frame_rate']:.2f} Hz (frame period >= {model['min_frame_us']} us), configured {1e6 / model['frame_us']:.2f} Hz
 """
     print(msg)
 
@@ -117,6 +524,195 @@ def parse_config_file(file_path):
     raise ValueError("unsupported file format. provide .cfg or .json file.")
 
 
+def f32(x):
+    """
+    Round a Python float (double) to the nearest single precision value
+    """
+    return struct.unpack('f', struct.pack('f', x))[0]
+
+
+def gen_window(win_len, win_gen_len, win_type, q_format):
+    """
+    Generate a window like mathUtils_genWindow() of the MMWAVE-L-SDK
+
+    The SDK evaluates the cosine terms with a single precision rotation
+    recurrence, so every operation is rounded to single precision here to get
+    bit-identical coefficients (exact as long as the target does not fuse
+    multiply-adds in the generator). Products and sums of two single precision
+    values are computed exactly enough in double precision for the single
+    rounding by f32() to be correct.
+    """
+    one_q = f32(float(1 << q_format))
+    phi   = f32((2 * math.pi) / f32(float(win_len) - 1))
+    e1_r  = f32(math.cos(phi))
+    e1_i  = f32(math.sin(phi))
+    e2_r  = f32(math.cos(f32(2 * phi)))
+    e2_i  = f32(math.sin(f32(2 * phi)))
+
+    if win_type == 'blackman':
+        a0, a1, a2 = f32(0.42), f32(0.5), f32(0.08)
+    elif win_type == 'hanning':
+        a0, a1, a2 = f32(0.5), f32(0.5), f32(0.0)
+    else:
+        raise ValueError(f"unsupported window type '{win_type}'")
+
+    ephy_r, ephy_i   = f32(1.0), f32(0.0)
+    ephy2_r, ephy2_i = f32(1.0), f32(0.0)
+    win = []
+    for _ in range(win_gen_len):
+        val = f32(f32(a0 - f32(a1 * ephy_r)) + f32(a2 * ephy2_r))
+        val = int(f32(one_q * val) + 0.5)
+        if val >= int(one_q):
+            val = int(one_q) - 1
+        win.append(val & 0xFFFFFFFF)
+
+        tmp_r  = ephy_r
+        ephy_r = f32(f32(ephy_r * e1_r) - f32(ephy_i * e1_i))
+        ephy_i = f32(f32(tmp_r * e1_i) + f32(ephy_i * e1_r))
+
+        tmp_r   = ephy2_r
+        ephy2_r = f32(f32(ephy2_r * e2_r) - f32(ephy2_i * e2_i))
+        ephy2_i = f32(f32(tmp_r * e2_i) + f32(ephy2_i * e2_r))
+    return win
+
+
+def generate_window_table_file(data, script_name, base_input, output_path):
+    """
+    Generate a C header file 'window_table.h' with the precomputed range window
+    """
+    timestamp = time.strftime("%Y-%m-%d %H:%M:%S")
+
+    guard_macro = os.path.splitext(WINDOW_TABLE_HEADER_NAME)[0].upper() + "_H"
+
+    # symmetric window, only the first half is generated (as in RangeProc_getWindow())
+    n_adc   = int(data['chirpComnCfg']['numOfAdcSamples'])
+    win_len = (n_adc + 1) // 2
+    win     = gen_window(n_adc, win_len, RANGE_WINDOW_TYPE, RANGE_WINDOW_QFORMAT)
+
+    rows = []
+    for i in range(0, win_len, 8):
+        rows.append("    " + ", ".join(f"0x{v:08X}U" for v in win[i:i + 8]))
+    table = ",\n".join(rows)
+
+    content = f"""
+#ifndef {guard_macro}
+#define {guard_macro}
+
+/**
+ * @file {WINDOW_TABLE_HEADER_NAME}
+ *
+ * @brief Precomputed range FFT window.
+ *
+ * First half of the symmetric {RANGE_WINDOW_TYPE.capitalize()} window for {n_adc} ADC samples in
+ * Q{RANGE_WINDOW_QFORMAT}, bit-identical to mathUtils_genWindow(). RangeProc_config()
+ * hands this table to the range DPU instead of generating the window at startup
+ * when CLI_NUM_ADC_SAMPLES matches (see RANGEPROC_WINDOW_TABLE_ENABLE). Only to
+ * be included by rangeproc_dpc.c.
+ *
+ * This file was auto-generated by the script '{script_name}' from the config file '{base_input}' on {timestamp}
+ */
+
+#include <stdint.h>
+
+/*! @brief Number of ADC samples the table was generated for */
+#define WINDOW_TABLE_NUM_ADC_SAMPLES {n_adc}
+
+/*! @brief Q format of the coefficients */
+#define WINDOW_TABLE_QFORMAT         {RANGE_WINDOW_QFORMAT}
+
+/*! @brief Number of coefficients */
+#define WINDOW_TABLE_LEN             {win_len}
+
+static const uint32_t gWindowTable[WINDOW_TABLE_LEN] = {{
+{table}
+}};
+
+#endif /* {guard_macro} */
+"""
+    # write file to output path
+    with open(output_path, 'w') as f:
+        f.write(content)
+
+
+def generate_budget_file(data, script_name, base_input, output_path):
+    """
+    Generate a C header file 'budget.h' with the derived sizes and timings of the
+    configuration and static assertions against the limits in budget_limits.h
+    """
+    timestamp = time.strftime("%Y-%m-%d %H:%M:%S")
+
+    guard_macro = os.path.splitext(BUDGET_HEADER_NAME)[0].upper() + "_H"
+
+    try:
+        cube = derive_cube(data)
+    except ValueError as e:
+        body = f'#error "infeasible configuration: {e}"'
+    else:
+        frame_us  = int(round(float(data['frameCfg']['framePeriodicity']) * 1000))
+        active_us = int(round(float(data['frameCfg']['burstPeriodicity']) *
+                              int(data['frameCfg']['numOfBurstsInFrame'])))
+        body = f"""/*! @brief Radar cube dimensions (see chirp_accum.h) */
+#define BUDGET_NUM_RANGE_BINS            {cube['n_bins']}U
+#define BUDGET_NUM_VIRTUAL_ANTENNAS      {cube['n_virt']}U
+#define BUDGET_NUM_DOPPLER_CHIRPS        {cube['n_doppler']}U
+
+/*! @brief Size of the radar cube in bytes */
+#define BUDGET_CUBE_BYTES                {cube['cube_bytes']}U
+
+/*! @brief Size of the symmetric range window in bytes */
+#define BUDGET_WINDOW_BYTES              {4 * ((cube['n_adc'] + 1) // 2)}U
+
+/*! @brief Frame period and time spent chirping (bursts x burst period) in us */
+#define BUDGET_FRAME_PERIOD_US           {frame_us}U
+#define BUDGET_ACTIVE_FRAME_US           {active_us}U
+
+/*! @brief Derived pool budgets */
+#define BUDGET_MAX_CUBE_SLOTS            (L3_MEM_SIZE / BUDGET_CUBE_BYTES)
+#define BUDGET_L3_HEADROOM_BYTES         (L3_MEM_SIZE - BUDGET_CUBE_BYTES)
+#define BUDGET_CORE_LOCAL_HEADROOM_BYTES (MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE - BUDGET_WINDOW_BYTES)
+
+/*! @brief Time to transfer the cube at SPI_SCLK_HZ in us (rounded up, without gaps between the chunks) */
+#define BUDGET_SPI_TIME_US               ((uint32_t)((((uint64_t)BUDGET_CUBE_BYTES * 8U * 1000000U) + SPI_SCLK_HZ - 1U) / SPI_SCLK_HZ))
+
+_Static_assert(BUDGET_CUBE_BYTES <= L3_MEM_SIZE,
+               "radar cube exceeds L3_MEM_SIZE");
+_Static_assert(BUDGET_WINDOW_BYTES <= MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE,
+               "range window exceeds MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE");
+_Static_assert((BUDGET_CUBE_BYTES % BYTES_PER_FRAME) == 0U,
+               "radar cube is not a multiple of the SPI frame size BYTES_PER_FRAME");
+_Static_assert((BUDGET_ACTIVE_FRAME_US + BUDGET_SPI_TIME_US) <= BUDGET_FRAME_PERIOD_US,
+               "chirping and the SPI transfer of the radar cube exceed the frame period");"""
+
+    content = f"""
+#ifndef {guard_macro}
+#define {guard_macro}
+
+/**
+ * @file {BUDGET_HEADER_NAME}
+ *
+ * @brief Build-time memory and throughput budget of the configuration in defines.h.
+ *
+ * Integer sizes and timings derived from the configuration, checked against
+ * the limits of budget_limits.h, so that a profile which does not fit the
+ * memory or can not be streamed within the frame period fails the build. Only
+ * the radar cube is accounted for the SPI time (default stream).
+ *
+ * This file was auto-generated by the script '{script_name}' from the config file '{base_input}' on {timestamp}
+ */
+
+#include <stdint.h>
+
+#include "budget_limits.h"
+
+{body}
+
+#endif /* {guard_macro} */
+"""
+    # write file to output path
+    with open(output_path, 'w') as f:
+        f.write(content)
+
+
 def generate_defines_file(data, script_name, base_input, output_path):
     """
     Generate a C header file 'defines.h' from parsed data
@@ -200,6 +796,75 @@ def generate_defines_file(data, script_name, base_input, output_path):
         f.write(content)
 
 
+def pack_profile_words(data):
+    """
+    Pack the profile commands of a config into the 32-bit words of ConfigCmd_Profile
+    (integers as uint32, fractional values as IEEE float bits)
+    """
+    words = []
+    for cmd in CONFIG_CMD_COMMANDS:
+        if cmd not in data:
+            raise ValueError(f"command '{cmd}' missing, it is required for a profile record")
+        for param in CONFIG_STRUCTURE[cmd]:
+            if param in CONFIG_CMD_FLOAT_PARAMS:
+                words.append(struct.unpack('<I', struct.pack('<f', float(data[cmd][param])))[0])
+            else:
+                words.append(int(data[cmd][param]) & 0xFFFFFFFF)
+    return words
+
+
+def encode_config_cmd(data, sequence):
+    """
+    Encode the profile commands of a config as command record (see config_cmd.h)
+    Returns the record as bytes in SPI order: 32-bit words, most significant byte first
+    """
+    payload = pack_profile_words(data)
+
+    # the device computes the CRC over the words in its memory order (little endian)
+    crc = zlib.crc32(struct.pack(f'<{len(payload)}I', *payload))
+    header = [CONFIG_CMD_MAGIC,
+              (CONFIG_CMD_VERSION << 16) | CONFIG_CMD_TYPE_PROFILE,
+              ((4 * len(payload)) << 16) | (sequence & 0xFFFF),
+              crc]
+    words = header + payload
+    return struct.pack(f'>{len(words)}I', *words)
+
+
+def encode_profile_blob(data):
+    """
+    Encode the profile commands of a config as flash blob (ProfileBlob, see profile_blob.h)
+    Returns the blob as bytes in the memory order of the device (little endian)
+    """
+    words   = pack_profile_words(data)
+    payload = struct.pack(f'<{len(words)}I', *words)
+    header = struct.pack('<IHHII', PROFILE_BLOB_MAGIC, PROFILE_BLOB_VERSION, PROFILE_BLOB_HEADER_BYTES,
+                         len(payload), zlib.crc32(payload))
+    return header + payload
+
+
+def decode_config_cmd_status(raw):
+    """
+    Decode a status record as read via SPI (32-bit words, most significant byte first)
+    Returns a dict or None if the bytes hold no valid status record
+    """
+    if len(raw) < 32:
+        return None
+    words = struct.unpack('>8I', raw[:32])
+    if words[0] != CONFIG_CMD_STATUS_MAGIC or zlib.crc32(struct.pack('<7I', *words[:7])) != words[7]:
+        return None
+    state  = words[1] & 0xFFFF
+    result = struct.unpack('<h', struct.pack('<H', words[2] & 0xFFFF))[0]
+    return {
+        'version':     words[1] >> 16,
+        'state':       CONFIG_CMD_STATES[state] if state < len(CONFIG_CMD_STATES) else state,
+        'sequence':    words[2] >> 16,
+        'result':      CONFIG_CMD_RESULTS.get(result, result),
+        'profile_crc': words[3],
+        'applied':     words[4],
+        'rejected':    words[5],
+    }
+
+
 def print_usage(script_name):
     """
     Print usage instructions / information
@@ -207,12 +872,33 @@ def print_usage(script_name):
     msg = f"""\
 Description:
   This script takes config files from the MMWAVE-L-SDK or TI mmWave Sensing Estimator and generates a {DEFINES_HEADER_NAME}
-  file from it. Please note that it only processes the commands and parameters which are used within the minimal
+  file from it, together with the precomputed range window {WINDOW_TABLE_HEADER_NAME} and the build-time budget checks
+  {BUDGET_HEADER_NAME} in the same directory. Please note
+  that it only processes the commands and parameters which are used within the minimal
   RangeProc DPU implementation in this repo and ignores all the others. 
   TI mmWave Sensing Estimator: https://dev.ti.com/gallery/view/mmwave/mmWaveSensingEstimator/ver/2.4.1/
 
 Usage:
   {script_name} <path to config .cfg or .json> [-o <output header file or directory>]
+  {script_name} <path to config .cfg or .json> --encode-cmd <output .bin> [--seq <sequence number>]
+  {script_name} <path to config .cfg or .json> --encode-blob <output .bin>
+  {script_name} <path to config .cfg or .json> --check [--spi-sclk <Hz>] [--chunk-bytes <bytes>] [--chunk-gap-us <us>]
+
+  --encode-cmd writes the channelCfg, chirpComnCfg, chirpTimingCfg and frameCfg commands as runtime
+  reconfiguration record (SPI_CMD_CHANNEL_ENABLE, see config_cmd.h) instead of generating the headers.
+  The host sends it in the command slot of the next frame.
+
+  --encode-blob writes the same commands as profile blob (see profile_blob.h) instead of generating the
+  headers. Programmed to PROFILE_BLOB_FLASH_OFFSET, it is loaded at boot in place of {DEFINES_HEADER_NAME}.
+
+  Every configuration is checked against a timing, memory and throughput model with the limits of
+  {BUDGET_LIMITS_HEADER_NAME} first (the one in the output directory of -o if there is one, else the one of
+  the repo): chirps within the burst period, bursts and the SPI transfer of the radar cube within the frame
+  period, the cube within L3_MEM_SIZE. An infeasible configuration is rejected with the reasons and the nearest
+  feasible profiles, nothing is written. --check only prints the model (chirp, burst and frame timing, duty
+  cycle, SPI time, L3 headroom, max. frame rate). --spi-sclk (default SPI_SCLK_HZ), --chunk-bytes (bytes per SPI
+  transaction, default MAX_SPI_TRANSFER_SIZE) and --chunk-gap-us (host turnaround after each chunk, default 0)
+  model another SPI link or FTDI reader.
 
 """
     print(msg)
@@ -223,6 +909,15 @@ def main():
     parser = argparse.ArgumentParser(add_help=False)
     parser.add_argument('input_file', nargs='?', help="path to config file (.cfg or .json)")
     parser.add_argument('-o', '--output', help="path to output header file or directory", default=None)
+    parser.add_argument('--encode-cmd', help="path to output command record (.bin)", default=None)
+    parser.add_argument('--encode-blob', help="path to output profile blob (.bin)", default=None)
+    parser.add_argument('--seq', type=int, help="sequence number of the command record", default=1)
+    parser.add_argument('--check', action='store_true', help="only print the feasibility model")
+    parser.add_argument('--spi-sclk', type=int, help="SPI clock in Hz (default SPI_SCLK_HZ)", default=None)
+    parser.add_argument('--chunk-bytes', type=int, help="bytes per SPI transaction (default MAX_SPI_TRANSFER_SIZE)",
+                        default=None)
+    parser.add_argument('--chunk-gap-us', type=float, help="host turnaround after each SPI transaction in us",
+                        default=0.0)
     parser.add_argument('-h', '--help', action='store_true', help="show help message and exit")
     args = parser.parse_args()
 
@@ -249,6 +944,53 @@ def main():
     repo_root   = os.path.dirname(script_dir)
     default_dir = os.path.join(repo_root, 'minimal_rangeproc_impl', 'include')
 
+    # the limits next to the generated headers (budget.h includes those first), else the ones of the repo
+    limits_path = os.path.join(default_dir, BUDGET_LIMITS_HEADER_NAME)
+    if args.output:
+        output_dir  = args.output if os.path.isdir(args.output) else os.path.dirname(args.output)
+        output_path = os.path.join(output_dir, BUDGET_LIMITS_HEADER_NAME)
+        if os.path.isfile(output_path):
+            limits_path = output_path
+
+    # check the configuration against the model before anything is written
+    model_args = {'spi_sclk_hz': args.spi_sclk, 'chunk_bytes': args.chunk_bytes, 'chunk_gap_us': args.chunk_gap_us}
+    try:
+        limits = read_budget_limits(limits_path)
+        if args.check:
+            print_basic_config_info(data, evaluate_feasibility(data, limits, **model_args))
+        feasible = check_feasibility(data, limits, **model_args)
+    except Exception as e:
+        print(f"error: {e}")
+        sys.exit(1)
+    if args.check:
+        sys.exit(0 if feasible else 1)
+    if not feasible:
+        sys.exit(1)
+
+    # encode a command record for the runtime reconfiguration instead of the headers
+    if args.encode_cmd:
+        try:
+            record = encode_config_cmd(data, args.seq)
+        except Exception as e:
+            print(f"error: {e}")
+            sys.exit(1)
+        with open(args.encode_cmd, 'wb') as f:
+            f.write(record)
+        print(f"generated command record: {args.encode_cmd} ({len(record)} bytes, sequence {args.seq & 0xFFFF})")
+        return
+
+    # encode a profile blob for the flash instead of the headers
+    if args.encode_blob:
+        try:
+            blob = encode_profile_blob(data)
+        except Exception as e:
+            print(f"error: {e}")
+            sys.exit(1)
+        with open(args.encode_blob, 'wb') as f:
+            f.write(blob)
+        print(f"generated profile blob: {args.encode_blob} ({len(blob)} bytes, version {PROFILE_BLOB_VERSION})")
+        return
+
     # if output file arg is provided, ensure that it is an actual file and not a dir
     #   otherwise use the defined default dir
     if args.output:
@@ -276,8 +1018,19 @@ def main():
     generate_defines_file(data, script_name, os.path.basename(args.input_file), final)
     print(f"generated header: {final}")
 
+    # generate the window table and the budget checks next to it
+    for header_name, generate in ((WINDOW_TABLE_HEADER_NAME, generate_window_table_file),
+                                  (BUDGET_HEADER_NAME, generate_budget_file)):
+        header_final = os.path.join(os.path.dirname(final), header_name)
+        if os.path.exists(header_final):
+            resp = input(f"file '{header_final}' exists. overwrite? [y/N]: ")
+            if resp.lower() != 'y':
+                sys.exit(1)
+        generate(data, script_name, os.path.basename(args.input_file), header_final)
+        print(f"generated header: {header_final}")
+
     # output some basic info about the config
-    print_basic_config_info(data)
+    print_basic_config_info(data, evaluate_feasibility(data, limits, **model_args))
 
 
 if __name__ == '__main__':
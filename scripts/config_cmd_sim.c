@@ -0,0 +1,174 @@
+/**
+ * @file config_cmd_sim.c
+ * @brief Host simulation of the runtime reconfiguration (config_cmd.h).
+ *
+ * Runs the command records written by chirp_config_to_defines.py --encode-cmd
+ * through the same decode, validation and stop/reconfigure/restart sequence as
+ * the firmware, with the sensor operations replaced by stubs which can be made
+ * to fail. Prints the state after every step and the status record the host
+ * would read in the next command slot.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -Wall -Iminimal_rangeproc_impl/include -o config_cmd_sim scripts/config_cmd_sim.c \
+ *         minimal_rangeproc_impl/src/config_cmd.c minimal_rangeproc_impl/src/chirp_accum.c \
+ *         minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     python3 scripts/chirp_config_to_defines.py profiles/default.cfg --encode-cmd active.bin
+ *     python3 scripts/chirp_config_to_defines.py new.cfg --encode-cmd cmd.bin --seq 2
+ *     ./config_cmd_sim active.bin cmd.bin [fail-stop|fail-apply|fail-rollback|fail-restart|corrupt]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "budget_limits.h"
+#include "config_cmd.h"
+
+/*! @brief RANGEPROC_MAX_ADC_SAMPLES of rangeproc_dpc.h (SDK header, not included here) */
+#define SIM_MAX_ADC_SAMPLES     1024U
+
+/*! @brief Words of the command slot (SPI_CMD_SLOT_WORDS of spi_transmit.h) */
+#define SIM_SLOT_WORDS          32U
+
+/**
+ * @brief Faults injected into the sensor operations.
+ */
+typedef struct Sim_Faults_t
+{
+    int failStop;
+    int failApply;      /* applying the new profile fails */
+    int failRollback;   /* applying the previous profile fails as well */
+    int failRestart;
+    int numApplied;     /* calls of the apply operation */
+} Sim_Faults;
+
+static const char *gStateNames[] = {
+    "RUNNING", "PENDING", "STOPPING", "RECONFIGURING", "ROLLBACK", "RESTARTING", "FAILED"
+};
+
+static int32_t Sim_stopSensor(void *arg) {
+    Sim_Faults *faults = (Sim_Faults *)arg;
+
+    printf("  stop sensor%s\n", faults->failStop ? ": failed" : "");
+    return faults->failStop ? -1 : 0;
+}
+
+static int32_t Sim_applyProfile(void *arg, const ConfigCmd_Profile *profile) {
+    Sim_Faults *faults = (Sim_Faults *)arg;
+    ConfigCmd_SensorParams params;
+    int fail = (faults->numApplied == 0) ? faults->failApply : faults->failRollback;
+
+    faults->numApplied++;
+    ConfigCmd_toSensorParams(profile, &params);
+    printf("  apply profile: %u ADC samples, %u range bins, ramp %u, idle %u, slope %d, frame %u ticks%s\n",
+           profile->chirpComnCfg.numOfAdcSamples, params.numRangeBins, params.rampEndTime,
+           params.idleTime, params.freqSlope, params.framePeriod, fail ? ": failed" : "");
+    return fail ? -1 : 0;
+}
+
+static int32_t Sim_startSensor(void *arg) {
+    Sim_Faults *faults = (Sim_Faults *)arg;
+
+    printf("  trigger DPU and start sensor%s\n", faults->failRestart ? ": failed" : "");
+    return faults->failRestart ? -1 : 0;
+}
+
+/**
+ * @brief Reads a record as the SPI receives it: 32-bit words, most significant byte first.
+ */
+static uint32_t Sim_readRecord(const char *path, uint32_t *words, uint32_t maxWords) {
+    uint8_t bytes[4];
+    uint32_t numWords = 0;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) {
+        return 0;
+    }
+    while ((numWords < maxWords) && (fread(bytes, 1, sizeof(bytes), f) == sizeof(bytes))) {
+        words[numWords++] = ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+                            ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+    }
+    fclose(f);
+    return numWords;
+}
+
+static void Sim_printState(const char *step, const ConfigCmd_Ctrl *ctrl) {
+    printf("%-8s state %s, sequence %u, result %d, applied %u, rejected %u\n",
+           step, gStateNames[ctrl->state], ctrl->lastSequence, ctrl->lastResult,
+           ctrl->numApplied, ctrl->numRejected);
+}
+
+int main(int argc, char **argv) {
+    uint32_t slot[SIM_SLOT_WORDS];
+    uint32_t status[CONFIG_CMD_STATUS_WORDS];
+    ConfigCmd_Profile active;
+    ConfigCmd_Limits limits;
+    ConfigCmd_Ctrl ctrl;
+    ConfigCmd_Ops ops;
+    Sim_Faults faults;
+    uint32_t numWords;
+    uint32_t sequence;
+    uint32_t i;
+    int32_t retVal;
+
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <active record> <command record> "
+                        "[fail-stop|fail-apply|fail-rollback|fail-restart|corrupt]\n", argv[0]);
+        return 2;
+    }
+
+    /* the profile the sensor was started with (defines.h on the device) */
+    numWords = Sim_readRecord(argv[1], slot, SIM_SLOT_WORDS);
+    if (ConfigCmd_decode(slot, numWords, &active, &sequence) != CONFIG_CMD_OK) {
+        fprintf(stderr, "error: %s holds no valid command record\n", argv[1]);
+        return 2;
+    }
+
+    memset(&faults, 0, sizeof(faults));
+    if (argc > 3) {
+        faults.failStop     = (strcmp(argv[3], "fail-stop") == 0);
+        faults.failApply    = (strcmp(argv[3], "fail-apply") == 0) || (strcmp(argv[3], "fail-rollback") == 0);
+        faults.failRollback = (strcmp(argv[3], "fail-rollback") == 0);
+        faults.failRestart  = (strcmp(argv[3], "fail-restart") == 0);
+    }
+    ops.stopSensor   = Sim_stopSensor;
+    ops.applyProfile = Sim_applyProfile;
+    ops.startSensor  = Sim_startSensor;
+    ops.arg          = &faults;
+
+    /* L3 left for the cubes after the boot allocations, as RangeProc_initConfigCmd() measures it */
+    limits.maxAdcSamples  = SIM_MAX_ADC_SAMPLES;
+    limits.numMinorChirps = 0;
+    limits.freeBytes      = L3_MEM_SIZE;
+    limits.reserveBytes   = 0;
+    ConfigCmd_init(&ctrl, &active, &limits);
+    Sim_printState("boot", &ctrl);
+
+    /* an idle slot (host sends zeros) leaves the state unchanged */
+    memset(slot, 0, sizeof(slot));
+    retVal = ConfigCmd_receive(&ctrl, slot, SIM_SLOT_WORDS);
+    printf("idle slot: %d\n", retVal);
+
+    memset(slot, 0, sizeof(slot));
+    numWords = Sim_readRecord(argv[2], slot, SIM_SLOT_WORDS);
+    if ((argc > 3) && (strcmp(argv[3], "corrupt") == 0) && (numWords > CONFIG_CMD_HEADER_WORDS)) {
+        slot[CONFIG_CMD_HEADER_WORDS] ^= 1U;
+    }
+    retVal = ConfigCmd_receive(&ctrl, slot, SIM_SLOT_WORDS);
+    printf("command slot: %d\n", retVal);
+    Sim_printState("receive", &ctrl);
+
+    /* frame boundary */
+    retVal = ConfigCmd_service(&ctrl, &ops);
+    printf("service: %d\n", retVal);
+    Sim_printState("service", &ctrl);
+
+    (void)ConfigCmd_encodeStatus(&ctrl, status);
+    printf("status record:");
+    for (i = 0; i < CONFIG_CMD_STATUS_WORDS; i++) {
+        printf(" %08x", status[i]);
+    }
+    printf("\n");
+    return (retVal < 0) ? 1 : 0;
+}
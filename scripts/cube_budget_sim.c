@@ -0,0 +1,158 @@
+/**
+ * @file cube_budget_sim.c
+ * @brief Host test of the radar cube memory accounting (cube_budget.h) against the L3 pool.
+ *
+ * Checks the cube sizes of the default profile, then for a grid of cube
+ * dimensions, pool fill levels and reserves that CubeBudget_check() accepts a
+ * configuration exactly when the major cube, the minor cube and the reserve
+ * can be allocated from a memory pool (mem_pool.h) of the size of L3, and that
+ * the reported headroom is what the pool has left. Allocations made before the
+ * cubes are multiples of 4 bytes, as in the demo. Also checks the exact fit,
+ * the minor cube limit and the overflow handling. Exits with 1 if a check
+ * fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o cube_budget_sim scripts/cube_budget_sim.c \
+ *         minimal_rangeproc_impl/src/cube_budget.c minimal_rangeproc_impl/src/mem_pool.c
+ *     ./cube_budget_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "budget_limits.h"
+#include "cube_budget.h"
+#include "mem_pool.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+
+static uint32_t gL3[L3_MEM_SIZE / sizeof(uint32_t)];
+
+static void Sim_testDefaultProfile(void) {
+    CubeBudget_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, 0U, L3_MEM_SIZE, 0U };
+    CubeBudget_Report report;
+    int ok;
+
+    ok = (CubeBudget_check(&cfg, &report) == 0) && (report.majorBytes == 98304U) && (report.minorBytes == 0U) &&
+         (report.totalBytes == 98304U) && (report.headroomBytes == (int32_t)(L3_MEM_SIZE - 98304U));
+    Sim_check(ok, "default profile: 98304 byte cube, the rest of L3 is headroom");
+
+    cfg.numMinorChirps = 8U;
+    ok = (CubeBudget_check(&cfg, &report) == 0) && (report.minorBytes == 12288U) && (report.totalBytes == 110592U);
+    Sim_check(ok, "default profile with 8 minor motion chirps: 12288 byte minor cube");
+}
+
+/**
+ * @brief Allocates the cubes and the reserve from a pool with usedBytes already taken.
+ *
+ * @return 1 if all allocations succeed, the bytes left in *freeBytes
+ */
+static int Sim_allocate(const CubeBudget_Config *cfg, uint32_t usedBytes, uint32_t *freeBytes) {
+    MemPoolObj pool;
+    int ok = 1;
+
+    memset(&pool, 0, sizeof(pool));
+    pool.cfg.addr = gL3;
+    pool.cfg.size = sizeof(gL3);
+    DPC_ObjDet_MemPoolReset(&pool);
+    (void)DPC_ObjDet_MemPoolAlloc(&pool, usedBytes, sizeof(uint32_t));
+
+    ok = ok && (DPC_ObjDet_MemPoolAlloc(&pool, cfg->numRangeBins * cfg->numVirtualAntennas * cfg->numMajorChirps * 4U,
+                                        sizeof(uint32_t)) != NULL);
+    ok = ok && (DPC_ObjDet_MemPoolAlloc(&pool, cfg->numRangeBins * cfg->numVirtualAntennas * cfg->numMinorChirps * 4U,
+                                        sizeof(uint32_t)) != NULL);
+    ok = ok && (DPC_ObjDet_MemPoolAlloc(&pool, cfg->reserveBytes, sizeof(uint32_t)) != NULL);
+    *freeBytes = DPC_ObjDet_MemPoolGetFree(&pool);
+    return ok;
+}
+
+static void Sim_testPool(void) {
+    static const uint32_t bins[] = { 16U, 64U, 128U, 256U, 512U };
+    static const uint32_t antennas[] = { 1U, 3U, 6U, 8U, 12U };
+    static const uint32_t chirps[] = { 1U, 16U, 64U, 128U, 256U };
+    static const uint32_t used[] = { 0U, 4096U, 100000U, 300000U };
+    static const uint32_t reserves[] = { 0U, 8192U };
+    uint32_t b, a, c, m, u, r, numRuns = 0, numFit = 0;
+    int ok = 1;
+    char msg[160];
+
+    for (b = 0; b < sizeof(bins) / sizeof(bins[0]); b++) {
+        for (a = 0; a < sizeof(antennas) / sizeof(antennas[0]); a++) {
+            for (c = 0; c < sizeof(chirps) / sizeof(chirps[0]); c++) {
+                for (m = 0; m < 3U; m++) {
+                    for (u = 0; u < sizeof(used) / sizeof(used[0]); u++) {
+                        for (r = 0; r < sizeof(reserves) / sizeof(reserves[0]); r++) {
+                            uint32_t minor = (m == 0U) ? 0U : ((m == 1U) ? (chirps[c] + 7U) / 8U : chirps[c]);
+                            CubeBudget_Config cfg = { bins[b], antennas[a], chirps[c], minor,
+                                                      L3_MEM_SIZE - used[u], reserves[r] };
+                            CubeBudget_Report report;
+                            uint32_t freeBytes;
+                            int fits = (CubeBudget_check(&cfg, &report) == 0);
+                            int allocated = Sim_allocate(&cfg, used[u], &freeBytes);
+
+                            ok = ok && (fits == allocated) && (!fits || (report.headroomBytes == (int32_t)freeBytes)) &&
+                                 (fits || (report.headroomBytes < 0));
+                            numRuns++;
+                            numFit += (uint32_t)fits;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "%u configurations (%u fit): accepted exactly when the L3 pool allocations succeed, "
+             "headroom is what the pool has left", numRuns, numFit);
+    Sim_check(ok && (numFit > 0U) && (numFit < numRuns), msg);
+}
+
+static void Sim_testEdges(void) {
+    CubeBudget_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, 8U, 110592U, 0U };
+    CubeBudget_Report report;
+    int ok;
+
+    ok = (CubeBudget_check(&cfg, &report) == 0) && (report.headroomBytes == 0);
+    cfg.reserveBytes = 4U;
+    ok = ok && (CubeBudget_check(&cfg, &report) == -1) && (report.headroomBytes == -4);
+    Sim_check(ok, "exact fit is accepted with 0 headroom, 4 bytes short is rejected with -4");
+
+    cfg.numMinorChirps = SIM_NUM_CHIRPS + 1U;
+    Sim_check(CubeBudget_check(&cfg, &report) == -1, "minor cube with more chirps than the major cube is rejected");
+
+    cfg.numRangeBins = 0x10000U;
+    cfg.numVirtualAntennas = 0x10000U;
+    cfg.numMinorChirps = 1U;
+    ok = (CubeBudget_check(&cfg, &report) == -1) && (report.headroomBytes == INT32_MIN) &&
+         (CubeBudget_getCubeSize(0x10000U, 0x10000U, 1U) == 0U);
+    Sim_check(ok, "cube size above 4 GB is reported as overflow");
+
+    cfg.numRangeBins = 1U;
+    cfg.numVirtualAntennas = 1U;
+    cfg.numMajorChirps = 0x3FFFFFFFU;
+    cfg.numMinorChirps = 0x3FFFFFFFU;
+    cfg.freeBytes = UINT32_MAX;
+    ok = (CubeBudget_check(&cfg, &report) == -1) && (report.majorBytes == 0xFFFFFFFCU) &&
+         (report.totalBytes == UINT32_MAX) && (report.headroomBytes < 0);
+    Sim_check(ok, "total above 4 GB saturates and is rejected");
+
+    cfg.numMajorChirps = 0U;
+    cfg.numMinorChirps = 0U;
+    cfg.freeBytes = 0U;
+    cfg.reserveBytes = 0U;
+    ok = (CubeBudget_check(&cfg, &report) == 0) && (report.totalBytes == 0U);
+    Sim_check(ok, "disabled cubes need no memory");
+}
+
+int main(void) {
+    Sim_testDefaultProfile();
+    Sim_testPool();
+    Sim_testEdges();
+
+    return Sim_result();
+}
@@ -0,0 +1,209 @@
+/**
+ * @file cube_layout_sim.c
+ * @brief Host test and benchmark of the radar cube layout conversion (cube_layout.h).
+ *
+ * For every order and I/Q mode and several cube dimensions, checks every
+ * sample of the converted cube against the index formula of the layout table
+ * in cube_layout.h, the round trip back to the native cube, that the native
+ * layout is a plain copy and that unknown orders are rejected. Then times the
+ * conversion of a cube of the default profile and a slow-time kernel (a
+ * weighted sum over the chirps of each range bin and antenna, the access
+ * pattern of a Doppler DFT) on the native and on the range-major cube. Exits
+ * with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o cube_layout_sim scripts/cube_layout_sim.c \
+ *         minimal_rangeproc_impl/src/cube_layout.c
+ *     ./cube_layout_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cube_layout.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+#define SIM_NUM_SAMPLES         (SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS)
+
+static const char *gOrderNames[] = { "chirp-major", "range-major", "antenna-major" };
+
+/**
+ * @brief Sample index of (chirp, antenna, bin) in a layout, as in the table of cube_layout.h.
+ */
+static uint32_t Sim_index(const CubeLayout_Config *cfg, uint32_t chirp, uint32_t ant, uint32_t bin) {
+    switch (cfg->order) {
+        case CUBE_LAYOUT_RANGE_MAJOR:
+            return (bin * cfg->numVirtualAntennas + ant) * cfg->numChirps + chirp;
+        case CUBE_LAYOUT_ANTENNA_MAJOR:
+            return (ant * cfg->numChirps + chirp) * cfg->numRangeBins + bin;
+        default:
+            return (chirp * cfg->numVirtualAntennas + ant) * cfg->numRangeBins + bin;
+    }
+}
+
+static int Sim_checkLayout(const CubeLayout_Config *cfg, const int16_t *src, const int16_t *dst) {
+    uint32_t numSamples = cfg->numChirps * cfg->numVirtualAntennas * cfg->numRangeBins;
+    uint32_t chirp, ant, bin;
+
+    for (chirp = 0; chirp < cfg->numChirps; chirp++) {
+        for (ant = 0; ant < cfg->numVirtualAntennas; ant++) {
+            for (bin = 0; bin < cfg->numRangeBins; bin++) {
+                uint32_t native = (chirp * cfg->numVirtualAntennas + ant) * cfg->numRangeBins + bin;
+                uint32_t idx = Sim_index(cfg, chirp, ant, bin);
+                /* native: imaginary part first; split: real plane, then imaginary plane */
+                int16_t re = cfg->iqSplit ? dst[idx] : dst[2U * idx + 1U];
+                int16_t im = cfg->iqSplit ? dst[numSamples + idx] : dst[2U * idx];
+
+                if ((re != src[2U * native + 1U]) || (im != src[2U * native])) {
+                    return 0;
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+static void Sim_testLayouts(int16_t *src, int16_t *dst, int16_t *back) {
+    static const uint32_t dims[][3] = { { 64U, 6U, 64U }, { 1U, 1U, 1U }, { 7U, 3U, 5U }, { 256U, 12U, 16U } };
+    uint32_t d, i;
+    uint8_t order, split;
+    int layoutOk = 1, roundTripOk = 1;
+    char msg[160];
+
+    for (d = 0; d < sizeof(dims) / sizeof(dims[0]); d++) {
+        uint32_t numValues = 2U * dims[d][0] * dims[d][1] * dims[d][2];
+
+        srand(d + 1U);
+        for (i = 0; i < numValues; i++) {
+            src[i] = (int16_t)((rand() & 0xFFFF) - 32768);
+        }
+        for (order = CUBE_LAYOUT_CHIRP_MAJOR; order <= CUBE_LAYOUT_ANTENNA_MAJOR; order++) {
+            for (split = 0; split < 2U; split++) {
+                CubeLayout_Config cfg = { dims[d][0], dims[d][1], dims[d][2], order, split };
+
+                memset(dst, 0, numValues * sizeof(int16_t));
+                layoutOk = layoutOk && (CubeLayout_fromNative(&cfg, src, dst) == 0) && Sim_checkLayout(&cfg, src, dst);
+                roundTripOk = roundTripOk && (CubeLayout_toNative(&cfg, dst, back) == 0) &&
+                              (memcmp(back, src, numValues * sizeof(int16_t)) == 0);
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "every sample at its index of the layout table (%u cube sizes, 3 orders, 2 I/Q modes)",
+             (uint32_t)(sizeof(dims) / sizeof(dims[0])));
+    Sim_check(layoutOk, msg);
+    Sim_check(roundTripOk, "conversion back to the native layout restores the cube");
+}
+
+static void Sim_testNative(int16_t *src, int16_t *dst) {
+    CubeLayout_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, CUBE_LAYOUT_CHIRP_MAJOR, 0U };
+    int ok;
+
+    ok = (CubeLayout_isConverted(&cfg) == 0U) && (CubeLayout_fromNative(&cfg, src, dst) == 0) &&
+         (memcmp(src, dst, 2U * SIM_NUM_SAMPLES * sizeof(int16_t)) == 0);
+    cfg.iqSplit = 1U;
+    ok = ok && (CubeLayout_isConverted(&cfg) == 1U);
+    cfg.iqSplit = 0U;
+    cfg.order = CUBE_LAYOUT_RANGE_MAJOR;
+    ok = ok && (CubeLayout_isConverted(&cfg) == 1U);
+    Sim_check(ok, "native interleaved layout is a plain copy, all other layouts are converted");
+
+    cfg.order = CUBE_LAYOUT_ANTENNA_MAJOR + 1U;
+    Sim_check((CubeLayout_fromNative(&cfg, src, dst) == -1) && (CubeLayout_toNative(&cfg, src, dst) == -1),
+              "unknown order is rejected");
+}
+
+/**
+ * @brief Slow-time kernel on the native cube: real part against a chirp weight per (bin, antenna).
+ */
+static int64_t Sim_kernelNative(const int16_t *x) {
+    int64_t sum = 0;
+    uint32_t b, a, c;
+
+    for (b = 0; b < SIM_NUM_RANGE_BINS; b++) {
+        for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+            for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+                sum += (int64_t)x[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + b) + 1U] * (int64_t)(c & 7U);
+            }
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Same kernel on the range-major cube with split I/Q: the chirps of a (bin, antenna) are contiguous.
+ */
+static int64_t Sim_kernelRangeMajor(const int16_t *x) {
+    int64_t sum = 0;
+    uint32_t ba, c;
+
+    for (ba = 0; ba < SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS; ba++) {
+        const int16_t *re = &x[ba * SIM_NUM_CHIRPS];
+        for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+            sum += (int64_t)re[c] * (int64_t)(c & 7U);
+        }
+    }
+    return sum;
+}
+
+static void Sim_benchmark(int16_t *src, int16_t *dst) {
+    uint32_t i, iterations = 500U;
+    uint8_t order, split;
+    int64_t native = 0, reordered = 0;
+    double t0, tNative, tReordered;
+
+    printf("\nbenchmark, %u x %u x %u cube:\n", SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS);
+    for (i = 0; i < 2U * SIM_NUM_SAMPLES; i++) {
+        src[i] = (int16_t)((rand() & 0xFFFF) - 32768);
+    }
+    for (order = CUBE_LAYOUT_CHIRP_MAJOR; order <= CUBE_LAYOUT_ANTENNA_MAJOR; order++) {
+        for (split = 0; split < 2U; split++) {
+            CubeLayout_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, order, split };
+
+            t0 = Sim_nowUs();
+            for (i = 0; i < iterations; i++) {
+                (void)CubeLayout_fromNative(&cfg, src, dst);
+            }
+            printf("  %-13s %-11s conversion in %6.1f us\n", gOrderNames[order], split ? "split" : "interleaved",
+                   (Sim_nowUs() - t0) / iterations);
+        }
+    }
+
+    {
+        CubeLayout_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, CUBE_LAYOUT_RANGE_MAJOR, 1U };
+        (void)CubeLayout_fromNative(&cfg, src, dst);
+    }
+    t0 = Sim_nowUs();
+    for (i = 0; i < iterations; i++) {
+        native += Sim_kernelNative(src);
+    }
+    tNative = (Sim_nowUs() - t0) / iterations;
+    t0 = Sim_nowUs();
+    for (i = 0; i < iterations; i++) {
+        reordered += Sim_kernelRangeMajor(dst);
+    }
+    tReordered = (Sim_nowUs() - t0) / iterations;
+    printf("  slow-time kernel: native %.1f us, range-major split %.1f us\n", tNative, tReordered);
+    Sim_check(native == reordered, "slow-time kernel gives the same result on the native and the range-major cube");
+}
+
+int main(void) {
+    int16_t *src = malloc(2U * 256U * 12U * 16U * sizeof(int16_t));
+    int16_t *dst = malloc(2U * 256U * 12U * 16U * sizeof(int16_t));
+    int16_t *back = malloc(2U * 256U * 12U * 16U * sizeof(int16_t));
+
+    Sim_testLayouts(src, dst, back);
+    Sim_testNative(src, dst);
+    Sim_benchmark(src, dst);
+
+    free(src);
+    free(dst);
+    free(back);
+    return Sim_result();
+}
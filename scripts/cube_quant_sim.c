@@ -0,0 +1,287 @@
+/**
+ * @file cube_quant_sim.c
+ * @brief Host test and benchmark of the int8 radar cube quantisation (cube_quant.h).
+ *
+ * Checks the payload size, the SQNR reported in the header against the SQNR
+ * measured on the dequantised cube and against the theoretical value of a
+ * full scale tone, the gain of the per-range-bin scales on weak range bins
+ * next to strong ones, the bias removed by dithering, every quantised sample
+ * of a cube wider than the blocks of the quantiser, the zeroed padding and
+ * the rejection of invalid arguments. Then times quantiser and dequantiser on
+ * a cube of the default profile. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o cube_quant_sim scripts/cube_quant_sim.c \
+ *         minimal_rangeproc_impl/src/cube_quant.c -lm
+ *     ./cube_quant_sim [iterations]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cube_quant.h"
+#include "sim_check.h"
+
+/*! @brief Cube of the default profile: 64 range bins, 6 virtual antennas x 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ROWS            384U
+
+/*! @brief Range bins of the sample check, not a multiple of the block of the quantiser */
+#define SIM_NUM_WIDE_BINS       200U
+
+/*! @brief Range bins of the strong near targets in the dynamic range check */
+#define SIM_NUM_STRONG_BINS     4U
+
+/**
+ * @brief Fills a cube with one complex tone per range line, amplitude per range bin.
+ */
+static void Sim_fillCube(int16_t *cube, uint32_t numBins, uint32_t numRows, double strongAmp, double weakAmp) {
+    uint32_t row, bin;
+
+    for (row = 0; row < numRows; row++) {
+        for (bin = 0; bin < numBins; bin++) {
+            double amp   = (bin < SIM_NUM_STRONG_BINS) ? strongAmp : weakAmp;
+            double phase = 0.37 * (double)(row * numBins + bin) + 0.11 * (double)bin;
+            cube[2U * (row * numBins + bin)]      = (int16_t)lrint(amp * cos(phase));
+            cube[2U * (row * numBins + bin) + 1U] = (int16_t)lrint(amp * sin(phase));
+        }
+    }
+}
+
+/**
+ * @brief SQNR in dB between two cubes over the range bins [firstBin, numBins).
+ */
+static double Sim_sqnrDb(const int16_t *ref, const int16_t *rec, uint32_t numBins, uint32_t numRows,
+                         uint32_t firstBin) {
+    double sig = 0.0, err = 0.0;
+    uint32_t row, bin, k;
+
+    for (row = 0; row < numRows; row++) {
+        for (bin = firstBin; bin < numBins; bin++) {
+            for (k = 0; k < 2U; k++) {
+                double x = ref[2U * (row * numBins + bin) + k];
+                double e = x - rec[2U * (row * numBins + bin) + k];
+                sig += x * x;
+                err += e * e;
+            }
+        }
+    }
+    return 10.0 * log10(sig / err);
+}
+
+static void *Sim_allocPayload(const CubeQuant_Config *cfg) {
+    return aligned_alloc(4, CubeQuant_getPayloadSize(cfg));
+}
+
+static void Sim_testPayloadSize(void) {
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_FRAME, 0U, 3U, 1U };
+    uint32_t expected = (uint32_t)sizeof(CubeQuant_Header) + 4U + 8U;
+
+    Sim_check(CubeQuant_getPayloadSize(&cfg) == expected, "payload of 3 bins x 1 row is padded to 4 bytes");
+    cfg.granularity  = CUBE_QUANT_GRANULARITY_PER_RANGE_BIN;
+    cfg.numRangeBins = SIM_NUM_RANGE_BINS;
+    cfg.numRows      = SIM_NUM_ROWS;
+    expected = (uint32_t)sizeof(CubeQuant_Header) + 4U * SIM_NUM_RANGE_BINS + 2U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS;
+    Sim_check(CubeQuant_getPayloadSize(&cfg) == expected, "per-bin payload holds one scale per range bin");
+    Sim_check(2U * CubeQuant_getPayloadSize(&cfg) < 4U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS + 2048U,
+              "quantised payload is about half of the 16-bit cube");
+}
+
+static void Sim_testSqnr(void) {
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_FRAME, 0U, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS };
+    uint32_t numValues = 2U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS;
+    int16_t *cube = malloc(numValues * sizeof(int16_t));
+    int16_t *rec  = malloc(numValues * sizeof(int16_t));
+    void *payload;
+    double measured, perFrameWeak, perBinWeak;
+    char msg[160];
+
+    /* full scale tone: uniform error of one step, 10 log10((127^2 / 2) / (1 / 12)) = 49.9 dB */
+    Sim_fillCube(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, 20000.0, 20000.0);
+    payload = Sim_allocPayload(&cfg);
+    Sim_check((CubeQuant_quantize(&cfg, cube, payload, NULL) == 0) && (CubeQuant_dequantize(payload, rec) == 0),
+              "quantise and dequantise a full scale tone");
+    measured = Sim_sqnrDb(cube, rec, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, 0U);
+    snprintf(msg, sizeof(msg), "reported SQNR %.2f dB matches measured %.2f dB within 0.5 dB",
+             ((CubeQuant_Header *)payload)->sqnrDb, measured);
+    Sim_check(fabs(((CubeQuant_Header *)payload)->sqnrDb - measured) < 0.5, msg);
+    snprintf(msg, sizeof(msg), "full scale SQNR %.2f dB within 1.5 dB of the theoretical 49.9 dB", measured);
+    Sim_check(fabs(measured - 49.9) < 1.5, msg);
+
+    /* strong near bins, weak rest (30 dB apart): per-frame scales leave the weak bins with a few bits */
+    Sim_fillCube(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, 30000.0, 950.0);
+    (void)CubeQuant_quantize(&cfg, cube, payload, NULL);
+    (void)CubeQuant_dequantize(payload, rec);
+    perFrameWeak = Sim_sqnrDb(cube, rec, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, SIM_NUM_STRONG_BINS);
+    free(payload);
+
+    cfg.granularity = CUBE_QUANT_GRANULARITY_PER_RANGE_BIN;
+    payload = Sim_allocPayload(&cfg);
+    (void)CubeQuant_quantize(&cfg, cube, payload, NULL);
+    (void)CubeQuant_dequantize(payload, rec);
+    perBinWeak = Sim_sqnrDb(cube, rec, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, SIM_NUM_STRONG_BINS);
+    snprintf(msg, sizeof(msg), "weak bins: per-bin SQNR %.2f dB exceeds per-frame %.2f dB by 20 dB",
+             perBinWeak, perFrameWeak);
+    Sim_check(perBinWeak > perFrameWeak + 20.0, msg);
+
+    free(payload);
+    free(cube);
+    free(rec);
+}
+
+static void Sim_testDither(void) {
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_FRAME, 0U, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS };
+    uint32_t numValues = 2U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS;
+    int16_t *cube = malloc(numValues * sizeof(int16_t));
+    int16_t *rec  = malloc(numValues * sizeof(int16_t));
+    void *payload = Sim_allocPayload(&cfg);
+    uint32_t state = 0x12345678U;
+    uint32_t i;
+    double step, meanPlain = 0.0, meanDither = 0.0;
+    char msg[160];
+
+    /* one full scale sample sets the step, all others are 0.3 steps: plain rounding maps them to 0 */
+    step = 12700.0 / CUBE_QUANT_MAX_CODE;
+    for (i = 0; i < numValues; i++) {
+        cube[i] = (int16_t)lrint(0.3 * step);
+    }
+    cube[0] = 12700;
+
+    (void)CubeQuant_quantize(&cfg, cube, payload, NULL);
+    (void)CubeQuant_dequantize(payload, rec);
+    for (i = 1; i < numValues; i++) {
+        meanPlain += rec[i];
+    }
+    cfg.ditherEnable = 1U;
+    Sim_check(CubeQuant_quantize(&cfg, cube, payload, &state) == 0, "quantise with dither");
+    Sim_check(((CubeQuant_Header *)payload)->ditherEnable == 1U, "dither flag in the header");
+    (void)CubeQuant_dequantize(payload, rec);
+    for (i = 1; i < numValues; i++) {
+        meanDither += rec[i];
+    }
+    meanPlain  /= (double)(numValues - 1U) * step;
+    meanDither /= (double)(numValues - 1U) * step;
+    snprintf(msg, sizeof(msg), "dither removes the bias of a 0.3 step input (mean %.3f plain, %.3f dithered)",
+             meanPlain, meanDither);
+    Sim_check((fabs(meanPlain) < 0.01) && (fabs(meanDither - 0.3) < 0.02), msg);
+
+    state = 0U;
+    Sim_check(CubeQuant_quantize(&cfg, cube, payload, &state) == -1, "dither state 0 is rejected");
+
+    free(payload);
+    free(cube);
+    free(rec);
+}
+
+/**
+ * @brief Checks every quantised sample of a cube wider than a block of range bins
+ *        against the rounded and clipped sample / step.
+ */
+static void Sim_testSamples(void) {
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_RANGE_BIN, 0U, SIM_NUM_WIDE_BINS, SIM_NUM_ROWS };
+    uint32_t numValues = 2U * SIM_NUM_WIDE_BINS * SIM_NUM_ROWS;
+    int16_t *cube = malloc(numValues * sizeof(int16_t));
+    void *payload;
+    uint32_t g, i, numDiff = 0;
+    char msg[160];
+
+    Sim_fillCube(cube, SIM_NUM_WIDE_BINS, SIM_NUM_ROWS, 20000.0, 500.0);
+    for (g = 0; g < 2U; g++) {
+        const float *scales;
+        const int8_t *q;
+
+        cfg.granularity = (g == 0U) ? CUBE_QUANT_GRANULARITY_PER_FRAME : CUBE_QUANT_GRANULARITY_PER_RANGE_BIN;
+        payload = Sim_allocPayload(&cfg);
+        (void)CubeQuant_quantize(&cfg, cube, payload, NULL);
+        scales = (const float *)((const CubeQuant_Header *)payload + 1);
+        q = (const int8_t *)(scales + CubeQuant_getNumScales(&cfg));
+        for (i = 0; i < numValues; i++) {
+            double v = (double)cube[i] / scales[(g == 0U) ? 0U : ((i / 2U) % SIM_NUM_WIDE_BINS)];
+            long ref = lround(v);
+            ref = (ref > CUBE_QUANT_MAX_CODE) ? CUBE_QUANT_MAX_CODE : (ref < -CUBE_QUANT_MAX_CODE) ?
+                  -CUBE_QUANT_MAX_CODE : ref;
+            /* the reciprocal may round the other way exactly between two codes */
+            numDiff += ((q[i] != ref) && (fabs(fabs(v - trunc(v)) - 0.5) > 1e-4)) ? 1U : 0U;
+        }
+        free(payload);
+    }
+    snprintf(msg, sizeof(msg), "%u range bins, per frame and per bin: %u of %u samples differ from round(x / step)",
+             SIM_NUM_WIDE_BINS, numDiff, 2U * numValues);
+    Sim_check(numDiff == 0U, msg);
+    free(cube);
+}
+
+static void Sim_testInvalid(void) {
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_FRAME, 0U, 3U, 1U };
+    int16_t cube[6] = { 100, -100, 50, -50, 25, -25 };
+    int16_t rec[6];
+    uint32_t payload[16];
+    CubeQuant_Header *hdr = (CubeQuant_Header *)payload;
+
+    memset(payload, 0xA5, sizeof(payload));
+    (void)CubeQuant_quantize(&cfg, cube, payload, NULL);
+    Sim_check(((int8_t *)(payload) + sizeof(CubeQuant_Header) + 4U)[6] == 0 &&
+              ((int8_t *)(payload) + sizeof(CubeQuant_Header) + 4U)[7] == 0, "padding is zeroed");
+
+    hdr->granularity = 2U;
+    Sim_check(CubeQuant_dequantize(payload, rec) == -1, "unknown granularity is rejected");
+    hdr->granularity = CUBE_QUANT_GRANULARITY_PER_RANGE_BIN;
+    Sim_check(CubeQuant_dequantize(payload, rec) == -1, "per-bin header with one scale is rejected");
+    cfg.numRows = 0U;
+    Sim_check(CubeQuant_quantize(&cfg, cube, payload, NULL) == -1, "empty cube is rejected");
+}
+
+static void Sim_benchmark(uint32_t iterations) {
+    static const char *names[] = { "per frame", "per bin", "per bin, dither" };
+    CubeQuant_Config cfg = { CUBE_QUANT_GRANULARITY_PER_FRAME, 0U, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS };
+    uint32_t numValues = 2U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS;
+    int16_t *cube = malloc(numValues * sizeof(int16_t));
+    int16_t *rec  = malloc(numValues * sizeof(int16_t));
+    uint32_t state = 1U;
+    uint32_t mode, i;
+
+    Sim_fillCube(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, 20000.0, 500.0);
+    printf("\nbenchmark, %u x %u cube (%u bytes), %u iterations:\n", SIM_NUM_RANGE_BINS, SIM_NUM_ROWS,
+           numValues * 2U, iterations);
+    for (mode = 0; mode < 3U; mode++) {
+        void *payload;
+        double t0, tq, td;
+
+        cfg.granularity  = (mode == 0U) ? CUBE_QUANT_GRANULARITY_PER_FRAME : CUBE_QUANT_GRANULARITY_PER_RANGE_BIN;
+        cfg.ditherEnable = (mode == 2U) ? 1U : 0U;
+        payload = Sim_allocPayload(&cfg);
+
+        t0 = Sim_nowUs();
+        for (i = 0; i < iterations; i++) {
+            (void)CubeQuant_quantize(&cfg, cube, payload, &state);
+        }
+        tq = (Sim_nowUs() - t0) / iterations;
+        t0 = Sim_nowUs();
+        for (i = 0; i < iterations; i++) {
+            (void)CubeQuant_dequantize(payload, rec);
+        }
+        td = (Sim_nowUs() - t0) / iterations;
+        printf("  %-16s quantise %8.1f us (%6.1f MB/s), dequantise %8.1f us, SQNR %.1f dB\n", names[mode],
+               tq, numValues * 2.0 / tq, td, ((CubeQuant_Header *)payload)->sqnrDb);
+        free(payload);
+    }
+    free(cube);
+    free(rec);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 200U;
+
+    Sim_testPayloadSize();
+    Sim_testSqnr();
+    Sim_testDither();
+    Sim_testSamples();
+    Sim_testInvalid();
+    Sim_benchmark((iterations > 0U) ? iterations : 1U);
+
+    return Sim_result();
+}
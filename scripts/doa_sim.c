@@ -0,0 +1,280 @@
+/**
+ * @file doa_sim.c
+ * @brief Host reference test and benchmark of the angle of arrival estimation (doa.h).
+ *
+ * Uses the antenna geometry of doa_proc.h (4 azimuth columns, 2 antennas one
+ * half wavelength above). Places single targets with Doppler and receiver
+ * noise on a grid of azimuth and elevation angles and checks the estimated
+ * angles and level, checks that without row 1 the elevation is 0, compares
+ * the range-azimuth heatmap with a double precision DFT reference and the
+ * position of its peak, checks the chirp sums and the geometry checks of
+ * Doa_init(). Then times an estimate and the heatmap model on a cube of the
+ * default profile. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o doa_sim scripts/doa_sim.c \
+ *         minimal_rangeproc_impl/src/doa.c -lm
+ *     ./doa_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "doa.h"
+#include "doa_proc.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+
+/*! @brief Range and Doppler bin and amplitude of the target */
+#define SIM_TARGET_BIN          20U
+#define SIM_TARGET_DOPPLER      5U
+#define SIM_TARGET_AMP          3000.0
+
+/*! @brief Largest angle errors on the grid (4 azimuth columns, one elevation row at SNR ~ 50 dB) */
+#define SIM_MAX_AZ_ERROR_DEG    0.5
+#define SIM_MAX_EL_ERROR_DEG    0.5
+
+static void Sim_initConfig(Doa_Config *cfg, int withElevation) {
+    static const uint8_t antRow[] = DOAPROC_ANT_ROW;
+    static const uint8_t antCol[] = DOAPROC_ANT_COL;
+    uint32_t ant;
+
+    memset(cfg, 0, sizeof(Doa_Config));
+    cfg->numRangeBins       = SIM_NUM_RANGE_BINS;
+    cfg->numVirtualAntennas = SIM_NUM_ANTENNAS;
+    cfg->numChirps          = SIM_NUM_CHIRPS;
+    cfg->azimuthFftSize     = DOAPROC_AZIMUTH_FFT_SIZE;
+    cfg->dopplerFftSize     = SIM_NUM_CHIRPS;
+    for (ant = 0; ant < SIM_NUM_ANTENNAS; ant++) {
+        cfg->antRow[ant] = (withElevation || (antRow[ant] == 0U)) ? antRow[ant] : DOA_ANT_UNUSED;
+        cfg->antCol[ant] = antCol[ant];
+    }
+}
+
+/**
+ * @brief FORMAT_6 cube with one target at (azimuth, elevation) in SIM_TARGET_BIN and receiver noise.
+ */
+static void Sim_fillCube(int16_t *cube, const Doa_Config *cfg, double azDeg, double elDeg) {
+    static const uint8_t antRow[] = DOAPROC_ANT_ROW;
+    double az = azDeg * M_PI / 180.0, el = elDeg * M_PI / 180.0;
+    uint32_t c, a, b;
+
+    srand(1);
+    for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+        for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+            for (b = 0; b < SIM_NUM_RANGE_BINS; b++) {
+                int16_t *s = &cube[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + b)];
+                double re = (double)(rand() % 201) - 100.0;
+                double im = (double)(rand() % 201) - 100.0;
+
+                if (b == SIM_TARGET_BIN) {
+                    double ph = 2.0 * M_PI * SIM_TARGET_DOPPLER * c / SIM_NUM_CHIRPS +
+                                M_PI * sin(az) * cos(el) * cfg->antCol[a] + M_PI * sin(el) * antRow[a];
+                    re += SIM_TARGET_AMP * cos(ph);
+                    im += SIM_TARGET_AMP * sin(ph);
+                }
+                s[0] = (int16_t)lrint(im);
+                s[1] = (int16_t)lrint(re);
+            }
+        }
+    }
+}
+
+static void Sim_testEstimates(int16_t *cube) {
+    Doa_Config cfg, cfgAz;
+    double maxAz = 0.0, maxEl = 0.0, maxLevel = 0.0, maxAzOnly = 0.0;
+    int az, el, elZero = 1;
+    char msg[200];
+
+    Sim_initConfig(&cfg, 1);
+    Sim_initConfig(&cfgAz, 0);
+    (void)Doa_init(&cfg);
+    (void)Doa_init(&cfgAz);
+    for (az = -60; az <= 60; az += 5) {
+        for (el = -30; el <= 30; el += 10) {
+            Doa_Estimate est;
+
+            Sim_fillCube(cube, &cfg, az, el);
+            Doa_estimate(&cfg, cube, SIM_TARGET_BIN, SIM_TARGET_DOPPLER, &est);
+            maxAz = fmax(maxAz, fabs(est.azimuthDegQ7 / 128.0 - az));
+            maxEl = fmax(maxEl, fabs(est.elevationDegQ7 / 128.0 - el));
+            maxLevel = fmax(maxLevel, fabs(est.level / SIM_TARGET_AMP - 1.0));
+            elZero = elZero && (est.rangeIdx == SIM_TARGET_BIN) && (est.dopplerIdx == SIM_TARGET_DOPPLER);
+
+            if (el == 0) {
+                Doa_estimate(&cfgAz, cube, SIM_TARGET_BIN, SIM_TARGET_DOPPLER, &est);
+                maxAzOnly = fmax(maxAzOnly, fabs(est.azimuthDegQ7 / 128.0 - az));
+                elZero = elZero && (est.elevationDegQ7 == 0);
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "azimuth -60..60, elevation -30..30: errors %.2f / %.2f deg (limits %.1f / %.1f)",
+             maxAz, maxEl, SIM_MAX_AZ_ERROR_DEG, SIM_MAX_EL_ERROR_DEG);
+    Sim_check((maxAz <= SIM_MAX_AZ_ERROR_DEG) && (maxEl <= SIM_MAX_EL_ERROR_DEG), msg);
+    snprintf(msg, sizeof(msg), "level is the target amplitude per sample (largest deviation %.1f%%)", 100.0 * maxLevel);
+    Sim_check(maxLevel < 0.05, msg);
+    snprintf(msg, sizeof(msg), "row 0 only: elevation 0, azimuth error %.2f deg, cells reported as requested", maxAzOnly);
+    Sim_check(elZero && (cfgAz.elevationEn == 0U) && (maxAzOnly <= SIM_MAX_AZ_ERROR_DEG), msg);
+}
+
+/**
+ * @brief Reference heatmap: DFT of the row 0 columns in double precision, / n, floored per chirp, summed, shifted.
+ */
+static void Sim_referenceHeatmap(const Doa_Config *cfg, const int16_t *cube, uint32_t *ref) {
+    uint32_t n = cfg->azimuthFftSize, shift = Doa_getShift(cfg->numChirps);
+    uint32_t b, c, k, col;
+
+    for (b = 0; b < cfg->numRangeBins; b++) {
+        for (k = 0; k < n; k++) {
+            uint32_t sum = 0;
+            for (c = 0; c < cfg->numChirps; c++) {
+                double re = 0.0, im = 0.0;
+                for (col = 0; col < cfg->numAzimuthCols; col++) {
+                    uint32_t ant = cfg->azimuthAnt[col];
+                    const int16_t *s;
+                    double ph = -2.0 * M_PI * (double)(k * col) / (double)n;
+
+                    if (ant == DOA_ANT_UNUSED) {
+                        continue;
+                    }
+                    s = &cube[2U * ((c * cfg->numVirtualAntennas + ant) * cfg->numRangeBins + b)];
+                    re += s[1] * cos(ph) - s[0] * sin(ph);
+                    im += s[1] * sin(ph) + s[0] * cos(ph);
+                }
+                sum += (uint32_t)(sqrt(re * re + im * im) / (double)n);
+            }
+            ref[b * n + k] = sum >> shift;
+        }
+    }
+}
+
+static void Sim_testHeatmap(int16_t *cube) {
+    Doa_Config cfg;
+    uint16_t heatmap[SIM_NUM_RANGE_BINS * DOA_MAX_AZIMUTH_FFT_SIZE];
+    uint32_t ref[SIM_NUM_RANGE_BINS * DOA_MAX_AZIMUTH_FFT_SIZE];
+    uint32_t n = DOAPROC_AZIMUTH_FFT_SIZE, i, k, peak = 0, maxDiff = 0;
+    double expected;
+    char msg[160];
+
+    Sim_initConfig(&cfg, 1);
+    (void)Doa_init(&cfg);
+    Sim_fillCube(cube, &cfg, 30.0, 0.0);
+    (void)Doa_computeHeatmap(&cfg, cube, heatmap);
+    Sim_referenceHeatmap(&cfg, cube, ref);
+    for (i = 0; i < SIM_NUM_RANGE_BINS * n; i++) {
+        uint32_t d = (heatmap[i] > ref[i]) ? (heatmap[i] - ref[i]) : (ref[i] - heatmap[i]);
+        maxDiff = (d > maxDiff) ? d : maxDiff;
+    }
+    snprintf(msg, sizeof(msg), "heatmap matches the DFT reference within 1 LSB (max %u)", maxDiff);
+    Sim_check(maxDiff <= 1U, msg);
+
+    /* bin k is sin(azimuth) = 2 k / n: 30 deg is bin 8 of 32 */
+    for (k = 1; k < n; k++) {
+        peak = (heatmap[SIM_TARGET_BIN * n + k] > heatmap[SIM_TARGET_BIN * n + peak]) ? k : peak;
+    }
+    expected = 0.5 * n * sin(30.0 * M_PI / 180.0);
+    snprintf(msg, sizeof(msg), "heatmap peak of a target at 30 deg in bin %u (expected %.0f)", peak, expected);
+    Sim_check(peak == (uint32_t)lrint(expected), msg);
+    Sim_check(Doa_getHeatmapSize(&cfg) == SIM_NUM_RANGE_BINS * n * 2U, "heatmap size is range bins x FFT size x 2");
+}
+
+static void Sim_testSumChirps(void) {
+    Doa_Config cfg;
+    uint16_t mag[3U * 2U * 4U], heatmap[2U * 4U];
+    uint32_t i;
+    int ok = 1;
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.numChirps = 3U;
+    cfg.azimuthFftSize = 4U;
+    for (i = 0; i < 8U; i++) {
+        mag[i] = (uint16_t)i;
+        mag[8U + i] = (uint16_t)(10U * i);
+        mag[16U + i] = UINT16_MAX;
+    }
+    Doa_sumChirps(mag, 2U, &cfg, heatmap);
+    for (i = 0; i < 8U; i++) {
+        uint32_t v = (11U * i + UINT16_MAX) >> 2;
+        ok = ok && (heatmap[i] == (uint16_t)((v > UINT16_MAX) ? UINT16_MAX : v));
+    }
+    Sim_check(ok && (Doa_getShift(3U) == 2U) && (Doa_getShift(64U) == 6U),
+              "chirp sums are shifted by ceil(log2(chirps)) and saturated");
+}
+
+static void Sim_testInit(void) {
+    Doa_Config cfg;
+    int ok;
+
+    Sim_initConfig(&cfg, 1);
+    ok = (Doa_init(&cfg) == 0) && (cfg.numAzimuthCols == 4U) && (cfg.numAzimuthAnt == 4U) && (cfg.elevationEn == 1U) &&
+         (cfg.azimuthAnt[0] == 0U) && (cfg.azimuthAnt[1] == 1U) && (cfg.azimuthAnt[2] == 3U) && (cfg.azimuthAnt[3] == 4U);
+    Sim_check(ok, "geometry of doa_proc.h: 4 azimuth columns, elevation enabled, column map");
+
+    Sim_initConfig(&cfg, 1);
+    cfg.antRow[2] = 0U;
+    ok = (Doa_init(&cfg) == -1);
+    Sim_initConfig(&cfg, 1);
+    cfg.antCol[0] = DOAPROC_AZIMUTH_FFT_SIZE;
+    ok = ok && (Doa_init(&cfg) == -1);
+    Sim_initConfig(&cfg, 1);
+    cfg.antRow[0] = 2U;
+    ok = ok && (Doa_init(&cfg) == -1);
+    Sim_initConfig(&cfg, 1);
+    cfg.azimuthFftSize = 24U;
+    ok = ok && (Doa_init(&cfg) == -1);
+    Sim_initConfig(&cfg, 1);
+    cfg.dopplerFftSize = 32U;
+    ok = ok && (Doa_init(&cfg) == -1);
+    Sim_initConfig(&cfg, 1);
+    memset(cfg.antRow, 1, sizeof(cfg.antRow));
+    ok = ok && (Doa_init(&cfg) == -1);
+    Sim_check(ok, "two antennas in a column, column past the FFT, unknown row, FFT size, Doppler size and "
+                  "no azimuth row are rejected");
+}
+
+static void Sim_benchmark(int16_t *cube) {
+    Doa_Config cfg;
+    Doa_Estimate est;
+    uint16_t heatmap[SIM_NUM_RANGE_BINS * DOA_MAX_AZIMUTH_FFT_SIZE];
+    struct timespec t0, t1, t2;
+    uint32_t i, iterations = 1000U;
+
+    Sim_initConfig(&cfg, 1);
+    (void)Doa_init(&cfg);
+    Sim_fillCube(cube, &cfg, 20.0, 10.0);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        Doa_estimate(&cfg, cube, SIM_TARGET_BIN, SIM_TARGET_DOPPLER, &est);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (i = 0; i < 20U; i++) {
+        (void)Doa_computeHeatmap(&cfg, cube, heatmap);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    printf("\nbenchmark, %u x %u x %u cube: %.2f us per estimate, heatmap model in %.0f us\n", SIM_NUM_RANGE_BINS,
+           SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS,
+           ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations,
+           ((double)(t2.tv_sec - t1.tv_sec) * 1e6 + (double)(t2.tv_nsec - t1.tv_nsec) * 1e-3) / 20.0);
+}
+
+int main(void) {
+    int16_t *cube = malloc(4U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS);
+
+    Sim_testEstimates(cube);
+    Sim_testHeatmap(cube);
+    Sim_testSumChirps();
+    Sim_testInit();
+    Sim_benchmark(cube);
+
+    free(cube);
+    return Sim_result();
+}
@@ -0,0 +1,268 @@
+"""
+Host test of the feasibility model of chirp_config_to_defines.py (evaluate_feasibility(),
+suggest_feasible()) and of the limits it reads from budget_limits.h.
+
+Checks that read_budget_limits() evaluates budget_limits.h to the values of
+the firmware and rejects every expression which is not a plain C integer
+expression. Then evaluates a matrix of profiles derived from
+profiles/default.cfg (ADC samples, bursts, chirps per burst, accumulation,
+frame period, TX antennas, burst period) and compares the violations and the
+derived values (cube size, SPI time, L3 headroom, max. frame rate, duty
+cycles) with an independent model. Profiles without a chirp timing violation
+must compile with the generated budget.h exactly when they are feasible, for
+every infeasible profile the suggested profiles must be feasible, change only
+the reported parameters and come nearest first. Finally runs the script with
+-o and --check and checks that the budget_limits.h of the output directory is
+used if there is one. Exits with 1 if a check fails.
+
+Run (from the repo root, CC selects the compiler, default gcc):
+
+    python3 scripts/feasibility_sim.py
+"""
+import concurrent.futures
+import itertools
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import chirp_config_to_defines as gen
+
+REPO_ROOT   = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCRIPT      = os.path.join(REPO_ROOT, 'scripts', 'chirp_config_to_defines.py')
+INCLUDE_DIR = os.path.join(REPO_ROOT, 'minimal_rangeproc_impl', 'include')
+BASE_CFG    = os.path.join(REPO_ROOT, 'profiles', 'default.cfg')
+CC          = os.environ.get('CC', 'gcc')
+
+# values of budget_limits.h, evaluated by hand
+LIMITS = {'L3_MEM_SIZE': 0x40000 + 160 * 1024, 'MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE': 28 * 1024,
+          'MAX_SPI_TRANSFER_SIZE': 65280, 'BYTES_PER_FRAME': 4, 'SPI_SCLK_HZ': 30000000}
+
+# plain integer expressions (with A = 10 defined before) and their values in C
+EXPRESSIONS = {'(0x40000 + 160*1024)': 0x40000 + 160 * 1024, '((8U+6U+4U+2U+8U) * 1024U)': 28672,
+               '(A/3U)': 3, '-7/2': -3, '7/-2': -3, '-(A - 12) * 2': 4, '010': 8, '0x1Fu': 31}
+
+# expressions read_budget_limits() must not evaluate
+REJECTED = ['__import__("os").getpid()', '2**10', '1 << 4', 'A if A else 0', '1.5', 'sizeof(int)', 'B',
+            '(1 + 2', '1 +', '3 4', '1/0', '12abc', '"x"', '[1][0]']
+
+# profile matrix: numOfAdcSamples, numOfBurstsInFrame, numOfChirpsInBurst, numOfChirpsAccum,
+# framePeriodicity (ms), txChCtrlBitMask, burstPeriodicity (us)
+MATRIX = list(itertools.product((64, 100, 128, 256, 512), (16, 64, 128, 256), (2, 4, 6), (0, 2), (50, 100, 200),
+                                (3, 1), (60, 403)))
+
+num_failed = 0
+
+
+def check(ok, what):
+    global num_failed
+    print(f"{'pass' if ok else 'FAIL'}: {what}")
+    if not ok:
+        num_failed += 1
+
+
+def profile(base, n_adc, bursts, cpb, accum, frame_ms, tx, burst_us):
+    """
+    Copy of the base configuration with the parameters of a matrix entry
+    """
+    data = {cmd: dict(params) for cmd, params in base.items()}
+    data['chirpComnCfg']['numOfAdcSamples'] = str(n_adc)
+    data['frameCfg']['numOfBurstsInFrame']  = str(bursts)
+    data['frameCfg']['numOfChirpsInBurst']  = str(cpb)
+    data['frameCfg']['numOfChirpsAccum']    = str(accum)
+    data['frameCfg']['framePeriodicity']    = str(frame_ms)
+    data['channelCfg']['txChCtrlBitMask']   = str(tx)
+    data['frameCfg']['burstPeriodicity']    = str(burst_us)
+    return data
+
+
+def write_limits(path, replace):
+    """
+    Copy of budget_limits.h with the values of some macros replaced
+    """
+    with open(os.path.join(INCLUDE_DIR, gen.BUDGET_LIMITS_HEADER_NAME), 'r') as f:
+        text = f.read()
+    for macro, value in replace.items():
+        text = re.sub(rf'(#define\s+{macro}\s+).*', rf'\g<1>{value}', text)
+    with open(path, 'w') as f:
+        f.write(text)
+
+
+def test_limits(tmp_dir):
+    limits = gen.read_budget_limits(os.path.join(INCLUDE_DIR, gen.BUDGET_LIMITS_HEADER_NAME))
+    check(all(limits.get(name) == value for name, value in LIMITS.items()),
+          f"{gen.BUDGET_LIMITS_HEADER_NAME} evaluates to the limits of the firmware")
+
+    wrong = {e: gen.eval_limit_expr(e, {'A': 10}) for e in EXPRESSIONS}
+    wrong = {e: v for e, v in wrong.items() if v != EXPRESSIONS[e]}
+    check(not wrong, f"{len(EXPRESSIONS)} constant expressions evaluate as in C" + (f": {wrong}" if wrong else ''))
+
+    accepted = []
+    for expr in REJECTED:
+        try:
+            accepted.append((expr, gen.eval_limit_expr(expr, {'A': 10})))
+        except ValueError:
+            pass
+    check(not accepted, f"{len(REJECTED)} other expressions are rejected" + (f", not {accepted}" if accepted else ''))
+
+    # a required limit which is no plain integer expression is an error, not a missing or evaluated limit
+    path = os.path.join(tmp_dir, gen.BUDGET_LIMITS_HEADER_NAME)
+    write_limits(path, {'SPI_SCLK_HZ': '(__import__("os").getpid())'})
+    try:
+        gen.read_budget_limits(path)
+        error = ''
+    except ValueError as e:
+        error = str(e)
+    check('SPI_SCLK_HZ' in error and 'unsupported' in error, f"required limit with a call is rejected ({error})")
+
+
+def expected(limits, chirp_us, n_rx, n_adc, bursts, cpb, accum, frame_ms, tx, burst_us):
+    """
+    Independent model: the violated checks and, if the cube can be derived, its size and SPI time
+    """
+    n_tx = bin(tx).count('1')
+    accum = max(accum, 1)
+    reasons = set()
+    if cpb * chirp_us > burst_us:
+        reasons.add('burst')
+    if burst_us * bursts > frame_ms * 1000:
+        reasons.add('frame')
+    if cpb % accum or (cpb // accum) % n_tx:
+        reasons.add('accum')
+        return reasons, None, None
+    n_bins = 1
+    while n_bins < n_adc:
+        n_bins *= 2
+    cube = (n_bins // 2) * n_tx * n_rx * ((cpb // accum) * bursts // n_tx) * 4
+    spi_us = -(-cube * 8 * 1000000 // limits['SPI_SCLK_HZ'])
+    if cube > limits['L3_MEM_SIZE']:
+        reasons.add('L3')
+    if burst_us * bursts <= frame_ms * 1000 < burst_us * bursts + spi_us:
+        reasons.add('spi')
+    return reasons, cube, spi_us
+
+
+def compile_budget(data, header):
+    """
+    Generates and compiles budget.h, returns True if it compiles
+    """
+    os.makedirs(os.path.dirname(header))
+    gen.generate_budget_file(data, 'feasibility_sim.py', 'matrix', header)
+    cmd = [CC, '-std=c11', '-fsyntax-only', f'-I{INCLUDE_DIR}', '-x', 'c', header]
+    return subprocess.run(cmd, capture_output=True).returncode == 0
+
+
+def test_matrix(base, tmp_dir):
+    limits = gen.read_budget_limits(os.path.join(INCLUDE_DIR, gen.BUDGET_LIMITS_HEADER_NAME))
+    chirp_us = float(base['chirpTimingCfg']['chirpIdleTime']) + float(base['chirpComnCfg']['chirpRampEndTime'])
+    n_rx = bin(int(base['channelCfg']['rxChCtrlBitMask'])).count('1')
+
+    def run(idx_entry):
+        idx, entry = idx_entry
+        data = profile(base, *entry)
+        model = gen.evaluate_feasibility(data, limits)
+        reasons, cube, spi_us = expected(limits, chirp_us, n_rx, *entry)
+        n_bursts, cpb, frame_ms, burst_us = entry[1], entry[2], entry[4], entry[6]
+        values_ok = True
+        if cube is not None:
+            values_ok = (model['cube_bytes'] == cube and model['spi_us'] == spi_us and
+                         model['l3_headroom'] == limits['L3_MEM_SIZE'] - cube and
+                         abs(model['max_frame_rate'] - 1e6 / (burst_us * n_bursts + spi_us)) < 1e-9 and
+                         abs(model['active_duty'] - burst_us * n_bursts / (frame_ms * 1000)) < 1e-12 and
+                         abs(model['rf_duty'] - cpb * chirp_us * n_bursts / (frame_ms * 1000)) < 1e-12)
+
+        # without the chirp timing the verdict is the one of the generated budget.h
+        compile_ok = True
+        if 'burst' not in reasons:
+            header = os.path.join(tmp_dir, f'matrix_{idx}', gen.BUDGET_HEADER_NAME)
+            compile_ok = compile_budget(data, header) == (not reasons)
+
+        suggestions_ok, num_suggestions = True, 0
+        if reasons:
+            suggestions = gen.suggest_feasible(data, limits)
+            num_suggestions = len(suggestions)
+            suggestions_ok = num_suggestions > 0
+            for changes in suggestions:
+                changed = data
+                for cmd, param, old, new in changes:
+                    suggestions_ok = suggestions_ok and float(data[cmd][param]) == old and old != new
+                    changed = gen._with_param(changed, cmd, param, new)
+                suggestions_ok = suggestions_ok and not gen.evaluate_feasibility(changed, limits)['violations']
+            keys = [sum(gen._relative_change(old, new) for _, _, old, new in changes) for changes in suggestions]
+            suggestions_ok = suggestions_ok and keys == sorted(keys)
+        return (entry, reasons, len(model['violations']) == len(reasons), values_ok, compile_ok, suggestions_ok,
+                num_suggestions)
+
+    counts = {}
+    failed = {'violations': [], 'values': [], 'budget.h': [], 'suggestions': []}
+    num_suggestions = 0
+    with concurrent.futures.ThreadPoolExecutor(max_workers=os.cpu_count()) as pool:
+        for entry, reasons, *oks, num in pool.map(run, enumerate(MATRIX)):
+            for key, ok in zip(failed, oks):
+                if not ok:
+                    failed[key].append((entry, sorted(reasons)))
+            key = '+'.join(sorted(reasons)) or 'ok'
+            counts[key] = counts.get(key, 0) + 1
+            num_suggestions += num
+    for key, entries in failed.items():
+        for entry, reasons in entries[:5]:
+            print(f"      {key} {entry}: expected {reasons}")
+
+    summary = ', '.join(f'{k} {v}' for k, v in sorted(counts.items()))
+    check(not failed['violations'], f"{len(MATRIX)} profiles violate the checks of the reference model ({summary})")
+    check(all(any(k in key.split('+') for key in counts) for k in ('ok', 'burst', 'frame', 'accum', 'L3', 'spi')),
+          "the matrix has feasible profiles and profiles violating each check")
+    check(not failed['values'], "cube size, SPI time, L3 headroom, max. frame rate and duty cycles")
+    check(not failed['budget.h'], f"generated {gen.BUDGET_HEADER_NAME} compiles exactly for the feasible profiles")
+    check(not failed['suggestions'],
+          f"{num_suggestions} suggested profiles are feasible, change the reported parameters, nearest first")
+
+
+def run_script(*args):
+    """
+    Runs chirp_config_to_defines.py, returns the exit code and output
+    """
+    result = subprocess.run([sys.executable, SCRIPT, BASE_CFG] + list(args), capture_output=True, text=True,
+                            stdin=subprocess.DEVNULL)
+    return result.returncode, result.stdout
+
+
+def test_output_limits(tmp_dir):
+    limits_dir = os.path.join(tmp_dir, 'limits')
+    empty_dir = os.path.join(tmp_dir, 'empty')
+    os.makedirs(limits_dir)
+    os.makedirs(empty_dir)
+    write_limits(os.path.join(limits_dir, gen.BUDGET_LIMITS_HEADER_NAME), {'L3_MEM_SIZE': '(16U * 1024U)'})
+
+    code, output = run_script('--check')
+    check(code == 0, "default.cfg is feasible with the limits of the repo")
+    code, output = run_script('-o', limits_dir, '--check')
+    check(code == 1 and 'exceeds L3_MEM_SIZE 16384 bytes' in output,
+          "-o <directory>: the budget_limits.h of the output directory is used")
+    code, output = run_script('-o', os.path.join(limits_dir, gen.DEFINES_HEADER_NAME))
+    check(code == 1 and not os.path.exists(os.path.join(limits_dir, gen.DEFINES_HEADER_NAME)),
+          "-o <file>: the budget_limits.h next to it is used, nothing is written")
+    code, output = run_script('-o', empty_dir, '--check')
+    check(code == 0, "-o <directory> without budget_limits.h: the limits of the repo are used")
+
+
+def main():
+    base = gen.parse_config_file(BASE_CFG)
+
+    tmp_dir = tempfile.mkdtemp(prefix='feasibility_sim_')
+    try:
+        test_limits(tmp_dir)
+        test_matrix(base, tmp_dir)
+        test_output_limits(tmp_dir)
+    finally:
+        shutil.rmtree(tmp_dir)
+
+    print(f"\n{'ok' if num_failed == 0 else 'FAILED'}: {num_failed} check(s) failed")
+    sys.exit(0 if num_failed == 0 else 1)
+
+
+if __name__ == '__main__':
+    main()
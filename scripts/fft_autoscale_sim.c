@@ -0,0 +1,228 @@
+/**
+ * @file fft_autoscale_sim.c
+ * @brief Host test of the closed-loop range FFT scaling (fft_autoscale.h) with synthetic amplitude ramps.
+ *
+ * Runs the controller in a loop with a synthetic range FFT: every frame the
+ * scene has an amplitude before scaling, the cube holds it shifted by the
+ * applied shift and clipped to 16 bits. Checks that the shift follows a rising
+ * ramp with one clipped frame per step, that it is lowered only after
+ * framesDown quiet frames on a falling ramp, that it does not toggle on a peak
+ * around the headroom threshold, that it stays within its limits, the split
+ * into HWA output shift and butterfly stages and the cube statistics. Then
+ * times the statistics pass on a cube of the default profile. Exits with 1 if
+ * a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o fft_autoscale_sim scripts/fft_autoscale_sim.c \
+ *         minimal_rangeproc_impl/src/fft_autoscale.c -lm
+ *     ./fft_autoscale_sim [-v]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fft_autoscale.h"
+#include "sim_check.h"
+
+/*! @brief Controller parameters of rangeproc_dpc.h (SDK header, not included here) */
+#define SIM_MAX_SHIFT           10U
+#define SIM_MAX_DIV_SHIFT       7U
+#define SIM_SAT_THRESHOLD       32767U
+#define SIM_SAT_COUNT_UP        1U
+#define SIM_HEADROOM_LOW        16384U
+#define SIM_FRAMES_DOWN         8U
+#define SIM_INITIAL_SHIFT       2U
+
+/*! @brief I/Q values of the cube of the default profile (64 range bins x 6 antennas x 64 chirps) */
+#define SIM_NUM_VALUES          (2U * 64U * 384U)
+
+static int gVerbose = 0;
+
+/**
+ * @brief Range FFT output of a scene with peak amplitude amp, scaled by 2^-shift and clipped to 16 bits.
+ */
+static void Sim_rangeFft(int16_t *cube, uint32_t numValues, double amp, uint8_t shift) {
+    uint32_t i;
+
+    for (i = 0; i < numValues; i++) {
+        /* peak of the pattern is 1 at i % 7 == 6 */
+        double v = amp * (double)((int32_t)(i % 7U) - 3) / 3.0 / (double)(1U << shift);
+        v = (v > 32767.0) ? 32767.0 : ((v < -32768.0) ? -32768.0 : v);
+        cube[i] = (int16_t)lrint(v);
+    }
+}
+
+/**
+ * @brief Runs one frame, returns 1 if the cube of the frame saturated.
+ */
+static int Sim_frame(const FftAutoScale_Config *cfg, FftAutoScale_State *state, int16_t *cube, double amp,
+                     uint32_t frameIdx, int *changed) {
+    FftAutoScale_Stats stats;
+    uint8_t applied = state->shift;
+
+    Sim_rangeFft(cube, 256U, amp, applied);
+    FftAutoScale_computeStats(cube, 256U, cfg->satThreshold, &stats);
+    *changed = FftAutoScale_update(cfg, state, &stats);
+    if (gVerbose) {
+        printf("  frame %3u: amplitude %9.0f, shift %2u, peak %5u, %3u saturated%s\n", frameIdx, amp, applied,
+               stats.peak, stats.numSaturated, *changed ? " -> changed" : "");
+    }
+    return (stats.numSaturated > 0U) ? 1 : 0;
+}
+
+/**
+ * @brief Smallest shift at which a scene of amplitude amp does not saturate.
+ */
+static uint8_t Sim_idealShift(double amp) {
+    uint8_t shift = 0;
+
+    while ((amp / (double)(1U << shift) >= (double)SIM_SAT_THRESHOLD - 0.5) && (shift < SIM_MAX_SHIFT)) {
+        shift++;
+    }
+    return shift;
+}
+
+static void Sim_testRamps(const FftAutoScale_Config *cfg, int16_t *cube) {
+    FftAutoScale_State state;
+    uint32_t frameIdx = 0, step, i;
+    uint32_t numSaturated = 0, numSteps = 0;
+    uint32_t firstQuiet = 0, firstDown = 0;
+    int changed, settled = 1;
+    double amp = 0.0;
+    char msg[160];
+
+    FftAutoScale_init(cfg, &state, SIM_INITIAL_SHIFT);
+
+    /* rising ramp: the amplitude doubles every 4 frames from 80000 up to 80000 * 2^6 */
+    for (step = 0; step <= 6U; step++) {
+        amp = 80000.0 * (double)(1U << step);
+        numSteps += (Sim_idealShift(amp) > state.shift) ? 1U : 0U;
+        for (i = 0; i < 4U; i++) {
+            numSaturated += (uint32_t)Sim_frame(cfg, &state, cube, amp, frameIdx++, &changed);
+        }
+        settled = settled && (state.shift == Sim_idealShift(amp));
+    }
+    snprintf(msg, sizeof(msg), "rising ramp: %u clipped frames for %u shift steps", numSaturated, numSteps);
+    Sim_check(numSaturated == numSteps, msg);
+    Sim_check(settled, "rising ramp: the shift settles at the smallest one without clipping within a step");
+
+    /* falling ramp: the scene drops to 1/8, the shift comes down one bit per framesDown frames */
+    amp /= 8.0;
+    for (i = 0; i < 64U; i++) {
+        (void)Sim_frame(cfg, &state, cube, amp, frameIdx, &changed);
+        if ((firstQuiet == 0U) && (amp / (double)(1U << state.shift) < SIM_HEADROOM_LOW)) {
+            firstQuiet = frameIdx;
+        }
+        if ((firstDown == 0U) && changed) {
+            firstDown = frameIdx;
+        }
+        frameIdx++;
+    }
+    snprintf(msg, sizeof(msg), "falling ramp: first decrease after %u quiet frames (framesDown %u)",
+             firstDown - firstQuiet + 1U, SIM_FRAMES_DOWN);
+    Sim_check(firstDown - firstQuiet + 1U == SIM_FRAMES_DOWN, msg);
+    snprintf(msg, sizeof(msg), "falling ramp: the shift settles at %u with the peak in the upper half", state.shift);
+    Sim_check((amp / (double)(1U << state.shift) >= SIM_HEADROOM_LOW) &&
+              (amp / (double)(1U << state.shift) < SIM_SAT_THRESHOLD), msg);
+}
+
+static void Sim_testNoToggle(const FftAutoScale_Config *cfg, int16_t *cube) {
+    FftAutoScale_State state;
+    uint32_t numChanges = 0, i;
+    int changed;
+
+    /* peak alternates just below and above the headroom threshold */
+    FftAutoScale_init(cfg, &state, 3U);
+    for (i = 0; i < 100U; i++) {
+        double amp = 8.0 * ((i & 1U) ? 16600.0 : 16200.0);
+        (void)Sim_frame(cfg, &state, cube, amp, i, &changed);
+        numChanges += (uint32_t)changed;
+    }
+    Sim_check(numChanges == 0U, "no shift change on a peak around the headroom threshold");
+}
+
+static void Sim_testLimits(const FftAutoScale_Config *cfg, int16_t *cube) {
+    FftAutoScale_State state;
+    uint32_t i, numChanges = 0;
+    int changed;
+
+    FftAutoScale_init(cfg, &state, 200U);
+    Sim_check(state.shift == SIM_MAX_SHIFT, "initial shift is clipped to maxShift");
+    for (i = 0; i < 20U; i++) {
+        (void)Sim_frame(cfg, &state, cube, 1e9, i, &changed);
+        numChanges += (uint32_t)changed;
+    }
+    Sim_check((state.shift == SIM_MAX_SHIFT) && (numChanges == 0U), "saturation at maxShift reports no change");
+    for (i = 0; i < 200U; i++) {
+        (void)Sim_frame(cfg, &state, cube, 10.0, i, &changed);
+    }
+    Sim_check(state.shift == cfg->minShift, "a quiet scene brings the shift down to minShift and not below");
+}
+
+static void Sim_testSplit(const FftAutoScale_Config *cfg) {
+    uint8_t shift, divShift, numStages;
+    int ok = 1;
+
+    for (shift = 0; shift <= SIM_MAX_SHIFT; shift++) {
+        FftAutoScale_splitShift(cfg, shift, &divShift, &numStages);
+        ok = ok && (divShift + numStages == shift) && (divShift <= SIM_MAX_DIV_SHIFT) &&
+             ((numStages == 0U) || (divShift == SIM_MAX_DIV_SHIFT));
+    }
+    Sim_check(ok, "split shift: output shift first, butterfly stages for the rest");
+}
+
+static void Sim_testStats(void) {
+    int16_t cube[6] = { 0, 32767, -32768, -5, 12, -32767 };
+    FftAutoScale_Stats stats;
+
+    FftAutoScale_computeStats(cube, 6U, SIM_SAT_THRESHOLD, &stats);
+    Sim_check((stats.peak == 32768U) && (stats.numSaturated == 3U), "statistics: -32768 is the peak, 3 saturated");
+}
+
+static void Sim_benchmark(const FftAutoScale_Config *cfg) {
+    int16_t *cube = malloc(SIM_NUM_VALUES * sizeof(int16_t));
+    FftAutoScale_Stats stats;
+    struct timespec t0, t1;
+    uint32_t i, iterations = 1000U;
+    double us;
+
+    Sim_rangeFft(cube, SIM_NUM_VALUES, 40000.0, 1U);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        FftAutoScale_computeStats(cube, SIM_NUM_VALUES, cfg->satThreshold, &stats);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    us = ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations;
+    printf("\nbenchmark: statistics of %u values in %.1f us (peak %u, %u saturated)\n", SIM_NUM_VALUES, us,
+           stats.peak, stats.numSaturated);
+    free(cube);
+}
+
+int main(int argc, char **argv) {
+    FftAutoScale_Config cfg;
+    int16_t cube[256];
+
+    gVerbose = (argc > 1) && (strcmp(argv[1], "-v") == 0);
+
+    cfg.minShift     = 0U;
+    cfg.maxShift     = SIM_MAX_SHIFT;
+    cfg.maxDivShift  = SIM_MAX_DIV_SHIFT;
+    cfg.satThreshold = SIM_SAT_THRESHOLD;
+    cfg.satCountUp   = SIM_SAT_COUNT_UP;
+    cfg.headroomLow  = SIM_HEADROOM_LOW;
+    cfg.framesDown   = SIM_FRAMES_DOWN;
+
+    Sim_testRamps(&cfg, cube);
+    Sim_testNoToggle(&cfg, cube);
+    Sim_testLimits(&cfg, cube);
+    Sim_testSplit(&cfg);
+    Sim_testStats();
+    Sim_benchmark(&cfg);
+
+    return Sim_result();
+}
@@ -0,0 +1,281 @@
+/**
+ * @file mem_pool_sim.c
+ * @brief Host test and microbenchmark of the memory pool with checkpoints and tags (mem_pool.h).
+ *
+ * Checks allocation, alignment and exhaustion, nested checkpoints (rewind
+ * keeps the scope open, pop closes it, scopes nested in it are dropped, the
+ * innermost of equally named checkpoints is taken), the tag log (usage per
+ * tag, entries released by a rewind, overflow counted in numTagsDropped) and
+ * the reset. Then replays a long random sequence of allocations, pushes,
+ * rewinds and pops against a reference model of the pool. Finally times
+ * untagged and tagged allocations and a push/alloc/pop scope. Exits with 1 if
+ * a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o mem_pool_sim scripts/mem_pool_sim.c \
+ *         minimal_rangeproc_impl/src/mem_pool.c
+ *     ./mem_pool_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem_pool.h"
+#include "sim_check.h"
+
+/*! @brief Size of the simulated pool */
+#define SIM_POOL_SIZE           4096U
+
+/*! @brief Operations of the random sequence */
+#define SIM_NUM_OPERATIONS      200000U
+
+/*! @brief Iterations of the benchmark */
+#define SIM_NUM_ITERATIONS      10000000U
+
+static uint8_t gMem[SIM_POOL_SIZE] __attribute__((aligned(64)));
+
+static const char *gNames[] = { "pipeline", "stage", "cube", "doppler" };
+
+static void Sim_initPool(MemPoolObj *pool) {
+    memset(pool, 0, sizeof(MemPoolObj));
+    pool->cfg.addr = gMem;
+    pool->cfg.size = sizeof(gMem);
+    DPC_ObjDet_MemPoolReset(pool);
+}
+
+static void Sim_testAlloc(void) {
+    MemPoolObj pool;
+    uint32_t align, offset;
+    uint8_t *p;
+    int ok = 1;
+
+    Sim_initPool(&pool);
+    ok = (DPC_ObjDet_MemPoolAlloc(&pool, 10U, 4U) == gMem) && (DPC_ObjDet_MemPoolGetFree(&pool) == 4086U) &&
+         (DPC_ObjDet_MemPoolAlloc(&pool, 0U, 1U) == gMem + 10);
+    Sim_check(ok, "first allocation at the pool start, free bytes counted without padding");
+
+    for (align = 1U; align <= 64U; align <<= 1) {
+        for (offset = 0; offset < 2U * align; offset++) {
+            DPC_ObjDet_MemPoolReset(&pool);
+            (void)DPC_ObjDet_MemPoolAlloc(&pool, offset, 1U);
+            p = DPC_ObjDet_MemPoolAlloc(&pool, 8U, (uint8_t)align);
+            ok = ok && (p != NULL) && (((uintptr_t)p % align) == 0U) && (p >= gMem + offset) &&
+                 (p < gMem + offset + align);
+        }
+    }
+    Sim_check(ok, "allocations aligned to 1..64 bytes with the least padding");
+
+    DPC_ObjDet_MemPoolReset(&pool);
+    (void)DPC_ObjDet_MemPoolAlloc(&pool, 1U, 1U);
+    ok = (DPC_ObjDet_MemPoolAlloc(&pool, SIM_POOL_SIZE - 4U, 4U) == gMem + 4) &&
+         (DPC_ObjDet_MemPoolGetFree(&pool) == 0U) && (DPC_ObjDet_MemPoolAlloc(&pool, 1U, 1U) == NULL);
+    DPC_ObjDet_MemPoolReset(&pool);
+    (void)DPC_ObjDet_MemPoolAlloc(&pool, 1U, 1U);
+    ok = ok && (DPC_ObjDet_MemPoolAlloc(&pool, SIM_POOL_SIZE - 3U, 4U) == NULL) &&
+         (DPC_ObjDet_MemPoolGet(&pool) == gMem + 1);
+    Sim_check(ok, "exact fit after padding succeeds, one byte more fails and leaves the pool unchanged");
+}
+
+static void Sim_testCheckpoints(void) {
+    MemPoolObj pool;
+    void *cube, *doppler;
+    uint32_t i;
+    int ok;
+
+    Sim_initPool(&pool);
+    (void)DPC_ObjDet_MemPoolAlloc(&pool, 10U, 4U);
+    ok = (DPC_ObjDet_MemPoolPushCheckpoint(&pool, "pipeline") == 0);
+    cube = DPC_ObjDet_MemPoolAllocTagged(&pool, 100U, 8U, "cube");
+    ok = ok && (cube == gMem + 16) && (DPC_ObjDet_MemPoolPushCheckpoint(&pool, "stage") == 0);
+    doppler = DPC_ObjDet_MemPoolAllocTagged(&pool, 200U, 4U, "doppler");
+    ok = ok && (DPC_ObjDet_MemPoolGetTagUsage(&pool, "doppler") == 200U) && (pool.numTags == 2U);
+    ok = ok && (DPC_ObjDet_MemPoolPopCheckpoint(&pool, "stage") == 0) &&
+         (DPC_ObjDet_MemPoolGet(&pool) == gMem + 116) && (pool.numTags == 1U) && (pool.numCheckpoints == 1U) &&
+         (DPC_ObjDet_MemPoolGetTagUsage(&pool, "doppler") == 0U);
+    Sim_check(ok, "pop releases the allocations and tags of the inner scope and closes it");
+
+    ok = (DPC_ObjDet_MemPoolAllocTagged(&pool, 200U, 4U, "doppler") == doppler) &&
+         (DPC_ObjDet_MemPoolPushCheckpoint(&pool, "stage") == 0) &&
+         (DPC_ObjDet_MemPoolRewind(&pool, "pipeline") == 0) && (DPC_ObjDet_MemPoolGet(&pool) == gMem + 10) &&
+         (pool.numTags == 0U) && (pool.numCheckpoints == 1U) &&
+         (DPC_ObjDet_MemPoolAllocTagged(&pool, 50U, 8U, "cube") == cube);
+    Sim_check(ok, "rewind of the outer scope drops the inner one, keeps the outer open and reuses the memory");
+
+    ok = (DPC_ObjDet_MemPoolRewind(&pool, "stage") == -1) && (DPC_ObjDet_MemPoolPopCheckpoint(&pool, "none") == -1) &&
+         (DPC_ObjDet_MemPoolGetMaxUsage(&pool) == 316U);
+    Sim_check(ok, "unknown or closed checkpoints are rejected, the maximum usage survives rewinds");
+
+    for (i = 1; i < MEM_POOL_MAX_CHECKPOINTS; i++) {
+        (void)DPC_ObjDet_MemPoolAlloc(&pool, 4U, 4U);
+        ok = ok && (DPC_ObjDet_MemPoolPushCheckpoint(&pool, "nested") == 0);
+    }
+    ok = ok && (DPC_ObjDet_MemPoolPushCheckpoint(&pool, "nested") == -1) &&
+         (DPC_ObjDet_MemPoolRewind(&pool, "nested") == 0) && (pool.numCheckpoints == MEM_POOL_MAX_CHECKPOINTS) &&
+         (DPC_ObjDet_MemPoolPopCheckpoint(&pool, "pipeline") == 0) && (pool.numCheckpoints == 0U) &&
+         (DPC_ObjDet_MemPoolGet(&pool) == gMem + 10);
+    Sim_check(ok, "MEM_POOL_MAX_CHECKPOINTS scopes nest, equal names resolve to the innermost");
+}
+
+static void Sim_testTags(void) {
+    MemPoolObj pool;
+    uint32_t i;
+    int ok = 1;
+
+    Sim_initPool(&pool);
+    (void)DPC_ObjDet_MemPoolAllocTagged(&pool, 64U, 4U, "cube");
+    (void)DPC_ObjDet_MemPoolAlloc(&pool, 8U, 4U);
+    (void)DPC_ObjDet_MemPoolAllocTagged(&pool, 32U, 4U, "window");
+    (void)DPC_ObjDet_MemPoolAllocTagged(&pool, 16U, 4U, "cube");
+    ok = (DPC_ObjDet_MemPoolGetTagUsage(&pool, "cube") == 80U) &&
+         (DPC_ObjDet_MemPoolGetTagUsage(&pool, "window") == 32U) &&
+         (DPC_ObjDet_MemPoolGetTagUsage(&pool, "none") == 0U) && (pool.numTags == 3U);
+    Sim_check(ok, "usage is summed per tag, untagged allocations are not logged");
+
+    DPC_ObjDet_MemPoolReset(&pool);
+    for (i = 0; i < MEM_POOL_MAX_TAGS + 3U; i++) {
+        ok = ok && (DPC_ObjDet_MemPoolAllocTagged(&pool, 4U, 4U, "t") != NULL);
+    }
+    ok = ok && (pool.numTags == MEM_POOL_MAX_TAGS) && (pool.numTagsDropped == 3U) &&
+         (DPC_ObjDet_MemPoolGetFree(&pool) == SIM_POOL_SIZE - 4U * (MEM_POOL_MAX_TAGS + 3U));
+    Sim_check(ok, "allocations beyond the tag log are made and counted as dropped");
+
+    DPC_ObjDet_MemPoolReset(&pool);
+    ok = (pool.numTags == 0U) && (pool.numTagsDropped == 0U) && (pool.numCheckpoints == 0U) &&
+         (DPC_ObjDet_MemPoolGet(&pool) == gMem);
+    Sim_check(ok, "reset drops tags, dropped count and checkpoints");
+}
+
+/**
+ * @brief Replays random operations against a reference model (offsets, checkpoint stack, tag sizes).
+ */
+static void Sim_testRandom(void) {
+    MemPoolObj pool;
+    uint32_t curr = 0, maxUsed = 0, numCp = 0, numTags = 0, op;
+    uint32_t cpAddr[MEM_POOL_MAX_CHECKPOINTS], cpTags[MEM_POOL_MAX_CHECKPOINTS];
+    const char *cpName[MEM_POOL_MAX_CHECKPOINTS];
+    const char *tagName[MEM_POOL_MAX_TAGS];
+    uint32_t tagSize[MEM_POOL_MAX_TAGS];
+    int ok = 1;
+    char msg[160];
+
+    Sim_initPool(&pool);
+    srand(11);
+    for (op = 0; (op < SIM_NUM_OPERATIONS) && ok; op++) {
+        const char *name = gNames[rand() % 4];
+        int kind = rand() % 10;
+        int32_t ret, idx = -1;
+        uint32_t i;
+
+        if (kind < 6) {
+            uint32_t size = (uint32_t)rand() % 300U;
+            uint32_t align = 1U << (rand() % 7);
+            uint32_t addr = (curr + align - 1U) & ~(align - 1U);
+            int tagged = rand() % 2;
+            uint8_t *p = DPC_ObjDet_MemPoolAllocTagged(&pool, size, (uint8_t)align, tagged ? name : NULL);
+
+            if (addr + size <= SIM_POOL_SIZE) {
+                ok = (p == gMem + addr);
+                curr = addr + size;
+                maxUsed = (curr > maxUsed) ? curr : maxUsed;
+                if (tagged && (numTags < MEM_POOL_MAX_TAGS)) {
+                    tagName[numTags] = name;
+                    tagSize[numTags] = size;
+                    numTags++;
+                }
+            } else {
+                ok = (p == NULL);
+            }
+        } else if (kind < 8) {
+            ret = DPC_ObjDet_MemPoolPushCheckpoint(&pool, name);
+            ok = (ret == ((numCp < MEM_POOL_MAX_CHECKPOINTS) ? 0 : -1));
+            if (ret == 0) {
+                cpName[numCp] = name;
+                cpAddr[numCp] = curr;
+                cpTags[numCp] = numTags;
+                numCp++;
+            }
+        } else {
+            for (i = numCp; i > 0U; i--) {
+                if (strcmp(cpName[i - 1U], name) == 0) {
+                    idx = (int32_t)(i - 1U);
+                    break;
+                }
+            }
+            ret = (kind == 8) ? DPC_ObjDet_MemPoolRewind(&pool, name) : DPC_ObjDet_MemPoolPopCheckpoint(&pool, name);
+            ok = (ret == ((idx >= 0) ? 0 : -1));
+            if (idx >= 0) {
+                curr = cpAddr[idx];
+                numTags = cpTags[idx];
+                numCp = (uint32_t)idx + ((kind == 8) ? 1U : 0U);
+            }
+        }
+        ok = ok && (DPC_ObjDet_MemPoolGet(&pool) == gMem + curr) && (pool.numCheckpoints == numCp) &&
+             (pool.numTags == numTags) && (DPC_ObjDet_MemPoolGetMaxUsage(&pool) == maxUsed) &&
+             (DPC_ObjDet_MemPoolGetFree(&pool) == SIM_POOL_SIZE - curr);
+        for (i = 0; (i < 4U) && ok; i++) {
+            uint32_t j, usage = 0;
+
+            for (j = 0; j < numTags; j++) {
+                usage += (strcmp(tagName[j], gNames[i]) == 0) ? tagSize[j] : 0U;
+            }
+            ok = (DPC_ObjDet_MemPoolGetTagUsage(&pool, gNames[i]) == usage);
+        }
+    }
+    snprintf(msg, sizeof(msg), "%u random allocations, pushes, rewinds and pops match the reference model", op);
+    Sim_check(ok, msg);
+}
+
+static void Sim_benchmark(void) {
+    MemPoolObj pool;
+    volatile uintptr_t sink = 0;
+    uint32_t i;
+    double t0, tAlloc, tTagged, tScope;
+
+    Sim_initPool(&pool);
+    (void)DPC_ObjDet_MemPoolPushCheckpoint(&pool, "bench");
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        sink += (uintptr_t)DPC_ObjDet_MemPoolAlloc(&pool, 64U, 4U);
+        if ((i & 31U) == 31U) {
+            (void)DPC_ObjDet_MemPoolRewind(&pool, "bench");
+        }
+    }
+    tAlloc = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    (void)DPC_ObjDet_MemPoolRewind(&pool, "bench");
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        sink += (uintptr_t)DPC_ObjDet_MemPoolAllocTagged(&pool, 64U, 4U, "cube");
+        if ((i & 15U) == 15U) {
+            (void)DPC_ObjDet_MemPoolRewind(&pool, "bench");
+        }
+    }
+    tTagged = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        (void)DPC_ObjDet_MemPoolPushCheckpoint(&pool, "scope");
+        sink += (uintptr_t)DPC_ObjDet_MemPoolAllocTagged(&pool, 64U, 4U, "cube");
+        (void)DPC_ObjDet_MemPoolPopCheckpoint(&pool, "scope");
+    }
+    tScope = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    printf("\nbenchmark:\n");
+    printf("  untagged allocation (rewind every 32)   %6.2f ns\n", tAlloc);
+    printf("  tagged allocation (rewind every 16)     %6.2f ns\n", tTagged);
+    printf("  push, tagged allocation and pop         %6.2f ns\n", tScope);
+    (void)sink;
+}
+
+int main(void) {
+    Sim_testAlloc();
+    Sim_testCheckpoints();
+    Sim_testTags();
+    Sim_testRandom();
+    Sim_benchmark();
+
+    return Sim_result();
+}
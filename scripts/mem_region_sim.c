@@ -0,0 +1,260 @@
+/**
+ * @file mem_region_sim.c
+ * @brief Host test of the buffer placement across memory regions (mem_region.h).
+ *
+ * Builds the region map of mmwave_basic.c over mocked memories of the sizes in
+ * budget_limits.h (core local RAM, L3 and optionally the FECSS shared RAM) and
+ * checks the placement policies, the attribute filter, the alignment and size
+ * limits, the largest free region, checkpoints and rewinds across all regions
+ * and the usage report.
+ * Then places random buffers with random attributes and policies and compares
+ * every choice with a brute-force reference selection. Finally compares the
+ * largest radar cube that fits next to the SPI command slot and the stream
+ * records with and without the FECSS shared RAM region. Exits with 1 if a
+ * check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o mem_region_sim scripts/mem_region_sim.c \
+ *         minimal_rangeproc_impl/src/mem_region.c minimal_rangeproc_impl/src/mem_pool.c
+ *     ./mem_region_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "budget_limits.h"
+#include "mem_pool.h"
+#include "mem_region.h"
+#include "sim_check.h"
+
+/*! @brief Stream records and SPI command slot placed next to the cube */
+#define SIM_STREAM_BYTES        (64U * 1024U)
+#define SIM_CMD_SLOT_BYTES      64U
+
+/*! @brief Buffers of the random placement test */
+#define SIM_NUM_BUFFERS         100000U
+
+static uint8_t gCoreLocal[MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE] __attribute__((aligned(64)));
+static uint8_t gL3[L3_MEM_SIZE] __attribute__((aligned(64)));
+static uint8_t gFecssShram[FECSS_SHRAM_MEM_SIZE] __attribute__((aligned(64)));
+
+static MemPoolObj gCoreLocalPool;
+static MemPoolObj gL3Pool;
+static MemPoolObj gFecssShramPool;
+static MemRegion_Map gMap;
+
+/**
+ * @brief Region map of mmwave_basic.c, with or without the FECSS shared RAM.
+ */
+static void Sim_setup(int withFecssShram) {
+    memset(&gCoreLocalPool, 0, sizeof(MemPoolObj));
+    memset(&gL3Pool, 0, sizeof(MemPoolObj));
+    memset(&gFecssShramPool, 0, sizeof(MemPoolObj));
+    gCoreLocalPool.cfg.addr = gCoreLocal;
+    gCoreLocalPool.cfg.size = sizeof(gCoreLocal);
+    gL3Pool.cfg.addr = gL3;
+    gL3Pool.cfg.size = sizeof(gL3);
+    gFecssShramPool.cfg.addr = gFecssShram;
+    gFecssShramPool.cfg.size = sizeof(gFecssShram);
+
+    MemRegion_init(&gMap);
+    (void)MemRegion_add(&gMap, "Core local", &gCoreLocalPool, 0U, 0U);
+    (void)MemRegion_add(&gMap, "L3", &gL3Pool, MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA, 1U);
+    if (withFecssShram) {
+        (void)MemRegion_add(&gMap, "FECSS SHRAM", &gFecssShramPool, MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA, 1U);
+    }
+    MemRegion_reset(&gMap);
+}
+
+static void Sim_testPolicies(void) {
+    MemPoolObj empty;
+    int ok;
+
+    Sim_setup(1);
+    memset(&empty, 0, sizeof(empty));
+    ok = (gMap.numRegions == 3U) && (MemRegion_add(&gMap, "empty", &empty, 0U, 0U) == -1);
+    (void)MemRegion_add(&gMap, "spare", &gCoreLocalPool, 0U, 2U);
+    ok = ok && (MemRegion_add(&gMap, "full", &gCoreLocalPool, 0U, 2U) == -1);
+    Sim_check(ok, "empty pools and more than MEM_REGION_MAX_NUM regions are rejected");
+
+    Sim_setup(1);
+    ok = (MemRegion_select(&gMap, 100U, 4U, 0U, MEM_REGION_POLICY_FASTEST) == 0) &&
+         (MemRegion_select(&gMap, 100U, 4U, 0U, MEM_REGION_POLICY_LARGEST_FREE) == 1) &&
+         (MemRegion_select(&gMap, 100U, 4U, 0U, MEM_REGION_POLICY_FIRST_FIT) == 0) &&
+         (MemRegion_select(&gMap, 100U, 4U, MEM_REGION_ATTR_DMA, MEM_REGION_POLICY_FASTEST) == 1) &&
+         (MemRegion_select(&gMap, 100U, 4U, MEM_REGION_ATTR_HWA, MEM_REGION_POLICY_FIRST_FIT) == 1);
+    Sim_check(ok, "fastest picks core local, largest free picks L3, DMA and HWA buffers skip core local");
+
+    ok = (MemRegion_select(&gMap, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE + 1U, 4U, 0U, MEM_REGION_POLICY_FASTEST) == 1) &&
+         (MemRegion_select(&gMap, L3_MEM_SIZE + 1U, 4U, 0U, MEM_REGION_POLICY_FASTEST) == -1) &&
+         (MemRegion_select(&gMap, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE, 4U, 0U, MEM_REGION_POLICY_FASTEST) == 0);
+    (void)DPC_ObjDet_MemPoolAlloc(&gCoreLocalPool, 1U, 1U);
+    ok = ok && (MemRegion_select(&gMap, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE - 4U, 4U, 0U,
+                                 MEM_REGION_POLICY_FASTEST) == 0) &&
+         (MemRegion_select(&gMap, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE - 3U, 4U, 0U, MEM_REGION_POLICY_FASTEST) == 1);
+    Sim_check(ok, "a buffer too large for a region after alignment falls back to the next one, or to none");
+
+    Sim_setup(1);
+    (void)DPC_ObjDet_MemPoolAlloc(&gL3Pool, L3_MEM_SIZE - 4096U, 4U);
+    ok = (MemRegion_getLargestFree(&gMap, MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA) == FECSS_SHRAM_MEM_SIZE) &&
+         (MemRegion_getLargestFree(&gMap, 0U) == FECSS_SHRAM_MEM_SIZE) &&
+         (MemRegion_getLargestFree(&gMap, 1U << 7) == 0U);
+    ok = ok && (MemRegion_alloc(&gMap, FECSS_SHRAM_MEM_SIZE - 4096U, 4U, MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                                MEM_REGION_POLICY_LARGEST_FREE, "radarCube", NULL) != NULL) &&
+         (MemRegion_alloc(&gMap, 4096U, 4U, MEM_REGION_ATTR_DMA | MEM_REGION_ATTR_HWA,
+                          MEM_REGION_POLICY_LARGEST_FREE, "radarCube", NULL) != NULL) &&
+         (MemRegion_getLargestFree(&gMap, MEM_REGION_ATTR_DMA) == 4096U);
+    Sim_check(ok, "buffers within the largest free DMA and HWA region are all placed by largest free");
+}
+
+static void Sim_testCheckpoints(void) {
+    MemRegion_Usage usage;
+    int32_t idx;
+    uint32_t i;
+    int ok;
+
+    Sim_setup(1);
+    ok = (MemRegion_pushCheckpoint(&gMap, "pipeline") == 0) &&
+         (MemRegion_alloc(&gMap, 400U * 1024U, 4U, MEM_REGION_ATTR_HWA, MEM_REGION_POLICY_LARGEST_FREE, "radarCube",
+                          &idx) == gL3) && (idx == 1) &&
+         (MemRegion_alloc(&gMap, 20U * 1024U, 4U, 0U, MEM_REGION_POLICY_LARGEST_FREE, "stream", &idx) == gFecssShram) &&
+         (idx == 2) &&
+         (MemRegion_alloc(&gMap, 90U * 1024U, 4U, MEM_REGION_ATTR_DMA, MEM_REGION_POLICY_FASTEST, "none", &idx) == NULL) &&
+         (idx == -1);
+    MemRegion_getUsage(&gMap, 2U, &usage);
+    ok = ok && (usage.size == FECSS_SHRAM_MEM_SIZE) && (usage.used == 20U * 1024U) &&
+         (usage.free == FECSS_SHRAM_MEM_SIZE - 20U * 1024U) && (usage.peak == 20U * 1024U);
+    Sim_check(ok, "cube in L3, stream records in the FECSS shared RAM, a DMA buffer too large for both is refused");
+
+    ok = (MemRegion_rewind(&gMap, "pipeline") == 0);
+    MemRegion_getUsage(&gMap, 1U, &usage);
+    ok = ok && (usage.used == 0U) && (usage.peak == 400U * 1024U) && (gFecssShramPool.numTags == 0U) &&
+         (MemRegion_rewind(&gMap, "none") == -1);
+    Sim_check(ok, "rewind releases the buffers of all regions and keeps the peak, unknown checkpoints fail");
+
+    /* a checkpoint missing in one region: no region is rewound */
+    ok = (MemRegion_pushCheckpoint(&gMap, "stage") == 0) &&
+         (MemRegion_alloc(&gMap, 1024U, 4U, 0U, MEM_REGION_POLICY_FIRST_FIT, "a", NULL) != NULL) &&
+         (MemRegion_alloc(&gMap, 1024U, 4U, MEM_REGION_ATTR_HWA, MEM_REGION_POLICY_FIRST_FIT, "b", NULL) != NULL);
+    (void)DPC_ObjDet_MemPoolPopCheckpoint(&gFecssShramPool, "stage");
+    ok = ok && (MemRegion_rewind(&gMap, "stage") == -1);
+    MemRegion_getUsage(&gMap, 1U, &usage);
+    ok = ok && (usage.used == 1024U) && (gCoreLocalPool.numTags == 1U) && (gCoreLocalPool.numCheckpoints == 2U) &&
+         (MemRegion_rewind(&gMap, "pipeline") == 0) && (gCoreLocalPool.numCheckpoints == 1U);
+    MemRegion_getUsage(&gMap, 1U, &usage);
+    Sim_check(ok && (usage.used == 0U), "a checkpoint missing in one region fails the rewind without rewinding any region");
+
+    for (i = 1; i < MEM_POOL_MAX_CHECKPOINTS; i++) {
+        ok = ok && (MemRegion_pushCheckpoint(&gMap, "nested") == 0);
+    }
+    /* one region with a full stack: no checkpoint is opened in any region */
+    (void)DPC_ObjDet_MemPoolRewind(&gL3Pool, "pipeline");
+    ok = ok && (MemRegion_pushCheckpoint(&gMap, "nested") == -1) &&
+         (gCoreLocalPool.numCheckpoints == MEM_POOL_MAX_CHECKPOINTS) && (gL3Pool.numCheckpoints == 1U) &&
+         (MemRegion_pushCheckpoint(&gMap, "last") == -1) && (gL3Pool.numCheckpoints == 1U);
+    Sim_check(ok, "a checkpoint is opened in all regions or, if one region is full, in none");
+}
+
+/**
+ * @brief Reference selection: all qualifying regions, then the policy as a strict ordering.
+ */
+static int32_t Sim_select(uint32_t size, uint32_t align, uint32_t attrs, uint32_t policy) {
+    int32_t best = -1;
+    uint32_t i;
+
+    for (i = 0; i < gMap.numRegions; i++) {
+        const MemPoolObj *pool = gMap.region[i].pool;
+        uintptr_t addr = (pool->currAddr + align - 1U) & ~((uintptr_t)align - 1U);
+        uintptr_t end = (uintptr_t)pool->cfg.addr + pool->cfg.size;
+
+        if (((gMap.region[i].attrs & attrs) != attrs) || (addr + size > end)) {
+            continue;
+        }
+        if ((best < 0) ||
+            ((policy == MEM_REGION_POLICY_FASTEST) && (gMap.region[i].speedRank < gMap.region[best].speedRank)) ||
+            ((policy == MEM_REGION_POLICY_LARGEST_FREE) &&
+             (DPC_ObjDet_MemPoolGetFree(pool) > DPC_ObjDet_MemPoolGetFree(gMap.region[best].pool)))) {
+            best = (int32_t)i;
+        }
+    }
+    return best;
+}
+
+static void Sim_testRandom(void) {
+    uint32_t n, numPlaced = 0, numRefused = 0;
+    int ok = 1;
+    char msg[160];
+
+    srand(13);
+    Sim_setup(1);
+    (void)MemRegion_pushCheckpoint(&gMap, "pipeline");
+    for (n = 0; (n < SIM_NUM_BUFFERS) && ok; n++) {
+        uint32_t size = (uint32_t)rand() % ((rand() % 4 == 0) ? 32768U : 2048U);
+        uint32_t align = 1U << (rand() % 7);
+        uint32_t attrs = (uint32_t)rand() % 4U;
+        uint32_t policy = (uint32_t)rand() % 3U;
+        int32_t ref = Sim_select(size, align, attrs, policy);
+        int32_t idx;
+        void *buf;
+        uintptr_t expected = 0;
+
+        if (ref >= 0) {
+            expected = (gMap.region[ref].pool->currAddr + align - 1U) & ~((uintptr_t)align - 1U);
+        }
+        buf = MemRegion_alloc(&gMap, size, (uint8_t)align, attrs, policy, NULL, &idx);
+        ok = (idx == ref) && ((ref < 0) ? (buf == NULL) : ((uintptr_t)buf == expected));
+        numPlaced += (ref >= 0) ? 1U : 0U;
+        numRefused += (ref < 0) ? 1U : 0U;
+        if ((n % 150U) == 149U) {
+            (void)MemRegion_rewind(&gMap, "pipeline");
+        }
+    }
+    snprintf(msg, sizeof(msg), "%u random buffers (%u placed, %u refused) land where the reference selection puts them",
+             n, numPlaced, numRefused);
+    Sim_check(ok && (numRefused > 0U), msg);
+}
+
+/**
+ * @brief Largest cube (multiple of 4 KB) that fits L3 next to the command slots and the stream records.
+ */
+static uint32_t Sim_maxCube(int withFecssShram) {
+    uint32_t cube, maxCube = 0;
+
+    for (cube = 4096U; cube <= L3_MEM_SIZE; cube += 4096U) {
+        int32_t idx;
+
+        Sim_setup(withFecssShram);
+        if ((MemRegion_alloc(&gMap, cube, 4U, MEM_REGION_ATTR_HWA, MEM_REGION_POLICY_FIRST_FIT, "radarCube",
+                             &idx) == NULL) || (idx != 1) ||
+            (MemRegion_alloc(&gMap, SIM_CMD_SLOT_BYTES, 4U, MEM_REGION_ATTR_DMA, MEM_REGION_POLICY_LARGEST_FREE,
+                             "cmdSlot", NULL) == NULL) ||
+            (MemRegion_alloc(&gMap, SIM_STREAM_BYTES, 4U, MEM_REGION_ATTR_DMA, MEM_REGION_POLICY_LARGEST_FREE,
+                             "stream", NULL) == NULL)) {
+            break;
+        }
+        maxCube = cube;
+    }
+    return maxCube;
+}
+
+static void Sim_testCapacity(void) {
+    uint32_t withoutShram = Sim_maxCube(0);
+    uint32_t withShram = Sim_maxCube(1);
+    char msg[160];
+
+    snprintf(msg, sizeof(msg), "largest cube next to %u KB of stream records: %u KB without, %u KB with the FECSS "
+             "shared RAM", SIM_STREAM_BYTES / 1024U, withoutShram / 1024U, withShram / 1024U);
+    Sim_check((withShram > withoutShram) && (withShram + 4096U > L3_MEM_SIZE - SIM_CMD_SLOT_BYTES), msg);
+}
+
+int main(void) {
+    Sim_testPolicies();
+    Sim_testCheckpoints();
+    Sim_testRandom();
+    Sim_testCapacity();
+
+    return Sim_result();
+}
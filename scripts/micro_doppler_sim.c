@@ -0,0 +1,252 @@
+/**
+ * @file micro_doppler_sim.c
+ * @brief Host reference test and benchmark of the micro-Doppler spectrogram column (micro_doppler.h).
+ *
+ * Builds a spectrogram from consecutive frames of a target whose Doppler is
+ * modulated over the frames (a swinging limb on a walking target) and checks
+ * that the column peak follows the modulation. Compares the column model with
+ * a double precision windowed DFT reference summed over the range window and
+ * with the rows of RdHeatmap_compute(), and checks the window placement at the
+ * edges, the column size, the row sums and the argument checks. Then times a
+ * column of the default profile. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o micro_doppler_sim scripts/micro_doppler_sim.c \
+ *         minimal_rangeproc_impl/src/micro_doppler.c minimal_rangeproc_impl/src/rd_heatmap.c -lm
+ *     ./micro_doppler_sim [-v]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "micro_doppler.h"
+#include "rd_heatmap.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+
+/*! @brief Target range bin, range window and first usable range bin */
+#define SIM_TARGET_BIN          11U
+#define SIM_RANGE_LEN           4U
+#define SIM_MIN_RANGE_BIN       2U
+
+/*! @brief Frames of the spectrogram (one modulation period) and Doppler modulation in bins */
+#define SIM_NUM_FRAMES          32U
+#define SIM_DOPPLER_CENTER      8.0
+#define SIM_DOPPLER_SWING       6.0
+
+/*! @brief Largest difference between the model and the reference in LSB */
+#define SIM_MAX_ERROR_LSB       3.0
+
+static int gVerbose = 0;
+
+/**
+ * @brief First half of a symmetric Hann window in Q17 (like mathUtils_genWindow).
+ */
+static void Sim_genWindow(int32_t *window) {
+    uint32_t i;
+
+    for (i = 0; i < (SIM_NUM_CHIRPS + 1U) / 2U; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * (double)(i + 1U) / (double)(SIM_NUM_CHIRPS + 1U));
+        window[i] = (int32_t)lround(w * (double)(1U << RD_HEATMAP_WINDOW_QFORMAT));
+    }
+}
+
+/**
+ * @brief FORMAT_6 cube with a target in SIM_TARGET_BIN (and half of it in the next bin) at a Doppler bin.
+ */
+static void Sim_fillCube(int16_t *cube, double doppler, uint32_t seed) {
+    uint32_t c, a, b;
+
+    srand(seed);
+    for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+        for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+            for (b = 0; b < SIM_NUM_RANGE_BINS; b++) {
+                int16_t *s = &cube[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + b)];
+                double re = (double)(rand() % 61) - 30.0;
+                double im = (double)(rand() % 61) - 30.0;
+                double amp = (b == SIM_TARGET_BIN) ? 2000.0 : ((b == SIM_TARGET_BIN + 1U) ? 1000.0 : 0.0);
+                double ph = 2.0 * M_PI * doppler * c / SIM_NUM_CHIRPS + 0.7 * a;
+
+                s[0] = (int16_t)lrint(im + amp * sin(ph));
+                s[1] = (int16_t)lrint(re + amp * cos(ph));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reference column: windowed DFT in double precision per antenna, magnitude / n, summed and shifted.
+ */
+static void Sim_reference(const int16_t *cube, const int32_t *window, uint32_t rangeStart, uint32_t rangeLen,
+                          double *ref) {
+    uint32_t n = SIM_NUM_CHIRPS, k, b, a, c;
+    double antShift = (double)(1U << RdHeatmap_getShift(SIM_NUM_ANTENNAS));
+    double rowShift = (double)(1U << MicroDoppler_getShift(rangeLen));
+
+    for (k = 0; k < n; k++) {
+        double sum = 0.0;
+        for (b = rangeStart; b < rangeStart + rangeLen; b++) {
+            double row = 0.0;
+            for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+                double re = 0.0, im = 0.0;
+                for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+                    const int16_t *s = &cube[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + b)];
+                    uint32_t wIdx = (c < (SIM_NUM_CHIRPS + 1U) / 2U) ? c : (SIM_NUM_CHIRPS - 1U - c);
+                    double w = (double)window[wIdx] / (double)(1U << RD_HEATMAP_WINDOW_QFORMAT);
+                    double ph = -2.0 * M_PI * (double)(k * c) / (double)n;
+                    re += w * (s[1] * cos(ph) - s[0] * sin(ph));
+                    im += w * (s[1] * sin(ph) + s[0] * cos(ph));
+                }
+                row += sqrt(re * re + im * im) / (double)n;
+            }
+            sum += floor(row / antShift);
+        }
+        ref[k] = sum / rowShift;
+    }
+}
+
+static uint32_t Sim_peakBin(const uint16_t *column) {
+    uint32_t k, best = 0;
+
+    for (k = 1; k < SIM_NUM_CHIRPS; k++) {
+        best = (column[k] > column[best]) ? k : best;
+    }
+    return best;
+}
+
+static void Sim_testSpectrogram(int16_t *cube, const int32_t *window) {
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, SIM_NUM_CHIRPS };
+    uint32_t start = MicroDoppler_centerWindow(SIM_TARGET_BIN, SIM_RANGE_LEN, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS);
+    uint16_t scratch[MICRO_DOPPLER_MAX_RANGE_LEN * SIM_NUM_CHIRPS], column[SIM_NUM_CHIRPS], sums[SIM_NUM_CHIRPS];
+    uint16_t *heatmap = malloc(RdHeatmap_getSize(&cfg));
+    double ref[SIM_NUM_CHIRPS], maxError = 0.0;
+    uint32_t f, k, maxPeakError = 0;
+    int rowsOk = 1;
+    char msg[200];
+
+    for (f = 0; f < SIM_NUM_FRAMES; f++) {
+        double doppler = SIM_DOPPLER_CENTER + SIM_DOPPLER_SWING * sin(2.0 * M_PI * f / SIM_NUM_FRAMES);
+        uint32_t peak, expected = (uint32_t)lrint(doppler), err;
+
+        Sim_fillCube(cube, doppler, f + 1U);
+        (void)MicroDoppler_compute(&cfg, cube, window, start, SIM_RANGE_LEN, scratch, column);
+        peak = Sim_peakBin(column);
+        err = (peak > expected) ? (peak - expected) : (expected - peak);
+        maxPeakError = (err > maxPeakError) ? err : maxPeakError;
+        if (gVerbose) {
+            printf("  frame %2u: doppler %5.2f, peak in bin %2u, column", f, doppler, peak);
+            for (k = 0; k < 20U; k++) {
+                printf(" %4u", column[k]);
+            }
+            printf("\n");
+        }
+
+        if ((f % 8U) == 0U) {
+            /* reference on every 8th frame, the DFT reference is slow */
+            Sim_reference(cube, window, start, SIM_RANGE_LEN, ref);
+            for (k = 0; k < SIM_NUM_CHIRPS; k++) {
+                maxError = fmax(maxError, fabs((double)column[k] - ref[k]));
+            }
+            (void)RdHeatmap_compute(&cfg, cube, window, heatmap);
+            MicroDoppler_sumRows(&heatmap[start * SIM_NUM_CHIRPS], SIM_RANGE_LEN, SIM_NUM_CHIRPS, sums);
+            rowsOk = rowsOk && (memcmp(sums, column, sizeof(column)) == 0);
+        }
+    }
+    snprintf(msg, sizeof(msg), "spectrogram of %u frames: the column peak follows a Doppler of %.0f +- %.0f bins "
+             "(largest error %u bin)", SIM_NUM_FRAMES, SIM_DOPPLER_CENTER, SIM_DOPPLER_SWING, maxPeakError);
+    Sim_check(maxPeakError <= 1U, msg);
+    snprintf(msg, sizeof(msg), "column matches the DFT reference within %.1f LSB (max %.2f)", SIM_MAX_ERROR_LSB,
+             maxError);
+    Sim_check(maxError <= SIM_MAX_ERROR_LSB, msg);
+    Sim_check(rowsOk, "column is the sum of the rows of the range-Doppler heatmap in the window");
+    free(heatmap);
+}
+
+static void Sim_testWindow(void) {
+    int ok;
+
+    ok = (MicroDoppler_centerWindow(SIM_TARGET_BIN, 4U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == 9U) &&
+         (MicroDoppler_centerWindow(SIM_TARGET_BIN, 5U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == 9U) &&
+         (MicroDoppler_centerWindow(SIM_TARGET_BIN, 1U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == 11U);
+    Sim_check(ok, "window of 1, 4 and 5 bins is centred on the target bin");
+    ok = (MicroDoppler_centerWindow(1U, 4U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == SIM_MIN_RANGE_BIN) &&
+         (MicroDoppler_centerWindow(63U, 4U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == 60U) &&
+         (MicroDoppler_centerWindow(62U, 8U, SIM_MIN_RANGE_BIN, SIM_NUM_RANGE_BINS) == 56U);
+    Sim_check(ok, "window is kept within [minBin, numRangeBins) at both edges");
+}
+
+static void Sim_testSizes(void) {
+    uint16_t rows[5U * 4U], column[4];
+    uint32_t i;
+    int ok = 1;
+
+    for (i = 0; i < 20U; i++) {
+        rows[i] = UINT16_MAX;
+    }
+    MicroDoppler_sumRows(rows, 5U, 4U, column);
+    for (i = 0; i < 4U; i++) {
+        ok = ok && (column[i] == (uint16_t)((5U * UINT16_MAX) >> 3));
+    }
+    Sim_check(ok && (MicroDoppler_getShift(5U) == 3U) && (MicroDoppler_getShift(MICRO_DOPPLER_MAX_RANGE_LEN) == 3U),
+              "row sums of full-scale rows are shifted by ceil(log2(rangeLen)) without overflow");
+    Sim_check((MicroDoppler_getSize(64U) == sizeof(MicroDoppler_Header) + 128U) &&
+              (MicroDoppler_getSize(2U) == sizeof(MicroDoppler_Header) + 4U) && (sizeof(MicroDoppler_Header) % 4U == 0U),
+              "column size is header plus values, padded to 4 bytes");
+}
+
+static void Sim_testArguments(int16_t *cube, const int32_t *window) {
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, SIM_NUM_CHIRPS };
+    uint16_t scratch[(MICRO_DOPPLER_MAX_RANGE_LEN + 1U) * SIM_NUM_CHIRPS], column[SIM_NUM_CHIRPS];
+    int ok;
+
+    ok = (MicroDoppler_compute(&cfg, cube, window, 10U, 0U, scratch, column) == -1) &&
+         (MicroDoppler_compute(&cfg, cube, window, 10U, MICRO_DOPPLER_MAX_RANGE_LEN + 1U, scratch, column) == -1) &&
+         (MicroDoppler_compute(&cfg, cube, window, 62U, 4U, scratch, column) == -1);
+    cfg.fftSize = 48U;
+    ok = ok && (MicroDoppler_compute(&cfg, cube, window, 10U, 4U, scratch, column) == -1);
+    Sim_check(ok, "empty or too long windows, windows past the end and invalid FFT sizes are rejected");
+}
+
+static void Sim_benchmark(int16_t *cube, const int32_t *window) {
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, SIM_NUM_CHIRPS };
+    uint16_t scratch[MICRO_DOPPLER_MAX_RANGE_LEN * SIM_NUM_CHIRPS], column[SIM_NUM_CHIRPS];
+    struct timespec t0, t1;
+    uint32_t i, iterations = 200U;
+
+    Sim_fillCube(cube, SIM_DOPPLER_CENTER, 1U);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        (void)MicroDoppler_compute(&cfg, cube, window, 9U, SIM_RANGE_LEN, scratch, column);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("\nbenchmark, %u x %u x %u cube: model of a %u bin column in %.1f us, column %u bytes instead of a "
+           "%u byte heatmap\n", SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, SIM_RANGE_LEN,
+           ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations,
+           MicroDoppler_getSize(SIM_NUM_CHIRPS), RdHeatmap_getSize(&cfg));
+}
+
+int main(int argc, char **argv) {
+    int16_t *cube = malloc(4U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS);
+    int32_t window[SIM_NUM_CHIRPS / 2U];
+
+    gVerbose = (argc > 1) && (strcmp(argv[1], "-v") == 0);
+
+    Sim_genWindow(window);
+    Sim_testSpectrogram(cube, window);
+    Sim_testWindow();
+    Sim_testSizes();
+    Sim_testArguments(cube, window);
+    Sim_benchmark(cube, window);
+
+    free(cube);
+    return Sim_result();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file profile_blob_sim.c
+ * @brief Host test of the profile blob (profile_blob.h) written by chirp_config_to_defines.py.
+ *
+ * Loads a blob encoded by the script with --encode-blob from profiles/default.cfg
+ * and checks that ProfileBlob_check() accepts it, that it carries the profile
+ * of defines.h (generated from the same configuration) and passes
+ * ConfigCmd_validate(), and that ProfileBlob_encode() of the decoded profile
+ * gives the same bytes. Then checks that a flipped payload or CRC bit, another
+ * version or length, a partly programmed blob and an erased or zeroed sector
+ * are rejected with the matching error. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o profile_blob_sim scripts/profile_blob_sim.c \
+ *         minimal_rangeproc_impl/src/profile_blob.c minimal_rangeproc_impl/src/config_cmd.c \
+ *         minimal_rangeproc_impl/src/chirp_accum.c minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     python3 scripts/chirp_config_to_defines.py profiles/default.cfg --encode-blob profile.bin
+ *     ./profile_blob_sim profile.bin
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "budget_limits.h"
+#include "config_cmd.h"
+#include "defines.h"
+#include "profile_blob.h"
+#include "sim_check.h"
+
+/*! @brief Maximum number of ADC samples the profile is validated against */
+#define SIM_MAX_ADC_SAMPLES     1024U
+
+/*! @brief Bytes of the blob programmed before the write was interrupted */
+#define SIM_PARTIAL_BYTES       50U
+
+/**
+ * @brief Reads a blob file into erased flash, returns the number of bytes of the file.
+ */
+static long Sim_load(const char *path, ProfileBlob *blob) {
+    uint8_t extra;
+    long numBytes;
+    FILE *f = fopen(path, "rb");
+
+    memset(blob, 0xFF, sizeof(ProfileBlob));
+    if (f == NULL) {
+        return -1;
+    }
+    numBytes = (long)fread(blob, 1, sizeof(ProfileBlob), f);
+    numBytes += (long)fread(&extra, 1, 1, f);
+    fclose(f);
+    return numBytes;
+}
+
+static void Sim_testFile(const ProfileBlob *blob, long numBytes) {
+    char msg[160];
+
+    snprintf(msg, sizeof(msg), "blob of the script has %ld bytes (sizeof(ProfileBlob) %u)", numBytes,
+             (unsigned)sizeof(ProfileBlob));
+    Sim_check(numBytes == (long)sizeof(ProfileBlob), msg);
+    snprintf(msg, sizeof(msg), "ProfileBlob_check() accepts the blob of the script (result %d)",
+             (int)ProfileBlob_check(blob));
+    Sim_check(ProfileBlob_check(blob) == PROFILE_BLOB_OK, msg);
+}
+
+static void Sim_testDefines(const ProfileBlob *blob) {
+    const ConfigCmd_Profile *p = &blob->profile;
+    ConfigCmd_Profile active;
+    ConfigCmd_SensorParams params;
+    ConfigCmd_Limits limits = { SIM_MAX_ADC_SAMPLES, 0U, L3_MEM_SIZE, 0U };
+    int ok;
+    char msg[160];
+
+    ok = (p->channelCfg.rxChCtrlBitMask == CLI_CHA_CFG_RX_BITMASK) &&
+         (p->channelCfg.txChCtrlBitMask == CLI_CHA_CFG_TX_BITMASK) &&
+         (p->channelCfg.miscCtrl == CLI_CHA_CFG_MISC_CTRL) &&
+         (p->chirpComnCfg.digOutputSampRate == CLI_DIG_OUT_SAMPLING_RATE) &&
+         (p->chirpComnCfg.digOutputBitsSel == CLI_DIG_OUT_BITS_SEL) &&
+         (p->chirpComnCfg.dfeFirSel == CLI_DFE_FIR_SEL) &&
+         (p->chirpComnCfg.numOfAdcSamples == CLI_NUM_ADC_SAMPLES) &&
+         (p->chirpComnCfg.chirpTxMimoPatSel == CLI_MIMO_SEL) &&
+         (p->chirpComnCfg.chirpRxHpfSel == CLI_CHIRP_RX_HPF_SEL) &&
+         (p->frameCfg.numOfChirpsInBurst == CLI_NUM_CHIRPS_PER_BURST) &&
+         (p->frameCfg.numOfChirpsAccum == CLI_NUM_CHIRPS_ACCUM) &&
+         (p->frameCfg.numOfBurstsInFrame == CLI_NUM_BURSTS_PER_FRAME) &&
+         (p->frameCfg.numOfFrames == CLI_NUM_FRAMES);
+    Sim_check(ok, "integer fields of the blob equal defines.h");
+
+    ConfigCmd_toSensorParams(p, &params);
+    ok = (params.rampEndTime == (uint16_t)CLI_CHIRP_RAMP_END_TIME) &&
+         (params.idleTime == (uint16_t)CLI_CHIRP_IDLE_TIME) &&
+         (params.adcStartTime == (uint16_t)CLI_CHIRP_ADC_START_TIME) &&
+         (params.txStartTime == (int16_t)CLI_CHIRP_TX_START_TIME) &&
+         (params.freqSlope == (int16_t)CLI_CHIRP_FREQ_SLOPE) &&
+         (params.freqStart == (uint32_t)CLI_CHIRP_START_FREQ) &&
+         (params.burstPeriod == (uint32_t)CLI_W_BURST_PERIOD) &&
+         (params.framePeriod == (uint32_t)CLI_FRAME_PERIOD);
+    snprintf(msg, sizeof(msg), "timing of the blob in front-end units equals defines.h (idle %u, ramp end %u, "
+             "slope %d, start %u, burst %u, frame %u)", params.idleTime, params.rampEndTime, params.freqSlope,
+             params.freqStart, params.burstPeriod, params.framePeriod);
+    Sim_check(ok, msg);
+
+    memset(&active, 0, sizeof(active));
+    active.channelCfg = p->channelCfg;
+    snprintf(msg, sizeof(msg), "profile of the blob passes ConfigCmd_validate() (result %d)",
+             (int)ConfigCmd_validate(p, &active, &limits));
+    Sim_check(ConfigCmd_validate(p, &active, &limits) == CONFIG_CMD_OK, msg);
+}
+
+static void Sim_testRoundTrip(const ProfileBlob *blob) {
+    ProfileBlob encoded;
+
+    ProfileBlob_encode(&blob->profile, &encoded);
+    Sim_check(memcmp(&encoded, blob, sizeof(ProfileBlob)) == 0,
+              "ProfileBlob_encode() of the decoded profile is byte-identical to the blob of the script");
+}
+
+static void Sim_testCorrupt(const ProfileBlob *blob) {
+    ProfileBlob t;
+    uint32_t bit, numBits = 0, numRejected = 0;
+    int ok;
+    char msg[160];
+
+    /* every single bit of the payload and the CRC */
+    for (bit = 0; bit < 8U * (sizeof(t.crc) + sizeof(t.profile)); bit++) {
+        t = *blob;
+        ((uint8_t *)&t.crc)[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        numRejected += (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_CRC) ? 1U : 0U;
+        numBits++;
+    }
+    snprintf(msg, sizeof(msg), "bad CRC: %u of %u flipped payload and CRC bits are rejected", numRejected, numBits);
+    Sim_check(numRejected == numBits, msg);
+
+    t = *blob;
+    t.version = PROFILE_BLOB_VERSION + 1U;
+    ok = (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_VERSION);
+    t.version = 0U;
+    ok = ok && (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_VERSION);
+    Sim_check(ok, "bad version: blobs of another format version are rejected");
+
+    t = *blob;
+    t.payloadBytes = sizeof(ConfigCmd_Profile) - 4U;
+    ok = (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_LENGTH);
+    t = *blob;
+    t.headerBytes = 12U;
+    ok = ok && (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_LENGTH);
+    Sim_check(ok, "bad length: other header or payload sizes are rejected");
+
+    memset(&t, 0xFF, sizeof(t));
+    memcpy(&t, blob, SIM_PARTIAL_BYTES);
+    snprintf(msg, sizeof(msg), "blob programmed up to byte %u is rejected (result %d)", SIM_PARTIAL_BYTES,
+             (int)ProfileBlob_check(&t));
+    Sim_check(ProfileBlob_check(&t) == PROFILE_BLOB_ERR_CRC, msg);
+
+    memset(&t, 0xFF, sizeof(t));
+    ok = (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_EMPTY);
+    memset(&t, 0, sizeof(t));
+    ok = ok && (ProfileBlob_check(&t) == PROFILE_BLOB_ERR_EMPTY);
+    Sim_check(ok, "erased (0xFF) and zeroed sectors are empty");
+}
+
+int main(int argc, char **argv) {
+    ProfileBlob blob;
+    long numBytes;
+
+    if (argc < 2) {
+        printf("usage: %s <profile blob of chirp_config_to_defines.py --encode-blob>\n", argv[0]);
+        return 1;
+    }
+    numBytes = Sim_load(argv[1], &blob);
+    if (numBytes < 0) {
+        Sim_check(0, "open the blob file");
+    } else {
+        Sim_testFile(&blob, numBytes);
+        Sim_testDefines(&blob);
+        Sim_testRoundTrip(&blob);
+        Sim_testCorrupt(&blob);
+    }
+
+    return Sim_result();
+}
@@ -0,0 +1,236 @@
+/**
+ * @file range_peaks_sim.c
+ * @brief Host reference test and benchmark of the top-K range peak list (range_peaks.h).
+ *
+ * Compares RangePeaks_find() with a brute force reference (all local maxima of
+ * the range profile, stable sort by decreasing power, first K) on random
+ * profiles with ties, checks the interpolated range of targets at fractional
+ * bins in the range FFT of a Blackman windowed chirp, the per-antenna samples
+ * and the argument checks. Then times the reduction of a frame of the default
+ * profile (range profile and peak search) in microseconds and, on x86, in TSC
+ * cycles. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o range_peaks_sim scripts/range_peaks_sim.c \
+ *         minimal_rangeproc_impl/src/range_peaks.c minimal_rangeproc_impl/src/range_profile.c -lm
+ *     ./range_peaks_sim [iterations]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "range_peaks.h"
+#include "range_profile.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 128 ADC samples, 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_ADC_SAMPLES     128U
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+#define SIM_NUM_ROWS            (SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS)
+
+/*! @brief Peaks per frame (K) */
+#define SIM_MAX_PEAKS           4U
+
+static const RangePeaks_Peak *Sim_peak(const RangePeaks_Config *cfg, const void *payload, uint32_t n) {
+    return (const RangePeaks_Peak *)((const uint8_t *)payload + sizeof(RangePeaks_Header) +
+                                     n * RangePeaks_getPeakSize(cfg));
+}
+
+/**
+ * @brief Reference: local maxima (greater than the left, not less than the right neighbour),
+ *        stable sort by decreasing power, first maxPeaks. Returns the number of peaks.
+ */
+static uint32_t Sim_referencePeaks(const RangePeaks_Config *cfg, const uint64_t *acc, uint16_t *bins) {
+    uint16_t all[SIM_NUM_RANGE_BINS];
+    uint32_t numAll = 0, i, j, bin;
+
+    for (bin = (cfg->minBin > 0U) ? cfg->minBin : 1U; bin + 1U < cfg->numRangeBins; bin++) {
+        if ((acc[bin] > acc[bin - 1U]) && (acc[bin] >= acc[bin + 1U])) {
+            all[numAll++] = (uint16_t)bin;
+        }
+    }
+    /* insertion sort is stable: equal powers keep the lower bin first */
+    for (i = 1; i < numAll; i++) {
+        uint16_t b = all[i];
+        for (j = i; (j > 0U) && (acc[all[j - 1U]] < acc[b]); j--) {
+            all[j] = all[j - 1U];
+        }
+        all[j] = b;
+    }
+    numAll = (numAll > cfg->maxPeaks) ? cfg->maxPeaks : numAll;
+    memcpy(bins, all, numAll * sizeof(uint16_t));
+    return numAll;
+}
+
+static void Sim_testReference(int16_t *cube, void *payload) {
+    RangePeaks_Config cfg = { SIM_MAX_PEAKS, 2U, SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS };
+    uint64_t acc[SIM_NUM_RANGE_BINS];
+    uint16_t refBins[SIM_NUM_RANGE_BINS];
+    uint32_t trial, n, bin, numMismatches = 0;
+    char msg[160];
+
+    srand(1);
+    for (trial = 0; trial < 2000U; trial++) {
+        uint32_t numRef;
+        int32_t numPeaks;
+
+        /* few distinct levels, so that ties and plateaus occur */
+        for (bin = 0; bin < SIM_NUM_RANGE_BINS; bin++) {
+            acc[bin] = (uint64_t)(rand() % ((trial % 4U == 0U) ? 4 : 1000));
+        }
+        cfg.maxPeaks = (uint16_t)(1U + trial % 8U);
+        cfg.minBin   = (uint16_t)(trial % 5U);
+        numRef   = Sim_referencePeaks(&cfg, acc, refBins);
+        numPeaks = RangePeaks_find(&cfg, cube, acc, payload);
+        if (numPeaks != (int32_t)numRef) {
+            numMismatches++;
+            continue;
+        }
+        for (n = 0; n < numRef; n++) {
+            if (Sim_peak(&cfg, payload, n)->bin != refBins[n]) {
+                numMismatches++;
+                break;
+            }
+        }
+    }
+    snprintf(msg, sizeof(msg), "peak bins match the reference on 2000 random profiles (%u mismatches)",
+             numMismatches);
+    Sim_check(numMismatches == 0U, msg);
+}
+
+/**
+ * @brief Range FFT of targets at fractional range bins: Blackman windowed complex tones,
+ *        64-point half of a 128-point DFT, the phase rotates over the rows.
+ */
+static void Sim_fillTargets(int16_t *cube, const double *bins, const double *amps, uint32_t numTargets) {
+    double re[SIM_NUM_RANGE_BINS], im[SIM_NUM_RANGE_BINS];
+    uint32_t row, k, n, t;
+
+    memset(re, 0, sizeof(re));
+    memset(im, 0, sizeof(im));
+    for (k = 0; k < SIM_NUM_RANGE_BINS; k++) {
+        for (n = 0; n < SIM_NUM_ADC_SAMPLES; n++) {
+            double w = 0.42 - 0.5 * cos(2.0 * M_PI * n / (SIM_NUM_ADC_SAMPLES - 1U)) +
+                       0.08 * cos(4.0 * M_PI * n / (SIM_NUM_ADC_SAMPLES - 1U));
+            for (t = 0; t < numTargets; t++) {
+                double ph = 2.0 * M_PI * n * (bins[t] - (double)k) / SIM_NUM_ADC_SAMPLES;
+                re[k] += amps[t] * w * cos(ph);
+                im[k] += amps[t] * w * sin(ph);
+            }
+        }
+    }
+    for (row = 0; row < SIM_NUM_ROWS; row++) {
+        double rot = 0.7 * row;
+        for (k = 0; k < SIM_NUM_RANGE_BINS; k++) {
+            /* cmplx16ImRe_t: imaginary part first */
+            cube[2U * (row * SIM_NUM_RANGE_BINS + k)]      = (int16_t)lrint(re[k] * sin(rot) + im[k] * cos(rot));
+            cube[2U * (row * SIM_NUM_RANGE_BINS + k) + 1U] = (int16_t)lrint(re[k] * cos(rot) - im[k] * sin(rot));
+        }
+    }
+}
+
+static void Sim_testInterpolation(int16_t *cube, void *payload) {
+    static const double bins[] = { 20.3, 41.75, 9.5 };
+    static const double amps[] = { 200.0, 120.0, 60.0 };
+    RangePeaks_Config cfg = { SIM_MAX_PEAKS, 2U, SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS };
+    uint64_t acc[SIM_NUM_RANGE_BINS];
+    const RangePeaks_Peak *peak;
+    double maxErr = 0.0;
+    uint32_t n, ant;
+    int32_t numPeaks;
+    int samplesOk = 1;
+    char msg[160];
+
+    Sim_fillTargets(cube, bins, amps, 3U);
+    RangeProfile_accumulate(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, acc);
+    numPeaks = RangePeaks_find(&cfg, cube, acc, payload);
+    Sim_check(numPeaks >= 3, "three targets found");
+    for (n = 0; (n < 3U) && ((int32_t)n < numPeaks); n++) {
+        peak = Sim_peak(&cfg, payload, n);
+        maxErr = fmax(maxErr, fabs(peak->rangeBin - bins[n]));
+        for (ant = 0; ant < SIM_NUM_ANTENNAS; ant++) {
+            const int16_t *iq = (const int16_t *)(peak + 1) + 2U * ant;
+            samplesOk = samplesOk && (iq[0] == cube[2U * (ant * SIM_NUM_RANGE_BINS + peak->bin)]) &&
+                        (iq[1] == cube[2U * (ant * SIM_NUM_RANGE_BINS + peak->bin) + 1U]);
+        }
+    }
+    snprintf(msg, sizeof(msg), "targets sorted by power, interpolated within 0.1 bin (max. error %.3f)", maxErr);
+    Sim_check(maxErr < 0.1, msg);
+    Sim_check(samplesOk, "per-antenna samples are the first chirp of the cube at the peak bin");
+}
+
+static void Sim_testArguments(int16_t *cube, void *payload) {
+    RangePeaks_Config cfg = { SIM_MAX_PEAKS, 0U, SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS };
+    uint64_t acc[SIM_NUM_RANGE_BINS];
+
+    memset(acc, 0, sizeof(acc));
+    Sim_check(RangePeaks_getPayloadSize(&cfg) == sizeof(RangePeaks_Header) +
+              SIM_MAX_PEAKS * (sizeof(RangePeaks_Peak) + 4U * SIM_NUM_ANTENNAS), "payload size");
+    Sim_check(RangePeaks_find(&cfg, cube, acc, payload) == 0, "flat profile has no peak");
+    cfg.maxPeaks = 0U;
+    Sim_check(RangePeaks_find(&cfg, cube, acc, payload) == -1, "K = 0 is rejected");
+    cfg.maxPeaks     = SIM_MAX_PEAKS;
+    cfg.numRangeBins = 2U;
+    Sim_check(RangePeaks_find(&cfg, cube, acc, payload) == -1, "less than 3 range bins are rejected");
+}
+
+static void Sim_benchmark(int16_t *cube, void *payload, uint32_t iterations) {
+    static const double bins[] = { 20.3, 41.75, 9.5 };
+    static const double amps[] = { 200.0, 120.0, 60.0 };
+    RangePeaks_Config cfg = { SIM_MAX_PEAKS, 2U, SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS };
+    uint64_t acc[SIM_NUM_RANGE_BINS];
+    struct timespec t0, t1;
+    uint32_t i;
+    double us;
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t c0, c1;
+#endif
+
+    Sim_fillTargets(cube, bins, amps, 3U);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+#if defined(__x86_64__) || defined(__i386__)
+    c0 = __rdtsc();
+#endif
+    for (i = 0; i < iterations; i++) {
+        RangeProfile_accumulate(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, acc);
+        (void)RangePeaks_find(&cfg, cube, acc, payload);
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    c1 = __rdtsc();
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    us = ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations;
+    printf("\nbenchmark, %u x %u cube, K = %u: %.1f us per frame", SIM_NUM_RANGE_BINS, SIM_NUM_ROWS,
+           SIM_MAX_PEAKS, us);
+#if defined(__x86_64__) || defined(__i386__)
+    printf(", %.0f TSC cycles per frame", (double)(c1 - c0) / iterations);
+#endif
+    printf(", payload %u bytes instead of %u\n", RangePeaks_getPayloadSize(&cfg),
+           4U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000U;
+    int16_t *cube = aligned_alloc(4, 4U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS);
+    void *payload = aligned_alloc(4, 4096U);
+
+    memset(cube, 0, 4U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS);
+    Sim_testReference(cube, payload);
+    Sim_testInterpolation(cube, payload);
+    Sim_testArguments(cube, payload);
+    Sim_benchmark(cube, payload, (iterations > 0U) ? iterations : 1U);
+
+    free(cube);
+    free(payload);
+    return Sim_result();
+}
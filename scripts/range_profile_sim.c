@@ -0,0 +1,163 @@
+/**
+ * @file range_profile_sim.c
+ * @brief Host reference test and benchmark of the non-coherent range profile (range_profile.h).
+ *
+ * Compares RangeProfile_compute() with a reference that sums the sample powers
+ * of every range bin in double precision, on random cubes of several profiles
+ * and on full-scale cubes (-32768 everywhere) at the largest number of range
+ * lines, checks that RangeProfile_getShift() is the smallest shift without
+ * overflow and that the values of a full-scale cube stay within uint32. Then
+ * times the reduction of a cube of the default profile in microseconds and,
+ * on x86, in TSC cycles. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o range_profile_sim scripts/range_profile_sim.c \
+ *         minimal_rangeproc_impl/src/range_profile.c
+ *     ./range_profile_sim [iterations]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "range_profile.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ROWS            (6U * 64U)
+
+/*! @brief Largest cube of the tests: 512 range bins x 12 antennas x 128 chirps */
+#define SIM_MAX_RANGE_BINS      512U
+#define SIM_MAX_ROWS            (12U * 128U)
+
+/**
+ * @brief Reference: power sums of all range bins in double precision (exact below 2^53).
+ */
+static void Sim_reference(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows, double *ref) {
+    uint32_t row, bin;
+
+    for (bin = 0; bin < numRangeBins; bin++) {
+        ref[bin] = 0.0;
+        for (row = 0; row < numRows; row++) {
+            double re = cube[2U * (row * numRangeBins + bin) + 1U];
+            double im = cube[2U * (row * numRangeBins + bin)];
+            ref[bin] += re * re + im * im;
+        }
+    }
+}
+
+static int Sim_compare(const int16_t *cube, uint32_t numRangeBins, uint32_t numRows, uint64_t *acc,
+                       uint32_t *profile, double *ref) {
+    uint32_t shift = RangeProfile_getShift(numRows);
+    uint32_t bin;
+
+    RangeProfile_compute(cube, numRangeBins, numRows, acc, profile);
+    Sim_reference(cube, numRangeBins, numRows, ref);
+    for (bin = 0; bin < numRangeBins; bin++) {
+        if ((acc[bin] != (uint64_t)ref[bin]) || (profile[bin] != (uint32_t)((uint64_t)ref[bin] >> shift))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void Sim_testReference(int16_t *cube, uint64_t *acc, uint32_t *profile, double *ref) {
+    static const uint32_t bins[] = { 16U, 64U, 100U, 256U, 512U };
+    static const uint32_t rows[] = { 1U, 3U, 384U, 1000U, SIM_MAX_ROWS };
+    uint32_t i, j, k;
+    int ok = 1;
+    char msg[160];
+
+    srand(1);
+    for (i = 0; i < sizeof(bins) / sizeof(bins[0]); i++) {
+        for (j = 0; j < sizeof(rows) / sizeof(rows[0]); j++) {
+            for (k = 0; k < 2U * bins[i] * rows[j]; k++) {
+                cube[k] = (int16_t)((rand() & 0xFFFF) - 32768);
+            }
+            ok = ok && Sim_compare(cube, bins[i], rows[j], acc, profile, ref);
+        }
+    }
+    snprintf(msg, sizeof(msg), "random cubes of %u profiles match the reference", (uint32_t)(i * j));
+    Sim_check(ok, msg);
+
+    /* -32768 is the largest power of a component, a full-scale cube is the worst case of the shift */
+    for (k = 0; k < 2U * SIM_MAX_RANGE_BINS * SIM_MAX_ROWS; k++) {
+        cube[k] = -32768;
+    }
+    ok = Sim_compare(cube, SIM_MAX_RANGE_BINS, SIM_MAX_ROWS, acc, profile, ref) &&
+         (acc[0] == ((uint64_t)SIM_MAX_ROWS << 31)) &&
+         (profile[0] == (uint32_t)(((uint64_t)SIM_MAX_ROWS << 31) >> RangeProfile_getShift(SIM_MAX_ROWS)));
+    snprintf(msg, sizeof(msg), "full-scale cube of %u range lines matches the reference without overflow (0x%08X)",
+             SIM_MAX_ROWS, profile[0]);
+    Sim_check(ok, msg);
+}
+
+static void Sim_testShift(void) {
+    uint32_t numRows;
+    int ok = 1;
+
+    for (numRows = 1; numRows <= 4096U; numRows++) {
+        uint32_t shift = RangeProfile_getShift(numRows);
+        uint64_t worst = (uint64_t)numRows << 31;
+        ok = ok && ((worst >> shift) <= 0xFFFFFFFFULL) && ((shift == 0U) || ((worst >> (shift - 1U)) > 0xFFFFFFFFULL));
+    }
+    Sim_check(ok, "shift is the smallest one without overflow for 1 to 4096 range lines");
+    Sim_check((RangeProfile_getShift(1U) == 0U) && (RangeProfile_getShift(2U) == 1U) &&
+              (RangeProfile_getShift(SIM_NUM_ROWS) == 8U), "shift of 1, 2 and 384 range lines is 0, 1 and 8");
+}
+
+static void Sim_benchmark(int16_t *cube, uint64_t *acc, uint32_t *profile, uint32_t iterations) {
+    struct timespec t0, t1;
+    uint32_t i;
+    double us;
+#if defined(__x86_64__) || defined(__i386__)
+    uint64_t c0, c1;
+#endif
+
+    for (i = 0; i < 2U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS; i++) {
+        cube[i] = (int16_t)((rand() & 0xFFFF) - 32768);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+#if defined(__x86_64__) || defined(__i386__)
+    c0 = __rdtsc();
+#endif
+    for (i = 0; i < iterations; i++) {
+        RangeProfile_compute(cube, SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, acc, profile);
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    c1 = __rdtsc();
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    us = ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations;
+    printf("\nbenchmark, %u x %u cube: %.1f us per frame", SIM_NUM_RANGE_BINS, SIM_NUM_ROWS, us);
+#if defined(__x86_64__) || defined(__i386__)
+    printf(", %.2f TSC cycles per sample", (double)(c1 - c0) / iterations / (SIM_NUM_RANGE_BINS * SIM_NUM_ROWS));
+#endif
+    printf(", payload %u bytes instead of %u\n", (uint32_t)(sizeof(RangeProfile_Header) + 4U * SIM_NUM_RANGE_BINS),
+           4U * SIM_NUM_RANGE_BINS * SIM_NUM_ROWS);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000U;
+    int16_t *cube = aligned_alloc(4, 4U * SIM_MAX_RANGE_BINS * SIM_MAX_ROWS);
+    uint64_t *acc = malloc(SIM_MAX_RANGE_BINS * sizeof(uint64_t));
+    uint32_t *profile = malloc(SIM_MAX_RANGE_BINS * sizeof(uint32_t));
+    double *ref = malloc(SIM_MAX_RANGE_BINS * sizeof(double));
+
+    Sim_testReference(cube, acc, profile, ref);
+    Sim_testShift();
+    Sim_benchmark(cube, acc, profile, (iterations > 0U) ? iterations : 1U);
+
+    free(cube);
+    free(acc);
+    free(profile);
+    free(ref);
+    return Sim_result();
+}
@@ -0,0 +1,210 @@
+/**
+ * @file range_reconfig_sim.c
+ * @brief Host test and benchmark of the range DPU change detection and window cache (range_reconfig.h).
+ *
+ * Checks that RangeReconfig_isChanged() reports no change for identical
+ * parameters and a change for every single parameter that differs, for the
+ * configurations of an FFT scaling update and of a sub-frame switch, and the
+ * lookup, keying and capacity of the window cache. Then times the change
+ * detection and the window lookup against the regeneration of a 128 sample
+ * Blackman window in floating point, which the cache avoids. Exits with 1 if a
+ * check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o range_reconfig_sim scripts/range_reconfig_sim.c \
+ *         minimal_rangeproc_impl/src/range_reconfig.c -lm
+ *     ./range_reconfig_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "range_reconfig.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 128 ADC samples, 64 range bins, 128 chirps, 2 TX, 6 virtual antennas */
+#define SIM_NUM_ADC_SAMPLES     128U
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_CHIRPS          128U
+#define SIM_NUM_TX              2U
+#define SIM_NUM_ANTENNAS        6U
+
+/*! @brief Window type (MATHUTILS_WIN_BLACKMAN) and Q format of the range window */
+#define SIM_WIN_TYPE            3U
+#define SIM_QFORMAT             17U
+
+/*! @brief Iterations of the benchmark */
+#define SIM_NUM_ITERATIONS      10000000U
+
+static uint8_t gCubeA[16];
+static uint8_t gCubeB[16];
+static int32_t gWindowA[SIM_NUM_ADC_SAMPLES / 2U];
+static int32_t gWindowB[SIM_NUM_ADC_SAMPLES / 4U];
+
+static void Sim_defaultParams(RangeReconfig_Params *params) {
+    params->fftOutputDivShift        = 2U;
+    params->numButterflyStagesScaled = 0U;
+    params->window                   = gWindowA;
+    params->windowSize               = sizeof(gWindowA);
+    params->numAdcSamples            = SIM_NUM_ADC_SAMPLES;
+    params->rangeFftSize             = SIM_NUM_ADC_SAMPLES;
+    params->numRangeBins             = SIM_NUM_RANGE_BINS;
+    params->numChirpsPerFrame        = SIM_NUM_CHIRPS;
+    params->numDopplerChirpsPerFrame = SIM_NUM_CHIRPS / SIM_NUM_TX;
+    params->numTxAntennas            = SIM_NUM_TX;
+    params->numVirtualAntennas       = SIM_NUM_ANTENNAS;
+    params->isBpmEnabled             = 1U;
+    params->adcDataSize              = SIM_NUM_ADC_SAMPLES * 3U * 4U;
+    params->adcRxChanStride          = SIM_NUM_ADC_SAMPLES * 2U;
+    params->cube                     = gCubeA;
+    params->cubeBytes                = 98304U;
+}
+
+/**
+ * @brief Blackman window in Q format, as mathUtils_genWindow() generates it at boot.
+ */
+static void Sim_genBlackman(int32_t *win, uint32_t numSamples, uint32_t len, uint32_t qFormat) {
+    double phi = 2.0 * M_PI / (double)(numSamples - 1U);
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        win[i] = (int32_t)((0.42 - 0.5 * cos(phi * i) + 0.08 * cos(2.0 * phi * i)) * (double)(1U << qFormat) + 0.5);
+    }
+}
+
+static void Sim_testIsChanged(void) {
+    RangeReconfig_Params cur, next;
+    uint32_t field, numFields = 0;
+    int ok = 1;
+    char msg[160];
+
+    Sim_defaultParams(&cur);
+    next = cur;
+    Sim_check(RangeReconfig_isChanged(&cur, &next) == 0, "identical parameters: no change");
+
+    for (field = 0; field < 16U; field++) {
+        Sim_defaultParams(&next);
+        switch (field) {
+            case 0:  next.fftOutputDivShift++;          break;
+            case 1:  next.numButterflyStagesScaled++;   break;
+            case 2:  next.window = gWindowB;            break;
+            case 3:  next.windowSize++;                 break;
+            case 4:  next.numAdcSamples++;              break;
+            case 5:  next.rangeFftSize++;               break;
+            case 6:  next.numRangeBins++;               break;
+            case 7:  next.numChirpsPerFrame++;          break;
+            case 8:  next.numDopplerChirpsPerFrame++;   break;
+            case 9:  next.numTxAntennas++;              break;
+            case 10: next.numVirtualAntennas++;         break;
+            case 11: next.isBpmEnabled = 0U;            break;
+            case 12: next.adcDataSize++;                break;
+            case 13: next.adcRxChanStride++;            break;
+            case 14: next.cube = gCubeB;                break;
+            default: next.cubeBytes++;                  break;
+        }
+        ok = ok && (RangeReconfig_isChanged(&cur, &next) == 1);
+        numFields++;
+    }
+    snprintf(msg, sizeof(msg), "each of the %u parameters differing on its own is a change", numFields);
+    Sim_check(ok && (numFields == 16U), msg);
+
+    next = cur;
+    next.fftOutputDivShift = 3U;
+    next.numButterflyStagesScaled = 1U;
+    ok = (RangeReconfig_isChanged(&cur, &next) == 1);
+    next = cur;
+    next.numChirpsPerFrame = SIM_NUM_CHIRPS / 2U;
+    next.numDopplerChirpsPerFrame = SIM_NUM_CHIRPS / 4U;
+    next.cube = gCubeB;
+    next.cubeBytes = 49152U;
+    ok = ok && (RangeReconfig_isChanged(&cur, &next) == 1) && (RangeReconfig_isChanged(&next, &next) == 0);
+    Sim_check(ok, "FFT scaling update and sub-frame switch are changes, re-applying the same sub-frame is not");
+}
+
+static void Sim_testWindowCache(void) {
+    RangeReconfig_WindowCache cache;
+    RangeReconfig_Window window = { SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT, gWindowA, sizeof(gWindowA) };
+    const RangeReconfig_Window *found;
+    uint32_t i;
+    int ok;
+
+    RangeReconfig_initWindowCache(&cache);
+    ok = (RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT) == NULL) &&
+         (RangeReconfig_addWindow(&cache, &window) == 0);
+    found = RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT);
+    ok = ok && (found != NULL) && (found->window == gWindowA) && (found->windowSize == sizeof(gWindowA));
+    Sim_check(ok, "added window is found");
+
+    ok = (RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT - 1U) == NULL) &&
+         (RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE + 1U, SIM_QFORMAT) == NULL) &&
+         (RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES / 2U, SIM_WIN_TYPE, SIM_QFORMAT) == NULL);
+    Sim_check(ok, "other ADC samples, window type or Q format do not match");
+
+    ok = 1;
+    for (i = 1; i < RANGE_RECONFIG_MAX_WINDOWS; i++) {
+        window.numAdcSamples = SIM_NUM_ADC_SAMPLES + i;
+        ok = ok && (RangeReconfig_addWindow(&cache, &window) == 0);
+    }
+    window.numAdcSamples = 2U * SIM_NUM_ADC_SAMPLES;
+    ok = ok && (RangeReconfig_addWindow(&cache, &window) == -1) &&
+         (RangeReconfig_findWindow(&cache, 2U * SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT) == NULL) &&
+         (RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES + RANGE_RECONFIG_MAX_WINDOWS - 1U, SIM_WIN_TYPE,
+                                   SIM_QFORMAT) != NULL);
+    Sim_check(ok, "a full cache rejects further windows and keeps the cached ones");
+}
+
+static void Sim_benchmark(void) {
+    RangeReconfig_Params cur, next;
+    RangeReconfig_WindowCache cache;
+    RangeReconfig_Window window = { SIM_NUM_ADC_SAMPLES, SIM_WIN_TYPE, SIM_QFORMAT, gWindowA, sizeof(gWindowA) };
+    const RangeReconfig_Window *found;
+    volatile uint32_t sink = 0;
+    uint32_t i;
+    double t0, tCompare, tLookup, tGenerate;
+
+    Sim_defaultParams(&cur);
+    next = cur;
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        /* the last parameter differs every other call, so that all are compared */
+        next.cubeBytes = cur.cubeBytes + (i & 1U);
+        sink += (uint32_t)RangeReconfig_isChanged(&cur, &next);
+    }
+    tCompare = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    RangeReconfig_initWindowCache(&cache);
+    for (i = 0; i < RANGE_RECONFIG_MAX_WINDOWS; i++) {
+        window.numAdcSamples = SIM_NUM_ADC_SAMPLES + i;
+        (void)RangeReconfig_addWindow(&cache, &window);
+    }
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        found = RangeReconfig_findWindow(&cache, SIM_NUM_ADC_SAMPLES + (i & 3U), SIM_WIN_TYPE, SIM_QFORMAT);
+        sink += (found != NULL) ? 1U : 0U;
+    }
+    tLookup = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS / 100U; i++) {
+        Sim_genBlackman(gWindowA, SIM_NUM_ADC_SAMPLES + (i & 1U), SIM_NUM_ADC_SAMPLES / 2U, SIM_QFORMAT);
+        sink += (uint32_t)gWindowA[10];
+    }
+    tGenerate = (Sim_nowNs() - t0) / (SIM_NUM_ITERATIONS / 100U);
+
+    printf("\nbenchmark:\n");
+    printf("  change detection        %8.1f ns\n", tCompare);
+    printf("  window lookup           %8.1f ns\n", tLookup);
+    printf("  window generation       %8.1f ns (%u samples, double)\n", tGenerate, SIM_NUM_ADC_SAMPLES);
+    (void)sink;
+}
+
+int main(void) {
+    Sim_testIsChanged();
+    Sim_testWindowCache();
+    Sim_benchmark();
+
+    return Sim_result();
+}
@@ -0,0 +1,244 @@
+/**
+ * @file rd_heatmap_sim.c
+ * @brief Host reference test and benchmark of the range-Doppler heatmap model (rd_heatmap.h).
+ *
+ * Compares the fixed-point model RdHeatmap_compute() with a double precision
+ * windowed DFT (scaled by 1/fftSize like the model, summed over the antennas
+ * and shifted) on cubes with targets at positive and negative velocities and
+ * receiver noise, with and without zero padding. Checks the Doppler bin of
+ * the targets, that RdHeatmap_computeRows() matches the rows of the full
+ * heatmap, the antenna sums of RdHeatmap_sumAntennas() with saturation and
+ * the rejection of unsupported configurations. Then times the model on a cube
+ * of the default profile. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o rd_heatmap_sim scripts/rd_heatmap_sim.c \
+ *         minimal_rangeproc_impl/src/rd_heatmap.c -lm
+ *     ./rd_heatmap_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rd_heatmap.h"
+#include "sim_check.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+
+/*! @brief Largest difference between the model and the reference in LSB */
+#define SIM_MAX_ERROR_LSB       3.0
+
+/**
+ * @brief First half of a symmetric Hann window in Q17 (like mathUtils_genWindow).
+ */
+static void Sim_genWindow(int32_t *window, uint32_t numChirps) {
+    uint32_t i;
+
+    for (i = 0; i < (numChirps + 1U) / 2U; i++) {
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * (double)(i + 1U) / (double)(numChirps + 1U));
+        window[i] = (int32_t)lround(w * (double)(1U << RD_HEATMAP_WINDOW_QFORMAT));
+    }
+}
+
+/**
+ * @brief FORMAT_6 cube with a target per entry of bins/dopplers (doppler bin, negative values are negative velocities).
+ */
+static void Sim_fillCube(int16_t *cube, const RdHeatmap_Config *cfg, const uint32_t *bins, const int32_t *dopplers,
+                         const double *amps, uint32_t numTargets) {
+    uint32_t c, a, b, t;
+
+    srand(1);
+    for (c = 0; c < cfg->numDopplerChirps; c++) {
+        for (a = 0; a < cfg->numVirtualAntennas; a++) {
+            for (b = 0; b < cfg->numRangeBins; b++) {
+                int16_t *s = &cube[2U * ((c * cfg->numVirtualAntennas + a) * cfg->numRangeBins + b)];
+                double re = (double)(rand() % 41) - 20.0;
+                double im = (double)(rand() % 41) - 20.0;
+
+                for (t = 0; t < numTargets; t++) {
+                    if (bins[t] == b) {
+                        double ph = 2.0 * M_PI * ((double)dopplers[t] * c / cfg->fftSize + 0.3 * a);
+                        re += amps[t] * cos(ph);
+                        im += amps[t] * sin(ph);
+                    }
+                }
+                s[0] = (int16_t)lrint(im);
+                s[1] = (int16_t)lrint(re);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reference heatmap: windowed DFT in double precision, magnitude / fftSize, summed and shifted.
+ */
+static void Sim_reference(const RdHeatmap_Config *cfg, const int16_t *cube, const int32_t *window, double *ref) {
+    uint32_t n = cfg->fftSize, shift = RdHeatmap_getShift(cfg->numVirtualAntennas);
+    uint32_t b, a, k, c;
+
+    for (b = 0; b < cfg->numRangeBins; b++) {
+        for (k = 0; k < n; k++) {
+            double sum = 0.0;
+            for (a = 0; a < cfg->numVirtualAntennas; a++) {
+                double re = 0.0, im = 0.0;
+                for (c = 0; c < cfg->numDopplerChirps; c++) {
+                    const int16_t *s = &cube[2U * ((c * cfg->numVirtualAntennas + a) * cfg->numRangeBins + b)];
+                    uint32_t wIdx = (c < (cfg->numDopplerChirps + 1U) / 2U) ? c : (cfg->numDopplerChirps - 1U - c);
+                    double w = (double)window[wIdx] / (double)(1U << RD_HEATMAP_WINDOW_QFORMAT);
+                    double ph = -2.0 * M_PI * (double)(k * c) / (double)n;
+                    re += w * (s[1] * cos(ph) - s[0] * sin(ph));
+                    im += w * (s[1] * sin(ph) + s[0] * cos(ph));
+                }
+                sum += sqrt(re * re + im * im) / (double)n;
+            }
+            ref[b * n + k] = sum / (double)(1U << shift);
+        }
+    }
+}
+
+static uint32_t Sim_peakBin(const uint16_t *row, uint32_t n) {
+    uint32_t k, best = 0;
+
+    for (k = 1; k < n; k++) {
+        best = (row[k] > row[best]) ? k : best;
+    }
+    return best;
+}
+
+static void Sim_testReference(uint16_t numChirps, uint16_t fftSize) {
+    static const uint32_t bins[] = { 10U, 30U, 47U };
+    static const int32_t dopplers[] = { 5, -12, 0 };
+    static const double amps[] = { 9000.0, 3000.0, 20000.0 };
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, numChirps, fftSize };
+    int16_t *cube = malloc(4U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * numChirps);
+    uint16_t *heatmap = malloc(RdHeatmap_getSize(&cfg));
+    uint16_t *rows = malloc(RdHeatmap_getSize(&cfg));
+    double *ref = malloc(sizeof(double) * SIM_NUM_RANGE_BINS * fftSize);
+    int32_t window[RD_HEATMAP_MAX_FFT_SIZE / 2U];
+    double maxError = 0.0;
+    uint32_t i, t;
+    int peaksOk = 1;
+    char msg[160];
+
+    Sim_genWindow(window, numChirps);
+    Sim_fillCube(cube, &cfg, bins, dopplers, amps, 3U);
+    (void)RdHeatmap_compute(&cfg, cube, window, heatmap);
+    Sim_reference(&cfg, cube, window, ref);
+    for (i = 0; i < (uint32_t)SIM_NUM_RANGE_BINS * fftSize; i++) {
+        maxError = fmax(maxError, fabs((double)heatmap[i] - ref[i]));
+    }
+    snprintf(msg, sizeof(msg), "%u chirps, %u point FFT: model matches the reference within %.1f LSB (max %.2f)",
+             numChirps, fftSize, SIM_MAX_ERROR_LSB, maxError);
+    Sim_check(maxError <= SIM_MAX_ERROR_LSB, msg);
+
+    for (t = 0; t < 3U; t++) {
+        uint32_t expected = (uint32_t)((dopplers[t] + (int32_t)fftSize) % (int32_t)fftSize);
+        peaksOk = peaksOk && (Sim_peakBin(&heatmap[bins[t] * fftSize], fftSize) == expected);
+    }
+    snprintf(msg, sizeof(msg), "%u chirps, %u point FFT: targets at doppler bins 5, -12 and 0 peak in bins 5, %u and 0",
+             numChirps, fftSize, fftSize - 12U);
+    Sim_check(peaksOk, msg);
+
+    /* rows in groups of 5 bins, the last group is shorter */
+    for (i = 0; i < SIM_NUM_RANGE_BINS; i += 5U) {
+        uint32_t numBins = (i + 5U <= SIM_NUM_RANGE_BINS) ? 5U : (SIM_NUM_RANGE_BINS - i);
+        (void)RdHeatmap_computeRows(&cfg, cube, window, i, numBins, &rows[i * fftSize]);
+    }
+    snprintf(msg, sizeof(msg), "%u chirps, %u point FFT: computeRows in groups of 5 bins matches compute",
+             numChirps, fftSize);
+    Sim_check(memcmp(rows, heatmap, RdHeatmap_getSize(&cfg)) == 0, msg);
+
+    free(cube);
+    free(heatmap);
+    free(rows);
+    free(ref);
+}
+
+static void Sim_testSumAntennas(void) {
+    RdHeatmap_Config cfg = { 2U, 3U, 4U, 4U };
+    uint16_t mag[3U * 2U * 4U], heatmap[2U * 4U];
+    uint32_t i;
+    int ok = 1;
+
+    /* [antenna][bin][doppler]: 3 antennas sum to 6 * i, shifted by 2 */
+    for (i = 0; i < 8U; i++) {
+        mag[i] = (uint16_t)i;
+        mag[8U + i] = (uint16_t)(2U * i);
+        mag[16U + i] = (uint16_t)(3U * i);
+    }
+    RdHeatmap_sumAntennas(mag, 2U, &cfg, heatmap);
+    for (i = 0; i < 8U; i++) {
+        ok = ok && (heatmap[i] == (uint16_t)((6U * i) >> 2));
+    }
+    Sim_check(ok && (RdHeatmap_getShift(3U) == 2U), "antenna sums of 3 antennas are shifted by 2");
+
+    cfg.numVirtualAntennas = 1U;
+    mag[0] = UINT16_MAX;
+    RdHeatmap_sumAntennas(mag, 1U, &cfg, heatmap);
+    Sim_check((heatmap[0] == UINT16_MAX) && (RdHeatmap_getShift(1U) == 0U) && (RdHeatmap_getShift(8U) == 3U) &&
+              (RdHeatmap_getShift(12U) == 4U), "shift is ceil(log2(antennas)), full-scale sums stay within uint16");
+}
+
+static void Sim_testArguments(void) {
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, 48U };
+    static int16_t cube[4U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS];
+    static uint16_t heatmap[SIM_NUM_RANGE_BINS * 512U];
+    int32_t window[RD_HEATMAP_MAX_FFT_SIZE / 2U] = { 0 };
+    int ok;
+
+    ok = (RdHeatmap_compute(&cfg, cube, window, heatmap) == -1);
+    cfg.fftSize = 32U;
+    ok = ok && (RdHeatmap_compute(&cfg, cube, window, heatmap) == -1);
+    cfg.fftSize = 512U;
+    ok = ok && (RdHeatmap_compute(&cfg, cube, window, heatmap) == -1);
+    cfg.fftSize = 64U;
+    ok = ok && (RdHeatmap_computeRows(&cfg, cube, window, 60U, 5U, heatmap) == -1);
+    cfg.numVirtualAntennas = 0U;
+    ok = ok && (RdHeatmap_compute(&cfg, cube, window, heatmap) == -1);
+    Sim_check(ok, "FFT size no power of 2, below the chirps or too large, rows past the end and 0 antennas are rejected");
+}
+
+static void Sim_benchmark(void) {
+    static const uint32_t bins[] = { 10U };
+    static const int32_t dopplers[] = { 5 };
+    static const double amps[] = { 9000.0 };
+    RdHeatmap_Config cfg = { SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, SIM_NUM_CHIRPS };
+    int16_t *cube = malloc(4U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS);
+    uint16_t *heatmap = malloc(RdHeatmap_getSize(&cfg));
+    int32_t window[SIM_NUM_CHIRPS / 2U];
+    struct timespec t0, t1;
+    uint32_t i, iterations = 20U;
+    double us;
+
+    Sim_genWindow(window, SIM_NUM_CHIRPS);
+    Sim_fillCube(cube, &cfg, bins, dopplers, amps, 1U);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < iterations; i++) {
+        (void)RdHeatmap_compute(&cfg, cube, window, heatmap);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    us = ((double)(t1.tv_sec - t0.tv_sec) * 1e6 + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-3) / iterations;
+    printf("\nbenchmark, %u x %u x %u cube: model in %.0f us per frame, heatmap %u bytes\n", SIM_NUM_RANGE_BINS,
+           SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS, us, RdHeatmap_getSize(&cfg));
+    free(cube);
+    free(heatmap);
+}
+
+int main(void) {
+    Sim_testReference(SIM_NUM_CHIRPS, SIM_NUM_CHIRPS);
+    Sim_testReference(48U, 64U);
+    Sim_testReference(128U, 128U);
+    Sim_testSumAntennas();
+    Sim_testArguments();
+    Sim_benchmark();
+
+    return Sim_result();
+}
@@ -0,0 +1,334 @@
+/**
+ * @file recovery_sim.c
+ * @brief Host simulation of the pipeline recovery (recovery.h) with fault injection.
+ *
+ * Runs the frame loop of the dpcTask for a number of frames with the DPU,
+ * HWA, sensor and SPI replaced by stubs. Faults are injected at given frames,
+ * recovery actions can be made to fail. SPI faults go through the path of
+ * spi_transmit.c: a failed transfer of a data buffer or of the command slot
+ * sets spiTxFailed and the rest of the frame is not transmitted. Prints every
+ * fault with the action which recovered it and every resync marker the host
+ * would receive, and checks that SPI_BUSY is high after every frame, that the
+ * DPU is armed for every frame and that the first frame streamed after a
+ * fault starts with the resync marker, reporting the last good frame and the
+ * dropped frames. Exits with 1 if a check fails or the recovery gave up.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -Wall -Iminimal_rangeproc_impl/include -o recovery_sim scripts/recovery_sim.c \
+ *         minimal_rangeproc_impl/src/recovery.c
+ *     ./recovery_sim 40 process@3 process@4 stage@5 spi@12 spi-cmd@13 trigger@20 reset-fail@20
+ *     ./recovery_sim 10 process@2 process@3 process@4 restart-fail@4
+ *
+ * Faults: process, trigger, stage, sensor (sub-frame switch or reconfiguration
+ * failed), spi (transfer of a data buffer failed), spi-cmd (transfer of the
+ * command slot failed). Failing actions: rearm-fail, reset-fail, restart-fail
+ * (all recovery actions of that level fail at the frame). Without faults a
+ * default scenario is run.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "recovery.h"
+#include "sim_check.h"
+
+/*! @brief Maximum number of injected events */
+#define SIM_MAX_EVENTS      32
+
+/*! @brief Event kinds, the faults use their RECOVERY_FAULT_* value */
+#define SIM_EVENT_REARM_FAIL    (RECOVERY_NUM_FAULTS + 0U)
+#define SIM_EVENT_RESET_FAIL    (RECOVERY_NUM_FAULTS + 1U)
+#define SIM_EVENT_RESTART_FAIL  (RECOVERY_NUM_FAULTS + 2U)
+#define SIM_EVENT_SPI_CMD       (RECOVERY_NUM_FAULTS + 3U)
+
+/*! @brief Buffers transmitted per frame (resync marker or frame info, radar cube, products) */
+#define SIM_NUM_TX_BUFFERS      3U
+
+/*! @brief Buffer whose transfer fails on an spi fault */
+#define SIM_FAILING_TX_BUFFER   1U
+
+/**
+ * @brief Injected fault or failing action.
+ */
+typedef struct Sim_Event_t
+{
+    uint32_t kind;
+    uint32_t frameIdx;
+} Sim_Event;
+
+/**
+ * @brief Stubbed pipeline.
+ */
+typedef struct Sim_Pipeline_t
+{
+    int failRearm;
+    int failReset;
+    int failRestart;
+    int armed;          /* the DPU waits for the next frame */
+} Sim_Pipeline;
+
+/**
+ * @brief Stubbed SPI of spi_transmit.c and the host on the other end.
+ */
+typedef struct Sim_Spi_t
+{
+    int failData;       /* MCSPI_transfer() of SIM_FAILING_TX_BUFFER fails */
+    int failCmdSlot;    /* MCSPI_transfer() of the command slot fails */
+    int busyHigh;       /* SPI_BUSY pin, low while a chunk is announced */
+    uint32_t spiTxFailed;
+    uint32_t numBuffers; /* buffers the host received in this frame */
+} Sim_Spi;
+
+static const char *gEventNames[] = {
+    "spi", "process", "trigger", "stage", "sensor", "rearm-fail", "reset-fail", "restart-fail", "spi-cmd"
+};
+
+static int32_t Sim_rearm(void *arg) {
+    Sim_Pipeline *pipe = (Sim_Pipeline *)arg;
+
+    printf("    rearm%s\n", pipe->failRearm ? ": failed" : "");
+    pipe->armed = !pipe->failRearm;
+    return pipe->failRearm ? -1 : 0;
+}
+
+static int32_t Sim_reset(void *arg) {
+    Sim_Pipeline *pipe = (Sim_Pipeline *)arg;
+
+    printf("    reset HWA, configure DPU%s\n", pipe->failReset ? ": failed" : "");
+    if (pipe->failReset) {
+        return -1;
+    }
+    return Sim_rearm(arg);
+}
+
+static int32_t Sim_restart(void *arg) {
+    Sim_Pipeline *pipe = (Sim_Pipeline *)arg;
+
+    printf("    stop sensor, rebuild pipeline, restart%s\n", pipe->failRestart ? ": failed" : "");
+    if (pipe->failRestart) {
+        return -1;
+    }
+    return Sim_rearm(arg);
+}
+
+/**
+ * @brief One transfer as spi_transfer_buffer() and spi_exchange_cmd_slot() do it, returns 0 on success.
+ */
+static int32_t Sim_transfer(Sim_Spi *spi, int fail) {
+    spi->busyHigh = 0;      /* GPIO_pinWriteLow(): the master reads the chunk */
+    spi->busyHigh = 1;      /* GPIO_pinWriteHigh() after MCSPI_transfer(), also if it failed */
+    if (fail) {
+        return -1;
+    }
+    spi->numBuffers++;
+    return 0;
+}
+
+/**
+ * @brief One iteration of spi_transmit_loop().
+ */
+static void Sim_spiTransmit(Sim_Spi *spi) {
+    uint32_t bufIdx;
+
+    spi->numBuffers = 0;
+    for (bufIdx = 0; bufIdx < SIM_NUM_TX_BUFFERS; bufIdx++) {
+        if (Sim_transfer(spi, spi->failData && (bufIdx == SIM_FAILING_TX_BUFFER)) != 0) {
+            spi->spiTxFailed = 1U;
+            break;
+        }
+    }
+    if (Sim_transfer(spi, spi->failCmdSlot) != 0) {
+        spi->spiTxFailed = 1U;
+    }
+}
+
+static int Sim_hasEvent(const Sim_Event *events, uint32_t numEvents, uint32_t kind, uint32_t frameIdx) {
+    uint32_t i;
+
+    for (i = 0; i < numEvents; i++) {
+        if ((events[i].kind == kind) && (events[i].frameIdx == frameIdx)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static uint32_t Sim_parseEvents(int argc, char **argv, Sim_Event *events) {
+    static const char *defaults[] = {
+        "process@3", "process@4", "stage@5", "spi@12", "spi-cmd@13", "spi@24", "trigger@20", "reset-fail@20",
+        "sensor@28", "process@34"
+    };
+    uint32_t numEvents = 0;
+    uint32_t numArgs = (argc > 2) ? (uint32_t)(argc - 2) : (uint32_t)(sizeof(defaults) / sizeof(defaults[0]));
+    uint32_t i, kind;
+
+    for (i = 0; (i < numArgs) && (numEvents < SIM_MAX_EVENTS); i++) {
+        const char *arg = (argc > 2) ? argv[i + 2] : defaults[i];
+        const char *at = strchr(arg, '@');
+
+        for (kind = 0; kind < sizeof(gEventNames) / sizeof(gEventNames[0]); kind++) {
+            if ((at != NULL) && (strlen(gEventNames[kind]) == (size_t)(at - arg)) &&
+                (strncmp(arg, gEventNames[kind], (size_t)(at - arg)) == 0)) {
+                events[numEvents].kind     = kind;
+                events[numEvents].frameIdx = (uint32_t)strtoul(at + 1, NULL, 10);
+                numEvents++;
+                break;
+            }
+        }
+        if (kind == sizeof(gEventNames) / sizeof(gEventNames[0])) {
+            fprintf(stderr, "warning: ignoring %s\n", arg);
+        }
+    }
+    return numEvents;
+}
+
+/**
+ * @brief Handles a fault like RangeProc_recover() does.
+ */
+static int Sim_fault(Recovery_Ctrl *ctrl, uint32_t fault, uint32_t dropped, uint32_t frameIdx,
+                     const Recovery_Ops *ops) {
+    int32_t level;
+
+    printf("frame %3u: %s fault\n", frameIdx, Recovery_faultName(fault));
+    level = Recovery_handleFault(ctrl, fault, dropped, ops);
+    printf("    -> %s, next fault handled with %s at least\n", Recovery_levelName(level),
+           Recovery_levelName(ctrl->level));
+    return (level == RECOVERY_ERR_FAILED) ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    Sim_Event events[SIM_MAX_EVENTS];
+    Sim_Pipeline pipe;
+    Sim_Spi spi;
+    Recovery_Ctrl ctrl;
+    Recovery_Ops ops;
+    Recovery_Marker marker;
+    uint32_t numFrames = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 40U;
+    uint32_t numEvents = Sim_parseEvents(argc, argv, events);
+    uint32_t numStreamed = 0, numMarkers = 0, numSpiFaults = 0;
+    uint32_t lastGoodFrameIdx = 0, numDropped = 0;
+    uint32_t numBadMarkers = 0, numUnexpectedMarkers = 0, numMissingMarkers = 0, numBusyLow = 0;
+    uint32_t frameIdx;
+    int stalled = 0, markerExpected = 0;
+
+    memset(&pipe, 0, sizeof(pipe));
+    memset(&spi, 0, sizeof(spi));
+    ops.rearm   = Sim_rearm;
+    ops.reset   = Sim_reset;
+    ops.restart = Sim_restart;
+    ops.arg     = &pipe;
+    Recovery_init(&ctrl);
+    pipe.armed   = 1;
+    spi.busyHigh = 1;
+
+    for (frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+        pipe.failRearm   = Sim_hasEvent(events, numEvents, SIM_EVENT_REARM_FAIL, frameIdx);
+        pipe.failReset   = Sim_hasEvent(events, numEvents, SIM_EVENT_RESET_FAIL, frameIdx);
+        pipe.failRestart = Sim_hasEvent(events, numEvents, SIM_EVENT_RESTART_FAIL, frameIdx);
+        spi.failData     = Sim_hasEvent(events, numEvents, RECOVERY_FAULT_SPI, frameIdx);
+        spi.failCmdSlot  = Sim_hasEvent(events, numEvents, SIM_EVENT_SPI_CMD, frameIdx);
+
+        if (!pipe.armed) {
+            printf("frame %3u: DPU not armed, pipeline stalled\n", frameIdx);
+            stalled = 1;
+            break;
+        }
+
+        /* DPU process or a processing stage fails: the frame is dropped */
+        if (Sim_hasEvent(events, numEvents, RECOVERY_FAULT_PROCESS, frameIdx) ||
+            Sim_hasEvent(events, numEvents, RECOVERY_FAULT_STAGE, frameIdx)) {
+            uint32_t fault = Sim_hasEvent(events, numEvents, RECOVERY_FAULT_PROCESS, frameIdx) ?
+                             RECOVERY_FAULT_PROCESS : RECOVERY_FAULT_STAGE;
+
+            pipe.armed = 0;
+            numDropped++;
+            markerExpected = 1;
+            if (Sim_fault(&ctrl, fault, 1U, frameIdx, &ops) != 0) {
+                printf("recovery gave up, the firmware stops in DebugP_assert()\n");
+                return 1;
+            }
+            continue;
+        }
+
+        /* streamProducts_process(): the marker is the first record of the frame */
+        if (Recovery_takeMarker(&ctrl, &marker) != 0) {
+            printf("frame %3u: resync marker: %u faults, last good frame %u, %u dropped, last %s by %s, %u restarts\n",
+                   frameIdx, marker.numFaults, marker.lastGoodFrameIdx, marker.numDroppedFrames,
+                   Recovery_faultName(marker.lastFault), Recovery_levelName(marker.lastLevel),
+                   marker.numRestarts);
+            if ((marker.sync[0] != RECOVERY_SYNC_WORD0) || (marker.sync[1] != RECOVERY_SYNC_WORD1) ||
+                (marker.lastGoodFrameIdx != lastGoodFrameIdx) || (marker.numDroppedFrames != numDropped)) {
+                printf("    FAIL: expected last good frame %u and %u dropped frames\n", lastGoodFrameIdx, numDropped);
+                numBadMarkers++;
+            }
+            if (!markerExpected) {
+                printf("    FAIL: marker without a fault\n");
+                numUnexpectedMarkers++;
+            }
+            markerExpected = 0;
+            numDropped = 0;
+            numMarkers++;
+        } else if (markerExpected) {
+            printf("frame %3u: FAIL: streamed without the resync marker\n", frameIdx);
+            numMissingMarkers++;
+        }
+
+        /* spiTask: transmit the frame, dpcTask waits for it */
+        spi.spiTxFailed = 0U;
+        Sim_spiTransmit(&spi);
+        if (!spi.busyHigh) {
+            printf("frame %3u: FAIL: SPI_BUSY is low after the frame\n", frameIdx);
+            numBusyLow++;
+        }
+
+        if (spi.spiTxFailed != 0U) {
+            printf("frame %3u: host received %u of %u transfers\n", frameIdx, spi.numBuffers, SIM_NUM_TX_BUFFERS + 1U);
+            numSpiFaults++;
+            numDropped++;
+            markerExpected = 1;
+            (void)Sim_fault(&ctrl, RECOVERY_FAULT_SPI, 1U, frameIdx, &ops);
+        } else {
+            Recovery_frameDone(&ctrl, frameIdx);
+            lastGoodFrameIdx = frameIdx;
+            numStreamed++;
+        }
+
+        /* sub-frame switch or reconfiguration: the recovery restarts the sensor and arms the DPU */
+        pipe.armed = 0;
+        if (Sim_hasEvent(events, numEvents, RECOVERY_FAULT_SENSOR, frameIdx)) {
+            markerExpected = 1;
+            if (Sim_fault(&ctrl, RECOVERY_FAULT_SENSOR, 0U, frameIdx, &ops) != 0) {
+                printf("recovery gave up, the firmware stops in DebugP_assert()\n");
+                return 1;
+            }
+            continue;
+        }
+
+        /* trigger for the next frame */
+        if (Sim_hasEvent(events, numEvents, RECOVERY_FAULT_TRIGGER, frameIdx)) {
+            markerExpected = 1;
+            if (Sim_fault(&ctrl, RECOVERY_FAULT_TRIGGER, 0U, frameIdx, &ops) != 0) {
+                printf("recovery gave up, the firmware stops in DebugP_assert()\n");
+                return 1;
+            }
+        } else {
+            pipe.armed = 1;
+        }
+    }
+
+    printf("%u of %u frames streamed, %u faults: %u resyncs, %u rearms, %u resets, %u restarts\n",
+           numStreamed, numFrames, ctrl.numFaults, ctrl.numActions[RECOVERY_LEVEL_RESYNC],
+           ctrl.numActions[RECOVERY_LEVEL_REARM], ctrl.numActions[RECOVERY_LEVEL_RESET],
+           ctrl.numActions[RECOVERY_LEVEL_RESTART]);
+    printf("%u SPI faults, %u resync markers\n\n", numSpiFaults, numMarkers);
+
+    Sim_check(!stalled, "the DPU is armed for every frame");
+    Sim_check(numBusyLow == 0U, "SPI_BUSY is high after every frame");
+    Sim_check(numMissingMarkers == 0U, "the first frame streamed after a fault starts with the resync marker");
+    Sim_check(numBadMarkers == 0U, "the markers report the last good frame and the dropped frames");
+    Sim_check(numUnexpectedMarkers == 0U, "resync markers only after a fault");
+    return Sim_result();
+}
@@ -0,0 +1,53 @@
+#ifndef SIM_CHECK_H
+#define SIM_CHECK_H
+
+/**
+ * @file sim_check.h
+ * @brief Checks and timing of the host simulations in this directory.
+ *
+ * Every simulation is a single translation unit which includes this header,
+ * reports each check with Sim_check() and returns Sim_result() from main().
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+/*! @brief Number of failed checks */
+static int gNumFailed = 0;
+
+/**
+ * @brief Prints the result of a check and counts it if it failed.
+ */
+static inline void Sim_check(int ok, const char *what) {
+    printf("%s: %s\n", ok ? "pass" : "FAIL", what);
+    if (!ok) {
+        gNumFailed++;
+    }
+}
+
+/**
+ * @brief Monotonic time in ns.
+ */
+static inline double Sim_nowNs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Monotonic time in us.
+ */
+static inline double Sim_nowUs(void) {
+    return Sim_nowNs() * 1e-3;
+}
+
+/**
+ * @brief Prints the number of failed checks, returns the exit code of the simulation (1 if a check failed).
+ */
+static inline int Sim_result(void) {
+    printf("\n%s: %d check(s) failed\n", (gNumFailed == 0) ? "ok" : "FAILED", gNumFailed);
+    return (gNumFailed == 0) ? 0 : 1;
+}
+
+#endif /* SIM_CHECK_H */
@@ -0,0 +1,233 @@
+/**
+ * @file slowtime_codec_sim.c
+ * @brief Host rate/distortion benchmark and test of the slow-time transform codec (slowtime_codec.h).
+ *
+ * Encodes and decodes synthetic cubes of the default profile for several
+ * scenes (static and moving targets over receiver noise, a dense scene, pure
+ * noise) and target SNRs, and prints compression ratio, achieved SNR (header
+ * and measured on the decoded cube) and encoder/decoder time. Checks that the
+ * measured SNR reaches the target, that the header reports it, that the
+ * compression follows the scene content and the target SNR, that the doppler bin of a moving
+ * target survives at its doppler index in the payload and that mismatched
+ * payloads and configurations are rejected. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o slowtime_codec_sim scripts/slowtime_codec_sim.c \
+ *         minimal_rangeproc_impl/src/slowtime_codec.c -lm
+ *     ./slowtime_codec_sim
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_check.h"
+#include "slowtime_codec.h"
+
+/*! @brief Default profile: 64 range bins, 6 virtual antennas, 64 doppler chirps */
+#define SIM_NUM_RANGE_BINS      64U
+#define SIM_NUM_ANTENNAS        6U
+#define SIM_NUM_CHIRPS          64U
+#define SIM_NUM_VALUES          (2U * SIM_NUM_RANGE_BINS * SIM_NUM_ANTENNAS * SIM_NUM_CHIRPS)
+
+/*! @brief Range bin and normalised doppler frequency of the moving target */
+#define SIM_MOVING_BIN          25U
+#define SIM_MOVING_DOPPLER      0.171875    /* doppler bin 11 */
+
+/*! @brief Scenes */
+#define SIM_SCENE_SPARSE        0U      /* 3 static targets, 1 moving target, receiver noise */
+#define SIM_SCENE_DENSE         1U      /* a target in every range bin with its own doppler */
+#define SIM_SCENE_NOISE         2U      /* receiver noise only */
+
+/*! @brief Receiver noise, the noise only scene is louder to keep the int16 rounding of the decoder below 40 dB */
+#define SIM_NOISE_SIGMA         12.0
+#define SIM_NOISE_SIGMA_LOUD    200.0
+#define SIM_NUM_SCENES          3U
+
+static const char *gSceneNames[SIM_NUM_SCENES] = { "sparse", "dense", "noise" };
+
+/**
+ * @brief Gaussian noise sample (Box-Muller).
+ */
+static double Sim_noise(double sigma) {
+    double u1 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+    double u2 = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+
+    return sigma * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Fills a FORMAT_6 cube (chirp, antenna, range bin; imaginary part first).
+ */
+static void Sim_fillScene(int16_t *cube, uint32_t scene) {
+    double sigma = (scene == SIM_SCENE_NOISE) ? SIM_NOISE_SIGMA_LOUD : SIM_NOISE_SIGMA;
+    uint32_t c, a, b;
+
+    srand(1);
+    for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+        for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+            for (b = 0; b < SIM_NUM_RANGE_BINS; b++) {
+                double amp = 0.0, fd = 0.0, ph, re, im;
+                int16_t *s = &cube[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + b)];
+
+                if (scene == SIM_SCENE_SPARSE) {
+                    amp = (b == 3U) ? 15000.0 : (b == 10U) ? 8000.0 : (b == 40U) ? 2000.0 :
+                          (b == SIM_MOVING_BIN) ? 3000.0 : 0.0;
+                    fd  = (b == SIM_MOVING_BIN) ? SIM_MOVING_DOPPLER : 0.0;
+                } else if (scene == SIM_SCENE_DENSE) {
+                    amp = 400.0 + 60.0 * (double)(b % 11U);
+                    fd  = (double)((b * 7U) % SIM_NUM_CHIRPS) / SIM_NUM_CHIRPS;
+                }
+                ph = 2.0 * M_PI * (fd * c + 0.3 * a + 0.01 * b);
+                re = amp * cos(ph) + Sim_noise(sigma);
+                im = amp * sin(ph) + Sim_noise(sigma);
+                s[0] = (int16_t)lrint(im);
+                s[1] = (int16_t)lrint(re);
+            }
+        }
+    }
+}
+
+static double Sim_snrDb(const int16_t *ref, const int16_t *rec) {
+    double sig = 0.0, err = 0.0;
+    uint32_t i;
+
+    for (i = 0; i < SIM_NUM_VALUES; i++) {
+        double d = (double)ref[i] - (double)rec[i];
+        sig += (double)ref[i] * (double)ref[i];
+        err += d * d;
+    }
+    return 10.0 * log10(sig / err);
+}
+
+/**
+ * @brief Doppler bin with the largest power in a range bin, summed over antennas (DFT over slow time).
+ */
+static uint32_t Sim_dopplerPeak(const int16_t *cube, uint32_t bin) {
+    uint32_t k, c, a, best = 0;
+    double bestPower = -1.0;
+
+    for (k = 0; k < SIM_NUM_CHIRPS; k++) {
+        double power = 0.0;
+        for (a = 0; a < SIM_NUM_ANTENNAS; a++) {
+            double re = 0.0, im = 0.0;
+            for (c = 0; c < SIM_NUM_CHIRPS; c++) {
+                const int16_t *s = &cube[2U * ((c * SIM_NUM_ANTENNAS + a) * SIM_NUM_RANGE_BINS + bin)];
+                double ph = -2.0 * M_PI * (double)(k * c) / SIM_NUM_CHIRPS;
+                re += s[1] * cos(ph) - s[0] * sin(ph);
+                im += s[1] * sin(ph) + s[0] * cos(ph);
+            }
+            power += re * re + im * im;
+        }
+        if (power > bestPower) {
+            bestPower = power;
+            best = k;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Doppler index of the strongest kept coefficient of a sequence in the payload.
+ */
+static int32_t Sim_strongestIndex(const void *payload, uint32_t bin, uint32_t ant) {
+    const uint8_t *in = (const uint8_t *)payload + sizeof(SlowTimeCodec_Header);
+    uint32_t seq, k, count;
+    int32_t best = -1;
+    double bestPower = -1.0;
+
+    for (seq = 0; seq < bin * SIM_NUM_ANTENNAS + ant; seq++) {
+        in += 1U + 5U * in[0];
+    }
+    count = *in++;
+    for (k = 0; k < count; k++, in += 5) {
+        double re = (double)(int16_t)(in[1] | (in[2] << 8));
+        double im = (double)(int16_t)(in[3] | (in[4] << 8));
+        if (re * re + im * im > bestPower) {
+            bestPower = re * re + im * im;
+            best = in[0];
+        }
+    }
+    return best;
+}
+
+int main(void) {
+    static const float targets[] = { 20.0f, 30.0f, 40.0f };
+    static SlowTimeCodec_Obj obj;
+    SlowTimeCodec_Config cfg = { 30.0f, SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS, SIM_NUM_CHIRPS };
+    int16_t *cube = malloc(SIM_NUM_VALUES * sizeof(int16_t));
+    int16_t *rec  = malloc(SIM_NUM_VALUES * sizeof(int16_t));
+    void *payload = aligned_alloc(4, SlowTimeCodec_getMaxPayloadSize(&cfg));
+    double ratio[SIM_NUM_SCENES][3];
+    uint32_t scene, t;
+    int snrOk = 1, headerOk = 1, dopplerOk = 1, rateOk = 1;
+    char msg[160];
+
+    printf("rate/distortion, %u x %u x %u cube (%u bytes):\n", SIM_NUM_RANGE_BINS, SIM_NUM_ANTENNAS,
+           SIM_NUM_CHIRPS, SIM_NUM_VALUES * 2U);
+    printf("  scene   target   bytes    ratio   kept  header   measured  encode    decode\n");
+    for (scene = 0; scene < SIM_NUM_SCENES; scene++) {
+        Sim_fillScene(cube, scene);
+        for (t = 0; t < 3U; t++) {
+            const SlowTimeCodec_Header *hdr = (const SlowTimeCodec_Header *)payload;
+            double t0, tEnc, tDec, measured;
+            int32_t numBytes;
+
+            cfg.targetSnrDb = targets[t];
+            (void)SlowTimeCodec_init(&obj, &cfg);
+            t0 = Sim_nowUs();
+            numBytes = SlowTimeCodec_encode(&obj, cube, payload);
+            tEnc = Sim_nowUs() - t0;
+            t0 = Sim_nowUs();
+            (void)SlowTimeCodec_decode(&obj, payload, rec);
+            tDec = Sim_nowUs() - t0;
+            measured = Sim_snrDb(cube, rec);
+            ratio[scene][t] = (double)(SIM_NUM_VALUES * 2U) / (double)numBytes;
+
+            printf("  %-7s %4.0f dB %7d %7.1fx %6u %5.1f dB %6.1f dB %6.0f us %6.0f us\n", gSceneNames[scene],
+                   targets[t], numBytes, ratio[scene][t], hdr->numKept, hdr->achievedSnrDb, measured, tEnc, tDec);
+
+            /* rounding the decoded samples to int16 adds a little noise on top of the codec */
+            snrOk    = snrOk && (measured >= targets[t] - 0.5);
+            headerOk = headerOk && (hdr->achievedSnrDb >= targets[t]) && (fabs(hdr->achievedSnrDb - measured) < 1.0);
+            if (scene == SIM_SCENE_SPARSE) {
+                dopplerOk = dopplerOk && (Sim_dopplerPeak(rec, SIM_MOVING_BIN) == Sim_dopplerPeak(cube, SIM_MOVING_BIN));
+            }
+            rateOk = rateOk && ((t == 0U) || (ratio[scene][t] <= ratio[scene][t - 1U]));
+        }
+    }
+    printf("\n");
+    Sim_check(snrOk, "measured SNR reaches the target (within 0.5 dB for the int16 rounding)");
+    Sim_check(headerOk, "achieved SNR in the header reaches the target and matches the measured one within 1 dB");
+    Sim_check(dopplerOk, "doppler bin of the moving target is preserved");
+    snprintf(msg, sizeof(msg), "compression follows the scene: sparse %.1fx > dense %.1fx > noise %.1fx at 30 dB",
+             ratio[SIM_SCENE_SPARSE][1], ratio[SIM_SCENE_DENSE][1], ratio[SIM_SCENE_NOISE][1]);
+    Sim_check((ratio[SIM_SCENE_SPARSE][1] > ratio[SIM_SCENE_DENSE][1]) &&
+              (ratio[SIM_SCENE_DENSE][1] > ratio[SIM_SCENE_NOISE][1]), msg);
+    Sim_check(rateOk, "compression does not rise with the target SNR");
+
+    /* the coefficients are ordered as the doppler FFT (exp(-j)), not mirrored */
+    Sim_fillScene(cube, SIM_SCENE_SPARSE);
+    cfg.targetSnrDb = 30.0f;
+    (void)SlowTimeCodec_init(&obj, &cfg);
+    (void)SlowTimeCodec_encode(&obj, cube, payload);
+    snprintf(msg, sizeof(msg), "strongest coefficient of the moving target is doppler bin %d (DFT peak %u)",
+             (int)Sim_strongestIndex(payload, SIM_MOVING_BIN, 0U), Sim_dopplerPeak(cube, SIM_MOVING_BIN));
+    Sim_check(Sim_strongestIndex(payload, SIM_MOVING_BIN, 0U) == (int32_t)Sim_dopplerPeak(cube, SIM_MOVING_BIN),
+              msg);
+
+    /* a payload of other dimensions and a non power of 2 chirp count are rejected */
+    cfg.numRangeBins = 32U;
+    (void)SlowTimeCodec_init(&obj, &cfg);
+    Sim_check(SlowTimeCodec_decode(&obj, payload, rec) == -1, "payload of other dimensions is rejected");
+    cfg.numDopplerChirps = 48U;
+    Sim_check(SlowTimeCodec_init(&obj, &cfg) == -1, "chirp count which is no power of 2 is rejected");
+
+    free(cube);
+    free(rec);
+    free(payload);
+    return Sim_result();
+}
@@ -0,0 +1,206 @@
+/**
+ * @file subframe_sim.c
+ * @brief Host test of the sub-frame plan and rotation (subframe.h).
+ *
+ * Checks the plan of the default profile with the long-range sub-frame of
+ * subframe_cfg.h and a third sub-frame with a non power of 2 number of ADC
+ * samples and chirp accumulation, the exact fit of the budgets and the
+ * rejection of invalid tables. Then, for a grid of random sub-frame tables,
+ * compares every layout with ChirpAccum_compute() and checks that cubes and
+ * windows are aligned, contiguous and do not overlap. Finally runs a frame
+ * sequence: each frame follows SubFrame_next(), fills the cube of its
+ * sub-frame in a simulated L3 and must leave the cubes of all other
+ * sub-frames untouched. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o subframe_sim scripts/subframe_sim.c \
+ *         minimal_rangeproc_impl/src/subframe.c minimal_rangeproc_impl/src/chirp_accum.c \
+ *         minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     ./subframe_sim
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "budget_limits.h"
+#include "chirp_accum.h"
+#include "sim_check.h"
+#include "subframe.h"
+
+/*! @brief Default profile: 128 ADC samples, 2 chirps per burst, 64 bursts, 2 TX, 3 RX */
+#define SIM_NUM_ADC_SAMPLES     128U
+#define SIM_CHIRPS_PER_BURST    2U
+#define SIM_BURSTS_PER_FRAME    64U
+#define SIM_NUM_TX              2U
+#define SIM_NUM_RX              3U
+
+/*! @brief Frames of the sequence test */
+#define SIM_NUM_FRAMES          40U
+
+static uint8_t gL3[L3_MEM_SIZE];
+
+static void Sim_testDefaultPlan(void) {
+    SubFrame_Config cfg[SUBFRAME_MAX_NUM + 1] = {
+        { SIM_NUM_ADC_SAMPLES, SIM_CHIRPS_PER_BURST, SIM_BURSTS_PER_FRAME, 0U, 90U, 300U },
+        { SIM_NUM_ADC_SAMPLES, SIM_CHIRPS_PER_BURST, 32U, 0U, 45U, 300U },
+        { 100U, 4U, 16U, 2U, 60U, 250U },
+    };
+    SubFrame_Plan plan;
+    int ok;
+
+    ok = (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE, &plan) == 0) &&
+         (plan.numSubFrames == 2U) && (plan.layout[0].numRangeBins == 64U) &&
+         (plan.layout[0].numChirpsPerFrame == 128U) && (plan.layout[0].numDopplerChirpsPerFrame == 64U) &&
+         (plan.layout[0].cubeBytes == 98304U) && (plan.layout[0].cubeOffset == 0U) &&
+         (plan.layout[0].windowBytes == 256U) && (plan.layout[0].windowOffset == 0U) &&
+         (plan.layout[1].cubeBytes == 49152U) && (plan.layout[1].cubeOffset == 98304U) &&
+         (plan.layout[1].windowOffset == 256U) && (plan.cubeBytes == 147456U) && (plan.windowBytes == 512U);
+    Sim_check(ok, "default and long-range sub-frame: 98304 + 49152 byte cubes, 2 x 256 byte windows");
+
+    ok = (SubFrame_plan(cfg, 3U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE, &plan) == 0) &&
+         (plan.layout[2].numRangeBins == 64U) && (plan.layout[2].windowBytes == 200U) &&
+         (plan.layout[2].extraShift == 1U) && (plan.layout[2].numChirpsPerFrame == 32U) &&
+         (plan.layout[2].numDopplerChirpsPerFrame == 16U) && (plan.layout[2].cubeOffset == 147456U) &&
+         (plan.layout[2].windowOffset == 512U) && (plan.cubeBytes == 147456U + 24576U) && (plan.windowBytes == 712U);
+    Sim_check(ok, "third sub-frame with 100 ADC samples accumulated by 2: 64 bins, 200 byte window, shift 1");
+
+    ok = (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, 147456U, 512U, &plan) == 0) &&
+         (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, 147455U, 512U, &plan) == -1) &&
+         (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, 147456U, 511U, &plan) == -1);
+    Sim_check(ok, "exact fit of the cube and window budgets is accepted, one byte less is rejected");
+
+    ok = (SubFrame_plan(cfg, 0U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, UINT32_MAX, &plan) == -1) &&
+         (SubFrame_plan(cfg, SUBFRAME_MAX_NUM + 1U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, UINT32_MAX, &plan) == -1);
+    /* 2 chirps per burst can not be accumulated by 4 */
+    cfg[1].numChirpsAccum = 4U;
+    ok = ok && (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, UINT32_MAX, &plan) == -1);
+    cfg[1].numChirpsAccum = 0U;
+    cfg[1].numAdcSamples = 0U;
+    ok = ok && (SubFrame_plan(cfg, 2U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, UINT32_MAX, &plan) == -1);
+    Sim_check(ok, "0 or too many sub-frames, invalid accumulation and 0 ADC samples are rejected");
+}
+
+static void Sim_testGrid(void) {
+    static const uint32_t samples[] = { 32U, 64U, 100U, 128U, 200U, 256U };
+    static const uint32_t perBurst[] = { 1U, 2U, 4U, 8U };
+    static const uint32_t bursts[] = { 8U, 16U, 32U, 64U };
+    static const uint32_t accum[] = { 0U, 1U, 2U, 4U };
+    uint32_t run, i, numValid = 0, numRuns = 2000U;
+    int ok = 1;
+    char msg[160];
+
+    srand(5);
+    for (run = 0; run < numRuns; run++) {
+        SubFrame_Config cfg[SUBFRAME_MAX_NUM];
+        SubFrame_Plan plan;
+        uint32_t numSubFrames = 1U + (uint32_t)rand() % SUBFRAME_MAX_NUM;
+        uint32_t numTx = 1U + (uint32_t)rand() % 2U;
+        uint32_t cubeEnd = 0, windowEnd = 0;
+        int valid = 1;
+
+        for (i = 0; i < numSubFrames; i++) {
+            cfg[i].numAdcSamples = samples[rand() % 6];
+            cfg[i].numChirpsPerBurst = perBurst[rand() % 4];
+            cfg[i].numBurstsPerFrame = bursts[rand() % 4];
+            cfg[i].numChirpsAccum = accum[rand() % 4];
+            cfg[i].chirpSlope = 90U;
+            cfg[i].rampEndTime = 300U;
+        }
+        if (SubFrame_plan(cfg, numSubFrames, numTx, SIM_NUM_RX, UINT32_MAX, UINT32_MAX, &plan) != 0) {
+            /* only a table with a sub-frame ChirpAccum_compute() rejects may fail without a budget */
+            for (i = 0; i < numSubFrames; i++) {
+                ChirpAccum_Config accumCfg = { cfg[i].numChirpsPerBurst, cfg[i].numBurstsPerFrame,
+                                               cfg[i].numChirpsAccum, numTx, numTx * SIM_NUM_RX, 64U };
+                ChirpAccum_Dims dims;
+                valid = valid && (ChirpAccum_compute(&accumCfg, &dims) == 0);
+            }
+            ok = ok && !valid;
+            continue;
+        }
+        for (i = 0; i < numSubFrames; i++) {
+            const SubFrame_Layout *layout = &plan.layout[i];
+            uint32_t bins = 1U;
+            ChirpAccum_Config accumCfg;
+            ChirpAccum_Dims dims;
+
+            while (bins < cfg[i].numAdcSamples) {
+                bins <<= 1;
+            }
+            accumCfg.numChirpsPerBurst = cfg[i].numChirpsPerBurst;
+            accumCfg.numBurstsPerFrame = cfg[i].numBurstsPerFrame;
+            accumCfg.numChirpsAccum = cfg[i].numChirpsAccum;
+            accumCfg.numTxAntennas = numTx;
+            accumCfg.numVirtualAntennas = numTx * SIM_NUM_RX;
+            accumCfg.numRangeBins = bins / 2U;
+            ok = ok && (ChirpAccum_compute(&accumCfg, &dims) == 0) && (layout->numRangeBins == bins / 2U) &&
+                 (layout->numDopplerChirpsPerFrame == dims.numDopplerChirpsPerFrame) &&
+                 (layout->numChirpsPerFrame == dims.numChirpsPerFrame) && (layout->extraShift == dims.extraShift) &&
+                 (layout->cubeBytes == dims.cubeBytes) &&
+                 (layout->windowBytes == 4U * ((cfg[i].numAdcSamples + 1U) / 2U)) &&
+                 (layout->cubeOffset == cubeEnd) && (layout->windowOffset == windowEnd) &&
+                 ((layout->cubeOffset % 4U) == 0U) && ((layout->windowOffset % 4U) == 0U);
+            cubeEnd += layout->cubeBytes;
+            windowEnd += layout->windowBytes;
+        }
+        ok = ok && (plan.cubeBytes == cubeEnd) && (plan.windowBytes == windowEnd) &&
+             (SubFrame_plan(cfg, numSubFrames, numTx, SIM_NUM_RX, cubeEnd, windowEnd, &plan) == 0) &&
+             (SubFrame_plan(cfg, numSubFrames, numTx, SIM_NUM_RX, cubeEnd - 1U, windowEnd, &plan) == -1);
+        numValid++;
+    }
+    snprintf(msg, sizeof(msg), "%u random tables (%u valid): layouts match ChirpAccum_compute(), cubes and windows "
+             "are aligned and contiguous, budgets are exact", numRuns, numValid);
+    Sim_check(ok && (numValid > 0U) && (numValid < numRuns), msg);
+}
+
+static void Sim_testSequence(void) {
+    SubFrame_Config cfg[3] = {
+        { SIM_NUM_ADC_SAMPLES, SIM_CHIRPS_PER_BURST, SIM_BURSTS_PER_FRAME, 0U, 90U, 300U },
+        { SIM_NUM_ADC_SAMPLES, SIM_CHIRPS_PER_BURST, 32U, 0U, 45U, 300U },
+        { 100U, 4U, 16U, 2U, 60U, 250U },
+    };
+    uint8_t lastFrame[3] = { 0xFFU, 0xFFU, 0xFFU };
+    uint32_t numFrames[3] = { 0U, 0U, 0U };
+    SubFrame_Plan plan;
+    uint32_t frame, idx = 0, i, b;
+    int rotationOk = 1, isolationOk = 1;
+    char msg[160];
+
+    if (SubFrame_plan(cfg, 3U, SIM_NUM_TX, SIM_NUM_RX, L3_MEM_SIZE, MMWDEMO_OBJDET_CORE_LOCAL_MEM_SIZE, &plan) != 0) {
+        Sim_check(0, "plan of the sequence test");
+        return;
+    }
+    memset(gL3, 0xFF, sizeof(gL3));
+    for (frame = 0; frame < SIM_NUM_FRAMES; frame++) {
+        const SubFrame_Layout *layout = &plan.layout[idx];
+
+        rotationOk = rotationOk && (idx == frame % 3U);
+        /* the range DPU of this sub-frame writes its cube */
+        memset(&gL3[layout->cubeOffset], (int)(frame & 0x7FU), layout->cubeBytes);
+        lastFrame[idx] = (uint8_t)(frame & 0x7FU);
+        numFrames[idx]++;
+        for (i = 0; i < 3U; i++) {
+            for (b = 0; b < plan.layout[i].cubeBytes; b++) {
+                isolationOk = isolationOk && (gL3[plan.layout[i].cubeOffset + b] == lastFrame[i]);
+            }
+        }
+        idx = SubFrame_next(idx, 3U);
+    }
+    for (b = plan.cubeBytes; b < sizeof(gL3); b++) {
+        isolationOk = isolationOk && (gL3[b] == 0xFFU);
+    }
+    snprintf(msg, sizeof(msg), "%u frames rotate 0, 1, 2 (%u/%u/%u frames per sub-frame)", SIM_NUM_FRAMES,
+             numFrames[0], numFrames[1], numFrames[2]);
+    Sim_check(rotationOk && (SubFrame_next(0U, 1U) == 0U), msg);
+    Sim_check(isolationOk, "each frame writes only the cube of its sub-frame, L3 after the cubes is untouched");
+}
+
+int main(void) {
+    Sim_testDefaultPlan();
+    Sim_testGrid();
+    Sim_testSequence();
+
+    return Sim_result();
+}
@@ -0,0 +1,223 @@
+/**
+ * @file warm_start_sim.c
+ * @brief Host test and benchmark of the state retained across resets (warm_start.h).
+ *
+ * Checks that random RAM content after a power-on never passes
+ * WarmStart_isValid(), that a sealed record does, and that it is rejected
+ * after any single bit of the record or of the retained calibration data
+ * flipped, with another version and after WarmStart_invalidate(). Then runs a
+ * sequence of boots through the check and seal order of mmwave_basic.c
+ * (mmwave_checkWarmStart(), mmwave_retainState()): power-on, watchdog
+ * resets, a reset during the boot and a power loss, and checks which boots
+ * are warm, the boot count and the retained profile. Finally times the check
+ * of a warm boot. Exits with 1 if a check fails.
+ *
+ * Build and run (from the repo root):
+ *
+ *     gcc -O2 -Wall -Iminimal_rangeproc_impl/include -o warm_start_sim scripts/warm_start_sim.c \
+ *         minimal_rangeproc_impl/src/warm_start.c minimal_rangeproc_impl/src/config_cmd.c \
+ *         minimal_rangeproc_impl/src/chirp_accum.c minimal_rangeproc_impl/src/cube_budget.c -lm
+ *     ./warm_start_sim
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config_cmd.h"
+#include "profile_blob.h"
+#include "sim_check.h"
+#include "warm_start.h"
+
+/*! @brief Record of factory_cal.h: magic, CRC and the calibration data of the front end */
+#define SIM_CALIB_BYTES         128U
+
+/*! @brief Power-on RAM contents tried */
+#define SIM_NUM_POWER_ON        1000000U
+
+/*! @brief Iterations of the benchmark */
+#define SIM_NUM_ITERATIONS      1000000U
+
+static uint8_t gCalib[SIM_CALIB_BYTES];
+
+static void Sim_random(void *data, uint32_t numBytes) {
+    uint8_t *bytes = (uint8_t *)data;
+    uint32_t i;
+
+    for (i = 0; i < numBytes; i++) {
+        bytes[i] = (uint8_t)rand();
+    }
+}
+
+static void Sim_profile(ConfigCmd_Profile *profile, uint32_t numAdcSamples) {
+    memset(profile, 0, sizeof(ConfigCmd_Profile));
+    profile->channelCfg.rxChCtrlBitMask    = 7U;
+    profile->channelCfg.txChCtrlBitMask    = 3U;
+    profile->chirpComnCfg.numOfAdcSamples  = numAdcSamples;
+    profile->chirpComnCfg.chirpRampEndTime = 30.0f;
+    profile->frameCfg.numOfChirpsInBurst   = 2U;
+    profile->frameCfg.numOfBurstsInFrame   = 64U;
+    profile->frameCfg.framePeriodicity     = 100.0f;
+}
+
+static void Sim_testPowerOn(void) {
+    WarmStart_State state;
+    uint32_t i, numValid = 0, numMagic = 0;
+    char msg[160];
+
+    for (i = 0; i < SIM_NUM_POWER_ON; i++) {
+        Sim_random(&state, sizeof(state));
+        /* the worst case: random content behind an intact magic and version */
+        if ((i & 1U) != 0U) {
+            state.magic   = WARM_START_MAGIC;
+            state.version = WARM_START_VERSION;
+            numMagic++;
+        }
+        numValid += (uint32_t)WarmStart_isValid(&state, gCalib, SIM_CALIB_BYTES);
+    }
+    snprintf(msg, sizeof(msg), "power-on: %u of %u random records are valid (%u with intact magic and version)",
+             numValid, SIM_NUM_POWER_ON, numMagic);
+    Sim_check(numValid == 0U, msg);
+}
+
+static void Sim_testRecord(void) {
+    WarmStart_State sealed, state;
+    ConfigCmd_Profile profile;
+    uint32_t bit, numBits = 0, numRejected = 0;
+    char msg[160];
+
+    Sim_profile(&profile, 128U);
+    WarmStart_seal(&sealed, 3U, &profile, PROFILE_BLOB_SOURCE_FLASH, gCalib, SIM_CALIB_BYTES);
+    Sim_check(WarmStart_isValid(&sealed, gCalib, SIM_CALIB_BYTES) == 1, "sealed record is valid");
+
+    for (bit = 0; bit < 8U * sizeof(WarmStart_State); bit++) {
+        state = sealed;
+        ((uint8_t *)&state)[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        numRejected += (WarmStart_isValid(&state, gCalib, SIM_CALIB_BYTES) == 0) ? 1U : 0U;
+        numBits++;
+    }
+    snprintf(msg, sizeof(msg), "%u of %u flipped record bits are rejected", numRejected, numBits);
+    Sim_check(numRejected == numBits, msg);
+
+    numBits = 0;
+    numRejected = 0;
+    for (bit = 0; bit < 8U * SIM_CALIB_BYTES; bit++) {
+        gCalib[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        numRejected += (WarmStart_isValid(&sealed, gCalib, SIM_CALIB_BYTES) == 0) ? 1U : 0U;
+        gCalib[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        numBits++;
+    }
+    snprintf(msg, sizeof(msg), "%u of %u flipped calibration bits are rejected", numRejected, numBits);
+    Sim_check(numRejected == numBits, msg);
+
+    /* a record of another version is rejected even with a matching CRC */
+    state = sealed;
+    state.version = WARM_START_VERSION + 1U;
+    state.crc = ConfigCmd_crc32(&state, (uint32_t)offsetof(WarmStart_State, crc));
+    Sim_check(WarmStart_isValid(&state, gCalib, SIM_CALIB_BYTES) == 0, "record of another version is rejected");
+
+    state = sealed;
+    WarmStart_invalidate(&state);
+    Sim_check(WarmStart_isValid(&state, gCalib, SIM_CALIB_BYTES) == 0, "invalidated record is rejected");
+}
+
+/**
+ * @brief One boot in the order of mmwave_basic.c, returns 1 if it was warm.
+ *
+ * @param state          retained state
+ * @param profile        profile of a cold boot, on return the one the sensor runs with
+ * @param numBoots       output: boots since the last cold boot
+ * @param sensorStarted  0 if the device resets before the sensor runs
+ */
+static int Sim_boot(WarmStart_State *state, ConfigCmd_Profile *profile, uint32_t *numBoots, int sensorStarted) {
+    int warm = 0;
+
+    /* mmwave_checkWarmStart() */
+    *numBoots = 1U;
+    if (WarmStart_isValid(state, gCalib, SIM_CALIB_BYTES) != 0) {
+        warm = 1;
+        *numBoots = state->numBoots + 1U;
+    }
+    WarmStart_invalidate(state);
+
+    /* mmwave_loadBootProfile() */
+    if (warm != 0) {
+        *profile = state->profile;
+    }
+
+    /* mmwave_retainState() once the sensor runs */
+    if (sensorStarted != 0) {
+        WarmStart_seal(state, *numBoots, profile, PROFILE_BLOB_SOURCE_FLASH, gCalib, SIM_CALIB_BYTES);
+    }
+    return warm;
+}
+
+static void Sim_testBoots(void) {
+    WarmStart_State state;
+    ConfigCmd_Profile coldProfile, profile;
+    uint32_t numBoots = 0;
+    int ok;
+
+    Sim_profile(&coldProfile, 256U);
+
+    Sim_random(&state, sizeof(state));
+    profile = coldProfile;
+    ok = (Sim_boot(&state, &profile, &numBoots, 1) == 0) && (numBoots == 1U);
+    Sim_check(ok, "power-on: cold boot");
+
+    /* the sensor runs with the profile of the cold boot, a warm boot must keep it */
+    Sim_profile(&profile, 64U);
+    ok = (Sim_boot(&state, &profile, &numBoots, 1) == 1) && (numBoots == 2U) &&
+         (memcmp(&profile, &coldProfile, sizeof(profile)) == 0);
+    ok = ok && (Sim_boot(&state, &profile, &numBoots, 1) == 1) && (numBoots == 3U);
+    Sim_check(ok, "watchdog resets: warm boots with the retained profile, boots counted");
+
+    ok = (Sim_boot(&state, &profile, &numBoots, 0) == 1) && (numBoots == 4U) &&
+         (Sim_boot(&state, &profile, &numBoots, 1) == 0) && (numBoots == 1U);
+    Sim_check(ok, "reset during a boot: the next boot is cold");
+
+    ok = (Sim_boot(&state, &profile, &numBoots, 1) == 1) && (numBoots == 2U);
+    Sim_random(&state, sizeof(state));
+    ok = ok && (Sim_boot(&state, &profile, &numBoots, 1) == 0) && (numBoots == 1U);
+    Sim_check(ok, "power loss: cold boot");
+
+    gCalib[SIM_CALIB_BYTES - 1U] ^= 0x80U;
+    ok = (Sim_boot(&state, &profile, &numBoots, 1) == 0);
+    gCalib[SIM_CALIB_BYTES - 1U] ^= 0x80U;
+    Sim_check(ok, "calibration data changed in RAM: cold boot");
+}
+
+static void Sim_benchmark(void) {
+    WarmStart_State state;
+    ConfigCmd_Profile profile;
+    volatile int32_t sink = 0;
+    uint32_t i;
+    double t0, tCheck;
+
+    Sim_profile(&profile, 128U);
+    WarmStart_seal(&state, 1U, &profile, PROFILE_BLOB_SOURCE_FLASH, gCalib, SIM_CALIB_BYTES);
+    t0 = Sim_nowNs();
+    for (i = 0; i < SIM_NUM_ITERATIONS; i++) {
+        sink += WarmStart_isValid(&state, gCalib, SIM_CALIB_BYTES);
+    }
+    tCheck = (Sim_nowNs() - t0) / SIM_NUM_ITERATIONS;
+
+    printf("\nbenchmark:\n");
+    printf("  warm boot check         %8.1f ns (%u byte record, %u byte calibration)\n", tCheck,
+           (unsigned)sizeof(WarmStart_State), SIM_CALIB_BYTES);
+    (void)sink;
+}
+
+int main(void) {
+    srand(1);
+    Sim_random(gCalib, SIM_CALIB_BYTES);
+
+    Sim_testPowerOn();
+    Sim_testRecord();
+    Sim_testBoots();
+    Sim_benchmark();
+
+    return Sim_result();
+}
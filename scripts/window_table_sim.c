@@ -0,0 +1,141 @@
+/**
+ * @file window_table_sim.c
+ * @brief Host test of the precomputed range window (window_table.h) against mathUtils_genWindow().
+ *
+ * Models mathUtils_genWindow() of the MMWAVE-L-SDK (single precision rotation
+ * recurrence of the cosine terms) and checks that gWindowTable is bit-identical
+ * to the Q17 Blackman window it generates for WINDOW_TABLE_NUM_ADC_SAMPLES,
+ * and that the model stays within 2 LSB of a double precision Blackman window
+ * for all window lengths the configuration allows. With a file argument, also
+ * checks every table in it against the model; each table is a line
+ * "<numAdcSamples> <blackman 1/hanning 0> <len> <coefficients...>", as written
+ * by gen_window() of chirp_config_to_defines.py (see below). Exits with 1 if
+ * a check fails.
+ *
+ * Build and run (from the repo root, without fused multiply-adds like the
+ * generator on the target):
+ *
+ *     gcc -O2 -Wall -ffp-contract=off -Iminimal_rangeproc_impl/include -o window_table_sim \
+ *         scripts/window_table_sim.c -lm
+ *     python3 -c "import sys; sys.path.insert(0, 'scripts'); import chirp_config_to_defines as c
+ *     for n in range(2, 1025):
+ *         for t, b in (('blackman', 1), ('hanning', 0)):
+ *             print(n, b, (n + 1) // 2, *c.gen_window(n, (n + 1) // 2, t, 17))" > windows.txt
+ *     ./window_table_sim windows.txt
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim_check.h"
+#include "window_table.h"
+
+/*! @brief Range of numOfAdcSamples accepted by the configuration */
+#define SIM_MIN_ADC_SAMPLES     2U
+#define SIM_MAX_ADC_SAMPLES     1024U
+
+/**
+ * @brief Model of mathUtils_genWindow(), Blackman (1) or Hanning (0).
+ */
+static void Sim_genWindow(uint32_t *win, uint32_t winLen, uint32_t winGenLen, int blackman, uint32_t qFormat) {
+    float oneQformat = (float)(1U << qFormat);
+    float phi = 2 * M_PI / ((float)winLen - 1);
+    float ephyR = 1.0f, ephyI = 0.0f, ephy2R = 1.0f, ephy2I = 0.0f, tmpR;
+    float e1R = cos(phi), e1I = sin(phi), e2R = cos(2 * phi), e2I = sin(2 * phi);
+    float a0 = blackman ? 0.42f : 0.5f, a1 = 0.5f, a2 = blackman ? 0.08f : 0.0f;
+    int32_t winVal;
+    uint32_t i;
+
+    for (i = 0; i < winGenLen; i++) {
+        winVal = (int32_t)((oneQformat * (a0 - a1 * ephyR + a2 * ephy2R)) + 0.5);
+        if (winVal >= (int32_t)oneQformat) {
+            winVal = (int32_t)oneQformat - 1;
+        }
+        win[i] = (uint32_t)winVal;
+
+        tmpR = ephyR;
+        ephyR = ephyR * e1R - ephyI * e1I;
+        ephyI = tmpR * e1I + ephyI * e1R;
+        tmpR = ephy2R;
+        ephy2R = ephy2R * e2R - ephy2I * e2I;
+        ephy2I = tmpR * e2I + ephy2I * e2R;
+    }
+}
+
+static void Sim_testTable(void) {
+    uint32_t win[WINDOW_TABLE_LEN];
+    uint32_t i, numDiff = 0;
+    char msg[160];
+
+    Sim_genWindow(win, WINDOW_TABLE_NUM_ADC_SAMPLES, WINDOW_TABLE_LEN, 1, WINDOW_TABLE_QFORMAT);
+    for (i = 0; i < WINDOW_TABLE_LEN; i++) {
+        numDiff += (win[i] != gWindowTable[i]) ? 1U : 0U;
+    }
+    snprintf(msg, sizeof(msg), "gWindowTable is bit-identical to the Q%u Blackman window for %u ADC samples "
+             "(%u of %u coefficients differ)", WINDOW_TABLE_QFORMAT, WINDOW_TABLE_NUM_ADC_SAMPLES, numDiff,
+             WINDOW_TABLE_LEN);
+    Sim_check((numDiff == 0U) && (WINDOW_TABLE_LEN == (WINDOW_TABLE_NUM_ADC_SAMPLES + 1) / 2), msg);
+}
+
+static void Sim_testModel(void) {
+    static uint32_t win[(SIM_MAX_ADC_SAMPLES + 1U) / 2U];
+    uint32_t n, i;
+    double maxErr = 0.0;
+    char msg[160];
+
+    for (n = SIM_MIN_ADC_SAMPLES; n <= SIM_MAX_ADC_SAMPLES; n++) {
+        Sim_genWindow(win, n, (n + 1U) / 2U, 1, WINDOW_TABLE_QFORMAT);
+        for (i = 0; i < (n + 1U) / 2U; i++) {
+            double phi = 2.0 * M_PI * i / (double)(n - 1U);
+            double ref = (0.42 - 0.5 * cos(phi) + 0.08 * cos(2.0 * phi)) * (double)(1U << WINDOW_TABLE_QFORMAT);
+
+            maxErr = fmax(maxErr, fabs((double)win[i] - ref));
+        }
+    }
+    snprintf(msg, sizeof(msg), "model is a Blackman window for %u..%u samples (max error %.2f LSB)",
+             SIM_MIN_ADC_SAMPLES, SIM_MAX_ADC_SAMPLES, maxErr);
+    Sim_check(maxErr <= 2.0, msg);
+}
+
+static void Sim_testFile(const char *path) {
+    static uint32_t win[(SIM_MAX_ADC_SAMPLES + 1U) / 2U];
+    unsigned n, len, v, i, numTables = 0, numDiff = 0;
+    int blackman, ok = 1;
+    char msg[160];
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL) {
+        Sim_check(0, "open the window file");
+        return;
+    }
+    while (fscanf(f, "%u %d %u", &n, &blackman, &len) == 3) {
+        if ((n < SIM_MIN_ADC_SAMPLES) || (len > (SIM_MAX_ADC_SAMPLES + 1U) / 2U)) {
+            ok = 0;
+            break;
+        }
+        Sim_genWindow(win, n, len, blackman, WINDOW_TABLE_QFORMAT);
+        for (i = 0; i < len; i++) {
+            if (fscanf(f, "%u", &v) != 1) {
+                ok = 0;
+                break;
+            }
+            numDiff += (v != win[i]) ? 1U : 0U;
+        }
+        numTables++;
+    }
+    fclose(f);
+    snprintf(msg, sizeof(msg), "%u tables of the script match the model (%u coefficients differ)", numTables, numDiff);
+    Sim_check(ok && (numTables > 0U) && (numDiff == 0U), msg);
+}
+
+int main(int argc, char **argv) {
+    Sim_testTable();
+    Sim_testModel();
+    if (argc > 1) {
+        Sim_testFile(argv[1]);
+    }
+
+    return Sim_result();
+}